@@ -75,6 +75,12 @@ KeyboardAwareContainer {
             visualizerTab.recoverStatusError = true
             visualizerTab.recoverStatus = error
         }
+        function onRecoveryCancelled() {
+            visualizerTab.recoverStatusError = false
+            visualizerTab.recoverStatus = TranslationManager.translate(
+                "settings.visualizer.recoverStopped",
+                "Stopped. Retrieve the same dates again to continue where it left off.")
+        }
     }
 
     DatePickerDialog {
@@ -547,16 +553,23 @@ KeyboardAwareContainer {
                     Layout.fillWidth: true
                     spacing: Theme.scaled(10)
 
+                    // While a run is going the button stops it.
                     AccessibleButton {
                         text: MainController.visualizerImporter.recovering
-                            ? TranslationManager.translate("settings.visualizer.recovering", "Retrieving…")
+                            ? TranslationManager.translate("settings.visualizer.recoverStop", "Stop")
                             : TranslationManager.translate("settings.visualizer.recoverButton", "Retrieve")
-                        accessibleName: TranslationManager.translate(
-                            "settings.visualizer.recoverButtonA11y", "Retrieve shots from Visualizer")
-                        primary: true
-                        enabled: visualizerTab.visualizerConnected &&
-                                 !MainController.visualizerImporter.recovering
+                        accessibleName: MainController.visualizerImporter.recovering
+                            ? TranslationManager.translate(
+                                "settings.visualizer.recoverStopA11y", "Stop retrieving shots from Visualizer")
+                            : TranslationManager.translate(
+                                "settings.visualizer.recoverButtonA11y", "Retrieve shots from Visualizer")
+                        primary: !MainController.visualizerImporter.recovering
+                        enabled: visualizerTab.visualizerConnected
                         onClicked: {
+                            if (MainController.visualizerImporter.recovering) {
+                                MainController.visualizerImporter.cancelRecovery()
+                                return
+                            }
                             visualizerTab.recoverStatusError = false
                             visualizerTab.recoverStatus = TranslationManager.translate(
                                 "settings.visualizer.recoverStarting", "Looking up your shots…")
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Measure bytes on the wire and load time for the ShotServer shot pages.
+
+Fetches the shot list (/shots) and a shot detail page (/shot/<id>, the newest
+shot unless --shot is given) from a running Decenza, three ways each:
+
+  identity   no Accept-Encoding, no validator — what every page view cost
+             before responses were compressed and validated
+  gzip       Accept-Encoding: gzip, deflate, no validator — a first visit
+  revalidate Accept-Encoding plus the ETag from the gzip fetch as
+             If-None-Match — a repeat visit; expected to come back 304
+
+Each is repeated --runs times on a fresh connection. Reported per page and
+mode: HTTP status, bytes received (status line + headers + body, as read off
+the socket), and the median time from sending the request to the last byte.
+Over tablet Wi-Fi the last column is the page-load time the user feels; on
+localhost it is mostly server time.
+
+Not a CI check: it needs a device (or a desktop build) serving the web UI,
+with history in it. With web security enabled, pass the decenza_session
+cookie value from a logged-in browser via --session.
+
+Usage:
+    python3 scripts/measure_web_transfer.py 192.168.1.50
+    python3 scripts/measure_web_transfer.py 192.168.1.50 --port 8888 --runs 20
+    python3 scripts/measure_web_transfer.py localhost --shot 1234 --session <cookie>
+
+Exit: 0 on success, 1 if any fetch failed.
+"""
+import argparse, json, socket, statistics, sys, time
+
+
+def fetch(host, port, path, headers, timeout=30.0):
+    """One GET on its own connection: (status, wire bytes, seconds, header fields, body)."""
+    lines = [f"GET {path} HTTP/1.1", f"Host: {host}:{port}", "Connection: close"]
+    lines += [f"{k}: {v}" for k, v in headers.items()]
+    request = ("\r\n".join(lines) + "\r\n\r\n").encode()
+
+    with socket.create_connection((host, port), timeout=timeout) as sock:
+        start = time.perf_counter()
+        sock.sendall(request)
+        received = bytearray()
+        head_end = -1
+        expected = None
+        while True:
+            chunk = sock.recv(65536)
+            if not chunk:
+                break
+            received += chunk
+            if head_end < 0:
+                head_end = received.find(b"\r\n\r\n")
+                if head_end >= 0:
+                    head = received[:head_end].decode("latin-1").split("\r\n")
+                    status = int(head[0].split(" ")[1])
+                    fields = {}
+                    for line in head[1:]:
+                        name, _, value = line.partition(":")
+                        fields[name.strip().lower()] = value.strip()
+                    if status == 304:
+                        expected = head_end + 4
+                    elif "content-length" in fields:
+                        expected = head_end + 4 + int(fields["content-length"])
+            if expected is not None and len(received) >= expected:
+                break
+        elapsed = time.perf_counter() - start
+
+    if head_end < 0:
+        raise RuntimeError(f"{path}: no response head")
+    return status, len(received), elapsed, fields, bytes(received[head_end + 4:])
+
+
+def newest_shot_id(host, port, base_headers):
+    # One shot, one field: a small, never-chunked response whatever the history.
+    status, _, _, fields, body = fetch(host, port, "/api/shots?limit=1&fields=id", base_headers)
+    if status != 200:
+        raise RuntimeError(f"/api/shots: HTTP {status}")
+    if fields.get("content-encoding"):
+        raise RuntimeError("/api/shots came back encoded without Accept-Encoding")
+    shots = json.loads(body)
+    if not shots:
+        raise RuntimeError("no shots in history")
+    return shots[0]["id"]
+
+
+def measure(host, port, path, runs, base_headers):
+    rows = []
+    modes = [
+        ("identity", {}),
+        ("gzip", {"Accept-Encoding": "gzip, deflate"}),
+    ]
+    etag = None
+    for mode, extra in modes:
+        results = [fetch(host, port, path, {**base_headers, **extra}) for _ in range(runs)]
+        status, wire = results[-1][0], results[-1][1]
+        if mode == "gzip":
+            etag = results[-1][3].get("etag")
+        rows.append((mode, status, wire, statistics.median(r[2] for r in results)))
+
+    if etag:
+        headers = {**base_headers, "Accept-Encoding": "gzip, deflate", "If-None-Match": etag}
+        results = [fetch(host, port, path, headers) for _ in range(runs)]
+        rows.append(("revalidate", results[-1][0], results[-1][1],
+                     statistics.median(r[2] for r in results)))
+    else:
+        rows.append(("revalidate", 0, 0, 0.0))
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=8888)
+    parser.add_argument("--runs", type=int, default=10)
+    parser.add_argument("--shot", type=int, help="shot id for the detail page (default: newest)")
+    parser.add_argument("--session", help="decenza_session cookie value, when web security is on")
+    args = parser.parse_args()
+
+    base_headers = {"User-Agent": "measure_web_transfer"}
+    if args.session:
+        base_headers["Cookie"] = f"decenza_session={args.session}"
+
+    failed = False
+    try:
+        shot_id = args.shot or newest_shot_id(args.host, args.port, base_headers)
+    except (OSError, RuntimeError, ValueError) as e:
+        print(f"error: {e}", file=sys.stderr)
+        return 1
+
+    print(f"{'page':<14} {'mode':<11} {'status':>6} {'bytes':>10} {'median ms':>10}")
+    for label, path in (("shot list", "/shots"), ("shot detail", f"/shot/{shot_id}")):
+        try:
+            rows = measure(args.host, args.port, path, args.runs, base_headers)
+        except (OSError, RuntimeError, ValueError) as e:
+            print(f"{label:<14} error: {e}")
+            failed = True
+            continue
+        for mode, status, wire, seconds in rows:
+            print(f"{label:<14} {mode:<11} {status:>6} {wire:>10} {seconds * 1000:>10.1f}")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -30,6 +30,7 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 #include <QPointer>
 #include <QCoreApplication>
 #include <QRegularExpression>
@@ -1024,7 +1025,7 @@ void AIManager::requestRecentShotContext(const QString& beanBrand, const QString
     // event loop. The background thread captures `self` by value but MUST NOT dereference
     // it. All dereferences occur inside the QueuedConnection callback, which runs on the
     // main thread where QPointer's tracking is valid.
-    QThread* thread = QThread::create([self, dbPath, beanBrand, beanType, profileName, excludeShotId, serial]() {
+    TaskExecutor::instance().submit(TaskLane::Interactive, [self, dbPath, beanBrand, beanType, profileName, excludeShotId, serial]() {
         auto qualifiedShots = loadQualifiedShots(dbPath, beanBrand, beanType, profileName, excludeShotId);
 
         GrinderContext grinderCtx;
@@ -1091,9 +1092,6 @@ void AIManager::requestRecentShotContext(const QString& beanBrand, const QString
             self->emitRecentShotContext(qualifiedShots, grinderCtx, grinderBrand, serial, grinderCalibration, recentAdvice);
         }, Qt::QueuedConnection);
     });
-
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
 
 void AIManager::emitRecentShotContext(
@@ -4,70 +4,170 @@
 
 namespace Conductance {
 
-QVector<QPointF> fromPressureFlow(const QVector<QPointF>& pressure,
-                                   const QVector<QPointF>& flow)
+namespace {
+
+// 9-point Gaussian kernel (Visualizer.coffee).
+constexpr double GAUSSIAN[] = {
+    0.048297, 0.08393, 0.124548, 0.157829, 0.170793,
+    0.157829, 0.124548, 0.08393, 0.048297
+};
+constexpr qsizetype KERNEL_HALF = 4;
+
+// Clamp to [-5, 19] per Visualizer convention. NaN passes through, as it did
+// through the if/else-if this replaced.
+inline double clampDerivative(double v)
+{
+    return v < -5.0 ? -5.0 : (v > 19.0 ? 19.0 : v);
+}
+
+// Smoothed value at i where the kernel runs off either end of raw: only the
+// in-range taps contribute, renormalised by their weight.
+double smoothedAtEdge(const double* raw, qsizetype n, qsizetype i)
+{
+    double smoothed = 0.0;
+    double weightSum = 0.0;
+    for (qsizetype k = -KERNEL_HALF; k <= KERNEL_HALF; ++k) {
+        const qsizetype idx = i + k;
+        if (idx >= 0 && idx < n) {
+            const double w = GAUSSIAN[k + KERNEL_HALF];
+            smoothed += raw[idx] * w;
+            weightSum += w;
+        }
+    }
+    if (weightSum > 0.0) smoothed /= weightSum;
+    return smoothed;
+}
+
+} // namespace
+
+// The guards are folded into the divisor rather than branched around, so
+// every lane does the same work: a gated sample divides by 1 and its quotient
+// is then discarded for the 0 the scalar form returns.
+
+void sampleBatch(const double* pressure, const double* flow, double* out, qsizetype n)
 {
-    const qsizetype n = std::min(pressure.size(), flow.size());
-    QVector<QPointF> out;
-    out.reserve(n);
     for (qsizetype i = 0; i < n; ++i) {
-        const double t = pressure[i].x();
-        out.append(QPointF(t, sample(pressure[i].y(), flow[i].y())));
+        const double p = pressure[i];
+        const double f = flow[i];
+        const bool gated = f <= 0.05 || p <= 0.05;
+        const double c = (f * f) / (gated ? 1.0 : p);
+        out[i] = gated ? 0.0 : (c < 19.0 ? c : 19.0);
     }
-    return out;
 }
 
-QVector<QPointF> derivative(const QVector<QPointF>& conductance)
+void resistanceBatch(const double* pressure, const double* flow, double* out, qsizetype n)
 {
-    QVector<QPointF> out;
-    const qsizetype n = conductance.size();
-    if (n < 3) return out;
+    for (qsizetype i = 0; i < n; ++i) {
+        const double f = flow[i];
+        const bool gated = f <= 0.05;
+        const double r = pressure[i] / (gated ? 1.0 : f);
+        out[i] = gated ? 0.0 : (r < 15.0 ? r : 15.0);
+    }
+}
+
+void darcyResistanceBatch(const double* pressure, const double* flow, double* out, qsizetype n)
+{
+    for (qsizetype i = 0; i < n; ++i) {
+        const double p = pressure[i];
+        const double f = flow[i];
+        const bool gated = f <= 0.05 || p <= 0.05;
+        const double r = p / (gated ? 1.0 : f * f);
+        out[i] = gated ? 0.0 : (r < 19.0 ? r : 19.0);
+    }
+}
+
+qsizetype derivativeBatch(const double* times, const double* conductance, double* out, qsizetype n)
+{
+    if (n < 3) return 0;
 
     // Step 1: centered difference, scaled ×10 (matches Visualizer.coffee).
+    // Samples closer than 1 ms on either side have no derivative (0).
     QVector<double> raw(n, 0.0);
+    double* r = raw.data();
     for (qsizetype i = 1; i < n - 1; ++i) {
-        const double dt = conductance[i + 1].x() - conductance[i - 1].x();
-        if (dt > 0.001) {
-            const double dc = conductance[i + 1].y() - conductance[i - 1].y();
-            raw[i] = (dc / dt) * 10.0;
-        }
+        const double dt = times[i + 1] - times[i - 1];
+        const double dc = conductance[i + 1] - conductance[i - 1];
+        const bool valid = dt > 0.001;
+        r[i] = valid ? (dc / (valid ? dt : 1.0)) * 10.0 : 0.0;
     }
     // Edge values: forward/backward difference.
     {
-        double dt = conductance[1].x() - conductance[0].x();
+        double dt = times[1] - times[0];
         if (dt > 0.001)
-            raw[0] = ((conductance[1].y() - conductance[0].y()) / dt) * 10.0;
-        dt = conductance[n - 1].x() - conductance[n - 2].x();
+            r[0] = ((conductance[1] - conductance[0]) / dt) * 10.0;
+        dt = times[n - 1] - times[n - 2];
         if (dt > 0.001)
-            raw[n - 1] = ((conductance[n - 1].y() - conductance[n - 2].y()) / dt) * 10.0;
+            r[n - 1] = ((conductance[n - 1] - conductance[n - 2]) / dt) * 10.0;
+    }
+
+    // Step 2: Gaussian smoothing. Where the whole kernel fits, the taps are
+    // unrolled and the weight sum is a constant — summed in the same order
+    // the per-sample loop sums it (the weights total 1.000001, not 1, so the
+    // division is kept). Each sum starts from 0.0 like that loop's, which is
+    // what keeps a -0.0 tap from surviving as -0.0.
+    double fullWeight = 0.0;
+    for (double w : GAUSSIAN) fullWeight += w;
+
+    const qsizetype interiorEnd = n - KERNEL_HALF;
+    const qsizetype headEnd = std::min(KERNEL_HALF, n);
+    for (qsizetype i = 0; i < headEnd; ++i)
+        out[i] = clampDerivative(smoothedAtEdge(r, n, i));
+    for (qsizetype i = KERNEL_HALF; i < interiorEnd; ++i) {
+        double smoothed = 0.0;
+        smoothed += r[i - 4] * GAUSSIAN[0];
+        smoothed += r[i - 3] * GAUSSIAN[1];
+        smoothed += r[i - 2] * GAUSSIAN[2];
+        smoothed += r[i - 1] * GAUSSIAN[3];
+        smoothed += r[i] * GAUSSIAN[4];
+        smoothed += r[i + 1] * GAUSSIAN[5];
+        smoothed += r[i + 2] * GAUSSIAN[6];
+        smoothed += r[i + 3] * GAUSSIAN[7];
+        smoothed += r[i + 4] * GAUSSIAN[8];
+        out[i] = clampDerivative(smoothed / fullWeight);
     }
+    for (qsizetype i = std::max(headEnd, interiorEnd); i < n; ++i)
+        out[i] = clampDerivative(smoothedAtEdge(r, n, i));
 
-    // Step 2: 9-point Gaussian kernel (Visualizer.coffee).
-    static constexpr double GAUSSIAN[] = {
-        0.048297, 0.08393, 0.124548, 0.157829, 0.170793,
-        0.157829, 0.124548, 0.08393, 0.048297
-    };
-    static constexpr qsizetype KERNEL_HALF = 4;
+    return n;
+}
 
+// The QPointF forms split the series into columns and run the batch kernels,
+// so every caller — columnar or not — goes through one implementation.
+
+QVector<QPointF> fromPressureFlow(const QVector<QPointF>& pressure,
+                                   const QVector<QPointF>& flow)
+{
+    const qsizetype n = std::min(pressure.size(), flow.size());
+    QVector<double> p(n), f(n), c(n);
+    for (qsizetype i = 0; i < n; ++i) {
+        p[i] = pressure[i].y();
+        f[i] = flow[i].y();
+    }
+    sampleBatch(p.constData(), f.constData(), c.data(), n);
+
+    QVector<QPointF> out;
     out.reserve(n);
+    for (qsizetype i = 0; i < n; ++i)
+        out.append(QPointF(pressure[i].x(), c[i]));
+    return out;
+}
+
+QVector<QPointF> derivative(const QVector<QPointF>& conductance)
+{
+    QVector<QPointF> out;
+    const qsizetype n = conductance.size();
+    if (n < 3) return out;
+
+    QVector<double> t(n), c(n), d(n);
     for (qsizetype i = 0; i < n; ++i) {
-        double smoothed = 0.0;
-        double weightSum = 0.0;
-        for (qsizetype k = -KERNEL_HALF; k <= KERNEL_HALF; ++k) {
-            const qsizetype idx = i + k;
-            if (idx >= 0 && idx < n) {
-                const double w = GAUSSIAN[k + KERNEL_HALF];
-                smoothed += raw[idx] * w;
-                weightSum += w;
-            }
-        }
-        if (weightSum > 0.0) smoothed /= weightSum;
-        // Clamp to [-5, 19] per Visualizer convention.
-        if (smoothed < -5.0) smoothed = -5.0;
-        else if (smoothed > 19.0) smoothed = 19.0;
-        out.append(QPointF(conductance[i].x(), smoothed));
+        t[i] = conductance[i].x();
+        c[i] = conductance[i].y();
     }
+    derivativeBatch(t.constData(), c.constData(), d.data(), n);
 
+    out.reserve(n);
+    for (qsizetype i = 0; i < n; ++i)
+        out.append(QPointF(t[i], d[i]));
     return out;
 }
 
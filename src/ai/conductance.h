@@ -15,6 +15,12 @@
 // P/F² form respectively) with no Visualizer.coffee counterpart to match.
 namespace Conductance {
 
+// Bump whenever a change here alters any output for the same pressure/flow.
+// Stored derived curves are stamped with it (shot_samples.derived_version)
+// and loads trust only a matching stamp, so a formula change that forgets
+// this bump is never applied to saved shots.
+constexpr int kAlgorithmVersion = 1;
+
 // Darcy conductance C = F² / P, clamped to 19 to match the Visualizer
 // convention. Returns 0 when either P or F is essentially zero.
 inline double sample(double pressureBar, double flowMlS)
@@ -43,6 +49,22 @@ inline double darcyResistanceSample(double pressureBar, double flowMlS)
     return r < 19.0 ? r : 19.0;
 }
 
+// Batch forms of the three formulas above, over contiguous columns of n
+// samples: out[i] = formula(pressure[i], flow[i]). The loops are written
+// branch-free, with the same guards, clamps and expression order as the
+// scalar forms, so the compiler can vectorize them and their results are
+// bit-identical to calling the scalars one sample at a time. `out` may not
+// alias either input.
+void sampleBatch(const double* pressure, const double* flow, double* out, qsizetype n);
+void resistanceBatch(const double* pressure, const double* flow, double* out, qsizetype n);
+void darcyResistanceBatch(const double* pressure, const double* flow, double* out, qsizetype n);
+
+// dC/dt over a conductance column (times[i], conductance[i]) — the same
+// derivative, smoothing and clamp as derivative() below, into `out` (n
+// values, on the input's clock). Returns the number of values written: n, or
+// 0 when the input is too short (n < 3).
+qsizetype derivativeBatch(const double* times, const double* conductance, double* out, qsizetype n);
+
 // Build a time-aligned conductance series from pressure and flow series.
 // Samples are paired by index — callers must ensure the two series share the
 // same time axis (true for both ShotDataModel and visualizer payloads).
@@ -1178,7 +1178,8 @@ QJsonObject buildGrinderCalibrationBlock(QSqlDatabase& db,
         "       bean_brand, bean_type, roast_date, final_weight, "
         "       COALESCE(enjoyment,0), COALESCE(drink_tds,0), "
         "       COALESCE(yield_override, 0), "
-        "       json_extract(profile_json,'$.target_weight'), "
+        "       (SELECT json_extract(sp.profile_json,'$.target_weight') "
+        "          FROM shot_profiles sp WHERE sp.hash = shots.profile_hash), "
         "       COALESCE(rpm, 0) "
         "FROM shots "
         // Grinder identity resolves through the equipment_id pointer, not the
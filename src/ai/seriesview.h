@@ -0,0 +1,155 @@
+#pragma once
+
+#include <QPointF>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Read-only view of a (time, value) series for the shot detectors and the
+// summarizer: time lookups by binary search instead of a walk from t = 0.
+//
+// Samples are sorted by time (every recorded and imported curve is), possibly
+// with runs of equal timestamps. Each lookup keeps the exact answer of the
+// linear helper it replaced, so verdicts don't move:
+//   stepAt            — first sample at or after t, else the last
+//                       (ShotAnalysis::findValueAtTime)
+//   interpolateOrNaN  — linear between the bracketing samples, NaN outside
+//                       [first, last] (shotanalysis.cpp's lookupOrNaN)
+//   interpolateAt     — linear between the bracketing samples, clamped to the
+//                       ends (ShotSummarizer::findValueAtTime)
+//   average/max/min   — over samples with start <= t <= end, in sample order
+//                       (ShotSummarizer::calculateAverage/Max/Min)
+//
+// A detector that queries once per sample of another curve asks for
+// nondecreasing times; a Cursor remembers where the last answer was and
+// gallops forward from there, so the whole pass is linear rather than
+// n·log n. Moving a cursor backwards is allowed and falls back to a binary
+// search.
+//
+// The view does not own the samples: the vector must outlive it and not
+// change underneath it.
+class SeriesView {
+public:
+    explicit SeriesView(const QVector<QPointF>& data)
+        : m_points(data.constData()), m_size(data.size()) {}
+
+    bool isEmpty() const { return m_size == 0; }
+    qsizetype size() const { return m_size; }
+
+    // Index of the first sample with x >= t (size() if none).
+    qsizetype lowerBound(double t) const {
+        return std::lower_bound(m_points, m_points + m_size, t,
+                                [](const QPointF& p, double v) { return p.x() < v; }) - m_points;
+    }
+    // Index of the first sample with x > t (size() if none).
+    qsizetype upperBound(double t) const {
+        return std::upper_bound(m_points, m_points + m_size, t,
+                                [](double v, const QPointF& p) { return v < p.x(); }) - m_points;
+    }
+
+    double stepAt(double t) const { return stepFrom(lowerBound(t)); }
+    double interpolateOrNaN(double t) const { return interpolateOrNaNFrom(lowerBound(t), t); }
+    double interpolateAt(double t) const { return interpolateFrom(lowerBound(t), t); }
+
+    // 0 when no sample falls in [start, end], as the summarizer reports it.
+    double average(double start, double end) const {
+        const qsizetype first = lowerBound(start);
+        const qsizetype last = upperBound(end);
+        double sum = 0;
+        int count = 0;
+        for (qsizetype i = first; i < last; ++i) {
+            sum += m_points[i].y();
+            count++;
+        }
+        return count > 0 ? sum / count : 0;
+    }
+    double max(double start, double end) const {
+        double maxVal = -std::numeric_limits<double>::infinity();
+        for (qsizetype i = lowerBound(start), last = upperBound(end); i < last; ++i)
+            maxVal = std::max(maxVal, m_points[i].y());
+        return maxVal == -std::numeric_limits<double>::infinity() ? 0 : maxVal;
+    }
+    double min(double start, double end) const {
+        double minVal = std::numeric_limits<double>::infinity();
+        for (qsizetype i = lowerBound(start), last = upperBound(end); i < last; ++i)
+            minVal = std::min(minVal, m_points[i].y());
+        return minVal == std::numeric_limits<double>::infinity() ? 0 : minVal;
+    }
+
+    // Lookups for nondecreasing times; see the class comment.
+    class Cursor;
+
+private:
+    // The lookups proper, given i = lowerBound(t).
+    double stepFrom(qsizetype i) const {
+        if (m_size == 0) return 0.0;
+        return i < m_size ? m_points[i].y() : m_points[m_size - 1].y();
+    }
+
+    double interpolateOrNaNFrom(qsizetype i, double t) const {
+        if (m_size == 0) return std::nan("");
+        if (t < m_points[0].x() || t > m_points[m_size - 1].x()) return std::nan("");
+        // The bracket's right end is never the first sample: at t == first.x
+        // it is the second, interpolated at alpha 0.
+        i = std::max<qsizetype>(i, 1);
+        if (i >= m_size) return m_points[m_size - 1].y();
+        const double x0 = m_points[i - 1].x();
+        const double x1 = m_points[i].x();
+        const double y0 = m_points[i - 1].y();
+        const double y1 = m_points[i].y();
+        if (x1 <= x0) return y1;
+        const double alpha = (t - x0) / (x1 - x0);
+        return y0 + alpha * (y1 - y0);
+    }
+
+    double interpolateFrom(qsizetype i, double t) const {
+        if (m_size == 0) return 0;
+        if (i == m_size) return m_points[m_size - 1].y();
+        if (i == 0) return m_points[0].y();
+        const QPointF& p1 = m_points[i - 1];
+        const QPointF& p2 = m_points[i];
+        const double dx = p2.x() - p1.x();
+        if (std::abs(dx) < 1e-6) return p2.y();  // Guard against division by zero
+        const double alpha = (t - p1.x()) / dx;
+        return p1.y() + alpha * (p2.y() - p1.y());
+    }
+
+    const QPointF* m_points;
+    qsizetype m_size;
+};
+
+class SeriesView::Cursor {
+public:
+    explicit Cursor(const QVector<QPointF>& data) : m_view(data) {}
+
+    // lowerBound(t), starting from the previous answer.
+    qsizetype seek(double t) {
+        const QPointF* p = m_view.m_points;
+        const qsizetype n = m_view.m_size;
+        if (m_pos > 0 && p[m_pos - 1].x() >= t) {
+            m_pos = m_view.lowerBound(t);
+            return m_pos;
+        }
+        // Everything before lo is < t; hi is n or the first probe >= t.
+        qsizetype lo = m_pos, hi = m_pos, step = 1;
+        while (hi < n && p[hi].x() < t) {
+            lo = hi + 1;
+            hi += step;
+            step *= 2;
+        }
+        hi = std::min(hi, n);
+        m_pos = std::lower_bound(p + lo, p + hi, t,
+                                 [](const QPointF& q, double v) { return q.x() < v; }) - p;
+        return m_pos;
+    }
+
+    double stepAt(double t) { return m_view.stepFrom(seek(t)); }
+    double interpolateOrNaN(double t) { return m_view.interpolateOrNaNFrom(seek(t), t); }
+    double interpolateAt(double t) { return m_view.interpolateFrom(seek(t), t); }
+
+private:
+    SeriesView m_view;
+    qsizetype m_pos = 0;
+};
@@ -1,5 +1,6 @@
 #include "shotanalysis.h"
 #include "history/shothistorystorage.h"  // HistoryPhaseMarker
+#include "seriesview.h"
 
 #include <QVariantMap>
 #include <algorithm>
@@ -22,26 +23,73 @@ bool phaseAtTime(const QList<HistoryPhaseMarker>& phases, double t, bool* outIsF
     return true;
 }
 
-// Interpolate value from a (time, value) series at time t. Returns std::nan
-// when the series is empty or t falls outside [first.x, last.x] — callers
-// treat that as "no goal data for this moment."
-double lookupOrNaN(const QVector<QPointF>& data, double t)
+// Non-espresso modes: filter/pourover brew through a paper filter, tea
+// steeps, steam is a manual health check, cleaning/calibration flow hot
+// water through an empty portafilter. None of these have a puck for the
+// channeling or pour-truncated detectors to score.
+bool isNonPuckBeverage(const QString& beverageType)
 {
-    if (data.isEmpty()) return std::nan("");
-    if (t < data.first().x() || t > data.last().x()) return std::nan("");
-    // Linear interpolation between the nearest bracketing samples.
-    for (qsizetype i = 1; i < data.size(); ++i) {
-        if (data[i].x() >= t) {
-            const double x0 = data[i - 1].x();
-            const double x1 = data[i].x();
-            const double y0 = data[i - 1].y();
-            const double y1 = data[i].y();
-            if (x1 <= x0) return y1;
-            const double alpha = (t - x0) / (x1 - x0);
-            return y0 + alpha * (y1 - y0);
+    const QString bev = beverageType.toLower();
+    return bev == QStringLiteral("filter")
+        || bev == QStringLiteral("pourover")
+        || bev == QStringLiteral("tea")
+        || bev == QStringLiteral("steam")
+        || bev == QStringLiteral("cleaning");
+}
+
+// Everything the whole-pour detectors need from the samples inside
+// [pourStart, pourEnd], gathered in one walk of pressure and one of flow.
+// Pour-truncated, the turbo skip, flow trend and the expert band used to
+// each re-walk the same window; they now read these. Each accumulator adds
+// the same samples in the same order its detector did, so the results are
+// bit-identical.
+struct PourWindowScan {
+    double peakPressureBar = 0.0;
+
+    // Turbo skip: mean of flow samples above 0.05 ml/s.
+    double turboFlowSum = 0.0;
+    int turboFlowCount = 0;
+
+    // Flow trend: first 30 % and last 30 % of the pour (only when the pour
+    // window is non-degenerate).
+    double trendStartSum = 0.0, trendEndSum = 0.0;
+    int trendStartCount = 0, trendEndCount = 0;
+
+    // Expert-band median flow; filled only on request.
+    std::vector<double> flowValues;
+
+    bool turbo() const {
+        return turboFlowCount > 0
+            && (turboFlowSum / turboFlowCount) > ShotAnalysis::CHANNELING_MAX_AVG_FLOW;
+    }
+};
+
+PourWindowScan scanPourWindow(const QVector<QPointF>& pressure,
+                              const QVector<QPointF>& flow,
+                              double pourStart, double pourEnd,
+                              bool keepFlowValues)
+{
+    PourWindowScan scan;
+
+    for (const auto& pt : pressure) {
+        if (pt.x() < pourStart) continue;
+        if (pt.x() > pourEnd) break;
+        if (pt.y() > scan.peakPressureBar) scan.peakPressureBar = pt.y();
+    }
+
+    const double pourSpan = pourEnd - pourStart;
+    for (const auto& fp : flow) {
+        if (fp.x() < pourStart) continue;
+        if (fp.x() > pourEnd) break;
+        if (fp.y() > 0.05) { scan.turboFlowSum += fp.y(); ++scan.turboFlowCount; }
+        if (pourSpan > 0) {
+            const double progress = (fp.x() - pourStart) / pourSpan;
+            if (progress < 0.3) { scan.trendStartSum += fp.y(); ++scan.trendStartCount; }
+            if (progress > 0.7) { scan.trendEndSum += fp.y(); ++scan.trendEndCount; }
         }
+        if (keepFlowValues) scan.flowValues.push_back(fp.y());
     }
-    return data.last().y();
+    return scan;
 }
 
 } // namespace
@@ -162,6 +210,16 @@ QVector<ShotAnalysis::DetectionWindow> ShotAnalysis::buildChannelingWindows(
     const double analysisStart = pourStart + CHANNELING_DC_POUR_SKIP_SEC;
     const double analysisEnd = pourEnd - CHANNELING_DC_POUR_SKIP_END_SEC;
 
+    // One cursor per (series, offset) lookup: the grid only moves forward,
+    // so each sees nondecreasing times. Goal and actual are indexed by
+    // isFlowMode.
+    SeriesView::Cursor goalNowAt[] = {SeriesView::Cursor(pressureGoal), SeriesView::Cursor(flowGoal)};
+    SeriesView::Cursor goalPastAt[] = {SeriesView::Cursor(pressureGoal), SeriesView::Cursor(flowGoal)};
+    SeriesView::Cursor goalFutAt[] = {SeriesView::Cursor(pressureGoal), SeriesView::Cursor(flowGoal)};
+    SeriesView::Cursor actualAt[] = {SeriesView::Cursor(pressure), SeriesView::Cursor(flow)};
+    SeriesView::Cursor pressureNowAt(pressure);
+    SeriesView::Cursor pressureFutAt(pressure);
+
     for (const auto& pt : grid) {
         const double t = pt.x();
         if (t < analysisStart) continue;
@@ -173,13 +231,11 @@ QVector<ShotAnalysis::DetectionWindow> ShotAnalysis::buildChannelingWindows(
             continue;
         }
 
-        const QVector<QPointF>& goalSeries = isFlowMode ? flowGoal : pressureGoal;
-        const QVector<QPointF>& actualSeries = isFlowMode ? flow : pressure;
-
-        const double goalNow = lookupOrNaN(goalSeries, t);
-        const double goalPast = lookupOrNaN(goalSeries, t - WINDOW_HALF_SEC);
-        const double goalFut = lookupOrNaN(goalSeries, t + WINDOW_HALF_SEC);
-        const double actual = lookupOrNaN(actualSeries, t);
+        const int mode = isFlowMode ? 1 : 0;
+        const double goalNow = goalNowAt[mode].interpolateOrNaN(t);
+        const double goalPast = goalPastAt[mode].interpolateOrNaN(t - WINDOW_HALF_SEC);
+        const double goalFut = goalFutAt[mode].interpolateOrNaN(t + WINDOW_HALF_SEC);
+        const double actual = actualAt[mode].interpolateOrNaN(t);
 
         // No goal data at this moment (outside series bounds or sentinel) → skip.
         if (std::isnan(goalNow) || std::isnan(goalPast) || std::isnan(goalFut)
@@ -249,8 +305,8 @@ QVector<ShotAnalysis::DetectionWindow> ShotAnalysis::buildChannelingWindows(
         // converged-and-held goal — so excluding rising-pressure samples
         // doesn't mask either signature in pressure mode.
         {
-            const double pressureNow = lookupOrNaN(pressure, t);
-            const double pressureFut = lookupOrNaN(pressure, t + WINDOW_HALF_SEC);
+            const double pressureNow = pressureNowAt.interpolateOrNaN(t);
+            const double pressureFut = pressureFutAt.interpolateOrNaN(t + WINDOW_HALF_SEC);
             if (!std::isnan(pressureNow) && !std::isnan(pressureFut)
                 && pressureNow > 0.5
                 && pressureFut > pressureNow * (1.0 + WINDOW_STATIONARY_REL)) {
@@ -274,41 +330,20 @@ bool ShotAnalysis::shouldSkipChannelingCheck(const QString& beverageType,
                                                const QVector<QPointF>& flowData,
                                                double pourStart, double pourEnd)
 {
-    QString bev = beverageType.toLower();
-    // Non-espresso modes: filter/pourover brew through a paper filter, tea
-    // steeps, steam is a manual health check, cleaning/calibration flow hot
-    // water through an empty portafilter. None of these have a puck whose
-    // integrity dC/dt can meaningfully score.
-    if (bev == QStringLiteral("filter")
-        || bev == QStringLiteral("pourover")
-        || bev == QStringLiteral("tea")
-        || bev == QStringLiteral("steam")
-        || bev == QStringLiteral("cleaning"))
+    if (isNonPuckBeverage(beverageType))
         return true;
 
     // Check for turbo: avg flow during extraction > threshold
-    if (pourStart < pourEnd && !flowData.isEmpty()) {
-        double sum = 0;
-        int count = 0;
-        for (const auto& fp : flowData) {
-            if (fp.x() < pourStart) continue;
-            if (fp.x() > pourEnd) break;
-            if (fp.y() > 0.05) { sum += fp.y(); ++count; }
-        }
-        if (count > 0 && (sum / count) > CHANNELING_MAX_AVG_FLOW)
-            return true;
-    }
+    if (pourStart < pourEnd && !flowData.isEmpty()
+        && scanPourWindow({}, flowData, pourStart, pourEnd, false).turbo())
+        return true;
 
     return false;
 }
 
 double ShotAnalysis::findValueAtTime(const QVector<QPointF>& data, double time)
 {
-    if (data.isEmpty()) return 0.0;
-    for (const auto& pt : data) {
-        if (pt.x() >= time) return pt.y();
-    }
-    return data.last().y();
+    return SeriesView(data).stepAt(time);
 }
 
 ShotAnalysis::GrindCheck ShotAnalysis::analyzeFlowVsGoal(
@@ -437,13 +472,16 @@ ShotAnalysis::GrindCheck ShotAnalysis::analyzeFlowVsGoal(
             return false;
         };
 
+        SeriesView::Cursor goalAt(flowGoal);
+        SeriesView::Cursor goalPastAt(flowGoal);
+        SeriesView::Cursor goalFutAt(flowGoal);
         double actualSum = 0, goalSum = 0;
         qsizetype count = 0;
         for (const auto& fp : flow) {
             const double t = fp.x();
             if (t < pourStart || t > pourEnd) continue;
             if (!inFlowMode(t)) continue;
-            const double goal = findValueAtTime(flowGoal, t);
+            const double goal = goalAt.stepAt(t);
             if (goal < FLOW_GOAL_MIN_AVG) continue;  // preinfusion sentinel / unset goal
             // Stationarity gate: skip samples where flow_goal is changing
             // rapidly across ±FLOW_GOAL_STATIONARY_HALF_SEC. Excludes
@@ -452,18 +490,16 @@ ShotAnalysis::GrindCheck ShotAnalysis::analyzeFlowVsGoal(
             // the puck is supposed to track. See FLOW_GOAL_STATIONARY_REL
             // for the motivating false-positive (issue #1128).
             //
-            // Uses findValueAtTime (which clamps to first/last sample
-            // out-of-bounds) rather than lookupOrNaN: extreme short
+            // Uses stepAt (which clamps to first/last sample
+            // out-of-bounds) rather than interpolateOrNaN: extreme short
             // puck-failure shots (sub-second flow-mode phases) have legitimate
             // flat-goal signals where the past/future half-window extends
             // outside the series. NaN-skipping would silence those genuine
             // gushers; clamping to the actual first/last value preserves the
             // signal because the comparison is still against the real
             // stationary value, not a sentinel.
-            const double goalPast = findValueAtTime(
-                flowGoal, t - FLOW_GOAL_STATIONARY_HALF_SEC);
-            const double goalFut = findValueAtTime(
-                flowGoal, t + FLOW_GOAL_STATIONARY_HALF_SEC);
+            const double goalPast = goalPastAt.stepAt(t - FLOW_GOAL_STATIONARY_HALF_SEC);
+            const double goalFut = goalFutAt.stepAt(t + FLOW_GOAL_STATIONARY_HALF_SEC);
             const double denom = std::max(goal, FLOW_GOAL_MIN_AVG);
             if (std::abs(goalPast - goal) / denom > FLOW_GOAL_STATIONARY_REL
                 || std::abs(goalFut - goal) / denom > FLOW_GOAL_STATIONARY_REL) {
@@ -508,6 +544,7 @@ ShotAnalysis::GrindCheck ShotAnalysis::analyzeFlowVsGoal(
         return false;
     };
 
+    SeriesView::Cursor pressureAt(pressure);
     double pressurizedDuration = 0.0;
     double flowSum = 0.0;
     qsizetype flowSamples = 0;
@@ -519,7 +556,7 @@ ShotAnalysis::GrindCheck ShotAnalysis::analyzeFlowVsGoal(
             prevValid = false;
             continue;
         }
-        const double press = findValueAtTime(pressure, fp.x());
+        const double press = pressureAt.stepAt(fp.x());
         if (press < CHOKED_PRESSURE_MIN_BAR) {
             prevValid = false;
             continue;
@@ -631,27 +668,17 @@ bool ShotAnalysis::detectPourTruncated(const QVector<QPointF>& pressure,
     // Non-espresso modes legitimately run below PRESSURE_FLOOR_BAR (tea
     // steeps cold, pourover runs at a few bar max, cleaning just flushes).
     // Skip entirely — same rule the channeling/grind detectors use.
-    const QString bev = beverageType.toLower();
-    if (bev == QStringLiteral("filter")
-        || bev == QStringLiteral("pourover")
-        || bev == QStringLiteral("tea")
-        || bev == QStringLiteral("steam")
-        || bev == QStringLiteral("cleaning"))
+    if (isNonPuckBeverage(beverageType))
         return false;
 
     if (pressure.size() < 10 || pourEnd <= pourStart) return false;
 
-    // Scan the pour window for peak pressure. We look only inside the pour
-    // (not the entire sample range) because some profiles briefly spike
-    // during fill before the puck is engaged — that's not diagnostic of
-    // whether extraction actually built pressure.
-    double peakBar = 0.0;
-    for (const auto& pt : pressure) {
-        if (pt.x() < pourStart) continue;
-        if (pt.x() > pourEnd) break;
-        if (pt.y() > peakBar) peakBar = pt.y();
-    }
-    return peakBar < PRESSURE_FLOOR_BAR;
+    // Peak pressure inside the pour only (not the entire sample range),
+    // because some profiles briefly spike during fill before the puck is
+    // engaged — that's not diagnostic of whether extraction actually built
+    // pressure.
+    return scanPourWindow(pressure, {}, pourStart, pourEnd, false).peakPressureBar
+        < PRESSURE_FLOOR_BAR;
 }
 
 bool ShotAnalysis::detectSkipFirstFrame(const QList<HistoryPhaseMarker>& phases,
@@ -778,29 +805,33 @@ ShotAnalysis::AnalysisResult ShotAnalysis::analyzeShot(
     d.pourStartSec = pourStart;
     d.pourEndSec = pourEnd;
 
+    // Every whole-pour statistic the detectors below read, in one walk of
+    // the window (see PourWindowScan). The expert band's median needs the
+    // flow samples themselves; nothing else does.
+    const bool bandNeedsFlowValues = expertBand
+        && expertBand->axis == ExpertBand::Axis::ExtractionFlow;
+    PourWindowScan pour = scanPourWindow(pressure, flow, pourStart, pourEnd, bandNeedsFlowValues);
+    const bool nonPuckBeverage = isNonPuckBeverage(beverageType);
+
     // --- Pour-truncated detection (runs first; dominates the cascade) ---
     // When peak pressure stayed below PRESSURE_FLOOR_BAR the puck never built,
     // so channeling / flow-trend / grind blocks are all
     // reading off curves the failed puck didn't produce. Skip those blocks
     // entirely when this fires, and emit a single "Puck failed" warning +
-    // verdict that names the meta-action ("don't tune off this shot"). Peak
-    // pressure is computed locally for the warning text — detectPourTruncated
-    // doesn't return it.
-    const bool pourTruncated = detectPourTruncated(pressure, pourStart, pourEnd, beverageType);
+    // verdict that names the meta-action ("don't tune off this shot").
+    // Same decision as detectPourTruncated (pressure.size() >= 10 holds here).
+    const bool pourTruncated = !nonPuckBeverage && pourEnd > pourStart
+        && pour.peakPressureBar < PRESSURE_FLOOR_BAR;
     d.pourTruncated = pourTruncated;
-    double peakPressureBar = 0.0;
-    if (pourTruncated) {
-        for (const auto& pt : pressure) {
-            if (pt.x() < pourStart) continue;
-            if (pt.x() > pourEnd) break;
-            if (pt.y() > peakPressureBar) peakPressureBar = pt.y();
-        }
+    const double peakPressureBar = pourTruncated ? pour.peakPressureBar : 0.0;
+    if (pourTruncated)
         d.peakPressureBar = peakPressureBar;
-    }
 
     // --- dC/dt analysis (channeling) ---
+    // The turbo arm is shouldSkipChannelingCheck's, off the shared scan.
     bool skipChanneling = pourTruncated
-        || shouldSkipChannelingCheck(beverageType, flow, pourStart, pourEnd)
+        || nonPuckBeverage
+        || (pourStart < pourEnd && pour.turbo())
         || analysisFlags.contains(QStringLiteral("channeling_expected"));
 
     if (!skipChanneling && !conductanceDerivative.isEmpty()) {
@@ -846,17 +877,9 @@ ShotAnalysis::AnalysisResult ShotAnalysis::analyzeShot(
     // that never built pressure.
     const bool flowTrendOk = analysisFlags.contains(QStringLiteral("flow_trend_ok"));
     if (!pourTruncated && !flowTrendOk && pourStart > 0 && pourEnd > pourStart && flow.size() > 10) {
-        double flowStartSum = 0, flowEndSum = 0;
-        int flowStartCount = 0, flowEndCount = 0;
-        const double pourSpan = pourEnd - pourStart;
-        for (const auto& fp : flow) {
-            if (fp.x() < pourStart || fp.x() > pourEnd) continue;
-            double progress = (fp.x() - pourStart) / pourSpan;
-            if (progress < 0.3) { flowStartSum += fp.y(); ++flowStartCount; }
-            if (progress > 0.7) { flowEndSum += fp.y(); ++flowEndCount; }
-        }
-        if (flowStartCount > 0 && flowEndCount > 0) {
-            const double delta = (flowEndSum / flowEndCount) - (flowStartSum / flowStartCount);
+        if (pour.trendStartCount > 0 && pour.trendEndCount > 0) {
+            const double delta = (pour.trendEndSum / pour.trendEndCount)
+                - (pour.trendStartSum / pour.trendStartCount);
             d.flowTrendChecked = true;
             d.flowTrendDeltaMlPerSec = delta;
             if (delta > 0.5) {
@@ -1110,15 +1133,9 @@ ShotAnalysis::AnalysisResult ShotAnalysis::analyzeShot(
             QString axisLabel, unit;
             if (band.axis == ExpertBand::Axis::PressurePeak) {
                 // Peak pressure across the pour window (the pour-truncated
-                // path only populates peakPressureBar when it fires, so
-                // compute it here independently over the same window).
-                double pk = 0.0;
-                for (const auto& pt : pressure) {
-                    if (pt.x() < pourStart) continue;
-                    if (pt.x() > pourEnd) break;
-                    if (pt.y() > pk) pk = pt.y();
-                }
-                observed = pk;
+                // path only reports peakPressureBar when it fires; the scan
+                // has it either way).
+                observed = pour.peakPressureBar;
                 axisLabel = QStringLiteral("peak pressure");
                 unit = QStringLiteral("bar");
             } else if (band.axis == ExpertBand::Axis::ExtractionFlow) {
@@ -1143,12 +1160,7 @@ ShotAnalysis::AnalysisResult ShotAnalysis::analyzeShot(
                 // whose pour mixes fill/extraction at different flow rates
                 // would need a flow-mode-scoped window here. Empty window →
                 // observed stays NaN → strict no-op (never fire on absent data).
-                std::vector<double> fv;
-                for (const auto& fp : flow) {
-                    if (fp.x() < pourStart) continue;
-                    if (fp.x() > pourEnd) break;
-                    fv.push_back(fp.y());
-                }
+                std::vector<double>& fv = pour.flowValues;
                 if (!fv.empty()) {
                     std::sort(fv.begin(), fv.end());
                     const size_t n = fv.size();
@@ -90,6 +90,15 @@ struct ExpertBand {
 // tuning happens in one place.
 class ShotAnalysis {
 public:
+    // Bump whenever analyzeShot can return a different AnalysisResult for the
+    // same inputs: a threshold below, a detector, a summary line, a field
+    // added to DetectorResults. Stored analyses (and the badge columns
+    // projected from them) are stamped with it; a mismatch sends the shot
+    // back through analyzeShot on its next load or the history re-analysis
+    // job. KB and profile-resolution changes need no bump — they reach
+    // analyzeShot as AnalysisInputs, which the stored row is keyed on.
+    static constexpr int ALGORITHM_VERSION = 1;
+
     // --- Thresholds (tune here, applies everywhere) ---
     // Channeling detection via conductance derivative (dC/dt). This is the most
     // diagnostic puck integrity signal — it catches events invisible to flow or
@@ -201,7 +210,8 @@ public:
 
     // --- Helpers ---
 
-    // Find Y value at a given time using linear search (data assumed sorted by X).
+    // Y of the first sample at or after `time`, else the last (data sorted by
+    // X). A binary search; per-sample loops use a SeriesView::Cursor instead.
     static double findValueAtTime(const QVector<QPointF>& data, double time);
 
     // --- User-facing shot summary ---
@@ -299,8 +309,9 @@ public:
     // (|actual − goal| / goal ≤ WINDOW_CONVERGED_REL) and using
     // max(goal, FLOW_GOAL_MIN_AVG) as the denominator instead of `goal`
     // directly. The lookups also intentionally diverge: the channeling
-    // detector uses lookupOrNaN and drops out-of-bounds samples, while
-    // this gate uses findValueAtTime (clamping to first/last sample)
+    // detector interpolates (SeriesView::interpolateOrNaN) and drops
+    // out-of-bounds samples, while this gate steps (SeriesView::stepAt,
+    // clamping to first/last sample)
     // because legitimate short puck-failure gushers have flat-goal
     // signals where the half-window extends past the series start —
     // see the trim-bypass test in tst_shotanalysis. A flat target
@@ -1,5 +1,6 @@
 #include "shotsummarizer.h"
 #include "shotanalysis.h"
+#include "seriesview.h"
 #include "../history/shothistory_types.h"  // HistoryPhaseMarker — passed to ShotAnalysis::analyzeShot
 #include "../profile/profile.h"
 #include "profileshapeindex.h"   // resolveProfileKb — title steps, then shape
@@ -766,9 +767,10 @@ QString ShotSummarizer::renderShotAnalysisProse(const ShotSummary& summary, Rend
         const auto& actualCurve = phase.isFlowMode ? summary.flowCurve : summary.pressureCurve;
         const auto& goalCurve = phase.isFlowMode ? summary.flowGoalCurve : summary.pressureGoalCurve;
 
+        SeriesView::Cursor goalAt(goalCurve);
         for (const auto& pt : actualCurve) {
             if (pt.x() < phase.startTime || pt.x() > phase.endTime) continue;
-            double target = findValueAtTime(goalCurve, pt.x());
+            double target = goalAt.interpolateAt(pt.x());
             double dev = std::abs(pt.y() - target);
             if (dev > maxDev) {
                 maxDev = dev;
@@ -1576,65 +1578,22 @@ Keep responses concise and practical. The goal is a better-tasting next brew, no
 
 double ShotSummarizer::findValueAtTime(const QVector<QPointF>& data, double time)
 {
-    if (data.isEmpty()) return 0;
-
-    // Use binary search for O(log N) lookup in time-sorted data
-    auto it = std::lower_bound(data.begin(), data.end(), time, [](const QPointF& p, double t) {
-        return p.x() < t;
-    });
-
-    if (it == data.end()) return data.last().y();
-    if (it == data.begin()) return it->y();
-
-    // Linear interpolation between *prev and *it
-    const auto& p1 = *(it - 1);
-    const auto& p2 = *it;
-    double dx = p2.x() - p1.x();
-    if (std::abs(dx) < 1e-6) return p2.y(); // Guard against division by zero
-
-    double t = (time - p1.x()) / dx;
-    return p1.y() + t * (p2.y() - p1.y());
+    return SeriesView(data).interpolateAt(time);
 }
 
 double ShotSummarizer::calculateAverage(const QVector<QPointF>& data, double startTime, double endTime)
 {
-    if (data.isEmpty()) return 0;
-
-    double sum = 0;
-    int count = 0;
-    for (const auto& point : data) {
-        if (point.x() >= startTime && point.x() <= endTime) {
-            sum += point.y();
-            count++;
-        }
-    }
-    return count > 0 ? sum / count : 0;
+    return SeriesView(data).average(startTime, endTime);
 }
 
 double ShotSummarizer::calculateMax(const QVector<QPointF>& data, double startTime, double endTime)
 {
-    if (data.isEmpty()) return 0;
-
-    double maxVal = -std::numeric_limits<double>::infinity();
-    for (const auto& point : data) {
-        if (point.x() >= startTime && point.x() <= endTime) {
-            maxVal = std::max(maxVal, point.y());
-        }
-    }
-    return maxVal == -std::numeric_limits<double>::infinity() ? 0 : maxVal;
+    return SeriesView(data).max(startTime, endTime);
 }
 
 double ShotSummarizer::calculateMin(const QVector<QPointF>& data, double startTime, double endTime)
 {
-    if (data.isEmpty()) return 0;
-
-    double minVal = std::numeric_limits<double>::infinity();
-    for (const auto& point : data) {
-        if (point.x() >= startTime && point.x() <= endTime) {
-            minVal = std::min(minVal, point.y());
-        }
-    }
-    return minVal == std::numeric_limits<double>::infinity() ? 0 : minVal;
+    return SeriesView(data).min(startTime, endTime);
 }
 
 QString ShotSummarizer::sharedCorePhilosophy()
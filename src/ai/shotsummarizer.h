@@ -7,6 +7,7 @@
 #include <QVector>
 #include <QPointF>
 #include <QVariant>
+#include <atomic>
 #include <limits>
 
 #include "../history/shotprojection.h"
@@ -400,7 +401,7 @@ private:
 
     // Curve helpers — pure functions, kept static so they can be called from
     // file-scope helpers (e.g. makeWholeShotPhase) without a ShotSummarizer
-    // instance.
+    // instance. Binary searches over a SeriesView (seriesview.h).
     static double findValueAtTime(const QVector<QPointF>& data, double time);
     static double calculateAverage(const QVector<QPointF>& data, double startTime, double endTime);
     static double calculateMax(const QVector<QPointF>& data, double startTime, double endTime);
@@ -509,7 +510,10 @@ private:
     // new ambiguity class).
     struct RecipeAlias { QString key; QString id; };
     static QList<RecipeAlias> s_recipeAliases;
-    static bool s_knowledgeLoaded;
+    // Atomic: loadProfileKnowledge's unlocked first check runs on whatever
+    // thread asks (shot_eval and reanalysis workers in parallel), and the
+    // release store publishes the maps filled before it.
+    static std::atomic<bool> s_knowledgeLoaded;
     static void loadProfileKnowledge();
     static QString matchProfileKey(const QMap<QString, ProfileKnowledge>& knowledge,
                                    const QString& profileTitle, const QString& editorTypeHint);
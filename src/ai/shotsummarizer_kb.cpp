@@ -43,7 +43,7 @@
 QMap<QString, ShotSummarizer::ProfileKnowledge> ShotSummarizer::s_profileKnowledge;
 QMap<QString, QString> ShotSummarizer::s_aliasToId;
 QList<ShotSummarizer::RecipeAlias> ShotSummarizer::s_recipeAliases;
-bool ShotSummarizer::s_knowledgeLoaded = false;
+std::atomic<bool> ShotSummarizer::s_knowledgeLoaded{false};
 
 // Static cache for profile catalog (compact one-liner per KB profile)
 QString ShotSummarizer::s_profileCatalog;
@@ -134,10 +134,10 @@ expertBandFromJson(const QString& whoFor, const QJsonObject& eb)
 
 void ShotSummarizer::loadProfileKnowledge()
 {
-    if (s_knowledgeLoaded) return;
+    if (s_knowledgeLoaded.load(std::memory_order_acquire)) return;
     static QMutex mutex;
     QMutexLocker locker(&mutex);
-    if (s_knowledgeLoaded) return;  // re-check after acquiring lock
+    if (s_knowledgeLoaded.load(std::memory_order_relaxed)) return;  // re-check after acquiring lock
 
     QFile file(QStringLiteral(":/ai/profile_knowledge.json"));
     if (!file.open(QIODevice::ReadOnly)) {
@@ -145,7 +145,7 @@ void ShotSummarizer::loadProfileKnowledge()
         // Latch even on failure: the resource won't reappear within a
         // process lifetime; a per-call retry in test binaries (which may
         // not link the qrc) is noise. Empty KB → every consumer no-ops.
-        s_knowledgeLoaded = true;
+        s_knowledgeLoaded.store(true, std::memory_order_release);
         return;
     }
     const QByteArray raw = file.readAll();
@@ -156,7 +156,7 @@ void ShotSummarizer::loadProfileKnowledge()
     if (perr.error != QJsonParseError::NoError || !doc.isObject()) {
         qWarning() << "ShotSummarizer: profile_knowledge.json parse error:"
                    << perr.errorString();
-        s_knowledgeLoaded = true;
+        s_knowledgeLoaded.store(true, std::memory_order_release);
         return;
     }
     const QJsonArray profiles = doc.object().value(QStringLiteral("profiles")).toArray();
@@ -261,7 +261,7 @@ void ShotSummarizer::loadProfileKnowledge()
              << "alias keys )";
 
     buildProfileCatalog();
-    s_knowledgeLoaded = true;
+    s_knowledgeLoaded.store(true, std::memory_order_release);
 }
 
 void ShotSummarizer::buildProfileCatalog()
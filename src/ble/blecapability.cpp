@@ -1,5 +1,6 @@
 #include "blecapability.h"
 #include "bluetoothlogging.h"
+#include "../core/taskexecutor.h"
 
 #include <QCoreApplication>
 #include <QDebug>
@@ -124,9 +125,7 @@ void logLinuxBtDiagnosticsOnce()
         // QProcess::waitForFinished() blocks up to 2 s per subprocess; spawn
         // a worker thread so the BLE error handler (main thread) returns
         // immediately.
-        QThread* t = QThread::create([] { collectAndLogDiagnostics(); });
-        QObject::connect(t, &QThread::finished, t, &QObject::deleteLater);
-        t->start();
+        TaskExecutor::instance().submit(TaskLane::Background, [] { collectAndLogDiagnostics(); });
     });
 #endif
 }
@@ -1,6 +1,7 @@
 #include "blegattqueue.h"
 
 #include "blegattlogging.h"
+#include "bleiothread.h"
 
 #include <QTimer>
 
@@ -34,7 +35,17 @@ QString dispatchLine(const QString& label, qsizetype depth, int waitedMs) {
 
 }  // namespace BleGatt
 
+// Every public entry point starts the same way: off the queue's own thread, a
+// mutator is posted there and a query blocks on it (bleiothread.h). Posting
+// keeps a main-thread caller from ever waiting on the radio's thread just to
+// hand over work; FIFO delivery keeps it ordered against the caller's later
+// queries, which travel through the same event queue.
+
 void BleGattQueue::submit(Operation op) {
+    if (BleIo::needsHop(this)) {
+        BleIo::post(this, [this, op = std::move(op)]() mutable { submit(std::move(op)); });
+        return;
+    }
     if (!validate(op)) return;
     op.enqueuedAtMs = nowMs();
     m_queue.enqueue(std::move(op));
@@ -43,6 +54,10 @@ void BleGattQueue::submit(Operation op) {
 }
 
 void BleGattQueue::submitFront(Operation op) {
+    if (BleIo::needsHop(this)) {
+        BleIo::post(this, [this, op = std::move(op)]() mutable { submitFront(std::move(op)); });
+        return;
+    }
     if (!validate(op)) return;
     op.enqueuedAtMs = nowMs();
     m_queue.prepend(std::move(op));
@@ -189,6 +204,10 @@ void BleGattQueue::dispatchNext() {
     // The issue callback runs with the slot already held, so anything it
     // submits re-entrantly queues behind rather than being dispatched under it.
     //
+    issueInFlight();
+}
+
+void BleGattQueue::issueInFlight() {
     // Copied out of m_inFlight before it is called. The callback can reach back
     // in and clear the slot on the same stack — noteFailed() from a guard that
     // never reached the platform, forget() from a consumer that tears the link
@@ -196,7 +215,33 @@ void BleGattQueue::dispatchNext() {
     // whose body is currently running, which is undefined behaviour. A local
     // copy outlives the call.
     const std::function<void()> issue = m_inFlight->issue;
-    issue();
+    QObject* context = m_inFlight->context.data();
+    if (!context || !BleIo::needsHop(context)) {
+        issue();
+        return;
+    }
+
+    // A requester on another thread (a scale, while the DE1 owns the I/O
+    // thread). The slot is held from here, so nothing else is issued under it
+    // while the call is in transit. Generation-guarded like a retry: only that
+    // requester can end its own operation, from its own thread, so if the
+    // generation still matches when this runs, the slot is still its.
+    const quint64 generation = m_generation;
+    BleIo::post(context, [this, generation, issue]() {
+        if (m_generation != generation) return;
+        issue();
+    });
+}
+
+void BleGattQueue::notifyAbandoned(const Operation& op) {
+    if (!op.onAbandoned) return;
+    QObject* context = op.context.data();
+    if (!context || !BleIo::needsHop(context)) {
+        op.onAbandoned();
+        return;
+    }
+    std::function<void()> onAbandoned = op.onAbandoned;
+    BleIo::post(context, std::move(onAbandoned));
 }
 
 void BleGattQueue::chargeForeignWait() {
@@ -217,6 +262,10 @@ void BleGattQueue::chargeForeignWait() {
 }
 
 void BleGattQueue::noteSucceeded(Requester requester) {
+    if (BleIo::needsHop(this)) {
+        BleIo::post(this, [this, requester]() { noteSucceeded(requester); });
+        return;
+    }
     // A late or duplicate completion for an operation that is no longer in
     // flight must not release someone else's slot. This is the same
     // misattribution BleTransport::onDescriptorWritten guards against when a
@@ -234,6 +283,10 @@ void BleGattQueue::noteSucceeded(Requester requester) {
 }
 
 void BleGattQueue::noteFailed(Requester requester) {
+    if (BleIo::needsHop(this)) {
+        BleIo::post(this, [this, requester]() { noteFailed(requester); });
+        return;
+    }
     if (!m_inFlight.has_value() || m_inFlight->requester != requester) return;
 
     // A second failure report arriving INSIDE the retry delay must not arm a
@@ -267,9 +320,7 @@ void BleGattQueue::noteFailed(Requester requester) {
         QTimer::singleShot(m_inFlight->policy.retryDelayMs, this, [this, generation]() {
             if (m_generation != generation || !m_inFlight.has_value()) return;
             m_retryPending = false;
-            // Copied for the same reason as in dispatchNext().
-            const std::function<void()> issue = m_inFlight->issue;
-            issue();
+            issueInFlight();
         });
         return;
     }
@@ -282,13 +333,18 @@ void BleGattQueue::noteFailed(Requester requester) {
     m_retryPending = false;
     ++m_generation;
 
-    if (done.onAbandoned) done.onAbandoned();
+    notifyAbandoned(done);
 
     scheduleDispatch();
     emitDrainedIfIdle();
 }
 
 qsizetype BleGattQueue::forget(Requester requester) {
+    // Blocking, not posted: a transport destructor relies on its work being
+    // gone when this returns — the requester tag is its address.
+    if (BleIo::needsHop(this))
+        return BleIo::callOn(this, [this, requester]() { return forget(requester); });
+
     qsizetype dropped = 0;
 
     QQueue<Operation> kept;
@@ -322,6 +378,9 @@ qsizetype BleGattQueue::forget(Requester requester) {
 }
 
 qsizetype BleGattQueue::discard(Requester requester, const QList<QBluetoothUuid>& keys) {
+    if (BleIo::needsHop(this))
+        return BleIo::callOn(this, [this, requester, &keys]() { return discard(requester, keys); });
+
     if (keys.isEmpty() || m_queue.isEmpty()) return 0;
 
     const qsizetype before = m_queue.size();
@@ -346,7 +405,21 @@ qsizetype BleGattQueue::discard(Requester requester, const QList<QBluetoothUuid>
     return dropped;
 }
 
+bool BleGattQueue::isBusy() const {
+    if (BleIo::needsHop(this))
+        return BleIo::callOn(this, [this]() { return isBusy(); });
+    return m_inFlight.has_value();
+}
+
+qsizetype BleGattQueue::pendingCount() const {
+    if (BleIo::needsHop(this))
+        return BleIo::callOn(this, [this]() { return pendingCount(); });
+    return m_queue.size();
+}
+
 qsizetype BleGattQueue::pendingCount(Requester requester) const {
+    if (BleIo::needsHop(this))
+        return BleIo::callOn(this, [this, requester]() { return pendingCount(requester); });
     qsizetype n = 0;
     for (const Operation& op : std::as_const(m_queue))
         if (op.requester == requester) ++n;
@@ -354,14 +427,20 @@ qsizetype BleGattQueue::pendingCount(Requester requester) const {
 }
 
 BleGattQueue::Requester BleGattQueue::inFlightRequester() const {
+    if (BleIo::needsHop(this))
+        return BleIo::callOn(this, [this]() { return inFlightRequester(); });
     return m_inFlight.has_value() ? m_inFlight->requester : nullptr;
 }
 
 QBluetoothUuid BleGattQueue::inFlightKey() const {
+    if (BleIo::needsHop(this))
+        return BleIo::callOn(this, [this]() { return inFlightKey(); });
     return m_inFlight.has_value() ? m_inFlight->key : QBluetoothUuid();
 }
 
 QString BleGattQueue::inFlightLabel() const {
+    if (BleIo::needsHop(this))
+        return BleIo::callOn(this, [this]() { return inFlightLabel(); });
     return m_inFlight.has_value() ? m_inFlight->label : QString();
 }
 
@@ -5,9 +5,11 @@
 #include "../core/logcollapse.h"
 
 #include <QElapsedTimer>
+#include <QPointer>
 #include <QQueue>
 #include <QString>
 
+#include <atomic>
 #include <functional>
 #include <optional>
 
@@ -81,6 +83,18 @@
  * generous: a dead scale link would hold the shared slot through the DE1's
  * ~32 s worst-case retry sequence, starving the machine the budget exists to
  * protect.
+ *
+ * ---- Threads --------------------------------------------------------------
+ *
+ * Where main.cpp runs the BLE I/O thread, the process-wide instance lives on
+ * it, beside the DE1's BleTransport, so a stop-at-weight never waits for the
+ * GUI thread to get a turn (see sawstopchannel.h). The scale and refractometer
+ * transports stay on the main thread. Every public method is therefore callable
+ * from any thread: mutators are posted to the queue's thread, queries block on
+ * it (bleiothread.h — the I/O thread itself never blocks on anyone), and an
+ * operation's issue and onAbandoned callbacks run on the thread of its
+ * `context`. The ordering guarantees are unchanged, because all of the state
+ * is still touched by exactly one thread.
  */
 namespace BleGatt {
 /**
@@ -205,6 +219,15 @@ public:
         // requester tearing down is not told about work it is itself dropping.
         std::function<void()> onAbandoned;
         Policy policy;
+        // The object issue and onAbandoned belong to. When it lives on another
+        // thread than the queue, both are queued to it instead of being called
+        // on the queue's thread — a scale's QLowEnergyService may only be
+        // touched from the thread that owns it. Null means "call in place",
+        // which is what tests and same-thread callers get.
+        //
+        // A hopped issue is dropped if the slot has moved on by the time it
+        // runs, and both callbacks are dropped if the context is destroyed.
+        QPointer<QObject> context;
     };
 
     /**
@@ -263,10 +286,10 @@ public:
     qsizetype discard(Requester requester, const QList<QBluetoothUuid>& keys);
 
     /** True while an operation is outstanding, for any requester. */
-    bool isBusy() const { return m_inFlight.has_value(); }
+    bool isBusy() const;
 
     /** Queued (not in-flight) operations, all requesters. */
-    qsizetype pendingCount() const { return m_queue.size(); }
+    qsizetype pendingCount() const;
 
     /** Queued operations belonging to one requester. */
     qsizetype pendingCount(Requester requester) const;
@@ -311,6 +334,10 @@ signals:
 
 private:
     void dispatchNext();
+    // Calls the in-flight operation's issue callback, on its context's thread.
+    void issueInFlight();
+    // Calls a released operation's onAbandoned, on its context's thread.
+    static void notifyAbandoned(const Operation& op);
     // Rejects an unrunnable operation at submit. See the definition.
     static bool validate(const Operation& op);
     void scheduleDispatch();
@@ -357,8 +384,9 @@ private:
     // Bumped on EVERY slot transition (dispatch, success, abandon, teardown).
     // A delayed retry captures it and reissues only if it still matches, so a
     // retry whose operation was dropped mid-delay cannot fire against whatever
-    // took the slot next.
-    quint64 m_generation = 0;
+    // took the slot next. Atomic because an issue hopped to a requester on
+    // another thread reads it there for the same check.
+    std::atomic<quint64> m_generation{0};
 
     // True between posting a dispatch and running it. The guard a timer's
     // isActive() used to provide, without the timer.
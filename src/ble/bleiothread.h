@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QMetaObject>
+#include <QObject>
+#include <QThread>
+
+#include <type_traits>
+#include <utility>
+
+/**
+ * Thread hops for the BLE I/O thread.
+ *
+ * On platforms that run it (see main.cpp), the DE1's BleTransport, the shared
+ * BleGattQueue and the SawStopChannel live on a dedicated "BLE-IO" thread, so a
+ * stop-at-weight write never waits for the GUI thread. Everything else — the
+ * scale transports, DE1Device, BLEManager, QML — stays on the main thread and
+ * reaches those objects through the two helpers below.
+ *
+ * ONE-WAY RULE: other threads may block on the I/O thread (callOn), but the I/O
+ * thread never blocks on anyone. Everything it sends outward is a queued signal
+ * or a post(). Two threads each blocking on the other is a deadlock with no log
+ * line, so the rule is what keeps callOn() safe — do not add a blocking call in
+ * the other direction.
+ *
+ * Where there is no I/O thread (Apple platforms, tests) every object is on the
+ * caller's thread, needsHop() is false, and both helpers run inline — the code
+ * paths are exactly the single-threaded ones they replaced.
+ */
+namespace BleIo {
+
+/**
+ * True when `obj` lives on another thread that is running an event loop.
+ *
+ * A finished thread counts as "no hop": a blocking call into a thread that will
+ * never run it again would hang forever, and after shutdown the caller is the
+ * only thread left touching these objects anyway.
+ */
+inline bool needsHop(const QObject* obj) {
+    QThread* owner = obj->thread();
+    return owner && owner != QThread::currentThread() && owner->isRunning();
+}
+
+/** Run `f` on `obj`'s thread and wait for it. Inline when no hop is needed. */
+template <typename F>
+auto callOn(const QObject* obj, F&& f) -> decltype(f()) {
+    using R = decltype(f());
+    if (!needsHop(obj)) return f();
+    auto* target = const_cast<QObject*>(obj);
+    if constexpr (std::is_void_v<R>) {
+        QMetaObject::invokeMethod(target, std::forward<F>(f), Qt::BlockingQueuedConnection);
+    } else {
+        R result{};
+        QMetaObject::invokeMethod(target, [&result, &f]() { result = f(); },
+                                  Qt::BlockingQueuedConnection);
+        return result;
+    }
+}
+
+/**
+ * Queue `f` on `obj`'s thread. Dropped, not run, if `obj` is destroyed first —
+ * the same guarantee as any queued invocation with a context object.
+ */
+template <typename F>
+void post(QObject* obj, F&& f) {
+    QMetaObject::invokeMethod(obj, std::forward<F>(f), Qt::QueuedConnection);
+}
+
+}  // namespace BleIo
@@ -1,12 +1,14 @@
 #include "bletransport.h"
 #include "blecapability.h"
 #include "bledeviceid.h"
+#include "bleiothread.h"
 #include "blecontrollererror.h"
 #include "bleserviceerror.h"
 #include "de1logging.h"
 #ifndef DECENZA_TESTING
 #include "blemanager.h"
 #endif
+#include "core/latencystats.h"
 #include "protocol/de1characteristics.h"
 
 #include <QBluetoothAddress>
@@ -95,6 +97,14 @@ BleTransport::BleTransport(QObject* parent, BleGattQueue* queue)
     : DE1Transport(parent)
     , m_gattQueue(queue ? queue : &BleGattQueue::instance())
 {
+    // Parented to this object, though they are members, so moveToThread()
+    // carries them to the BLE I/O thread with it — a timer can only be started
+    // from the thread it belongs to. A member child is removed from the child
+    // list by its own destructor, before ~QObject would delete it.
+    m_operationTimeoutTimer.setParent(this);
+    m_retryTimer.setParent(this);
+    m_connectWatchdogTimer.setParent(this);
+
     // The outer bound on an operation the platform never answers. Retry and
     // abandonment are the queue's; this only says "no answer at all is also an
     // answer". See the member's declaration for why there is exactly one.
@@ -164,12 +174,25 @@ BleTransport::~BleTransport() {
 }
 
 // -- DE1Transport interface implementation --
+//
+// Callable from any thread. Where DE1Device has moved this transport to the BLE
+// I/O thread, a call from the main thread is posted there (or, for the three
+// that return a value, waits for it) — see bleiothread.h. Posting preserves the
+// caller's order, which is all the queue ever relied on.
 
 void BleTransport::write(const QBluetoothUuid& uuid, const QByteArray& data) {
+    if (BleIo::needsHop(this)) {
+        BleIo::post(this, [this, uuid, data]() { write(uuid, data); });
+        return;
+    }
     submitWrite(uuid, data, /*toFront=*/false);
 }
 
 void BleTransport::writeUrgent(const QBluetoothUuid& uuid, const QByteArray& data) {
+    if (BleIo::needsHop(this)) {
+        BleIo::post(this, [this, uuid, data]() { writeUrgent(uuid, data); });
+        return;
+    }
     // Urgency is queue POSITION, never a bypass: this jumps ahead of everything
     // waiting but still waits for whatever is outstanding, on this device or any
     // other. That is the whole guarantee the queue provides.
@@ -187,10 +210,18 @@ void BleTransport::writeUrgent(const QBluetoothUuid& uuid, const QByteArray& dat
 }
 
 void BleTransport::read(const QBluetoothUuid& uuid) {
+    if (BleIo::needsHop(this)) {
+        BleIo::post(this, [this, uuid]() { read(uuid); });
+        return;
+    }
     submitRead(uuid);
 }
 
 void BleTransport::subscribe(const QBluetoothUuid& uuid) {
+    if (BleIo::needsHop(this)) {
+        BleIo::post(this, [this, uuid]() { subscribe(uuid); });
+        return;
+    }
     // Ad-hoc subscribe outside the connect sequence — the firmware updater's
     // FW_MAP_REQUEST. Not a required stream: nothing about the machine's
     // usability depends on it.
@@ -198,6 +229,10 @@ void BleTransport::subscribe(const QBluetoothUuid& uuid) {
 }
 
 void BleTransport::subscribeAll() {
+    if (BleIo::needsHop(this)) {
+        BleIo::post(this, [this]() { subscribeAll(); });
+        return;
+    }
     if (!m_service) return;
 
     m_streamsNotEnabled.clear();
@@ -242,6 +277,10 @@ void BleTransport::subscribeAll() {
 }
 
 void BleTransport::disconnect() {
+    if (BleIo::needsHop(this)) {
+        BleIo::post(this, [this]() { disconnect(); });
+        return;
+    }
     // Releases the slot if we hold it and drops everything of ours still
     // waiting, including any half-finished subscribeAll() sequence — a
     // torn-down connection's queued work must not bleed into the next attempt,
@@ -290,6 +329,8 @@ void BleTransport::disconnect() {
 }
 
 qsizetype BleTransport::clearQueue() {
+    if (BleIo::needsHop(this))
+        return BleIo::callOn(this, [this]() { return clearQueue(); });
     // forget() counts the in-flight operation as well as the queued ones, which
     // is what this caller needs: it is about to change machine state and must
     // invalidate the MMR dedup cache if an MMR write was mid-air. Under-report
@@ -299,6 +340,8 @@ qsizetype BleTransport::clearQueue() {
 }
 
 qsizetype BleTransport::discardQueued(const QList<QBluetoothUuid>& uuids) {
+    if (BleIo::needsHop(this))
+        return BleIo::callOn(this, [this, &uuids]() { return discardQueued(uuids); });
     // Scoped to this transport's own entries, and deliberately does NOT touch
     // the in-flight operation — the asymmetry with clearQueue() above. Here the
     // caller is withdrawing work it queued itself, and an operation already
@@ -308,6 +351,8 @@ qsizetype BleTransport::discardQueued(const QList<QBluetoothUuid>& uuids) {
 }
 
 bool BleTransport::isConnected() const {
+    if (BleIo::needsHop(this))
+        return BleIo::callOn(this, [this]() { return isConnected(); });
     return m_controller &&
            (m_controller->state() == QLowEnergyController::ConnectedState ||
             m_controller->state() == QLowEnergyController::DiscoveredState) &&
@@ -318,6 +363,34 @@ bool BleTransport::isConnected() const {
 // -- BLE-specific public API --
 
 void BleTransport::connectToDevice(const QBluetoothDeviceInfo& device) {
+    // The connection-priority latch is read HERE, on the caller's thread, and
+    // carried to the connect. BLEManager lives on the main thread, and
+    // onControllerConnected() may run on the BLE I/O thread, which neither
+    // reads another thread's state nor blocks on it. A latch set mid-run only
+    // ever took effect on the next connect, so one snapshot per connect is the
+    // contract it already had.
+    bool skipHighPriority = false;
+    QString skipHighTrigger;
+#ifndef DECENZA_TESTING
+    if (auto* mgr = BLEManager::instance(); mgr && !BleIo::needsHop(mgr)) {
+        skipHighPriority = mgr->scaleSkipHighPriority();
+        if (skipHighPriority) skipHighTrigger = mgr->scaleSkipHighTriggerKind();
+    }
+#endif
+    if (BleIo::needsHop(this)) {
+        BleIo::post(this, [this, device, skipHighPriority, skipHighTrigger]() {
+            beginConnect(device, skipHighPriority, skipHighTrigger);
+        });
+        return;
+    }
+    beginConnect(device, skipHighPriority, skipHighTrigger);
+}
+
+void BleTransport::beginConnect(const QBluetoothDeviceInfo& device,
+                                bool skipHighPriority, const QString& skipHighTrigger) {
+    m_skipHighPriority = skipHighPriority;
+    m_skipHighTrigger = skipHighTrigger;
+
     const QString deviceId = getDeviceIdentifier(device);
 
     bool zombieReconnect = false;
@@ -419,26 +492,20 @@ void BleTransport::onControllerConnected() {
     // connectionUpdated() signal exists but Android's BLE stack does not
     // reliably fire the underlying onConnectionUpdated callback, so Qt never
     // emits it in practice — no negotiated-interval feedback is available.)
-#ifndef DECENZA_TESTING
-    if (auto* mgr = BLEManager::instance(); mgr && mgr->scaleSkipHighPriority()) {
+    //
+    // The latch is the snapshot connectToDevice() took on the caller's thread.
+    // Test builds never set it (blemanager.cpp is not linked there), so they
+    // keep the unconditional HIGH request.
+    if (m_skipHighPriority) {
         log(QString("DE1 connection-priority: skipping HIGH "
                     "(dual-HIGH-incapable latch set, trigger=%1) — DE1 link "
                     "stays at BALANCED")
-                .arg(mgr->scaleSkipHighTriggerKind()));
+                .arg(m_skipHighTrigger));
     } else {
         log("DE1 connection-priority: requesting HIGH");
         QLowEnergyConnectionParameters params;
         m_controller->requestConnectionUpdate(params);
     }
-#else
-    // Test build: blemanager.h is intentionally not included (see the
-    // #ifndef DECENZA_TESTING include guard at the top of this file) and
-    // blemanager.cpp is not linked, so BLEManager::instance() is unavailable
-    // here — keep the original unconditional HIGH request. Production builds
-    // (DECENZA_TESTING never defined) always take the latch-aware branch above.
-    QLowEnergyConnectionParameters params;
-    m_controller->requestConnectionUpdate(params);
-#endif
 
     m_controller->discoverServices();
 }
@@ -562,7 +629,15 @@ void BleTransport::onControllerError(QLowEnergyController::Error error) {
     // most of the BLE stack (scales, refractometers, permissions).
     if (error == QLowEnergyController::UnknownRemoteDeviceError
         && !BleCapability::linuxMissing()) {
-        if (auto* m = BLEManager::instance()) m->requestBluezCacheHint();
+        // Posted when this transport is on the BLE I/O thread: BLEManager is a
+        // main-thread object, and the I/O thread never calls into another
+        // thread's state directly.
+        if (auto* m = BLEManager::instance()) {
+            if (BleIo::needsHop(m))
+                BleIo::post(m, [m]() { m->requestBluezCacheHint(); });
+            else
+                m->requestBluezCacheHint();
+        }
     }
 #endif
 
@@ -739,7 +814,7 @@ void BleTransport::onCharacteristicChanged(const QLowEnergyCharacteristic& c, co
     // it ends no operation, which is why onCharacteristicRead below is a
     // separate slot rather than this one wired to both signals.
     m_notificationLiveness.restart();
-    emit dataReceived(c.uuid(), value);
+    emit dataReceived(c.uuid(), value, LatencyStats::nowMs());
 }
 
 void BleTransport::onCharacteristicRead(const QLowEnergyCharacteristic& c, const QByteArray& value) {
@@ -1014,6 +1089,7 @@ BleGattQueue::Operation BleTransport::operationFor(const QBluetoothUuid& key,
                                                    int timeoutMs) {
     BleGattQueue::Operation op;
     op.requester = this;
+    op.context = this;
     op.key = key;
     op.label = QStringLiteral("%1 %2").arg(verb, key.toString().mid(1, 8));
     // Named, not positional: both fields are ints, so a swapped pair would
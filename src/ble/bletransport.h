@@ -25,6 +25,10 @@
  * platform while any device has an operation outstanding. See blegattqueue.h
  * for why that is process-wide rather than per-device (#1819).
  *
+ * Threads: DE1Device may move this object to the BLE I/O thread (bleiothread.h).
+ * The public API below is then callable from any thread and hops to the
+ * transport's own; signals reach main-thread receivers queued, as usual.
+ *
  * Lifecycle:
  *   1. Construct BleTransport
  *   2. Call connectToDevice(deviceInfo)
@@ -109,6 +113,10 @@ private:
     void log(const QString& message);
     void info(const QString& message);
     void warn(const QString& message);
+    // connectToDevice() on the transport's own thread, with the latch snapshot
+    // taken on the caller's.
+    void beginConnect(const QBluetoothDeviceInfo& device,
+                      bool skipHighPriority, const QString& skipHighTrigger);
     bool setupController(const QBluetoothDeviceInfo& device);
     void setupService();
     void writeCharacteristic(const QBluetoothUuid& uuid, const QByteArray& data);
@@ -356,6 +364,11 @@ private:
     // be false.
     void forgetWriteFailureState();
 
+    // BLEManager's dual-HIGH-incapable latch as it stood when this connect
+    // started; read by onControllerConnected(). See connectToDevice().
+    bool m_skipHighPriority = false;
+    QString m_skipHighTrigger;
+
     // Service discovery retry logic
     QBluetoothDeviceInfo m_pendingDevice;
     QTimer m_retryTimer;
@@ -4,9 +4,11 @@
 #include "machine/sawlogging.h"
 #include "de1transport.h"
 #include "bletransport.h"
+#include "sawstopchannel.h"
 #include "protocol/binarycodec.h"
 #include "protocol/firmwarepackets.h"
 #include "profile/profile.h"
+#include "../core/latencystats.h"
 #include "../core/settings_hardware.h"
 
 #ifdef DECENZA_SIMULATOR
@@ -58,6 +60,7 @@
 #define WATER_LOG(msg)          DE1_LOG_STDERR_TAGGED("WaterLevel", msg)
 #define SHOTSETTINGS_LOG(msg)   DE1_LOG_STDERR_TAGGED("ShotSettings", msg)
 #include <QStringList>
+#include <QThread>
 #include <chrono>
 #include <memory>
 
@@ -136,12 +139,48 @@ void DE1Device::setTransport(DE1Transport* transport) {
                 this, &DE1Device::logMessage);
     }
 
+    updateSawStopChannel();
+
     if (wasConnected != isConnected()) {
         emit connectedChanged();
         emit guiEnabledChanged();
     }
 }
 
+void DE1Device::setSawStopChannel(SawStopChannel* channel) {
+    if (m_sawStopChannel) {
+        m_sawStopChannel->arm(nullptr);
+        QObject::disconnect(m_sawStopChannel, nullptr, this, nullptr);
+    }
+    m_sawStopChannel = channel;
+    if (m_sawStopChannel) {
+        // All three arrive queued: the channel lives on the I/O thread.
+        connect(m_sawStopChannel, &SawStopChannel::stopIssued,
+                this, &DE1Device::onSawStopIssued);
+        connect(m_sawStopChannel, &SawStopChannel::stopAcked, this,
+                [this](qint64 sawTriggerMs, qint64 writeMs, qint64 ackMs) {
+            reportSawLatency(sawTriggerMs, writeMs, ackMs, QStringLiteral("io"));
+        });
+        connect(m_sawStopChannel, &SawStopChannel::fallback, this,
+                [this](qint64 sawTriggerMs) { stopOperationUrgent(sawTriggerMs); });
+    }
+    updateSawStopChannel();
+}
+
+void DE1Device::updateSawStopChannel() {
+    if (!m_sawStopChannel) return;
+    // Only a BLE transport on the channel's own thread: the channel calls it
+    // inline. Serial (USB) transports and the simulator keep the main-thread
+    // route, and so does a firmware flash, whose guard lives here and must see
+    // the stop to drop it.
+    auto* ble = qobject_cast<BleTransport*>(m_transport);
+    const bool fastPath = ble
+        && ble->thread() == m_sawStopChannel->thread()
+        && !m_simulationMode
+        && !m_firmwareFlashInProgress;
+    m_sawStopChannel->arm(fastPath ? ble : nullptr);
+}
+
 QString DE1Device::connectionType() const {
     if (m_simulationMode) return QStringLiteral("Simulation");
     if (!m_transport) return QString();
@@ -326,11 +365,12 @@ void DE1Device::onTransportDisconnected() {
     emit guiEnabledChanged();
 }
 
-void DE1Device::onTransportDataReceived(const QBluetoothUuid& uuid, const QByteArray& data) {
+void DE1Device::onTransportDataReceived(const QBluetoothUuid& uuid, const QByteArray& data,
+                                        qint64 receivedMs) {
     if (uuid == DE1::Characteristic::STATE_INFO) {
         parseStateInfo(data);
     } else if (uuid == DE1::Characteristic::SHOT_SAMPLE) {
-        parseShotSample(data);
+        parseShotSample(data, receivedMs);
     } else if (uuid == DE1::Characteristic::SHOT_SETTINGS) {
         parseShotSettings(data);
     } else if (uuid == DE1::Characteristic::WATER_LEVELS) {
@@ -373,36 +413,49 @@ void DE1Device::onTransportWriteComplete(const QBluetoothUuid& uuid, const QByte
         && uuid == DE1::Characteristic::REQUESTED_STATE
         && data.size() == 1
         && static_cast<uint8_t>(data[0]) == static_cast<uint8_t>(DE1::State::Idle)) {
-        qint64 ackMs = monotonicMsNow();
-        qint64 dispatchMs = m_lastSawWriteMs - m_lastSawTriggerMs;
-        qint64 bleAckMs = ackMs - m_lastSawWriteMs;
-        qint64 totalMs = ackMs - m_lastSawTriggerMs;
-        // Tier by what happened, not by importance. A normal stop is developer
-        // detail and belongs at DEBUG among the rest; a slow one is the single
-        // most consequential thing in the log for that shot, and per LOGGING.md
-        // a fault whose reader can only find it by scrolling through the normal
-        // case is a fault nobody reads.
-        //
-        // bleAckMs now spans the shared GATT queue, so it includes any wait
-        // behind another device's operation — the queue's own FOREIGN_WAIT_WARN
-        // line names which one. Read the two together.
-        if (bleAckMs >= SAW_SLOW_ACK_WARN_MS) {
-            SAW_WARN_STDERR("Latency", QStringLiteral(
-                "the stop-at-weight command took %1 ms to reach the machine "
-                "(dispatch=%2 ms, total=%3 ms). Bluetooth was busy; the shot may "
-                "have run past its target weight. A [Bluetooth][GattQueue] line "
-                "just before this names the device that held the radio.")
-                    .arg(bleAckMs).arg(dispatchMs).arg(totalMs));
-        } else {
-            SAW_LOG_STDERR("Latency", QStringLiteral("dispatch=%1 ms, bleAck=%2 ms, total=%3 ms")
-                                          .arg(dispatchMs).arg(bleAckMs).arg(totalMs));
-        }
+        reportSawLatency(m_lastSawTriggerMs, m_lastSawWriteMs, monotonicMsNow(),
+                         QStringLiteral("main"));
         m_sawStopWritePending = false;
         m_lastSawTriggerMs = 0;
         m_lastSawWriteMs = 0;
     }
 }
 
+void DE1Device::reportSawLatency(qint64 triggerMs, qint64 writeMs, qint64 ackMs,
+                                 const QString& path) {
+    qint64 dispatchMs = writeMs - triggerMs;
+    qint64 bleAckMs = ackMs - writeMs;
+    qint64 totalMs = ackMs - triggerMs;
+    // Dispatch was already recorded when the write was issued — a stop whose
+    // ACK never comes still counts there. This leg only exists once it does.
+    LatencyStats::record(LatencyStats::Leg::DispatchToAck, bleAckMs);
+    // Tier by what happened, not by importance. A normal stop is developer
+    // detail and belongs at DEBUG among the rest; a slow one is the single
+    // most consequential thing in the log for that shot, and per LOGGING.md
+    // a fault whose reader can only find it by scrolling through the normal
+    // case is a fault nobody reads.
+    //
+    // bleAckMs now spans the shared GATT queue, so it includes any wait
+    // behind another device's operation — the queue's own FOREIGN_WAIT_WARN
+    // line names which one. Read the two together.
+    //
+    // `path` is on both lines because it decides how to read `dispatch`: on
+    // "io" it is the BLE I/O thread's turn and should stay in single digits;
+    // on "main" it includes the GUI thread's, which is what a GC pause
+    // stretches (docs/ANDROID_MEMORY_GC_PRESSURE.md).
+    if (bleAckMs >= SAW_SLOW_ACK_WARN_MS) {
+        SAW_WARN_STDERR("Latency", QStringLiteral(
+            "the stop-at-weight command took %1 ms to reach the machine "
+            "(dispatch=%2 ms, total=%3 ms, path=%4). Bluetooth was busy; the shot "
+            "may have run past its target weight. A [Bluetooth][GattQueue] line "
+            "just before this names the device that held the radio.")
+                .arg(bleAckMs).arg(dispatchMs).arg(totalMs).arg(path));
+    } else {
+        SAW_LOG_STDERR("Latency", QStringLiteral("dispatch=%1 ms, bleAck=%2 ms, total=%3 ms, path=%4")
+                                      .arg(dispatchMs).arg(bleAckMs).arg(totalMs).arg(path));
+    }
+}
+
 // -- Connection state --
 
 bool DE1Device::isConnected() const {
@@ -461,6 +514,8 @@ void DE1Device::setSimulationMode(bool enabled) {
         emit firmwareVersionChanged();
     }
 
+    updateSawStopChannel();
+
     emit simulationModeChanged();
     emit connectedChanged();
     emit guiEnabledChanged();
@@ -563,8 +618,17 @@ void DE1Device::connectToDevice(const QBluetoothDeviceInfo& device) {
     DEVICE_INFO(QStringLiteral("Connect attempt starting for %1")
                     .arg(getDeviceIdentifier(device)));
 
-    // Create a new BleTransport and wire it up (DE1Device owns it)
-    auto* bleTransport = new BleTransport(this);
+    // Create a new BleTransport and wire it up (DE1Device owns it). On the BLE
+    // I/O thread it cannot be our child — a parent and its children share a
+    // thread — so ownership is by m_ownsTransport alone, and disconnect()
+    // deletes it there with deleteLater().
+    BleTransport* bleTransport = nullptr;
+    if (m_ioThread) {
+        bleTransport = new BleTransport(nullptr);
+        bleTransport->moveToThread(m_ioThread);
+    } else {
+        bleTransport = new BleTransport(this);
+    }
     setTransport(bleTransport);
     m_ownsTransport = true;
     bleTransport->connectToDevice(device);
@@ -583,6 +647,10 @@ void DE1Device::disconnect() {
     m_lastSawWriteMs = 0;
 
     if (m_transport) {
+        // Disarm the SAW fast path before the transport can be deleted: the
+        // channel holds a raw pointer to it and reads it on the I/O thread,
+        // where the deleteLater() below runs.
+        if (m_sawStopChannel) m_sawStopChannel->arm(nullptr);
         // Disconnect signals FIRST to prevent re-entrant emissions
         // (BleTransport::disconnect() emits disconnected(), which would
         // trigger onTransportDisconnected() and double-emit our signals)
@@ -637,7 +705,7 @@ void DE1Device::parseStateInfo(const QByteArray& data) {
     }
 }
 
-void DE1Device::parseShotSample(const QByteArray& data) {
+void DE1Device::parseShotSample(const QByteArray& data, qint64 receivedMs) {
     // DE1 has two BLE specs with different packet formats:
     // Old spec (< 1.0): 17 bytes, pressure/flow are 1 byte each (U8P4)
     // New spec (>= 1.0): 19 bytes, pressure/flow are 2 bytes each (U16P12), temp is 3 bytes
@@ -645,6 +713,9 @@ void DE1Device::parseShotSample(const QByteArray& data) {
     const uint8_t* d = reinterpret_cast<const uint8_t*>(data.constData());
     ShotSample sample;
     sample.timestamp = QDateTime::currentMSecsSinceEpoch();
+    // An unstamped emitter (a test, a future transport) is timed from here,
+    // which undercounts by the hop it missed but never invents a latency.
+    sample.receivedMs = receivedMs > 0 ? receivedMs : LatencyStats::nowMs();
 
     // Detect BLE spec based on packet size
     bool newSpec = (data.size() >= 19);
@@ -1226,6 +1297,8 @@ void DE1Device::stopOperationUrgent(qint64 sawTriggerMs) {
         m_lastSawTriggerMs = sawTriggerMs;
         m_lastSawWriteMs = monotonicMsNow();
         m_sawStopWritePending = true;
+        LatencyStats::record(LatencyStats::Leg::TriggerToDispatch,
+                             m_lastSawWriteMs - sawTriggerMs);
     } else {
         m_sawStopWritePending = false;
         m_lastSawTriggerMs = 0;
@@ -1290,13 +1363,7 @@ void DE1Device::wakeUp() {
 }
 
 void DE1Device::clearCommandQueue() {
-    if (m_profileUploadInProgress) {
-        finishProfileUpload(false, QStringLiteral("command queue cleared during upload"));
-    }
-    m_sleepPendingAfterUpload = false;
-    m_sawStopWritePending = false;
-    m_lastSawTriggerMs = 0;
-    m_lastSawWriteMs = 0;
+    forgetQueuedCommandState();
     // Dropping the transport queue discards pending MMR writes whose values
     // are already recorded in m_lastMMRValues, so the cache would silently
     // elide the next retry. Only invalidate the cache if something was
@@ -1312,6 +1379,33 @@ void DE1Device::clearCommandQueue() {
     }
 }
 
+void DE1Device::forgetQueuedCommandState() {
+    if (m_profileUploadInProgress) {
+        finishProfileUpload(false, QStringLiteral("command queue cleared during upload"));
+    }
+    m_sleepPendingAfterUpload = false;
+    m_sawStopWritePending = false;
+    m_lastSawTriggerMs = 0;
+    m_lastSawWriteMs = 0;
+}
+
+void DE1Device::onSawStopIssued(qint64 sawTriggerMs, qint64 writeMs, qsizetype dropped) {
+    // The channel already cleared the transport queue and submitted Idle on the
+    // I/O thread; this is the rest of what stopOperationUrgent() would have done.
+    // The latency line comes from the channel's own ACK watch, so nothing here
+    // arms onTransportWriteComplete()'s.
+    forgetQueuedCommandState();
+    // Same rule as clearCommandQueue(): only a drop can leave the MMR cache
+    // claiming a value the DE1 never received.
+    if (dropped > 0) {
+        m_lastMMRValues.clear();
+    }
+    LatencyStats::record(LatencyStats::Leg::TriggerToDispatch, writeMs - sawTriggerMs);
+    SAW_LOG_STDERR("Stop", QStringLiteral("issued on the BLE I/O thread %1 ms after the "
+                                          "trigger (%2 queued command(s) dropped)")
+                               .arg(writeMs - sawTriggerMs).arg(dropped));
+}
+
 void DE1Device::uploadProfile(const Profile& profile) {
 #ifdef DECENZA_SIMULATOR
     if (m_simulationMode && m_simulator) {
@@ -1621,6 +1715,9 @@ QByteArray DE1Device::buildMMRPayload(uint32_t address, uint32_t value) {
 void DE1Device::setFirmwareFlashInProgress(bool inProgress) {
     if (m_firmwareFlashInProgress == inProgress) return;
     m_firmwareFlashInProgress = inProgress;
+    // A stop during a flash must reach dropDeviceWriteIfFirmwareFlash(), so
+    // the I/O-thread route is withdrawn for its duration.
+    updateSawStopChannel();
     // DEBUG: the flash's own progress is the story; this is how it is enforced.
     FW_LOG(QStringLiteral("MMR-write guard %1")
                .arg(inProgress ? QStringLiteral("ENGAGED") : QStringLiteral("cleared")));
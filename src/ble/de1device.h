@@ -36,11 +36,16 @@ class Profile;
 class SettingsHardware;
 class DE1Transport;
 class BleTransport;
+class SawStopChannel;
+class QThread;
 
 class DE1Simulator;
 
 struct ShotSample {
     qint64 timestamp = 0;
+    // Steady-clock arrival at the transport (LatencyStats::nowMs()). Not a
+    // time-of-day: `timestamp` above is that. 0 for simulated samples.
+    qint64 receivedMs = 0;
     double timer = 0.0;
     double groupPressure = 0.0;
     double groupFlow = 0.0;
@@ -148,6 +153,14 @@ public:
     DE1Transport* transport() const { return m_transport; }
     QString connectionType() const;
 
+    // The BLE I/O thread (bleiothread.h). When set, connectToDevice() creates
+    // its BleTransport unparented and moves it there; null keeps it on this
+    // object's thread, which is what tests and Apple platforms get.
+    void setIoThread(QThread* thread) { m_ioThread = thread; }
+    // The stop-at-weight fast path (sawstopchannel.h). DE1Device arms it
+    // whenever it applies and reports the latency of the stops it carries.
+    void setSawStopChannel(SawStopChannel* channel);
+
     // Simulation mode for GUI development without hardware
     bool simulationMode() const { return m_simulationMode; }
     void setSimulationMode(bool enabled);
@@ -384,15 +397,28 @@ private:
     // when a flash is in progress so the caller should bail.
     bool dropDeviceWriteIfFirmwareFlash(const char* label) const;
 
+    // Arms the SAW stop channel iff the current transport can take the fast
+    // path; disarms it otherwise. Called at every point that changes the answer.
+    void updateSawStopChannel();
+    // The main-thread half of a stop the channel issued on the I/O thread.
+    void onSawStopIssued(qint64 sawTriggerMs, qint64 writeMs, qsizetype dropped);
+    // Device-side state a command-queue clear invalidates, minus the clear
+    // itself (which the SAW channel does on the I/O thread).
+    void forgetQueuedCommandState();
+    // The SAW-Latency line. `path` names the route the stop took: "main" via
+    // this object's event queue, "io" via the SAW stop channel.
+    void reportSawLatency(qint64 triggerMs, qint64 writeMs, qint64 ackMs,
+                          const QString& path);
+
     // Transport signal handlers
     void onTransportConnected();
     void onTransportDisconnected();
-    void onTransportDataReceived(const QBluetoothUuid& uuid, const QByteArray& data);
+    void onTransportDataReceived(const QBluetoothUuid& uuid, const QByteArray& data, qint64 receivedMs);
     void onTransportWriteComplete(const QBluetoothUuid& uuid, const QByteArray& data);
 
     // Parse methods (dispatch from onTransportDataReceived)
     void parseStateInfo(const QByteArray& data);
-    void parseShotSample(const QByteArray& data);
+    void parseShotSample(const QByteArray& data, qint64 receivedMs = 0);
     void parseShotSettings(const QByteArray& data);
     void parseWaterLevel(const QByteArray& data);
     void parseVersion(const QByteArray& data);
@@ -442,6 +468,8 @@ private:
     // Owned when created internally via connectToDevice(); set externally via setTransport() for USB
     DE1Transport* m_transport = nullptr;
     bool m_ownsTransport = false;  // True when DE1Device created the transport (connectToDevice)
+    QThread* m_ioThread = nullptr;                // Not owned; see setIoThread()
+    SawStopChannel* m_sawStopChannel = nullptr;   // Not owned; lives on m_ioThread
 
     DE1::State m_state = DE1::State::Sleep;
     DE1::SubState m_subState = DE1::SubState::Ready;
@@ -126,8 +126,12 @@ signals:
      * Emitted when data is received from a characteristic (notification or read response).
      * @param uuid The characteristic that produced the data.
      * @param data The raw binary payload.
+     * @param receivedMs Steady-clock arrival (LatencyStats::nowMs()), stamped
+     *        by the transport as it emits; 0 when the emitter did not stamp.
+     *        Taken here rather than by the receiver because the receiver may be
+     *        a queued hop away (the BLE I/O thread → DE1Device on main).
      */
-    void dataReceived(const QBluetoothUuid& uuid, const QByteArray& data);
+    void dataReceived(const QBluetoothUuid& uuid, const QByteArray& data, qint64 receivedMs = 0);
 
     /**
      * Emitted when a write is abandoned after exhausting its retries.
@@ -0,0 +1,93 @@
+#include "sawstopchannel.h"
+
+#include "bletransport.h"
+#include "protocol/de1characteristics.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+
+#include <chrono>
+
+namespace {
+// Same clock as WeightProcessor's trigger and DE1Device's SAW timestamps, so
+// the three legs of SAW-Latency subtract cleanly whichever thread took them.
+qint64 monotonicMsNow()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+bool isIdleRequest(const QBluetoothUuid& uuid, const QByteArray& data)
+{
+    return uuid == DE1::Characteristic::REQUESTED_STATE
+        && data.size() == 1
+        && static_cast<uint8_t>(data[0]) == static_cast<uint8_t>(DE1::State::Idle);
+}
+}
+
+SawStopChannel::SawStopChannel(QObject* parent)
+    : QObject(parent)
+{
+}
+
+QEvent::Type SawStopChannel::wakeEventType() {
+    static int type = QEvent::registerEventType();
+    return static_cast<QEvent::Type>(type);
+}
+
+bool SawStopChannel::post(qint64 sawTriggerMs) {
+    if (sawTriggerMs <= 0 || !isArmed()) return false;
+
+    // Only the post that fills an empty slot wakes the thread; a stop already on
+    // its way keeps its own (earlier) trigger time.
+    qint64 empty = 0;
+    if (m_pendingTriggerMs.compare_exchange_strong(empty, sawTriggerMs)) {
+        // HighEventPriority for the same reason SawStopEvent uses it: anything
+        // the main thread has already posted to the transport (a D-Flow
+        // setpoint write) must not be queued ahead of the stop.
+        QCoreApplication::postEvent(this, new QEvent(wakeEventType()), Qt::HighEventPriority);
+    }
+    return true;
+}
+
+void SawStopChannel::arm(BleTransport* transport) {
+    m_transport.store(transport);
+}
+
+void SawStopChannel::customEvent(QEvent* event) {
+    if (event->type() != wakeEventType()) return;
+    const qint64 sawTriggerMs = m_pendingTriggerMs.exchange(0);
+    if (sawTriggerMs > 0) issueStop(sawTriggerMs);
+}
+
+void SawStopChannel::issueStop(qint64 sawTriggerMs) {
+    BleTransport* transport = m_transport.load();
+    if (!transport) {
+        // Disarmed in between — a disconnect, or a firmware flash starting.
+        // DE1Device decides what a stop means then, on its own thread.
+        emit fallback(sawTriggerMs);
+        return;
+    }
+
+    // Both calls run inline: the transport lives on this thread (arm()'s
+    // contract), so neither is a hop. clearQueue() before the write, exactly as
+    // DE1Device::stopOperationUrgent() orders them — stale frames and MMR
+    // writes must not follow the stop onto the wire.
+    const qsizetype dropped = transport->clearQueue();
+    const qint64 writeMs = monotonicMsNow();
+
+    // One-shot: the first Idle ACK after this write ends the measurement. A
+    // newer stop replaces the watch, and the transport's destruction severs it.
+    QObject::disconnect(m_ackWatch);
+    m_ackWatch = connect(transport, &DE1Transport::writeComplete, this,
+                         [this, sawTriggerMs, writeMs](const QBluetoothUuid& uuid,
+                                                       const QByteArray& data) {
+        if (!isIdleRequest(uuid, data)) return;
+        QObject::disconnect(m_ackWatch);
+        emit stopAcked(sawTriggerMs, writeMs, monotonicMsNow());
+    }, Qt::DirectConnection);
+
+    transport->writeUrgent(DE1::Characteristic::REQUESTED_STATE,
+                           QByteArray(1, static_cast<char>(DE1::State::Idle)));
+    emit stopIssued(sawTriggerMs, writeMs, dropped);
+}
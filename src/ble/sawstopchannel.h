@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QMetaObject>
+#include <QObject>
+
+#include <atomic>
+
+class BleTransport;
+
+/**
+ * The stop-at-weight fast path: from WeightProcessor's worker thread straight to
+ * the DE1's write characteristic on the BLE I/O thread, without a turn of the
+ * GUI thread in between.
+ *
+ * Before this existed, the stop went worker → high-priority event on the main
+ * thread → DE1Device → BleTransport. The event jumped the main thread's queue,
+ * but nothing can jump a main thread that is not running: on the slow Android
+ * tablets in docs/ANDROID_MEMORY_GC_PRESSURE.md the `dispatch` leg of
+ * SAW-Latency — worker trigger to write queued — was measured at 6.8 s, all of
+ * it spent waiting for the GUI thread. The I/O thread runs nothing but Bluetooth
+ * work, so its turn is never far away.
+ *
+ * The handoff is one atomic slot. post() is wait-free and callable from any
+ * thread: it publishes the trigger timestamp and, only when the slot was empty,
+ * wakes the I/O thread with a high-priority event. A second post while a stop is
+ * already on its way is absorbed — the first stop is the one that matters, and
+ * its timestamp is the one the latency is measured from.
+ *
+ * On the I/O thread the channel does what DE1Device::stopOperationUrgent() does
+ * to the transport — clear this device's queued GATT work, then write Idle to
+ * the FRONT of the shared queue — and reports back to DE1Device, queued, so the
+ * device-side bookkeeping (a failed profile upload, the MMR dedup cache) still
+ * happens on the main thread where that state lives. The Idle write's ACK is
+ * observed on the I/O thread, so bleAck is timed where the radio is, not where
+ * the GUI happens to be.
+ *
+ * Urgency is still POSITION, exactly as for writeUrgent(): the stop waits for
+ * whatever operation is in flight on the radio, on any device. What this removes
+ * is the wait for the GUI thread, not the wait for the radio.
+ *
+ * DE1Device arms the channel only when it applies: a BleTransport living on the
+ * channel's thread, no simulator, no firmware flash. Unarmed, post() returns
+ * false and the caller takes the old main-thread route.
+ */
+class SawStopChannel : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SawStopChannel(QObject* parent = nullptr);
+
+    /**
+     * Hand a stop to the I/O thread. Any thread; never blocks.
+     *
+     * @param sawTriggerMs  The worker's steady-clock trigger time; must be > 0.
+     * @return false when the channel is not armed — the caller must stop the
+     *         machine some other way.
+     */
+    bool post(qint64 sawTriggerMs);
+
+    /**
+     * Route stops to `transport`, which must live on this channel's thread.
+     * Null disarms. Called by DE1Device on the main thread, and always BEFORE
+     * the transport it names is scheduled for deletion.
+     */
+    void arm(BleTransport* transport);
+    bool isArmed() const { return m_transport.load() != nullptr; }
+
+signals:
+    /**
+     * The queue was cleared and the Idle write submitted, on the I/O thread.
+     * `dropped` is what clearQueue() returned, including an in-flight write.
+     */
+    void stopIssued(qint64 sawTriggerMs, qint64 writeMs, qsizetype dropped);
+    /** The Idle write was acknowledged by the DE1. All times steady-clock ms. */
+    void stopAcked(qint64 sawTriggerMs, qint64 writeMs, qint64 ackMs);
+    /**
+     * The channel was disarmed between post() and the I/O thread picking the
+     * stop up. The stop was NOT issued; the receiver must issue it.
+     */
+    void fallback(qint64 sawTriggerMs);
+
+protected:
+    void customEvent(QEvent* event) override;
+
+private:
+    static QEvent::Type wakeEventType();
+    void issueStop(qint64 sawTriggerMs);
+
+    // 0 = empty. Written by any thread, drained by the channel's own.
+    std::atomic<qint64> m_pendingTriggerMs{0};
+    // Set and cleared on the main thread, read on the channel's. DE1Device
+    // clears it before the transport's deleteLater() is posted, so a load that
+    // sees a pointer sees a live object: deletion runs on this same thread.
+    std::atomic<BleTransport*> m_transport{nullptr};
+    // Channel thread only. The one-shot watch for the Idle write's ACK.
+    QMetaObject::Connection m_ackWatch;
+};
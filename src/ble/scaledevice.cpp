@@ -1,5 +1,6 @@
 #include "scaledevice.h"
 
+#include "core/latencystats.h"
 #include "core/logtags.h"
 #include "scales/scalelogging.h"
 #include <QDebug>
@@ -169,7 +170,9 @@ void ScaleDevice::setWeight(double weight) {
     m_weight = weight;
     // Unconditional: a sample arrived. Drives the scale-feed stall detector and
     // SAW de-jitter, which must track sample arrival, not value change (#1176).
-    emit weightSampleReceived(weight);
+    // Stamped here: every scale type funnels its notification through this
+    // call, so it is the latest common point before the hop to the worker.
+    emit weightSampleReceived(weight, LatencyStats::nowMs());
     // Deduped: only on a genuine value change. Drives the `weight` Q_PROPERTY
     // and QML bindings (and onScaleWeightChanged, which feeds MQTT) — a
     // constant reading must not churn those.
@@ -99,7 +99,10 @@ signals:
     // otherwise indistinguishable from a dead feed and trips a false stall →
     // mid-shot connection-priority backoff / ruined shot. See #1176, #1185.
     // WeightProcessor::processWeight is wired to THIS, never weightChanged.
-    void weightSampleReceived(double weight);
+    // receivedMs is the steady-clock arrival (LatencyStats::nowMs()) stamped in
+    // setWeight(), so the worker can time its queued hop; 0 for the synthetic
+    // simulation reset, which arrived from nowhere.
+    void weightSampleReceived(double weight, qint64 receivedMs = 0);
     void flowRateChanged(double rate);
     void batteryLevelChanged(int level);
     void chargingChanged(bool charging);
@@ -47,6 +47,10 @@ void ScaleBleTransport::submitGattOperation(const QBluetoothUuid& key,
     op.requester = this;
     op.key = key;
     op.label = label;
+    // The queue may live on the BLE I/O thread while this transport stays on
+    // the main thread; the callbacks below touch this object's service and
+    // timer, so they must run here.
+    op.context = this;
     // Policy left at its default: no retries. See the header.
     op.issue = [this, timeoutMs, issue = std::move(issue)]() {
         m_operationTimeoutTimer.start(timeoutMs);
@@ -47,6 +47,7 @@
 #include <QThread>
 #include <QSqlDatabase>
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 #include <QSqlError>
 #include <QPointer>
 #include <tuple>
@@ -336,6 +337,9 @@ MainController::MainController(QNetworkAccessManager* networkManager,
     // Create shot history storage and comparison model
     m_shotHistory = new ShotHistoryStorage(this);
     m_shotHistory->initialize();
+    // Every background read opens this file; let the shared executor's workers
+    // keep a connection to it between tasks.
+    TaskExecutor::instance().setPooledDatabase(m_shotHistory->databasePath());
     // Mirror the startup-seeded latest-shot id (initialize() reads MAX(id))
     // so QML's MainController.lastSavedShotId is valid across restarts —
     // no emit needed: QML bindings haven't been created yet.
@@ -1021,7 +1025,7 @@ void MainController::loadShotWithMetadata(qint64 shotId, double doseOverride) {
     // event loop. The background thread captures `self` by value but MUST NOT dereference
     // it. All dereferences occur inside the QueuedConnection callback, which runs on the
     // main thread where QPointer's tracking is valid.
-    QThread* thread = QThread::create([self, dbPath, shotId, doseOverride]() {
+    TaskExecutor::instance().submit(TaskLane::Interactive, [self, dbPath, shotId, doseOverride]() {
         ShotRecord record;
         qint64 matchedBagId = -1;
         if (!withTempDb(dbPath, "load_meta", [&](QSqlDatabase& db) {
@@ -1041,9 +1045,6 @@ void MainController::loadShotWithMetadata(qint64 shotId, double doseOverride) {
             if (self) self->applyLoadedShotMetadata(shotId, record, doseOverride, matchedBagId);
         }, Qt::QueuedConnection);
     });
-
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
 
 void MainController::applyLoadedShotMetadata(qint64 shotId, const ShotRecord& shotRecord, double doseOverride,
@@ -1745,7 +1746,8 @@ void MainController::checkRecipesUpgradeEligibility() {
     // accept create, a spurious duplicate starter recipe for a user who
     // already has some).
     auto recipeCountOk = std::make_shared<bool>(false);
-    QThread* thread = QThread::create([dbPath, record, recipeCount, shotId, recipeCountOk]() {
+    QPointer<MainController> self(this);
+    TaskExecutor::instance().submit(TaskLane::Interactive, [self, dbPath, record, recipeCount, shotId, recipeCountOk]() {
         const bool opened = withTempDb(dbPath, "recipes_upgrade_offer", [&](QSqlDatabase& db) {
             QSqlQuery countQuery(db);
             *recipeCountOk = countQuery.exec(QStringLiteral("SELECT COUNT(*) FROM recipes"))
@@ -1769,18 +1771,17 @@ void MainController::checkRecipesUpgradeEligibility() {
             *recipeCountOk = false;
             qWarning() << "checkRecipesUpgradeEligibility: could not open shot history DB";
         }
+        QMetaObject::invokeMethod(self, [self, record, recipeCount, shotId, recipeCountOk]() {
+            if (!self) return;
+            self->m_recipesUpgradeWillCreate = RecipePromotion::isEligibleForStarterRecipe(
+                *recipeCountOk, *recipeCount, *shotId, record->summary.id);
+            self->m_recipesUpgradeShotRecord = self->m_recipesUpgradeWillCreate ? *record : ShotRecord();
+
+            const bool milkPreselected = self->m_recipesUpgradeWillCreate
+                && RecipePromotion::milkPreselectedFromSteamJson(self->m_recipesUpgradeShotRecord.steamJson);
+            emit self->recipesUpgradeOfferReady(self->m_recipesUpgradeWillCreate, milkPreselected);
+        }, Qt::QueuedConnection);
     });
-    connect(thread, &QThread::finished, this, [this, record, recipeCount, shotId, recipeCountOk]() {
-        m_recipesUpgradeWillCreate = RecipePromotion::isEligibleForStarterRecipe(
-            *recipeCountOk, *recipeCount, *shotId, record->summary.id);
-        m_recipesUpgradeShotRecord = m_recipesUpgradeWillCreate ? *record : ShotRecord();
-
-        const bool milkPreselected = m_recipesUpgradeWillCreate
-            && RecipePromotion::milkPreselectedFromSteamJson(m_recipesUpgradeShotRecord.steamJson);
-        emit recipesUpgradeOfferReady(m_recipesUpgradeWillCreate, milkPreselected);
-    });
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
 
 void MainController::acceptRecipesFirstUpgrade(const QString& name, bool hasMilk) {
@@ -3041,7 +3042,7 @@ void MainController::computeAutoFlowCalibration() {
         return;
     }
 
-    const auto& weightFlowData = m_shotDataModel->weightFlowRateData();
+    const SampleColumn weightFlowData = m_shotDataModel->column(ShotSampleBuffer::Channel::WeightFlowRate);
     if (weightFlowData.isEmpty()) {
         qDebug() << "Auto flow cal: skipped (no scale weight data)";
         return;
@@ -3059,8 +3060,8 @@ void MainController::computeAutoFlowCalibration() {
         return;
     }
 
-    const auto& flowData = m_shotDataModel->flowData();
-    const auto& pressureData = m_shotDataModel->pressureData();
+    const SampleColumn flowData = m_shotDataModel->column(ShotSampleBuffer::Channel::Flow);
+    const SampleColumn pressureData = m_shotDataModel->column(ShotSampleBuffer::Channel::Pressure);
     if (flowData.size() < 10 || pressureData.size() < 10) {
         qDebug() << "Auto flow cal: skipped (insufficient data - flow:"
                  << flowData.size() << "pressure:" << pressureData.size() << ")";
@@ -4019,7 +4020,7 @@ void MainController::onShotEnded() {
     // drip after stop; for non-SAW shots this is the instantaneous weight at stop time).
     // Fall back to last recorded scale data, then estimate from volume.
     double finalWeight = 0;
-    const auto& cumulativeWeight = m_shotDataModel->cumulativeWeightData();
+    const SampleColumn cumulativeWeight = m_shotDataModel->column(ShotSampleBuffer::Channel::Weight);
     if (m_timingController && m_timingController->currentWeight() > 0) {
         finalWeight = m_timingController->currentWeight();
     } else if (!cumulativeWeight.isEmpty()) {
@@ -4291,8 +4292,8 @@ void MainController::onShotEnded() {
     }
 
     // Log final shot state for debugging early exits
-    const auto& pressureData = m_shotDataModel->pressureData();
-    const auto& flowData = m_shotDataModel->flowData();
+    const SampleColumn pressureData = m_shotDataModel->column(ShotSampleBuffer::Channel::Pressure);
+    const SampleColumn flowData = m_shotDataModel->column(ShotSampleBuffer::Channel::Flow);
     double finalPressure = pressureData.isEmpty() ? 0 : pressureData.last().y();
     double finalFlow = flowData.isEmpty() ? 0 : flowData.last().y();
     qDebug() << "MainController: Shot ended -"
@@ -4474,10 +4475,18 @@ void MainController::factoryResetAndQuit()
         m_shotServer->stop();
     }
 
-    // 2. Close the shot database so files can be deleted
+    // 2. Close the shot database so files can be deleted — including the
+    // storage workers' pooled connections, which outlive their last task
     if (m_shotHistory) {
         m_shotHistory->close();
+        m_shotHistory->releaseDbConnections();
     }
+    if (m_bagStorage) m_bagStorage->releaseDbConnections();
+    if (m_equipmentStorage) m_equipmentStorage->releaseDbConnections();
+    if (m_recipeStorage) m_recipeStorage->releaseDbConnections();
+    TaskExecutor::instance().setPooledDatabase(QString());
+    if (!TaskExecutor::instance().releasePooledConnections())
+        qWarning() << "MainController::factoryResetAndQuit() - executor still holds a database connection";
 
     // 3. Wipe all data
     m_settings->factoryReset();
@@ -4785,7 +4794,7 @@ void MainController::onShotSampleReceived(const ShotSample& sample) {
                                pressureGoal, flowGoal,
                                /*temperatureGoal*/ sample.setTempGoal,
                                /*temperatureMixGoal*/ sample.setMixTempGoal,
-                               sample.frameNumber, isFlowMode);
+                               sample.frameNumber, isFlowMode, sample.receivedMs);
 
     // Log tracking delta every 10 shot samples for debug (at the DE1's ~5Hz sample rate,
     // this is roughly every 2 seconds). Only log when a goal is active.
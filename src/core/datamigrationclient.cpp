@@ -9,6 +9,7 @@
 #include "../screensaver/screensavervideomanager.h"
 #include "../ai/aimanager.h"
 #include "../ai/aiconversation.h"
+#include "taskexecutor.h"
 
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -1093,7 +1094,7 @@ void DataMigrationClient::onShotsReply()
     int beforeCount = m_shotHistory->totalShots();
     auto destroyed = m_destroyed;
 
-    QThread* thread = QThread::create([this, destDbPath, tempDbPath, beforeCount, destroyed]() {
+    TaskExecutor::instance().submit(TaskLane::Maintenance, [this, destDbPath, tempDbPath, beforeCount, destroyed]() {
         ShotHistoryStorage::ImportResult shotImport;
         bool success = ShotHistoryStorage::importDatabaseStatic(destDbPath, tempDbPath, true, &shotImport);
 
@@ -1139,9 +1140,6 @@ void DataMigrationClient::onShotsReply()
             startNextImport();
         }, Qt::QueuedConnection);
     });
-
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
 
 void DataMigrationClient::doImportMedia()
@@ -6,6 +6,8 @@
 #include <QThread>
 #include <QObject>
 #include <QString>
+#include <QStringList>
+#include <QTimer>
 #include <QDebug>
 
 #include "core/storagelogging.h"
@@ -13,6 +15,7 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <vector>
 
 // True when a statement failed because someone else holds the lock rather than
 // for a reason retrying cannot fix. This is what separates "wait and try again"
@@ -192,11 +195,304 @@ private:
     QString m_commitError;
 };
 
+// Long-lived connections for threads that run many short DB tasks.
+//
+// withTempDb (below) used to open a fresh connection for every call: addDatabase,
+// open, two PRAGMAs, removeDatabase, and every statement prepared from scratch.
+// On a tablet that costs more than most of the queries it wraps. A thread that
+// runs a stream of tasks against one database — each storage's SerialDbWorker —
+// opts in with poolOnCurrentThread(path). From then on withTempDb on that thread,
+// for that path, borrows one connection that stays open, and PreparedQuery serves
+// that connection's statements from a small LRU instead of re-preparing them.
+//
+// Everything here is per thread — a QSqlDatabase may only be used on the thread
+// that opened it — so nothing is locked. Deliberately NOT pooled:
+//   - Other paths on an opted-in thread: import sources and backup copies are
+//     temp files, and a cached handle would hold each one open after it is
+//     deleted.
+//   - Threads that never opt in. A dedicated QThread::create one-shot would pay
+//     the open anyway and then strand the handle until it exits. (TaskExecutor's
+//     workers are long-lived, so they do opt in.)
+//   - A nested withTempDb on the same thread and path. The pooled connection is
+//     busy, and sharing it would merge the two frames' transactions (the nesting
+//     DbWriteTxn refuses), so the inner call gets a temporary connection as
+//     before.
+//
+// A connection is checked back in clean. A transaction left open is rolled back
+// with a warning — closing the connection used to roll it back in silence — and
+// no cached statement is left active, so an idle pooled connection holds no WAL
+// read snapshot and never holds up a checkpoint. It still holds the FILE open,
+// which is why it closes after kIdleCloseMs without use, on
+// releaseCurrentThread(), and when its thread finishes: a factory reset deletes
+// shots.db, and Windows refuses to delete an open file.
+class DbConnectionPool {
+public:
+    static constexpr int kStatementCacheSize = 32;
+    static constexpr int kIdleCloseMs = 10000;
+
+    struct CachedStatement {
+        QString sql;
+        std::unique_ptr<QSqlQuery> query;
+        quint64 lastUse = 0;
+        bool borrowed = false;   // a live PreparedQuery holds it; never evicted
+    };
+    struct Connection {
+        QString path;
+        QString name;
+        QSqlDatabase db;
+        bool inUse = false;
+        // unique_ptr so a borrowed entry keeps its address when others are evicted.
+        std::vector<std::unique_ptr<CachedStatement>> statements;
+    };
+
+    // Opts the calling thread in for `dbPath`. Idempotent; an empty path is ignored.
+    static void poolOnCurrentThread(const QString& dbPath) {
+        ThreadState& s = state();
+        if (!dbPath.isEmpty() && !s.paths.contains(dbPath))
+            s.paths << dbPath;
+    }
+
+    // Closes every idle pooled connection the calling thread holds. The thread
+    // stays opted in; the next withTempDb reopens on demand.
+    static void releaseCurrentThread() {
+        ThreadState& s = state();
+        closeIdleConnections(s);
+        s.idleTimer.reset();
+    }
+
+    // Pooled connections the calling thread holds open right now.
+    static int openConnectionCount() { return static_cast<int>(state().connections.size()); }
+
+    // withTempDb's side. nullptr when the calling thread does not pool `dbPath`,
+    // when its connection is already checked out (nesting), or when it could not
+    // be opened — the caller then falls back to a temporary connection, which
+    // reports the open failure itself.
+    static Connection* acquire(const QString& dbPath) {
+        ThreadState& s = state();
+        if (dbPath.isEmpty() || !s.paths.contains(dbPath))
+            return nullptr;
+        for (const auto& c : s.connections) {
+            if (c->path != dbPath)
+                continue;
+            if (c->inUse)
+                return nullptr;
+            if (!c->db.isOpen()) {
+                // Someone closed it from inside a task. Its statements died with
+                // the driver's handle; reopen clean.
+                c->statements.clear();
+                if (!openConfigured(c->db))
+                    return nullptr;
+            }
+            c->inUse = true;
+            return c.get();
+        }
+
+        auto c = std::make_unique<Connection>();
+        c->path = dbPath;
+        c->name = QStringLiteral("dbpool_%1_%2")
+            .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()), 0, 16)
+            .arg(++s.serial);
+        c->db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), c->name);
+        c->db.setDatabaseName(dbPath);
+        if (!openConfigured(c->db)) {
+            c->db = QSqlDatabase();
+            QSqlDatabase::removeDatabase(c->name);
+            return nullptr;
+        }
+        c->inUse = true;
+        s.connections.push_back(std::move(c));
+        return s.connections.back().get();
+    }
+
+    static void release(Connection* conn, const QString& connPrefix) {
+        // A ROLLBACK that succeeds found a transaction the task never ended.
+        // Without a transaction it is a cheap "no transaction is active" error.
+        QSqlQuery rollback(conn->db);
+        if (rollback.exec(QStringLiteral("ROLLBACK")))
+            qWarning() << "withTempDb:" << connPrefix
+                       << "returned with a transaction still open - rolled back";
+        conn->inUse = false;
+        trimStatements(*conn);
+        armIdleTimer(state());
+    }
+
+    // PreparedQuery's side: the checked-out pooled connection `db` is, or nullptr.
+    static Connection* checkedOut(const QSqlDatabase& db) {
+        const QString name = db.connectionName();
+        for (const auto& c : state().connections) {
+            if (c->inUse && c->name == name)
+                return c.get();
+        }
+        return nullptr;
+    }
+
+    // Borrows the cached statement for `sql`, preparing it on a miss. nullptr when
+    // it is already borrowed (the same SQL twice in one frame) or fails to
+    // prepare; the caller then prepares a one-shot query, which reports the error.
+    static CachedStatement* borrow(Connection* conn, const QString& sql) {
+        const quint64 tick = ++state().tick;
+        for (const auto& st : conn->statements) {
+            if (st->sql != sql)
+                continue;
+            if (st->borrowed)
+                return nullptr;
+            st->borrowed = true;
+            st->lastUse = tick;
+            return st.get();
+        }
+        auto st = std::make_unique<CachedStatement>();
+        st->sql = sql;
+        st->query = std::make_unique<QSqlQuery>(conn->db);
+        if (!st->query->prepare(sql))
+            return nullptr;
+        st->borrowed = true;
+        st->lastUse = tick;
+        conn->statements.push_back(std::move(st));
+        trimStatements(*conn);
+        return conn->statements.back().get();
+    }
+
+private:
+    struct ThreadState {
+        QStringList paths;
+        std::vector<std::unique_ptr<Connection>> connections;
+        std::unique_ptr<QTimer> idleTimer;
+        quint64 tick = 0;
+        int serial = 0;
+        // Backstop only: SerialDbWorker releases on QThread::finished, while the
+        // thread's event dispatcher still exists.
+        ~ThreadState() { closeIdleConnections(*this); }
+    };
+
+    static ThreadState& state() {
+        thread_local ThreadState s;
+        return s;
+    }
+
+    static bool openConfigured(QSqlDatabase& db) {
+        if (!db.open())
+            return false;
+        QSqlQuery(db).exec(QStringLiteral("PRAGMA busy_timeout = 5000"));
+        QSqlQuery(db).exec(QStringLiteral("PRAGMA foreign_keys = ON"));
+        return true;
+    }
+
+    // Drops least-recently-used statements past the cap, never a borrowed one —
+    // so a frame borrowing more than the cap runs over it until check-in.
+    static void trimStatements(Connection& conn) {
+        while (static_cast<int>(conn.statements.size()) > kStatementCacheSize) {
+            auto victim = conn.statements.end();
+            for (auto it = conn.statements.begin(); it != conn.statements.end(); ++it) {
+                if (!(*it)->borrowed && (victim == conn.statements.end()
+                                         || (*it)->lastUse < (*victim)->lastUse))
+                    victim = it;
+            }
+            if (victim == conn.statements.end())
+                return;
+            conn.statements.erase(victim);
+        }
+    }
+
+    static void closeIdleConnections(ThreadState& s) {
+        for (auto it = s.connections.begin(); it != s.connections.end();) {
+            Connection& c = **it;
+            if (c.inUse) {
+                ++it;
+                continue;
+            }
+            // Statements, then the handle, then the registry entry: removeDatabase
+            // warns about, and disables, a connection something still references.
+            c.statements.clear();
+            c.db = QSqlDatabase();
+            QSqlDatabase::removeDatabase(c.name);
+            it = s.connections.erase(it);
+        }
+    }
+
+    // Restarted on every check-in, so it fires kIdleCloseMs after the LAST task.
+    // Needs an event loop to fire; without one the connection lives until
+    // releaseCurrentThread() or thread exit.
+    static void armIdleTimer(ThreadState& s) {
+        if (!QThread::currentThread()->eventDispatcher())
+            return;
+        if (!s.idleTimer) {
+            s.idleTimer = std::make_unique<QTimer>();
+            s.idleTimer->setSingleShot(true);
+            s.idleTimer->setInterval(kIdleCloseMs);
+            QObject::connect(s.idleTimer.get(), &QTimer::timeout, [] {
+                closeIdleConnections(state());
+            });
+        }
+        s.idleTimer->start();
+    }
+};
+
+// A prepared statement for `sql` on `db`. On a pooled connection it is borrowed
+// from the connection's statement cache — prepared once, reused by every later
+// task — and reset (not finalized) when this goes out of scope. On any other
+// connection it is an ordinary one-shot QSqlQuery. Either way the call site is
+// the same:
+//
+//     PreparedQuery query(db, sql);
+//     if (!query.ok()) { qWarning() << ... << query->lastError().text(); return; }
+//     query->bindValue(0, id);
+//
+// Rebind every placeholder before each exec(): a cached statement keeps the
+// previous borrower's values. Never prepare() a different statement on it.
+class PreparedQuery {
+public:
+    PreparedQuery(QSqlDatabase& db, const QString& sql) {
+        if (DbConnectionPool::Connection* conn = DbConnectionPool::checkedOut(db))
+            m_cached = DbConnectionPool::borrow(conn, sql);
+        if (m_cached) {
+            m_query = m_cached->query.get();
+            m_ok = true;
+        } else {
+            m_local = std::make_unique<QSqlQuery>(db);
+            m_ok = m_local->prepare(sql);
+            m_query = m_local.get();
+        }
+    }
+    ~PreparedQuery() {
+        if (m_cached) {
+            // Reset, so the connection holds no read snapshot between tasks.
+            m_query->finish();
+            m_cached->borrowed = false;
+        }
+    }
+    PreparedQuery(const PreparedQuery&) = delete;
+    PreparedQuery& operator=(const PreparedQuery&) = delete;
+
+    bool ok() const { return m_ok; }
+    bool isCached() const { return m_cached != nullptr; }
+    QSqlQuery& operator*() { return *m_query; }
+    QSqlQuery* operator->() { return m_query; }
+
+private:
+    DbConnectionPool::CachedStatement* m_cached = nullptr;
+    std::unique_ptr<QSqlQuery> m_local;
+    QSqlQuery* m_query = nullptr;
+    bool m_ok = false;
+};
+
 // Opens a temporary QSQLITE connection, runs `work(db)`, then removes the connection.
 // Sets PRAGMA busy_timeout and foreign_keys. Returns true if the DB opened successfully.
 // Thread-safe: each call uses a unique connection name based on the current thread ID.
+// On a thread that pools `dbPath` (DbConnectionPool above), `work` runs on that
+// thread's long-lived connection instead; the contract is the same.
 template<typename Work>
 static bool withTempDb(const QString& dbPath, const QString& connPrefix, Work&& work) {
+    if (DbConnectionPool::Connection* pooled = DbConnectionPool::acquire(dbPath)) {
+        // Checked back in even if `work` throws, like the removal below.
+        struct Checkin {
+            DbConnectionPool::Connection* conn;
+            const QString& prefix;
+            ~Checkin() { DbConnectionPool::release(conn, prefix); }
+        } checkin{pooled, connPrefix};
+        work(pooled->db);
+        return true;
+    }
+
     const QString connName = connPrefix + QString("_%1")
         .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()), 0, 16);
     bool opened = false;
@@ -287,7 +583,8 @@ public:
 
     // Post an arbitrary task to the worker thread (FIFO). The task runs on the
     // worker thread and is responsible for opening its own DB connection (via
-    // withTempDb) and marshaling any result back to its owner's thread itself
+    // withTempDb — pooled when it names setPooledDatabase()'s path) and
+    // marshaling any result back to its owner's thread itself
     // (e.g. QMetaObject::invokeMethod(receiver, ..., Qt::QueuedConnection)). For
     // callers whose work receives a ready db handle, prefer run() below.
     void post(std::function<void()> task) {
@@ -297,7 +594,8 @@ public:
         // worker — see m_outstanding's declaration for the use-after-free that
         // capturing `this` here caused.
         QMetaObject::invokeMethod(m_context,
-            [counter = m_outstanding, task = std::move(task)]() mutable {
+            [counter = m_outstanding, pooledPath = m_pooledPath, task = std::move(task)]() mutable {
+                DbConnectionPool::poolOnCurrentThread(pooledPath);
                 task();
                 counter->fetch_sub(1, std::memory_order_release);
             }, Qt::QueuedConnection);
@@ -326,6 +624,25 @@ public:
     // Identifies which storage's worker this is in a thread dump.
     QString name() const { return m_name; }
 
+    // The database a bare post() task opens with withTempDb, so those tasks share
+    // the worker's pooled connection too (see DbConnectionPool). run() pools its
+    // own dbPath without this. Owner thread only, like post().
+    void setPooledDatabase(const QString& dbPath) { m_pooledPath = dbPath; }
+
+    // Closes the worker's pooled connections once the tasks queued before this
+    // call have run, and BLOCKS until it has — for an owner about to delete the
+    // file (factory reset), which must not race a connection that is still open.
+    // FIFO, so nothing already submitted loses its connection mid-task. Owner
+    // thread only, like post(); never from a task (it would wait on itself). Not
+    // counted in isIdle().
+    void releasePooledConnections() {
+        if (!m_thread)
+            return;
+        Q_ASSERT(QThread::currentThread() != m_thread);
+        QMetaObject::invokeMethod(m_context, []() { DbConnectionPool::releaseCurrentThread(); },
+                                  Qt::BlockingQueuedConnection);
+    }
+
     // Post `work(db)` to the worker thread (FIFO), then deliver `done(dbOpened)`
     // back on `receiver`'s thread via a queued call. `dbOpened` is false when the
     // connection could not be opened — in which case `work` never ran and any
@@ -355,6 +672,7 @@ public:
         auto ticket = roundTripTicket();
         post([dbPath, connPrefix, work = std::move(work), done = std::move(done),
               receiver, destroyed, ticket]() mutable {
+            DbConnectionPool::poolOnCurrentThread(dbPath);
             const bool dbOpened = withTempDb(dbPath, connPrefix, [&](QSqlDatabase& db) { work(db); });
             if (!dbOpened)
                 qWarning() << "SerialDbWorker: failed to open DB for" << connPrefix;
@@ -396,10 +714,17 @@ private:
         m_thread->setObjectName(m_name);
         m_context = new QObject;          // event-loop affinity = the worker thread
         m_context->moveToThread(m_thread);
+        // `finished` is emitted on the worker thread itself, before its event
+        // dispatcher goes away — the one place its pooled connections (and their
+        // idle timer) can still be torn down on the thread that owns them.
+        QObject::connect(m_thread, &QThread::finished, m_context,
+                         []() { DbConnectionPool::releaseCurrentThread(); },
+                         Qt::DirectConnection);
         m_thread->start();
     }
 
     QString m_name;
+    QString m_pooledPath;
     QThread* m_ownerThread = nullptr;  // thread that first used this worker
     QThread* m_thread = nullptr;
     QObject* m_context = nullptr;
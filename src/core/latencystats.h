@@ -0,0 +1,227 @@
+#pragma once
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+
+// Fixed-bucket latency histograms for the shot control loop.
+//
+// The SAW-Latency line answers "how slow was THIS stop"; it cannot answer "did
+// this build get slower", or "is this tablet worse than that one", without
+// someone grepping a dozen logs and tabulating by hand. These histograms are
+// that tabulation, kept live: four legs of the loop, each recorded at the point
+// the second timestamp is taken, served as JSON on /api/debug/latency and by the
+// debug_get_latency MCP tool.
+//
+//   ScaleToWeightProcessor  scale notification → WeightProcessor::processWeight
+//                           (the main thread's queued hop to the worker)
+//   TriggerToDispatch       SAW trigger on the worker → Idle write submitted
+//                           (SAW-Latency's `dispatch`)
+//   DispatchToAck           Idle write submitted → DE1 acknowledged it
+//                           (SAW-Latency's `bleAck`; spans the shared GATT queue)
+//   SampleToChartFlush      DE1 shot sample at the transport → the live chart's
+//                           flush that drew it
+//
+// Every stamp is steady-clock milliseconds from nowMs() — the same clock as
+// WeightProcessor's trigger and DE1Device's SAW timestamps — because a wall
+// clock stepped by NTP mid-shot turns a latency into a negative number.
+//
+// Recording is lock-free and callable from any thread: the worker, the BLE I/O
+// thread and the GUI thread all write here. Buckets are fixed so two dumps from
+// different builds or devices line up column for column; percentiles are read
+// off the buckets and are therefore upper bounds, accurate to the bucket.
+// Counters are process-lifetime until reset() — a reset racing a record can
+// leave one sample's count and sum on opposite sides of it, which is noise at
+// these volumes, not a reason for a lock on the hot path.
+namespace LatencyStats {
+
+inline qint64 nowMs()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+enum class Leg {
+    ScaleToWeightProcessor = 0,
+    TriggerToDispatch,
+    DispatchToAck,
+    SampleToChartFlush,
+    Count
+};
+
+// The JSON key. Stable: dashboards and scripts diff these across builds.
+inline QString legName(Leg leg)
+{
+    switch (leg) {
+    case Leg::ScaleToWeightProcessor: return QStringLiteral("scaleToWeightProcessor");
+    case Leg::TriggerToDispatch:      return QStringLiteral("triggerToDispatch");
+    case Leg::DispatchToAck:          return QStringLiteral("dispatchToAck");
+    case Leg::SampleToChartFlush:     return QStringLiteral("sampleToChartFlush");
+    case Leg::Count:                  break;
+    }
+    return QString();
+}
+
+inline QString legDescription(Leg leg)
+{
+    switch (leg) {
+    case Leg::ScaleToWeightProcessor:
+        return QStringLiteral("Scale weight notification to the SAW worker picking it up");
+    case Leg::TriggerToDispatch:
+        return QStringLiteral("SAW trigger on the worker to the Idle write being submitted");
+    case Leg::DispatchToAck:
+        return QStringLiteral("Idle write submitted to the DE1 acknowledging it (includes waits in the shared BLE queue)");
+    case Leg::SampleToChartFlush:
+        return QStringLiteral("DE1 shot sample at the transport to the live chart drawing it");
+    case Leg::Count:
+        break;
+    }
+    return QString();
+}
+
+class Histogram {
+public:
+    // Inclusive upper bounds in ms. One more bucket than bounds: the last holds
+    // everything above 10 s, which on this loop means a stall, not a latency.
+    static constexpr std::array<qint64, 13> kBoundsMs = {
+        1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+    static constexpr std::size_t kBucketCount = kBoundsMs.size() + 1;
+
+    void record(qint64 ms)
+    {
+        // A negative span is a stamp from another clock, not a fast sample.
+        // Counted as 0 rather than dropped, so a mixed-clock bug shows up as a
+        // suspicious pile in the first bucket instead of as missing samples.
+        if (ms < 0) ms = 0;
+        m_buckets[bucketFor(ms)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sumMs.fetch_add(static_cast<quint64>(ms), std::memory_order_relaxed);
+        qint64 seen = m_maxMs.load(std::memory_order_relaxed);
+        while (ms > seen && !m_maxMs.compare_exchange_weak(seen, ms, std::memory_order_relaxed)) {}
+    }
+
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    qint64 maxMs() const { return m_maxMs.load(std::memory_order_relaxed); }
+    quint64 bucketCount(std::size_t i) const { return m_buckets[i].load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the q-quantile, capped at the largest
+    // sample seen (so a lone 3 ms sample reads 3, not 5). -1 when empty.
+    qint64 percentileMs(double q) const
+    {
+        const quint64 total = count();
+        if (total == 0) return -1;
+        const quint64 rank = qMax<quint64>(1, static_cast<quint64>(std::ceil(q * static_cast<double>(total))));
+        quint64 cumulative = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            cumulative += bucketCount(i);
+            if (cumulative >= rank)
+                return i < kBoundsMs.size() ? qMin(kBoundsMs[i], maxMs()) : maxMs();
+        }
+        return maxMs();
+    }
+
+    QJsonObject toJson() const
+    {
+        const quint64 total = count();
+        QJsonArray counts;
+        for (std::size_t i = 0; i < kBucketCount; ++i)
+            counts.append(static_cast<qint64>(bucketCount(i)));
+        const quint64 sum = m_sumMs.load(std::memory_order_relaxed);
+        return QJsonObject{
+            {"count", static_cast<qint64>(total)},
+            {"meanMs", total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0},
+            {"maxMs", maxMs()},
+            {"p50Ms", percentileMs(0.50)},
+            {"p95Ms", percentileMs(0.95)},
+            {"p99Ms", percentileMs(0.99)},
+            {"counts", counts},
+        };
+    }
+
+    void reset()
+    {
+        for (auto& bucket : m_buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        m_count.store(0, std::memory_order_relaxed);
+        m_sumMs.store(0, std::memory_order_relaxed);
+        m_maxMs.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static std::size_t bucketFor(qint64 ms)
+    {
+        std::size_t i = 0;
+        while (i < kBoundsMs.size() && ms > kBoundsMs[i]) ++i;
+        return i;
+    }
+
+    std::array<std::atomic<quint64>, kBucketCount> m_buckets{};
+    std::atomic<quint64> m_count{0};
+    std::atomic<quint64> m_sumMs{0};
+    std::atomic<qint64> m_maxMs{0};
+};
+
+// The process-wide set. A function-local static, so every translation unit —
+// and every test binary that compiles only some of them — shares one instance
+// without a .cpp of its own.
+inline Histogram& histogram(Leg leg)
+{
+    static std::array<Histogram, static_cast<std::size_t>(Leg::Count)> all;
+    return all[static_cast<std::size_t>(leg)];
+}
+
+inline std::atomic<qint64>& resetAtMs()
+{
+    static std::atomic<qint64> at{nowMs()};
+    return at;
+}
+
+inline void record(Leg leg, qint64 ms)
+{
+    histogram(leg).record(ms);
+}
+
+// Record `now - stampMs`. A stamp of 0 means "not taken" (a simulated sample,
+// a synthetic weight) and records nothing.
+inline void recordSince(Leg leg, qint64 stampMs)
+{
+    if (stampMs > 0) record(leg, nowMs() - stampMs);
+}
+
+inline void reset()
+{
+    for (int i = 0; i < static_cast<int>(Leg::Count); ++i)
+        histogram(static_cast<Leg>(i)).reset();
+    resetAtMs().store(nowMs());
+}
+
+// {"clock", "sinceResetMs", "bucketsMs", "legs": {name: {...}}}. `bucketsMs`
+// are the inclusive upper bounds; each leg's `counts` has one more entry than
+// it, the last being everything above the final bound.
+inline QJsonObject toJson()
+{
+    QJsonArray bounds;
+    for (qint64 b : Histogram::kBoundsMs)
+        bounds.append(b);
+    QJsonObject legs;
+    for (int i = 0; i < static_cast<int>(Leg::Count); ++i) {
+        const Leg leg = static_cast<Leg>(i);
+        QJsonObject entry = histogram(leg).toJson();
+        entry["description"] = legDescription(leg);
+        legs[legName(leg)] = entry;
+    }
+    return QJsonObject{
+        {"clock", QStringLiteral("steady")},
+        {"sinceResetMs", nowMs() - resetAtMs().load()},
+        {"bucketsMs", bounds},
+        {"legs", legs},
+    };
+}
+
+}  // namespace LatencyStats
@@ -0,0 +1,488 @@
+#pragma once
+
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QThread>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "dbutils.h"
+
+// A shared "never mind" flag for work that may not be worth starting any more.
+//
+// Deliberately the same shape as the std::shared_ptr<std::atomic<bool>>
+// `m_destroyed` flags the storages and ShotServer already carry, so one of those
+// converts straight into a token: the task is skipped if its owner is gone by
+// the time a worker reaches it. A default-constructed token is never cancelled.
+class CancellationToken {
+public:
+    CancellationToken() = default;
+    // Implicit, so an existing `destroyed` flag can be passed as-is.
+    CancellationToken(std::shared_ptr<std::atomic<bool>> flag) : m_flag(std::move(flag)) {}
+
+    static CancellationToken create() {
+        return CancellationToken(std::make_shared<std::atomic<bool>>(false));
+    }
+
+    // Cancelled when `object` is destroyed — for a request, its socket (ShotServer
+    // retires a socket with deleteLater as soon as the client goes away). A null
+    // object yields an already-cancelled token. Call from `object`'s thread.
+    static CancellationToken boundTo(QObject* object) {
+        CancellationToken token = create();
+        if (!object) {
+            token.cancel();
+            return token;
+        }
+        QObject::connect(object, &QObject::destroyed, [flag = token.m_flag]() {
+            flag->store(true, std::memory_order_release);
+        });
+        return token;
+    }
+
+    void cancel() const {
+        if (m_flag)
+            m_flag->store(true, std::memory_order_release);
+    }
+    bool isCancelled() const { return m_flag && m_flag->load(std::memory_order_acquire); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_flag;
+};
+
+// Which kind of work a task is. The lanes are strict priorities — a free worker
+// always takes Interactive work first — and the lower two are also capped, so
+// they can never occupy every worker:
+//   Interactive  someone is waiting on the result: a web request, an MCP tool
+//                call, a page opening a shot. Every worker may run these.
+//   Background   nobody is waiting: Visualizer bag syncs, export refreshes,
+//                temp-file cleanup. All workers but one.
+//   Maintenance  long and rare: full-history exports, database imports and
+//                migrations. At most half the workers (and at least one).
+enum class TaskLane { Interactive = 0, Background = 1, Maintenance = 2 };
+
+// The process-wide pool the one-shot background tasks run on.
+//
+// Every request to the web server and every MCP tool call used to spawn a
+// QThread::create thread of its own — about ninety call sites, all the same
+// create / deleteLater / start boilerplate. A dashboard polling the web UI, or an
+// agent firing a burst of tool calls, turned into a thread per request on a
+// four-core tablet: each paid thread creation, a fresh SQLite connection, and
+// then competed with the rest for the same cores and the same WAL lock. Here a
+// fixed set of workers (idealThreadCount(), clamped to 2..4) takes tasks from
+// three priority lanes instead, and queue depth is visible (toJson(), served at
+// /api/executor) rather than showing up as a stall.
+//
+// Scheduling is work-stealing. A task submitted FROM a worker (a follow-up its
+// parent spawned) goes on that worker's own deque, and the worker takes its own
+// newest task first, while its data is still warm. An idle worker takes the
+// oldest task from the shared queue, and failing that steals the OLDEST task from
+// a busy worker's deque, so a burst spawned on one worker spreads out. One mutex
+// guards all of it: a task here is a SQL query or a file operation, milliseconds
+// long, so the lock is never what a worker waits on. What stealing buys is
+// placement, not lock-freedom.
+//
+// Workers opt in to DbConnectionPool for setPooledDatabase()'s path, which is
+// what the per-task withTempDb calls across the web server and MCP were paying
+// for. A worker closes its pooled connection after DbConnectionPool::kIdleCloseMs
+// without work, and on releasePooledConnections().
+//
+// NOT for:
+//   - Work that must run in submission order. That is SerialDbWorker's job, and
+//     the storages keep theirs.
+//   - Work that blocks for seconds on something other than the CPU or the disk
+//     (mDNS resolves, the tsnet tunnel). Each one would hold a worker hostage,
+//     so those keep dedicated threads.
+//   - Work an owner must join in its destructor (DatabaseBackupManager's
+//     backups, TranslationManager's scan). A pool task has no handle to wait on.
+//
+// Header-only like dbutils.h, so test targets need no extra source. instance()
+// is created on first use and deliberately never destroyed: main() calls
+// shutdown() after the event loop ends, and a task that outlasts that is
+// abandoned exactly as a detached QThread::create thread used to be.
+class TaskExecutor {
+public:
+    static constexpr int kLaneCount = 3;
+
+    static TaskExecutor& instance() {
+        static TaskExecutor* s = new TaskExecutor(defaultWorkerCount());
+        return *s;
+    }
+
+    static int defaultWorkerCount() { return std::clamp(QThread::idealThreadCount(), 2, 4); }
+
+    // Workers start on the first submit(). Tests construct their own instance.
+    explicit TaskExecutor(int workerCount) : m_workerCount(std::max(1, workerCount)) {}
+    ~TaskExecutor() { shutdown(-1); }
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+    // Runs `task` on a worker. `token` is checked when a worker picks the task
+    // up, and a cancelled task is dropped without running. Once a task has
+    // started it runs to the end, so a long task should poll the token itself.
+    // The task marshals its own result back, like a QThread::create body did.
+    // Any callable, move-only ones included (QThread::create took those, and
+    // ShotHistoryStorage's in-flight guard is one). Safe from any thread.
+    template<typename F>
+    void submit(TaskLane lane, F&& task, CancellationToken token = {}) {
+        // std::function needs a copyable target; sharing the callable makes the
+        // wrapper copyable without copying it.
+        auto callable = std::make_shared<std::decay_t<F>>(std::forward<F>(task));
+        enqueue(lane, [callable]() { (*callable)(); }, std::move(token));
+    }
+
+private:
+    void enqueue(TaskLane lane, std::function<void()> task, CancellationToken token) {
+        const int l = static_cast<int>(lane);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            lock.unlock();
+            qWarning() << "TaskExecutor: submit after shutdown - task dropped";
+            return;
+        }
+        ensureStarted();
+        Task t{std::move(task), std::move(token), Clock::now()};
+        Worker* self = currentWorker();
+        if (self && self->owner == this)
+            self->local[l].push_back(std::move(t));
+        else
+            m_shared[l].push_back(std::move(t));
+        LaneStats& st = m_stats[l];
+        ++st.submitted;
+        ++st.queued;
+        st.peakQueued = std::max(st.peakQueued, st.queued);
+        lock.unlock();
+        m_workAvailable.notify_one();
+    }
+
+public:
+    // The database every worker pools (DbConnectionPool). Empty turns pooling
+    // off for tasks that start after the call.
+    void setPooledDatabase(const QString& dbPath) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pooledPath = dbPath;
+    }
+
+    // Asks every worker to close its pooled connection, and waits up to
+    // `timeoutMs` (-1: no limit) until each has: an idle worker does it at once,
+    // a busy one when its current task ends. False on timeout. For an owner
+    // about to delete the file (factory reset). Never call it from a task.
+    bool releasePooledConnections(int timeoutMs = 5000) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_workers.empty())
+            return true;
+        const quint64 generation = ++m_releaseGeneration;
+        m_workAvailable.notify_all();
+        const auto done = [&]() {
+            return std::all_of(m_workers.begin(), m_workers.end(), [&](const auto& w) {
+                return w->releasedGeneration >= generation || w->exited;
+            });
+        };
+        if (timeoutMs < 0) {
+            m_stateChanged.wait(lock, done);
+            return true;
+        }
+        return m_stateChanged.wait_for(lock, std::chrono::milliseconds(timeoutMs), done);
+    }
+
+    // Nothing queued and nothing running. For tests and for the shutdown path.
+    bool waitForIdle(int timeoutMs) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_stateChanged.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                                       [&]() { return idleLocked(); });
+    }
+
+    // Stops taking submissions, lets the workers drain what is already queued,
+    // and joins them for up to `timeoutMs` (-1: no limit). A worker still busy
+    // after that is left running, detached. False if any was.
+    bool shutdown(int timeoutMs) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_workAvailable.notify_all();
+        QDeadlineTimer deadline = timeoutMs < 0 ? QDeadlineTimer(QDeadlineTimer::Forever)
+                                                : QDeadlineTimer(timeoutMs);
+        bool allJoined = true;
+        for (const auto& w : m_workers) {
+            if (!w->thread)
+                continue;
+            if (w->thread->wait(deadline)) {
+                delete w->thread;
+                w->thread = nullptr;
+            } else {
+                allJoined = false;
+            }
+        }
+        if (!allJoined) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            qWarning() << "TaskExecutor: shutdown timed out with"
+                       << (m_stats[0].running + m_stats[1].running + m_stats[2].running)
+                       << "task(s) running and" << queuedLocked() << "queued - abandoning them";
+        }
+        return allJoined;
+    }
+
+    // Per-lane counters since start. `queued` and `running` are current values;
+    // the rest are totals. Waits are from submit() to a worker picking the task up.
+    struct LaneStats {
+        int queued = 0;
+        int running = 0;
+        int peakQueued = 0;
+        quint64 submitted = 0;
+        quint64 completed = 0;
+        quint64 cancelled = 0;
+        qint64 totalWaitUs = 0;
+        qint64 maxWaitUs = 0;
+    };
+    LaneStats stats(TaskLane lane) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats[static_cast<int>(lane)];
+    }
+    quint64 stolenCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stolen;
+    }
+    int workerCount() const { return m_workerCount; }
+
+    QJsonObject toJson() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        static const char* const kNames[kLaneCount] = {"interactive", "background", "maintenance"};
+        QJsonObject lanes;
+        for (int l = 0; l < kLaneCount; ++l) {
+            const LaneStats& st = m_stats[l];
+            const quint64 started = st.completed;
+            lanes[QLatin1String(kNames[l])] = QJsonObject{
+                {"queued", st.queued},
+                {"running", st.running},
+                {"peakQueued", st.peakQueued},
+                {"maxConcurrent", laneCap(l)},
+                {"submitted", static_cast<qint64>(st.submitted)},
+                {"completed", static_cast<qint64>(st.completed)},
+                {"cancelled", static_cast<qint64>(st.cancelled)},
+                {"avgWaitMs", started ? st.totalWaitUs / 1000.0 / started : 0.0},
+                {"maxWaitMs", st.maxWaitUs / 1000.0},
+            };
+        }
+        return QJsonObject{
+            {"workers", m_workerCount},
+            {"started", !m_workers.empty()},
+            {"stolen", static_cast<qint64>(m_stolen)},
+            {"pooledDatabase", !m_pooledPath.isEmpty()},
+            {"lanes", lanes},
+        };
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Task {
+        std::function<void()> run;
+        CancellationToken token;
+        Clock::time_point enqueued;
+    };
+    struct Worker {
+        const TaskExecutor* owner = nullptr;
+        QThread* thread = nullptr;
+        std::array<std::deque<Task>, kLaneCount> local;
+        quint64 releasedGeneration = 0;
+        bool exited = false;
+    };
+
+    // The worker the calling thread is, of whichever executor (tests run more
+    // than one) — submit() checks `owner`.
+    static Worker*& currentWorkerSlot() {
+        thread_local Worker* w = nullptr;
+        return w;
+    }
+    static Worker* currentWorker() { return currentWorkerSlot(); }
+
+    int laneCap(int lane) const {
+        switch (lane) {
+        case 0: return m_workerCount;
+        case 1: return std::max(1, m_workerCount - 1);
+        default: return std::max(1, m_workerCount / 2);
+        }
+    }
+
+    int queuedLocked() const { return m_stats[0].queued + m_stats[1].queued + m_stats[2].queued; }
+    bool idleLocked() const {
+        for (const LaneStats& st : m_stats) {
+            if (st.queued || st.running)
+                return false;
+        }
+        return true;
+    }
+
+    // Under m_mutex.
+    void ensureStarted() {
+        if (!m_workers.empty())
+            return;
+        for (int i = 0; i < m_workerCount; ++i) {
+            auto w = std::make_unique<Worker>();
+            Worker* raw = w.get();
+            raw->owner = this;
+            w->thread = QThread::create([this, raw]() { workerLoop(raw); });
+            w->thread->setObjectName(QStringLiteral("TaskExecutor-%1").arg(i));
+            m_workers.push_back(std::move(w));
+        }
+        for (const auto& w : m_workers)
+            w->thread->start();
+    }
+
+    // Under m_mutex. Highest lane with headroom first; within a lane, own newest,
+    // then the shared queue's oldest, then another worker's oldest.
+    bool takeTask(Worker* self, Task& out, int& outLane) {
+        for (int l = 0; l < kLaneCount; ++l) {
+            if (m_stats[l].running >= laneCap(l))
+                continue;
+            if (!self->local[l].empty()) {
+                out = std::move(self->local[l].back());
+                self->local[l].pop_back();
+            } else if (!m_shared[l].empty()) {
+                out = std::move(m_shared[l].front());
+                m_shared[l].pop_front();
+            } else {
+                Worker* victim = nullptr;
+                for (const auto& w : m_workers) {
+                    if (w.get() != self && !w->local[l].empty()) {
+                        victim = w.get();
+                        break;
+                    }
+                }
+                if (!victim)
+                    continue;
+                out = std::move(victim->local[l].front());
+                victim->local[l].pop_front();
+                ++m_stolen;
+            }
+            outLane = l;
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(Worker* self) {
+        currentWorkerSlot() = self;
+        QString pooledPath;
+        bool holdsPooled = false;
+        const auto releasePooled = [&](std::unique_lock<std::mutex>& lock) {
+            lock.unlock();
+            if (holdsPooled)
+                DbConnectionPool::releaseCurrentThread();
+            holdsPooled = false;
+            lock.lock();
+        };
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            if (self->releasedGeneration < m_releaseGeneration) {
+                const quint64 generation = m_releaseGeneration;
+                releasePooled(lock);
+                self->releasedGeneration = generation;
+                m_stateChanged.notify_all();
+            }
+
+            Task task;
+            int lane = 0;
+            if (!takeTask(self, task, lane)) {
+                if (m_stopping && queuedLocked() == 0)
+                    break;
+                const bool woken = m_workAvailable.wait_for(
+                    lock, std::chrono::milliseconds(DbConnectionPool::kIdleCloseMs), [&]() {
+                        return (m_stopping && queuedLocked() == 0)
+                            || self->releasedGeneration < m_releaseGeneration
+                            || hasTaskFor(self);
+                    });
+                if (!woken && holdsPooled)
+                    releasePooled(lock);  // idle long enough: let the file go
+                continue;
+            }
+
+            LaneStats& st = m_stats[lane];
+            --st.queued;
+            ++st.running;
+            const qint64 waitUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                Clock::now() - task.enqueued).count();
+            if (m_pooledPath != pooledPath) {
+                // Re-pointed (or switched off): drop the old file's connection.
+                releasePooled(lock);
+                pooledPath = m_pooledPath;
+            }
+            const bool cancelled = task.token.isCancelled();
+            lock.unlock();
+
+            if (!cancelled) {
+                if (!pooledPath.isEmpty()) {
+                    DbConnectionPool::poolOnCurrentThread(pooledPath);
+                    holdsPooled = true;
+                }
+                task.run();
+            }
+            // Before the counters say "done": a task's captures include the
+            // in-flight guards other code waits on (ShotHistoryStorage's
+            // detached-thread count), and those must drop first.
+            task = Task();
+
+            lock.lock();
+            --st.running;
+            if (cancelled) {
+                ++st.cancelled;
+            } else {
+                ++st.completed;
+                st.totalWaitUs += waitUs;
+                st.maxWaitUs = std::max(st.maxWaitUs, waitUs);
+            }
+            m_stateChanged.notify_all();
+            // A lane cap may have held another worker back until now.
+            if (queuedLocked() > 0)
+                m_workAvailable.notify_one();
+        }
+        self->exited = true;
+        m_stateChanged.notify_all();
+        lock.unlock();
+        if (holdsPooled)
+            DbConnectionPool::releaseCurrentThread();
+        currentWorkerSlot() = nullptr;
+    }
+
+    // Under m_mutex: would takeTask() find anything for `self` right now?
+    bool hasTaskFor(Worker* self) const {
+        for (int l = 0; l < kLaneCount; ++l) {
+            if (m_stats[l].running >= laneCap(l))
+                continue;
+            if (!m_shared[l].empty() || !self->local[l].empty())
+                return true;
+            for (const auto& w : m_workers) {
+                if (!w->local[l].empty())
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    const int m_workerCount;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workAvailable;   // workers wait here
+    std::condition_variable m_stateChanged;    // waitForIdle / release / shutdown wait here
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::array<std::deque<Task>, kLaneCount> m_shared;
+    std::array<LaneStats, kLaneCount> m_stats;
+    QString m_pooledPath;
+    quint64 m_releaseGeneration = 0;
+    quint64 m_stolen = 0;
+    bool m_stopping = false;
+};
@@ -4,6 +4,7 @@
 #include "settings_app.h"
 #include "translationmanager.h"
 #include "version.h"
+#include "taskexecutor.h"
 
 #include <algorithm>
 
@@ -758,12 +759,10 @@ void UpdateChecker::onDownloadFinished()
             const QString fileToRemove = m_downloadFile->fileName();
             const int capturedGen = s_downloadGeneration.loadAcquire();
             m_downloadFile->close();
-            QThread* t = QThread::create([fileToRemove, capturedGen]() {
+            TaskExecutor::instance().submit(TaskLane::Background, [fileToRemove, capturedGen]() {
                 if (s_downloadGeneration.loadAcquire() == capturedGen)
                     QFile::remove(fileToRemove);
             });
-            connect(t, &QThread::finished, t, &QThread::deleteLater);
-            t->start();
             delete m_downloadFile;
             m_downloadFile = nullptr;
             m_currentReply->deleteLater();
@@ -815,12 +814,10 @@ void UpdateChecker::onDownloadFinished()
         emit errorMessageChanged();
         {
             const int capturedGen = s_downloadGeneration.loadAcquire();
-            QThread* t = QThread::create([filePath, capturedGen]() {
+            TaskExecutor::instance().submit(TaskLane::Background, [filePath, capturedGen]() {
                 if (s_downloadGeneration.loadAcquire() == capturedGen)
                     QFile::remove(filePath);
             });
-            connect(t, &QThread::finished, t, &QThread::deleteLater);
-            t->start();
         }
         delete m_downloadFile;
         m_downloadFile = nullptr;
@@ -841,12 +838,10 @@ void UpdateChecker::onDownloadFinished()
         emit errorMessageChanged();
         {
             const int capturedGen = s_downloadGeneration.loadAcquire();
-            QThread* t = QThread::create([filePath, capturedGen]() {
+            TaskExecutor::instance().submit(TaskLane::Background, [filePath, capturedGen]() {
                 if (s_downloadGeneration.loadAcquire() == capturedGen)
                     QFile::remove(filePath);
             });
-            connect(t, &QThread::finished, t, &QThread::deleteLater);
-            t->start();
         }
         delete m_downloadFile;
         m_downloadFile = nullptr;
@@ -867,12 +862,10 @@ void UpdateChecker::onDownloadFinished()
         emit errorMessageChanged();
         {
             const int capturedGen = s_downloadGeneration.loadAcquire();
-            QThread* t = QThread::create([filePath, capturedGen]() {
+            TaskExecutor::instance().submit(TaskLane::Background, [filePath, capturedGen]() {
                 if (s_downloadGeneration.loadAcquire() == capturedGen)
                     QFile::remove(filePath);
             });
-            connect(t, &QThread::finished, t, &QThread::deleteLater);
-            t->start();
         }
         delete m_downloadFile;
         m_downloadFile = nullptr;
@@ -946,12 +939,10 @@ void UpdateChecker::dismissUpdate()
                 // subsequent user action) reuses the same filename before this thread
                 // runs, we must not delete the new download's freshly-opened file.
                 const int capturedGen = s_downloadGeneration.loadAcquire();
-                QThread* t = QThread::create([partialPath, capturedGen]() {
+                TaskExecutor::instance().submit(TaskLane::Background, [partialPath, capturedGen]() {
                     if (s_downloadGeneration.loadAcquire() == capturedGen)
                         QFile::remove(partialPath);
                 });
-                connect(t, &QThread::finished, t, &QThread::deleteLater);
-                t->start();
             }
         }
         m_downloading = false;
@@ -971,12 +962,10 @@ void UpdateChecker::dismissUpdate()
     if (!m_downloadedApkPath.isEmpty()) {
         QString path = m_downloadedApkPath;
         const int capturedGen = s_downloadGeneration.loadAcquire();
-        QThread* t = QThread::create([path, capturedGen]() {
+        TaskExecutor::instance().submit(TaskLane::Background, [path, capturedGen]() {
             if (s_downloadGeneration.loadAcquire() == capturedGen && !QFile::remove(path))
                 qWarning() << "UpdateChecker: Failed to remove cached APK:" << path;
         });
-        connect(t, &QThread::finished, t, &QThread::deleteLater);
-        t->start();
         m_downloadedApkPath.clear();
         m_expectedDownloadSize = 0;
         emit downloadReadyChanged();
@@ -1141,12 +1130,10 @@ void UpdateChecker::onInstallStatus(int status, const QString& message)
                 m_expectedDownloadSize = 0;
                 emit downloadReadyChanged();
                 const int capturedGen = s_downloadGeneration.loadAcquire();
-                QThread* t = QThread::create([path, capturedGen]() {
+                TaskExecutor::instance().submit(TaskLane::Background, [path, capturedGen]() {
                     if (s_downloadGeneration.loadAcquire() == capturedGen)
                         QFile::remove(path);
                 });
-                connect(t, &QThread::finished, t, &QThread::deleteLater);
-                t->start();
             }
             return;
         case 3:  // STATUS_FAILURE_ABORTED — user cancelled the confirmation.
@@ -1168,12 +1155,10 @@ void UpdateChecker::onInstallStatus(int status, const QString& message)
             if (!m_updateAvailable && !m_downloadedApkPath.isEmpty()) {
                 QString path = m_downloadedApkPath;
                 const int capturedGen = s_downloadGeneration.loadAcquire();
-                QThread* t = QThread::create([path, capturedGen]() {
+                TaskExecutor::instance().submit(TaskLane::Background, [path, capturedGen]() {
                     if (s_downloadGeneration.loadAcquire() == capturedGen)
                         QFile::remove(path);
                 });
-                connect(t, &QThread::finished, t, &QThread::deleteLater);
-                t->start();
                 m_downloadedApkPath.clear();
                 m_expectedDownloadSize = 0;
                 emit downloadReadyChanged();
@@ -1227,12 +1212,10 @@ void UpdateChecker::onInstallStatus(int status, const QString& message)
     if (!m_updateAvailable && !m_downloadedApkPath.isEmpty()) {
         QString path = m_downloadedApkPath;
         const int capturedGen = s_downloadGeneration.loadAcquire();
-        QThread* t = QThread::create([path, capturedGen]() {
+        TaskExecutor::instance().submit(TaskLane::Background, [path, capturedGen]() {
             if (s_downloadGeneration.loadAcquire() == capturedGen)
                 QFile::remove(path);
         });
-        connect(t, &QThread::finished, t, &QThread::deleteLater);
-        t->start();
         m_downloadedApkPath.clear();
         m_expectedDownloadSize = 0;
         emit downloadReadyChanged();
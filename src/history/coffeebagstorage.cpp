@@ -320,6 +320,12 @@ bool CoffeeBagStorage::isDbWorkIdle() const
     return !m_dbWorker || m_dbWorker->isIdle();
 }
 
+void CoffeeBagStorage::releaseDbConnections()
+{
+    if (m_dbWorker)
+        m_dbWorker->releasePooledConnections();
+}
+
 void CoffeeBagStorage::runAsync(const QString& connPrefix,
                                 std::function<void(QSqlDatabase&)> work,
                                 std::function<void(bool dbOpened)> done)
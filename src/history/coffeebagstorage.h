@@ -194,6 +194,10 @@ public:
     // with nothing shown for it.
     bool isDbWorkIdle() const;
 
+    // Blocks until the worker has closed its pooled connection to the file — see
+    // ShotHistoryStorage::releaseDbConnections().
+    void releaseDbConnections();
+
     // Async queries — results via signals (QVariantList of toVariantMap()).
     Q_INVOKABLE void requestInventory();                   // inInventory = true, MRU order
     Q_INVOKABLE void requestBag(qint64 bagId);             // bagReady()
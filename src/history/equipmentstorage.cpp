@@ -259,6 +259,12 @@ bool EquipmentStorage::isDbWorkIdle() const
     return !m_dbWorker || m_dbWorker->isIdle();
 }
 
+void EquipmentStorage::releaseDbConnections()
+{
+    if (m_dbWorker)
+        m_dbWorker->releasePooledConnections();
+}
+
 void EquipmentStorage::runAsync(const QString& connPrefix,
                                 std::function<void(QSqlDatabase&)> work,
                                 std::function<void(bool dbOpened)> done)
@@ -150,6 +150,10 @@ public:
     // rationale (same shape, same worker type).
     bool isDbWorkIdle() const;
 
+    // Blocks until the worker has closed its pooled connection to the file — see
+    // ShotHistoryStorage::releaseDbConnections().
+    void releaseDbConnections();
+
     // Async queries — results via signals.
     Q_INVOKABLE void requestInventory();                       // inventoryReady()
     Q_INVOKABLE void requestPackage(qint64 packageId);         // packageReady()
@@ -278,6 +278,12 @@ bool RecipeStorage::isDbWorkIdle() const
     return !m_dbWorker || m_dbWorker->isIdle();
 }
 
+void RecipeStorage::releaseDbConnections()
+{
+    if (m_dbWorker)
+        m_dbWorker->releasePooledConnections();
+}
+
 void RecipeStorage::runAsync(const QString& connPrefix,
                              std::function<void(QSqlDatabase&)> work,
                              std::function<void(bool dbOpened)> done)
@@ -484,6 +484,10 @@ public:
     // shutdown drain could not cover it.
     bool isDbWorkIdle() const;
 
+    // Blocks until the worker has closed its pooled connection to the file — see
+    // ShotHistoryStorage::releaseDbConnections().
+    void releaseDbConnections();
+
 signals:
     void inventoryReady(const QVariantList& recipes);
     void archivedReady(const QVariantList& recipes);
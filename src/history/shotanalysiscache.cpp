@@ -0,0 +1,193 @@
+#include "shotanalysiscache.h"
+
+#include "shothistory_types.h"
+#include "shothistorystorage_internal.h"
+#include "core/dbutils.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QIODevice>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include <type_traits>
+
+namespace ShotAnalysisCache {
+
+namespace {
+
+// Bump when the encoding below changes shape. Rows written in another format
+// fail decode() and are recomputed, so no migration is needed for it.
+constexpr quint8 kFormatVersion = 1;
+
+// Pinned rather than left at the build's default, so a Qt upgrade can't
+// change how an existing row reads.
+constexpr QDataStream::Version kStreamVersion = QDataStream::Qt_6_0;
+
+// Every DetectorResults field, in stream order. The one list drives both
+// directions, so a field can't be written without also being read back; a
+// field added to the struct and not here is caught by tst_shotrecord_cache's
+// round-trip test, and needs an ALGORITHM_VERSION bump anyway.
+template <typename Detectors, typename Visit>
+void visitDetectorFields(Detectors& d, Visit&& visit)
+{
+    visit(d.pourTruncated);
+    visit(d.peakPressureBar);
+    visit(d.pourStartSec);
+    visit(d.pourEndSec);
+    visit(d.channelingChecked);
+    visit(d.channelingSeverity);
+    visit(d.channelingSpikeTimeSec);
+    visit(d.flowTrendChecked);
+    visit(d.flowTrend);
+    visit(d.flowTrendDeltaMlPerSec);
+    visit(d.preinfusionObserved);
+    visit(d.preinfusionDripWeightG);
+    visit(d.preinfusionDripDurationSec);
+    visit(d.grindChecked);
+    visit(d.grindHasData);
+    visit(d.grindChokedPuck);
+    visit(d.grindYieldOvershoot);
+    visit(d.grindVerifiedClean);
+    visit(d.grindFlowDeltaMlPerSec);
+    visit(d.grindSampleCount);
+    visit(d.grindDirection);
+    visit(d.grindGateRan);
+    visit(d.grindGatePassed);
+    visit(d.grindGateFlowSamples);
+    visit(d.grindGatePressurizedDurationSec);
+    visit(d.grindGateMeanPressurizedFlowMlPerSec);
+    visit(d.grindGateYieldRatio);
+    visit(d.grindCoverage);
+    visit(d.skipFirstFrame);
+    visit(d.verdictCategory);
+}
+
+// qsizetype is 32-bit on 32-bit targets; widen it so a row (or a restored
+// backup) reads the same on every device.
+template <typename T>
+void writeField(QDataStream& out, const T& value)
+{
+    if constexpr (std::is_same_v<T, qsizetype>) out << qint64(value);
+    else out << value;
+}
+
+template <typename T>
+void readField(QDataStream& in, T& value)
+{
+    if constexpr (std::is_same_v<T, qsizetype>) {
+        qint64 wide = 0;
+        in >> wide;
+        value = qsizetype(wide);
+    } else {
+        in >> value;
+    }
+}
+
+void writeOptional(QDataStream& out, const std::optional<double>& value)
+{
+    out << value.has_value() << value.value_or(0.0);
+}
+
+} // namespace
+
+QByteArray inputsKey(const QString& beverageType, double durationSec,
+                     double targetWeightG, double finalWeightG,
+                     const QList<HistoryPhaseMarker>& phases,
+                     const decenza::storage::detail::AnalysisInputs& inputs)
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+
+    out << beverageType << durationSec << targetWeightG << finalWeightG;
+    out << qint64(phases.size());
+    for (const HistoryPhaseMarker& phase : phases) {
+        out << phase.time << phase.label << qint32(phase.frameNumber)
+            << phase.isFlowMode << phase.transitionReason;
+    }
+
+    out << inputs.analysisFlags << inputs.firstFrameSeconds << qint32(inputs.frameCount)
+        << inputs.profileKbResolved << inputs.identityKbId << inputs.identityFromShape;
+    out << inputs.expertBand.has_value();
+    if (inputs.expertBand) {
+        const ShotAnalysis::ExpertBand& band = *inputs.expertBand;
+        out << qint32(band.axis);
+        writeOptional(out, band.lo);
+        writeOptional(out, band.hi);
+        out << band.src << band.confidence;
+    }
+
+    return QCryptographicHash::hash(bytes, QCryptographicHash::Sha256);
+}
+
+QByteArray encode(const Entry& entry)
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+
+    out << kFormatVersion << entry.result.lines;
+    visitDetectorFields(entry.result.detectors, [&out](const auto& field) { writeField(out, field); });
+    out << entry.kbDerivedFrom;
+    return bytes;
+}
+
+std::optional<Entry> decode(const QByteArray& blob)
+{
+    QDataStream in(blob);
+    in.setVersion(kStreamVersion);
+
+    quint8 format = 0;
+    in >> format;
+    if (in.status() != QDataStream::Ok || format != kFormatVersion) return std::nullopt;
+
+    Entry entry;
+    in >> entry.result.lines;
+    visitDetectorFields(entry.result.detectors, [&in](auto& field) { readField(in, field); });
+    in >> entry.kbDerivedFrom;
+
+    if (in.status() != QDataStream::Ok || !in.atEnd()) return std::nullopt;
+    return entry;
+}
+
+std::optional<Entry> load(QSqlDatabase& db, qint64 shotId, const QByteArray& inputsKey)
+{
+    PreparedQuery query(db, QStringLiteral(
+        "SELECT fingerprint, inputs_key, result FROM shot_analysis WHERE shot_id = ?"));
+    if (!query.ok()) return std::nullopt;
+    query->bindValue(0, shotId);
+    if (!query->exec() || !query->next()) return std::nullopt;
+
+    const bool current = query->value(0).toLongLong() == kFingerprint
+        && query->value(1).toByteArray() == inputsKey;
+    const QByteArray blob = current ? query->value(2).toByteArray() : QByteArray();
+    // Release the read before the caller's writes — see the blob SELECT in
+    // loadShotRecordStatic for why an active statement breaks them.
+    query->finish();
+    return current ? decode(blob) : std::nullopt;
+}
+
+bool store(QSqlDatabase& db, qint64 shotId, const QByteArray& inputsKey, const Entry& entry)
+{
+    // Guarded on the shot still existing: the history re-analysis job reads a
+    // shot on one connection and writes its row later on another, and a shot
+    // deleted in between must cost nothing rather than fail the foreign key —
+    // and with it the rest of that job's batch.
+    PreparedQuery query(db, QStringLiteral(
+        "INSERT OR REPLACE INTO shot_analysis (shot_id, fingerprint, inputs_key, result) "
+        "SELECT ?, ?, ?, ? WHERE EXISTS (SELECT 1 FROM shots WHERE id = ?)"));
+    if (query.ok()) {
+        query->bindValue(0, shotId);
+        query->bindValue(1, kFingerprint);
+        query->bindValue(2, inputsKey);
+        query->bindValue(3, encode(entry));
+        query->bindValue(4, shotId);
+        if (query->exec()) return true;
+    }
+    qWarning() << "ShotAnalysisCache::store: failed for shot" << shotId << query->lastError().text();
+    return false;
+}
+
+} // namespace ShotAnalysisCache
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include <optional>
+
+#include "ai/conductance.h"
+#include "ai/shotanalysis.h"
+
+class QSqlDatabase;
+struct HistoryPhaseMarker;
+
+namespace decenza::storage::detail {
+struct AnalysisInputs;
+}
+
+// Persisted ShotAnalysis::analyzeShot output — the shot_analysis side table
+// (migration 40), one row per shot.
+//
+// analyzeShot is a pure function of the shot's curves, a handful of scalar
+// columns and the AnalysisInputs its profile resolves to, so its output only
+// changes when one of those does or when the detectors do. A row records both:
+//
+//   - fingerprint: kFingerprint at write time — the detector version and the
+//     derived-curve version whose conductanceDerivative it read. Rows with
+//     any other value are stale, and the history re-analysis job finds
+//     them by this column alone.
+//   - inputs_key: inputsKey() over everything besides the curves. A metadata
+//     edit or a KB update changes the key, and the row is simply not trusted
+//     on the next load — no edit path has to remember to invalidate it.
+//
+// The curves themselves are not keyed: a shot's sample blob is written once
+// and only ever rewritten by the derived-curve self-heal, which runs when
+// shot_samples.derived_version is stale — and then kFingerprint disagrees too.
+namespace ShotAnalysisCache {
+
+constexpr qint64 kFingerprint =
+    (qint64(ShotAnalysis::ALGORITHM_VERSION) << 16) | Conductance::kAlgorithmVersion;
+
+struct Entry {
+    ShotAnalysis::AnalysisResult result;
+    // ShotRecord::cachedKbDerivedFrom, which is derived beside the analysis
+    // and has to be restored with it.
+    QString kbDerivedFrom;
+};
+
+// SHA-256 over every non-curve analyzeShot argument, in a fixed order.
+QByteArray inputsKey(const QString& beverageType, double durationSec,
+                     double targetWeightG, double finalWeightG,
+                     const QList<HistoryPhaseMarker>& phases,
+                     const decenza::storage::detail::AnalysisInputs& inputs);
+
+// Versioned QDataStream encoding. decode() returns nullopt for anything it
+// did not write itself: another format version, a truncated blob, trailing
+// bytes.
+QByteArray encode(const Entry& entry);
+std::optional<Entry> decode(const QByteArray& blob);
+
+// The stored entry, or nullopt when there is no row, it is stale, its key
+// differs or it does not decode. Never warns on a miss — a miss is the
+// normal state of every shot saved before migration 40.
+std::optional<Entry> load(QSqlDatabase& db, qint64 shotId, const QByteArray& inputsKey);
+
+// INSERT OR REPLACE under kFingerprint; a shot that no longer exists stores
+// nothing and succeeds. Warns and returns false on failure.
+bool store(QSqlDatabase& db, qint64 shotId, const QByteArray& inputsKey, const Entry& entry);
+
+} // namespace ShotAnalysisCache
@@ -2,7 +2,8 @@
 #include "core/grinderaliases.h"
 #include "network/tastecvamap.h"
 #include <QFile>
-#include <QRegularExpression>
+#include <QHash>
+#include <QVarLengthArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -49,16 +50,106 @@ double jsonToScalar(const QJsonValue& v, double defaultVal = 0.0)
     }
     return v.toDouble(defaultVal);
 }
+
+// Tcl's whitespace. ASCII only: .shot keys and numbers are ASCII, and a
+// multi-byte UTF-8 sequence never contains one of these bytes.
+bool isTclSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// The position just past the '}' closing a '{' that sits just before `pos`,
+// or text.size() when it never closes.
+qsizetype skipBraced(QByteArrayView text, qsizetype pos)
+{
+    int braceCount = 1;
+    while (pos < text.size() && braceCount > 0) {
+        if (text[pos] == '{') braceCount++;
+        else if (text[pos] == '}') braceCount--;
+        pos++;
+    }
+    return pos;
+}
+
+// Where each top-level key of a .shot file starts its value, built in one
+// pass over the raw bytes. A top-level key is a line's leading run of
+// non-whitespace; its value starts at the next non-whitespace byte, which
+// may be on a later line (the `^key\s+` a multiline regex would match).
+// Every lookup after that is a hash probe instead of a scan of the file.
+class TclKeyIndex {
+public:
+    explicit TclKeyIndex(QByteArrayView content)
+        : m_content(content)
+    {
+        // ~40 top-level keys in a de1app file
+        m_valueStarts.reserve(64);
+        const qsizetype size = content.size();
+        qsizetype lineStart = 0;
+        while (lineStart < size) {
+            qsizetype lineEnd = content.indexOf('\n', lineStart);
+            if (lineEnd < 0) lineEnd = size;
+
+            qsizetype keyEnd = lineStart;
+            while (keyEnd < lineEnd && !isTclSpace(content[keyEnd])) keyEnd++;
+            if (keyEnd > lineStart) {
+                qsizetype valueStart = keyEnd;
+                while (valueStart < size && isTclSpace(content[valueStart])) valueStart++;
+                if (valueStart > keyEnd && valueStart < size)
+                    m_valueStarts[content.sliced(lineStart, keyEnd - lineStart)].append(valueStart);
+            }
+            lineStart = lineEnd + 1;
+        }
+    }
+
+    // The key's value on its line: a braced value up to its closing brace
+    // (braces included, not followed past the line), otherwise the first word.
+    QByteArrayView value(QByteArrayView key) const
+    {
+        const auto it = m_valueStarts.constFind(key);
+        if (it == m_valueStarts.cend()) return {};
+
+        const qsizetype start = it->first();
+        qsizetype end = m_content.indexOf('\n', start);
+        if (end < 0) end = m_content.size();
+        const QByteArrayView line = m_content.sliced(start, end - start).trimmed();
+
+        if (line.startsWith('{'))
+            return line.first(skipBraced(line, 1));
+
+        qsizetype wordEnd = 0;
+        while (wordEnd < line.size() && !isTclSpace(line[wordEnd])) wordEnd++;
+        return line.first(wordEnd);
+    }
+
+    // The first `key {...}` block, braces included, following nested braces
+    // across lines.
+    QByteArrayView bracedBlock(QByteArrayView key) const
+    {
+        const auto it = m_valueStarts.constFind(key);
+        if (it == m_valueStarts.cend()) return {};
+
+        for (const qsizetype start : *it) {
+            if (m_content[start] == '{')
+                return m_content.sliced(start, skipBraced(m_content, start + 1) - start);
+        }
+        return {};
+    }
+
+private:
+    QByteArrayView m_content;
+    // Every occurrence, in file order; the first one wins, as the regex did.
+    QHash<QByteArrayView, QVarLengthArray<qsizetype, 1>> m_valueStarts;
+};
 }  // namespace
 
 ShotFileParser::ParseResult ShotFileParser::parse(const QByteArray& fileContents, const QString& filename)
 {
     ParseResult result;
-    QString content = QString::fromUtf8(fileContents);
+    const TclKeyIndex index(fileContents);
 
     // Extract timestamp from clock field, falling back to the filename
     // (de1app names files YYYYMMDDTHHMMSS.shot, so the name is always a valid timestamp)
-    QString clockStr = extractValue(content, "clock");
+    const QByteArrayView clockStr = index.value("clock");
     qint64 timestamp = clockStr.toLongLong();
 
     if (timestamp == 0) {
@@ -83,30 +174,30 @@ ShotFileParser::ParseResult ShotFileParser::parse(const QByteArray& fileContents
     result.record.summary.uuid = generateUuid(timestamp, filename);
 
     // Extract time-series data
-    QVector<double> elapsed = parseTclList(extractValue(content, "espresso_elapsed"));
+    QVector<double> elapsed = parseTclList(index.value("espresso_elapsed"));
     if (elapsed.isEmpty()) {
         result.errorMessage = "Missing espresso_elapsed data";
         return result;
     }
 
     // Core time-series
-    QVector<double> pressure = parseTclList(extractValue(content, "espresso_pressure"));
-    QVector<double> flow = parseTclList(extractValue(content, "espresso_flow"));
-    QVector<double> tempBasket = parseTclList(extractValue(content, "espresso_temperature_basket"));
-    QVector<double> weight = parseTclList(extractValue(content, "espresso_weight"));
+    QVector<double> pressure = parseTclList(index.value("espresso_pressure"));
+    QVector<double> flow = parseTclList(index.value("espresso_flow"));
+    QVector<double> tempBasket = parseTclList(index.value("espresso_temperature_basket"));
+    QVector<double> weight = parseTclList(index.value("espresso_weight"));
 
     // Goal/target values
-    QVector<double> pressureGoal = parseTclList(extractValue(content, "espresso_pressure_goal"));
-    QVector<double> flowGoal = parseTclList(extractValue(content, "espresso_flow_goal"));
-    QVector<double> tempGoal = parseTclList(extractValue(content, "espresso_temperature_goal"));
+    QVector<double> pressureGoal = parseTclList(index.value("espresso_pressure_goal"));
+    QVector<double> flowGoal = parseTclList(index.value("espresso_flow_goal"));
+    QVector<double> tempGoal = parseTclList(index.value("espresso_temperature_goal"));
 
     // Additional data (de1app records these)
-    QVector<double> tempMix = parseTclList(extractValue(content, "espresso_temperature_mix"));
-    QVector<double> resistance = parseTclList(extractValue(content, "espresso_resistance"));
-    QVector<double> waterDispensed = parseTclList(extractValue(content, "espresso_water_dispensed"));
+    QVector<double> tempMix = parseTclList(index.value("espresso_temperature_mix"));
+    QVector<double> resistance = parseTclList(index.value("espresso_resistance"));
+    QVector<double> waterDispensed = parseTclList(index.value("espresso_water_dispensed"));
 
     // Scale-based flow rate (g/s) - important for visualizer and weight-flow graphs
-    QVector<double> flowWeight = parseTclList(extractValue(content, "espresso_flow_weight"));
+    QVector<double> flowWeight = parseTclList(index.value("espresso_flow_weight"));
 
     // Convert to point vectors
     result.record.pressure = toPointVector(elapsed, pressure);
@@ -134,7 +225,7 @@ ShotFileParser::ParseResult ShotFileParser::parse(const QByteArray& fileContents
     result.record.summary.duration = elapsed.isEmpty() ? 0 : elapsed.last();
 
     // Parse settings block for metadata
-    QString settingsBlock = extractBracedBlock(content, "settings");
+    const QByteArrayView settingsBlock = index.bracedBlock("settings");
     if (!settingsBlock.isEmpty()) {
         QVariantMap settings = parseTclDict(settingsBlock);
 
@@ -176,16 +267,12 @@ ShotFileParser::ParseResult ShotFileParser::parse(const QByteArray& fileContents
     }
 
     // Extract profile JSON
-    result.record.profileJson = extractProfileJson(content);
+    result.record.profileJson = extractProfileJson(index.bracedBlock("profile"));
 
     // Parse phase markers from timers
-    QString preinfStartStr = extractValue(content, "timers(espresso_preinfusion_start)");
-    QString pourStartStr = extractValue(content, "timers(espresso_pour_start)");
-    QString espressoStartStr = extractValue(content, "timers(espresso_start)");
-
-    qint64 espressoStart = espressoStartStr.toLongLong();
-    qint64 preinfStart = preinfStartStr.toLongLong();
-    qint64 pourStart = pourStartStr.toLongLong();
+    qint64 espressoStart = index.value("timers(espresso_start)").toLongLong();
+    qint64 preinfStart = index.value("timers(espresso_preinfusion_start)").toLongLong();
+    qint64 pourStart = index.value("timers(espresso_pour_start)").toLongLong();
 
     if (espressoStart > 0) {
         // Preinfusion start
@@ -446,23 +533,30 @@ ShotFileParser::ParseResult ShotFileParser::parseVisualizerShot(const QJsonObjec
     return result;
 }
 
-QVector<double> ShotFileParser::parseTclList(const QString& listStr)
+QVector<double> ShotFileParser::parseTclList(QByteArrayView listStr)
 {
     QVector<double> result;
-    QString str = listStr.trimmed();
+    QByteArrayView str = listStr.trimmed();
 
     // Remove outer braces if present
     if (str.startsWith('{') && str.endsWith('}')) {
-        str = str.mid(1, str.length() - 2);
+        str = str.size() > 1 ? str.sliced(1, str.size() - 2) : QByteArrayView();
     }
 
-    // Split by whitespace
-    QStringList parts = str.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+    // de1app separates samples with single spaces, so this is the count
+    result.reserve(str.count(' ') + 1);
+
+    // Each token is converted where it lies; QByteArrayView::toDouble is the
+    // same C-locale parser QString::toDouble uses, without the UTF-16 copy.
+    qsizetype pos = 0;
+    while (pos < str.size()) {
+        while (pos < str.size() && isTclSpace(str[pos])) pos++;
+        const qsizetype tokenStart = pos;
+        while (pos < str.size() && !isTclSpace(str[pos])) pos++;
+        if (pos == tokenStart) break;
 
-    result.reserve(parts.size());
-    for (const QString& part : parts) {
         bool ok;
-        double val = part.toDouble(&ok);
+        double val = str.sliced(tokenStart, pos - tokenStart).toDouble(&ok);
         if (ok) {
             result.append(val);
         }
@@ -471,112 +565,53 @@ QVector<double> ShotFileParser::parseTclList(const QString& listStr)
     return result;
 }
 
-QVariantMap ShotFileParser::parseTclDict(const QString& dictStr)
+QVariantMap ShotFileParser::parseTclDict(QByteArrayView dictStr)
 {
     QVariantMap result;
-    QString str = dictStr.trimmed();
+    QByteArrayView str = dictStr.trimmed();
 
     // Remove outer braces
     if (str.startsWith('{') && str.endsWith('}')) {
-        str = str.mid(1, str.length() - 2);
+        str = str.size() > 1 ? str.sliced(1, str.size() - 2) : QByteArrayView();
     }
 
-    int pos = 0;
-    while (pos < str.length()) {
+    qsizetype pos = 0;
+    while (pos < str.size()) {
         // Skip whitespace
-        while (pos < str.length() && str[pos].isSpace()) pos++;
-        if (pos >= str.length()) break;
+        while (pos < str.size() && isTclSpace(str[pos])) pos++;
+        if (pos >= str.size()) break;
 
         // Read key
-        QString key;
-        while (pos < str.length() && !str[pos].isSpace() && str[pos] != '{') {
-            key += str[pos++];
-        }
+        const qsizetype keyStart = pos;
+        while (pos < str.size() && !isTclSpace(str[pos]) && str[pos] != '{') pos++;
+        const QByteArrayView key = str.sliced(keyStart, pos - keyStart);
 
         // Skip whitespace
-        while (pos < str.length() && str[pos].isSpace()) pos++;
-        if (pos >= str.length()) break;
+        while (pos < str.size() && isTclSpace(str[pos])) pos++;
+        if (pos >= str.size()) break;
 
         // Read value
-        QString value;
+        QByteArrayView value;
         if (str[pos] == '{') {
             // Braced value - find matching close brace
-            int braceCount = 1;
-            pos++; // Skip opening brace
-            int valueStart = pos;
-            while (pos < str.length() && braceCount > 0) {
-                if (str[pos] == '{') braceCount++;
-                else if (str[pos] == '}') braceCount--;
-                pos++;
-            }
-            value = str.mid(valueStart, pos - valueStart - 1);
+            const qsizetype valueStart = pos + 1;
+            pos = skipBraced(str, valueStart);
+            value = str.sliced(valueStart, qMax<qsizetype>(0, pos - valueStart - 1));
         } else {
             // Unbraced value - read until whitespace
-            while (pos < str.length() && !str[pos].isSpace()) {
-                value += str[pos++];
-            }
+            const qsizetype valueStart = pos;
+            while (pos < str.size() && !isTclSpace(str[pos])) pos++;
+            value = str.sliced(valueStart, pos - valueStart);
         }
 
         if (!key.isEmpty()) {
-            result[key] = value;
+            result[QString::fromUtf8(key)] = QString::fromUtf8(value);
         }
     }
 
     return result;
 }
 
-QString ShotFileParser::extractValue(const QString& content, const QString& key)
-{
-    // Match patterns like: key {value} or key value
-    QRegularExpression re(QString("^%1\\s+(.+)$").arg(QRegularExpression::escape(key)),
-                          QRegularExpression::MultilineOption);
-    QRegularExpressionMatch match = re.match(content);
-
-    if (match.hasMatch()) {
-        QString value = match.captured(1).trimmed();
-
-        // Handle braced values
-        if (value.startsWith('{')) {
-            int braceCount = 1;
-            int pos = 1;
-            while (pos < value.length() && braceCount > 0) {
-                if (value[pos] == '{') braceCount++;
-                else if (value[pos] == '}') braceCount--;
-                pos++;
-            }
-            return value.left(pos);
-        }
-
-        // Simple value - return first word
-        return value.split(QRegularExpression("\\s+")).first();
-    }
-
-    return QString();
-}
-
-QString ShotFileParser::extractBracedBlock(const QString& content, const QString& key)
-{
-    // Find the key followed by a brace block
-    qsizetype keyPos = content.indexOf(QRegularExpression(QString("^%1\\s+\\{").arg(QRegularExpression::escape(key)),
-                                                     QRegularExpression::MultilineOption));
-    if (keyPos < 0) return QString();
-
-    // Find the opening brace
-    qsizetype braceStart = content.indexOf('{', keyPos);
-    if (braceStart < 0) return QString();
-
-    // Find matching closing brace
-    int braceCount = 1;
-    qsizetype pos = braceStart + 1;
-    while (pos < content.length() && braceCount > 0) {
-        if (content[pos] == '{') braceCount++;
-        else if (content[pos] == '}') braceCount--;
-        pos++;
-    }
-
-    return content.mid(braceStart, pos - braceStart);
-}
-
 QVector<QPointF> ShotFileParser::toPointVector(const QVector<double>& times, const QVector<double>& values)
 {
     QVector<QPointF> result;
@@ -593,31 +628,15 @@ QVector<QPointF> ShotFileParser::toPointVector(const QVector<double>& times, con
     return result;
 }
 
-QString ShotFileParser::extractProfileJson(const QString& content)
+QString ShotFileParser::extractProfileJson(QByteArrayView block)
 {
-    // The profile is stored as a JSON block after "profile {"
-    qsizetype profileStart = content.indexOf(QRegularExpression("^profile\\s+\\{", QRegularExpression::MultilineOption));
-    if (profileStart < 0) return QString();
-
-    qsizetype jsonStart = content.indexOf('{', profileStart);
-    if (jsonStart < 0) return QString();
-
-    // Find matching closing brace
-    int braceCount = 1;
-    qsizetype pos = jsonStart + 1;
-    while (pos < content.length() && braceCount > 0) {
-        if (content[pos] == '{') braceCount++;
-        else if (content[pos] == '}') braceCount--;
-        pos++;
-    }
-
-    QString jsonStr = content.mid(jsonStart, pos - jsonStart);
+    if (block.isEmpty()) return QString();
 
     // Validate it's actually JSON
-    QJsonDocument doc = QJsonDocument::fromJson(jsonStr.toUtf8());
+    QJsonDocument doc = QJsonDocument::fromJson(block.toByteArray());
     if (doc.isNull()) return QString();
 
-    return jsonStr;
+    return QString::fromUtf8(block);
 }
 
 QString ShotFileParser::generateUuid(qint64 timestamp, const QString& filename)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QByteArrayView>
 #include <QString>
 #include <QVector>
 #include <QPointF>
@@ -12,6 +13,10 @@
  *
  * These files contain time-series data, metadata, settings, and profile info
  * from shots recorded by the original Decent Espresso tablet app.
+ *
+ * parse() reads the raw bytes in place: one pass indexes where each top-level
+ * key's value starts, and lookups and numeric lists are then read straight
+ * from those offsets, so a file is decoded once rather than once per key.
  */
 class ShotFileParser {
 public:
@@ -59,23 +64,19 @@ public:
                                             qint64 clockEpoch);
 
 private:
-    // Parse Tcl list format: {value1 value2 value3 ...}
-    static QVector<double> parseTclList(const QString& listStr);
+    // Parse Tcl list format: {value1 value2 value3 ...}. Tokens that are not
+    // numbers are skipped.
+    static QVector<double> parseTclList(QByteArrayView listStr);
 
     // Parse Tcl dictionary format: key1 value1 key2 value2 ...
-    static QVariantMap parseTclDict(const QString& dictStr);
-
-    // Extract a top-level key-value pair from the file
-    static QString extractValue(const QString& content, const QString& key);
-
-    // Extract a braced block (handles nested braces)
-    static QString extractBracedBlock(const QString& content, const QString& key);
+    static QVariantMap parseTclDict(QByteArrayView dictStr);
 
     // Convert time + value arrays to QPointF vector
     static QVector<QPointF> toPointVector(const QVector<double>& times, const QVector<double>& values);
 
-    // Parse the embedded JSON profile
-    static QString extractProfileJson(const QString& content);
+    // The embedded JSON profile, given the braced `profile` block; empty
+    // unless it is valid JSON
+    static QString extractProfileJson(QByteArrayView block);
 
     // Generate UUID from timestamp for deduplication
     static QString generateUuid(qint64 timestamp, const QString& filename);
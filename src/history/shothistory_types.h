@@ -232,6 +232,42 @@ struct ShotRecord {
     QString cachedKbDerivedFrom;
 };
 
+// What a full load found out of date in a shot's stored rows, gathered by
+// ShotHistoryStorage::readShotRecordStatic so the writes can happen somewhere
+// other than the read: loadShotRecordStatic applies its own at once, the
+// history re-analysis job applies a batch of them in one transaction on the
+// serial worker. Empty when the rows were already current.
+struct ShotRecordRefresh {
+    qint64 shotId = 0;
+
+    // Non-empty: replaces shot_samples.data_blob, and stamps it.
+    QByteArray correctedBlob;
+    // With correctedBlob: a curve changed (not just the format), so
+    // shots.updated_at is bumped — see the self-heal in loadShotRecordStatic.
+    bool curvesChanged = false;
+    // The stored curves were recomputed and matched, so only
+    // shot_samples.derived_version is stale.
+    bool stampDerived = false;
+
+    // Non-empty: `analysis` and `kbDerivedFrom` go to shot_analysis under
+    // this inputs key (history/shotanalysiscache.h).
+    QByteArray analysisKey;
+    std::optional<ShotAnalysis::AnalysisResult> analysis;
+    QString kbDerivedFrom;
+
+    // The four badge columns disagree with the analysis; these are the values
+    // to write.
+    bool badgesChanged = false;
+    bool channelingDetected = false;
+    bool grindIssueDetected = false;
+    bool skipFirstFrameDetected = false;
+    bool pourTruncatedDetected = false;
+
+    bool isEmpty() const {
+        return correctedBlob.isEmpty() && !stampDerived && analysisKey.isEmpty() && !badgesChanged;
+    }
+};
+
 // Grinder settings context from shot history (shared by MCP and in-app AI)
 struct GrinderContext {
     QString model;
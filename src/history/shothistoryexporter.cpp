@@ -5,6 +5,7 @@
 #include "../core/settings.h"
 #include "../core/settings_network.h"
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 #include "../network/visualizeruploader.h"
 
 #include <QDateTime>
@@ -167,7 +168,7 @@ void ShotHistoryExporter::startBulkExport()
     });
     m_exportThreads->fetch_add(1, std::memory_order_relaxed);
 
-    QThread* thread = QThread::create([this, dbPath, historyDir, destroyed, inFlight]() {
+    TaskExecutor::instance().submit(TaskLane::Maintenance, [this, dbPath, historyDir, destroyed, inFlight]() {
         auto selectAllShots = [&dbPath](QList<ShotRefreshInfo>& out) {
             withTempDb(dbPath, "she_ids", [&](QSqlDatabase& db) {
                 QSqlQuery q(db);
@@ -227,8 +228,6 @@ void ShotHistoryExporter::startBulkExport()
             emit bulkExportFinished(written, skipped, failed);
         }, Qt::QueuedConnection);
     });
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
 
 void ShotHistoryExporter::exportSingleShot(qint64 shotId)
@@ -242,12 +241,10 @@ void ShotHistoryExporter::exportSingleShot(qint64 shotId)
     });
     m_exportThreads->fetch_add(1, std::memory_order_relaxed);
 
-    QThread* thread = QThread::create([dbPath, historyDir, shotId, destroyed, inFlight]() {
+    TaskExecutor::instance().submit(TaskLane::Background, [dbPath, historyDir, shotId, destroyed, inFlight]() {
         if (*destroyed) return;
         writeShotJson(dbPath, historyDir, shotId);
     });
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
 
 void ShotHistoryExporter::deleteExportedShot(qint64 shotId)
@@ -263,7 +260,7 @@ void ShotHistoryExporter::deleteExportedShot(qint64 shotId)
     });
     m_exportThreads->fetch_add(1, std::memory_order_relaxed);
 
-    QThread* thread = QThread::create([historyDir, shotId, destroyed, inFlight]() {
+    TaskExecutor::instance().submit(TaskLane::Background, [historyDir, shotId, destroyed, inFlight]() {
         if (*destroyed) return;
         QDir dir(historyDir);
         const QStringList matches = dir.entryList(
@@ -274,6 +271,4 @@ void ShotHistoryExporter::deleteExportedShot(qint64 shotId)
             }
         }
     });
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
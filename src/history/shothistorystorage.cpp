@@ -12,7 +12,9 @@
 #include "ai/conductance.h"
 #include "ai/shotanalysis.h"
 #include "ai/shotsummarizer.h"
+#include "history/shotanalysiscache.h"
 #include "history/shotbadgeprojection.h"
+#include "history/shotsampleblob.h"
 #include "core/grinderaliases.h"
 #include "core/yieldspec.h"
 #include "models/shotdatamodel.h"
@@ -23,6 +25,7 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QSqlRecord>
+#include <QCryptographicHash>
 #include <QStandardPaths>
 #include <QDir>
 #include <QUuid>
@@ -34,10 +37,15 @@
 #include <QDebug>
 #include <QSettings>
 #include <QThread>
+#include <QElapsedTimer>
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <iterator>
+#include <limits>
+#include <vector>
 #include "core/dbutils.h"
+#include "core/taskexecutor.h"
 
 #ifdef Q_OS_ANDROID
 #include <QJniObject>
@@ -77,13 +85,14 @@ void ShotHistoryStorage::runOnDbThread(std::function<void()> task)
 {
     if (!m_dbWorker)
         m_dbWorker = std::make_unique<SerialDbWorker>(QStringLiteral("ShotHistoryStorageWorker"));
+    m_dbWorker->setPooledDatabase(m_dbPath);
     m_dbWorker->post(std::move(task));
 }
 
-void ShotHistoryStorage::runDetachedDbThread(std::function<void()> body)
+void ShotHistoryStorage::runDetachedDbThread(std::function<void()> body, TaskLane lane)
 {
     // Counted, so isDbWorkIdle() can see it. The counter is a shared_ptr for the
-    // same reason m_destroyed is: the thread may outlive `this`, and it must still
+    // same reason m_destroyed is: the task may outlive `this`, and it must still
     // be able to decrement without touching a destroyed object.
     // The decrement is RAII rather than a trailing statement, so an exception escaping
     // body() cannot latch the counter above zero for the rest of the process. That matters
@@ -91,12 +100,9 @@ void ShotHistoryStorage::runDetachedDbThread(std::function<void()> body)
     // wait on it — a factory reset about to delete the file, a shutdown drain — from a wait
     // into a hang.
     //
-    // NOT covered: thread->start() failing. Qt only warns there, run() never executes, and
-    // `finished` never fires, so the QThread is never deleteLater'd and the lambda holding
-    // this guard is never destroyed either. Accepted rather than worked around: it means
-    // the OS refused a thread, the process has bigger problems, and the tests' failOnWarning
-    // would surface Qt's warning immediately. Stated because the first draft of this comment
-    // claimed the guard handled it, which is wrong in a way that reads as reassuring.
+    // NOT covered: a task TaskExecutor::shutdown() abandons at exit, queued or running —
+    // its lambda, and with it this guard, is never destroyed. Accepted: shutdown runs
+    // after the event loop has ended, and nothing waits on this counter by then.
     struct InFlightGuard {
         std::shared_ptr<std::atomic<int>> counter;
         explicit InFlightGuard(std::shared_ptr<std::atomic<int>> c) : counter(std::move(c)) {
@@ -114,12 +120,10 @@ void ShotHistoryStorage::runDetachedDbThread(std::function<void()> body)
         }
     };
 
-    QThread* thread = QThread::create(
+    TaskExecutor::instance().submit(lane,
         [body = std::move(body), guard = InFlightGuard(m_detachedDbThreads)]() mutable {
             body();
         });
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
 
 bool ShotHistoryStorage::isDbWorkIdle() const
@@ -145,6 +149,12 @@ bool ShotHistoryStorage::isDbWriteWorkIdle() const
     return !m_dbWorker || m_dbWorker->isIdle();
 }
 
+void ShotHistoryStorage::releaseDbConnections()
+{
+    if (m_dbWorker)
+        m_dbWorker->releasePooledConnections();
+}
+
 void ShotHistoryStorage::close()
 {
     if (m_db.isOpen()) {
@@ -269,6 +279,10 @@ bool ShotHistoryStorage::initialize(const QString& dbPath)
     // named "ShotHistoryStorageWorker", in whichever test happened to be
     // running — see the same hazard documented in tst_coffeebags.cpp.
     logGrinderCensus();
+    // Same placement and same test-build exclusion as the census. The job's
+    // batches queue behind anything already posted, so startup work the user
+    // is waiting on is never behind it.
+    requestHistoryReanalysis();
 #endif
 
     qDebug() << "ShotHistoryStorage: Database initialized with" << m_totalShots << "shots";
@@ -2100,6 +2114,196 @@ bool ShotHistoryStorage::runMigrations()
         }
     }
 
+    // Migration 39: move the two cold text blobs out of `shots`. debug_log
+    // (~10 KB) and profile_json (~5 KB) made up most of every row, so every
+    // filtered list, distinct-value getter and auto-favorites GROUP BY that
+    // can't run off a covering index paged through them for nothing. Logs go
+    // to shot_debug_logs keyed by shot id; profiles go to shot_profiles keyed
+    // by the SHA-256 of their JSON, so the dozens of shots pulled from one
+    // profile share a single row. Readers LEFT JOIN both tables back in.
+    //
+    // DROP COLUMN (SQLite >= 3.35, like migration 23) leaves the freed pages on
+    // the freelist, where new rows reuse them — no VACUUM, which would rewrite
+    // the whole file on the main thread at startup.
+    if (currentVersion >= 38 && currentVersion < 39) {
+        qDebug() << "ShotHistoryStorage: Running migration to version 39 "
+                    "(debug_log/profile_json side tables)";
+        query.finish();
+        DbWriteTxn txn = DbWriteTxn::begin(m_db, "migration cold blob tables", 1);
+        if (!txn.ok()) {
+            qWarning() << "ShotHistoryStorage: migration 39 could not start a transaction"
+                          " - will retry next launch";
+        } else {
+        bool ok = query.exec(R"(
+            CREATE TABLE IF NOT EXISTS shot_profiles (
+                hash TEXT PRIMARY KEY,
+                profile_json TEXT NOT NULL
+            ) WITHOUT ROWID
+        )") && query.exec(R"(
+            CREATE TABLE IF NOT EXISTS shot_debug_logs (
+                shot_id INTEGER PRIMARY KEY REFERENCES shots(id) ON DELETE CASCADE,
+                debug_log TEXT NOT NULL
+            )
+        )");
+        if (ok && !hasColumn("shots", "profile_hash"))
+            ok = query.exec("ALTER TABLE shots ADD COLUMN profile_hash TEXT");
+
+        if (ok && hasColumn("shots", "profile_json")) {
+            // Collect first, update after: an UPDATE on `shots` while the
+            // SELECT over it is still stepping is undefined in SQLite. The
+            // cache skips re-hashing the same JSON for every shot of a profile.
+            QList<QPair<qint64, QString>> hashes;
+            QHash<QString, QString> hashByJson;
+            QSqlQuery read(m_db);
+            ok = read.exec("SELECT id, profile_json FROM shots "
+                           "WHERE profile_json IS NOT NULL AND profile_json != ''");
+            while (ok && read.next()) {
+                const QString json = read.value(1).toString();
+                auto it = hashByJson.constFind(json);
+                if (it == hashByJson.constEnd()) {
+                    const std::optional<QString> hash = storeProfileJsonStatic(m_db, json);
+                    if (!hash) { ok = false; break; }
+                    it = hashByJson.insert(json, *hash);
+                }
+                hashes.append({read.value(0).toLongLong(), *it});
+            }
+            read.finish();
+
+            QSqlQuery update(m_db);
+            update.prepare("UPDATE shots SET profile_hash = ? WHERE id = ?");
+            for (qsizetype i = 0; ok && i < hashes.size(); ++i) {
+                update.addBindValue(hashes[i].second);
+                update.addBindValue(hashes[i].first);
+                ok = update.exec();
+            }
+            if (ok)
+                qDebug() << "ShotHistoryStorage: migration 39 hashed" << hashes.size()
+                         << "profile(s) into" << hashByJson.size() << "distinct row(s)";
+        }
+        if (ok && hasColumn("shots", "debug_log")) {
+            ok = query.exec("INSERT OR IGNORE INTO shot_debug_logs (shot_id, debug_log) "
+                            "SELECT id, debug_log FROM shots "
+                            "WHERE debug_log IS NOT NULL AND debug_log != ''");
+        }
+        if (ok && hasColumn("shots", "debug_log"))
+            ok = query.exec("ALTER TABLE shots DROP COLUMN debug_log");
+        if (ok && hasColumn("shots", "profile_json"))
+            ok = query.exec("ALTER TABLE shots DROP COLUMN profile_json");
+        if (ok) {
+            // A profile row outlives its last shot only until that shot is
+            // deleted; shot_debug_logs is cleaned by its ON DELETE CASCADE.
+            ok = query.exec("CREATE INDEX IF NOT EXISTS idx_shots_profile_hash ON shots(profile_hash)")
+                 && query.exec(R"(
+                CREATE TRIGGER IF NOT EXISTS shots_profile_gc AFTER DELETE ON shots
+                WHEN old.profile_hash IS NOT NULL BEGIN
+                    DELETE FROM shot_profiles WHERE hash = old.profile_hash
+                        AND NOT EXISTS (SELECT 1 FROM shots WHERE profile_hash = old.profile_hash);
+                END
+            )");
+        }
+        if (!ok)
+            qWarning() << "ShotHistoryStorage: migration 39 failed:" << query.lastError().text();
+
+        // Post-condition, as in migration 23: stamp only when the columns are
+        // verifiably gone, so a half-applied pass retries instead of leaving
+        // readers joining against data that never moved.
+        ok = ok && columnPresent("shots", "debug_log") == std::optional<bool>(false)
+             && columnPresent("shots", "profile_json") == std::optional<bool>(false)
+             && columnPresent("shots", "profile_hash") == std::optional<bool>(true);
+        if (ok) {
+            ok = query.exec("DELETE FROM schema_version")
+                 && query.exec(QStringLiteral("INSERT INTO schema_version (version) VALUES (39)"));
+        }
+        if (ok && txn.commit()) {
+            currentVersion = 39;
+            qDebug() << "ShotHistoryStorage: migration 39 complete";
+        } else {
+            qWarning() << "ShotHistoryStorage: migration 39 incomplete - will retry next launch";
+        }
+        }
+    }
+
+    // Migration 40: versioned derived data. shot_samples.derived_version
+    // records which Conductance:: version produced the blob's derived curves,
+    // and shot_analysis holds each shot's analyzeShot output under its
+    // fingerprint (history/shotanalysiscache.h). Loads trust both when they
+    // are current instead of recomputing on every open.
+    //
+    // Nothing is backfilled: every existing blob reads as version 0, which is
+    // stale, so each shot is re-derived once — on its next load, or by the
+    // history re-analysis job — exactly as every load did before this.
+    if (currentVersion >= 39 && currentVersion < 40) {
+        qDebug() << "ShotHistoryStorage: Running migration to version 40 "
+                    "(derived-curve and analysis stamps)";
+        query.finish();
+        DbWriteTxn txn = DbWriteTxn::begin(m_db, "migration derived data stamps", 1);
+        if (!txn.ok()) {
+            qWarning() << "ShotHistoryStorage: migration 40 could not start a transaction"
+                          " - will retry next launch";
+        } else {
+        bool ok = query.exec(R"(
+            CREATE TABLE IF NOT EXISTS shot_analysis (
+                shot_id INTEGER PRIMARY KEY REFERENCES shots(id) ON DELETE CASCADE,
+                fingerprint INTEGER NOT NULL,
+                inputs_key BLOB NOT NULL,
+                result BLOB NOT NULL
+            )
+        )");
+        if (ok && !hasColumn("shot_samples", "derived_version"))
+            ok = query.exec("ALTER TABLE shot_samples ADD COLUMN derived_version INTEGER NOT NULL DEFAULT 0");
+        if (!ok)
+            qWarning() << "ShotHistoryStorage: migration 40 failed:" << query.lastError().text();
+
+        ok = ok && columnPresent("shot_samples", "derived_version") == std::optional<bool>(true);
+        if (ok) {
+            ok = query.exec("DELETE FROM schema_version")
+                 && query.exec(QStringLiteral("INSERT INTO schema_version (version) VALUES (40)"));
+        }
+        if (ok && txn.commit()) {
+            currentVersion = 40;
+            qDebug() << "ShotHistoryStorage: migration 40 complete";
+        } else {
+            qWarning() << "ShotHistoryStorage: migration 40 incomplete - will retry next launch";
+        }
+        }
+    }
+
+    // Migration 41: checkpoint for the history re-analysis job
+    // (requestHistoryReanalysis). One row at most: the fingerprint the job was
+    // running under, the id its next batch starts below, and how many shots
+    // it had done — written in the same transaction as each batch, so a
+    // restart resumes exactly where the last commit left off.
+    if (currentVersion >= 40 && currentVersion < 41) {
+        qDebug() << "ShotHistoryStorage: Running migration to version 41 (re-analysis checkpoint)";
+        query.finish();
+        DbWriteTxn txn = DbWriteTxn::begin(m_db, "migration reanalysis checkpoint", 1);
+        if (!txn.ok()) {
+            qWarning() << "ShotHistoryStorage: migration 41 could not start a transaction"
+                          " - will retry next launch";
+        } else {
+        bool ok = query.exec(R"(
+            CREATE TABLE IF NOT EXISTS shot_reanalysis_checkpoint (
+                id INTEGER PRIMARY KEY CHECK (id = 1),
+                fingerprint INTEGER NOT NULL,
+                before_id INTEGER NOT NULL,
+                done INTEGER NOT NULL
+            )
+        )");
+        if (!ok)
+            qWarning() << "ShotHistoryStorage: migration 41 failed:" << query.lastError().text();
+        if (ok) {
+            ok = query.exec("DELETE FROM schema_version")
+                 && query.exec(QStringLiteral("INSERT INTO schema_version (version) VALUES (41)"));
+        }
+        if (ok && txn.commit()) {
+            currentVersion = 41;
+            qDebug() << "ShotHistoryStorage: migration 41 complete";
+        } else {
+            qWarning() << "ShotHistoryStorage: migration 41 incomplete - will retry next launch";
+        }
+        }
+    }
+
     m_schemaVersion = currentVersion;
     return true;
 }
@@ -2121,136 +2325,178 @@ void ShotHistoryStorage::importLegacyBeanPresets()
     m_migratedActiveBagId = CoffeeBagStorage::convertLegacyPresetSettings(m_dbPath);
 }
 
-QJsonObject ShotHistoryStorage::pointsToJsonObject(const QVector<QPointF>& points)
+QByteArray ShotHistoryStorage::compressSampleData(ShotDataModel* shotData, const QString& phaseSummariesJson)
 {
-    QJsonArray timeArr, valueArr;
-    for (const auto& pt : points) {
-        timeArr.append(pt.x());
-        valueArr.append(pt.y());
-    }
-    QJsonObject obj;
-    obj["t"] = timeArr;
-    obj["v"] = valueArr;
-    return obj;
+    return compressSampleData(shotData->samples(), phaseSummariesJson);
 }
 
-QByteArray ShotHistoryStorage::compressSampleData(ShotDataModel* shotData, const QString& phaseSummariesJson)
+QByteArray ShotHistoryStorage::compressSampleData(const ShotSampleBuffer& samples, const QString& phaseSummariesJson)
 {
-    QJsonObject root;
-
-    root["pressure"] = pointsToJsonObject(shotData->pressureData());
-    root["flow"] = pointsToJsonObject(shotData->flowData());
-    root["temperature"] = pointsToJsonObject(shotData->temperatureData());
-    root["pressureGoal"] = pointsToJsonObject(shotData->pressureGoalData());
-    root["flowGoal"] = pointsToJsonObject(shotData->flowGoalData());
-    root["temperatureGoal"] = pointsToJsonObject(shotData->temperatureGoalData());
-    root["temperatureMixGoal"] = pointsToJsonObject(shotData->temperatureMixGoalData());
-
-    root["temperatureMix"] = pointsToJsonObject(shotData->temperatureMixData());
-    root["resistance"] = pointsToJsonObject(shotData->resistanceData());
-    root["conductance"] = pointsToJsonObject(shotData->conductanceData());
-    root["darcyResistance"] = pointsToJsonObject(shotData->darcyResistanceData());
-    root["conductanceDerivative"] = pointsToJsonObject(shotData->conductanceDerivativeData());
-    root["waterDispensed"] = pointsToJsonObject(shotData->waterDispensedData());
-
-    // Weight data - store cumulative weight for history
-    root["weight"] = pointsToJsonObject(shotData->cumulativeWeightData());
-    // Also store flow rate from scale for future graph display
-    root["weightFlow"] = pointsToJsonObject(shotData->weightData());
-    // Weight-based flow rate (g/s) for visualizer export
-    root["weightFlowRate"] = pointsToJsonObject(shotData->weightFlowRateData());
-
-    // Phase summaries for UI display (pre-computed by saveShot() via computePhaseSummaries)
-    if (!phaseSummariesJson.isEmpty()) {
-        root["phaseSummaries"] = QJsonDocument::fromJson(phaseSummariesJson.toUtf8()).array();
-    }
-
-    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Compact);
-    return qCompress(json, 9);  // Max compression
+    using ShotSampleBlob::Series;
+    using Channel = ShotSampleBuffer::Channel;
+
+    // The goal segments concatenate into a fresh vector, so they need a
+    // local to outlive the SeriesRef pointing at them. Everything else is a
+    // column view; the machine-clock ones share one time array.
+    const QVector<QPointF> pressureGoal = samples.goalPoints(ShotSampleBuffer::GoalCurve::Pressure);
+    const QVector<QPointF> flowGoal = samples.goalPoints(ShotSampleBuffer::GoalCurve::Flow);
+
+    // Weight is the cumulative series. The graph copy (weightData(), the
+    // old "weightFlow" key) was written alongside it "for future graph
+    // display" and never read back; it is the same samples plus a leading
+    // zero, so it no longer takes space in the blob.
+    return ShotSampleBlob::encode({
+        {Series::Pressure, nullptr, samples.column(Channel::Pressure)},
+        {Series::Flow, nullptr, samples.column(Channel::Flow)},
+        {Series::Temperature, nullptr, samples.column(Channel::Temperature)},
+        {Series::TemperatureMix, nullptr, samples.column(Channel::TemperatureMix)},
+        {Series::PressureGoal, &pressureGoal},
+        {Series::FlowGoal, &flowGoal},
+        {Series::TemperatureGoal, nullptr, samples.column(Channel::TemperatureGoal)},
+        {Series::TemperatureMixGoal, nullptr, samples.column(Channel::TemperatureMixGoal)},
+        {Series::Resistance, nullptr, samples.column(Channel::Resistance)},
+        {Series::Conductance, nullptr, samples.column(Channel::Conductance)},
+        {Series::DarcyResistance, nullptr, samples.column(Channel::DarcyResistance)},
+        {Series::ConductanceDerivative, nullptr, samples.column(Channel::ConductanceDerivative)},
+        {Series::WaterDispensed, nullptr, samples.column(Channel::WaterDispensed)},
+        {Series::Weight, nullptr, samples.column(Channel::Weight)},
+        {Series::WeightFlowRate, nullptr, samples.column(Channel::WeightFlowRate)},
+    }, phaseSummariesJson);
 }
 
-void ShotHistoryStorage::decompressSampleData(const QByteArray& blob, ShotRecord* record,
-                                               QByteArray* outCorrectedBlob)
+void ShotHistoryStorage::encodeShotSamples(ShotSaveData& data, const ShotSampleBuffer& samples)
 {
-    if (outCorrectedBlob) outCorrectedBlob->clear();
+    using Channel = ShotSampleBuffer::Channel;
 
-    QByteArray json = qUncompress(blob);
-    if (json.isEmpty()) {
-        qWarning() << "ShotHistoryStorage: Failed to decompress sample data";
-        return;
-    }
+    // Compute quality flags and phase summaries. Uses ShotSummarizer::getAnalysisFlags()
+    // for KB flag lookups and ShotAnalysis helpers for detection — the same
+    // calls loadShotRecordStatic() makes on its worker for every load.
+    // Build a temporary ShotRecord from the snapshot to reuse the static helpers.
+    ShotRecord tmpRecord;
+    // The detectors still take point vectors, so these four are
+    // materialized from the snapshot's columns.
+    tmpRecord.pressure = samples.column(Channel::Pressure).toPoints();
+    tmpRecord.flow = samples.column(Channel::Flow).toPoints();
+    tmpRecord.temperature = samples.column(Channel::Temperature).toPoints();
+    tmpRecord.weight = samples.column(Channel::Weight).toPoints();
+    tmpRecord.phases = data.phaseMarkers;
+
+    // Compute phase summaries
+    computePhaseSummaries(tmpRecord);
+    data.phaseSummariesJson = tmpRecord.phaseSummariesJson;
 
-    QJsonDocument doc = QJsonDocument::fromJson(json);
-    QJsonObject root = doc.object();
+    // Compute all four quality badges via a single ShotAnalysis::analyzeShot
+    // pass and project the booleans from DetectorResults using the
+    // documented mapping. This unifies the save-time, load-time, and
+    // dialog/AI/MCP cascades on one pipeline — the cascade lives in exactly
+    // one place (analyzeShot's body). See docs/SHOT_REVIEW.md §4 for the
+    // full mapping table and decenza::deriveBadgesFromAnalysis (in
+    // history/shotbadgeprojection.h) for the projection rules.
+    const AnalysisInputs inputs = prepareAnalysisInputs(data.profileKbId, data.profileJson);
+    // Read the gate off AnalysisInputs rather than deriving it from the
+    // persisted id. The id is empty for a profile that resolved by SHAPE
+    // (change: resolve-profile-kb-by-shape) — a re-tuned copy of a
+    // documented profile, for which Arm 1's structural question is
+    // answerable. Deriving from the id would gate Arm 1 off for exactly
+    // the profiles this change exists to serve.
+    const bool profileKbResolved = inputs.profileKbResolved;
+    const auto analysis = ShotAnalysis::analyzeShot(
+        tmpRecord.pressure, tmpRecord.flow,
+        tmpRecord.weight,
+        samples.column(Channel::ConductanceDerivative).toPoints(),
+        tmpRecord.phases, data.beverageType, data.duration,
+        samples.goalPoints(ShotSampleBuffer::GoalCurve::Pressure),
+        samples.goalPoints(ShotSampleBuffer::GoalCurve::Flow),
+        inputs.analysisFlags, inputs.firstFrameSeconds,
+        data.targetWeight, data.finalWeight,
+        inputs.frameCount, inputs.expertBand,
+        profileKbResolved);
+    decenza::applyBadgesToTarget(data, analysis.detectors);
+
+    // Encode from the snapshot's columns
+    data.compressedSamples = compressSampleData(samples, data.phaseSummariesJson);
+    data.sampleCount = static_cast<int>(samples.sampleCount());
+}
 
-    auto arrayToPoints = [](const QJsonObject& obj) {
-        QVector<QPointF> points;
-        QJsonArray timeArr = obj["t"].toArray();
-        QJsonArray valueArr = obj["v"].toArray();
-        qsizetype count = qMin(timeArr.size(), valueArr.size());
-        points.reserve(count);
-        for (qsizetype i = 0; i < count; ++i) {
-            points.append(QPointF(timeArr[i].toDouble(), valueArr[i].toDouble()));
-        }
-        return points;
-    };
+bool ShotHistoryStorage::decompressSampleData(const QByteArray& blob, ShotRecord* record,
+                                               QByteArray* outCorrectedBlob,
+                                               bool* outCurvesChanged,
+                                               ShotSampleBlob::SeriesMask series,
+                                               bool storedDerivedCurrent)
+{
+    using ShotSampleBlob::Series;
+    using ShotSampleBlob::seriesBit;
 
-    record->pressure = arrayToPoints(root["pressure"].toObject());
-    record->flow = arrayToPoints(root["flow"].toObject());
-    record->temperature = arrayToPoints(root["temperature"].toObject());
-    record->pressureGoal = arrayToPoints(root["pressureGoal"].toObject());
-    record->flowGoal = arrayToPoints(root["flowGoal"].toObject());
-    record->temperatureGoal = arrayToPoints(root["temperatureGoal"].toObject());
-    // Absent for shots recorded before the mix goal series existed — leave empty
-    // rather than defaulting, so consumers can tell "no data" from "goal was 0".
-    if (root.contains("temperatureMixGoal"))
-        record->temperatureMixGoal = arrayToPoints(root["temperatureMixGoal"].toObject());
-    if (root.contains("temperatureMix"))
-        record->temperatureMix = arrayToPoints(root["temperatureMix"].toObject());
-    if (root.contains("resistance"))
-        record->resistance = arrayToPoints(root["resistance"].toObject());
-    if (root.contains("conductance"))
-        record->conductance = arrayToPoints(root["conductance"].toObject());
-    if (root.contains("darcyResistance"))
-        record->darcyResistance = arrayToPoints(root["darcyResistance"].toObject());
-    if (root.contains("conductanceDerivative"))
-        record->conductanceDerivative = arrayToPoints(root["conductanceDerivative"].toObject());
-    if (root.contains("waterDispensed"))
-        record->waterDispensed = arrayToPoints(root["waterDispensed"].toObject());
-    record->weight = arrayToPoints(root["weight"].toObject());
-    if (root.contains("weightFlowRate"))
-        record->weightFlowRate = arrayToPoints(root["weightFlowRate"].toObject());
-
-    // Phase summaries (stored as JSON array in the compressed blob)
-    if (root.contains("phaseSummaries")) {
-        record->phaseSummariesJson = QString::fromUtf8(
-            QJsonDocument(root["phaseSummaries"].toArray()).toJson(QJsonDocument::Compact));
+    if (outCorrectedBlob) outCorrectedBlob->clear();
+    if (outCurvesChanged) *outCurvesChanged = false;
+
+    // Stamped by the current Conductance:: code (shot_samples.derived_version):
+    // the stored curves are what computeDerivedCurves would produce, so they
+    // are decoded like any other series and nothing is recomputed. Only a
+    // binary blob can carry a stamp — the legacy format predates it — so a
+    // legacy blob falls through to the upgrade below whatever the caller says.
+    if (storedDerivedCurrent && ShotSampleBlob::isBinary(blob))
+        return ShotSampleBlob::decode(blob, record, series) != ShotSampleBlob::Format::Invalid;
+
+    if (series != ShotSampleBlob::kAllSeries) {
+        // Partial load: decode only what was asked for, plus pressure/flow
+        // when a derived curve was asked for (it is recomputed from them).
+        // There is no self-heal or format upgrade here — re-encoding would
+        // write back a blob missing every series that wasn't decoded — so
+        // the next full load of this shot does both.
+        const bool wantsDerived = (series & ShotSampleBlob::kDerivedSeries) != 0;
+        const ShotSampleBlob::SeriesMask sources =
+            seriesBit(Series::Pressure) | seriesBit(Series::Flow);
+        const ShotSampleBlob::SeriesMask decodeMask = series | (wantsDerived ? sources : 0);
+        if (ShotSampleBlob::decode(blob, record, decodeMask) == ShotSampleBlob::Format::Invalid)
+            return false;  // decode() has warned
+        if (!wantsDerived) return false;
+
+        computeDerivedCurves(*record);
+        // Drop what was only decoded or derived along the way, so a caller
+        // can't come to depend on a series its mask didn't name.
+        const std::pair<Series, QVector<QPointF> ShotRecord::*> incidental[] = {
+            {Series::Pressure, &ShotRecord::pressure},
+            {Series::Flow, &ShotRecord::flow},
+            {Series::Resistance, &ShotRecord::resistance},
+            {Series::Conductance, &ShotRecord::conductance},
+            {Series::DarcyResistance, &ShotRecord::darcyResistance},
+            {Series::ConductanceDerivative, &ShotRecord::conductanceDerivative},
+        };
+        for (const auto& [id, field] : incidental) {
+            if (!(series & seriesBit(id))) (record->*field).clear();
+        }
+        return true;
     }
 
+    const ShotSampleBlob::Format format = ShotSampleBlob::decode(blob, record);
+    if (format == ShotSampleBlob::Format::Invalid) return false;  // decode() has warned
+
     // Resistance, conductance, Darcy resistance and the conductance derivative
     // are pure functions of pressure/flow — recompute them unconditionally from
     // this shot's own samples rather than trusting whatever formula produced the
     // stored values (recompute-shot-curves-on-load). computeDerivedCurves()
-    // no-ops below 3 samples, leaving whatever was just parsed above untouched.
+    // no-ops below 3 samples, leaving whatever was just decoded above untouched.
     //
-    // Table-driven (one row per curve) rather than four parallel snapshot/compare/
-    // write blocks, so a future curve added to this set can't get wired into some
-    // of the three spots (snapshot, compare, JSON-key write) while silently missing another.
+    // Table-driven (one row per curve) rather than four parallel snapshot/compare
+    // blocks, so a future curve added to this set can't get wired into one of
+    // the two spots while silently missing the other.
     struct DerivedCurve {
-        const char* jsonKey;
         QVector<QPointF>* field;
         QVector<QPointF> stored;
     };
     std::array<DerivedCurve, 4> curves = {{
-        {"resistance", &record->resistance, {}},
-        {"conductance", &record->conductance, {}},
-        {"darcyResistance", &record->darcyResistance, {}},
-        {"conductanceDerivative", &record->conductanceDerivative, {}},
+        {&record->resistance, {}},
+        {&record->conductance, {}},
+        {&record->darcyResistance, {}},
+        {&record->conductanceDerivative, {}},
     }};
     for (auto& c : curves) c.stored = *c.field;
 
     computeDerivedCurves(*record);
 
+    // The binary codec is lossless, so this comparison means the same thing
+    // for both formats: a mismatch is a formula change, never codec noise.
     auto curvesMatch = [](const QVector<QPointF>& a, const QVector<QPointF>& b) {
         if (a.size() != b.size()) return false;
         constexpr double kEpsilon = 1e-6;
@@ -2265,11 +2511,14 @@ void ShotHistoryStorage::decompressSampleData(const QByteArray& blob, ShotRecord
     for (const auto& c : curves) {
         if (!curvesMatch(c.stored, *c.field)) { curvesChanged = true; break; }
     }
+    if (outCurvesChanged) *outCurvesChanged = curvesChanged;
 
-    if (curvesChanged && outCorrectedBlob) {
-        for (const auto& c : curves) root[c.jsonKey] = pointsToJsonObject(*c.field);
-        *outCorrectedBlob = qCompress(QJsonDocument(root).toJson(QJsonDocument::Compact), 9);
-    }
+    // A legacy JSON blob is re-encoded even when its curves were right: this
+    // is the lazy half of the format migration, so a shot pays the JSON parse
+    // at most once after the upgrade.
+    if ((curvesChanged || format == ShotSampleBlob::Format::LegacyJson) && outCorrectedBlob)
+        *outCorrectedBlob = ShotSampleBlob::encodeRecord(*record);
+    return true;
 }
 
 qint64 ShotHistoryStorage::saveShot(ShotDataModel* shotData,
@@ -2289,6 +2538,13 @@ qint64 ShotHistoryStorage::saveShot(ShotDataModel* shotData,
         return -1;
     }
 
+    // Main-thread cost of a save, reported with the "Saved shot" line. It
+    // lands at shot end, while the post-shot review animates in, so it should
+    // stay a handoff: field copies, the dC/dt pass the model itself needs,
+    // and a buffer snapshot. Analysis and encoding happen on the worker.
+    QElapsedTimer handoffTimer;
+    handoffTimer.start();
+
     // Extract all data from QObject pointers on the main thread into a plain value struct
     ShotSaveData data;
     data.uuid = QUuid::createUuid().toString(QUuid::WithoutBraces);
@@ -2339,68 +2595,14 @@ qint64 ShotHistoryStorage::saveShot(ShotDataModel* shotData,
         data.profileKbId = resolveProfileKb(*profile).persistableId();
     }
 
-    // Compute conductance derivative (post-shot Gaussian smoothing) before compression
+    // Compute conductance derivative (post-shot Gaussian smoothing) before the
+    // snapshot: the model keeps it for the post-shot graph and the upload.
     shotData->computeConductanceDerivative();
 
-    // Compute quality flags and phase summaries. Uses ShotSummarizer::getAnalysisFlags()
-    // for KB flag lookups and ShotAnalysis helpers for detection. Runs on the main
-    // thread before data is handed to the background save thread.
-    // Build a temporary ShotRecord from the live data to reuse the static helpers.
-    {
-        ShotRecord tmpRecord;
-        tmpRecord.pressure = shotData->pressureData();
-        tmpRecord.flow = shotData->flowData();
-        tmpRecord.temperature = shotData->temperatureData();
-        tmpRecord.weight = shotData->cumulativeWeightData();
-
-        // Extract phase markers into the record
-        QVariantList tmpMarkers = shotData->phaseMarkersVariant();
-        for (const QVariant& mv : tmpMarkers) {
-            QVariantMap m = mv.toMap();
-            HistoryPhaseMarker pm;
-            pm.time = m["time"].toDouble();
-            pm.label = m["label"].toString();
-            pm.frameNumber = m["frameNumber"].toInt();
-            pm.isFlowMode = m["isFlowMode"].toBool();
-            pm.transitionReason = m["transitionReason"].toString();
-            tmpRecord.phases.append(pm);
-        }
-
-        // Compute phase summaries
-        computePhaseSummaries(tmpRecord);
-        data.phaseSummariesJson = tmpRecord.phaseSummariesJson;
-
-        // Compute all four quality badges via a single ShotAnalysis::analyzeShot
-        // pass and project the booleans from DetectorResults using the
-        // documented mapping. This unifies the save-time, load-time, and
-        // dialog/AI/MCP cascades on one pipeline — the cascade lives in exactly
-        // one place (analyzeShot's body). See docs/SHOT_REVIEW.md §4 for the
-        // full mapping table and decenza::deriveBadgesFromAnalysis (in
-        // history/shotbadgeprojection.h) for the projection rules.
-        const AnalysisInputs inputs = prepareAnalysisInputs(data.profileKbId, data.profileJson);
-        // Read the gate off AnalysisInputs rather than deriving it from the
-        // persisted id. The id is empty for a profile that resolved by SHAPE
-        // (change: resolve-profile-kb-by-shape) — a re-tuned copy of a
-        // documented profile, for which Arm 1's structural question is
-        // answerable. Deriving from the id would gate Arm 1 off for exactly
-        // the profiles this change exists to serve.
-        const bool profileKbResolved = inputs.profileKbResolved;
-        const auto analysis = ShotAnalysis::analyzeShot(
-            tmpRecord.pressure, shotData->flowData(),
-            shotData->cumulativeWeightData(),
-            shotData->conductanceDerivativeData(),
-            tmpRecord.phases, data.beverageType, duration,
-            shotData->pressureGoalData(), shotData->flowGoalData(),
-            inputs.analysisFlags, inputs.firstFrameSeconds,
-            data.targetWeight, data.finalWeight,
-            inputs.frameCount, inputs.expertBand,
-            profileKbResolved);
-        decenza::applyBadgesToTarget(data, analysis.detectors);
-    }
-
-    // Compress sample data on main thread (reads QObject data vectors)
-    data.compressedSamples = compressSampleData(shotData, data.phaseSummariesJson);
-    data.sampleCount = static_cast<int>(shotData->pressureData().size());
+    // The shot's samples from here on: an O(1) implicitly shared snapshot of
+    // the model's buffer, not a copy of it. The model is free to clear() and
+    // record the next shot while the worker still reads this one.
+    ShotSampleBuffer samples = shotData->samples();
 
     // Extract phase markers on main thread
     QVariantList markers = shotData->phaseMarkersVariant();
@@ -2415,10 +2617,21 @@ qint64 ShotHistoryStorage::saveShot(ShotDataModel* shotData,
         data.phaseMarkers.append(pm);
     }
 
+    // Everything from here — analysis, encode, compress, INSERT — runs on the
+    // worker. The main thread's share ends at the handoff below.
+    const qint64 handoffMs = handoffTimer.elapsed();
+
     // Run DB work on background thread
     const QString dbPath = m_dbPath;
     auto destroyed = m_destroyed;
-    runOnDbThread([this, dbPath, data = std::move(data), destroyed]() {
+    runOnDbThread([this, dbPath, data = std::move(data), samples = std::move(samples),
+                   handoffMs, destroyed]() mutable {
+        QElapsedTimer encodeTimer;
+        encodeTimer.start();
+        encodeShotSamples(data, samples);
+        const qint64 encodeMs = encodeTimer.elapsed();
+        samples = ShotSampleBuffer();  // drop the snapshot before the INSERT
+
         qint64 shotId = saveShotStatic(dbPath, data);
 
         // Capture only the fields needed for logging (avoid copying the large compressedSamples blob)
@@ -2429,7 +2642,8 @@ qint64 ShotHistoryStorage::saveShot(ShotDataModel* shotData,
 
         if (*destroyed) return;
         QMetaObject::invokeMethod(this, [this, shotId, destroyed,
-                                         profileName, shotDuration, sampleCount, compressedSize]() {
+                                         profileName, shotDuration, sampleCount, compressedSize,
+                                         handoffMs, encodeMs]() {
             if (*destroyed) {
                 qDebug() << "ShotHistoryStorage: saveShot callback dropped (object destroyed)";
                 return;
@@ -2443,7 +2657,9 @@ qint64 ShotHistoryStorage::saveShot(ShotDataModel* shotData,
                          << "- Profile:" << profileName
                          << "- Duration:" << shotDuration << "s"
                          << "- Samples:" << sampleCount
-                         << "- Compressed size:" << compressedSize << "bytes";
+                         << "- Compressed size:" << compressedSize << "bytes"
+                         << "- Main thread:" << handoffMs << "ms"
+                         << "- Encode (worker):" << encodeMs << "ms";
             } else {
                 emit errorOccurred("Failed to save shot to database");
             }
@@ -2487,16 +2703,27 @@ qint64 ShotHistoryStorage::saveShotStatic(const QString& dbPath, const ShotSaveD
                 return false;
             }
 
+            // The profile row goes first so the shot can name it by hash. It
+            // joins this transaction, so a rollback below leaves no orphan.
+            QSqlError profileError;
+            const std::optional<QString> profileHash =
+                storeProfileJsonStatic(db, data.profileJson, &profileError);
+            if (!profileHash) {
+                locked = isSqliteLockError(profileError);
+                QSqlQuery(db).exec(QStringLiteral("ROLLBACK"));
+                return false;
+            }
+
             QSqlQuery query(db);
             query.prepare(R"(
                 INSERT INTO shots (
-                    uuid, timestamp, profile_name, profile_json, beverage_type,
+                    uuid, timestamp, profile_name, profile_hash, beverage_type,
                     duration_seconds, final_weight, dose_weight,
                     bean_brand, bean_type, roast_date, roast_level,
                     grinder_setting,
                     equipment_id, rpm,
                     drink_tds, drink_ey, enjoyment, espresso_notes, bean_notes, barista,
-                    profile_notes, debug_log,
+                    profile_notes,
                     temperature_override, yield_override, yield_mode, yield_anchor_value,
                     profile_kb_id,
                     channeling_detected, grind_issue_detected,
@@ -2505,13 +2732,13 @@ qint64 ShotHistoryStorage::saveShotStatic(const QString& dbPath, const ShotSaveD
                     bag_id, frozen_date, defrost_date, storage_hint, opened_date,
                     recipe_id, steam_json, hot_water_json
                 ) VALUES (
-                    :uuid, :timestamp, :profile_name, :profile_json, :beverage_type,
+                    :uuid, :timestamp, :profile_name, :profile_hash, :beverage_type,
                     :duration, :final_weight, :dose_weight,
                     :bean_brand, :bean_type, :roast_date, :roast_level,
                     :grinder_setting,
                     :equipment_id, :rpm,
                     :drink_tds, :drink_ey, :enjoyment, :espresso_notes, :bean_notes, :barista,
-                    :profile_notes, :debug_log,
+                    :profile_notes,
                     :temperature_override, :yield_override, :yield_mode, :yield_anchor_value,
                     :profile_kb_id,
                     :channeling_detected, :grind_issue_detected,
@@ -2525,7 +2752,7 @@ qint64 ShotHistoryStorage::saveShotStatic(const QString& dbPath, const ShotSaveD
             query.bindValue(":uuid", data.uuid);
             query.bindValue(":timestamp", data.timestamp);
             query.bindValue(":profile_name", data.profileName);
-            query.bindValue(":profile_json", data.profileJson);
+            query.bindValue(":profile_hash", profileHash->isEmpty() ? QVariant() : *profileHash);
             query.bindValue(":beverage_type", data.beverageType);
             query.bindValue(":duration", data.duration);
             query.bindValue(":final_weight", data.finalWeight);
@@ -2547,7 +2774,6 @@ qint64 ShotHistoryStorage::saveShotStatic(const QString& dbPath, const ShotSaveD
             query.bindValue(":bean_notes", QString());
             query.bindValue(":barista", data.barista);
             query.bindValue(":profile_notes", data.profileNotes);
-            query.bindValue(":debug_log", data.debugLog);
             query.bindValue(":temperature_override", data.temperatureOverride);
             query.bindValue(":yield_override", data.targetWeight);
             // The anchor that produced the target (intent) rides alongside the
@@ -2589,7 +2815,18 @@ qint64 ShotHistoryStorage::saveShotStatic(const QString& dbPath, const ShotSaveD
 
             shotId = query.lastInsertId().toLongLong();
 
-            // Insert compressed sample data
+            QSqlError logError;
+            if (!storeDebugLogStatic(db, shotId, data.debugLog, &logError)) {
+                locked = isSqliteLockError(logError);
+                QSqlQuery(db).exec(QStringLiteral("ROLLBACK"));
+                shotId = -1;
+                return false;
+            }
+
+            // Insert compressed sample data. Left at derived_version 0: the
+            // derived curves here were accumulated live by ShotDataModel, not
+            // by computeDerivedCurves, so the first full load (or the idle
+            // sweep) verifies them before they are trusted.
             query.prepare("INSERT INTO shot_samples (shot_id, sample_count, data_blob) VALUES (:id, :count, :blob)");
             query.bindValue(":id", shotId);
             query.bindValue(":count", data.sampleCount);
@@ -2603,19 +2840,22 @@ qint64 ShotHistoryStorage::saveShotStatic(const QString& dbPath, const ShotSaveD
                 return false;
             }
 
-            // Insert phase markers
-            for (const HistoryPhaseMarker& pm : data.phaseMarkers) {
-                query.prepare(R"(
-                    INSERT INTO shot_phases (shot_id, time_offset, label, frame_number, is_flow_mode, transition_reason)
-                    VALUES (:shot_id, :time, :label, :frame, :flow_mode, :reason)
-                )");
-                query.bindValue(":shot_id", shotId);
-                query.bindValue(":time", pm.time);
-                query.bindValue(":label", pm.label);
-                query.bindValue(":frame", pm.frameNumber);
-                query.bindValue(":flow_mode", pm.isFlowMode ? 1 : 0);
-                query.bindValue(":reason", pm.transitionReason);
-                query.exec();  // Non-critical if markers fail
+            // Insert phase markers — prepared once for the whole loop (and kept
+            // prepared across saves on the storage worker's pooled connection).
+            {
+                PreparedQuery insertPhase(db, QStringLiteral(
+                    "INSERT INTO shot_phases (shot_id, time_offset, label, frame_number, is_flow_mode, transition_reason) "
+                    "VALUES (?, ?, ?, ?, ?, ?)"));
+                for (const HistoryPhaseMarker& pm : data.phaseMarkers) {
+                    if (!insertPhase.ok()) break;
+                    insertPhase->bindValue(0, shotId);
+                    insertPhase->bindValue(1, pm.time);
+                    insertPhase->bindValue(2, pm.label);
+                    insertPhase->bindValue(3, pm.frameNumber);
+                    insertPhase->bindValue(4, pm.isFlowMode ? 1 : 0);
+                    insertPhase->bindValue(5, pm.transitionReason);
+                    insertPhase->exec();  // Non-critical if markers fail
+                }
             }
 
             // COMMIT. On a transient lock SQLite keeps the transaction staged, so
@@ -3159,6 +3399,267 @@ void ShotHistoryStorage::requestReanalyzeBadges(qint64 shotId)
     });
 }
 
+namespace {
+
+// Small enough that a shot the user opens mid-job waits behind at most one
+// short write transaction, large enough to keep every Maintenance worker busy.
+constexpr int kReanalysisBatchSize = 32;
+
+// A shot is stale when its curves are unstamped or its stored analysis is
+// missing or was written by other code. ? = before_id, derived version,
+// fingerprint; the SELECT variant appends ORDER BY and LIMIT.
+constexpr char kStaleShotsWhere[] =
+    " FROM shots s"
+    " JOIN shot_samples ss ON ss.shot_id = s.id"
+    " LEFT JOIN shot_analysis a ON a.shot_id = s.id"
+    " WHERE s.id < ? AND (ss.derived_version <> ?"
+    "   OR a.fingerprint IS NULL OR a.fingerprint <> ?)";
+
+} // namespace
+
+void ShotHistoryStorage::requestHistoryReanalysis()
+{
+    if (!m_ready || m_reanalysis.running) return;
+    m_reanalysis = Reanalysis();
+    m_reanalysis.running = true;
+    m_reanalysis.cancel = CancellationToken::create();
+
+    // Resume from the checkpoint when it was written under the current
+    // fingerprint; one from an older algorithm describes work that has to be
+    // redone anyway.
+    const QString dbPath = m_dbPath;
+    auto destroyed = m_destroyed;
+    runOnDbThread([this, dbPath, destroyed]() {
+        if (*destroyed) return;
+        qint64 beforeId = std::numeric_limits<qint64>::max();
+        int done = 0;
+        int remaining = 0;
+        withTempDb(dbPath, "shs_reanalysis_start", [&](QSqlDatabase& db) {
+            {
+                PreparedQuery checkpoint(db, QStringLiteral(
+                    "SELECT before_id, done FROM shot_reanalysis_checkpoint WHERE fingerprint = ?"));
+                if (checkpoint.ok()) {
+                    checkpoint->bindValue(0, ShotAnalysisCache::kFingerprint);
+                    if (checkpoint->exec() && checkpoint->next()) {
+                        beforeId = checkpoint->value(0).toLongLong();
+                        done = checkpoint->value(1).toInt();
+                    }
+                }
+            }
+            PreparedQuery count(db, QStringLiteral("SELECT COUNT(*)") + QLatin1String(kStaleShotsWhere));
+            if (!count.ok()) return;
+            count->bindValue(0, beforeId);
+            count->bindValue(1, Conductance::kAlgorithmVersion);
+            count->bindValue(2, ShotAnalysisCache::kFingerprint);
+            if (count->exec() && count->next())
+                remaining = count->value(0).toInt();
+        });
+
+        if (*destroyed) return;
+        QMetaObject::invokeMethod(this, [this, beforeId, done, remaining, destroyed]() {
+            if (*destroyed) return;
+            m_reanalysis.beforeId = beforeId;
+            m_reanalysis.done = done;
+            m_reanalysis.total = done + remaining;
+            if (done > 0)
+                qDebug() << "ShotHistoryStorage: history re-analysis resuming at" << done
+                         << "of" << m_reanalysis.total;
+            emit historyReanalysisProgress(m_reanalysis.done, m_reanalysis.total);
+            selectReanalysisBatch();
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ShotHistoryStorage::cancelHistoryReanalysis()
+{
+    if (m_reanalysis.running) m_reanalysis.cancel.cancel();
+}
+
+QJsonObject ShotHistoryStorage::historyReanalysisStatus() const
+{
+    QString state = QStringLiteral("idle");
+    if (m_reanalysis.running)
+        state = m_reanalysis.cancel.isCancelled() ? QStringLiteral("cancelling") : QStringLiteral("running");
+    return QJsonObject{
+        {"state", state},
+        {"done", m_reanalysis.done},
+        {"total", m_reanalysis.total},
+        {"badgesChanged", m_reanalysis.badgesChanged},
+        {"lastResult", m_reanalysis.lastResult},
+    };
+}
+
+void ShotHistoryStorage::selectReanalysisBatch()
+{
+    if (m_reanalysis.cancel.isCancelled()) {
+        finishHistoryReanalysis(QStringLiteral("cancelled"));
+        return;
+    }
+
+    const QString dbPath = m_dbPath;
+    const qint64 beforeId = m_reanalysis.beforeId;
+    auto destroyed = m_destroyed;
+    runOnDbThread([this, dbPath, beforeId, destroyed]() {
+        if (*destroyed) return;
+        QList<qint64> ids;
+        bool ok = false;
+        withTempDb(dbPath, "shs_reanalysis_select", [&](QSqlDatabase& db) {
+            PreparedQuery stale(db, QStringLiteral("SELECT s.id") + QLatin1String(kStaleShotsWhere)
+                                    + QStringLiteral(" ORDER BY s.id DESC LIMIT ?"));
+            if (!stale.ok()) return;
+            stale->bindValue(0, beforeId);
+            stale->bindValue(1, Conductance::kAlgorithmVersion);
+            stale->bindValue(2, ShotAnalysisCache::kFingerprint);
+            stale->bindValue(3, kReanalysisBatchSize);
+            if (!stale->exec()) {
+                qWarning() << "ShotHistoryStorage: history re-analysis query failed:"
+                           << stale->lastError().text();
+                return;
+            }
+            while (stale->next())
+                ids.append(stale->value(0).toLongLong());
+            ok = true;
+        });
+
+        if (*destroyed) return;
+        QMetaObject::invokeMethod(this, [this, ids, ok, destroyed]() {
+            if (*destroyed) return;
+            if (!ok) finishHistoryReanalysis(QStringLiteral("failed"));
+            else if (ids.isEmpty()) finishHistoryReanalysis(QStringLiteral("completed"));
+            else analyseReanalysisBatch(ids);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ShotHistoryStorage::analyseReanalysisBatch(const QList<qint64>& ids)
+{
+    // One pool task per shot. Each reads on its worker's own pooled connection
+    // — WAL readers never wait on each other or on the writer — and the last
+    // one to finish hands the batch, in id order, to the commit stage. A
+    // std::vector because every task writes its own slot concurrently, and
+    // QList's non-const operator[] would check for a detach on each.
+    //
+    // Nothing loads the profile KB before the fan-out: the first
+    // readShotRecordStatic to need it loads it under ShotSummarizer's lock,
+    // and the atomic s_knowledgeLoaded publishes it to the other workers.
+    struct Batch {
+        std::vector<ShotRecordRefresh> refreshes;
+        std::atomic<int> pending;
+        explicit Batch(qsizetype n) : refreshes(size_t(n)), pending(int(n)) {}
+    };
+    auto batch = std::make_shared<Batch>(ids.size());
+    const qint64 nextBeforeId = ids.last();
+    const QString dbPath = m_dbPath;
+    const CancellationToken cancel = m_reanalysis.cancel;
+    auto destroyed = m_destroyed;
+
+    for (qsizetype i = 0; i < ids.size(); ++i) {
+        const qint64 shotId = ids[i];
+        // The token is checked here rather than handed to the executor: a task
+        // the executor drops never counts down, and the batch would never end.
+        runDetachedDbThread([this, dbPath, shotId, i, batch, nextBeforeId, cancel, destroyed]() {
+            if (!*destroyed && !cancel.isCancelled()) {
+                withTempDb(dbPath, "shs_reanalysis_read", [&](QSqlDatabase& db) {
+                    readShotRecordStatic(db, shotId, &batch->refreshes[size_t(i)]);
+                });
+            }
+            if (batch->pending.fetch_sub(1, std::memory_order_acq_rel) != 1 || *destroyed) return;
+            QMetaObject::invokeMethod(this, [this, batch, nextBeforeId, destroyed]() {
+                if (*destroyed) return;
+                if (m_reanalysis.cancel.isCancelled()) {
+                    finishHistoryReanalysis(QStringLiteral("cancelled"));
+                    return;
+                }
+                commitReanalysisBatch(QList<ShotRecordRefresh>(
+                    std::make_move_iterator(batch->refreshes.begin()),
+                    std::make_move_iterator(batch->refreshes.end())), nextBeforeId);
+            }, Qt::QueuedConnection);
+        }, TaskLane::Maintenance);
+    }
+}
+
+void ShotHistoryStorage::commitReanalysisBatch(const QList<ShotRecordRefresh>& refreshes,
+                                               qint64 nextBeforeId)
+{
+    const QString dbPath = m_dbPath;
+    const int doneAfter = m_reanalysis.done + int(refreshes.size());
+    auto destroyed = m_destroyed;
+    runOnDbThread([this, dbPath, refreshes, nextBeforeId, doneAfter, destroyed]() {
+        if (*destroyed) return;
+        bool committed = false;
+        withTempDb(dbPath, "shs_reanalysis_write", [&](QSqlDatabase& db) {
+            DbWriteTxn txn = DbWriteTxn::begin(db, "history reanalysis");
+            if (!txn.ok()) return;
+            for (const ShotRecordRefresh& refresh : refreshes) {
+                if (!refresh.isEmpty() && !applyShotRecordRefreshStatic(db, refresh)) return;
+            }
+            PreparedQuery checkpoint(db, QStringLiteral(
+                "INSERT OR REPLACE INTO shot_reanalysis_checkpoint (id, fingerprint, before_id, done)"
+                " VALUES (1, ?, ?, ?)"));
+            if (!checkpoint.ok()) return;
+            checkpoint->bindValue(0, ShotAnalysisCache::kFingerprint);
+            checkpoint->bindValue(1, nextBeforeId);
+            checkpoint->bindValue(2, doneAfter);
+            if (!checkpoint->exec()) {
+                qWarning() << "ShotHistoryStorage: re-analysis checkpoint failed:"
+                           << checkpoint->lastError().text();
+                return;
+            }
+            committed = txn.commit();
+            if (!committed)
+                qWarning() << "ShotHistoryStorage: re-analysis batch commit failed:" << txn.commitError();
+        });
+
+        if (*destroyed) return;
+        QMetaObject::invokeMethod(this, [this, refreshes, committed, nextBeforeId, doneAfter, destroyed]() {
+            if (*destroyed) return;
+            if (!committed) {
+                finishHistoryReanalysis(QStringLiteral("failed"));
+                return;
+            }
+            m_reanalysis.beforeId = nextBeforeId;
+            m_reanalysis.done = doneAfter;
+            m_reanalysis.total = qMax(m_reanalysis.total, doneAfter);
+            m_reanalysis.written += int(refreshes.size());
+            for (const ShotRecordRefresh& r : refreshes) {
+                if (!r.badgesChanged) continue;
+                ++m_reanalysis.badgesChanged;
+                emit shotBadgesUpdated(r.shotId, r.channelingDetected, r.grindIssueDetected,
+                                       r.skipFirstFrameDetected, r.pourTruncatedDetected);
+            }
+            emit historyReanalysisProgress(m_reanalysis.done, m_reanalysis.total);
+            selectReanalysisBatch();
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ShotHistoryStorage::finishHistoryReanalysis(const QString& result)
+{
+    const bool completed = result == QLatin1String("completed");
+    m_reanalysis.running = false;
+    m_reanalysis.lastResult = result;
+    if (m_reanalysis.written > 0 || !completed) {
+        qDebug() << "ShotHistoryStorage: history re-analysis" << result << "after"
+                 << m_reanalysis.written << "shots," << m_reanalysis.badgesChanged << "badge changes";
+    }
+
+    // A finished job leaves no checkpoint, so the next one starts from the
+    // top and picks up shots saved or imported above this run's cursor. A
+    // cancelled or failed one keeps it, to resume from.
+    if (completed) {
+        const QString dbPath = m_dbPath;
+        runOnDbThread([dbPath]() {
+            withTempDb(dbPath, "shs_reanalysis_done", [](QSqlDatabase& db) {
+                QSqlQuery clear(db);
+                if (!clear.exec(QStringLiteral("DELETE FROM shot_reanalysis_checkpoint")))
+                    qWarning() << "ShotHistoryStorage: re-analysis checkpoint clear failed:"
+                               << clear.lastError().text();
+            });
+        });
+    }
+    emit historyReanalysisFinished(completed, m_reanalysis.written);
+}
+
 void ShotHistoryStorage::computeDerivedCurves(ShotRecord& record)
 {
     const qsizetype n = qMin(record.pressure.size(), record.flow.size());
@@ -3169,21 +3670,31 @@ void ShotHistoryStorage::computeDerivedCurves(ShotRecord& record)
     // drift apart. Conductance (+ its derivative) is additionally shared with
     // tools/shot_eval (offline); shot_eval doesn't compute resistance or Darcy
     // resistance, so that three-way agreement doesn't extend to those two.
-    record.conductance = Conductance::fromPressureFlow(record.pressure, record.flow);
-
-    record.resistance.clear();
-    record.resistance.reserve(n);
-    record.darcyResistance.clear();
-    record.darcyResistance.reserve(n);
+    //
+    // The curves are split into columns once and every output is one batch
+    // kernel over them, rather than four per-sample passes over QPointF.
+    QVector<double> times(n), pressure(n), flow(n);
     for (qsizetype i = 0; i < n; ++i) {
-        const double p = record.pressure[i].y();
-        const double f = record.flow[i].y();
-        record.resistance.append(QPointF(record.pressure[i].x(), Conductance::resistance(p, f)));
-        record.darcyResistance.append(
-            QPointF(record.pressure[i].x(), Conductance::darcyResistanceSample(p, f)));
+        times[i] = record.pressure[i].x();
+        pressure[i] = record.pressure[i].y();
+        flow[i] = record.flow[i].y();
     }
-
-    record.conductanceDerivative = Conductance::derivative(record.conductance);
+    QVector<double> conductance(n), resistance(n), darcy(n), derivative(n);
+    Conductance::sampleBatch(pressure.constData(), flow.constData(), conductance.data(), n);
+    Conductance::resistanceBatch(pressure.constData(), flow.constData(), resistance.data(), n);
+    Conductance::darcyResistanceBatch(pressure.constData(), flow.constData(), darcy.data(), n);
+    Conductance::derivativeBatch(times.constData(), conductance.constData(), derivative.data(), n);
+
+    auto toPoints = [&times, n](const QVector<double>& values) {
+        QVector<QPointF> points(n);
+        for (qsizetype i = 0; i < n; ++i)
+            points[i] = QPointF(times[i], values[i]);
+        return points;
+    };
+    record.conductance = toPoints(conductance);
+    record.resistance = toPoints(resistance);
+    record.darcyResistance = toPoints(darcy);
+    record.conductanceDerivative = toPoints(derivative);
 }
 
 void ShotHistoryStorage::computePhaseSummaries(ShotRecord& record)
@@ -3258,12 +3769,107 @@ void ShotHistoryStorage::computePhaseSummaries(ShotRecord& record)
 }
 
 ShotRecord ShotHistoryStorage::loadShotRecordStatic(QSqlDatabase& db, qint64 shotId,
-                                                     bool* outBadgesPersisted)
+                                                     bool* outBadgesPersisted,
+                                                     ShotSampleBlob::SeriesMask series)
 {
     if (outBadgesPersisted) *outBadgesPersisted = false;
+
+    ShotRecordRefresh refresh;
+    ShotRecord record = readShotRecordStatic(db, shotId, &refresh, series);
+    if (refresh.isEmpty()) return record;
+
+    // Everything the read found stale lands together or not at all. That
+    // matters most for the self-heal: a corrected blob with a stale updated_at
+    // would permanently hide the correction from
+    // ShotHistoryExporter::exportedFileIsFresh(), which decides purely by
+    // comparing an export's mtime against that column, and nothing ever
+    // retries a write that already "succeeded" on the blob half. A failure
+    // leaves the rows as they were, and the next load finds the same work.
+    DbWriteTxn txn = DbWriteTxn::begin(db, "load refresh");
+    if (!txn.ok() || !applyShotRecordRefreshStatic(db, refresh)) return record;
+    if (!txn.commit()) {
+        qWarning() << "ShotHistoryStorage::loadShotRecordStatic: refresh commit failed for shot"
+                   << shotId << txn.commitError();
+        return record;
+    }
+    if (outBadgesPersisted) *outBadgesPersisted = refresh.badgesChanged;
+    return record;
+}
+
+bool ShotHistoryStorage::applyShotRecordRefreshStatic(QSqlDatabase& db,
+                                                      const ShotRecordRefresh& refresh)
+{
+    const qint64 shotId = refresh.shotId;
+    auto run = [shotId](PreparedQuery& query, const char* what) {
+        if (query.ok() && query->exec()) return true;
+        qWarning() << "ShotHistoryStorage: refresh" << what << "failed for shot" << shotId
+                   << query->lastError().text();
+        return false;
+    };
+
+    if (!refresh.correctedBlob.isEmpty()) {
+        PreparedQuery curveUpd(db, QStringLiteral(
+            "UPDATE shot_samples SET data_blob = ?, derived_version = ? WHERE shot_id = ?"));
+        if (curveUpd.ok()) {
+            curveUpd->bindValue(0, refresh.correctedBlob);
+            curveUpd->bindValue(1, Conductance::kAlgorithmVersion);
+            curveUpd->bindValue(2, shotId);
+        }
+        if (!run(curveUpd, "curve self-heal")) return false;
+    } else if (refresh.stampDerived) {
+        PreparedQuery stampUpd(db, QStringLiteral(
+            "UPDATE shot_samples SET derived_version = ? WHERE shot_id = ?"));
+        if (stampUpd.ok()) {
+            stampUpd->bindValue(0, Conductance::kAlgorithmVersion);
+            stampUpd->bindValue(1, shotId);
+        }
+        if (!run(stampUpd, "derived-curve stamp")) return false;
+    }
+
+    if (!refresh.analysisKey.isEmpty() && refresh.analysis
+        && !ShotAnalysisCache::store(db, shotId, refresh.analysisKey,
+                                     {*refresh.analysis, refresh.kbDerivedFrom})) {
+        return false;
+    }
+
+    // Both a curve change and a badge change bump updated_at, so consumers
+    // keyed on it (ShotHistoryExporter's exportedFileIsFresh()) re-derive
+    // their own cached output. A format-only upgrade (legacy JSON to binary,
+    // same values) changes nothing an export contains, so it doesn't touch
+    // the column: opening old shots must not invalidate every export one by
+    // one.
+    if (refresh.badgesChanged) {
+        PreparedQuery badgeUpd(db, QStringLiteral(
+            "UPDATE shots SET channeling_detected = ?, grind_issue_detected = ?,"
+            " skip_first_frame_detected = ?, pour_truncated_detected = ?,"
+            " updated_at = strftime('%s', 'now') WHERE id = ?"));
+        if (badgeUpd.ok()) {
+            badgeUpd->bindValue(0, refresh.channelingDetected ? 1 : 0);
+            badgeUpd->bindValue(1, refresh.grindIssueDetected ? 1 : 0);
+            badgeUpd->bindValue(2, refresh.skipFirstFrameDetected ? 1 : 0);
+            badgeUpd->bindValue(3, refresh.pourTruncatedDetected ? 1 : 0);
+            badgeUpd->bindValue(4, shotId);
+        }
+        if (!run(badgeUpd, "badge persist")) return false;
+    } else if (!refresh.correctedBlob.isEmpty() && refresh.curvesChanged) {
+        PreparedQuery touchUpd(db, QStringLiteral(
+            "UPDATE shots SET updated_at = strftime('%s', 'now') WHERE id = ?"));
+        if (touchUpd.ok()) touchUpd->bindValue(0, shotId);
+        if (!run(touchUpd, "updated_at touch")) return false;
+    }
+    return true;
+}
+
+ShotRecord ShotHistoryStorage::readShotRecordStatic(QSqlDatabase& db, qint64 shotId,
+                                                     ShotRecordRefresh* outRefresh,
+                                                     ShotSampleBlob::SeriesMask series)
+{
+    ShotRecordRefresh discarded;
+    ShotRecordRefresh& refresh = outRefresh ? *outRefresh : discarded;
+    refresh = ShotRecordRefresh();
+    refresh.shotId = shotId;
     ShotRecord record;
 
-    QSqlQuery query(db);
     // Grinder identity (brand/model/burrs) is resolved by following the shot's
     // equipment_id pointer to its package's grinder item, not from per-shot
     // snapshot columns (add-equipment-packages task 4.1). The legacy
@@ -3272,13 +3878,16 @@ ShotRecord ShotHistoryStorage::loadShotRecordStatic(QSqlDatabase& db, qint64 sho
     // in the item's attrs JSON blob (json_extract). A NULL equipment_id (shot
     // with no grinder identity) LEFT-JOINs to NULLs — same empty strings the old
     // columns held.
-    if (!query.prepare(R"(
-        SELECT s.id, s.uuid, s.timestamp, s.profile_name, s.profile_json,
+    //
+    // All three SELECTs here are PreparedQuery: opening a shot is the commonest
+    // task on the storage worker, so its pooled connection keeps them prepared.
+    PreparedQuery shotQuery(db, QStringLiteral(R"(
+        SELECT s.id, s.uuid, s.timestamp, s.profile_name, sp.profile_json,
                s.duration_seconds, s.final_weight, s.dose_weight,
                s.bean_brand, s.bean_type, s.roast_date, s.roast_level,
                eg.brand, eg.model, json_extract(eg.attrs, '$.burrs'), s.grinder_setting,
                s.drink_tds, s.drink_ey, s.enjoyment, s.espresso_notes, s.bean_notes, s.barista,
-               s.profile_notes, s.visualizer_id, s.visualizer_url, s.debug_log,
+               s.profile_notes, s.visualizer_id, s.visualizer_url, dl.debug_log,
                s.temperature_override, s.yield_override, s.beverage_type, s.profile_kb_id,
                s.channeling_detected, s.grind_issue_detected,
                s.skip_first_frame_detected, s.pour_truncated_detected,
@@ -3297,11 +3906,15 @@ ShotRecord ShotHistoryStorage::loadShotRecordStatic(QSqlDatabase& db, qint64 sho
         LEFT JOIN equipment_items eb ON eb.package_id = s.equipment_id AND eb.kind = 'basket'
         LEFT JOIN equipment_items epp ON epp.package_id = s.equipment_id AND epp.kind = 'puckprep'
         LEFT JOIN equipment_packages ep ON ep.id = s.equipment_id
+        LEFT JOIN shot_profiles sp ON sp.hash = s.profile_hash
+        LEFT JOIN shot_debug_logs dl ON dl.shot_id = s.id
         WHERE s.id = ?
-    )")) {
-        qWarning() << "ShotHistoryStorage::loadShotRecordStatic: prepare failed:" << query.lastError().text();
+    )"));
+    if (!shotQuery.ok()) {
+        qWarning() << "ShotHistoryStorage::loadShotRecordStatic: prepare failed:" << shotQuery->lastError().text();
         return record;
     }
+    QSqlQuery& query = *shotQuery;
     query.bindValue(0, shotId);
 
     if (!query.exec() || !query.next()) {
@@ -3402,90 +4015,85 @@ ShotRecord ShotHistoryStorage::loadShotRecordStatic(QSqlDatabase& db, qint64 sho
         record.yieldAnchorValue = record.targetWeight;
     }
     record.summary.hasVisualizerUpload = !record.visualizerId.isEmpty();
+    // The row is read; release the statement before the caller's writes (the
+    // blob SELECT's finish() further down explains why an active one breaks
+    // them).
+    query.finish();
 
     // Snapshot stored badge values before the recompute block overwrites them, so
-    // we can detect drift and persist the corrected flags below.
+    // we can detect drift and report the corrected flags below.
     const bool storedChanneling = record.channelingDetected;
     const bool storedGrindIssue = record.grindIssueDetected;
     const bool storedSkipFirstFrame = record.skipFirstFrameDetected;
     const bool storedPourTruncated = record.pourTruncatedDetected;
 
-    // decompressSampleData() unconditionally recomputes resistance/conductance/
-    // darcyResistance/conductanceDerivative from this shot's own pressure/flow
-    // (recompute-shot-curves-on-load) — so conductanceDerivative is populated
-    // for the badge-recompute block below whenever the shot has enough samples
-    // for computeDerivedCurves() to run (its own >=3-sample guard applies here
-    // too). When the recompute disagrees with what was stored, correctedBlob
-    // comes back non-empty and we persist it below on the same connection.
-    QByteArray correctedBlob;
-    if (query.prepare("SELECT data_blob FROM shot_samples WHERE shot_id = ?")) {
-        query.bindValue(0, shotId);
-        if (query.exec() && query.next()) {
-            QByteArray blob = query.value(0).toByteArray();
-            decompressSampleData(blob, &record, &correctedBlob);
+    // decompressSampleData() recomputes resistance/conductance/darcyResistance/
+    // conductanceDerivative from this shot's own pressure/flow unless the row's
+    // derived_version says the stored ones came from the current algorithm
+    // (recompute-shot-curves-on-load, made once per algorithm change by the
+    // stamp) — so conductanceDerivative is populated for the analysis block
+    // below whenever the shot has enough samples for computeDerivedCurves() to
+    // run (its own >=3-sample guard applies here too). When the recompute
+    // disagrees with what was stored, or the blob is still in the legacy JSON
+    // format, correctedBlob comes back non-empty and goes into the refresh;
+    // either way a full load asks for the row to be stamped.
+    QByteArray& correctedBlob = refresh.correctedBlob;
+    bool& curvesChanged = refresh.curvesChanged;
+    bool derivedWasCurrent = false;
+    bool derivedNowCurrent = false;
+    if (PreparedQuery blobQuery(db, QStringLiteral(
+            "SELECT data_blob, derived_version FROM shot_samples WHERE shot_id = ?"));
+        blobQuery.ok()) {
+        QSqlQuery& blobSel = *blobQuery;
+        blobSel.bindValue(0, shotId);
+        if (blobSel.exec() && blobSel.next()) {
+            QByteArray blob = blobSel.value(0).toByteArray();
+            derivedWasCurrent = blobSel.value(1).toInt() == Conductance::kAlgorithmVersion;
+            derivedNowCurrent = decompressSampleData(blob, &record, &correctedBlob, &curvesChanged,
+                                                     series, derivedWasCurrent);
         }
         // Release the read transaction this SELECT is still holding — the
         // single row was consumed above but the statement was never stepped
-        // to exhaustion, so it stays "active" and the writes below would try
-        // to upgrade a stale WAL read snapshot instead of taking a fresh write
-        // lock. That upgrade fails immediately (SQLITE_BUSY_SNAPSHOT) rather
+        // to exhaustion, so it stays "active" and the caller's writes would
+        // try to upgrade a stale WAL read snapshot instead of taking a fresh
+        // write lock. That upgrade fails immediately (SQLITE_BUSY_SNAPSHOT) rather
         // than waiting out busy_timeout — see core/dbutils.h's DbWriteTxn doc
         // on the no-active-statement precondition.
-        query.finish();
+        blobSel.finish();
     }
 
-    if (!correctedBlob.isEmpty()) {
-        // Both writes land together or not at all: a corrected blob with a
-        // stale updated_at would permanently hide the correction from
-        // ShotHistoryExporter::exportedFileIsFresh(), which decides purely by
-        // comparing an export's mtime against this column, and nothing ever
-        // retries a write that already "succeeded" on the blob half.
-        DbWriteTxn txn = DbWriteTxn::begin(db, "curve self-heal");
-        if (txn.ok()) {
-            QSqlQuery curveUpd(db);
-            curveUpd.prepare("UPDATE shot_samples SET data_blob = ? WHERE shot_id = ?");
-            curveUpd.bindValue(0, correctedBlob);
-            curveUpd.bindValue(1, shotId);
-
-            // Bump updated_at so consumers keyed on it (ShotHistoryExporter's
-            // exportedFileIsFresh()) know this shot changed and re-derive
-            // their own cached output — same reason the badge-persist UPDATE
-            // below touches it too.
-            QSqlQuery touchUpd(db);
-            touchUpd.prepare("UPDATE shots SET updated_at = strftime('%s', 'now') WHERE id = ?");
-            touchUpd.bindValue(0, shotId);
-
-            if (curveUpd.exec() && touchUpd.exec()) {
-                if (!txn.commit()) {
-                    qWarning() << "ShotHistoryStorage::loadShotRecordStatic: curve self-heal"
-                                  " commit failed for shot" << shotId << txn.commitError();
-                }
-            } else {
-                qWarning() << "ShotHistoryStorage::loadShotRecordStatic: curve self-heal"
-                              " failed for shot" << shotId
-                           << curveUpd.lastError() << touchUpd.lastError();
-            }
-        }
-    }
-
-    if (query.prepare("SELECT time_offset, label, frame_number, is_flow_mode, transition_reason "
-                      "FROM shot_phases WHERE shot_id = ? ORDER BY time_offset")) {
-        query.bindValue(0, shotId);
-        if (query.exec()) {
-            while (query.next()) {
+    // A partial load never stamps — its recompute covered only the curves it
+    // was asked for.
+    refresh.stampDerived = series == ShotSampleBlob::kAllSeries && derivedNowCurrent
+        && !derivedWasCurrent && correctedBlob.isEmpty();
+
+    if (PreparedQuery phaseQuery(db, QStringLiteral("SELECT time_offset, label, frame_number, is_flow_mode, transition_reason "
+                                                    "FROM shot_phases WHERE shot_id = ? ORDER BY time_offset"));
+        phaseQuery.ok()) {
+        QSqlQuery& phaseSel = *phaseQuery;
+        phaseSel.bindValue(0, shotId);
+        if (phaseSel.exec()) {
+            while (phaseSel.next()) {
                 HistoryPhaseMarker marker;
-                marker.time = query.value(0).toDouble();
-                marker.label = query.value(1).toString();
-                marker.frameNumber = query.value(2).toInt();
-                marker.isFlowMode = query.value(3).toInt() != 0;
-                marker.transitionReason = query.value(4).toString();
+                marker.time = phaseSel.value(0).toDouble();
+                marker.label = phaseSel.value(1).toString();
+                marker.frameNumber = phaseSel.value(2).toInt();
+                marker.isFlowMode = phaseSel.value(3).toInt() != 0;
+                marker.transitionReason = phaseSel.value(4).toString();
                 record.phases.append(marker);
             }
         }
     }
 
-    // Compute phase summaries on-the-fly for legacy shots that lack them
-    if (record.phaseSummariesJson.isEmpty() && !record.pressure.isEmpty() && !record.phases.isEmpty()) {
+    // Compute phase summaries on-the-fly for legacy shots that lack them —
+    // only when every curve they average was decoded, since a summary built
+    // from a partial load would report zeros as if they were measurements.
+    using ShotSampleBlob::Series;
+    using ShotSampleBlob::seriesBit;
+    constexpr ShotSampleBlob::SeriesMask kPhaseSummarySeries = seriesBit(Series::Pressure)
+        | seriesBit(Series::Flow) | seriesBit(Series::Temperature) | seriesBit(Series::Weight);
+    if ((series & kPhaseSummarySeries) == kPhaseSummarySeries
+        && record.phaseSummariesJson.isEmpty() && !record.pressure.isEmpty() && !record.phases.isEmpty()) {
         computePhaseSummaries(record);
     }
 
@@ -3501,15 +4109,17 @@ ShotRecord ShotHistoryStorage::loadShotRecordStatic(QSqlDatabase& db, qint64 sho
         }
     }
 
-    // Always recompute every quality badge from the loaded curve data, so that
-    // detector improvements take effect on existing shots without a one-shot
-    // re-analyze pass. Stored badge values are only authoritative as of save
-    // time; the detectors evolve. The channeling sub-block uses
-    // conductanceDerivative, which decompressSampleData() above unconditionally
-    // recomputes from pressure/flow (recompute-shot-curves-on-load), regardless
-    // of migration status — populated whenever the shot has enough samples for
-    // computeDerivedCurves() to run (its own >=3-sample guard, shothistorystorage.h),
-    // same as before this change for any shot that already had the field.
+    // Every quality badge is a projection of the shot's analysis, and the
+    // analysis is either the stored one — when shot_analysis holds a row
+    // written by the current detectors and derived curves, for exactly these
+    // inputs (history/shotanalysiscache.h) — or a fresh analyzeShot pass that
+    // is then stored. Detector improvements still reach existing shots without
+    // a one-shot re-analyze pass: an ALGORITHM_VERSION bump makes every row
+    // stale, and the next load (or the history re-analysis job) recomputes it. The
+    // channeling sub-block uses conductanceDerivative, which
+    // decompressSampleData() above leaves current (trusted or recomputed) —
+    // populated whenever the shot has enough samples for computeDerivedCurves()
+    // to run (its own >=3-sample guard, shothistorystorage.h).
     // The grind and skip-first-frame sub-blocks need only flow / flowGoal /
     // pressure / phases, which are always available.
     // Compute all four quality badges via a single ShotAnalysis::analyzeShot
@@ -3525,63 +4135,76 @@ ShotRecord ShotHistoryStorage::loadShotRecordStatic(QSqlDatabase& db, qint64 sho
     // used to need is no longer required — analyzeShot returns clean
     // defaults for any input shape it can't handle, which the projection
     // helper interprets as "all badges false."
-    {
+    //
+    // A partial load that left out any of the detector inputs skips this
+    // block: analyzing missing curves would "correct" the stored badges to
+    // false. Those callers read the stored columns as-is.
+    const bool analysisInputsLoaded =
+        (series & ShotSampleBlob::kAnalysisSeries) == ShotSampleBlob::kAnalysisSeries;
+    if (analysisInputsLoaded) {
         const AnalysisInputs inputs = prepareAnalysisInputs(record.profileKbId, record.profileJson);
-        // Same as the save path: the gate comes from AnalysisInputs, which
-        // re-resolves from the shot's own stored profile (by title, then by
-        // shape). An empty persisted id no longer means "no context" — it is
-        // also what every shape-resolved profile carries.
-        const bool profileKbResolved = inputs.profileKbResolved;
-        auto analysis = ShotAnalysis::analyzeShot(
-            record.pressure, record.flow, record.weight,
-            record.conductanceDerivative,
-            record.phases, record.summary.beverageType, record.summary.duration,
-            record.pressureGoal, record.flowGoal,
-            inputs.analysisFlags, inputs.firstFrameSeconds,
-            record.targetWeight, record.summary.finalWeight,
-            inputs.frameCount, inputs.expertBand,
-            profileKbResolved);
-        decenza::applyBadgesToTarget(record, analysis.detectors);
-        // Cache the AnalysisResult on the ShotRecord so convertShotRecord
-        // (called next in the requestShot path) doesn't have to re-run
-        // analyzeShot on the same inputs. See cachedAnalysis docstring on
-        // ShotRecord for the invalidation contract.
-        record.cachedAnalysis = std::move(analysis);
-        // Same walk, same reason — see cachedKbDerivedFrom on ShotRecord. Only
-        // a SHAPE match is a derivation worth naming: a title match needs no
-        // explanation and an ambiguous one has no single entry to name.
-        if (inputs.identityFromShape && !inputs.identityKbId.isEmpty())
-            record.cachedKbDerivedFrom =
-                ShotSummarizer::canonicalNameForKbId(inputs.identityKbId);
-    }
-
-    // Persist any drift between the stored badge columns and the recomputed values
-    // on the same connection. Loading a shot is the canonical "touched it under the
-    // current detector" event — both UI and MCP go through this path — so the DB
-    // converges with detector improvements as shots are viewed without needing a
-    // separate bulk-resweep migration. The UPDATE is skipped when nothing changed.
-    const bool flagsChanged = (storedChanneling != record.channelingDetected
+        const QByteArray inputsKey = ShotAnalysisCache::inputsKey(
+            record.summary.beverageType, record.summary.duration,
+            record.targetWeight, record.summary.finalWeight, record.phases, inputs);
+        // A stored analysis is only as current as the conductanceDerivative it
+        // read, so it is not looked up while the curves are unverified (an
+        // unreadable blob); that shot is analysed afresh and not stored.
+        std::optional<ShotAnalysisCache::Entry> stored;
+        if (derivedNowCurrent)
+            stored = ShotAnalysisCache::load(db, shotId, inputsKey);
+        if (stored) {
+            decenza::applyBadgesToTarget(record, stored->result.detectors);
+            record.cachedAnalysis = std::move(stored->result);
+            record.cachedKbDerivedFrom = stored->kbDerivedFrom;
+        } else {
+            // Same as the save path: the gate comes from AnalysisInputs, which
+            // re-resolves from the shot's own stored profile (by title, then by
+            // shape). An empty persisted id no longer means "no context" — it is
+            // also what every shape-resolved profile carries.
+            const bool profileKbResolved = inputs.profileKbResolved;
+            auto analysis = ShotAnalysis::analyzeShot(
+                record.pressure, record.flow, record.weight,
+                record.conductanceDerivative,
+                record.phases, record.summary.beverageType, record.summary.duration,
+                record.pressureGoal, record.flowGoal,
+                inputs.analysisFlags, inputs.firstFrameSeconds,
+                record.targetWeight, record.summary.finalWeight,
+                inputs.frameCount, inputs.expertBand,
+                profileKbResolved);
+            decenza::applyBadgesToTarget(record, analysis.detectors);
+            // Cache the AnalysisResult on the ShotRecord so convertShotRecord
+            // (called next in the requestShot path) doesn't have to re-run
+            // analyzeShot on the same inputs. See cachedAnalysis docstring on
+            // ShotRecord for the invalidation contract.
+            record.cachedAnalysis = std::move(analysis);
+            // Same walk, same reason — see cachedKbDerivedFrom on ShotRecord. Only
+            // a SHAPE match is a derivation worth naming: a title match needs no
+            // explanation and an ambiguous one has no single entry to name.
+            if (inputs.identityFromShape && !inputs.identityKbId.isEmpty())
+                record.cachedKbDerivedFrom =
+                    ShotSummarizer::canonicalNameForKbId(inputs.identityKbId);
+            if (derivedNowCurrent) {
+                refresh.analysisKey = inputsKey;
+                refresh.analysis = record.cachedAnalysis;
+                refresh.kbDerivedFrom = record.cachedKbDerivedFrom;
+            }
+        }
+    }
+
+    // Report any drift between the stored badge columns and the recomputed
+    // values for the caller to persist. Loading a shot is the canonical
+    // "touched it under the current detector" event — both UI and MCP go
+    // through this path — so the DB converges with detector improvements as
+    // shots are viewed without needing a separate bulk-resweep migration.
+    refresh.badgesChanged = (storedChanneling != record.channelingDetected
         || storedGrindIssue != record.grindIssueDetected
         || storedSkipFirstFrame != record.skipFirstFrameDetected
         || storedPourTruncated != record.pourTruncatedDetected);
-    if (flagsChanged) {
-        QSqlQuery upd(db);
-        upd.prepare("UPDATE shots SET channeling_detected=:c,"
-                    " grind_issue_detected=:g,"
-                    " skip_first_frame_detected=:s,"
-                    " pour_truncated_detected=:p,"
-                    " updated_at = strftime('%s', 'now') WHERE id=:id");
-        upd.bindValue(":c", record.channelingDetected ? 1 : 0);
-        upd.bindValue(":g", record.grindIssueDetected ? 1 : 0);
-        upd.bindValue(":s", record.skipFirstFrameDetected ? 1 : 0);
-        upd.bindValue(":p", record.pourTruncatedDetected ? 1 : 0);
-        upd.bindValue(":id", shotId);
-        if (upd.exec()) {
-            if (outBadgesPersisted) *outBadgesPersisted = true;
-        } else {
-            qWarning() << "ShotHistoryStorage::loadShotRecordStatic: badge persist failed for shot"
-                       << shotId << upd.lastError();
-        }
+    if (refresh.badgesChanged) {
+        refresh.channelingDetected = record.channelingDetected;
+        refresh.grindIssueDetected = record.grindIssueDetected;
+        refresh.skipFirstFrameDetected = record.skipFirstFrameDetected;
+        refresh.pourTruncatedDetected = record.pourTruncatedDetected;
     }
 
     return record;
@@ -3605,6 +4228,51 @@ bool ShotHistoryStorage::deleteShotStatic(QSqlDatabase& db, qint64 shotId)
     return true;
 }
 
+QString ShotHistoryStorage::profileJsonHash(const QString& profileJson)
+{
+    return QString::fromLatin1(
+        QCryptographicHash::hash(profileJson.toUtf8(), QCryptographicHash::Sha256).toHex());
+}
+
+std::optional<QString> ShotHistoryStorage::storeProfileJsonStatic(QSqlDatabase& db,
+                                                                  const QString& profileJson,
+                                                                  QSqlError* outError)
+{
+    if (profileJson.isEmpty()) return QString();
+
+    // OR IGNORE: the hash names the content, so an existing row already holds
+    // exactly this JSON — the common case, since most shots reuse a profile.
+    const QString hash = profileJsonHash(profileJson);
+    PreparedQuery insert(db, QStringLiteral("INSERT OR IGNORE INTO shot_profiles (hash, profile_json) VALUES (?, ?)"));
+    QSqlQuery& query = *insert;
+    query.bindValue(0, hash);
+    query.bindValue(1, profileJson);
+    if (!insert.ok() || !query.exec()) {
+        qWarning() << "ShotHistoryStorage: Failed to store profile JSON:" << query.lastError().text();
+        if (outError) *outError = query.lastError();
+        return std::nullopt;
+    }
+    return hash;
+}
+
+bool ShotHistoryStorage::storeDebugLogStatic(QSqlDatabase& db, qint64 shotId,
+                                             const QString& debugLog, QSqlError* outError)
+{
+    if (debugLog.isEmpty()) return true;
+
+    PreparedQuery insert(db, QStringLiteral("INSERT OR REPLACE INTO shot_debug_logs (shot_id, debug_log) VALUES (?, ?)"));
+    QSqlQuery& query = *insert;
+    query.bindValue(0, shotId);
+    query.bindValue(1, debugLog);
+    if (!insert.ok() || !query.exec()) {
+        qWarning() << "ShotHistoryStorage: Failed to store debug log for shot" << shotId << ":"
+                   << query.lastError().text();
+        if (outError) *outError = query.lastError();
+        return false;
+    }
+    return true;
+}
+
 void ShotHistoryStorage::deleteShots(const QVariantList& shotIds)
 {
     if (!m_ready || shotIds.isEmpty()) return;
@@ -3981,7 +4649,7 @@ void ShotHistoryStorage::requestCreateBackup(const QString& destPath)
             m_backupInProgress = false;
             emit backupFinished(!resultPath.isEmpty(), resultPath);
         }, Qt::QueuedConnection);
-    });
+    }, TaskLane::Maintenance);
 
 }
 
@@ -4090,7 +4758,7 @@ void ShotHistoryStorage::requestImportDatabase(const QString& filePath, bool mer
             }
             emit importDatabaseFinished(success);
         }, Qt::QueuedConnection);
-    });
+    }, TaskLane::Maintenance);
 
 }
 
@@ -4232,6 +4900,9 @@ bool ShotHistoryStorage::importDatabaseStatic(const QString& destDbPath, const Q
             QSqlQuery delQuery(destDb);
             if (!delQuery.exec("DELETE FROM shot_phases") ||
                 !delQuery.exec("DELETE FROM shot_samples") ||
+                !delQuery.exec("DELETE FROM shot_debug_logs") ||
+                !delQuery.exec("DELETE FROM shot_analysis") ||
+                !delQuery.exec("DELETE FROM shot_reanalysis_checkpoint") ||
                 !delQuery.exec("DELETE FROM shots")) {
                 qWarning() << "ShotHistoryStorage::importDatabaseStatic: Failed to clear data:" << delQuery.lastError().text();
                 destDb.rollback();
@@ -4394,8 +5065,17 @@ bool ShotHistoryStorage::importDatabaseStatic(const QString& destDbPath, const Q
                     nextRelocatedId = std::max(nextRelocatedId, id + 1);
             }
 
+            // A post-migration-39 source keeps profile_json and debug_log in
+            // side tables; join them back under their old names so the rest
+            // of this loop reads either generation the same way.
+            const bool srcHasSideTables = srcDb.tables().contains(QStringLiteral("shot_profiles"));
             QSqlQuery srcShots(srcDb);
-            if (!srcShots.exec("SELECT * FROM shots")) {
+            if (!srcShots.exec(srcHasSideTables
+                    ? QStringLiteral("SELECT s.*, sp.profile_json AS profile_json, dl.debug_log AS debug_log "
+                                     "FROM shots s "
+                                     "LEFT JOIN shot_profiles sp ON sp.hash = s.profile_hash "
+                                     "LEFT JOIN shot_debug_logs dl ON dl.shot_id = s.id")
+                    : QStringLiteral("SELECT * FROM shots"))) {
                 qWarning() << "ShotHistoryStorage::importDatabaseStatic: Failed to query source:" << srcShots.lastError().text();
                 destDb.rollback();
                 goto cleanup;
@@ -4464,13 +5144,13 @@ bool ShotHistoryStorage::importDatabaseStatic(const QString& destDbPath, const Q
 
                 QSqlQuery insert(destDb);
                 insert.prepare(R"(
-                    INSERT INTO shots (id, uuid, timestamp, profile_name, profile_json, beverage_type,
+                    INSERT INTO shots (id, uuid, timestamp, profile_name, profile_hash, beverage_type,
                         duration_seconds, final_weight, dose_weight,
                         bean_brand, bean_type, roast_date, roast_level,
                         grinder_setting, equipment_id, rpm,
                         drink_tds, drink_ey,
                         enjoyment, espresso_notes, bean_notes, barista,
-                        profile_notes, visualizer_id, visualizer_url, debug_log,
+                        profile_notes, visualizer_id, visualizer_url,
                         temperature_override, yield_override, yield_mode, yield_anchor_value,
                         profile_kb_id,
                         channeling_detected, grind_issue_detected,
@@ -4479,7 +5159,7 @@ bool ShotHistoryStorage::importDatabaseStatic(const QString& destDbPath, const Q
                         bag_id, frozen_date, defrost_date, storage_hint, opened_date,
                         taste_balance, taste_body,
                         recipe_id, steam_json, hot_water_json)
-                    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+                    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
                 )");
 
                 // KEEP THE SHOT'S OWN ID wherever it is free.
@@ -4514,7 +5194,11 @@ bool ShotHistoryStorage::importDatabaseStatic(const QString& destDbPath, const Q
                 insert.addBindValue(uuid);
                 insert.addBindValue(srcShots.value("timestamp"));
                 insert.addBindValue(srcShots.value("profile_name"));
-                insert.addBindValue(srcShots.value("profile_json"));
+                // Content-addressed, so a profile the destination already
+                // holds (every merge of your own backup) adds no row.
+                const std::optional<QString> profileHash =
+                    storeProfileJsonStatic(destDb, srcShots.value("profile_json").toString());
+                insert.addBindValue(profileHash && !profileHash->isEmpty() ? QVariant(*profileHash) : QVariant());
                 QVariant bt = srcShots.value("beverage_type");
                 insert.addBindValue((bt.isValid() && !bt.isNull()) ? bt : QVariant(QString("espresso")));
                 insert.addBindValue(srcShots.value("duration_seconds"));
@@ -4542,7 +5226,6 @@ bool ShotHistoryStorage::importDatabaseStatic(const QString& destDbPath, const Q
                 insert.addBindValue(srcShots.value("profile_notes"));
                 insert.addBindValue(srcShots.value("visualizer_id"));
                 insert.addBindValue(srcShots.value("visualizer_url"));
-                insert.addBindValue(srcShots.value("debug_log"));
                 insert.addBindValue(srcShots.value("temperature_override"));
                 insert.addBindValue(srcShots.value("yield_override"));
                 // Anchor provenance: verbatim from a ≥34 source; pre-34 rows
@@ -4599,7 +5282,9 @@ bool ShotHistoryStorage::importDatabaseStatic(const QString& destDbPath, const Q
                 insert.addBindValue(srcValueOrNull(idxSteamJson));
                 insert.addBindValue(srcValueOrNull(idxHotWaterJson));
 
-                if (!insert.exec()) {
+                // A failed profile store already warned; it fails the row like
+                // a failed INSERT rather than importing a shot with no profile.
+                if (!profileHash || !insert.exec()) {
                     qWarning() << "ShotHistoryStorage::importDatabaseStatic: Failed to import shot:" << insert.lastError().text();
                     failed++;
                     if (!merge) {
@@ -4637,6 +5322,10 @@ bool ShotHistoryStorage::importDatabaseStatic(const QString& destDbPath, const Q
                 // was free.
                 tally.shotIdMap.insert(oldId, newId);
 
+                // Non-critical, like the samples below: the shot is intact
+                // without its log, and storeDebugLogStatic has said why.
+                storeDebugLogStatic(destDb, newId, srcShots.value("debug_log").toString());
+
                 // Import samples
                 QSqlQuery srcSamples(srcDb);
                 srcSamples.prepare("SELECT sample_count, data_blob FROM shot_samples WHERE shot_id = ?");
@@ -4721,7 +5410,9 @@ bool ShotHistoryStorage::importDatabaseStatic(const QString& destDbPath, const Q
                     qWarning() << "ShotHistoryStorage::importDatabaseStatic: Backfill transaction failed - skipping backfill";
                 } else {
                 QSqlQuery query(destDb);
-                query.prepare("SELECT id, profile_json FROM shots WHERE (beverage_type = 'espresso' OR beverage_type IS NULL) AND profile_json IS NOT NULL AND profile_json != ''");
+                query.prepare("SELECT s.id, sp.profile_json FROM shots s "
+                              "JOIN shot_profiles sp ON sp.hash = s.profile_hash "
+                              "WHERE s.beverage_type = 'espresso' OR s.beverage_type IS NULL");
                 query.exec();
                 while (query.next()) {
                     qint64 id = query.value(0).toLongLong();
@@ -4828,8 +5519,8 @@ std::optional<QSet<qint64>> ShotHistoryStorage::existingShotIds(const QSet<qint6
     // Primary-key IN over the distinct ids of one conversation's turns — a
     // couple of dozen at most, selecting only the id column. `EXPLAIN QUERY
     // PLAN` confirms `SEARCH shots USING INTEGER PRIMARY KEY (rowid=?)`, so it
-    // touches the index and the matched rows, not the profile_json/debug_log
-    // blobs that make a shots scan expensive.
+    // touches the index and the matched rows, not the wide rows that make a
+    // shots scan expensive.
     //
     // Measured against the maintainer's REAL database, pulled from the tablet
     // over /api/backup/shots (1061 shots, 18.1 MB), and against a synthetic 4x
@@ -4924,9 +5615,9 @@ qint64 ShotHistoryStorage::importShotRecord(const ShotRecord& record, bool overw
         qWarning() << "ShotHistoryStorage: Cannot import - not ready";
         return -1;
     }
-    // beginAttempts = 1: this overload runs synchronously on the GUI thread
-    // (ShotImporter batches it from a timer), and each further attempt can spend
-    // the full busy_timeout blocking the UI with no way to cancel.
+    // beginAttempts = 1: this overload runs synchronously on the caller's
+    // (GUI) thread, and each further attempt can spend the full busy_timeout
+    // blocking the UI with no way to cancel.
     return importShotRecordStatic(m_db, record, overwriteExisting, 1);
 }
 
@@ -4949,8 +5640,72 @@ void ShotHistoryStorage::importShotRecordAsync(const ShotRecord& record, bool ov
     });
 }
 
-qint64 ShotHistoryStorage::importShotRecordStatic(QSqlDatabase& db, const ShotRecord& record,
-                                                  bool overwriteExisting, int beginAttempts)
+void ShotHistoryStorage::importShotRecordsAsync(const QList<ShotRecord>& records, bool overwriteExisting,
+                                                std::function<void(const QList<qint64>&)> onDone)
+{
+    const QString dbPath = m_dbPath;
+    auto destroyed = m_destroyed;
+    runOnDbThread([this, dbPath, records, overwriteExisting,
+                   onDone = std::move(onDone), destroyed]() {
+        QList<qint64> results(records.size(), -1);
+        withTempDb(dbPath, "shs_import_batch", [&](QSqlDatabase& db) {
+            results = importShotRecordsStatic(db, records, overwriteExisting);
+        });
+        if (*destroyed) return;
+        QMetaObject::invokeMethod(this, [onDone, results, destroyed]() {
+            if (*destroyed) return;
+            if (onDone) onDone(results);
+        }, Qt::QueuedConnection);
+    });
+}
+
+namespace {
+
+// Host parameters per dedupe probe. SQLite builds before 3.32 cap a statement
+// at 999, and Android ships whatever its system library is.
+constexpr qsizetype kImportProbeChunk = 500;
+
+// Maps each of `keys` that matches `column` to its shot id, one IN (...) query
+// per chunk rather than one round trip per record. False on a query failure,
+// which the caller must not read as "no duplicates".
+bool probeShotIds(QSqlDatabase& db, const char* column, const QStringList& keys,
+                  QHash<QString, qint64>& out)
+{
+    for (qsizetype start = 0; start < keys.size(); start += kImportProbeChunk) {
+        const qsizetype n = qMin(kImportProbeChunk, keys.size() - start);
+        QStringList placeholders(n, QStringLiteral("?"));
+        QSqlQuery query(db);
+        query.prepare(QStringLiteral("SELECT %1, id FROM shots WHERE %1 IN (%2)")
+                          .arg(QLatin1String(column), placeholders.join(QLatin1Char(','))));
+        for (qsizetype i = 0; i < n; ++i)
+            query.bindValue(int(i), keys[start + i]);
+        if (!query.exec()) {
+            qWarning() << "ShotHistoryStorage: import" << column << "probe failed:"
+                       << query.lastError().text();
+            return false;
+        }
+        while (query.next())
+            out.insert(query.value(0).toString(), query.value(1).toLongLong());
+    }
+    return true;
+}
+
+// The near-duplicate rule: same profile name, start times less than 5 s apart.
+bool isNearDuplicate(const QList<QPair<qint64, qint64>>& startsAndIds, qint64 timestamp, qint64* outId)
+{
+    for (const auto& [start, id] : startsAndIds) {
+        if (qAbs(start - timestamp) < 5) {
+            if (outId) *outId = id;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+QList<qint64> ShotHistoryStorage::importShotRecordsStatic(QSqlDatabase& db, const QList<ShotRecord>& records,
+                                                          bool overwriteExisting, int beginAttempts)
 {
     // The dedupe probes below are READ-ONLY: when they match a shot we are
     // replacing they only record its id, and the delete happens later, inside
@@ -4967,80 +5722,171 @@ qint64 ShotHistoryStorage::importShotRecordStatic(QSqlDatabase& db, const ShotRe
     //    case that writes nothing — which turns a "skipped" result into a
     //    "failed" one under contention and serialises bulk imports for no gain.
     //
-    // Probing read-only and deleting inside the transaction gets both: a
-    // duplicate we are not overwriting returns 0 having taken no lock at all,
-    // and everything the import does destroy rolls back with it.
-    QList<qint64> replaceIds;   // shots this import replaces; deleted inside the txn
-    QSqlQuery query(db);
+    // Probing read-only and deleting inside the transaction gets both: a batch
+    // of duplicates we are not overwriting returns 0s having taken no lock at
+    // all, and everything the import does destroy rolls back with it.
+    QList<qint64> results(records.size(), 0);
+    if (records.isEmpty()) return results;
+
+    // One set query per key for the whole batch. Three keys, strongest first:
+    //
+    //  - visualizer_id, when the incoming record has one (only the Visualizer
+    //    recovery import sets it; .shot-file imports leave it empty, so it
+    //    probes nothing for them). This is the strongest key for the sync-gap
+    //    case: a shot that was pulled ON THIS DEVICE has a local uuid keyed on
+    //    its filename, so the recovery's visualizer-id-keyed uuid can never
+    //    match it — but if that local shot was uploaded, its visualizer_id
+    //    column is set to the same id we're importing, and matches here.
+    //    Without this, dedupe would fall through to the timestamp+profile_name
+    //    check, which a shot with a differently-formatted or later-renamed
+    //    profile title can slip past and re-import as a duplicate row.
+    //  - uuid.
+    //  - start time within 5 s on the same profile name, to catch
+    //    near-duplicates. Read as one range over the batch's span: a .shot
+    //    archive imports in filename (= time) order, so the span is narrow.
+    QStringList uuids, visualizerIds;
+    qint64 minTimestamp = std::numeric_limits<qint64>::max();
+    qint64 maxTimestamp = std::numeric_limits<qint64>::min();
+    for (const ShotRecord& record : records) {
+        uuids.append(record.summary.uuid);
+        if (!record.visualizerId.isEmpty())
+            visualizerIds.append(record.visualizerId);
+        minTimestamp = qMin(minTimestamp, record.summary.timestamp);
+        maxTimestamp = qMax(maxTimestamp, record.summary.timestamp);
+    }
+
+    QHash<QString, qint64> byUuid, byVisualizerId;
+    QHash<QString, QList<QPair<qint64, qint64>>> byProfile;  // profile_name -> (timestamp, id)
+    bool probed = probeShotIds(db, "uuid", uuids, byUuid)
+                  && probeShotIds(db, "visualizer_id", visualizerIds, byVisualizerId);
+    if (probed) {
+        QSqlQuery query(db);
+        query.prepare("SELECT id, timestamp, profile_name FROM shots WHERE timestamp > ? AND timestamp < ?");
+        query.bindValue(0, minTimestamp - 5);
+        query.bindValue(1, maxTimestamp + 5);
+        probed = query.exec();
+        if (!probed)
+            qWarning() << "ShotHistoryStorage: import near-duplicate probe failed:" << query.lastError().text();
+        while (probed && query.next()) {
+            byProfile[query.value(2).toString()].append(
+                {query.value(1).toLongLong(), query.value(0).toLongLong()});
+        }
+    }
+    if (!probed) {
+        results.fill(-1);
+        return results;
+    }
+
+    // Decide every record before writing any. A record that repeats one
+    // earlier in the same batch is skipped, as it would have been had the two
+    // been imported one after the other.
+    struct Planned {
+        qsizetype index;
+        QList<qint64> replaceIds;   // shots this record replaces; deleted inside the txn
+    };
+    QList<Planned> planned;
+    QSet<QString> batchUuids, batchVisualizerIds;
+    QHash<QString, QList<QPair<qint64, qint64>>> batchByProfile;
+    for (qsizetype i = 0; i < records.size(); ++i) {
+        const ShotRecord& record = records[i];
+        const QString& profileName = record.summary.profileName;
+        const qint64 timestamp = record.summary.timestamp;
+
+        if (batchUuids.contains(record.summary.uuid)
+            || (!record.visualizerId.isEmpty() && batchVisualizerIds.contains(record.visualizerId))
+            || isNearDuplicate(batchByProfile.value(profileName), timestamp, nullptr)) {
+            continue;   // repeats an earlier record of this batch, skip
+        }
 
-    // Check for duplicate by Visualizer id first, when the incoming record has
-    // one (only the Visualizer recovery import sets it; .shot-file imports leave
-    // it empty, so this probe is a no-op for them). This is the strongest key for
-    // the sync-gap case: a shot that was pulled ON THIS DEVICE has a local uuid
-    // keyed on its filename, so the recovery's visualizer-id-keyed uuid can never
-    // match it — but if that local shot was uploaded, its visualizer_id column is
-    // set to the same id we're importing, and matches here. Without this, dedupe
-    // would fall through to the timestamp+profile_name check, which a shot with a
-    // differently-formatted or later-renamed profile title can slip past and
-    // re-import as a duplicate row.
-    if (!record.visualizerId.isEmpty()) {
-        query.prepare("SELECT id FROM shots WHERE visualizer_id = ?");
-        query.bindValue(0, record.visualizerId);
-        if (query.exec() && query.next()) {
-            if (!overwriteExisting)
-                return 0;   // already have this exact Visualizer shot, skip
-            const qint64 existingId = query.value(0).toLongLong();
+        QList<qint64> replaceIds;
+        const auto matched = [&replaceIds](qint64 existingId) {
             if (!replaceIds.contains(existingId))
                 replaceIds.append(existingId);
+        };
+        if (!record.visualizerId.isEmpty()) {
+            if (auto it = byVisualizerId.constFind(record.visualizerId); it != byVisualizerId.cend())
+                matched(*it);
         }
+        if (auto it = byUuid.constFind(record.summary.uuid); it != byUuid.cend())
+            matched(*it);
+        qint64 nearId = 0;
+        if (isNearDuplicate(byProfile.value(profileName), timestamp, &nearId))
+            matched(nearId);
+
+        if (!replaceIds.isEmpty() && !overwriteExisting)
+            continue;   // duplicate found, skip
+
+        batchUuids.insert(record.summary.uuid);
+        if (!record.visualizerId.isEmpty())
+            batchVisualizerIds.insert(record.visualizerId);
+        batchByProfile[profileName].append({timestamp, 0});
+        planned.append({i, replaceIds});
     }
-
-    // Check for duplicate by UUID
-    query.prepare("SELECT id FROM shots WHERE uuid = ?");
-    query.bindValue(0, record.summary.uuid);
-    if (query.exec() && query.next()) {
-        if (!overwriteExisting)
-            return 0;   // duplicate found, skip
-        const qint64 existingId = query.value(0).toLongLong();
-        if (!replaceIds.contains(existingId))
-            replaceIds.append(existingId);
-    }
-
-    // Also check by timestamp (within 5 seconds) and profile to catch near-duplicates
-    query.prepare("SELECT id FROM shots WHERE ABS(timestamp - ?) < 5 AND profile_name = ?");
-    query.bindValue(0, record.summary.timestamp);
-    query.bindValue(1, record.summary.profileName);
-    if (query.exec() && query.next()) {
-        if (!overwriteExisting)
-            return 0;   // near-duplicate found, skip
-        const qint64 existingId = query.value(0).toLongLong();
-        if (!replaceIds.contains(existingId))
-            replaceIds.append(existingId);
-    }
-
-    // Release the probes' statement: it matched a row and was never stepped to
-    // exhaustion, so it is still active, and an active statement holds a read
-    // transaction open — which makes BEGIN IMMEDIATE fail instantly and
-    // unrecoverably. See DbWriteTxn's precondition.
-    query.finish();
+    if (planned.isEmpty()) return results;
 
     DbWriteTxn txn = DbWriteTxn::begin(db, "shot import", beginAttempts);
     if (!txn.ok()) {
-        qWarning() << "ShotHistoryStorage: import could not start a transaction, skipping shot"
-                   << record.summary.uuid;
-        return -1;
+        qWarning() << "ShotHistoryStorage: import could not start a transaction, skipping"
+                   << planned.size() << "shots";
+        for (const Planned& p : std::as_const(planned))
+            results[p.index] = -1;
+        return results;
     }
 
-    // Now inside the transaction, so these roll back with everything else.
-    for (const qint64 replaceId : std::as_const(replaceIds)) {
-        if (!deleteShotStatic(db, replaceId)) {
-            qWarning() << "ShotHistoryStorage: import could not remove the shot it replaces"
-                       << replaceId << "for" << record.summary.uuid
-                       << "- aborting rather than leaving a duplicate";
-            return -1;
+    // One savepoint per record, so a record that fails — its replaced shot
+    // included — rolls back alone and the rest of the batch still commits.
+    QSqlQuery savepoint(db);
+    for (const Planned& p : std::as_const(planned)) {
+        const ShotRecord& record = records[p.index];
+        results[p.index] = -1;
+        if (!savepoint.exec(QStringLiteral("SAVEPOINT shot_import"))) {
+            qWarning() << "ShotHistoryStorage: import savepoint failed for" << record.summary.uuid
+                       << savepoint.lastError().text();
+            continue;
         }
+
+        bool removed = true;
+        for (const qint64 replaceId : p.replaceIds) {
+            if (!deleteShotStatic(db, replaceId)) {
+                qWarning() << "ShotHistoryStorage: import could not remove the shot it replaces"
+                           << replaceId << "for" << record.summary.uuid
+                           << "- aborting rather than leaving a duplicate";
+                removed = false;
+                break;
+            }
+        }
+        const qint64 shotId = removed ? insertImportedShotStatic(db, record) : -1;
+
+        if (shotId > 0) {
+            savepoint.exec(QStringLiteral("RELEASE shot_import"));
+            results[p.index] = shotId;
+        } else {
+            savepoint.exec(QStringLiteral("ROLLBACK TO shot_import"));
+            savepoint.exec(QStringLiteral("RELEASE shot_import"));
+        }
+    }
+
+    // A failed COMMIT means nothing was written, so returning the ids here would
+    // report imported shots that do not exist. (The guard has already rolled
+    // back by this point, so nothing is left open on the connection.)
+    if (!txn.commit()) {
+        qWarning() << "ShotHistoryStorage: import commit failed for" << planned.size()
+                   << "shots -" << txn.commitError();
+        for (const Planned& p : std::as_const(planned))
+            results[p.index] = -1;
     }
+    return results;
+}
+
+qint64 ShotHistoryStorage::importShotRecordStatic(QSqlDatabase& db, const ShotRecord& record,
+                                                  bool overwriteExisting, int beginAttempts)
+{
+    return importShotRecordsStatic(db, QList<ShotRecord>{record}, overwriteExisting, beginAttempts)
+        .value(0, -1);
+}
 
+qint64 ShotHistoryStorage::insertImportedShotStatic(QSqlDatabase& db, const ShotRecord& record)
+{
     // Resolve the parsed grinder identity to an equipment package so the
     // imported shot keeps its grinder (the per-shot grinder_brand/model/burrs
     // columns are gone — migration 23; identity lives only on a package now).
@@ -5057,72 +5903,79 @@ qint64 ShotHistoryStorage::importShotRecordStatic(QSqlDatabase& db, const ShotRe
         }
     }
 
-    // Insert main shot record
-    query.prepare(R"(
+    const std::optional<QString> profileHash = storeProfileJsonStatic(db, record.profileJson);
+    if (!profileHash) return -1;
+
+    // Insert main shot record. No debug log: imported shots never carry one,
+    // so no shot_debug_logs row is written.
+    PreparedQuery query(db, QStringLiteral(R"(
         INSERT INTO shots (
-            uuid, timestamp, profile_name, profile_json, beverage_type,
+            uuid, timestamp, profile_name, profile_hash, beverage_type,
             duration_seconds, final_weight, dose_weight,
             bean_brand, bean_type, roast_date, roast_level,
             grinder_setting, equipment_id, rpm,
             drink_tds, drink_ey, enjoyment, espresso_notes, bean_notes, barista,
             taste_balance, taste_body,
             visualizer_id, visualizer_url,
-            profile_notes, debug_log,
+            profile_notes,
             temperature_override, yield_override, yield_mode, yield_anchor_value,
             profile_kb_id,
             channeling_detected, grind_issue_detected,
             skip_first_frame_detected, pour_truncated_detected
         ) VALUES (
-            :uuid, :timestamp, :profile_name, :profile_json, :beverage_type,
+            :uuid, :timestamp, :profile_name, :profile_hash, :beverage_type,
             :duration, :final_weight, :dose_weight,
             :bean_brand, :bean_type, :roast_date, :roast_level,
             :grinder_setting, :equipment_id, :rpm,
             :drink_tds, :drink_ey, :enjoyment, :espresso_notes, :bean_notes, :barista,
             :taste_balance, :taste_body,
             :visualizer_id, :visualizer_url,
-            :profile_notes, :debug_log,
+            :profile_notes,
             :temperature_override, :yield_override, :yield_mode, :yield_anchor_value,
             :profile_kb_id,
             :channeling_detected, :grind_issue_detected,
             :skip_first_frame_detected, :pour_truncated_detected
         )
-    )");
+    )"));
+    if (!query.ok()) {
+        qWarning() << "ShotHistoryStorage: Failed to prepare shot import:" << query->lastError().text();
+        return -1;
+    }
 
-    query.bindValue(":uuid", record.summary.uuid);
-    query.bindValue(":timestamp", record.summary.timestamp);
-    query.bindValue(":profile_name", record.summary.profileName);
-    query.bindValue(":profile_json", record.profileJson);
-    query.bindValue(":beverage_type", record.summary.beverageType.isEmpty() ? QStringLiteral("espresso") : record.summary.beverageType);
-    query.bindValue(":duration", record.summary.duration);
-    query.bindValue(":final_weight", record.summary.finalWeight);
-    query.bindValue(":dose_weight", record.summary.doseWeight);
-    query.bindValue(":bean_brand", record.summary.beanBrand);
-    query.bindValue(":bean_type", record.summary.beanType);
-    query.bindValue(":roast_date", record.roastDate);
-    query.bindValue(":roast_level", record.roastLevel);
+    query->bindValue(":uuid", record.summary.uuid);
+    query->bindValue(":timestamp", record.summary.timestamp);
+    query->bindValue(":profile_name", record.summary.profileName);
+    query->bindValue(":profile_hash", profileHash->isEmpty() ? QVariant() : *profileHash);
+    query->bindValue(":beverage_type", record.summary.beverageType.isEmpty() ? QStringLiteral("espresso") : record.summary.beverageType);
+    query->bindValue(":duration", record.summary.duration);
+    query->bindValue(":final_weight", record.summary.finalWeight);
+    query->bindValue(":dose_weight", record.summary.doseWeight);
+    query->bindValue(":bean_brand", record.summary.beanBrand);
+    query->bindValue(":bean_type", record.summary.beanType);
+    query->bindValue(":roast_date", record.roastDate);
+    query->bindValue(":roast_level", record.roastLevel);
     // Grinder identity is not snapshotted on the shot row (migration 23 dropped
     // the columns); it resolves via equipment_id to the package found/created
     // above from the parsed identity. The grind setting + rpm stay as per-shot
     // dial-in.
-    query.bindValue(":grinder_setting", record.grinderSetting);
-    query.bindValue(":equipment_id", importEquipmentId > 0 ? QVariant(importEquipmentId) : QVariant());
-    query.bindValue(":rpm", record.rpm > 0 ? QVariant(record.rpm) : QVariant());
-    query.bindValue(":drink_tds", record.drinkTds);
-    query.bindValue(":drink_ey", record.drinkEy);
-    query.bindValue(":enjoyment", record.summary.enjoyment);
-    query.bindValue(":espresso_notes", record.espressoNotes);
-    query.bindValue(":bean_notes", record.beanNotes);
-    query.bindValue(":barista", record.barista);
-    query.bindValue(":taste_balance", record.tasteBalance);
-    query.bindValue(":taste_body", record.tasteBody);
-    query.bindValue(":visualizer_id", record.visualizerId);
-    query.bindValue(":visualizer_url", record.visualizerUrl);
-    query.bindValue(":profile_notes", record.profileNotes);
-    query.bindValue(":debug_log", QString());  // No debug log for imported shots
+    query->bindValue(":grinder_setting", record.grinderSetting);
+    query->bindValue(":equipment_id", importEquipmentId > 0 ? QVariant(importEquipmentId) : QVariant());
+    query->bindValue(":rpm", record.rpm > 0 ? QVariant(record.rpm) : QVariant());
+    query->bindValue(":drink_tds", record.drinkTds);
+    query->bindValue(":drink_ey", record.drinkEy);
+    query->bindValue(":enjoyment", record.summary.enjoyment);
+    query->bindValue(":espresso_notes", record.espressoNotes);
+    query->bindValue(":bean_notes", record.beanNotes);
+    query->bindValue(":barista", record.barista);
+    query->bindValue(":taste_balance", record.tasteBalance);
+    query->bindValue(":taste_body", record.tasteBody);
+    query->bindValue(":visualizer_id", record.visualizerId);
+    query->bindValue(":visualizer_url", record.visualizerUrl);
+    query->bindValue(":profile_notes", record.profileNotes);
 
     // Bind overrides (always have values - user override or profile default)
-    query.bindValue(":temperature_override", record.temperatureOverride);
-    query.bindValue(":yield_override", record.targetWeight);
+    query->bindValue(":temperature_override", record.temperatureOverride);
+    query->bindValue(":yield_override", record.targetWeight);
     // Anchor provenance: a record that carries none (external-format imports
     // leave it empty) falls back to the migration-34 relabel of its target.
     {
@@ -5133,74 +5986,72 @@ qint64 ShotHistoryStorage::importShotRecordStatic(QSqlDatabase& db, const ShotRe
             mode = YieldSpec::modeAbsolute();
             anchor = record.targetWeight;
         }
-        query.bindValue(":yield_mode", mode);
-        query.bindValue(":yield_anchor_value", anchor > 0 ? QVariant(anchor) : QVariant());
+        query->bindValue(":yield_mode", mode);
+        query->bindValue(":yield_anchor_value", anchor > 0 ? QVariant(anchor) : QVariant());
     }
-    query.bindValue(":profile_kb_id", record.profileKbId.isEmpty() ? QVariant() : record.profileKbId);
-    query.bindValue(":channeling_detected", record.channelingDetected ? 1 : 0);
-    query.bindValue(":grind_issue_detected", record.grindIssueDetected ? 1 : 0);
-    query.bindValue(":skip_first_frame_detected", record.skipFirstFrameDetected ? 1 : 0);
-    query.bindValue(":pour_truncated_detected", record.pourTruncatedDetected ? 1 : 0);
-
-    if (!query.exec()) {
-        qWarning() << "ShotHistoryStorage: Failed to import shot:" << query.lastError().text();
+    query->bindValue(":profile_kb_id", record.profileKbId.isEmpty() ? QVariant() : record.profileKbId);
+    query->bindValue(":channeling_detected", record.channelingDetected ? 1 : 0);
+    query->bindValue(":grind_issue_detected", record.grindIssueDetected ? 1 : 0);
+    query->bindValue(":skip_first_frame_detected", record.skipFirstFrameDetected ? 1 : 0);
+    query->bindValue(":pour_truncated_detected", record.pourTruncatedDetected ? 1 : 0);
+
+    if (!query->exec()) {
+        qWarning() << "ShotHistoryStorage: Failed to import shot:" << query->lastError().text();
         return -1;
     }
 
-    qint64 shotId = query.lastInsertId().toLongLong();
-
-    // Compress and insert sample data
-    QJsonObject root;
-    root["pressure"] = pointsToJsonObject(record.pressure);
-    root["flow"] = pointsToJsonObject(record.flow);
-    root["temperature"] = pointsToJsonObject(record.temperature);
-    root["temperatureMix"] = pointsToJsonObject(record.temperatureMix);
-    root["resistance"] = pointsToJsonObject(record.resistance);
-    root["waterDispensed"] = pointsToJsonObject(record.waterDispensed);
-    root["pressureGoal"] = pointsToJsonObject(record.pressureGoal);
-    root["flowGoal"] = pointsToJsonObject(record.flowGoal);
-    root["temperatureGoal"] = pointsToJsonObject(record.temperatureGoal);
-    root["weight"] = pointsToJsonObject(record.weight);
-    root["weightFlowRate"] = pointsToJsonObject(record.weightFlowRate);
-
-    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Compact);
-    QByteArray compressedData = qCompress(json, 9);
+    const qint64 shotId = query->lastInsertId().toLongLong();
+
+    // Encode and insert sample data. The series set is the one imports have
+    // always stored: the derived curves are recomputed on load anyway, and
+    // an imported record carries no phase summaries.
+    using ShotSampleBlob::Series;
+    const QByteArray compressedData = ShotSampleBlob::encode({
+        {Series::Pressure, &record.pressure},
+        {Series::Flow, &record.flow},
+        {Series::Temperature, &record.temperature},
+        {Series::TemperatureMix, &record.temperatureMix},
+        {Series::Resistance, &record.resistance},
+        {Series::WaterDispensed, &record.waterDispensed},
+        {Series::PressureGoal, &record.pressureGoal},
+        {Series::FlowGoal, &record.flowGoal},
+        {Series::TemperatureGoal, &record.temperatureGoal},
+        {Series::Weight, &record.weight},
+        {Series::WeightFlowRate, &record.weightFlowRate},
+    });
     qsizetype sampleCount = record.pressure.size();
 
-    query.prepare("INSERT INTO shot_samples (shot_id, sample_count, data_blob) VALUES (:id, :count, :blob)");
-    query.bindValue(":id", shotId);
-    query.bindValue(":count", sampleCount);
-    query.bindValue(":blob", compressedData);
+    PreparedQuery samples(db, QStringLiteral(
+        "INSERT INTO shot_samples (shot_id, sample_count, data_blob) VALUES (:id, :count, :blob)"));
+    if (!samples.ok()) {
+        qWarning() << "ShotHistoryStorage: Failed to prepare imported samples:" << samples->lastError().text();
+        return -1;
+    }
+    samples->bindValue(":id", shotId);
+    samples->bindValue(":count", sampleCount);
+    samples->bindValue(":blob", compressedData);
 
-    if (!query.exec()) {
-        qWarning() << "ShotHistoryStorage: Failed to insert imported samples:" << query.lastError().text();
+    if (!samples->exec()) {
+        qWarning() << "ShotHistoryStorage: Failed to insert imported samples:" << samples->lastError().text();
         return -1;
     }
 
     // Insert phase markers
+    if (record.phases.isEmpty()) return shotId;
+    PreparedQuery phase(db, QStringLiteral(R"(
+        INSERT INTO shot_phases (shot_id, time_offset, label, frame_number, is_flow_mode, transition_reason)
+        VALUES (:shot_id, :time, :label, :frame, :flow_mode, :reason)
+    )"));
+    if (!phase.ok()) return shotId;  // Non-critical if markers fail
     for (const auto& marker : record.phases) {
-        query.prepare(R"(
-            INSERT INTO shot_phases (shot_id, time_offset, label, frame_number, is_flow_mode, transition_reason)
-            VALUES (:shot_id, :time, :label, :frame, :flow_mode, :reason)
-        )");
-        query.bindValue(":shot_id", shotId);
-        query.bindValue(":time", marker.time);
-        query.bindValue(":label", marker.label);
-        query.bindValue(":frame", marker.frameNumber);
-        query.bindValue(":flow_mode", marker.isFlowMode ? 1 : 0);
-        query.bindValue(":reason", marker.transitionReason);
-        query.exec();  // Non-critical if markers fail
-    }
-
-    // A failed COMMIT means nothing was written, so returning shotId here would
-    // report an imported shot that does not exist. (The guard has already rolled
-    // back by this point, so nothing is left open on the connection.)
-    if (!txn.commit()) {
-        qWarning() << "ShotHistoryStorage: import commit failed for" << record.summary.uuid
-                   << "-" << txn.commitError();
-        return -1;
+        phase->bindValue(":shot_id", shotId);
+        phase->bindValue(":time", marker.time);
+        phase->bindValue(":label", marker.label);
+        phase->bindValue(":frame", marker.frameNumber);
+        phase->bindValue(":flow_mode", marker.isFlowMode ? 1 : 0);
+        phase->bindValue(":reason", marker.transitionReason);
+        phase->exec();  // Non-critical if markers fail
     }
-
     return shotId;
 }
 
@@ -2,12 +2,15 @@
 
 #include "shothistory_types.h"
 #include "shotprojection.h"
+#include "shotsampleblob.h"
+#include "core/taskexecutor.h"
 
 #include <QObject>
 #include <QSqlDatabase>
 #include <QHash>
 #include <QSet>
 #include <QVariantList>
+#include <QJsonObject>
 #include <QDateTime>
 #include <atomic>
 #include <functional>
@@ -15,6 +18,7 @@
 #include <optional>
 
 #include <QtQml/qqmlregistration.h>
+class QSqlError;
 class QThread;
 class SerialDbWorker;
 
@@ -194,18 +198,59 @@ public:
                                                     const QString& roastLevel);
 
     // Static version for background-thread use — caller provides their own connection.
-    // Always recomputes the four quality badges from the loaded curve data and, when
-    // any recomputed flag differs from the stored column, issues an UPDATE on the same
+    // Derives the four quality badges from the shot's analysis — the stored one
+    // when shot_analysis holds a current row for these inputs, otherwise a fresh
+    // analyzeShot pass that is then stored (history/shotanalysiscache.h) — and,
+    // when any flag differs from the stored column, issues an UPDATE on the same
     // connection so the DB converges with the current detector logic. outBadgesPersisted
     // (when non-null) is set true when a write happened, false otherwise — used by
     // requestReanalyzeBadges to decide whether to emit shotBadgesUpdated.
+    //
+    // `series` narrows which curves are decoded (history/shotsampleblob.h);
+    // every scalar column is loaded regardless. A partial mask is a read-only
+    // load: the sample blob is never rewritten, and the badges are recomputed
+    // only when the mask covers ShotSampleBlob::kAnalysisSeries — otherwise the
+    // stored badge columns are returned as-is and cachedAnalysis stays empty,
+    // so a caller that goes on to convertShotRecord must include that set.
     static ShotRecord loadShotRecordStatic(QSqlDatabase& db, qint64 shotId,
-                                            bool* outBadgesPersisted = nullptr);
+                                            bool* outBadgesPersisted = nullptr,
+                                            ShotSampleBlob::SeriesMask series = ShotSampleBlob::kAllSeries);
+
+    // loadShotRecordStatic without its writes: what that load would persist
+    // comes back in `outRefresh` (nullptr to discard it) and the database is
+    // only read, so this is safe on any connection alongside other readers.
+    // The history re-analysis job runs it on the worker pool.
+    static ShotRecord readShotRecordStatic(QSqlDatabase& db, qint64 shotId,
+                                           ShotRecordRefresh* outRefresh,
+                                           ShotSampleBlob::SeriesMask series = ShotSampleBlob::kAllSeries);
+
+    // Writes `refresh` on `db`. The caller owns the transaction. Warns and
+    // returns false at the first failed statement; a refresh for a shot that
+    // has since been deleted writes nothing and succeeds.
+    static bool applyShotRecordRefreshStatic(QSqlDatabase& db, const ShotRecordRefresh& refresh);
+
+    // The two cold text blobs live outside `shots` (migration 39), so a scan of
+    // the hot table never pages them in. A profile is stored once per distinct
+    // JSON, keyed by profileJsonHash(); the shot row carries the hash in
+    // profile_hash. Both writers belong inside the caller's transaction, next
+    // to the shots INSERT they accompany.
+    //
+    // storeProfileJsonStatic returns the hash to bind into profile_hash — empty
+    // for an empty profile, which binds as NULL — or nullopt when the write
+    // failed (outError says why, so a save can tell a lock from a real error).
+    // storeDebugLogStatic writes nothing for an empty log: an absent row reads
+    // back as "" through the LEFT JOIN every reader uses.
+    static QString profileJsonHash(const QString& profileJson);
+    static std::optional<QString> storeProfileJsonStatic(QSqlDatabase& db, const QString& profileJson,
+                                                         QSqlError* outError = nullptr);
+    static bool storeDebugLogStatic(QSqlDatabase& db, qint64 shotId, const QString& debugLog,
+                                    QSqlError* outError = nullptr);
 
     // Compute resistance, conductance, Darcy resistance, and the conductance
-    // derivative from a shot's own raw pressure/flow data. Called
-    // unconditionally by decompressSampleData() on every load — these are
-    // pure functions of pressure/flow, not values to trust from storage. A
+    // derivative from a shot's own raw pressure/flow data. Called by
+    // decompressSampleData() whenever the stored curves are not stamped with
+    // the current Conductance::kAlgorithmVersion — these are pure functions of
+    // pressure/flow, trusted from storage only under a matching stamp. A
     // no-op below 3 samples (leaves whatever was already in `record`).
     static void computeDerivedCurves(ShotRecord& record);
 
@@ -243,6 +288,12 @@ public:
     // Safe to call from any thread (does not use m_db). Returns shotId or -1 on failure.
     static qint64 saveShotStatic(const QString& dbPath, const ShotSaveData& data);
 
+    // The CPU half of a save, run on the worker ahead of saveShotStatic():
+    // phase summaries, quality badges, then the compressed sample blob and
+    // sampleCount, all from `samples` — an immutable snapshot of the shot.
+    // Reads data.phaseMarkers and the profile fields; touches no QObject.
+    static void encodeShotSamples(ShotSaveData& data, const ShotSampleBuffer& samples);
+
     // Delete shot(s)
     Q_INVOKABLE void deleteShots(const QVariantList& shotIds);
 
@@ -290,8 +341,8 @@ public:
     // the renamed-profile case; see the caller in maincontroller.cpp.
     //
     // Bounded at `limit` rows with a small join. Deliberately NOT a DISTINCT over the whole
-    // table: `shots` carries debug_log and profile_json blobs, so a full scan drags those
-    // pages along (see the cost note on queryDistinctList). The window means a profile
+    // table: a full scan of `shots` pages through every row, and its cost grows with the
+    // history (see the cost note on queryDistinctList). The window means a profile
     // untouched for `limit` shots is treated as untried.
     Q_INVOKABLE void requestRecentProfileBasketPairs(int limit = 500);
 
@@ -360,15 +411,40 @@ public:
     // The standard QML detail-page flow does NOT need to call this: requestShot already
     // routes through loadShotRecordStatic, which persists drift on the same connection
     // and lets requestShot itself emit shotBadgesUpdated. This entry point exists for
-    // any explicit "re-evaluate this one shot" use case (e.g., a future bulk-resweep UI).
+    // any explicit "re-evaluate this one shot" use case; the whole history is
+    // requestHistoryReanalysis()'s job.
     Q_INVOKABLE void requestReanalyzeBadges(qint64 shotId);
 
+    // Async maintenance job: re-analyses every shot whose derived curves or
+    // stored analysis predate the current algorithm (Conductance::kAlgorithmVersion,
+    // ShotAnalysis::ALGORITHM_VERSION), so badge filters over the whole history
+    // are right without waiting for each shot to be opened.
+    //
+    // Streams shot ids newest first in batches. Each batch is read and analysed
+    // in parallel on the TaskExecutor Maintenance lane (readShotRecordStatic),
+    // then written in one transaction on the FIFO worker — together with the
+    // checkpoint, so a restart resumes at the last committed batch rather than
+    // the top. Interactive work queued on the worker runs between batches.
+    //
+    // Emits historyReanalysisProgress after every batch, shotBadgesUpdated for
+    // every shot whose badges changed, and historyReanalysisFinished once. A
+    // call while the job is running is a no-op. initialize() starts it on every
+    // launch; under an unchanged algorithm it finds nothing to do.
+    Q_INVOKABLE void requestHistoryReanalysis();
+    // Stops the job after the batch in flight; that batch is discarded, not
+    // written, and the checkpoint stays at the last one that was.
+    Q_INVOKABLE void cancelHistoryReanalysis();
+    // {state: idle|running|cancelling, done, total, badgesChanged,
+    //  lastResult: ""|completed|cancelled|failed} — served by the
+    // shots_reanalyze MCP tool and /api/shots/reanalysis.
+    QJsonObject historyReanalysisStatus() const;
+
     // Import a shot record directly (for .shot file import).
     // Returns: shot ID on success, 0 if duplicate (skipped), -1 on error.
     // If overwriteExisting is true, duplicates will be replaced instead of skipped.
-    // SYNCHRONOUS DB I/O on the caller's thread — call only from the main thread
-    // (the .shot batch importer does; see ShotImporter). Off-thread callers use
-    // importShotRecordAsync instead.
+    // SYNCHRONOUS DB I/O on the caller's thread — kept for tests and one-off
+    // callers; the app's importers use importShotRecordAsync or
+    // importShotRecordsAsync instead.
     qint64 importShotRecord(const ShotRecord& record, bool overwriteExisting = false);
 
     // Async variant: runs the insert on the shared serial DB worker thread (its
@@ -381,6 +457,14 @@ public:
     void importShotRecordAsync(const ShotRecord& record, bool overwriteExisting,
                                std::function<void(qint64 resultCode)> onDone);
 
+    // Batch variant for bulk imports (ShotImporter): the list is deduped with
+    // one set query per key and written in a single transaction on the serial
+    // DB worker. `onDone` gets one result code per record, in input order, with
+    // the meanings above. A record that fails rolls back alone; a duplicate
+    // within the list itself is skipped, the first occurrence winning.
+    void importShotRecordsAsync(const QList<ShotRecord>& records, bool overwriteExisting,
+                                std::function<void(const QList<qint64>& resultCodes)> onDone);
+
     // Refresh the total shots count (call after bulk import)
     Q_INVOKABLE void refreshTotalShots();
 
@@ -439,6 +523,14 @@ public:
     // so their isDbWorkIdle() is already write-only.
     bool isDbWriteWorkIdle() const;
 
+    // Blocks until the write worker has run what is queued and closed its pooled
+    // connection to the file (see DbConnectionPool in core/dbutils.h). An idle
+    // worker otherwise keeps shots.db open for a few seconds after its last task,
+    // which a factory reset deleting the file cannot allow. Detached threads are
+    // not pooled and hold the file only while they run — isDbWorkIdle() covers
+    // those.
+    void releaseDbConnections();
+
     // Checkpoint WAL to main database file
     void checkpoint();
 
@@ -589,6 +681,12 @@ signals:
     void mostRecentShotIdReady(qint64 shotId);
     void recentProfileBasketPairsReady(const QVariantList& pairs);
     void shotBadgesUpdated(qint64 shotId, bool channelingDetected, bool grindIssueDetected, bool skipFirstFrameDetected, bool pourTruncatedDetected);
+    // `done` of `total` shots re-analysed in this job, counting from its first
+    // run when it resumed from a checkpoint.
+    void historyReanalysisProgress(int done, int total);
+    // `completed` is false when the job was cancelled or a batch failed to
+    // commit; `reanalyzed` counts shots this run wrote, not a resumed total.
+    void historyReanalysisFinished(bool completed, int reanalyzed);
 
 private:
     // Post shot-CRUD background work onto a single FIFO worker thread, so two
@@ -596,18 +694,18 @@ private:
     // order (a fresh-thread-per-request scheme lets the OS scheduler reorder
     // them — see SerialDbWorker). `task` opens its own withTempDb connection and
     // marshals results back to the main thread itself. Heavy one-shot ops
-    // (backup/import) deliberately stay on their own threads.
+    // (backup/import) deliberately go through runDetachedDbThread instead.
     void runOnDbThread(std::function<void()> task);
 
-    // Run `body` on a one-shot background thread for a read query that does NOT
-    // need the FIFO ordering runOnDbThread() provides (and for the two heavy
-    // one-shot ops, backup and import). The thread deletes itself when it
-    // finishes and is counted, so isDbWorkIdle() covers it.
+    // Run `body` as a TaskExecutor task for a read query that does NOT need the
+    // FIFO ordering runOnDbThread() provides (and, on the Maintenance lane, for
+    // the two heavy one-shot ops, backup and import). Counted, so
+    // isDbWorkIdle() covers it until the task and its captures are gone.
     //
-    // ALWAYS spawn through this, never a bare QThread::create — that boilerplate
-    // was hand-copied at eleven sites, none of which was counted, and one of which
-    // had already drifted to calling start() before the deleteLater connect.
-    void runDetachedDbThread(std::function<void()> body);
+    // ALWAYS submit through this rather than TaskExecutor directly — the old
+    // QThread::create boilerplate was hand-copied at eleven sites, none of which
+    // was counted.
+    void runDetachedDbThread(std::function<void()> body, TaskLane lane = TaskLane::Interactive);
 
     // One-shot startup census of which grinder each shot is attributed to, and
     // how much numeric dial history that grinder actually has. Log only — it
@@ -635,6 +733,15 @@ private:
     // writes nothing.
     void logGrinderCensus();
 
+    // The stages of requestHistoryReanalysis(), each on the main thread and
+    // each handing the next its input. The descending cursor, not the
+    // staleness predicate, is what ends the job — a shot that can't be brought
+    // current (an unreadable blob) would otherwise be selected again forever.
+    void selectReanalysisBatch();
+    void analyseReanalysisBatch(const QList<qint64>& ids);
+    void commitReanalysisBatch(const QList<ShotRecordRefresh>& refreshes, qint64 nextBeforeId);
+    void finishHistoryReanalysis(const QString& result);
+
     bool createTables();
     bool runMigrations();
     // Version-independent merge-import of legacy bean/presets QSettings into
@@ -642,12 +749,30 @@ private:
     // migrations; clears the legacy keys only after a successful commit.
     void importLegacyBeanPresets();
     QByteArray compressSampleData(ShotDataModel* shotData, const QString& phaseSummariesJson = QString());
-    // outCorrectedBlob (when non-null): set to a recompressed blob when the
-    // recomputed derived curves differ from what was stored, left empty
-    // (cleared) otherwise. Callers on a DB connection use this to self-heal
-    // shot_samples.data_blob — see loadShotRecordStatic.
-    static void decompressSampleData(const QByteArray& blob, ShotRecord* record,
-                                      QByteArray* outCorrectedBlob = nullptr);
+    // Encodes straight from the buffer's columns — no per-series copy.
+    static QByteArray compressSampleData(const ShotSampleBuffer& samples,
+                                         const QString& phaseSummariesJson = QString());
+    // Decodes either blob format (history/shotsampleblob.h).
+    // outCorrectedBlob (when non-null): set to a re-encoded binary blob when the
+    // recomputed derived curves differ from what was stored OR the blob was in
+    // the legacy JSON format, left empty (cleared) otherwise. Callers on a DB
+    // connection use this to self-heal shot_samples.data_blob — see
+    // loadShotRecordStatic. outCurvesChanged separates the two reasons: only a
+    // curve change alters anything downstream of the blob. A partial `series`
+    // mask decodes and derives only those curves and never reports a
+    // correction (see the definition).
+    //
+    // storedDerivedCurrent: the row's derived_version matches
+    // Conductance::kAlgorithmVersion, so a binary blob's derived curves are
+    // decoded as stored instead of recomputed and compared. Returns true when
+    // the derived curves in `record` are the current algorithm's — trusted or
+    // just recomputed — and false for an unreadable blob or a partial mask
+    // that asked for none of them.
+    static bool decompressSampleData(const QByteArray& blob, ShotRecord* record,
+                                      QByteArray* outCorrectedBlob = nullptr,
+                                      bool* outCurvesChanged = nullptr,
+                                      ShotSampleBlob::SeriesMask series = ShotSampleBlob::kAllSeries,
+                                      bool storedDerivedCurrent = false);
     void updateTotalShots();
     QString buildFilterQuery(const ShotFilter& filter, QVariantList& bindValues);
     ShotFilter parseFilterMap(const QVariantMap& filterMap);
@@ -673,17 +798,23 @@ private:
     QStringList getDistinctGrinderSettings();
     // Helper to apply smart sorting for grinder settings
     void sortGrinderSettings(QStringList& settings);
-    // Connection-parameterised core of importShotRecord, so the import logic can
-    // run on either the main-thread m_db (importShotRecord) or a background
-    // withTempDb connection (importShotRecordAsync) from one implementation.
-    // deleteShotStatic is the internal row delete used by the overwrite path.
+    // Connection-parameterised core of the import entry points, so the import
+    // logic can run on either the main-thread m_db (importShotRecord) or a
+    // background withTempDb connection (importShotRecordAsync,
+    // importShotRecordsAsync) from one implementation. importShotRecordStatic
+    // is the one-record batch. insertImportedShotStatic writes a single shot
+    // inside the caller's transaction and returns its id, or -1. deleteShotStatic
+    // is the internal row delete used by the overwrite path.
     //
     // beginAttempts is passed through to DbWriteTxn::begin. It defaults to the
     // guard's own default for the background path; importShotRecord passes 1
     // because it runs on the GUI thread, where each extra attempt can spend the
     // full busy_timeout blocking the UI (see the COST note on DbWriteTxn).
+    static QList<qint64> importShotRecordsStatic(QSqlDatabase& db, const QList<ShotRecord>& records,
+                                                 bool overwriteExisting, int beginAttempts = 2);
     static qint64 importShotRecordStatic(QSqlDatabase& db, const ShotRecord& record,
                                          bool overwriteExisting, int beginAttempts = 2);
+    static qint64 insertImportedShotStatic(QSqlDatabase& db, const ShotRecord& record);
     // [[nodiscard]]: dropping this return let a failed delete fall through to the
     // INSERT, which then either duplicated the shot the import meant to replace
     // or failed on the uuid constraint and blamed the wrong thing. With
@@ -694,9 +825,6 @@ private:
     // Backfill beverage_type from profile_json for existing rows
     void backfillBeverageType();
 
-    // Helper for converting QVector<QPointF> to JSON object with t/v arrays
-    static QJsonObject pointsToJsonObject(const QVector<QPointF>& points);
-
     // Core backup helper: checkpoint + close + copy + reopen
     // Returns true on success, false on failure
     bool performDatabaseCopy(const QString& destPath);
@@ -714,6 +842,19 @@ private:
     std::atomic<bool> m_backupInProgress{false};  // Prevent concurrent backup/export operations (thread-safe)
     std::atomic<bool> m_importInProgress{false};   // Prevent concurrent import/restore operations (thread-safe)
 
+    // requestHistoryReanalysis() state. Main thread only; the stages carry
+    // what their worker halves need by value.
+    struct Reanalysis {
+        bool running = false;
+        CancellationToken cancel;
+        qint64 beforeId = 0;    // next batch: ids below this
+        int done = 0;           // including a resumed run's earlier progress
+        int total = 0;
+        int written = 0;        // this run only
+        int badgesChanged = 0;
+        QString lastResult;
+    } m_reanalysis;
+
     // Deduped narration of what grindStepForGrinder() derived — see its definition.
     // Why a derivation answered what it did. All three non-derived outcomes
     // return the SAME 0.0, so a log that does not name them cannot tell a broken
@@ -770,5 +911,8 @@ public:
     // Exercises the sample-blob round-trip directly (compressSampleData /
     // decompressSampleData) without standing up a database.
     friend class tst_SampleBlobSeries;
+    // Checks that encoding from a ShotSampleBuffer's column views matches
+    // encoding the same series as point vectors, byte for byte.
+    friend class tst_ShotSampleBuffer;
 #endif
 };
@@ -106,6 +106,9 @@ QString likeAllTermsLiteral(const QString& expr, const QString& in)
 // Measured live on a real 18.5 MB / 1,124-shot database, fresh connection per
 // run: 0.36-1.9 ms per column, 4.66 ms for all six. On a 16x copy (157 MB):
 // 1.6-17 ms per column. Each getter is called when a dialog or picker opens.
+// Migration 39 moved debug_log and profile_json out of `shots`, which cut the
+// columns that scan the table (no covering index) by a third to a half — e.g.
+// baristas 9.3 -> 6.0 ms on a synthetic 4,400-shot / 91 MB history.
 QStringList ShotHistoryStorage::queryDistinctList(const QString& sql, const QVariantList& binds)
 {
     if (!m_ready)
@@ -177,7 +180,7 @@ ShotFilter ShotHistoryStorage::parseFilterMap(const QVariantMap& filterMap)
 
 // EVERY column here is qualified `shots.`, and new ones must be too. The data
 // query this feeds now reads `FROM shots LEFT JOIN recipes r` (history-recipe-
-// identity), and the two tables collide on TEN names. SQLite
+// identity), and the two tables collide on NINE names. SQLite
 // rejects an ambiguous bare name outright ("ambiguous column name"), so the
 // failure is loud — but it lands at runtime, not at compile time, and only for
 // the filters that happen to name a colliding column.
@@ -702,11 +705,12 @@ QVariantList ShotHistoryStorage::loadRecentShotsByKbIdStatic(QSqlDatabase& db, c
                eg.brand AS grinder_brand, eg.model AS grinder_model,
                json_extract(eg.attrs, '$.burrs') AS grinder_burrs,
                s.grinder_setting, s.drink_tds, s.drink_ey, s.enjoyment,
-               s.espresso_notes, s.roast_date, s.temperature_override, s.yield_override, s.profile_json, s.beverage_type,
+               s.espresso_notes, s.roast_date, s.temperature_override, s.yield_override, sp.profile_json, s.beverage_type,
                s.stopped_by,
                s.frozen_date, s.defrost_date, s.storage_hint, s.opened_date
         FROM shots s
         LEFT JOIN equipment_items eg ON eg.package_id = s.equipment_id AND eg.kind = 'grinder'
+        LEFT JOIN shot_profiles sp ON sp.hash = s.profile_hash
         WHERE s.profile_kb_id = ?
     )");
     if (excludeShotId >= 0)
@@ -1152,8 +1156,8 @@ static double deriveGrindStep(const QList<double>& sortedDistinct)
 // a real 1,124-shot / 18.5 MB database; 37 ms median / 41 ms worst on a 16x copy
 // (17,984 shots / 157 MB). The more expensive of the two read shapes in this file
 // — a correlated equipment_id IN (SELECT ...) subquery over `shots`, whose cost
-// tracks table BYTES because a page read drags the profile_json and debug_log
-// blobs along. Two call paths reach it, and the frequency argument has to cover
+// tracks table BYTES. (Those figures predate migration 39, when every page read
+// still dragged the profile_json and debug_log blobs along.) Two call paths reach it, and the frequency argument has to cover
 // both: GrindRowSource.grindStep() and the ShotServer's grind-candidates
 // endpoint build a picker's rows, while queryGrinderContext (below) builds the
 // AI dialing/advisor context. Neither is per frame, per keystroke, or a binding.
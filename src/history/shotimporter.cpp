@@ -3,7 +3,6 @@
 #include "shotfileparser.h"
 #include <QDir>
 #include <QDirIterator>
-#include <QTimer>
 #include <QCoreApplication>
 #include <QDebug>
 #include <QFile>
@@ -11,6 +10,8 @@
 #include <QUrl>
 #include <private/qzipreader_p.h>
 
+#include <vector>
+
 #ifdef Q_OS_ANDROID
 #include <QJniObject>
 #include <QJniEnvironment>
@@ -22,8 +23,20 @@ ShotImporter::ShotImporter(ShotHistoryStorage* storage, QObject* parent)
 {
 }
 
+namespace {
+
+// Files parsed, then written in one transaction, per pipeline step. Large
+// enough that the per-transaction fsync is amortised over many shots, small
+// enough that the chunk being written plus the one parsing behind it stay a
+// few MB of curves.
+constexpr qsizetype kImportChunkSize = 64;
+
+} // namespace
+
 ShotImporter::~ShotImporter()
 {
+    *m_destroyed = true;
+    m_cancelToken.cancel();
     delete m_tempDir;
 }
 
@@ -60,30 +73,40 @@ void ShotImporter::importFromZip(const QString& zipPath, bool overwriteExisting)
 
 void ShotImporter::performZipExtraction()
 {
-    // Extract zip to temp directory
-    bool extractSuccess = extractZip(m_pendingZipPath, m_tempDir->path());
-
-    m_extracting = false;
-    emit isExtractingChanged();
-
-    if (!extractSuccess) {
-        m_importing = false;
-        emit isImportingChanged();
-        emit importError("shotimporter.error.zipExtract", "Failed to extract ZIP archive. The file may be corrupted or not a valid ZIP.");
-        return;
-    }
-
-    // Find all .shot files
-    QStringList shotFiles = findShotFiles(m_tempDir->path());
+    // Extraction inflates and writes every file of the archive — seconds for a
+    // large history — so it runs on a worker, and the main thread only hears
+    // back with the list of .shot files it produced.
+    const QString zipPath = m_pendingZipPath;
+    const QString destDir = m_tempDir->path();
+    auto destroyed = m_destroyed;
+    TaskExecutor::instance().submit(TaskLane::Background, [this, zipPath, destDir, destroyed]() {
+        const bool extractSuccess = extractZip(zipPath, destDir);
+        const QStringList shotFiles = extractSuccess ? findShotFiles(destDir) : QStringList();
+
+        if (*destroyed) return;
+        QMetaObject::invokeMethod(this, [this, extractSuccess, shotFiles, destroyed]() {
+            if (*destroyed) return;
+            m_extracting = false;
+            emit isExtractingChanged();
+
+            if (!extractSuccess) {
+                m_importing = false;
+                emit isImportingChanged();
+                emit importError("shotimporter.error.zipExtract", "Failed to extract ZIP archive. The file may be corrupted or not a valid ZIP.");
+                return;
+            }
 
-    if (shotFiles.isEmpty()) {
-        m_importing = false;
-        emit isImportingChanged();
-        emit importError("shotimporter.error.noShotsInArchive", "No .shot files found in archive");
-        return;
-    }
+            if (shotFiles.isEmpty()) {
+                m_importing = false;
+                emit isImportingChanged();
+                emit importError("shotimporter.error.noShotsInArchive", "No .shot files found in archive");
+                return;
+            }
 
-    startImport(shotFiles, m_overwriteExisting);
+            // A cancel during extraction is honoured by the pipeline's first step.
+            startImport(shotFiles, m_overwriteExisting);
+        }, Qt::QueuedConnection);
+    });
 }
 
 void ShotImporter::importFromDirectory(const QString& dirPath, bool overwriteExisting)
@@ -168,7 +191,11 @@ void ShotImporter::importFromDE1App(bool overwriteExisting)
 
 void ShotImporter::cancel()
 {
+    // In-flight stages see the token and wind down; the last one to finish
+    // completes the import. A chunk already being written commits or rolls
+    // back whole.
     m_cancelled = true;
+    m_cancelToken.cancel();
     setStatus("Cancelling...");
 }
 
@@ -456,83 +483,154 @@ void ShotImporter::startImport(const QStringList& files, bool overwriteExisting)
     m_importedFiles = 0;
     m_skippedFiles = 0;
     m_failedFiles = 0;
+    m_nextFile = 0;
+    m_parsing = false;
+    m_writing = false;
+    m_parsedChunks.clear();
+    m_cancelToken = CancellationToken::create();
+    if (m_cancelled) m_cancelToken.cancel();
 
     setStatus(QString("Importing %1 shots...").arg(m_totalFiles));
     emit progressChanged();
 
-    // Process files in batches using timer to keep UI responsive
-    QTimer::singleShot(0, this, &ShotImporter::onProcessNextFile);
+    pumpPipeline();
 }
 
-void ShotImporter::onProcessNextFile()
+void ShotImporter::pumpPipeline()
 {
-    if (m_cancelled || m_pendingFiles.isEmpty()) {
-        // Import complete or cancelled
-        m_importing = false;
-        emit isImportingChanged();
-
-        // Refresh the total shots count
-        if (m_storage) {
-            m_storage->refreshTotalShots();
-        }
+    if (m_cancelled) {
+        // Parsed but not yet written: dropped, like the files never reached.
+        m_parsedChunks.clear();
+        if (!m_parsing && !m_writing) finishImport();
+        return;
+    }
 
-        if (m_cancelled) {
-            setStatus("Import cancelled");
-        } else {
-            setStatus(QString("Complete: %1 imported, %2 skipped, %3 failed")
-                .arg(m_importedFiles).arg(m_skippedFiles).arg(m_failedFiles));
-        }
+    if (!m_writing && !m_parsedChunks.isEmpty())
+        writeChunk(m_parsedChunks.takeFirst());
 
-        emit importComplete(m_importedFiles, m_skippedFiles, m_failedFiles);
+    // Parse one chunk ahead of the writer and no further: the writer is the
+    // slower stage, and every parsed chunk waiting for it holds its curves.
+    if (!m_parsing && m_parsedChunks.isEmpty() && m_nextFile < m_pendingFiles.size())
+        parseNextChunk();
+
+    if (!m_parsing && !m_writing && m_parsedChunks.isEmpty() && m_nextFile >= m_pendingFiles.size())
+        finishImport();
+}
 
-        // Clean up temp dir
-        delete m_tempDir;
-        m_tempDir = nullptr;
+void ShotImporter::parseNextChunk()
+{
+    const QStringList files = m_pendingFiles.mid(m_nextFile, kImportChunkSize);
+    m_nextFile += files.size();
+    m_parsing = true;
+
+    m_currentFile = QFileInfo(files.first()).fileName();
+    emit currentFileChanged();
+
+    // One pool task per file; the last one to finish hands the chunk, in file
+    // order, back to the main thread. A std::vector because every task writes
+    // its own slot concurrently, and QList's non-const operator[] would check
+    // for a detach on each.
+    struct Chunk {
+        std::vector<ShotFileParser::ParseResult> results;
+        std::atomic<int> pending;
+        explicit Chunk(qsizetype n) : results(size_t(n)), pending(int(n)) {}
+    };
+    auto chunk = std::make_shared<Chunk>(files.size());
+    const CancellationToken cancel = m_cancelToken;
+    auto destroyed = m_destroyed;
+
+    for (qsizetype i = 0; i < files.size(); ++i) {
+        // The token is checked here rather than handed to the executor: a task
+        // the executor drops never counts down, and the chunk would never end.
+        TaskExecutor::instance().submit(TaskLane::Background, [this, files, i, chunk, cancel, destroyed]() {
+            if (!cancel.isCancelled())
+                chunk->results[size_t(i)] = ShotFileParser::parseFile(files[i]);
+            if (chunk->pending.fetch_sub(1, std::memory_order_acq_rel) != 1 || *destroyed) return;
+
+            QMetaObject::invokeMethod(this, [this, files, chunk, destroyed]() {
+                if (*destroyed) return;
+                m_parsing = false;
+                if (!m_cancelled) {
+                    QList<ShotRecord> records;
+                    records.reserve(files.size());
+                    for (qsizetype j = 0; j < files.size(); ++j) {
+                        ShotFileParser::ParseResult& result = chunk->results[size_t(j)];
+                        if (result.success) {
+                            records.append(std::move(result.record));
+                        } else {
+                            qWarning() << "Failed to parse" << QFileInfo(files[j]).fileName()
+                                       << ":" << result.errorMessage;
+                            m_failedFiles++;
+                            m_processedFiles++;
+                        }
+                    }
+                    emit progressChanged();
+                    if (!records.isEmpty())
+                        m_parsedChunks.append(records);
+                }
+                pumpPipeline();
+            }, Qt::QueuedConnection);
+        });
+    }
+}
 
+void ShotImporter::writeChunk(const QList<ShotRecord>& records)
+{
+    if (!m_storage) {
+        m_failedFiles += static_cast<int>(records.size());
+        m_processedFiles += static_cast<int>(records.size());
+        emit progressChanged();
         return;
     }
 
-    // Process a batch of files
-    int batchSize = 10;  // Process 10 files per timer tick
-    for (int i = 0; i < batchSize && !m_pendingFiles.isEmpty() && !m_cancelled; ++i) {
-        QString filePath = m_pendingFiles.takeFirst();
-        QString filename = QFileInfo(filePath).fileName();
+    m_writing = true;
+    auto destroyed = m_destroyed;
+    m_storage->importShotRecordsAsync(records, m_overwriteExisting,
+        [this, destroyed](const QList<qint64>& resultCodes) {
+            if (*destroyed) return;
+            m_writing = false;
+            for (const qint64 shotId : resultCodes) {
+                if (shotId > 0) {
+                    m_importedFiles++;
+                } else if (shotId == 0) {
+                    m_skippedFiles++;  // Duplicate
+                } else {
+                    m_failedFiles++;  // Database error
+                }
+            }
+            m_processedFiles += static_cast<int>(resultCodes.size());
+            emit progressChanged();
+            if (!m_cancelled)
+                setStatus(QString("Importing... %1/%2").arg(m_processedFiles).arg(m_totalFiles));
+            pumpPipeline();
+        });
+}
 
-        m_currentFile = filename;
-        emit currentFileChanged();
+void ShotImporter::finishImport()
+{
+    m_importing = false;
+    emit isImportingChanged();
 
-        // Parse the file
-        ShotFileParser::ParseResult result = ShotFileParser::parseFile(filePath);
+    // Refresh the total shots count
+    if (m_storage) {
+        m_storage->refreshTotalShots();
+    }
 
-        if (!result.success) {
-            qWarning() << "Failed to parse" << filename << ":" << result.errorMessage;
-            m_failedFiles++;
-        } else {
-            // TODO: importShotRecord() runs synchronously on the main thread via
-            // QTimer::singleShot batching. Should be moved to a background thread
-            // with batch processing to comply with the "no DB I/O on main thread" rule.
-            qint64 shotId = m_storage->importShotRecord(result.record, m_overwriteExisting);
-
-            if (shotId > 0) {
-                m_importedFiles++;
-            } else if (shotId == 0) {
-                m_skippedFiles++;  // Duplicate
-            } else {
-                m_failedFiles++;  // Database error
-            }
-        }
+    if (m_cancelled) {
+        setStatus("Import cancelled");
+    } else {
+        setStatus(QString("Complete: %1 imported, %2 skipped, %3 failed")
+            .arg(m_importedFiles).arg(m_skippedFiles).arg(m_failedFiles));
+    }
 
-        m_processedFiles++;
-        emit progressChanged();
+    emit importComplete(m_importedFiles, m_skippedFiles, m_failedFiles);
 
-        // Update status periodically
-        if (m_processedFiles % 50 == 0) {
-            setStatus(QString("Importing... %1/%2").arg(m_processedFiles).arg(m_totalFiles));
-        }
-    }
+    m_pendingFiles.clear();
+    m_nextFile = 0;
 
-    // Schedule next batch
-    QTimer::singleShot(0, this, &ShotImporter::onProcessNextFile);
+    // Clean up temp dir
+    delete m_tempDir;
+    m_tempDir = nullptr;
 }
 
 void ShotImporter::setStatus(const QString& message)
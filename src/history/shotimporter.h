@@ -7,6 +7,13 @@
 #include <QTemporaryDir>
 
 #include <QtQml/qqmlregistration.h>
+
+#include <atomic>
+#include <memory>
+
+#include "core/taskexecutor.h"
+#include "shothistory_types.h"
+
 class ShotHistoryStorage;
 
 /**
@@ -16,6 +23,12 @@ class ShotHistoryStorage;
  * - Single .shot files
  * - Directories containing .shot files
  * - ZIP archives containing .shot files
+ *
+ * Runs as a pipeline so a several-thousand-shot history never blocks the UI:
+ * the archive is extracted on a TaskExecutor worker, files are parsed in
+ * chunks on the Background lane (one task per file), and each parsed chunk is
+ * deduped and written in one transaction by the storage's serial DB worker
+ * (importShotRecordsAsync) while the next chunk parses.
  */
 class ShotImporter : public QObject {
     Q_OBJECT
@@ -73,18 +86,25 @@ signals:
     void importError(const QString& translationKey, const QString& fallbackMessage);
 
 private slots:
-    void onProcessNextFile();
     void performZipExtraction();
 
 private:
-    bool extractZip(const QString& zipPath, const QString& destDir);
+    // Static: they run on a worker thread and touch no member state.
+    static bool extractZip(const QString& zipPath, const QString& destDir);
 #ifdef Q_OS_ANDROID
-    bool extractZipFromContentUri(const QString& contentUri, const QString& destDir);
+    static bool extractZipFromContentUri(const QString& contentUri, const QString& destDir);
 #endif
-    QStringList findShotFiles(const QString& dirPath);
+    static QStringList findShotFiles(const QString& dirPath);
     void startImport(const QStringList& files, bool overwriteExisting);
     void setStatus(const QString& message);
 
+    // Pipeline stages, all entered on the main thread. pumpPipeline() starts
+    // whatever stage is free and finishes the import once nothing is left.
+    void pumpPipeline();
+    void parseNextChunk();
+    void writeChunk(const QList<ShotRecord>& records);
+    void finishImport();
+
     QString m_pendingZipPath;
 
     ShotHistoryStorage* m_storage;
@@ -103,4 +123,11 @@ private:
     QString m_statusMessage;
 
     QStringList m_pendingFiles;
+    qsizetype m_nextFile = 0;           // first file of m_pendingFiles not yet parsing
+    bool m_parsing = false;
+    bool m_writing = false;
+    QList<QList<ShotRecord>> m_parsedChunks;  // parsed, waiting for the writer
+    CancellationToken m_cancelToken;
+
+    std::shared_ptr<std::atomic<bool>> m_destroyed = std::make_shared<std::atomic<bool>>(false);
 };
@@ -0,0 +1,491 @@
+#include "shotsampleblob.h"
+
+#include "shothistory_types.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtEndian>
+
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace ShotSampleBlob {
+
+namespace {
+
+constexpr char kMagic[4] = {'D', 'Z', 'S', 'B'};
+constexpr quint8 kVersion = 1;
+constexpr int kHeaderSize = 16;
+constexpr int kColumnEntrySize = 16;
+constexpr int kSeriesEntrySize = 4;
+
+enum class Encoding : quint8 {
+    FixedDecimal = 0,  // value = q / 10^exponent
+    FixedBinary = 1,   // value = q * 2^-exponent
+    Float32 = 2,
+    Float64 = 3,
+};
+constexpr quint8 kFlagDeflated = 0x01;
+
+constexpr double kPow10[] = {1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0};
+constexpr int kMaxDecimalExponent = 6;
+constexpr int kMaxBinaryExponent = 24;
+// 2^53: past this a quantized integer no longer fits a double's mantissa, so
+// "round-trips exactly" stops meaning anything.
+constexpr double kMaxFixedMagnitude = 9007199254740992.0;
+
+// One row per series: its on-disk id, its legacy JSON key and the ShotRecord
+// field it decodes into. Table-driven so a series added later is a one-line
+// change here rather than an edit to the encoder, both decoders and the
+// record encoder in step.
+struct SeriesField {
+    Series id;
+    const char* legacyKey;
+    QVector<QPointF> ShotRecord::* field;
+};
+
+constexpr SeriesField kFields[] = {
+    {Series::Pressure, "pressure", &ShotRecord::pressure},
+    {Series::Flow, "flow", &ShotRecord::flow},
+    {Series::Temperature, "temperature", &ShotRecord::temperature},
+    {Series::TemperatureMix, "temperatureMix", &ShotRecord::temperatureMix},
+    {Series::PressureGoal, "pressureGoal", &ShotRecord::pressureGoal},
+    {Series::FlowGoal, "flowGoal", &ShotRecord::flowGoal},
+    {Series::TemperatureGoal, "temperatureGoal", &ShotRecord::temperatureGoal},
+    {Series::TemperatureMixGoal, "temperatureMixGoal", &ShotRecord::temperatureMixGoal},
+    {Series::Resistance, "resistance", &ShotRecord::resistance},
+    {Series::Conductance, "conductance", &ShotRecord::conductance},
+    {Series::DarcyResistance, "darcyResistance", &ShotRecord::darcyResistance},
+    {Series::ConductanceDerivative, "conductanceDerivative", &ShotRecord::conductanceDerivative},
+    {Series::WaterDispensed, "waterDispensed", &ShotRecord::waterDispensed},
+    {Series::Weight, "weight", &ShotRecord::weight},
+    {Series::WeightFlowRate, "weightFlowRate", &ShotRecord::weightFlowRate},
+};
+
+const SeriesField* fieldFor(quint8 id)
+{
+    for (const auto& f : kFields) {
+        if (static_cast<quint8>(f.id) == id) return &f;
+    }
+    return nullptr;  // a series id from a newer build — skipped, not an error
+}
+
+struct Column {
+    Encoding encoding = Encoding::Float64;
+    qint8 exponent = 0;
+    quint8 flags = 0;
+    quint32 count = 0;
+    QByteArray payload;
+};
+
+double fromFixed(qint64 q, Encoding encoding, int exponent)
+{
+    return encoding == Encoding::FixedDecimal ? double(q) / kPow10[exponent]
+                                              : std::ldexp(double(q), -exponent);
+}
+
+bool quantizeLosslessly(const double* values, qsizetype count, Encoding encoding, int exponent,
+                        QVector<qint64>* out)
+{
+    out->resize(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        const double v = values[i];
+        const double scaled = encoding == Encoding::FixedDecimal ? v * kPow10[exponent]
+                                                                 : std::ldexp(v, exponent);
+        if (!std::isfinite(scaled) || std::abs(scaled) >= kMaxFixedMagnitude) return false;
+        const qint64 q = std::llround(scaled);
+        if (fromFixed(q, encoding, exponent) != v) return false;
+        (*out)[i] = q;
+    }
+    return true;
+}
+
+void appendVarint(QByteArray& out, quint64 v)
+{
+    while (v >= 0x80) {
+        out.append(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.append(static_cast<char>(v));
+}
+
+quint64 zigzag(qint64 v) { return (static_cast<quint64>(v) << 1) ^ static_cast<quint64>(v >> 63); }
+qint64 unzigzag(quint64 v) { return static_cast<qint64>(v >> 1) ^ -static_cast<qint64>(v & 1); }
+
+template <typename T>
+void appendLE(QByteArray& out, T v)
+{
+    char buf[sizeof(T)];
+    qToLittleEndian(v, buf);
+    out.append(buf, sizeof(T));
+}
+
+// Takes a pointer and a count so a ShotSampleBuffer column encodes in place.
+Column encodeColumn(const double* values, qsizetype count)
+{
+    Column col;
+    col.count = static_cast<quint32>(count);
+
+    QVector<qint64> fixed;
+    bool isFixed = false;
+    for (int k = 0; k <= kMaxDecimalExponent && !isFixed; ++k) {
+        if (quantizeLosslessly(values, count, Encoding::FixedDecimal, k, &fixed)) {
+            col.encoding = Encoding::FixedDecimal;
+            col.exponent = static_cast<qint8>(k);
+            isFixed = true;
+        }
+    }
+    for (int k = 1; k <= kMaxBinaryExponent && !isFixed; ++k) {
+        if (quantizeLosslessly(values, count, Encoding::FixedBinary, k, &fixed)) {
+            col.encoding = Encoding::FixedBinary;
+            col.exponent = static_cast<qint8>(k);
+            isFixed = true;
+        }
+    }
+
+    if (isFixed) {
+        col.payload.reserve(count * 2);
+        qint64 prev = 0;
+        for (qint64 q : fixed) {
+            appendVarint(col.payload, zigzag(q - prev));
+            prev = q;
+        }
+    } else {
+        bool floatExact = true;
+        for (qsizetype i = 0; i < count; ++i) {
+            const double v = values[i];
+            if (static_cast<double>(static_cast<float>(v)) != v) { floatExact = false; break; }
+        }
+        col.encoding = floatExact ? Encoding::Float32 : Encoding::Float64;
+        col.payload.reserve(count * (floatExact ? 4 : 8));
+        for (qsizetype i = 0; i < count; ++i) {
+            const double v = values[i];
+            if (floatExact) {
+                const float f = static_cast<float>(v);
+                quint32 bits;
+                std::memcpy(&bits, &f, sizeof bits);
+                appendLE(col.payload, bits);
+            } else {
+                quint64 bits;
+                std::memcpy(&bits, &v, sizeof bits);
+                appendLE(col.payload, bits);
+            }
+        }
+    }
+
+    // Deflate only pays for itself when it saves a real fraction — every
+    // deflated column is an inflate on every load.
+    if (col.payload.size() >= 64) {
+        QByteArray deflated = qCompress(col.payload);
+        if (deflated.size() < col.payload.size() - col.payload.size() / 8) {
+            col.payload = std::move(deflated);
+            col.flags |= kFlagDeflated;
+        }
+    }
+    return col;
+}
+
+bool decodeColumn(const QByteArray& blob, const uchar* entry, QVector<double>* out)
+{
+    const auto encoding = static_cast<Encoding>(entry[0]);
+    const int exponent = static_cast<qint8>(entry[1]);
+    const quint8 flags = entry[2];
+    const quint32 count = qFromLittleEndian<quint32>(entry + 4);
+    const quint32 offset = qFromLittleEndian<quint32>(entry + 8);
+    const quint32 length = qFromLittleEndian<quint32>(entry + 12);
+
+    if (quint64(offset) + length > quint64(blob.size())) return false;
+
+    QByteArray inflated;
+    const uchar* p = reinterpret_cast<const uchar*>(blob.constData()) + offset;
+    qsizetype size = length;
+    if (flags & kFlagDeflated) {
+        inflated = qUncompress(p, length);
+        if (inflated.isEmpty() && count > 0) return false;
+        p = reinterpret_cast<const uchar*>(inflated.constData());
+        size = inflated.size();
+    }
+    const uchar* const end = p + size;
+    // Every encoding spends at least a byte per value, so a count past the
+    // payload size is corruption — checked before it can size an allocation.
+    if (qsizetype(count) > size) return false;
+
+    out->resize(count);
+    double* dst = out->data();
+    switch (encoding) {
+    case Encoding::FixedDecimal:
+    case Encoding::FixedBinary: {
+        if (encoding == Encoding::FixedDecimal && (exponent < 0 || exponent > kMaxDecimalExponent))
+            return false;
+        qint64 prev = 0;
+        for (quint32 i = 0; i < count; ++i) {
+            quint64 v = 0;
+            int shift = 0;
+            for (;;) {
+                if (p >= end || shift > 63) return false;
+                const uchar b = *p++;
+                v |= quint64(b & 0x7F) << shift;
+                if (!(b & 0x80)) break;
+                shift += 7;
+            }
+            prev += unzigzag(v);
+            dst[i] = fromFixed(prev, encoding, exponent);
+        }
+        return true;
+    }
+    case Encoding::Float32:
+        if (end - p != qsizetype(count) * 4) return false;
+        for (quint32 i = 0; i < count; ++i, p += 4) {
+            const quint32 bits = qFromLittleEndian<quint32>(p);
+            float f;
+            std::memcpy(&f, &bits, sizeof f);
+            dst[i] = f;
+        }
+        return true;
+    case Encoding::Float64:
+        if (end - p != qsizetype(count) * 8) return false;
+        for (quint32 i = 0; i < count; ++i, p += 8) {
+            const quint64 bits = qFromLittleEndian<quint64>(p);
+            std::memcpy(&dst[i], &bits, sizeof(double));
+        }
+        return true;
+    }
+    return false;  // unknown encoding
+}
+
+bool wanted(SeriesMask series, Series id) { return (series & seriesBit(id)) != 0; }
+
+Format decodeLegacyJson(const QByteArray& blob, ShotRecord* record, SeriesMask series)
+{
+    QByteArray json = qUncompress(blob);
+    if (json.isEmpty()) {
+        qWarning() << "ShotHistoryStorage: Failed to decompress sample data";
+        return Format::Invalid;
+    }
+
+    const QJsonObject root = QJsonDocument::fromJson(json).object();
+
+    auto arrayToPoints = [](const QJsonObject& obj) {
+        QVector<QPointF> points;
+        const QJsonArray timeArr = obj["t"].toArray();
+        const QJsonArray valueArr = obj["v"].toArray();
+        const qsizetype count = qMin(timeArr.size(), valueArr.size());
+        points.reserve(count);
+        for (qsizetype i = 0; i < count; ++i)
+            points.append(QPointF(timeArr[i].toDouble(), valueArr[i].toDouble()));
+        return points;
+    };
+
+    // Absent keys stay absent — temperatureMixGoal in particular is missing
+    // from every shot recorded before that series existed, and consumers tell
+    // "no data" from "goal was 0" by the vector being empty.
+    for (const auto& f : kFields) {
+        const QLatin1StringView key(f.legacyKey);
+        if (wanted(series, f.id) && root.contains(key))
+            record->*f.field = arrayToPoints(root[key].toObject());
+    }
+
+    if (root.contains(QLatin1StringView("phaseSummaries"))) {
+        record->phaseSummariesJson = QString::fromUtf8(
+            QJsonDocument(root["phaseSummaries"].toArray()).toJson(QJsonDocument::Compact));
+    }
+    return Format::LegacyJson;
+}
+
+Format decodeBinary(const QByteArray& blob, ShotRecord* record, SeriesMask series)
+{
+    const auto* data = reinterpret_cast<const uchar*>(blob.constData());
+    const quint8 version = data[4];
+    if (version != kVersion) {
+        qWarning() << "ShotHistoryStorage: sample blob has unsupported version" << version;
+        return Format::Invalid;
+    }
+    const int columnCount = data[5];
+    const int seriesCount = data[6];
+    const quint32 summariesOffset = qFromLittleEndian<quint32>(data + 8);
+    const quint32 summariesLength = qFromLittleEndian<quint32>(data + 12);
+
+    const qsizetype directoryEnd =
+        kHeaderSize + columnCount * kColumnEntrySize + seriesCount * kSeriesEntrySize;
+    if (directoryEnd > blob.size()
+        || quint64(summariesOffset) + summariesLength > quint64(blob.size())) {
+        qWarning() << "ShotHistoryStorage: sample blob is truncated (" << blob.size() << "bytes)";
+        return Format::Invalid;
+    }
+
+    // Decode into locals and only assign once the whole blob has proven
+    // readable, so a corrupt column can't leave a half-populated record.
+    QVector<QVector<double>> columns(columnCount);
+    QVector<bool> columnDecoded(columnCount, false);
+    auto column = [&](int index) -> const QVector<double>* {
+        if (index >= columnCount) return nullptr;
+        if (!columnDecoded[index]) {
+            if (!decodeColumn(blob, data + kHeaderSize + index * kColumnEntrySize, &columns[index]))
+                return nullptr;
+            columnDecoded[index] = true;
+        }
+        return &columns[index];
+    };
+
+    struct Decoded { const SeriesField* field; QVector<QPointF> points; };
+    QVector<Decoded> decoded;
+    decoded.reserve(seriesCount);
+    const uchar* seriesDir = data + kHeaderSize + columnCount * kColumnEntrySize;
+    for (int s = 0; s < seriesCount; ++s) {
+        const uchar* entry = seriesDir + s * kSeriesEntrySize;
+        const SeriesField* field = fieldFor(entry[0]);
+        if (!field || !wanted(series, field->id)) continue;
+        const QVector<double>* times = column(entry[1]);
+        const QVector<double>* values = column(entry[2]);
+        if (!times || !values) {
+            qWarning() << "ShotHistoryStorage: sample blob column for series" << entry[0]
+                       << "is corrupt";
+            return Format::Invalid;
+        }
+        const qsizetype n = qMin(times->size(), values->size());
+        QVector<QPointF> points(n);
+        QPointF* dst = points.data();
+        const double* t = times->constData();
+        const double* v = values->constData();
+        for (qsizetype i = 0; i < n; ++i) dst[i] = QPointF(t[i], v[i]);
+        decoded.append({field, std::move(points)});
+    }
+
+    for (auto& d : decoded) record->*(d.field->field) = std::move(d.points);
+    if (summariesLength > 0) {
+        record->phaseSummariesJson = QString::fromUtf8(
+            blob.constData() + summariesOffset, static_cast<qsizetype>(summariesLength));
+    }
+    return Format::Binary;
+}
+
+} // namespace
+
+QByteArray encode(const QList<SeriesRef>& series, const QString& phaseSummariesJson)
+{
+    QList<QVector<double>> timeColumns;  // decoded form, for dedupe
+    QList<Column> columns;
+    struct Entry { quint8 id; quint8 timeColumn; quint8 valueColumn; };
+    QList<Entry> entries;
+
+    // Column views already in the blob, by time-array address: the machine
+    // clock's dozen series resolve to one time column without a compare.
+    struct SharedTime { const double* data; qsizetype size; qsizetype column; };
+    QList<SharedTime> sharedTimes;
+
+    for (const SeriesRef& ref : series) {
+        QVector<double> times;
+        QVector<double> values;  // point vectors only; a column is read in place
+        const double* valueData = nullptr;
+        qsizetype valueCount = 0;
+        qsizetype timeIndex = -1;
+        if (ref.points) {
+            if (ref.points->isEmpty()) continue;
+            const qsizetype n = ref.points->size();
+            times.resize(n);
+            values.resize(n);
+            for (qsizetype i = 0; i < n; ++i) {
+                times[i] = (*ref.points)[i].x();
+                values[i] = (*ref.points)[i].y();
+            }
+            valueData = values.constData();
+            valueCount = n;
+        } else {
+            if (ref.column.isEmpty()) continue;
+            const qsizetype n = ref.column.size();
+            for (const SharedTime& shared : std::as_const(sharedTimes)) {
+                if (shared.data == ref.column.times() && shared.size == n) {
+                    timeIndex = shared.column;
+                    break;
+                }
+            }
+            if (timeIndex < 0)
+                times = QVector<double>(ref.column.times(), ref.column.times() + n);
+            valueData = ref.column.values();
+            valueCount = n;
+        }
+
+        // Share the time axis with an earlier series when it is identical —
+        // the common case, since every DE1-clocked series is sampled together.
+        if (timeIndex < 0) {
+            for (qsizetype c = 0; c < timeColumns.size(); ++c) {
+                if (!timeColumns[c].isEmpty() && timeColumns[c] == times) { timeIndex = c; break; }
+            }
+        }
+        if (timeIndex < 0) {
+            timeIndex = columns.size();
+            columns.append(encodeColumn(times.constData(), times.size()));
+            timeColumns.append(std::move(times));
+        }
+        if (!ref.points)
+            sharedTimes.append({ref.column.times(), ref.column.size(), timeIndex});
+        const qsizetype valueIndex = columns.size();
+        columns.append(encodeColumn(valueData, valueCount));
+        timeColumns.append(QVector<double>());  // keep indices aligned; never matched
+
+        entries.append({static_cast<quint8>(ref.id), static_cast<quint8>(timeIndex),
+                        static_cast<quint8>(valueIndex)});
+    }
+
+    const QByteArray summaries = phaseSummariesJson.toUtf8();
+    const qsizetype directoryEnd =
+        kHeaderSize + columns.size() * kColumnEntrySize + entries.size() * kSeriesEntrySize;
+
+    qsizetype payloadSize = summaries.size();
+    for (const Column& c : columns) payloadSize += c.payload.size();
+
+    QByteArray out;
+    out.reserve(directoryEnd + payloadSize);
+    out.append(kMagic, sizeof kMagic);
+    out.append(static_cast<char>(kVersion));
+    out.append(static_cast<char>(columns.size()));
+    out.append(static_cast<char>(entries.size()));
+    out.append('\0');
+    appendLE<quint32>(out, summaries.isEmpty() ? 0 : static_cast<quint32>(directoryEnd));
+    appendLE<quint32>(out, static_cast<quint32>(summaries.size()));
+
+    quint32 offset = static_cast<quint32>(directoryEnd + summaries.size());
+    for (const Column& c : columns) {
+        out.append(static_cast<char>(c.encoding));
+        out.append(static_cast<char>(c.exponent));
+        out.append(static_cast<char>(c.flags));
+        out.append('\0');
+        appendLE<quint32>(out, c.count);
+        appendLE<quint32>(out, offset);
+        appendLE<quint32>(out, static_cast<quint32>(c.payload.size()));
+        offset += static_cast<quint32>(c.payload.size());
+    }
+    for (const Entry& e : entries) {
+        out.append(static_cast<char>(e.id));
+        out.append(static_cast<char>(e.timeColumn));
+        out.append(static_cast<char>(e.valueColumn));
+        out.append('\0');
+    }
+    out.append(summaries);
+    for (const Column& c : columns) out.append(c.payload);
+    return out;
+}
+
+QByteArray encodeRecord(const ShotRecord& record)
+{
+    QList<SeriesRef> series;
+    series.reserve(std::size(kFields));
+    for (const auto& f : kFields) series.append({f.id, &(record.*f.field)});
+    return encode(series, record.phaseSummariesJson);
+}
+
+bool isBinary(const QByteArray& blob)
+{
+    return blob.size() >= kHeaderSize && std::memcmp(blob.constData(), kMagic, sizeof kMagic) == 0;
+}
+
+Format decode(const QByteArray& blob, ShotRecord* record, SeriesMask series)
+{
+    return isBinary(blob) ? decodeBinary(blob, record, series)
+                          : decodeLegacyJson(blob, record, series);
+}
+
+} // namespace ShotSampleBlob
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+#include "models/shotsamplebuffer.h"
+
+struct ShotRecord;
+
+// Codec for shot_samples.data_blob — the per-shot time series.
+//
+// Two formats live in that column and both decode here:
+//
+//   - Legacy: a compact JSON object of {"<series>": {"t": [...], "v": [...]}}
+//     run through qCompress(…, 9). Every shot saved before the binary format
+//     landed is in this shape, and stays readable forever — the upgrade is
+//     lazy (loadShotRecordStatic rewrites a legacy blob the first time the
+//     shot is opened), so an untouched shot can be a legacy blob indefinitely.
+//
+//   - Binary (version 1): a fixed header, a column directory and a series
+//     directory, then the column payloads. Each series points at a TIME column
+//     and a VALUE column; identical time columns are stored once, so the dozen
+//     series that share the DE1 sample clock carry a single time axis between
+//     them. Little-endian throughout:
+//
+//       0   char[4]  magic "DZSB"
+//       4   u8       version (1)
+//       5   u8       column count
+//       6   u8       series count
+//       7   u8       reserved (0)
+//       8   u32      phase-summaries offset   (0 when absent)
+//       12  u32      phase-summaries length   (UTF-8 compact JSON array)
+//       16  column directory, 16 bytes each:
+//             u8 encoding, i8 exponent, u8 flags, u8 reserved,
+//             u32 value count, u32 payload offset, u32 payload length
+//       …   series directory, 4 bytes each:
+//             u8 series id, u8 time column, u8 value column, u8 reserved
+//       …   payloads
+//
+// Column encodings are chosen per column by the encoder and are LOSSLESS: a
+// column is fixed-point only when every value round-trips bit-exactly at the
+// chosen scale (decimal 10^-k for millisecond clocks and typed-in goals,
+// binary 2^-k for the DE1's U8P4/U16P8 sensor fields), float32 only when every
+// value is exactly representable as a float, and float64 otherwise. Fixed-point
+// columns are delta + zigzag + LEB128 varint coded. A column payload whose
+// deflate is meaningfully smaller is stored deflated (flag bit 0). Losslessness
+// is what keeps detector verdicts and the derived-curve self-heal comparison
+// in decompressSampleData identical across the format change.
+//
+// The magic can't collide with a legacy blob: qCompress prefixes its output
+// with the big-endian uncompressed length, and "DZSB" read that way is over a
+// gigabyte.
+namespace ShotSampleBlob {
+
+// Stable on-disk ids — never renumber, only append.
+enum class Series : quint8 {
+    Pressure = 1,
+    Flow = 2,
+    Temperature = 3,
+    TemperatureMix = 4,
+    PressureGoal = 5,
+    FlowGoal = 6,
+    TemperatureGoal = 7,
+    TemperatureMixGoal = 8,
+    Resistance = 9,
+    Conductance = 10,
+    DarcyResistance = 11,
+    ConductanceDerivative = 12,
+    WaterDispensed = 13,
+    Weight = 14,
+    WeightFlowRate = 15,
+};
+
+// Which series a decode materializes: one bit per Series id. Ids stay below
+// 32 (the enum only appends, and a 32nd series would widen this type).
+using SeriesMask = quint32;
+
+constexpr SeriesMask seriesBit(Series s) { return SeriesMask(1) << static_cast<quint8>(s); }
+
+constexpr SeriesMask kAllSeries = ~SeriesMask(0);
+
+// Pure functions of pressure/flow — recomputed on load rather than trusted
+// from the blob (ShotHistoryStorage::computeDerivedCurves).
+constexpr SeriesMask kDerivedSeries = seriesBit(Series::Resistance)
+    | seriesBit(Series::Conductance)
+    | seriesBit(Series::DarcyResistance)
+    | seriesBit(Series::ConductanceDerivative);
+
+// Everything ShotAnalysis::analyzeShot reads. A load whose mask covers this
+// set still recomputes (and persists) the quality badges.
+constexpr SeriesMask kAnalysisSeries = seriesBit(Series::Pressure)
+    | seriesBit(Series::Flow)
+    | seriesBit(Series::Weight)
+    | seriesBit(Series::ConductanceDerivative)
+    | seriesBit(Series::PressureGoal)
+    | seriesBit(Series::FlowGoal);
+
+// One series to encode: either a point vector, or — when `points` is null — a
+// column view of the live ShotSampleBuffer. Columns on the same clock share
+// their time array, which the encoder recognizes by address and stores once
+// without comparing it.
+struct SeriesRef {
+    Series id;
+    const QVector<QPointF>* points = nullptr;
+    SampleColumn column = {};
+};
+
+enum class Format {
+    Invalid,     // empty, corrupt or truncated — nothing was decoded
+    LegacyJson,  // qCompress'd JSON; callers should re-encode and persist
+    Binary,
+};
+
+// Empty series are omitted, so "absent" and "recorded nothing" decode the
+// same way (an empty vector), exactly as the legacy optional keys did.
+QByteArray encode(const QList<SeriesRef>& series, const QString& phaseSummariesJson = QString());
+
+// Every series a ShotRecord carries, plus its phase summaries.
+QByteArray encodeRecord(const ShotRecord& record);
+
+bool isBinary(const QByteArray& blob);
+
+// Decodes either format into `record`'s series fields and phaseSummariesJson.
+// Series absent from the blob, or outside `series`, are left untouched. For a
+// binary blob the series directory is consulted first, so a column no
+// requested series points at is never inflated or parsed; a legacy blob still
+// has to be inflated and parsed whole, the mask only skips building points.
+// Warns and returns Invalid on a blob it cannot read.
+Format decode(const QByteArray& blob, ShotRecord* record, SeriesMask series = kAllSeries);
+
+} // namespace ShotSampleBlob
@@ -2,6 +2,7 @@
 #include "coffeebagstorage.h"
 #include "network/beanbaseclient.h"
 #include "core/dbutils.h"
+#include "core/taskexecutor.h"
 
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -162,7 +163,7 @@ void UnifiedBeanSearchModel::requestHistory()
     const QString kind = m_bagKind;
     auto destroyed = m_destroyed;
     auto rows = std::make_shared<QVariantList>();
-    QThread* thread = QThread::create([this, dbPath, filter, kind, rows, destroyed]() {
+    TaskExecutor::instance().submit(TaskLane::Interactive, [this, dbPath, filter, kind, rows, destroyed]() {
         withTempDb(dbPath, "bean_hist", [&](QSqlDatabase& db) {
             *rows = queryHistoryStatic(db, filter, 50, kind);
         });
@@ -180,9 +181,7 @@ void UnifiedBeanSearchModel::requestHistory()
                 requestHistory();
             }
         }, Qt::QueuedConnection);
-    });
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
+    }, destroyed);
 }
 
 QVariantList UnifiedBeanSearchModel::queryHistoryStatic(QSqlDatabase& db, const QString& filter,
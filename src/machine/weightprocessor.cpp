@@ -2,6 +2,7 @@
 #include "../ble/scales/scalelogging.h"  // the feed-liveness line is a [Scale] question
 #include "sawlogging.h"
 #include "sawprediction.h"
+#include "../core/latencystats.h"
 #include <QtMath>
 #include <QDebug>
 #include <chrono>
@@ -36,8 +37,12 @@ WeightProcessor::WeightProcessor(QObject* parent)
 {
 }
 
-void WeightProcessor::processWeight(double weight)
+void WeightProcessor::processWeight(double weight, qint64 receivedMs)
 {
+    // First thing, before any filtering can return early: the leg being timed
+    // is the hop here, and a rejected spike waited in the same queue.
+    LatencyStats::recordSince(LatencyStats::Leg::ScaleToWeightProcessor, receivedMs);
+
     qint64 wallClock = m_wallClock();
 
     // Spike filter (issue #610): reject single-packet BLE corruption.
@@ -35,8 +35,10 @@ public:
     explicit WeightProcessor(QObject* parent = nullptr);
 
 public slots:
-    // Called from main thread (all via QueuedConnection — thread-safe)
-    void processWeight(double weight);
+    // Called from main thread (all via QueuedConnection — thread-safe).
+    // receivedMs is ScaleDevice's steady-clock arrival stamp, fed to the
+    // scale→worker latency histogram; 0 (tests, synthetic samples) skips it.
+    void processWeight(double weight, qint64 receivedMs = 0);
     void configure(double targetWeight, int preinfuseFrameCount,
                    QVector<double> frameExitWeights,
                    QVector<FrameExitCondition> frameExitConditions,
@@ -115,6 +115,7 @@ extern "C" const char* __ubsan_default_options()
 
 
 #include "core/asynclogger.h"
+#include "core/taskexecutor.h"
 #include "core/btlogfilter.h"
 #include "core/appsettings.h"
 #include "core/settings.h"
@@ -148,6 +149,8 @@ extern "C" const char* __ubsan_default_options()
 #include "ble/de1logging.h"
 #include "ble/de1device.h"
 #include "ble/de1transport.h"
+#include "ble/blegattqueue.h"
+#include "ble/sawstopchannel.h"
 #ifndef Q_OS_IOS
 #include "usb/usbmanager.h"
 #include "usb/usbscalemanager.h"
@@ -1241,7 +1244,40 @@ int main(int argc, char *argv[])
     QObject::connect(settings.app(), &SettingsApp::simulationModeChanged,
                      &bleManager, applyScaleSimulated);
 
+    // The BLE I/O thread: the DE1's BleTransport, the shared GATT queue and the
+    // stop-at-weight channel live here, so a SAW stop goes from the weight
+    // worker to the DE1's write characteristic without a turn of the GUI
+    // thread (sawstopchannel.h, bleiothread.h). The GUI thread is the one a GC
+    // pause stalls on slow Android tablets — docs/ANDROID_MEMORY_GC_PRESSURE.md
+    // measured the stop's dispatch leg at 6.8 s there. Scale transports stay on
+    // the main thread; the queue hands their operations back to it.
+    //
+    // Not on Apple platforms: CoreBluetooth delivers its callbacks on its own
+    // queue and Qt's darwin backend re-posts them to the controller's thread,
+    // which has only ever been the main thread in this app (see the QueuedConnection
+    // note in BleTransport::setupController). Moving it is a separate change with
+    // its own testing, and GC pressure is not an Apple problem.
+    //
+    // Declared before de1Device so it outlives it. Stopped after app.exec().
+    QThread bleIoThread;
+    bleIoThread.setObjectName(QStringLiteral("BLE-IO"));
+    SawStopChannel sawStopChannel;
+#if defined(Q_OS_IOS) || defined(Q_OS_MACOS)
+    constexpr bool useBleIoThread = false;
+#else
+    constexpr bool useBleIoThread = true;
+#endif
+    if (useBleIoThread) {
+        BleGattQueue::instance().moveToThread(&bleIoThread);
+        sawStopChannel.moveToThread(&bleIoThread);
+        bleIoThread.start(QThread::HighPriority);
+    }
+
     DE1Device de1Device;
+    if (useBleIoThread) {
+        de1Device.setIoThread(&bleIoThread);
+        de1Device.setSawStopChannel(&sawStopChannel);
+    }
     de1Device.setSettings(settings.hardware());  // Heater calibration sent to firmware
     // D9: wire the persisted (build-scoped) dual-HIGH-incapable classification
     // store BEFORE any BLE connect, so a known-weak device starts both links
@@ -1436,11 +1472,15 @@ int main(int argc, char *argv[])
 
     // WeightProcessor → DE1Device: stop-at-weight.
     // Use DirectConnection so the lambda runs immediately on the WeightProcessor's HighPriority
-    // thread, then post a Qt::HighEventPriority event to DE1Device. This makes the SAW stop
-    // jump ahead of any normal-priority events already queued on the main thread (e.g. D-Flow
-    // setpoint writes), preventing the 4+ second delivery delay seen on slow devices.
+    // thread. The stop goes straight to the BLE I/O thread when DE1Device has armed the SAW
+    // channel (a BLE DE1, no simulator, no firmware flash) and never touches the main thread.
+    // Otherwise — USB, simulator, Apple platforms — post a Qt::HighEventPriority event to
+    // DE1Device. This makes the SAW stop jump ahead of any normal-priority events already
+    // queued on the main thread (e.g. D-Flow setpoint writes), preventing the 4+ second
+    // delivery delay seen on slow devices.
     QObject::connect(&weightProcessor, &WeightProcessor::stopNow,
-                     &weightProcessor, [&de1Device](qint64 sawTriggerMs) {
+                     &weightProcessor, [&de1Device, &sawStopChannel](qint64 sawTriggerMs) {
+                         if (sawStopChannel.post(sawTriggerMs)) return;
                          QCoreApplication::postEvent(&de1Device,
                              new SawStopEvent(sawTriggerMs),
                              Qt::HighEventPriority);
@@ -4904,6 +4944,20 @@ int main(int argc, char *argv[])
     // scale is destroyed. Only this pointer is unguarded.
     de1Device.setSimulator(nullptr);
 
+    // Stop the BLE I/O thread. aboutToQuit already disconnected the DE1, so the
+    // transport's deleteLater() is either done or runs as the thread finishes.
+    // The queue and the SAW channel stay bound to the finished thread; from here
+    // on BleIo::needsHop() is false for them and the scale transports' teardown
+    // below reaches the queue inline, with no other thread left to race.
+    if (bleIoThread.isRunning()) {
+        bleIoThread.quit();
+        bleIoThread.wait(2000);
+    }
+
+    // Let queued background work (a web request, an MCP call) finish while the
+    // objects it reports back to still exist; anything slower is abandoned.
+    TaskExecutor::instance().shutdown(2000);
+
     // DE1 signals already disconnected in aboutToQuit handler before BLE disconnect.
 
     // Disable crash handler before cleanup - crashes during C++ runtime destruction
@@ -6,6 +6,7 @@
 #include "../controllers/profilemanager.h"
 #include "../history/shothistorystorage.h"
 #include "../history/bagid.h"
+#include "../core/latencystats.h"
 #include "../core/logtags.h"
 #include "../core/memorymonitor.h"
 #include "../core/settings.h"
@@ -29,6 +30,7 @@
 #include <QCoreApplication>
 
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 #include "mcpagentdocs.h"
 
 #include <QFile>
@@ -134,7 +136,7 @@ void registerMcpResources(McpResourceRegistry* registry, DE1Device* device,
 
             const QString dbPath = shotHistory->databasePath();
 
-            QThread* thread = QThread::create([dbPath, respond]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, respond]() {
                 QJsonObject result;
                 QJsonArray shots;
 
@@ -169,9 +171,6 @@ void registerMcpResources(McpResourceRegistry* registry, DE1Device* device,
                     respond(result);
                 }, Qt::QueuedConnection);
             });
-
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         });
 
     // decenza://dialing/current_context
@@ -249,7 +248,7 @@ void registerMcpResources(McpResourceRegistry* registry, DE1Device* device,
 
             const QString dbPath = shotHistory->databasePath();
 
-            QThread* thread = QThread::create([dbPath, bean, grinder, activeProfile, machinePhase, respond]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, bean, grinder, activeProfile, machinePhase, respond]() {
                 QJsonObject result;
                 QJsonArray shots;
 
@@ -286,9 +285,6 @@ void registerMcpResources(McpResourceRegistry* registry, DE1Device* device,
                     respond(result);
                 }, Qt::QueuedConnection);
             });
-
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         });
 
     // decenza://profiles/list
@@ -347,6 +343,15 @@ void registerMcpResources(McpResourceRegistry* registry, DE1Device* device,
             if (!memoryMonitor) return QJsonObject();
             return memoryMonitor->toJson();
         });
+
+    // decenza://debug/latency
+    registry->registerResource(
+        "decenza://debug/latency",
+        "Control-Loop Latency",
+        "Fixed-bucket latency histograms for the shot control loop (scale to SAW worker, "
+        "stop dispatch, BLE ack, DE1 sample to chart)",
+        "application/json",
+        []() -> QJsonObject { return LatencyStats::toJson(); });
 }
 
 // Builds the {"log", "lines"} response fields shared by every debug_get_log
@@ -808,4 +813,19 @@ void registerDebugTools(McpToolRegistry* registry, MemoryMonitor* memoryMonitor)
             return result;
         },
         "read");
+
+    // debug_get_latency — the same histograms /api/debug/latency serves. Read-only:
+    // resetting the window is a web-UI/HTTP action (POST /api/debug/latency/reset),
+    // so an assistant comparing two runs cannot wipe the one it is comparing against.
+    registry->registerTool(
+        "debug_get_latency",
+        "Control-loop latency histograms since app start (or the last reset), steady clock, "
+        "fixed buckets: scaleToWeightProcessor, triggerToDispatch (SAW dispatch), "
+        "dispatchToAck (SAW bleAck), sampleToChartFlush. Each leg has count, meanMs, maxMs, "
+        "p50/p95/p99 (bucket upper bounds) and per-bucket counts against `bucketsMs`; the last "
+        "count is everything above the final bound. Use it to compare builds or devices "
+        "instead of tabulating [SAW] Latency log lines.",
+        QJsonObject{{"type", "object"}, {"properties", QJsonObject{}}},
+        [](const QJsonObject&) -> QJsonObject { return LatencyStats::toJson(); },
+        "read", McpTierNiche);
 }
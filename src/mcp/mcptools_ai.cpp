@@ -8,6 +8,7 @@
 #include "../controllers/maincontroller.h"
 #include "../network/beanbaseclient.h"
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 #include "../history/shothistorystorage.h"
 #include "../history/coffeebagstorage.h"
 #include "../history/shotprojection.h"
@@ -107,7 +108,7 @@ void registerAITools(McpToolRegistry* registry, MainController* mainController)
             // thread, then hop back to the main thread for AIManager
             // access (AIManager owns providers + ShotSummarizer and is
             // not thread-safe).
-            QThread* thread = QThread::create(
+            TaskExecutor::instance().submit(TaskLane::Interactive,
                 [dbPath, shotId, dryRun, userPromptOverride, systemPromptOverride,
                  aiPtr, respond]() {
                 ShotProjection shot;
@@ -387,9 +388,6 @@ void registerAITools(McpToolRegistry* registry, MainController* mainController)
                     aiLive->analyze(systemPrompt, userPrompt);
                 }, Qt::QueuedConnection);
             });
-
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         },
         "control");
 
@@ -530,7 +528,7 @@ void registerAITools(McpToolRegistry* registry, MainController* mainController)
             // withTempDb load has a guaranteed terminal (found=false on any
             // failure), exactly like bag_update.
             const QString dbPath = bagStorage->databasePath();
-            QThread* loadThread = QThread::create(
+            TaskExecutor::instance().submit(TaskLane::Interactive,
                 [st, beanbase, dbPath, bagId, urlOverride, finish, respond]() {
                     CoffeeBag bag;
                     const bool opened = withTempDb(dbPath, "mcp_extract_bag", [&](QSqlDatabase& db) {
@@ -564,8 +562,6 @@ void registerAITools(McpToolRegistry* registry, MainController* mainController)
                         beanbase->fetchPageText(st->url);
                     }, Qt::QueuedConnection);
                 });
-            QObject::connect(loadThread, &QThread::finished, loadThread, &QObject::deleteLater);
-            loadThread->start();
         },
         "control", McpTierNiche);
 
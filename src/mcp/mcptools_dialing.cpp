@@ -24,6 +24,7 @@
 #include <QCoreApplication>
 
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 
 // Data collected on the background thread (pure SQL results, no QObject access)
 struct DialingDbResult {
@@ -70,7 +71,7 @@ void registerDialingTools(McpToolRegistry* registry, MainController* mainControl
 
             const QString dbPath = shotHistory->databasePath();
 
-            QThread* thread = QThread::create(
+            TaskExecutor::instance().submit(TaskLane::Interactive,
                 [dbPath, shotId, historyLimit, includeFullKnowledge, mainController, profileManager, settings, respond]() {
                 // --- All SQL runs on this background thread ---
                 DialingDbResult dbResult;
@@ -363,9 +364,6 @@ void registerDialingTools(McpToolRegistry* registry, MainController* mainControl
                     respond(result);
                 }, Qt::QueuedConnection);
             });
-
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         },
         "read", McpTierCore);
 
@@ -408,7 +406,7 @@ void registerDialingTools(McpToolRegistry* registry, MainController* mainControl
 
             const QString dbPath = shotHistory->databasePath();
 
-            QThread* thread = QThread::create([dbPath, shotId, respond]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, shotId, respond]() {
                 qint64 resolvedShotId = shotId;
 
                 if (resolvedShotId <= 0) {
@@ -488,9 +486,6 @@ void registerDialingTools(McpToolRegistry* registry, MainController* mainControl
                     respond(result);
                 }, Qt::QueuedConnection);
             });
-
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         },
         "read", McpTierCore);
 }
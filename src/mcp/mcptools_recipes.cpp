@@ -18,6 +18,7 @@
 #include "../controllers/maincontroller.h"
 #include "../controllers/profilemanager.h"
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 #include "../core/settings.h"
 #include "../core/settings_dye.h"
 #include "../core/yieldspec.h"
@@ -325,7 +326,7 @@ void registerRecipeTools(McpToolRegistry* registry, ShotHistoryStorage* shotHist
                 (mainController && mainController->profileManager())
                     ? mainController->profileManager()->beverageTypeByTitleSnapshot()
                     : QHash<QString, QString>();
-            QThread* thread = QThread::create([dbPath, includeArchived, settings, respond, bevByTitle]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, includeArchived, settings, respond, bevByTitle]() {
                 QJsonArray recipes;
                 const bool opened = withTempDb(dbPath, "mcp_recipes", [&](QSqlDatabase& db) {
                     const auto addAll = [&](bool archived) {
@@ -347,8 +348,6 @@ void registerRecipeTools(McpToolRegistry* registry, ShotHistoryStorage* shotHist
                     respond(QJsonObject{{"recipes", recipes}, {"count", recipes.size()}});
                 }, Qt::QueuedConnection);
             });
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         },
         "read", McpTierCore);
 
@@ -376,7 +375,7 @@ void registerRecipeTools(McpToolRegistry* registry, ShotHistoryStorage* shotHist
                 (mainController && mainController->profileManager())
                     ? mainController->profileManager()->beverageTypeByTitleSnapshot()
                     : QHash<QString, QString>();
-            QThread* thread = QThread::create([dbPath, recipeId, settings, respond, bevByTitle]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, recipeId, settings, respond, bevByTitle]() {
                 QJsonObject result;
                 bool found = false;
                 const bool opened = withTempDb(dbPath, "mcp_recipe_get", [&](QSqlDatabase& db) {
@@ -395,8 +394,6 @@ void registerRecipeTools(McpToolRegistry* registry, ShotHistoryStorage* shotHist
                         respond(result);
                 }, Qt::QueuedConnection);
             });
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         },
         "read", McpTierCore);
 
@@ -676,7 +673,7 @@ void registerRecipeTools(McpToolRegistry* registry, ShotHistoryStorage* shotHist
             const QString fallbackSteam = mainController ? mainController->currentSteamSpecJson()
                                                          : QString();
             const QString dbPath = shotHistory->databasePath();
-            QThread* thread = QThread::create([dbPath, shotId, name, hasMilkProvided, hasMilk,
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, shotId, name, hasMilkProvided, hasMilk,
                                                fallbackSteam, recipeStorage, settings, respond]() {
                 ShotRecord record;
                 const bool opened = withTempDb(dbPath, "mcp_recipe_promote", [&](QSqlDatabase& db) {
@@ -718,8 +715,6 @@ void registerRecipeTools(McpToolRegistry* registry, ShotHistoryStorage* shotHist
                     recipeStorage->requestCreateRecipe(fields);
                 }, Qt::QueuedConnection);
             });
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         },
         "settings", McpTierCore);
 
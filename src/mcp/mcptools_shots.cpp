@@ -5,6 +5,7 @@
 #include "mcplogfilter.h"
 #include "../history/shothistorystorage.h"
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 
 #include <QDateTime>
 #include <QJsonObject>
@@ -54,6 +55,16 @@ static bool wantsFullDetail(const QJsonObject& args)
     return args.value("detail").toString() == QStringLiteral("full");
 }
 
+// Curves to decode for a detail level. A summary strips every time series
+// before responding, so it needs only what feeds the detector output and the
+// phase-summary fallback for shots saved without one.
+static ShotSampleBlob::SeriesMask seriesForDetail(bool fullDetail)
+{
+    if (fullDetail) return ShotSampleBlob::kAllSeries;
+    return ShotSampleBlob::kAnalysisSeries
+        | ShotSampleBlob::seriesBit(ShotSampleBlob::Series::Temperature);
+}
+
 // Replace 0 with null for enjoyment0to100/drinkTdsPct/drinkEyPct so MCP
 // consumers can distinguish unrated shots (and shots without TDS/EY
 // measurements) from a deliberate zero. The QML UI already does this
@@ -143,7 +154,7 @@ void registerShotTools(McpToolRegistry* registry, ShotHistoryStorage* shotHistor
 
             const QString dbPath = shotHistory->databasePath();
 
-            QThread* thread = QThread::create(
+            TaskExecutor::instance().submit(TaskLane::Interactive,
                 [dbPath, limit, offset, profileFilter, beanFilter,
                  minEnjoyment, hasRating, hasNotes, hasTds,
                  afterEpoch, beforeEpoch, currentDateTime, respond]() {
@@ -160,9 +171,9 @@ void registerShotTools(McpToolRegistry* registry, ShotHistoryStorage* shotHistor
                     // is reflected here too. A shot-linked recipe can only be
                     // archived, never deleted, so the row always resolves.
                     // EVERY shots column is qualified `s.`: joining `recipes` makes
-                    // ten names ambiguous (bag_id, beanbase_id, created_at,
-                    // equipment_id, hot_water_json, id, profile_json, steam_json,
-                    // updated_at, yield_mode), and SQLite rejects the whole
+                    // nine names ambiguous (bag_id, beanbase_id, created_at,
+                    // equipment_id, hot_water_json, id, steam_json, updated_at,
+                    // yield_mode), and SQLite rejects the whole
                     // statement on any one of them. Do not hand-maintain that list
                     // — recompute it from the two CREATE TABLEs plus their
                     // ALTER TABLE ADD COLUMN migrations if you need it. Qualifying
@@ -170,11 +181,13 @@ void registerShotTools(McpToolRegistry* registry, ShotHistoryStorage* shotHistor
                     QString sql = "SELECT s.id, s.timestamp, s.profile_name, s.dose_weight, s.final_weight, "
                                   "s.duration_seconds, s.enjoyment, "
                                   "s.grinder_setting, s.rpm, eg.model AS grinder_model, "
-                                  "s.espresso_notes, s.bean_brand, s.bean_type, s.yield_override, s.profile_json, "
+                                  "s.espresso_notes, s.bean_brand, s.bean_type, s.yield_override, "
+                                  "sp.profile_json AS profile_json, "
                                   "s.stopped_by, s.recipe_id, r.name AS recipe_name "
                                   "FROM shots s "
                                   "LEFT JOIN equipment_items eg ON eg.package_id = s.equipment_id AND eg.kind = 'grinder' "
                                   "LEFT JOIN recipes r ON r.id = s.recipe_id "
+                                  "LEFT JOIN shot_profiles sp ON sp.hash = s.profile_hash "
                                   "WHERE 1=1 ";
                     // Aliased `s` as well, though it does NOT join: it lets the shared
                     // WHERE fragments below carry one qualified spelling instead of
@@ -379,9 +392,6 @@ void registerShotTools(McpToolRegistry* registry, ShotHistoryStorage* shotHistor
                     respond(result);
                 }, Qt::QueuedConnection);
             });
-
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         },
         "read", McpTierCore);
 
@@ -421,11 +431,12 @@ void registerShotTools(McpToolRegistry* registry, ShotHistoryStorage* shotHistor
             const bool fullDetail = wantsFullDetail(args);
             const QString dbPath = shotHistory->databasePath();
 
-            QThread* thread = QThread::create([dbPath, shotId, fullDetail, respond]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, shotId, fullDetail, respond]() {
                 QJsonObject result;
 
                 if (!withTempDb(dbPath, "mcp_shot_detail", [&](QSqlDatabase& db) {
-                    ShotRecord record = ShotHistoryStorage::loadShotRecordStatic(db, shotId);
+                    ShotRecord record = ShotHistoryStorage::loadShotRecordStatic(
+                        db, shotId, nullptr, seriesForDetail(fullDetail));
                     ShotProjection shot = ShotHistoryStorage::convertShotRecord(record);
                     if (shot.isValid()) {
                         result = shot.toJsonObject();
@@ -454,9 +465,6 @@ void registerShotTools(McpToolRegistry* registry, ShotHistoryStorage* shotHistor
                     respond(result);
                 }, Qt::QueuedConnection);
             });
-
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         },
         "read", McpTierCore);
 
@@ -500,7 +508,7 @@ void registerShotTools(McpToolRegistry* registry, ShotHistoryStorage* shotHistor
             const bool fullDetail = wantsFullDetail(args);
             const QString dbPath = shotHistory->databasePath();
 
-            QThread* thread = QThread::create([dbPath, idArray, fullDetail, respond]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, idArray, fullDetail, respond]() {
                 QJsonObject result;
                 QJsonArray shots;
                 QJsonArray unresolved;
@@ -509,7 +517,8 @@ void registerShotTools(McpToolRegistry* registry, ShotHistoryStorage* shotHistor
                 if (!withTempDb(dbPath, "mcp_compare", [&](QSqlDatabase& db) {
                     for (const auto& idVal : idArray) {
                         qint64 shotId = idVal.toInteger();
-                        ShotRecord record = ShotHistoryStorage::loadShotRecordStatic(db, shotId);
+                        ShotRecord record = ShotHistoryStorage::loadShotRecordStatic(
+                            db, shotId, nullptr, seriesForDetail(fullDetail));
                         ShotProjection shot = ShotHistoryStorage::convertShotRecord(record);
                         if (!shot.isValid()) {
                             // Dropped IDs used to vanish: the caller got a shorter
@@ -642,9 +651,6 @@ void registerShotTools(McpToolRegistry* registry, ShotHistoryStorage* shotHistor
                     respond(result);
                 }, Qt::QueuedConnection);
             });
-
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         },
         "read", McpTierCore);
 
@@ -713,12 +719,17 @@ void registerShotTools(McpToolRegistry* registry, ShotHistoryStorage* shotHistor
 
             const QString dbPath = shotHistory->databasePath();
 
-            QThread* thread = QThread::create([dbPath, shotId, offset, limit, filter, regexMode, tailActive, tail, dedupe, respond]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, shotId, offset, limit, filter, regexMode, tailActive, tail, dedupe, respond]() {
                 QJsonObject result;
 
                 if (!withTempDb(dbPath, "mcp_shot_debug", [&](QSqlDatabase& db) {
                     QSqlQuery query(db);
-                    query.prepare("SELECT debug_log FROM shots WHERE id = ?");
+                    // LEFT JOIN, not a lookup in shot_debug_logs alone: an
+                    // unknown id and a shot that logged nothing still answer
+                    // differently.
+                    query.prepare("SELECT dl.debug_log FROM shots s "
+                                  "LEFT JOIN shot_debug_logs dl ON dl.shot_id = s.id "
+                                  "WHERE s.id = ?");
                     query.addBindValue(shotId);
                     if (query.exec() && query.next()) {
                         QString debugLog = query.value(0).toString();
@@ -793,9 +804,47 @@ void registerShotTools(McpToolRegistry* registry, ShotHistoryStorage* shotHistor
                     respond(result);
                 }, Qt::QueuedConnection);
             });
-
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         },
         "read");
+
+    // shots_reanalyze — the whole-history re-analysis job. It runs on its own
+    // at startup after a detector or derived-curve change; these verbs let an
+    // agent watch it, stop it, or start it again. Cancelling keeps the
+    // checkpoint, so the next start resumes rather than rescanning.
+    const auto reanalysisStatus = [shotHistory]() -> QJsonObject {
+        QJsonObject result = shotHistory->historyReanalysisStatus();
+        result["success"] = true;
+        return result;
+    };
+    const QVector<McpToolAction> reanalyzeActions{
+        McpRegistryHelpers::syncAction("status", "read",
+        [shotHistory, reanalysisStatus](const QJsonObject&) -> QJsonObject {
+            if (!shotHistory || !shotHistory->isReady())
+                return QJsonObject{{"error", "Shot history not available"}};
+            return reanalysisStatus();
+        }),
+        McpRegistryHelpers::syncAction("start", "control",
+        [shotHistory, reanalysisStatus](const QJsonObject&) -> QJsonObject {
+            if (!shotHistory || !shotHistory->isReady())
+                return QJsonObject{{"error", "Shot history not available"}};
+            shotHistory->requestHistoryReanalysis();
+            return reanalysisStatus();
+        }),
+        McpRegistryHelpers::syncAction("cancel", "control",
+        [shotHistory, reanalysisStatus](const QJsonObject&) -> QJsonObject {
+            if (!shotHistory || !shotHistory->isReady())
+                return QJsonObject{{"error", "Shot history not available"}};
+            shotHistory->cancelHistoryReanalysis();
+            return reanalysisStatus();
+        }),
+    };
+
+    registry->registerActionTool(
+        "shots_reanalyze",
+        "Re-derive curves and re-run shot analysis across the whole history after the detectors "
+        "change. status reports state (idle/running/cancelling), done/total shots and badge changes; "
+        "start begins or resumes the job, newest shots first; cancel stops it after the batch in "
+        "flight, keeping its checkpoint. The job also starts by itself at launch.",
+        QJsonObject{{"type", "object"}, {"properties", QJsonObject{}}},
+        reanalyzeActions);
 }
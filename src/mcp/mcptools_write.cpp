@@ -48,6 +48,7 @@
 #include <QCoreApplication>
 
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 
 void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManager,
                         ShotHistoryStorage* shotHistory, Settings* settings,
@@ -210,7 +211,7 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
 
             const QString dbPath = shotHistory->databasePath();
 
-            QThread* thread = QThread::create([dbPath, shotId, metadata, vizOverrides,
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, shotId, metadata, vizOverrides,
                                                respond, shotHistory, settings, visualizerUploader]() {
                 bool ok = false;
                 QString visualizerId;
@@ -300,9 +301,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                     respond(result);
                 }, Qt::QueuedConnection);
             });
-
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         },
         "control", McpTierCore);
 
@@ -343,7 +341,7 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
 
             const QString dbPath = shotHistory->databasePath();
 
-            QThread* thread = QThread::create([dbPath, shotId, respond, settings, visualizerUploader]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, shotId, respond, settings, visualizerUploader]() {
                 bool shotFound = false;
                 QString existingVisualizerId;
                 ShotProjection shot;
@@ -426,9 +424,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                         });
                     }, Qt::QueuedConnection);
             });
-
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         },
         "control", McpTierNiche);
 
@@ -1623,7 +1618,7 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                 return;
             }
             const QString dbPath = shotHistory->databasePath();
-            QThread* thread = QThread::create([dbPath, recipeId, revertMinutes, respond]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, recipeId, revertMinutes, respond]() {
                 QString name;
                 bool found = false;
                 const bool opened = withTempDb(dbPath, "mcp_recipe_get_auto_load", [&](QSqlDatabase& db) {
@@ -1651,8 +1646,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                     respond(result);
                 }, Qt::QueuedConnection);
             });
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         };
     const McpAsyncToolHandler recipeSetAutoLoad =
 [shotHistory, settings](const QJsonObject& args, std::function<void(QJsonObject)> respond) {
@@ -1680,7 +1673,7 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
             const bool hasRevert = args.contains("revertMinutes");
             const int revertMinutes = hasRevert ? args["revertMinutes"].toInt() : -1;
             const QString dbPath = shotHistory->databasePath();
-            QThread* thread = QThread::create([dbPath, recipeId, hasRevert, revertMinutes, settings, respond]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, recipeId, hasRevert, revertMinutes, settings, respond]() {
                 QString name;
                 bool found = false;
                 bool archived = false;
@@ -1716,8 +1709,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                     respond(result);
                 }, Qt::QueuedConnection);
             });
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         };
     const McpAsyncToolHandler recipeClearAutoLoad =
 [settings](const QJsonObject&, std::function<void(QJsonObject)> respond) {
@@ -1860,7 +1851,7 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
             }
             const bool includeEmpty = args["includeEmpty"].toBool();
             const QString dbPath = shotHistory->databasePath();
-            QThread* thread = QThread::create([dbPath, includeEmpty, bagToJson, respond]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, includeEmpty, bagToJson, respond]() {
                 QJsonArray bags;
                 const bool opened = withTempDb(dbPath, "mcp_bags", [&](QSqlDatabase& db) {
                     QSqlQuery query(db);
@@ -1883,8 +1874,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                     respond(QJsonObject{{"bags", bags}, {"count", bags.size()}});
                 }, Qt::QueuedConnection);
             });
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         }),
         McpRegistryHelpers::asyncAction("create", "settings",
 [bagToJson, bagStorage](const QJsonObject& args, std::function<void(QJsonObject)> respond) {
@@ -2064,40 +2053,12 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
             }
             const QString dbPath = shotHistory->databasePath();
 
-            // Load the just-updated bag on a background thread and respond.
-            // Always create the reader thread ON THE MAIN THREAD.
-            //
-            // This lambda is invoked from THREE places: :1842 (bagUpdated
-            // handler, main thread), :1857 (the headless fallback path, from
-            // INSIDE a QThread::create worker — the leak), and :1969 (the
-            // idempotent-merge early return, main thread via invokeMethod).
-            // Only the middle one runs off the main thread.
-            //
-            // In that second case the QThread built below inherited the
-            // WORKER's thread affinity, so deleteLater() on its finished()
-            // signal posted a DeferredDelete to the WORKER's event queue. A
-            // QThread::create thread never calls exec(), and has usually exited
-            // by then, so nothing ever processed that event: the QThread and
-            // its internals were never freed.
-            //
-            // Measured as 6,540 bytes / 70 allocations leaked in
-            // tst_mcptools_write. It survived a 250 ms drain of the MAIN
-            // thread's event queue — because the pending delete was never on
-            // the main thread's queue at all, which is what made two earlier
-            // explanations of this leak wrong. Confirmed by probe: on the
-            // fallback path this lambda reported
-            // currentThread() != qApp->thread() on every call.
-            //
-            // The hop makes affinity identical on all three paths, so the
-            // deferred delete always lands on an event loop that actually runs.
-            //
-            // Confirmed, not assumed: the nightly Linux ASan job reported
-            // 6,540 bytes / 70 allocations here before this change and ZERO
-            // after (run 29707910438, 84/84, no LeakSanitizer reports).
-            // LeakSanitizer is Linux-only, so no local run could have shown it.
+            // Load the just-updated bag on a background task and respond.
+            // Called from the bagUpdated handler, the headless fallback path
+            // (itself on a worker) and the idempotent-merge early return, so it
+            // submits from wherever it is; the result always hops to qApp.
             auto respondWithBag = [dbPath, bagId, bagToJson, respond]() {
-              QMetaObject::invokeMethod(qApp, [dbPath, bagId, bagToJson, respond]() {
-                QThread* t = QThread::create([dbPath, bagId, bagToJson, respond]() {
+                TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, bagId, bagToJson, respond]() {
                     CoffeeBag updated;
                     withTempDb(dbPath, "mcp_bagupd_read", [&](QSqlDatabase& db) {
                         updated = CoffeeBagStorage::loadBagStatic(db, bagId);
@@ -2114,9 +2075,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                         respond(QJsonObject{{"success", true}, {"bag", bagToJson(updated)}});
                     }, Qt::QueuedConnection);
                 });
-                QObject::connect(t, &QThread::finished, t, &QObject::deleteLater);
-                t->start();
-              }, Qt::QueuedConnection);
             };
 
             // onSuccess runs ONLY after the write is confirmed. Anything with
@@ -2158,7 +2116,7 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
 
                 // Fallback (no storage instance — e.g. headless tests): direct
                 // static write. Skips the in-app refresh/sync signals.
-                QThread* thread = QThread::create([dbPath, bagId, finalFields, respondWithBag, respond, onSuccess]() {
+                TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, bagId, finalFields, respondWithBag, respond, onSuccess]() {
                     bool success = false;
                     withTempDb(dbPath, "mcp_bagupd", [&](QSqlDatabase& db) {
                         success = CoffeeBagStorage::updateBagFieldsStatic(db, bagId, finalFields);
@@ -2174,8 +2132,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                         }, Qt::QueuedConnection);
                     }
                 });
-                QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-                thread->start();
             };
 
             // No blob work: column-only update goes straight through. Identity
@@ -2198,7 +2154,7 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
 
             // Read the current blob, merge, then run the normal update.
             QPointer<BeanBaseClient> safeBeanbase(beanbase);
-            QThread* mergeThread = QThread::create([dbPath, bagId, fields, blobEdits, safeBeanbase,
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, bagId, fields, blobEdits, safeBeanbase,
                                                    proceed, respondWithBag, respond]() {
                 bool found = false;
                 bool isTea = false;
@@ -2316,8 +2272,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                     proceed(finalFields, refreshPhoto);
                 }, Qt::QueuedConnection);
             });
-            QObject::connect(mergeThread, &QThread::finished, mergeThread, &QObject::deleteLater);
-            mergeThread->start();
         }),
         McpRegistryHelpers::asyncAction("select", "control",
 [shotHistory, settings](const QJsonObject& args, std::function<void(QJsonObject)> respond) {
@@ -2349,7 +2303,7 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
             }
             // Validate the bag exists before selecting it.
             const QString dbPath = shotHistory->databasePath();
-            QThread* thread = QThread::create([dbPath, bagId, settings, respond]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, bagId, settings, respond]() {
                 CoffeeBag bag;
                 // The open result is checked: a database that cannot be opened
                 // otherwise reports as "Bag not found", which sends the caller
@@ -2372,8 +2326,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                                             .arg(bag.roasterName, bag.coffeeName).trimmed()}});
                 }, Qt::QueuedConnection);
             });
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         }),
     };
 
@@ -2506,7 +2458,7 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
             }
             const qint64 activeId = settings ? settings->dye()->activeEquipmentId() : -1;
             const QString dbPath = shotHistory->databasePath();
-            QThread* thread = QThread::create([dbPath, activeId, packageToJson, respond]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, activeId, packageToJson, respond]() {
                 QJsonArray packages;
                 const bool opened = withTempDb(dbPath, "mcp_equip", [&](QSqlDatabase& db) {
                     for (const EquipmentPackageView& v : EquipmentStorage::loadInventoryStatic(db))
@@ -2517,8 +2469,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                     respond(QJsonObject{{"packages", packages}, {"count", packages.size()}});
                 }, Qt::QueuedConnection);
             });
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         }),
         McpRegistryHelpers::asyncAction("select", "control",
 [shotHistory, settings](const QJsonObject& args, std::function<void(QJsonObject)> respond) {
@@ -2529,7 +2479,7 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
             const qint64 packageId = args["packageId"].toInteger();
             if (packageId <= 0) { respond(QJsonObject{{"error", "Valid packageId is required"}}); return; }
             const QString dbPath = shotHistory->databasePath();
-            QThread* thread = QThread::create([dbPath, packageId, settings, respond]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, packageId, settings, respond]() {
                 EquipmentPackageView view;
                 // Checked, like the `list` action above it: an unopenable database
                 // otherwise answers "Package not found", which is a different problem
@@ -2558,8 +2508,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                                  pkgMap.value("grinderModel").toString()).trimmed()}});
                 }, Qt::QueuedConnection);
             });
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         }),
         McpRegistryHelpers::asyncAction("update", "settings",
 [shotHistory, settings, packageToJson, fillShotCount](const QJsonObject& args, std::function<void(QJsonObject)> respond) {
@@ -2595,7 +2543,7 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
             }
             const qint64 activeId = settings ? settings->dye()->activeEquipmentId() : -1;
             const QString dbPath = shotHistory->databasePath();
-            QThread* thread = QThread::create([=]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [=]() {
                 bool ok = false;
                 qint64 resultId = packageId;
                 EquipmentPackageView view;
@@ -2675,8 +2623,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                     respond(QJsonObject{{"success", true}, {"package", packageToJson(view, activeId)}});
                 }, Qt::QueuedConnection);
             });
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         }),
         McpRegistryHelpers::asyncAction("merge", "settings",
 [shotHistory, settings, packageToJson, fillShotCount](const QJsonObject& args, std::function<void(QJsonObject)> respond) {
@@ -2692,7 +2638,7 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
             }
             const qint64 activeId = settings ? settings->dye()->activeEquipmentId() : -1;
             const QString dbPath = shotHistory->databasePath();
-            QThread* thread = QThread::create([=]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [=]() {
                 EquipmentMergeResult merge;
                 EquipmentPackageView view;
                 const bool opened = withTempDb(dbPath, "mcp_equip_merge", [&](QSqlDatabase& db) {
@@ -2736,8 +2682,6 @@ void registerWriteTools(McpToolRegistry* registry, ProfileManager* profileManage
                         {"recipesMoved", merge.recipesMoved}});
                 }, Qt::QueuedConnection);
             });
-            QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-            thread->start();
         }, QStringLiteral("Fold one equipment package into another and delete it — irreversible")),
     };
 
@@ -8,9 +8,17 @@
 #include <QThread>
 #include <QSqlDatabase>
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 #include <QSqlError>
 #include <QSqlQuery>
 
+// The three curves the calibration graph draws — a full load would also
+// decode the rest and re-run the badge detectors for every shot scanned.
+static constexpr ShotSampleBlob::SeriesMask kCalibrationSeries =
+    ShotSampleBlob::seriesBit(ShotSampleBlob::Series::Pressure)
+    | ShotSampleBlob::seriesBit(ShotSampleBlob::Series::Flow)
+    | ShotSampleBlob::seriesBit(ShotSampleBlob::Series::WeightFlowRate);
+
 FlowCalibrationModel::FlowCalibrationModel(QObject* parent)
     : QObject(parent)
 {
@@ -57,7 +65,7 @@ void FlowCalibrationModel::loadRecentShots() {
     const QString dbPath = m_storage->databasePath();
     auto destroyed = m_destroyed;
 
-    QThread* thread = QThread::create([this, dbPath, destroyed]() {
+    TaskExecutor::instance().submit(TaskLane::Interactive, [this, dbPath, destroyed]() {
         QVector<qint64> shotIds;
         ShotRecord firstRecord;
         bool dbFailed = !withTempDb(dbPath, "fcm_recent", [&](QSqlDatabase& db) {
@@ -67,7 +75,8 @@ void FlowCalibrationModel::loadRecentShots() {
             } else if (query.exec()) {
                 while (query.next()) {
                     qint64 id = query.value(0).toLongLong();
-                    ShotRecord record = ShotHistoryStorage::loadShotRecordStatic(db, id);
+                    ShotRecord record = ShotHistoryStorage::loadShotRecordStatic(
+                        db, id, nullptr, kCalibrationSeries);
                     if (!record.weightFlowRate.isEmpty()) {
                         shotIds.append(id);
                         if (shotIds.size() == 1) {
@@ -115,10 +124,7 @@ void FlowCalibrationModel::loadRecentShots() {
             emit navigationChanged();
             setLoading(false);
         }, Qt::QueuedConnection);
-    });
-
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
+    }, destroyed);
 }
 
 void FlowCalibrationModel::previousShot() {
@@ -159,10 +165,10 @@ void FlowCalibrationModel::loadCurrentShot() {
     const qint64 shotId = m_shotIds[m_currentIndex];
     auto destroyed = m_destroyed;
 
-    QThread* thread = QThread::create([this, dbPath, shotId, destroyed]() {
+    TaskExecutor::instance().submit(TaskLane::Interactive, [this, dbPath, shotId, destroyed]() {
         ShotRecord record;
         bool dbFailed = !withTempDb(dbPath, "fcm_shot", [&](QSqlDatabase& db) {
-            record = ShotHistoryStorage::loadShotRecordStatic(db, shotId);
+            record = ShotHistoryStorage::loadShotRecordStatic(db, shotId, nullptr, kCalibrationSeries);
         });
 
         QMetaObject::invokeMethod(this, [this, record = std::move(record), dbFailed, destroyed]() {
@@ -181,10 +187,7 @@ void FlowCalibrationModel::loadCurrentShot() {
             applyShotRecord(record);
             setLoading(false);
         }, Qt::QueuedConnection);
-    });
-
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
+    }, destroyed);
 }
 
 void FlowCalibrationModel::applyShotRecord(const ShotRecord& record) {
@@ -5,8 +5,9 @@
 #include <QLocale>
 #include <QSqlDatabase>
 #include "../core/dbutils.h"
-#include <QThread>
+#include "../core/taskexecutor.h"
 #include <algorithm>
+#include <cmath>
 
 // Shot colors: Green, Blue, Orange
 const QList<QColor> ShotComparisonModel::SHOT_COLORS = {
@@ -102,6 +103,7 @@ void ShotComparisonModel::removeShot(qint64 shotId)
 void ShotComparisonModel::clearAll()
 {
     ++m_loadSerial;  // Invalidate any in-flight background loads
+    *m_loadCancelled = true;
     m_shotIds.clear();
     m_displayShots.clear();
     m_windowStart = 0;
@@ -159,6 +161,9 @@ void ShotComparisonModel::scheduleLoad()
     // Increment serial so any in-flight load knows its result is stale
     ++m_loadSerial;
     int serial = m_loadSerial;
+    // A load still queued behind other work is superseded too: skip it outright.
+    *m_loadCancelled = true;
+    m_loadCancelled = std::make_shared<std::atomic<bool>>(false);
 
     if (m_shotIds.isEmpty() || !m_storage) {
         m_displayShots.clear();
@@ -191,11 +196,23 @@ void ShotComparisonModel::scheduleLoad()
     // Open a dedicated SQLite connection on the worker thread, load the shots,
     // and deliver results back to the main thread via a queued invocation.
     // Qt guarantees the functor is not called if `this` is already destroyed.
-    QThread* thread = QThread::create([this, dbPath, windowIds, serial]() {
+    TaskExecutor::instance().submit(TaskLane::Interactive, [this, dbPath, windowIds, serial]() {
+        // Only the curves the comparison graph plots. Goals and water
+        // dispensed are never drawn here, and leaving a detector input out
+        // also skips the badge recompute this model has no use for.
+        using ShotSampleBlob::Series;
+        using ShotSampleBlob::seriesBit;
+        constexpr ShotSampleBlob::SeriesMask kComparisonSeries = seriesBit(Series::Pressure)
+            | seriesBit(Series::Flow) | seriesBit(Series::Temperature)
+            | seriesBit(Series::TemperatureMix) | seriesBit(Series::TemperatureMixGoal)
+            | seriesBit(Series::Weight) | seriesBit(Series::WeightFlowRate)
+            | ShotSampleBlob::kDerivedSeries;
+
         QList<ComparisonShot> shots;
         withTempDb(dbPath, "scm_load", [&](QSqlDatabase& db) {
             for (qint64 id : windowIds) {
-                ShotRecord record = ShotHistoryStorage::loadShotRecordStatic(db, id);
+                ShotRecord record = ShotHistoryStorage::loadShotRecordStatic(
+                    db, id, nullptr, kComparisonSeries);
                 if (record.summary.id == 0) continue;
 
                 ComparisonShot shot;
@@ -255,11 +272,7 @@ void ShotComparisonModel::scheduleLoad()
             emit loadingChanged();
             emit shotsChanged();
         }, Qt::QueuedConnection);
-    });
-
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    m_loadThread = thread;
-    thread->start();
+    }, m_loadCancelled);
 }
 
 void ShotComparisonModel::calculateMaxValues()
@@ -298,82 +311,65 @@ void ShotComparisonModel::calculateMaxValues()
     }
 }
 
-QVariantList ShotComparisonModel::pointsToVariant(const QVector<QPointF>& points) const
+QList<QPointF> ShotComparisonModel::curve(int index, QVector<QPointF> ComparisonShot::* series) const
 {
-    QVariantList result;
-    for (const auto& pt : points) {
-        QVariantMap p;
-        p["x"] = pt.x();
-        p["y"] = pt.y();
-        result.append(p);
-    }
-    return result;
+    if (index < 0 || index >= m_displayShots.size()) return {};
+    return m_displayShots[index].*series;  // implicitly shared, not copied
 }
 
-QVariantList ShotComparisonModel::getPressureData(int index) const
+QList<QPointF> ShotComparisonModel::getPressureData(int index) const
 {
-    if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].pressure);
+    return curve(index, &ComparisonShot::pressure);
 }
 
-QVariantList ShotComparisonModel::getFlowData(int index) const
+QList<QPointF> ShotComparisonModel::getFlowData(int index) const
 {
-    if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].flow);
+    return curve(index, &ComparisonShot::flow);
 }
 
-QVariantList ShotComparisonModel::getTemperatureData(int index) const
+QList<QPointF> ShotComparisonModel::getTemperatureData(int index) const
 {
-    if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].temperature);
+    return curve(index, &ComparisonShot::temperature);
 }
 
-QVariantList ShotComparisonModel::getWeightData(int index) const
+QList<QPointF> ShotComparisonModel::getWeightData(int index) const
 {
-    if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].weight);
+    return curve(index, &ComparisonShot::weight);
 }
 
-QVariantList ShotComparisonModel::getWeightFlowRateData(int index) const
+QList<QPointF> ShotComparisonModel::getWeightFlowRateData(int index) const
 {
-    if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].weightFlowRate);
+    return curve(index, &ComparisonShot::weightFlowRate);
 }
 
-QVariantList ShotComparisonModel::getResistanceData(int index) const
+QList<QPointF> ShotComparisonModel::getResistanceData(int index) const
 {
-    if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].resistance);
+    return curve(index, &ComparisonShot::resistance);
 }
 
-QVariantList ShotComparisonModel::getConductanceData(int index) const
+QList<QPointF> ShotComparisonModel::getConductanceData(int index) const
 {
-    if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].conductance);
+    return curve(index, &ComparisonShot::conductance);
 }
 
-QVariantList ShotComparisonModel::getConductanceDerivativeData(int index) const
+QList<QPointF> ShotComparisonModel::getConductanceDerivativeData(int index) const
 {
-    if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].conductanceDerivative);
+    return curve(index, &ComparisonShot::conductanceDerivative);
 }
 
-QVariantList ShotComparisonModel::getDarcyResistanceData(int index) const
+QList<QPointF> ShotComparisonModel::getDarcyResistanceData(int index) const
 {
-    if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].darcyResistance);
+    return curve(index, &ComparisonShot::darcyResistance);
 }
 
-QVariantList ShotComparisonModel::getTemperatureMixData(int index) const
+QList<QPointF> ShotComparisonModel::getTemperatureMixData(int index) const
 {
-    if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].temperatureMix);
+    return curve(index, &ComparisonShot::temperatureMix);
 }
 
-QVariantList ShotComparisonModel::getTemperatureMixGoalData(int index) const
+QList<QPointF> ShotComparisonModel::getTemperatureMixGoalData(int index) const
 {
-    if (index < 0 || index >= m_displayShots.size()) return QVariantList();
-    return pointsToVariant(m_displayShots[index].temperatureMixGoal);
+    return curve(index, &ComparisonShot::temperatureMixGoal);
 }
 
 QVariantList ShotComparisonModel::getPhaseMarkers(int index) const
@@ -438,6 +434,34 @@ QVariantMap ShotComparisonModel::getShotInfo(int index) const
     return result;
 }
 
+namespace {
+
+// The y of the sample nearest `time`, if one lies within 1 s; `missing`
+// otherwise. Samples are sorted by time, so this is a binary search plus a
+// look at the neighbour on each side. On a tie, and among samples sharing a
+// timestamp, the earliest wins — what the linear scan this replaced returned.
+double nearestValue(const QVector<QPointF>& points, double time, double missing,
+                    bool* found = nullptr)
+{
+    if (found) *found = false;
+    if (points.isEmpty()) return missing;
+
+    auto it = std::lower_bound(points.cbegin(), points.cend(), time,
+                               [](const QPointF& p, double t) { return p.x() < t; });
+    qsizetype best = it - points.cbegin();
+    if (best == points.size()
+        || (best > 0 && std::abs(points[best - 1].x() - time) <= std::abs(points[best].x() - time))) {
+        --best;
+        while (best > 0 && points[best - 1].x() == points[best].x()) --best;
+    }
+
+    if (std::abs(points[best].x() - time) >= 1.0) return missing;
+    if (found) *found = true;
+    return points[best].y();
+}
+
+}  // namespace
+
 QVariantMap ShotComparisonModel::getValuesAtTime(int index, double time) const
 {
     QVariantMap result;
@@ -445,49 +469,22 @@ QVariantMap ShotComparisonModel::getValuesAtTime(int index, double time) const
 
     const auto& shot = m_displayShots[index];
 
-    // Returns the Y value of the nearest point within 1 second, or -1.0 if none.
-    auto findNearest = [](const QVector<QPointF>& points, double t) -> double {
-        if (points.isEmpty()) return -1.0;
-        double closest = points[0].y();
-        double minDist = std::abs(points[0].x() - t);
-        for (const auto& pt : points) {
-            double dist = std::abs(pt.x() - t);
-            if (dist < minDist) {
-                minDist = dist;
-                closest = pt.y();
-            } else if (dist > minDist) {
-                break;  // data sorted by x
-            }
-        }
-        return minDist < 1.0 ? closest : -1.0;
-    };
-
-    double pressure    = findNearest(shot.pressure, time);
-    double flow        = findNearest(shot.flow, time);
-    double temp        = findNearest(shot.temperature, time);
-    double weight      = findNearest(shot.weight, time);
-    double weightFlow  = findNearest(shot.weightFlowRate, time);
-    double resistance  = findNearest(shot.resistance, time);
-    double conductance = findNearest(shot.conductance, time);
-    double darcy       = findNearest(shot.darcyResistance, time);
-    double mixTemp     = findNearest(shot.temperatureMix, time);
-    double mixTempGoal = findNearest(shot.temperatureMixGoal, time);
+    double pressure    = nearestValue(shot.pressure, time, -1.0);
+    double flow        = nearestValue(shot.flow, time, -1.0);
+    double temp        = nearestValue(shot.temperature, time, -1.0);
+    double weight      = nearestValue(shot.weight, time, -1.0);
+    double weightFlow  = nearestValue(shot.weightFlowRate, time, -1.0);
+    double resistance  = nearestValue(shot.resistance, time, -1.0);
+    double conductance = nearestValue(shot.conductance, time, -1.0);
+    double darcy       = nearestValue(shot.darcyResistance, time, -1.0);
+    double mixTemp     = nearestValue(shot.temperatureMix, time, -1.0);
+    double mixTempGoal = nearestValue(shot.temperatureMixGoal, time, -1.0);
 
     // dC/dt uses a sentinel distinct from flow/pressure (it legitimately ranges
-    // negative). findNearest returns -1.0 for "missing", but a real dC/dt value
-    // could be -1.0, so we use a custom lookup for this series.
+    // negative). The others read -1.0 as "missing", but a real dC/dt value
+    // could be -1.0, so this series reports presence separately.
     bool hasDcdt = false;
-    double dcdt = 0.0;
-    if (!shot.conductanceDerivative.isEmpty()) {
-        double best = shot.conductanceDerivative[0].y();
-        double minDist = std::abs(shot.conductanceDerivative[0].x() - time);
-        for (const auto& pt : shot.conductanceDerivative) {
-            double dist = std::abs(pt.x() - time);
-            if (dist < minDist) { minDist = dist; best = pt.y(); }
-            else if (dist > minDist) break;
-        }
-        if (minDist < 1.0) { dcdt = best; hasDcdt = true; }
-    }
+    double dcdt = nearestValue(shot.conductanceDerivative, time, 0.0, &hasDcdt);
 
     result["hasPressure"]    = pressure    >= 0.0;
     result["hasFlow"]        = flow        >= 0.0;
@@ -498,7 +495,7 @@ QVariantMap ShotComparisonModel::getValuesAtTime(int index, double time) const
     result["hasConductance"] = conductance >= 0.0;
     result["hasDarcyResistance"] = darcy   >= 0.0;
     result["hasTemperatureMix"]  = mixTemp >= 0.0;
-    // False for shots recorded before the mix goal series existed — findNearest
+    // False for shots recorded before the mix goal series existed — nearestValue
     // returns the -1.0 "missing" sentinel for an empty series.
     result["hasTemperatureMixGoal"] = mixTempGoal >= 0.0;
     result["hasConductanceDerivative"] = hasDcdt;
@@ -5,7 +5,9 @@
 #include <QPointF>
 #include <QVariantList>
 #include <QColor>
-#include <QThread>
+
+#include <atomic>
+#include <memory>
 
 #include <QtQml/qqmlregistration.h>
 class ShotHistoryStorage;
@@ -69,20 +71,27 @@ public:
     Q_INVOKABLE void shiftWindowRight();
     Q_INVOKABLE void setWindowStart(int index);
 
-    Q_INVOKABLE QVariantList getPressureData(int index) const;
-    Q_INVOKABLE QVariantList getFlowData(int index) const;
-    Q_INVOKABLE QVariantList getTemperatureData(int index) const;
-    Q_INVOKABLE QVariantList getWeightData(int index) const;
-    Q_INVOKABLE QVariantList getWeightFlowRateData(int index) const;
-    Q_INVOKABLE QVariantList getResistanceData(int index) const;
-    Q_INVOKABLE QVariantList getConductanceData(int index) const;
-    Q_INVOKABLE QVariantList getConductanceDerivativeData(int index) const;
-    Q_INVOKABLE QVariantList getDarcyResistanceData(int index) const;
-    Q_INVOKABLE QVariantList getTemperatureMixData(int index) const;
-    Q_INVOKABLE QVariantList getTemperatureMixGoalData(int index) const;
+    // Curves cross into QML as typed sequences (QList<QPointF>), not lists of
+    // boxed points: JS reads them like the arrays they replaced — length,
+    // [i].x, [i].y — but a call shares the shot's own vector instead of
+    // building a QVariantMap per point. The comparison graph calls these for
+    // 3 shots × 11 curves on every window change.
+    Q_INVOKABLE QList<QPointF> getPressureData(int index) const;
+    Q_INVOKABLE QList<QPointF> getFlowData(int index) const;
+    Q_INVOKABLE QList<QPointF> getTemperatureData(int index) const;
+    Q_INVOKABLE QList<QPointF> getWeightData(int index) const;
+    Q_INVOKABLE QList<QPointF> getWeightFlowRateData(int index) const;
+    Q_INVOKABLE QList<QPointF> getResistanceData(int index) const;
+    Q_INVOKABLE QList<QPointF> getConductanceData(int index) const;
+    Q_INVOKABLE QList<QPointF> getConductanceDerivativeData(int index) const;
+    Q_INVOKABLE QList<QPointF> getDarcyResistanceData(int index) const;
+    Q_INVOKABLE QList<QPointF> getTemperatureMixData(int index) const;
+    Q_INVOKABLE QList<QPointF> getTemperatureMixGoalData(int index) const;
     Q_INVOKABLE QVariantList getPhaseMarkers(int index) const;
 
     Q_INVOKABLE QVariantMap getShotInfo(int index) const;
+    // Each curve's value at its sample nearest `time` (within 1 s), found by
+    // binary search — the crosshair calls this per shot on every drag step.
     Q_INVOKABLE QVariantMap getValuesAtTime(int index, double time) const;
 
     Q_INVOKABLE QColor getShotColor(int index) const;
@@ -99,7 +108,6 @@ private:
     // current window, and delivers results back to the main thread via finished().
     void scheduleLoad();
     void calculateMaxValues();
-    QVariantList pointsToVariant(const QVector<QPointF>& points) const;
 
     struct ComparisonShot {
         qint64 id = 0;
@@ -145,12 +153,15 @@ private:
         QList<PhaseMarker> phases;
     };
 
+    QList<QPointF> curve(int index, QVector<QPointF> ComparisonShot::* series) const;
+
     ShotHistoryStorage* m_storage = nullptr;
     QList<qint64> m_shotIds;
     QList<ComparisonShot> m_displayShots;
     int m_windowStart = 0;
     bool m_loading = false;
-    QThread* m_loadThread = nullptr;  // Tracked so superseded loads can be abandoned
+    // Set when a newer load supersedes the queued one, so it never starts.
+    std::shared_ptr<std::atomic<bool>> m_loadCancelled = std::make_shared<std::atomic<bool>>(false);
     int m_loadSerial = 0;             // Incremented on each scheduleLoad(); stale results ignored
 
     double m_maxTime = 60.0;
@@ -161,4 +172,10 @@ private:
     static constexpr int DISPLAY_WINDOW_SIZE = 3;
     static const QList<QColor> SHOT_COLORS;
     static const QList<QColor> SHOT_COLORS_LIGHT;
+
+#ifdef DECENZA_TESTING
+    // Seeds m_displayShots directly, so the accessors can be checked and
+    // benchmarked without a database behind the window load.
+    friend class tst_ShotComparisonModel;
+#endif
 };
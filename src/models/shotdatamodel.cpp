@@ -1,31 +1,18 @@
 #include "shotdatamodel.h"
 #include "ai/conductance.h"
+#include "core/latencystats.h"
 #include "rendering/fastlinerenderer.h"
 #include <QDebug>
 
 ShotDataModel::ShotDataModel(QObject* parent)
     : QObject(parent)
 {
-    // Pre-allocate vectors to avoid reallocations during shot
-    m_pressurePoints.reserve(INITIAL_CAPACITY);
-    m_flowPoints.reserve(INITIAL_CAPACITY);
-    m_temperaturePoints.reserve(INITIAL_CAPACITY);
-    m_temperatureMixPoints.reserve(INITIAL_CAPACITY);
-    m_resistancePoints.reserve(INITIAL_CAPACITY);
-    m_conductancePoints.reserve(INITIAL_CAPACITY);
-    m_darcyResistancePoints.reserve(INITIAL_CAPACITY);
-    m_waterDispensedPoints.reserve(INITIAL_CAPACITY);
-    m_temperatureGoalPoints.reserve(INITIAL_CAPACITY);
-    m_temperatureMixGoalPoints.reserve(INITIAL_CAPACITY);
-    m_weightPoints.reserve(INITIAL_CAPACITY);
-    m_cumulativeWeightPoints.reserve(INITIAL_CAPACITY);
-    m_weightFlowRatePoints.reserve(INITIAL_CAPACITY);
-
-    // Initialize first segments for goal curves
-    m_pressureGoalSegments.append(QVector<QPointF>());
-    m_pressureGoalSegments[0].reserve(INITIAL_CAPACITY);
-    m_flowGoalSegments.append(QVector<QPointF>());
-    m_flowGoalSegments[0].reserve(INITIAL_CAPACITY);
+    // m_samples is pre-allocated at INITIAL_CAPACITY rows per clock, first
+    // goal segments included, so a shot doesn't reallocate while it runs.
+
+    // A flush normally finds one or two; 64 covers a main thread stalled for
+    // several seconds without a reallocation on the way back.
+    m_unflushedReceivedMs.reserve(64);
 
     // Chart update timer (~30fps) - batches data samples for efficient chart redraw
     m_flushTimer = new QTimer(this);
@@ -69,32 +56,32 @@ void ShotDataModel::registerFastSeries(FastLineRenderer* pressure, FastLineRende
     m_lastFlushedTemperatureMix = 0;
 
     // Bulk-load any existing data (e.g., returning to espresso page after shot)
-    if (!m_pressurePoints.isEmpty() || !m_flowPoints.isEmpty() || !m_weightPoints.isEmpty()) {
+    using Channel = ShotSampleBuffer::Channel;
+    const SampleColumn weight = column(Channel::Weight);
+    const SampleColumn weightFlow = column(Channel::WeightFlowRate);
+    if (m_samples.sampleCount() > 0 || !weight.isEmpty()) {
         qDebug() << "ShotDataModel: Populating fast renderers with existing data ("
-                 << m_pressurePoints.size() << " pressure,"
-                 << m_flowPoints.size() << " flow,"
-                 << m_weightPoints.size() << " weight,"
-                 << m_weightFlowRatePoints.size() << " weight flow)";
-        if (m_fastPressure) m_fastPressure->setPoints(m_pressurePoints);
-        if (m_fastFlow) m_fastFlow->setPoints(m_flowPoints);
-        if (m_fastTemperature) m_fastTemperature->setPoints(m_temperaturePoints);
-        if (m_fastWeight) m_fastWeight->setPoints(m_weightPoints);
-        if (m_fastWeightFlow) m_fastWeightFlow->setPoints(m_weightFlowRatePoints);
-        if (m_fastResistance) m_fastResistance->setPoints(m_resistancePoints);
-        if (m_fastConductance) m_fastConductance->setPoints(m_conductancePoints);
-        if (m_fastDarcyResistance) m_fastDarcyResistance->setPoints(m_darcyResistancePoints);
-        if (m_fastTemperatureMix) m_fastTemperatureMix->setPoints(m_temperatureMixPoints);
-
-        // Mark all as flushed
-        m_lastFlushedPressure = m_pressurePoints.size();
-        m_lastFlushedFlow = m_flowPoints.size();
-        m_lastFlushedTemp = m_temperaturePoints.size();
-        m_lastFlushedWeight = m_weightPoints.size();
-        m_lastFlushedWeightFlow = m_weightFlowRatePoints.size();
-        m_lastFlushedResistance = m_resistancePoints.size();
-        m_lastFlushedConductance = m_conductancePoints.size();
-        m_lastFlushedDarcyResistance = m_darcyResistancePoints.size();
-        m_lastFlushedTemperatureMix = m_temperatureMixPoints.size();
+                 << m_samples.sampleCount() << " samples,"
+                 << weight.size() << " weight,"
+                 << weightFlow.size() << " weight flow)";
+        auto load = [](FastLineRenderer* renderer, const SampleColumn& points, qsizetype* lastFlushed) {
+            if (renderer) renderer->setPoints(points.times(), points.values(), points.size());
+            *lastFlushed = points.size();
+        };
+        load(m_fastPressure, column(Channel::Pressure), &m_lastFlushedPressure);
+        load(m_fastFlow, column(Channel::Flow), &m_lastFlushedFlow);
+        load(m_fastTemperature, column(Channel::Temperature), &m_lastFlushedTemp);
+        load(m_fastWeightFlow, weightFlow, &m_lastFlushedWeightFlow);
+        load(m_fastResistance, column(Channel::Resistance), &m_lastFlushedResistance);
+        load(m_fastConductance, column(Channel::Conductance), &m_lastFlushedConductance);
+        load(m_fastDarcyResistance, column(Channel::DarcyResistance), &m_lastFlushedDarcyResistance);
+        load(m_fastTemperatureMix, column(Channel::TemperatureMix), &m_lastFlushedTemperatureMix);
+
+        // The weight graph's leading zero isn't stored, so it is the one
+        // series that goes through a materialized copy.
+        const QVector<QPointF> weightGraph = weightData();
+        if (m_fastWeight) m_fastWeight->setPoints(weightGraph);
+        m_lastFlushedWeight = weightGraph.size();
     }
 
     qDebug() << "ShotDataModel: Registered fast renderers (QSGGeometryNode, pre-allocated VBO)";
@@ -102,7 +89,8 @@ void ShotDataModel::registerFastSeries(FastLineRenderer* pressure, FastLineRende
     // Replay any goal-curve data we already accumulated so DashedLineSeries
     // bindings see the current state immediately (e.g., returning to the
     // espresso page after a shot completes).
-    if (!m_pressureGoalSegments.isEmpty() && !m_pressureGoalSegments[0].isEmpty()) {
+    const auto& pressureGoalSegments = m_samples.goalSegments(ShotSampleBuffer::GoalCurve::Pressure);
+    if (!pressureGoalSegments.isEmpty() && !pressureGoalSegments[0].isEmpty()) {
         m_goalCurvesDirty = true;
         m_dirty = true;
         onFlushTimerTick();
@@ -115,32 +103,13 @@ void ShotDataModel::clear() {
     // Stop timer during clear
     m_flushTimer->stop();
 
-    // Clear data vectors (keep capacity)
-    m_pressurePoints.clear();
-    m_flowPoints.clear();
-    m_temperaturePoints.clear();
-    m_temperatureMixPoints.clear();
-    m_resistancePoints.clear();
-    m_conductancePoints.clear();
-    m_darcyResistancePoints.clear();
-    m_conductanceDerivativePoints.clear();
-    m_waterDispensedPoints.clear();
-    m_temperatureGoalPoints.clear();
-    m_temperatureMixGoalPoints.clear();
-    m_weightPoints.clear();
-    m_cumulativeWeightPoints.clear();
-    m_weightFlowRatePoints.clear();
-    m_weightFlowRateRawPoints.clear();
+    // Clear sample storage (keeps the arenas, unless the last shot's save or
+    // upload still holds them — then this shot starts on fresh ones) and
+    // resets the goal segments to one empty segment each
+    m_samples.clear();
+    m_unflushedReceivedMs.clear();  // Never drawn, so never timed
     m_consecutiveSpikeRejections = 0;
 
-    // Reset goal segments - keep first segment with capacity
-    m_pressureGoalSegments.clear();
-    m_pressureGoalSegments.append(QVector<QPointF>());
-    m_pressureGoalSegments[0].reserve(INITIAL_CAPACITY);
-    m_flowGoalSegments.clear();
-    m_flowGoalSegments.append(QVector<QPointF>());
-    m_flowGoalSegments[0].reserve(INITIAL_CAPACITY);
-
     // Clear fast renderers
     if (m_fastPressure) m_fastPressure->clear();
     if (m_fastFlow) m_fastFlow->clear();
@@ -187,10 +156,7 @@ void ShotDataModel::clear() {
 
 void ShotDataModel::clearWeightData() {
     // Clear any pre-tare weight samples (race condition fix)
-    m_weightPoints.clear();
-    m_cumulativeWeightPoints.clear();
-    m_weightFlowRatePoints.clear();
-    m_weightFlowRateRawPoints.clear();
+    m_samples.clearWeights();
     if (m_fastWeight) m_fastWeight->clear();
     if (m_fastWeightFlow) m_fastWeightFlow->clear();
     m_lastFlushedWeight = 0;
@@ -204,14 +170,11 @@ void ShotDataModel::addSample(double time, double pressure, double flow, double
                               double mixTemp,
                               double pressureGoal, double flowGoal, double temperatureGoal,
                               double temperatureMixGoal,
-                              int frameNumber, bool isFlowMode) {
+                              int frameNumber, bool isFlowMode, qint64 receivedMs) {
     Q_UNUSED(frameNumber);
 
-    // Pure vector append - no signals, no chart updates
-    m_pressurePoints.append(QPointF(time, pressure));
-    m_flowPoints.append(QPointF(time, flow));
-    m_temperaturePoints.append(QPointF(time, temperature));
-    m_temperatureMixPoints.append(QPointF(time, mixTemp));
+    if (receivedMs > 0)
+        m_unflushedReceivedMs.append(receivedMs);
 
     // Resistance (P/F), conductance (F²/P) and Darcy resistance (P/F², the
     // inverse of conductance) all live in the Conductance:: namespace and are
@@ -222,36 +185,34 @@ void ShotDataModel::addSample(double time, double pressure, double flow, double
     const double resistance = Conductance::resistance(pressure, flow);
     const double conductance = Conductance::sample(pressure, flow);
     const double darcyResistance = Conductance::darcyResistanceSample(pressure, flow);
-    m_resistancePoints.append(QPointF(time, resistance));
-    m_conductancePoints.append(QPointF(time, conductance));
-    m_darcyResistancePoints.append(QPointF(time, darcyResistance));
 
     // Water dispensed: cumulative flow integration (flow is ml/s)
     double waterDispensed = 0.0;
-    if (!m_waterDispensedPoints.isEmpty()) {
-        double lastWater = m_waterDispensedPoints.last().y();
-        double lastTime = m_waterDispensedPoints.last().x();
+    const SampleColumn water = column(ShotSampleBuffer::Channel::WaterDispensed);
+    if (!water.isEmpty()) {
+        double lastWater = water.last().y();
+        double lastTime = water.last().x();
         double dt = time - lastTime;
         if (dt > 0) {
             waterDispensed = lastWater + flow * dt;
         }
     }
-    m_waterDispensedPoints.append(QPointF(time, waterDispensed));
+
+    // Pure column append - no signals, no chart updates
+    m_samples.appendMachineSample(time, pressure, flow, temperature, mixTemp,
+                                  resistance, conductance, darcyResistance, waterDispensed,
+                                  temperatureGoal, temperatureMixGoal);
 
     // Start new segments when pump mode changes (creates visual gap in goal curves)
     if (m_hasPumpModeData && isFlowMode != m_lastPumpModeIsFlow) {
         if (isFlowMode) {
             // Switching to flow mode: start new pressure goal segment
             m_currentPressureGoalSegment++;
-            if (m_currentPressureGoalSegment >= m_pressureGoalSegments.size()) {
-                m_pressureGoalSegments.append(QVector<QPointF>());
-            }
+            m_samples.openGoalSegment(ShotSampleBuffer::GoalCurve::Pressure, m_currentPressureGoalSegment);
         } else {
             // Switching to pressure mode: start new flow goal segment
             m_currentFlowGoalSegment++;
-            if (m_currentFlowGoalSegment >= m_flowGoalSegments.size()) {
-                m_flowGoalSegments.append(QVector<QPointF>());
-            }
+            m_samples.openGoalSegment(ShotSampleBuffer::GoalCurve::Flow, m_currentFlowGoalSegment);
         }
     }
     m_lastPumpModeIsFlow = isFlowMode;
@@ -259,15 +220,14 @@ void ShotDataModel::addSample(double time, double pressure, double flow, double
 
     // Add goal points to current segments
     if (pressureGoal > 0) {
-        m_pressureGoalSegments[m_currentPressureGoalSegment].append(QPointF(time, pressureGoal));
+        m_samples.appendGoal(ShotSampleBuffer::GoalCurve::Pressure, m_currentPressureGoalSegment, time, pressureGoal);
         m_goalCurvesDirty = true;
     }
     if (flowGoal > 0) {
-        m_flowGoalSegments[m_currentFlowGoalSegment].append(QPointF(time, flowGoal));
+        m_samples.appendGoal(ShotSampleBuffer::GoalCurve::Flow, m_currentFlowGoalSegment, time, flowGoal);
         m_goalCurvesDirty = true;
     }
-    m_temperatureGoalPoints.append(QPointF(time, temperatureGoal));
-    m_temperatureMixGoalPoints.append(QPointF(time, temperatureMixGoal));
+    // The temperature goals went into the machine row above
     m_goalCurvesDirty = true;
 
     // Update raw time - QML uses this to calculate axis max with pixel-based padding
@@ -284,7 +244,7 @@ void ShotDataModel::addSample(double time, double pressure, double flow, double
 void ShotDataModel::addWeightSample(double time, double weight, double flowRate) {
     // Store weight flow rate for visualizer export (flow["by_weight"])
     // Clamp negative values to 0 (can occur from scale noise)
-    m_weightFlowRatePoints.append(QPointF(time, qMax(0.0, flowRate)));
+    m_samples.appendWeightFlowRate(time, qMax(0.0, flowRate));
     addWeightSample(time, weight);
 }
 
@@ -312,9 +272,10 @@ void ShotDataModel::addWeightSample(double time, double weight) {
     // the filter on reality. Report once at the start of a run and once when it ends, never per
     // sample.
     constexpr int kMaxConsecutiveRejections = 3;
-    if (!m_weightPoints.isEmpty()) {
-        double lastWeight = m_weightPoints.last().y();
-        double lastTime = m_weightPoints.last().x();
+    const SampleColumn accepted = column(ShotSampleBuffer::Channel::Weight);
+    if (!accepted.isEmpty()) {
+        double lastWeight = accepted.last().y();
+        double lastTime = accepted.last().x();
         double deltaWeight = qAbs(weight - lastWeight);
         double deltaTime = time - lastTime;
 
@@ -349,16 +310,11 @@ void ShotDataModel::addWeightSample(double time, double weight) {
         m_consecutiveSpikeRejections = 0;
     }
 
-    // Store cumulative weight for export (visualizer, shot history)
-    m_cumulativeWeightPoints.append(QPointF(time, weight));
-
-    // Add initial zero point when weight curve starts (so line starts from zero at correct time)
-    if (m_weightPoints.isEmpty()) {
-        m_weightPoints.append(QPointF(time, 0.0));
-    }
-
-    // Plot cumulative weight (g) - shows weight progression during shot (0g -> 36g typical)
-    m_weightPoints.append(QPointF(time, weight));
+    // Cumulative weight (g) - one column for export (visualizer, shot history) and the
+    // graph, which plots the weight progression during shot (0g -> 36g typical). The
+    // graph's initial zero point, so the line starts from zero at the correct time,
+    // is added when it is drawn (onFlushTimerTick, weightData()), not stored.
+    m_samples.appendWeight(time, weight);
     m_dirty = true;
     // Timer-driven: onFlushTimerTick() runs every 33ms (~30fps), batching samples
     emit finalWeightChanged();  // For accessibility announcement
@@ -378,10 +334,13 @@ void ShotDataModel::markStopAt(double time) {
     m_stopTime = time;
 
     // Find the weight at or just before the stop time
+    // (the graph's leading zero shares the first sample's time, so it can never
+    // be the match and the accepted samples alone decide)
     m_weightAtStop = 0.0;
-    for (qsizetype i = m_weightPoints.size() - 1; i >= 0; --i) {
-        if (m_weightPoints[i].x() <= time) {
-            m_weightAtStop = m_weightPoints[i].y();
+    const SampleColumn weight = column(ShotSampleBuffer::Channel::Weight);
+    for (qsizetype i = weight.size() - 1; i >= 0; --i) {
+        if (weight.times()[i] <= time) {
+            m_weightAtStop = weight.values()[i];
             break;
         }
     }
@@ -398,36 +357,44 @@ void ShotDataModel::markStopAt(double time) {
 }
 
 void ShotDataModel::smoothWeightFlowRate(int window) {
-    // Save raw copy before smoothing (for by_weight_raw export)
-    m_weightFlowRateRawPoints = m_weightFlowRatePoints;
+    const SampleColumn rate = column(ShotSampleBuffer::Channel::WeightFlowRate);
+    qsizetype n = rate.size();
 
-    qsizetype n = m_weightFlowRatePoints.size();
+    // Save raw copy before smoothing (for by_weight_raw export). Same clock as
+    // the smoothed column, so only the values are copied.
+    m_samples.setWeightFlowRateRaw(rate.values(), n);
     if (n < 3) return;
 
     // Centered moving average: each point averages with `window` neighbors on each side.
     // With window=5 and ~5Hz data, this spans ~2.2s on top of the 1s LSLR recording window
     // and the real-time EMA smoothing. X values (timestamps) are preserved.
-    QVector<QPointF> smoothed;
-    smoothed.reserve(n);
+    const double* raw = rate.values();
+    QVector<double> smoothed(n);
     for (qsizetype i = 0; i < n; i++) {
         qsizetype lo = qMax(qsizetype(0), i - window);
         qsizetype hi = qMin(n - 1, i + window);
         double sum = 0;
         for (qsizetype j = lo; j <= hi; j++) {
-            sum += m_weightFlowRatePoints[j].y();
+            sum += raw[j];
         }
-        smoothed.append(QPointF(m_weightFlowRatePoints[i].x(), sum / (hi - lo + 1)));
+        smoothed[i] = sum / (hi - lo + 1);
     }
-    m_weightFlowRatePoints = smoothed;
+    m_samples.setWeightFlowRate(smoothed.constData(), n);
 }
 
 void ShotDataModel::computeConductanceDerivative() {
-    // Delegate to Conductance::derivative so ShotDataModel (per-sample live
+    // Delegate to Conductance::derivativeBatch so ShotDataModel (per-sample live
     // data) and tools/shot_eval (batch offline data) share one formula —
-    // keeps live-graph curves identical to offline-evaluation curves.
-    m_conductanceDerivativePoints = Conductance::derivative(m_conductancePoints);
+    // keeps live-graph curves identical to offline-evaluation curves. The
+    // kernel reads the conductance column in place and its result is on the
+    // conductance clock, so only its values are stored.
+    const SampleColumn conductance = column(ShotSampleBuffer::Channel::Conductance);
+    QVector<double> values(conductance.size());
+    const qsizetype count = Conductance::derivativeBatch(
+        conductance.times(), conductance.values(), values.data(), conductance.size());
+    m_samples.setConductanceDerivative(values.constData(), count);
     qDebug() << "ShotDataModel: Computed conductance derivative ("
-             << m_conductanceDerivativePoints.size() << " points)";
+             << count << " points)";
 }
 
 void ShotDataModel::trimSettlingData() {
@@ -435,58 +402,35 @@ void ShotDataModel::trimSettlingData() {
     // SAW settling period where the DE1 reports 0 pressure/flow while the scale settles.
     // De1app stops recording at the end of pouring substate; we trim at save time to
     // preserve live drip visualization during settling but produce clean history graphs.
-    qsizetype trimIndex = m_pressurePoints.size();
-    while (trimIndex > 0 && m_pressurePoints[trimIndex - 1].y() <= 0.0) {
+    const SampleColumn pressure = column(ShotSampleBuffer::Channel::Pressure);
+    const qsizetype sampleCount = pressure.size();
+    qsizetype trimIndex = sampleCount;
+    while (trimIndex > 0 && pressure.values()[trimIndex - 1] <= 0.0) {
         --trimIndex;
     }
 
-    if (trimIndex >= m_pressurePoints.size()) {
+    if (trimIndex >= sampleCount) {
         return;  // Nothing to trim
     }
 
     if (trimIndex == 0) {
-        qWarning() << "[ShotDataModel] trimSettlingData: all" << m_pressurePoints.size()
+        qWarning() << "[ShotDataModel] trimSettlingData: all" << sampleCount
                    << "samples have zero pressure — skipping trim to preserve data";
         return;
     }
 
-    qsizetype removed = m_pressurePoints.size() - trimIndex;
+    qsizetype removed = sampleCount - trimIndex;
     qDebug() << "[ShotDataModel] Trimming" << removed << "trailing zero-pressure settling samples"
-             << "(keeping" << trimIndex << "of" << m_pressurePoints.size() << ")";
-
-    // Trim sensor data series to the same length
-    m_pressurePoints.resize(trimIndex);
-    m_flowPoints.resize(qMin(m_flowPoints.size(), trimIndex));
-    m_temperaturePoints.resize(qMin(m_temperaturePoints.size(), trimIndex));
-    m_temperatureMixPoints.resize(qMin(m_temperatureMixPoints.size(), trimIndex));
-    m_resistancePoints.resize(qMin(m_resistancePoints.size(), trimIndex));
-    m_conductancePoints.resize(qMin(m_conductancePoints.size(), trimIndex));
-    m_darcyResistancePoints.resize(qMin(m_darcyResistancePoints.size(), trimIndex));
-    m_waterDispensedPoints.resize(qMin(m_waterDispensedPoints.size(), trimIndex));
-
-    // Trim time-based series using cutoff from last retained pressure sample.
-    // Goals and weight flow rate have different sample counts than DE1 sensor data.
-    // (trimIndex is guaranteed > 0 by the early returns above)
-    double cutoffTime = m_pressurePoints.last().x();
-    for (auto& segment : m_pressureGoalSegments) {
-        while (!segment.isEmpty() && segment.last().x() > cutoffTime)
-            segment.removeLast();
-    }
-    for (auto& segment : m_flowGoalSegments) {
-        while (!segment.isEmpty() && segment.last().x() > cutoffTime)
-            segment.removeLast();
-    }
-    while (!m_temperatureGoalPoints.isEmpty() && m_temperatureGoalPoints.last().x() > cutoffTime)
-        m_temperatureGoalPoints.removeLast();
-    while (!m_temperatureMixGoalPoints.isEmpty() && m_temperatureMixGoalPoints.last().x() > cutoffTime)
-        m_temperatureMixGoalPoints.removeLast();
-    while (!m_weightFlowRatePoints.isEmpty() && m_weightFlowRatePoints.last().x() > cutoffTime)
-        m_weightFlowRatePoints.removeLast();
-    while (!m_weightFlowRateRawPoints.isEmpty() && m_weightFlowRateRawPoints.last().x() > cutoffTime)
-        m_weightFlowRateRawPoints.removeLast();
-
-    // Do NOT trim cumulative weight data (m_weightPoints, m_cumulativeWeightPoints) —
-    // weight continues to change during settling and the settled final weight is accurate.
+             << "(keeping" << trimIndex << "of" << sampleCount << ")";
+
+    // Trims every machine-clock series (sensor data and temperature goals) to
+    // trimIndex, and the pressure/flow goals and weight flow rate — which have
+    // different sample counts than DE1 sensor data — by the last retained
+    // sample's time.
+    //
+    // Cumulative weight is NOT trimmed — weight continues to change during
+    // settling and the settled final weight is accurate.
+    m_samples.trimMachineRows(trimIndex);
 }
 
 void ShotDataModel::addPhaseMarker(double time, const QString& label, int frameNumber, bool isFlowMode, const QString& transitionReason) {
@@ -505,50 +449,35 @@ void ShotDataModel::onFlushTimerTick() {
     if (!m_dirty) return;
 
     // Incrementally append new points to fast renderers (pre-allocated VBO, no rebuild)
-    if (m_fastPressure) {
-        for (qsizetype i = m_lastFlushedPressure; i < m_pressurePoints.size(); ++i)
-            m_fastPressure->appendPoint(m_pressurePoints[i].x(), m_pressurePoints[i].y());
-        m_lastFlushedPressure = m_pressurePoints.size();
-    }
-    if (m_fastFlow) {
-        for (qsizetype i = m_lastFlushedFlow; i < m_flowPoints.size(); ++i)
-            m_fastFlow->appendPoint(m_flowPoints[i].x(), m_flowPoints[i].y());
-        m_lastFlushedFlow = m_flowPoints.size();
-    }
-    if (m_fastTemperature) {
-        for (qsizetype i = m_lastFlushedTemp; i < m_temperaturePoints.size(); ++i)
-            m_fastTemperature->appendPoint(m_temperaturePoints[i].x(), m_temperaturePoints[i].y());
-        m_lastFlushedTemp = m_temperaturePoints.size();
-    }
+    using Channel = ShotSampleBuffer::Channel;
+    auto flush = [](FastLineRenderer* renderer, const SampleColumn& points, qsizetype* lastFlushed) {
+        if (!renderer) return;
+        const qsizetype from = *lastFlushed;
+        if (points.size() > from)
+            renderer->appendPoints(points.times() + from, points.values() + from, points.size() - from);
+        *lastFlushed = points.size();
+    };
+    flush(m_fastPressure, column(Channel::Pressure), &m_lastFlushedPressure);
+    flush(m_fastFlow, column(Channel::Flow), &m_lastFlushedFlow);
+    flush(m_fastTemperature, column(Channel::Temperature), &m_lastFlushedTemp);
+    flush(m_fastWeightFlow, column(Channel::WeightFlowRate), &m_lastFlushedWeightFlow);
+    flush(m_fastResistance, column(Channel::Resistance), &m_lastFlushedResistance);
+    flush(m_fastConductance, column(Channel::Conductance), &m_lastFlushedConductance);
+    flush(m_fastDarcyResistance, column(Channel::DarcyResistance), &m_lastFlushedDarcyResistance);
+    flush(m_fastTemperatureMix, column(Channel::TemperatureMix), &m_lastFlushedTemperatureMix);
     if (m_fastWeight) {
-        for (qsizetype i = m_lastFlushedWeight; i < m_weightPoints.size(); ++i)
-            m_fastWeight->appendPoint(m_weightPoints[i].x(), m_weightPoints[i].y());
-        m_lastFlushedWeight = m_weightPoints.size();
-    }
-    if (m_fastWeightFlow) {
-        for (qsizetype i = m_lastFlushedWeightFlow; i < m_weightFlowRatePoints.size(); ++i)
-            m_fastWeightFlow->appendPoint(m_weightFlowRatePoints[i].x(), m_weightFlowRatePoints[i].y());
-        m_lastFlushedWeightFlow = m_weightFlowRatePoints.size();
-    }
-    if (m_fastResistance) {
-        for (qsizetype i = m_lastFlushedResistance; i < m_resistancePoints.size(); ++i)
-            m_fastResistance->appendPoint(m_resistancePoints[i].x(), m_resistancePoints[i].y());
-        m_lastFlushedResistance = m_resistancePoints.size();
-    }
-    if (m_fastConductance) {
-        for (qsizetype i = m_lastFlushedConductance; i < m_conductancePoints.size(); ++i)
-            m_fastConductance->appendPoint(m_conductancePoints[i].x(), m_conductancePoints[i].y());
-        m_lastFlushedConductance = m_conductancePoints.size();
-    }
-    if (m_fastDarcyResistance) {
-        for (qsizetype i = m_lastFlushedDarcyResistance; i < m_darcyResistancePoints.size(); ++i)
-            m_fastDarcyResistance->appendPoint(m_darcyResistancePoints[i].x(), m_darcyResistancePoints[i].y());
-        m_lastFlushedDarcyResistance = m_darcyResistancePoints.size();
-    }
-    if (m_fastTemperatureMix) {
-        for (qsizetype i = m_lastFlushedTemperatureMix; i < m_temperatureMixPoints.size(); ++i)
-            m_fastTemperatureMix->appendPoint(m_temperatureMixPoints[i].x(), m_temperatureMixPoints[i].y());
-        m_lastFlushedTemperatureMix = m_temperatureMixPoints.size();
+        // Graph point 0 is the leading zero at the first sample's time; graph
+        // point i > 0 is weight sample i - 1.
+        const SampleColumn weight = column(Channel::Weight);
+        if (m_lastFlushedWeight == 0 && !weight.isEmpty()) {
+            m_fastWeight->appendPoint(weight.times()[0], 0.0);
+            m_lastFlushedWeight = 1;
+        }
+        qsizetype from = m_lastFlushedWeight - 1;
+        if (from >= 0 && weight.size() > from)
+            m_fastWeight->appendPoints(weight.times() + from, weight.values() + from, weight.size() - from);
+        if (!weight.isEmpty())
+            m_lastFlushedWeight = weight.size() + 1;
     }
 
     // Goal-curve points republished as QML-bindable properties — DashedLineSeries
@@ -565,13 +494,30 @@ void ShotDataModel::onFlushTimerTick() {
         emit rawTimeChanged();
     }
 
+    // Timed after the renderer appends, so a slow append is in the number.
+    for (qint64 receivedMs : std::as_const(m_unflushedReceivedMs))
+        LatencyStats::recordSince(LatencyStats::Leg::SampleToChartFlush, receivedMs);
+    m_unflushedReceivedMs.clear();
+
     m_dirty = false;
     emit flushed();
 }
 
 double ShotDataModel::finalWeight() const {
-    if (m_weightPoints.isEmpty()) return 0.0;
-    return m_weightPoints.last().y();
+    const SampleColumn weight = column(ShotSampleBuffer::Channel::Weight);
+    if (weight.isEmpty()) return 0.0;
+    return weight.last().y();
+}
+
+QVector<QPointF> ShotDataModel::weightData() const {
+    const SampleColumn weight = column(ShotSampleBuffer::Channel::Weight);
+    QVector<QPointF> graph;
+    if (weight.isEmpty()) return graph;
+    graph.reserve(weight.size() + 1);
+    graph.append(QPointF(weight.first().x(), 0.0));
+    for (qsizetype i = 0; i < weight.size(); ++i)
+        graph.append(weight.at(i));
+    return graph;
 }
 
 QVariantList ShotDataModel::phaseMarkersVariant() const {
@@ -591,26 +537,19 @@ QVariantList ShotDataModel::phaseMarkersVariant() const {
 
 QVector<QPointF> ShotDataModel::pressureGoalData() const {
     // Combine all segments for export
-    QVector<QPointF> combined;
-    for (const auto& segment : m_pressureGoalSegments) {
-        combined.append(segment);
-    }
-    return combined;
+    return m_samples.goalPoints(ShotSampleBuffer::GoalCurve::Pressure);
 }
 
 QVector<QPointF> ShotDataModel::flowGoalData() const {
     // Combine all segments for export
-    QVector<QPointF> combined;
-    for (const auto& segment : m_flowGoalSegments) {
-        combined.append(segment);
-    }
-    return combined;
+    return m_samples.goalPoints(ShotSampleBuffer::GoalCurve::Flow);
 }
 
 // Variant-list accessors for QML — DashedLineSeries Repeaters bind to these.
 // Each segment becomes a JS array of Qt.point(x, y); the outer list is the segments.
 
-static QVariantList pointsToVariantList(const QVector<QPointF>& pts) {
+template <typename Points>
+static QVariantList pointsToVariantList(const Points& pts) {
     QVariantList out;
     out.reserve(pts.size());
     for (const QPointF& p : pts) {
@@ -621,8 +560,9 @@ static QVariantList pointsToVariantList(const QVector<QPointF>& pts) {
 
 QVariantList ShotDataModel::pressureGoalSegmentsVariant() const {
     QVariantList out;
-    out.reserve(m_pressureGoalSegments.size());
-    for (const auto& segment : m_pressureGoalSegments) {
+    const auto& segments = m_samples.goalSegments(ShotSampleBuffer::GoalCurve::Pressure);
+    out.reserve(segments.size());
+    for (const auto& segment : segments) {
         out.append(QVariant::fromValue(pointsToVariantList(segment)));
     }
     return out;
@@ -630,17 +570,18 @@ QVariantList ShotDataModel::pressureGoalSegmentsVariant() const {
 
 QVariantList ShotDataModel::flowGoalSegmentsVariant() const {
     QVariantList out;
-    out.reserve(m_flowGoalSegments.size());
-    for (const auto& segment : m_flowGoalSegments) {
+    const auto& segments = m_samples.goalSegments(ShotSampleBuffer::GoalCurve::Flow);
+    out.reserve(segments.size());
+    for (const auto& segment : segments) {
         out.append(QVariant::fromValue(pointsToVariantList(segment)));
     }
     return out;
 }
 
 QVariantList ShotDataModel::temperatureGoalPointsVariant() const {
-    return pointsToVariantList(m_temperatureGoalPoints);
+    return pointsToVariantList(column(ShotSampleBuffer::Channel::TemperatureGoal));
 }
 
 QVariantList ShotDataModel::temperatureMixGoalPointsVariant() const {
-    return pointsToVariantList(m_temperatureMixGoalPoints);
+    return pointsToVariantList(column(ShotSampleBuffer::Channel::TemperatureMixGoal));
 }
@@ -8,6 +8,8 @@
 #include <QVariantList>
 #include <QVector>
 
+#include "shotsamplebuffer.h"
+
 class FastLineRenderer;
 
 struct PhaseMarker {
@@ -58,24 +60,31 @@ public:
                                          FastLineRenderer* darcyResistance = nullptr,
                                          FastLineRenderer* temperatureMix = nullptr);
 
-    // Data export for visualizer upload
-    const QVector<QPointF>& pressureData() const { return m_pressurePoints; }
-    const QVector<QPointF>& flowData() const { return m_flowPoints; }
-    const QVector<QPointF>& temperatureData() const { return m_temperaturePoints; }
-    const QVector<QPointF>& temperatureMixData() const { return m_temperatureMixPoints; }
-    const QVector<QPointF>& resistanceData() const { return m_resistancePoints; }
-    const QVector<QPointF>& conductanceData() const { return m_conductancePoints; }
-    const QVector<QPointF>& darcyResistanceData() const { return m_darcyResistancePoints; }
-    const QVector<QPointF>& conductanceDerivativeData() const { return m_conductanceDerivativePoints; }
-    const QVector<QPointF>& waterDispensedData() const { return m_waterDispensedPoints; }
+    // The shot's samples, column by column. Copy it (O(1), implicitly shared)
+    // to keep a snapshot past this call — the save and upload paths do.
+    const ShotSampleBuffer& samples() const { return m_samples; }
+    SampleColumn column(ShotSampleBuffer::Channel channel) const { return m_samples.column(channel); }
+
+    // Materialized per-series copies, for consumers still written against
+    // QVector<QPointF> (MCP, the auto flow-cal and steam health checks, tests).
+    // Each call builds a fresh vector; hot paths read column() instead.
+    QVector<QPointF> pressureData() const { return column(ShotSampleBuffer::Channel::Pressure).toPoints(); }
+    QVector<QPointF> flowData() const { return column(ShotSampleBuffer::Channel::Flow).toPoints(); }
+    QVector<QPointF> temperatureData() const { return column(ShotSampleBuffer::Channel::Temperature).toPoints(); }
+    QVector<QPointF> temperatureMixData() const { return column(ShotSampleBuffer::Channel::TemperatureMix).toPoints(); }
+    QVector<QPointF> resistanceData() const { return column(ShotSampleBuffer::Channel::Resistance).toPoints(); }
+    QVector<QPointF> conductanceData() const { return column(ShotSampleBuffer::Channel::Conductance).toPoints(); }
+    QVector<QPointF> darcyResistanceData() const { return column(ShotSampleBuffer::Channel::DarcyResistance).toPoints(); }
+    QVector<QPointF> conductanceDerivativeData() const { return column(ShotSampleBuffer::Channel::ConductanceDerivative).toPoints(); }
+    QVector<QPointF> waterDispensedData() const { return column(ShotSampleBuffer::Channel::WaterDispensed).toPoints(); }
     QVector<QPointF> pressureGoalData() const;  // Combines all segments
     QVector<QPointF> flowGoalData() const;      // Combines all segments
-    const QVector<QPointF>& temperatureGoalData() const { return m_temperatureGoalPoints; }
-    const QVector<QPointF>& temperatureMixGoalData() const { return m_temperatureMixGoalPoints; }
-    const QVector<QPointF>& weightData() const { return m_weightPoints; }  // Cumulative weight (g) for graph
-    const QVector<QPointF>& cumulativeWeightData() const { return m_cumulativeWeightPoints; }  // Cumulative weight for export
-    const QVector<QPointF>& weightFlowRateData() const { return m_weightFlowRatePoints; }  // Flow rate from scale (g/s) for export
-    const QVector<QPointF>& weightFlowRateRawData() const { return m_weightFlowRateRawPoints; }  // Raw (pre-smoothing) flow rate
+    QVector<QPointF> temperatureGoalData() const { return column(ShotSampleBuffer::Channel::TemperatureGoal).toPoints(); }
+    QVector<QPointF> temperatureMixGoalData() const { return column(ShotSampleBuffer::Channel::TemperatureMixGoal).toPoints(); }
+    QVector<QPointF> weightData() const;  // Cumulative weight (g) for graph: a leading zero, then cumulativeWeightData()
+    QVector<QPointF> cumulativeWeightData() const { return column(ShotSampleBuffer::Channel::Weight).toPoints(); }  // Cumulative weight for export
+    QVector<QPointF> weightFlowRateData() const { return column(ShotSampleBuffer::Channel::WeightFlowRate).toPoints(); }  // Flow rate from scale (g/s) for export
+    QVector<QPointF> weightFlowRateRawData() const { return column(ShotSampleBuffer::Channel::WeightFlowRateRaw).toPoints(); }  // Raw (pre-smoothing) flow rate
 
     // Phase markers for state_change export
     const QList<PhaseMarker>& phaseMarkersList() const { return m_phaseMarkers; }
@@ -84,12 +93,15 @@ public slots:
     void clear();
     void clearWeightData();  // Clear only weight samples (call when tare completes)
 
-    // Data ingestion - vector append, chart update deferred to 33ms timer
+    // Data ingestion - vector append, chart update deferred to 33ms timer.
+    // receivedMs is ShotSample::receivedMs, timed to the flush that draws it
+    // (LatencyStats' sampleToChartFlush leg); 0 records nothing.
     void addSample(double time, double pressure, double flow, double temperature,
                    double mixTemp,
                    double pressureGoal, double flowGoal, double temperatureGoal,
                    double temperatureMixGoal,
-                   int frameNumber = -1, bool isFlowMode = false);
+                   int frameNumber = -1, bool isFlowMode = false,
+                   qint64 receivedMs = 0);
     void addWeightSample(double time, double weight, double flowRate);
     void addWeightSample(double time, double weight);  // Overload without flowRate (from ShotTimingController)
     void markExtractionStart(double time);
@@ -121,24 +133,8 @@ private slots:
     void onFlushTimerTick();  // Called by timer - batched update to chart
 
 private:
-    // Data storage - fast vector appends
-    QVector<QPointF> m_pressurePoints;
-    QVector<QPointF> m_flowPoints;
-    QVector<QPointF> m_temperaturePoints;
-    QVector<QPointF> m_temperatureMixPoints;
-    QVector<QPointF> m_resistancePoints;
-    QVector<QPointF> m_conductancePoints;          // F^2 / P (Darcy conductance)
-    QVector<QPointF> m_darcyResistancePoints;      // P / F^2 (Darcy resistance)
-    QVector<QPointF> m_conductanceDerivativePoints; // dC/dt, Gaussian smoothed (post-shot only)
-    QVector<QPointF> m_waterDispensedPoints;
-    QVector<QVector<QPointF>> m_pressureGoalSegments;  // Separate segments for clean breaks
-    QVector<QVector<QPointF>> m_flowGoalSegments;      // Separate segments for clean breaks
-    QVector<QPointF> m_temperatureGoalPoints;      // SetHeadTemp (basket target)
-    QVector<QPointF> m_temperatureMixGoalPoints;   // SetMixTemp (water-in target)
-    QVector<QPointF> m_weightPoints;  // Cumulative weight (g) - for graphing
-    QVector<QPointF> m_cumulativeWeightPoints;  // Cumulative weight (g) - for export
-    QVector<QPointF> m_weightFlowRatePoints;  // Flow rate from scale (g/s) - for visualizer export
-    QVector<QPointF> m_weightFlowRateRawPoints;  // Raw (pre-smoothing) copy for by_weight_raw export
+    // Data storage - column appends into one arena per clock (see ShotSampleBuffer)
+    ShotSampleBuffer m_samples{INITIAL_CAPACITY};
 
     // Spike-filter burst state — see addWeightSample(). The filter compares each sample against
     // the last ACCEPTED point, so a run of rejections keeps measuring against an ever-staler
@@ -161,13 +157,17 @@ private:
     qsizetype m_lastFlushedPressure = 0;
     qsizetype m_lastFlushedFlow = 0;
     qsizetype m_lastFlushedTemp = 0;
-    qsizetype m_lastFlushedWeight = 0;
+    qsizetype m_lastFlushedWeight = 0;  // Graph points, so counting the leading zero
     qsizetype m_lastFlushedWeightFlow = 0;
     qsizetype m_lastFlushedResistance = 0;
     qsizetype m_lastFlushedConductance = 0;
     qsizetype m_lastFlushedDarcyResistance = 0;
     qsizetype m_lastFlushedTemperatureMix = 0;
 
+    // Transport arrival stamps of the samples added since the last flush.
+    // Drained by onFlushTimerTick() into the sample→chart latency histogram.
+    QVector<qint64> m_unflushedReceivedMs;
+
     // Batched update timer (30fps)
     QTimer* m_flushTimer = nullptr;
     bool m_dirty = false;
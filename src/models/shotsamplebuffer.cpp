@@ -0,0 +1,250 @@
+#include "shotsamplebuffer.h"
+
+#include <cstring>
+
+QVector<QPointF> SampleColumn::toPoints() const
+{
+    QVector<QPointF> points(m_size);
+    QPointF* dst = points.data();
+    for (qsizetype i = 0; i < m_size; ++i)
+        dst[i] = QPointF(m_times[i], m_values[i]);
+    return points;
+}
+
+// --- SampleTable ---
+
+SampleTable::SampleTable(int channelCount, qsizetype capacity)
+    : m_lengths(channelCount, 0)
+    , m_channelCount(channelCount)
+    , m_initialCapacity(capacity)
+{
+    if (capacity > 0) {
+        m_capacity = capacity;
+        m_arena.resize((channelCount + 1) * capacity);
+    }
+}
+
+void SampleTable::grow()
+{
+    const qsizetype newCapacity = qMax<qsizetype>(64, m_capacity * 2);
+    QVector<double> arena((m_channelCount + 1) * newCapacity);
+    for (int c = 0; c <= m_channelCount; ++c) {
+        if (m_rows > 0) {
+            std::memcpy(arena.data() + c * newCapacity, columnData(c),
+                        static_cast<size_t>(m_rows) * sizeof(double));
+        }
+    }
+    m_arena = std::move(arena);
+    m_capacity = newCapacity;
+}
+
+void SampleTable::append(double time, std::initializer_list<double> values)
+{
+    Q_ASSERT(static_cast<int>(values.size()) <= m_channelCount);
+    if (m_rows == m_capacity) grow();
+
+    // One data() call: it is where a table shared with a snapshot detaches.
+    double* arena = m_arena.data();
+    arena[m_rows] = time;
+    int c = 0;
+    for (double v : values) {
+        arena[(c + 1) * m_capacity + m_rows] = v;
+        m_lengths[c] = m_rows + 1;
+        ++c;
+    }
+    ++m_rows;
+}
+
+void SampleTable::setChannel(int channel, const double* values, qsizetype count)
+{
+    Q_ASSERT(channel >= 0 && channel < m_channelCount);
+    count = qMin(count, m_rows);
+    if (count > 0)
+        std::memcpy(columnData(channel + 1), values, static_cast<size_t>(count) * sizeof(double));
+    m_lengths[channel] = count;
+}
+
+void SampleTable::truncate(qsizetype rows)
+{
+    if (rows >= m_rows) return;
+    m_rows = qMax<qsizetype>(0, rows);
+    for (qsizetype& length : m_lengths)
+        length = qMin(length, m_rows);
+}
+
+void SampleTable::clear()
+{
+    if (!m_arena.isDetached() && m_initialCapacity > 0) {
+        m_arena = QVector<double>((m_channelCount + 1) * m_initialCapacity);
+        m_capacity = m_initialCapacity;
+    } else if (!m_arena.isDetached()) {
+        m_arena = QVector<double>();
+        m_capacity = 0;
+    }
+    m_lengths.fill(0);
+    m_rows = 0;
+}
+
+SampleColumn SampleTable::column(int channel) const
+{
+    Q_ASSERT(channel >= 0 && channel < m_channelCount);
+    const qsizetype length = m_lengths.at(channel);
+    if (length == 0) return SampleColumn();
+    return SampleColumn(columnData(0), columnData(channel + 1), length);
+}
+
+// --- ShotSampleBuffer ---
+
+namespace {
+constexpr int kMachineChannels = 11;  // Pressure … ConductanceDerivative
+constexpr int kWeightFlowChannels = 2;  // WeightFlowRate, WeightFlowRateRaw
+}
+
+ShotSampleBuffer::ShotSampleBuffer(qsizetype capacity)
+    : m_machine(kMachineChannels, capacity)
+    , m_weight(1, capacity)
+    , m_weightFlow(kWeightFlowChannels, capacity)
+    , m_capacity(capacity)
+{
+    resetGoalSegments();
+}
+
+const SampleTable& ShotSampleBuffer::tableFor(Channel channel, int* index) const
+{
+    const int c = static_cast<int>(channel);
+    if (channel <= Channel::ConductanceDerivative) {
+        *index = c;
+        return m_machine;
+    }
+    if (channel == Channel::Weight) {
+        *index = 0;
+        return m_weight;
+    }
+    *index = c - static_cast<int>(Channel::WeightFlowRate);
+    return m_weightFlow;
+}
+
+SampleColumn ShotSampleBuffer::column(Channel channel) const
+{
+    int index = 0;
+    const SampleTable& table = tableFor(channel, &index);
+    return table.column(index);
+}
+
+void ShotSampleBuffer::appendMachineSample(double time, double pressure, double flow,
+                                           double temperature, double temperatureMix,
+                                           double resistance, double conductance,
+                                           double darcyResistance, double waterDispensed,
+                                           double temperatureGoal, double temperatureMixGoal)
+{
+    // Order is Channel's: everything up to, not including, ConductanceDerivative.
+    m_machine.append(time, {pressure, flow, temperature, temperatureMix,
+                            resistance, conductance, darcyResistance, waterDispensed,
+                            temperatureGoal, temperatureMixGoal});
+}
+
+void ShotSampleBuffer::appendWeight(double time, double weight)
+{
+    m_weight.append(time, {weight});
+}
+
+void ShotSampleBuffer::appendWeightFlowRate(double time, double flowRate)
+{
+    m_weightFlow.append(time, {flowRate});
+}
+
+void ShotSampleBuffer::setConductanceDerivative(const double* values, qsizetype count)
+{
+    m_machine.setChannel(static_cast<int>(Channel::ConductanceDerivative), values, count);
+}
+
+void ShotSampleBuffer::setWeightFlowRate(const double* values, qsizetype count)
+{
+    m_weightFlow.setChannel(0, values, count);
+}
+
+void ShotSampleBuffer::setWeightFlowRateRaw(const double* values, qsizetype count)
+{
+    m_weightFlow.setChannel(1, values, count);
+}
+
+QVector<QVector<QPointF>>& ShotSampleBuffer::segmentsFor(GoalCurve curve)
+{
+    return curve == GoalCurve::Pressure ? m_pressureGoalSegments : m_flowGoalSegments;
+}
+
+const QVector<QVector<QPointF>>& ShotSampleBuffer::goalSegments(GoalCurve curve) const
+{
+    return curve == GoalCurve::Pressure ? m_pressureGoalSegments : m_flowGoalSegments;
+}
+
+void ShotSampleBuffer::openGoalSegment(GoalCurve curve, int index)
+{
+    auto& segments = segmentsFor(curve);
+    while (segments.size() <= index)
+        segments.append(QVector<QPointF>());
+}
+
+void ShotSampleBuffer::appendGoal(GoalCurve curve, int segment, double time, double value)
+{
+    openGoalSegment(curve, segment);
+    segmentsFor(curve)[segment].append(QPointF(time, value));
+}
+
+QVector<QPointF> ShotSampleBuffer::goalPoints(GoalCurve curve) const
+{
+    const auto& segments = goalSegments(curve);
+    qsizetype total = 0;
+    for (const auto& segment : segments) total += segment.size();
+    QVector<QPointF> combined;
+    combined.reserve(total);
+    for (const auto& segment : segments) combined.append(segment);
+    return combined;
+}
+
+void ShotSampleBuffer::trimMachineRows(qsizetype machineRows)
+{
+    if (machineRows <= 0 || machineRows >= m_machine.rowCount()) return;
+    m_machine.truncate(machineRows);
+
+    // The goals and the weight-flow clock are cut by time, not index: they
+    // have their own sample counts.
+    const double cutoffTime = m_machine.times()[machineRows - 1];
+    for (auto* segments : {&m_pressureGoalSegments, &m_flowGoalSegments}) {
+        for (auto& segment : *segments) {
+            while (!segment.isEmpty() && segment.last().x() > cutoffTime)
+                segment.removeLast();
+        }
+    }
+    qsizetype weightFlowRows = m_weightFlow.rowCount();
+    const double* weightFlowTimes = m_weightFlow.times();
+    while (weightFlowRows > 0 && weightFlowTimes[weightFlowRows - 1] > cutoffTime)
+        --weightFlowRows;
+    m_weightFlow.truncate(weightFlowRows);
+}
+
+void ShotSampleBuffer::resetGoalSegments()
+{
+    m_pressureGoalSegments.clear();
+    m_pressureGoalSegments.append(QVector<QPointF>());
+    m_flowGoalSegments.clear();
+    m_flowGoalSegments.append(QVector<QPointF>());
+    if (m_capacity > 0) {
+        m_pressureGoalSegments[0].reserve(m_capacity);
+        m_flowGoalSegments[0].reserve(m_capacity);
+    }
+}
+
+void ShotSampleBuffer::clear()
+{
+    m_machine.clear();
+    m_weight.clear();
+    m_weightFlow.clear();
+    resetGoalSegments();
+}
+
+void ShotSampleBuffer::clearWeights()
+{
+    m_weight.clear();
+    m_weightFlow.clear();
+}
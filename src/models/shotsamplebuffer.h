@@ -0,0 +1,237 @@
+#pragma once
+
+#include <QPointF>
+#include <QVector>
+
+#include <initializer_list>
+#include <iterator>
+
+// A read-only view of one channel of a ShotSampleBuffer: a time column and a
+// value column of equal length, borrowed from the buffer's arena.
+//
+// It reads like a const QVector<QPointF> — size(), operator[], last(), range-for
+// — so code written against the old per-series vectors (interpolation, JSON
+// export) takes either without a second copy of itself. The difference is the
+// layout: x and y are two contiguous double arrays, and every channel on the
+// same clock points at the SAME time array, which is what lets consumers that
+// care (the blob encoder, FastLineRenderer) skip the per-point split entirely.
+//
+// A view is only valid while the buffer it came from (or a copy of it) is
+// alive and unmodified. Take a ShotSampleBuffer copy — O(1), implicitly shared —
+// to hold one across an event-loop turn or a thread hop.
+class SampleColumn {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = QPointF;
+        using difference_type = qsizetype;
+        using pointer = void;
+        using reference = QPointF;
+
+        const_iterator() = default;
+        const_iterator(const SampleColumn* column, qsizetype index) : m_column(column), m_index(index) {}
+
+        QPointF operator*() const { return m_column->at(m_index); }
+        QPointF operator[](difference_type n) const { return m_column->at(m_index + n); }
+
+        const_iterator& operator++() { ++m_index; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++m_index; return old; }
+        const_iterator& operator--() { --m_index; return *this; }
+        const_iterator operator--(int) { const_iterator old = *this; --m_index; return old; }
+        const_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+        const_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(m_column, m_index + n); }
+        friend const_iterator operator+(difference_type n, const const_iterator& it) { return it + n; }
+        const_iterator operator-(difference_type n) const { return const_iterator(m_column, m_index - n); }
+        difference_type operator-(const const_iterator& other) const { return m_index - other.m_index; }
+
+        bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+        bool operator<(const const_iterator& other) const { return m_index < other.m_index; }
+        bool operator>(const const_iterator& other) const { return m_index > other.m_index; }
+        bool operator<=(const const_iterator& other) const { return m_index <= other.m_index; }
+        bool operator>=(const const_iterator& other) const { return m_index >= other.m_index; }
+
+    private:
+        const SampleColumn* m_column = nullptr;
+        qsizetype m_index = 0;
+    };
+
+    SampleColumn() = default;
+    SampleColumn(const double* times, const double* values, qsizetype size)
+        : m_times(times), m_values(values), m_size(size) {}
+
+    qsizetype size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    const double* times() const { return m_times; }
+    const double* values() const { return m_values; }
+
+    QPointF at(qsizetype i) const { return QPointF(m_times[i], m_values[i]); }
+    QPointF operator[](qsizetype i) const { return at(i); }
+    QPointF first() const { return at(0); }
+    QPointF last() const { return at(m_size - 1); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+
+    // A materialized copy, for consumers still written against QVector<QPointF>.
+    QVector<QPointF> toPoints() const;
+
+private:
+    const double* m_times = nullptr;
+    const double* m_values = nullptr;
+    qsizetype m_size = 0;
+};
+
+// Struct-of-arrays storage for channels sampled on one clock: a time column
+// plus `channelCount` value columns, all in ONE QVector<double> arena laid out
+// column by column at a stride of capacity() —
+//
+//   [ t × cap | ch0 × cap | ch1 × cap | … ]
+//
+// Appending a row writes one double into each column; growth doubles the
+// capacity and moves each column once. Channels may be shorter than the table:
+// a channel only gets a length when a row names it, or when setChannel() fills
+// it after the fact (ShotSampleBuffer's post-shot curves), so column() reports
+// what was actually recorded rather than a tail of zeros.
+//
+// Copies share the arena (QVector's implicit sharing). The first write to a
+// shared table detaches it, so a snapshot never sees later appends and the
+// live side pays for the copy only if it keeps writing while one is held.
+class SampleTable {
+public:
+    SampleTable() = default;
+    SampleTable(int channelCount, qsizetype capacity);
+
+    int channelCount() const { return m_channelCount; }
+    qsizetype rowCount() const { return m_rows; }
+    qsizetype capacity() const { return m_capacity; }
+
+    // One row: the time and the first values.size() channels. Channels past
+    // those keep their current length.
+    void append(double time, std::initializer_list<double> values);
+
+    // Overwrite channel `channel` for rows [0, count) and give it that length.
+    // count is clamped to rowCount().
+    void setChannel(int channel, const double* values, qsizetype count);
+
+    // Drop rows past `rows`; channel lengths are clamped with them.
+    void truncate(qsizetype rows);
+
+    // Empty the table. Keeps the arena when nothing else holds it; otherwise
+    // (a snapshot is still alive) starts a fresh one at the original capacity
+    // rather than detaching — copying rows only to discard them.
+    void clear();
+
+    SampleColumn column(int channel) const;
+    const double* times() const { return m_arena.constData(); }
+
+private:
+    void grow();
+    double* columnData(int column) { return m_arena.data() + column * m_capacity; }
+    const double* columnData(int column) const { return m_arena.constData() + column * m_capacity; }
+
+    QVector<double> m_arena;
+    QVector<qsizetype> m_lengths;  // per channel, ≤ m_rows
+    int m_channelCount = 0;
+    qsizetype m_rows = 0;
+    qsizetype m_capacity = 0;
+    qsizetype m_initialCapacity = 0;
+};
+
+// Every sample of the shot in progress: the single store behind ShotDataModel,
+// the chart renderers, the history blob encoder and the Visualizer uploader.
+//
+// Three clocks, three tables, each with ONE time column:
+//
+//   machine     DE1 shot samples — pressure, flow, both temperatures, the
+//               per-sample derived curves, water dispensed, the temperature
+//               goals and (post-shot) dC/dt. The old per-series vectors stored
+//               this time axis eleven times over.
+//   weight      accepted scale weights (after the spike filter).
+//   weightFlow  the scale's flow rate, recorded BEFORE the spike filter — so
+//               not the weight clock — and, after smoothWeightFlowRate(), its
+//               pre-smoothing copy.
+//
+// Pressure and flow goals are sparse (recorded only while non-zero) and broken
+// into segments at each pump-mode change; they stay per-segment point lists.
+//
+// Values are stored as double, not float. The blob codec is lossless and the
+// detectors compare against thresholds at full precision, so narrowing here
+// would change saved shots and badge verdicts; the saving is the shared time
+// axis and the single allocation per table.
+//
+// Copying a ShotSampleBuffer is O(1): it is how a shot is handed to the save
+// and upload paths without copying a sample (ShotDataModel::samples()).
+class ShotSampleBuffer {
+public:
+    enum class Channel {
+        // Machine clock
+        Pressure,
+        Flow,
+        Temperature,
+        TemperatureMix,
+        Resistance,
+        Conductance,
+        DarcyResistance,
+        WaterDispensed,
+        TemperatureGoal,
+        TemperatureMixGoal,
+        ConductanceDerivative,  // post-shot only
+        // Weight clock
+        Weight,
+        // Weight-flow clock
+        WeightFlowRate,
+        WeightFlowRateRaw,  // post-shot only
+    };
+
+    enum class GoalCurve { Pressure, Flow };
+
+    explicit ShotSampleBuffer(qsizetype capacity = 0);
+
+    SampleColumn column(Channel channel) const;
+
+    // Machine rows recorded — the shot's sample count.
+    qsizetype sampleCount() const { return m_machine.rowCount(); }
+
+    void appendMachineSample(double time, double pressure, double flow,
+                             double temperature, double temperatureMix,
+                             double resistance, double conductance, double darcyResistance,
+                             double waterDispensed,
+                             double temperatureGoal, double temperatureMixGoal);
+    void appendWeight(double time, double weight);
+    void appendWeightFlowRate(double time, double flowRate);
+
+    // Post-shot curves: values for the existing rows of their clock.
+    void setConductanceDerivative(const double* values, qsizetype count);
+    void setWeightFlowRate(const double* values, qsizetype count);
+    void setWeightFlowRateRaw(const double* values, qsizetype count);
+
+    // Goal segments. openGoalSegment() makes segment `index` exist (empty) so
+    // the chart sees the break even before the new mode records a goal.
+    const QVector<QVector<QPointF>>& goalSegments(GoalCurve curve) const;
+    void openGoalSegment(GoalCurve curve, int index);
+    void appendGoal(GoalCurve curve, int segment, double time, double value);
+    QVector<QPointF> goalPoints(GoalCurve curve) const;  // all segments, concatenated
+
+    // Keep the first `machineRows` machine samples and drop goal and
+    // weight-flow samples after the last one kept. Weight is never trimmed.
+    void trimMachineRows(qsizetype machineRows);
+
+    void clear();
+    void clearWeights();  // weight and weight-flow clocks only
+
+private:
+    const SampleTable& tableFor(Channel channel, int* index) const;
+    QVector<QVector<QPointF>>& segmentsFor(GoalCurve curve);
+    void resetGoalSegments();
+
+    SampleTable m_machine;
+    SampleTable m_weight;
+    SampleTable m_weightFlow;
+    QVector<QVector<QPointF>> m_pressureGoalSegments;
+    QVector<QVector<QPointF>> m_flowGoalSegments;
+    qsizetype m_capacity = 0;
+};
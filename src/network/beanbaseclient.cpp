@@ -1,5 +1,6 @@
 #include "beanbaseclient.h"
 #include "beanbase_blob.h"
+#include "../core/taskexecutor.h"
 
 #include <QDebug>
 #include <QDir>
@@ -430,61 +431,63 @@ void BeanBaseClient::downloadBagImage(const QString& canonicalId, const QString&
         // is atomic (QSaveFile: temp file, verified write, commit-or-discard) so
         // a disk-full or crash mid-write can never leave a truncated file that
         // satisfies bagImagePath() and suppresses re-resolution forever. The
-        // completion hops back via the `this` connection context and emits when
+        // completion hops back with a queued call on `self` and emits when
         // a file is present at the path — after a refresh whose download failed
         // that is the PREVIOUS photo, which is the intended outcome: the bag
         // keeps the picture it had rather than losing it to a failed refresh.
         const QString dir = imageCacheDir();
         const QString path = dir + QLatin1Char('/') + canonicalId;
         QPointer<BeanBaseClient> self(this);
-        QThread* worker = QThread::create([bytes, dir, path]() {
-            if (!QDir().mkpath(dir)) {
-                qWarning() << "BeanBase: cannot create bag image cache dir" << dir;
-                return;
-            }
-            // QSaveFile, not QFile+rename: it commits atomically OVER an
-            // existing target. QFile::rename refuses a destination that already
-            // exists, which a refresh always has now that the old photo is kept
-            // until the new bytes land — so every refresh would "fail" its
-            // write and silently keep serving the stale image.
-            QSaveFile f(path);
-            const bool ok = f.open(QIODevice::WriteOnly)
-                && f.write(bytes) == bytes.size()
-                && f.commit();
-            if (!ok) {
-                // A local disk fault (full disk, permissions) — unlike the
-                // expected network/og:image misses, this is worth a log line.
-                // QSaveFile discards its own temp file on a failed commit.
-                qWarning() << "BeanBase: bag image write failed" << path << f.errorString();
-                return;
-            }
-            // Keep the cache a cache: evict oldest-written files beyond the
-            // cap (Time|Reversed = oldest first), never the one just written.
-            // A concurrent worker for another id could evict this file between
-            // the emit and the QML load — cosmetic and self-healing (next
-            // session re-resolves), so not worth serializing.
-            QFileInfoList files = QDir(dir).entryInfoList(QDir::Files, QDir::Time | QDir::Reversed);
-            qint64 total = 0;
-            for (const QFileInfo& fi : files)
-                total += fi.size();
-            for (const QFileInfo& fi : files) {
-                if (total <= kBagImageCacheCapBytes)
-                    break;
-                if (fi.filePath() == path)
-                    continue;
-                if (!QFile::remove(fi.filePath())) {
-                    qWarning() << "BeanBase: bag image cache eviction failed" << fi.filePath();
-                    continue;  // Don't credit the failed removal against the cap.
+        TaskExecutor::instance().submit(TaskLane::Background, [self, canonicalId, bytes, dir, path]() {
+            [&]() {
+                if (!QDir().mkpath(dir)) {
+                    qWarning() << "BeanBase: cannot create bag image cache dir" << dir;
+                    return;
                 }
-                total -= fi.size();
-            }
-        });
-        connect(worker, &QThread::finished, worker, &QObject::deleteLater);
-        connect(worker, &QThread::finished, this, [self, canonicalId, path]() {
-            if (self && QFile::exists(path))
-                emit self->bagImageReady(canonicalId, path);
+                // QSaveFile, not QFile+rename: it commits atomically OVER an
+                // existing target. QFile::rename refuses a destination that already
+                // exists, which a refresh always has now that the old photo is kept
+                // until the new bytes land — so every refresh would "fail" its
+                // write and silently keep serving the stale image.
+                QSaveFile f(path);
+                const bool ok = f.open(QIODevice::WriteOnly)
+                    && f.write(bytes) == bytes.size()
+                    && f.commit();
+                if (!ok) {
+                    // A local disk fault (full disk, permissions) — unlike the
+                    // expected network/og:image misses, this is worth a log line.
+                    // QSaveFile discards its own temp file on a failed commit.
+                    qWarning() << "BeanBase: bag image write failed" << path << f.errorString();
+                    return;
+                }
+                // Keep the cache a cache: evict oldest-written files beyond the
+                // cap (Time|Reversed = oldest first), never the one just written.
+                // A concurrent worker for another id could evict this file between
+                // the emit and the QML load — cosmetic and self-healing (next
+                // session re-resolves), so not worth serializing.
+                QFileInfoList files = QDir(dir).entryInfoList(QDir::Files, QDir::Time | QDir::Reversed);
+                qint64 total = 0;
+                for (const QFileInfo& fi : files)
+                    total += fi.size();
+                for (const QFileInfo& fi : files) {
+                    if (total <= kBagImageCacheCapBytes)
+                        break;
+                    if (fi.filePath() == path)
+                        continue;
+                    if (!QFile::remove(fi.filePath())) {
+                        qWarning() << "BeanBase: bag image cache eviction failed" << fi.filePath();
+                        continue;  // Don't credit the failed removal against the cap.
+                    }
+                    total -= fi.size();
+                }
+            }();
+            // Checked here rather than on the main thread: exists() is disk I/O too.
+            const bool present = QFile::exists(path);
+            QMetaObject::invokeMethod(self, [self, canonicalId, path, present]() {
+                if (self && present)
+                    emit self->bagImageReady(canonicalId, path);
+            }, Qt::QueuedConnection);
         });
-        worker->start();
     });
 }
 
@@ -0,0 +1,240 @@
+#include "httpcontentcoding.h"
+
+#include <QCryptographicHash>
+#include <QtEndian>
+
+#include <array>
+
+namespace HttpContentCoding {
+
+namespace {
+
+constexpr std::array<quint32, 256> kCrc32Table = [] {
+    std::array<quint32, 256> table{};
+    for (quint32 n = 0; n < 256; ++n) {
+        quint32 c = n;
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[n] = c;
+    }
+    return table;
+}();
+
+quint32 crc32(QByteArrayView data)
+{
+    quint32 c = 0xFFFFFFFFu;
+    for (const char byte : data)
+        c = kCrc32Table[(c ^ static_cast<quint8>(byte)) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+bool isSpaceOrTab(char c) { return c == ' ' || c == '\t'; }
+
+QByteArrayView trimmedSpaces(QByteArrayView v)
+{
+    while (!v.isEmpty() && isSpaceOrTab(v.front())) v = v.sliced(1);
+    while (!v.isEmpty() && isSpaceOrTab(v.back())) v.chop(1);
+    return v;
+}
+
+bool equalsIgnoreCase(QByteArrayView a, QByteArrayView b)
+{
+    return a.size() == b.size() && a.compare(b, Qt::CaseInsensitive) == 0;
+}
+
+// qvalue = ( "0" [ "." 0*3DIGIT ] ) / ( "1" [ "." 0*3("0") ] ), in
+// thousandths. Anything unparseable counts as 1, as if no weight were given.
+int parseQValue(QByteArrayView params)
+{
+    while (!params.isEmpty()) {
+        const qsizetype semicolon = params.indexOf(';');
+        const QByteArrayView param = trimmedSpaces(semicolon < 0 ? params : params.first(semicolon));
+        if (param.size() >= 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+            const QByteArrayView value = param.sliced(2);
+            if (value.isEmpty() || (value[0] != '0' && value[0] != '1'))
+                return 1000;
+            int q = (value[0] - '0') * 1000;
+            int scale = 100;
+            for (qsizetype i = 2; i < value.size() && i < 5 && value[1] == '.'; ++i, scale /= 10) {
+                if (value[i] < '0' || value[i] > '9')
+                    return 1000;
+                q += (value[i] - '0') * scale;
+            }
+            return qMin(q, 1000);
+        }
+        if (semicolon < 0) break;
+        params = params.sliced(semicolon + 1);
+    }
+    return 1000;
+}
+
+// The opaque part of an entity tag without any coding suffix, so "abc",
+// "abc-gzip" and W/"abc-deflate" all compare as abc.
+QByteArrayView baseOpaqueTag(QByteArrayView opaque)
+{
+    for (const QByteArrayView suffix : {QByteArrayView("-gzip"), QByteArrayView("-deflate")}) {
+        if (opaque.endsWith(suffix))
+            return opaque.chopped(suffix.size());
+    }
+    return opaque;
+}
+
+}  // namespace
+
+Coding negotiate(QByteArrayView acceptEncoding)
+{
+    int gzipQ = -1;
+    int deflateQ = -1;
+    int anyQ = -1;
+    while (!acceptEncoding.isEmpty()) {
+        const qsizetype comma = acceptEncoding.indexOf(',');
+        const QByteArrayView item = comma < 0 ? acceptEncoding : acceptEncoding.first(comma);
+        const qsizetype semicolon = item.indexOf(';');
+        const QByteArrayView coding = trimmedSpaces(semicolon < 0 ? item : item.first(semicolon));
+        const int q = semicolon < 0 ? 1000 : parseQValue(item.sliced(semicolon + 1));
+        if (equalsIgnoreCase(coding, "gzip") || equalsIgnoreCase(coding, "x-gzip"))
+            gzipQ = q;
+        else if (equalsIgnoreCase(coding, "deflate"))
+            deflateQ = q;
+        else if (coding == "*")
+            anyQ = q;
+        if (comma < 0) break;
+        acceptEncoding = acceptEncoding.sliced(comma + 1);
+    }
+
+    // A coding not named is acceptable only through "*".
+    if (gzipQ < 0) gzipQ = qMax(anyQ, 0);
+    if (deflateQ < 0) deflateQ = qMax(anyQ, 0);
+    if (gzipQ > 0 && gzipQ >= deflateQ) return Coding::Gzip;
+    if (deflateQ > 0) return Coding::Deflate;
+    return Coding::Identity;
+}
+
+QByteArrayView token(Coding coding)
+{
+    switch (coding) {
+    case Coding::Gzip:     return "gzip";
+    case Coding::Deflate:  return "deflate";
+    case Coding::Identity: break;
+    }
+    return {};
+}
+
+bool isCompressible(QByteArrayView contentType)
+{
+    const qsizetype semicolon = contentType.indexOf(';');
+    const QByteArrayView type = trimmedSpaces(semicolon < 0 ? contentType : contentType.first(semicolon));
+    if (type.size() > 5 && type.first(5).compare("text/", Qt::CaseInsensitive) == 0)
+        return true;
+    for (const QByteArrayView textual : {QByteArrayView("application/json"), QByteArrayView("application/javascript"),
+                                         QByteArrayView("application/x-ndjson"), QByteArrayView("application/xml"),
+                                         QByteArrayView("image/svg+xml")}) {
+        if (equalsIgnoreCase(type, textual))
+            return true;
+    }
+    return type.endsWith("+json") || type.endsWith("+xml");
+}
+
+bool shouldCompress(QByteArrayView contentType, qsizetype size)
+{
+    return size >= kMinCompressSize && size <= kMaxCompressSize && isCompressible(contentType);
+}
+
+QByteArray encode(QByteArrayView body, Coding coding, int level)
+{
+    if (coding == Coding::Identity)
+        return body.toByteArray();
+
+    // qCompress: 4-byte big-endian length, then a zlib stream (2-byte header,
+    // raw deflate data, 4-byte Adler-32).
+    const QByteArray compressed = qCompress(reinterpret_cast<const uchar*>(body.data()), body.size(), level);
+    if (compressed.size() < 4 + 6)
+        return {};
+    if (coding == Coding::Deflate)
+        return compressed.sliced(4);
+
+    const QByteArrayView raw = QByteArrayView(compressed).sliced(4 + 2, compressed.size() - 4 - 6);
+    QByteArray gzip;
+    gzip.reserve(10 + raw.size() + 8);
+    // ID1 ID2, CM=deflate, no flags, no mtime, no extra flags, OS unknown.
+    static constexpr char kHeader[10] = {'\x1f', '\x8b', '\x08', 0, 0, 0, 0, 0, 0, '\xff'};
+    gzip.append(kHeader, sizeof(kHeader));
+    gzip.append(raw);
+    char trailer[8];
+    qToLittleEndian<quint32>(crc32(body), trailer);
+    qToLittleEndian<quint32>(static_cast<quint32>(body.size()), trailer + 4);
+    gzip.append(trailer, sizeof(trailer));
+    return gzip;
+}
+
+QByteArray strongETag(QByteArrayView key)
+{
+    const QByteArray digest = QCryptographicHash::hash(key, QCryptographicHash::Sha1);
+    return '"' + digest.first(8).toHex() + '"';
+}
+
+QByteArray etagForCoding(const QByteArray& etag, Coding coding)
+{
+    if (coding == Coding::Identity || etag.size() < 2)
+        return etag;
+    return etag.chopped(1) + '-' + token(coding).toByteArray() + '"';
+}
+
+bool ifNoneMatch(QByteArrayView header, const QByteArray& etag)
+{
+    header = trimmedSpaces(header);
+    if (header == "*")
+        return true;
+    if (etag.size() < 2)
+        return false;
+    const QByteArrayView wanted = QByteArrayView(etag).sliced(1, etag.size() - 2);
+
+    // If-None-Match uses the weak comparison: W/ is ignored.
+    qsizetype pos = 0;
+    while (pos < header.size()) {
+        const qsizetype open = header.indexOf('"', pos);
+        if (open < 0) break;
+        const qsizetype close = header.indexOf('"', open + 1);
+        if (close < 0) break;
+        if (baseOpaqueTag(header.sliced(open + 1, close - open - 1)) == wanted)
+            return true;
+        pos = close + 1;
+    }
+    return false;
+}
+
+EncodedAsset EncodedAsset::make(const QByteArray& body, QByteArrayView contentType)
+{
+    EncodedAsset asset;
+    asset.identity = body;
+    asset.etag = strongETag(body);
+    if (shouldCompress(contentType, body.size())) {
+        // Encoded once for the life of the process, so spend the CPU.
+        QByteArray gzip = encode(body, Coding::Gzip, 9);
+        if (!gzip.isEmpty() && gzip.size() < body.size())
+            asset.gzip = std::move(gzip);
+        QByteArray deflate = encode(body, Coding::Deflate, 9);
+        if (!deflate.isEmpty() && deflate.size() < body.size())
+            asset.deflate = std::move(deflate);
+    }
+    return asset;
+}
+
+Coding EncodedAsset::codingFor(Coding accepted) const
+{
+    if (accepted == Coding::Gzip && !gzip.isEmpty()) return Coding::Gzip;
+    if (accepted == Coding::Deflate && !deflate.isEmpty()) return Coding::Deflate;
+    return Coding::Identity;
+}
+
+const QByteArray& EncodedAsset::body(Coding coding) const
+{
+    switch (coding) {
+    case Coding::Gzip:     return gzip;
+    case Coding::Deflate:  return deflate;
+    case Coding::Identity: break;
+    }
+    return identity;
+}
+
+}  // namespace HttpContentCoding
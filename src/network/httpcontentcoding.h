@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+// Content negotiation and validators for ShotServer responses.
+//
+// Coding: which of gzip / deflate / identity a request's Accept-Encoding
+// lets us send, and the encoders for them. Both compressed codings are built
+// on qCompress, so no zlib link is needed: "deflate" in HTTP is the zlib
+// stream qCompress produces behind its 4-byte length prefix, and gzip is the
+// same raw deflate data with the gzip header and CRC-32 trailer around it.
+//
+// Validators: strong ETags and If-None-Match. A strong ETag names one exact
+// byte sequence, and a gzip body is a different sequence from the identity
+// one, so each coding gets its own tag ("<tag>-gzip") — while an
+// If-None-Match naming any coding's variant still counts as a match, because
+// they are all the same representation underneath.
+
+namespace HttpContentCoding {
+
+enum class Coding { Identity, Gzip, Deflate };
+
+// Below this a compressed body saves less than it costs in headers and CPU.
+constexpr qsizetype kMinCompressSize = 1024;
+// Above this a body is sent as-is: encoding runs on the thread answering the
+// request, and nothing that large is a page a browser is waiting to render.
+constexpr qsizetype kMaxCompressSize = 2 * 1024 * 1024;
+
+// The coding to answer with: gzip over deflate when the client weighs them
+// equally, identity when it accepts neither (or sends no Accept-Encoding).
+Coding negotiate(QByteArrayView acceptEncoding);
+
+// Content-Encoding token: "gzip", "deflate", or empty for identity.
+QByteArrayView token(Coding coding);
+
+// Text-like types worth compressing; images other than SVG, archives and
+// databases are already compressed or not worth the CPU.
+bool isCompressible(QByteArrayView contentType);
+bool shouldCompress(QByteArrayView contentType, qsizetype size);
+
+QByteArray encode(QByteArrayView body, Coding coding, int level = -1);
+
+// Quoted strong ETag derived from `key` — a representation's bytes, or
+// anything that changes whenever they do (an id plus a modification stamp).
+QByteArray strongETag(QByteArrayView key);
+// The tag a `coding`-encoded body is sent under.
+QByteArray etagForCoding(const QByteArray& etag, Coding coding);
+// If-None-Match lists `etag` (in any coding's variant), or is "*".
+bool ifNoneMatch(QByteArrayView header, const QByteArray& etag);
+
+// A fixed body (an embedded page, an icon) encoded once in every coding, with
+// its ETag. Build it the first time it is served and keep it. A coding that
+// would not make the body smaller is left empty and served as identity.
+struct EncodedAsset {
+    QByteArray identity;
+    QByteArray gzip;
+    QByteArray deflate;
+    QByteArray etag;
+
+    static EncodedAsset make(const QByteArray& body, QByteArrayView contentType);
+    // The coding to send for a client that accepts `accepted`.
+    Coding codingFor(Coding accepted) const;
+    const QByteArray& body(Coding coding) const;
+};
+
+}  // namespace HttpContentCoding
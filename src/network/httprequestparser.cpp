@@ -0,0 +1,396 @@
+#include "httprequestparser.h"
+
+#include <QIODevice>
+
+namespace {
+
+constexpr qsizetype kMaxChunkSizeLine = 1024;
+
+bool isSpaceOrTab(char c) { return c == ' ' || c == '\t'; }
+
+QByteArrayView trimmedSpaces(QByteArrayView v)
+{
+    while (!v.isEmpty() && isSpaceOrTab(v.front())) v = v.sliced(1);
+    while (!v.isEmpty() && isSpaceOrTab(v.back())) v.chop(1);
+    return v;
+}
+
+bool equalsIgnoreCase(QByteArrayView a, QByteArrayView b)
+{
+    return a.size() == b.size() && a.compare(b, Qt::CaseInsensitive) == 0;
+}
+
+// A comma-separated field value (Connection, Transfer-Encoding) lists `token`.
+bool hasToken(QByteArrayView value, QByteArrayView token)
+{
+    while (!value.isEmpty()) {
+        const qsizetype comma = value.indexOf(',');
+        const QByteArrayView item = trimmedSpaces(comma < 0 ? value : value.first(comma));
+        if (equalsIgnoreCase(item, token)) return true;
+        if (comma < 0) break;
+        value = value.sliced(comma + 1);
+    }
+    return false;
+}
+
+// Non-negative decimal, digits only (no sign, no spaces); -1 if invalid.
+qint64 parseDecimal(QByteArrayView digits)
+{
+    if (digits.isEmpty() || digits.size() > 18) return -1;
+    qint64 value = 0;
+    for (const char c : digits) {
+        if (c < '0' || c > '9') return -1;
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
+
+// Chunk size: hex digits, optionally followed by ";extension"; -1 if invalid.
+qint64 parseChunkSizeLine(QByteArrayView line)
+{
+    const qsizetype semicolon = line.indexOf(';');
+    const QByteArrayView digits = trimmedSpaces(semicolon < 0 ? line : line.first(semicolon));
+    if (digits.isEmpty() || digits.size() > 15) return -1;
+    qint64 value = 0;
+    for (const char c : digits) {
+        int nibble;
+        if (c >= '0' && c <= '9')      nibble = c - '0';
+        else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+        else return -1;
+        value = (value << 4) | nibble;
+    }
+    return value;
+}
+
+}  // namespace
+
+// ─── HttpRequest ────────────────────────────────────────────────────────────
+
+QByteArrayView HttpRequest::header(QByteArrayView name) const
+{
+    for (const Field& field : m_fields) {
+        if (equalsIgnoreCase(view(field.name), name))
+            return view(field.value);
+    }
+    return {};
+}
+
+bool HttpRequest::hasHeader(QByteArrayView name) const
+{
+    for (const Field& field : m_fields) {
+        if (equalsIgnoreCase(view(field.name), name))
+            return true;
+    }
+    return false;
+}
+
+QByteArrayView HttpRequest::cookie(QByteArrayView name) const
+{
+    // Browsers send one Cookie field, but HTTP/1.1 allows several.
+    for (const Field& field : m_fields) {
+        if (!equalsIgnoreCase(view(field.name), "Cookie"))
+            continue;
+        QByteArrayView pairs = view(field.value);
+        while (!pairs.isEmpty()) {
+            const qsizetype semicolon = pairs.indexOf(';');
+            const QByteArrayView pair = trimmedSpaces(semicolon < 0 ? pairs : pairs.first(semicolon));
+            const qsizetype eq = pair.indexOf('=');
+            if (eq > 0 && pair.first(eq) == name)
+                return pair.sliced(eq + 1);
+            if (semicolon < 0) break;
+            pairs = pairs.sliced(semicolon + 1);
+        }
+    }
+    return {};
+}
+
+bool HttpRequest::keepAlive() const
+{
+    const QByteArrayView connection = header("Connection");
+    if (hasToken(connection, "close")) return false;
+    if (hasToken(connection, "keep-alive")) return true;
+    return version() == "HTTP/1.1";
+}
+
+// ─── HttpRequestParser ──────────────────────────────────────────────────────
+
+HttpRequestParser::HttpRequestParser(qsizetype maxHeadSize)
+    : m_maxHeadSize(maxHeadSize)
+{
+}
+
+void HttpRequestParser::append(const QByteArray& data)
+{
+    if (m_pos == m_buffer.size()) {
+        // Nothing pending — adopt the socket's buffer instead of copying it.
+        m_buffer = data;
+        m_pos = 0;
+        m_scanFrom = 0;
+    } else {
+        m_buffer.append(data);
+    }
+}
+
+HttpRequestParser::Status HttpRequestParser::fail(int status, const QString& reason)
+{
+    m_state = State::Failed;
+    m_errorStatus = status;
+    m_errorString = reason;
+    return Status::Error;
+}
+
+void HttpRequestParser::compact()
+{
+    if (m_pos == m_buffer.size()) {
+        m_buffer.clear();
+        m_pos = 0;
+        m_scanFrom = 0;
+    } else if (m_pos > 0 && m_pos >= m_buffer.size() / 2) {
+        // Drop the consumed front once it is most of the buffer, so a stream
+        // of pipelined requests doesn't grow it without bound.
+        m_buffer.remove(0, m_pos);
+        m_scanFrom = qMax<qsizetype>(0, m_scanFrom - m_pos);
+        m_pos = 0;
+    }
+}
+
+HttpRequestParser::Status HttpRequestParser::parse()
+{
+    for (;;) {
+        bool progressed = false;
+        switch (m_state) {
+        case State::Head:         return parseHead();
+        case State::Body:         progressed = stepBody(); break;
+        case State::ChunkSize:    progressed = stepChunkSize(); break;
+        case State::ChunkData:    progressed = stepChunkData(); break;
+        case State::ChunkDataEnd: progressed = stepChunkDataEnd(); break;
+        case State::Trailer:      progressed = stepTrailer(); break;
+        case State::Done:         return Status::Complete;
+        case State::Failed:       return Status::Error;
+        }
+        if (!progressed) {
+            compact();
+            return Status::NeedMore;
+        }
+    }
+}
+
+HttpRequestParser::Status HttpRequestParser::parseHead()
+{
+    // Tolerate the stray CRLF some clients send after a POST body.
+    while (m_buffer.size() - m_pos >= 2 && m_buffer.at(m_pos) == '\r' && m_buffer.at(m_pos + 1) == '\n')
+        m_pos += 2;
+
+    const qsizetype end = m_buffer.indexOf("\r\n\r\n", qMax(m_pos, m_scanFrom));
+    if (end < 0) {
+        if (bufferedSize() > m_maxHeadSize)
+            return fail(413, QStringLiteral("Headers too large"));
+        // Resume the search where this one stopped; a terminator split across
+        // reads starts at most three bytes back.
+        m_scanFrom = qMax(m_pos, m_buffer.size() - 3);
+        compact();
+        return Status::NeedMore;
+    }
+    if (end - m_pos > m_maxHeadSize)
+        return fail(413, QStringLiteral("Headers too large"));
+
+    m_request = HttpRequest();
+    m_request.m_head = m_buffer.sliced(m_pos, end - m_pos);
+    m_pos = end + 4;
+    m_scanFrom = m_pos;
+
+    const QByteArrayView head(m_request.m_head);
+
+    // Request line: method SP request-target SP HTTP-version
+    qsizetype lineEnd = head.indexOf("\r\n");
+    if (lineEnd < 0) lineEnd = head.size();
+    const QByteArrayView requestLine = head.first(lineEnd);
+    const qsizetype sp1 = requestLine.indexOf(' ');
+    const qsizetype sp2 = sp1 < 0 ? -1 : requestLine.indexOf(' ', sp1 + 1);
+    if (sp1 <= 0 || sp2 <= sp1 + 1 || requestLine.indexOf(' ', sp2 + 1) >= 0)
+        return fail(400, QStringLiteral("Malformed request line"));
+    m_request.m_method = {0, sp1};
+    m_request.m_target = {sp1 + 1, sp2 - sp1 - 1};
+    m_request.m_version = {sp2 + 1, lineEnd - sp2 - 1};
+    if (!m_request.version().startsWith("HTTP/1."))
+        return fail(400, QStringLiteral("Unsupported HTTP version"));
+
+    // Header fields: name ":" OWS value OWS
+    qsizetype lineStart = lineEnd + 2;
+    while (lineStart < head.size()) {
+        qsizetype next = head.indexOf("\r\n", lineStart);
+        if (next < 0) next = head.size();
+        const QByteArrayView line = head.sliced(lineStart, next - lineStart);
+        const qsizetype colon = line.indexOf(':');
+        // Obsolete line folding and whitespace before the colon are both
+        // request-smuggling vectors; RFC 9112 says reject.
+        if (colon <= 0 || isSpaceOrTab(line.front()) || isSpaceOrTab(line.at(colon - 1)))
+            return fail(400, QStringLiteral("Malformed header field"));
+
+        qsizetype valueStart = colon + 1;
+        qsizetype valueEnd = line.size();
+        while (valueStart < valueEnd && isSpaceOrTab(line.at(valueStart))) ++valueStart;
+        while (valueEnd > valueStart && isSpaceOrTab(line.at(valueEnd - 1))) --valueEnd;
+        m_request.m_fields.append({{lineStart, colon}, {lineStart + valueStart, valueEnd - valueStart}});
+        lineStart = next + 2;
+    }
+
+    // Body framing. Transfer-Encoding and Content-Length together, or two
+    // Content-Lengths that disagree, are rejected rather than guessed at.
+    m_chunked = false;
+    m_contentLength = 0;
+    bool sawLength = false;
+    for (qsizetype i = 0; i < m_request.headerCount(); ++i) {
+        const QByteArrayView name = m_request.headerName(i);
+        if (equalsIgnoreCase(name, "Transfer-Encoding")) {
+            if (!equalsIgnoreCase(m_request.headerValue(i), "chunked"))
+                return fail(501, QStringLiteral("Unsupported transfer coding"));
+            m_chunked = true;
+        } else if (equalsIgnoreCase(name, "Content-Length")) {
+            const qint64 length = parseDecimal(m_request.headerValue(i));
+            if (length < 0 || (sawLength && length != m_contentLength))
+                return fail(400, QStringLiteral("Invalid Content-Length"));
+            m_contentLength = length;
+            sawLength = true;
+        }
+    }
+    if (m_chunked && sawLength)
+        return fail(400, QStringLiteral("Both Content-Length and Transfer-Encoding"));
+    if (m_chunked)
+        m_contentLength = -1;
+
+    m_remaining = m_chunked ? 0 : m_contentLength;
+    m_bodyReceived = 0;
+    m_maxBodySize = kDefaultMaxBodySize;
+    m_sink = nullptr;
+    m_state = m_chunked ? State::ChunkSize : State::Body;
+    return Status::HeadComplete;
+}
+
+bool HttpRequestParser::consumeBody(qint64 count)
+{
+    if (m_bodyReceived + count > m_maxBodySize) {
+        fail(413, QStringLiteral("Request body too large"));
+        return false;
+    }
+    const char* data = m_buffer.constData() + m_pos;
+    if (m_sink) {
+        if (m_sink->write(data, count) != count) {
+            fail(500, QStringLiteral("Could not store request body"));
+            return false;
+        }
+    } else {
+        if (m_request.m_body.isEmpty() && !m_chunked)
+            m_request.m_body.reserve(m_contentLength);
+        m_request.m_body.append(data, count);
+    }
+    m_pos += count;
+    m_bodyReceived += count;
+    m_request.m_bodySize = m_bodyReceived;
+    return true;
+}
+
+// Each step returns false when it is starved for bytes, true when it moved the
+// state on (to the next state, Done or Failed).
+
+bool HttpRequestParser::stepBody()
+{
+    // Refuse an oversized Content-Length up front rather than after reading it.
+    if (m_bodyReceived == 0 && m_contentLength > m_maxBodySize) {
+        fail(413, QStringLiteral("Request body too large"));
+        return true;
+    }
+    const qint64 count = qMin<qint64>(m_remaining, bufferedSize());
+    if (count > 0 && !consumeBody(count))
+        return true;
+    m_remaining -= count;
+    if (m_remaining > 0)
+        return false;
+    m_state = State::Done;
+    return true;
+}
+
+bool HttpRequestParser::stepChunkSize()
+{
+    const qsizetype eol = m_buffer.indexOf("\r\n", m_pos);
+    if (eol < 0) {
+        if (bufferedSize() <= kMaxChunkSizeLine)
+            return false;
+        fail(400, QStringLiteral("Malformed chunk size"));
+        return true;
+    }
+    const qint64 size = parseChunkSizeLine(QByteArrayView(m_buffer).sliced(m_pos, eol - m_pos));
+    if (size < 0) {
+        fail(400, QStringLiteral("Malformed chunk size"));
+        return true;
+    }
+    if (m_bodyReceived + size > m_maxBodySize) {
+        fail(413, QStringLiteral("Request body too large"));
+        return true;
+    }
+    m_pos = eol + 2;
+    m_remaining = size;
+    m_state = size == 0 ? State::Trailer : State::ChunkData;
+    return true;
+}
+
+bool HttpRequestParser::stepChunkData()
+{
+    const qint64 count = qMin<qint64>(m_remaining, bufferedSize());
+    if (count > 0 && !consumeBody(count))
+        return true;
+    m_remaining -= count;
+    if (m_remaining > 0)
+        return false;
+    m_state = State::ChunkDataEnd;
+    return true;
+}
+
+bool HttpRequestParser::stepChunkDataEnd()
+{
+    if (bufferedSize() < 2)
+        return false;
+    if (m_buffer.at(m_pos) != '\r' || m_buffer.at(m_pos + 1) != '\n') {
+        fail(400, QStringLiteral("Malformed chunk"));
+        return true;
+    }
+    m_pos += 2;
+    m_state = State::ChunkSize;
+    return true;
+}
+
+bool HttpRequestParser::stepTrailer()
+{
+    // Trailer fields are read past and ignored; an empty line ends the body.
+    for (;;) {
+        const qsizetype eol = m_buffer.indexOf("\r\n", m_pos);
+        if (eol < 0) {
+            if (bufferedSize() <= m_maxHeadSize)
+                return false;
+            fail(413, QStringLiteral("Headers too large"));
+            return true;
+        }
+        const bool last = eol == m_pos;
+        m_pos = eol + 2;
+        if (last) {
+            m_state = State::Done;
+            return true;
+        }
+    }
+}
+
+HttpRequest HttpRequestParser::takeRequest()
+{
+    HttpRequest request = std::move(m_request);
+    m_request = HttpRequest();
+    m_state = State::Head;
+    m_contentLength = 0;
+    m_chunked = false;
+    m_remaining = 0;
+    m_bodyReceived = 0;
+    m_maxBodySize = kDefaultMaxBodySize;
+    m_sink = nullptr;
+    compact();
+    return request;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QVarLengthArray>
+
+class QIODevice;
+
+/**
+ * One parsed HTTP/1.1 request, as handed to ShotServer's route handlers.
+ *
+ * The request line and header block are kept as the single byte array they
+ * arrived in; method(), target(), header() and cookie() are views into it, so
+ * looking a header up neither splits nor copies the request. Views stay valid
+ * for as long as this object (or a copy of it) does.
+ */
+class HttpRequest {
+public:
+    QByteArrayView method() const { return view(m_method); }
+    // Path plus query, exactly as sent ("/api/shots?limit=20").
+    QByteArrayView target() const { return view(m_target); }
+    QByteArrayView version() const { return view(m_version); }
+
+    // First field named `name` (case-insensitive), trimmed; empty if absent.
+    QByteArrayView header(QByteArrayView name) const;
+    bool hasHeader(QByteArrayView name) const;
+    qsizetype headerCount() const { return m_fields.size(); }
+    QByteArrayView headerName(qsizetype i) const { return view(m_fields[i].name); }
+    QByteArrayView headerValue(qsizetype i) const { return view(m_fields[i].value); }
+
+    // Value of cookie `name` from the Cookie header(s); empty if absent.
+    QByteArrayView cookie(QByteArrayView name) const;
+
+    // Request line and header fields, without the terminating blank line.
+    const QByteArray& head() const { return m_head; }
+    // The decoded body (chunked framing removed). Empty when the body went to
+    // a sink — see HttpRequestParser::setBodySink().
+    const QByteArray& body() const { return m_body; }
+    qint64 bodySize() const { return m_bodySize; }
+    // For a body that went to a sink and was read back.
+    void setBody(QByteArray body) { m_body = std::move(body); m_bodySize = m_body.size(); }
+
+    // HTTP/1.1 defaults to persistent, HTTP/1.0 to close; Connection overrides.
+    bool keepAlive() const;
+
+private:
+    friend class HttpRequestParser;
+
+    struct Span {
+        qsizetype offset = 0;
+        qsizetype size = 0;
+    };
+    struct Field {
+        Span name;
+        Span value;
+    };
+
+    QByteArrayView view(Span span) const { return QByteArrayView(m_head).sliced(span.offset, span.size); }
+
+    QByteArray m_head;
+    Span m_method;
+    Span m_target;
+    Span m_version;
+    QVarLengthArray<Field, 16> m_fields;
+    QByteArray m_body;
+    qint64 m_bodySize = 0;
+};
+
+/**
+ * Incremental HTTP/1.1 request parser for one connection.
+ *
+ * Bytes go in as they arrive (append()); parse() advances a state machine over
+ * them and reports where it stopped. The head is located by resuming the
+ * "\r\n\r\n" search where the last read left off, then tokenized in one pass
+ * into offsets — the only copy is the head itself. Bodies are framed by
+ * Content-Length or chunked transfer coding and consumed as they arrive, into
+ * memory or into a sink device. Bytes past the end of a request stay buffered
+ * for the next one, so pipelined requests parse back to back.
+ *
+ * Typical loop:
+ *
+ *     parser.append(socket->readAll());
+ *     for (;;) {
+ *         switch (parser.parse()) {
+ *         case Status::HeadComplete: ...inspect parser.request(), maybe setBodySink()...; continue;
+ *         case Status::Complete:     handle(parser.takeRequest()); continue;
+ *         case Status::NeedMore:     return;
+ *         case Status::Error:        reply parser.errorStatus(), close; return;
+ *         }
+ *     }
+ */
+class HttpRequestParser {
+public:
+    enum class Status {
+        NeedMore,       // everything buffered is consumed; wait for more bytes
+        HeadComplete,   // request line + headers parsed, body not yet read
+        Complete,       // a whole request is ready: takeRequest()
+        Error           // malformed or over a limit; the connection is done
+    };
+
+    static constexpr qsizetype kDefaultMaxHeadSize = 64 * 1024;
+    static constexpr qint64 kDefaultMaxBodySize = 1024 * 1024;
+
+    explicit HttpRequestParser(qsizetype maxHeadSize = kDefaultMaxHeadSize);
+
+    void append(const QByteArray& data);
+    Status parse();
+
+    // Valid from HeadComplete until takeRequest(). The body is filled in by
+    // the time parse() returns Complete.
+    const HttpRequest& request() const { return m_request; }
+    HttpRequest takeRequest();
+
+    // Declared body length: Content-Length, 0 when there is no body, -1 when
+    // chunked (unknown until the last chunk).
+    qint64 contentLength() const { return m_contentLength; }
+    bool isChunked() const { return m_chunked; }
+    qint64 bodyReceived() const { return m_bodyReceived; }
+
+    // Set after HeadComplete: how large this request's body may grow (in
+    // memory or in the sink) before parse() fails with 413, and optionally a
+    // device the body is written to instead of HttpRequest::body(). The
+    // parser does not own the sink; both reset for the next request.
+    void setMaxBodySize(qint64 bytes) { m_maxBodySize = bytes; }
+    void setBodySink(QIODevice* sink) { m_sink = sink; }
+
+    // Nothing of a request has arrived yet (idle between requests).
+    bool isIdle() const { return m_state == State::Head && m_buffer.size() == m_pos; }
+    // Bytes received but not yet consumed: after takeRequest(), the start of
+    // a pipelined next request.
+    qsizetype bufferedSize() const { return m_buffer.size() - m_pos; }
+
+    // After Error: the status to answer with (400, 413, 501) and why.
+    int errorStatus() const { return m_errorStatus; }
+    QString errorString() const { return m_errorString; }
+
+private:
+    enum class State { Head, Body, ChunkSize, ChunkData, ChunkDataEnd, Trailer, Done, Failed };
+
+    Status parseHead();
+    bool stepBody();
+    bool stepChunkSize();
+    bool stepChunkData();
+    bool stepChunkDataEnd();
+    bool stepTrailer();
+    bool consumeBody(qint64 count);
+    Status fail(int status, const QString& reason);
+    void compact();
+
+    QByteArray m_buffer;
+    qsizetype m_pos = 0;          // first unconsumed byte of m_buffer
+    qsizetype m_scanFrom = 0;     // where the head-terminator search resumes
+    qsizetype m_maxHeadSize;
+
+    State m_state = State::Head;
+    HttpRequest m_request;
+    qint64 m_contentLength = 0;
+    bool m_chunked = false;
+    qint64 m_remaining = 0;       // of the body or the current chunk
+    qint64 m_bodyReceived = 0;
+    qint64 m_maxBodySize = kDefaultMaxBodySize;
+    QIODevice* m_sink = nullptr;
+
+    int m_errorStatus = 0;
+    QString m_errorString;
+};
@@ -0,0 +1,148 @@
+#include "httpresponsestream.h"
+
+#include "../core/taskexecutor.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QTcpSocket>
+
+HttpResponseStream::HttpResponseStream(QTcpSocket* socket, QByteArray head, qint64 contentLength, Producer producer)
+    : QObject(socket)
+    , m_socket(socket)
+    , m_head(std::move(head))
+    , m_contentLength(contentLength)
+    , m_producer(std::make_shared<Producer>(std::move(producer)))
+{
+}
+
+void HttpResponseStream::start()
+{
+    if (m_started) return;
+    m_started = true;
+    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+        fail("socket closed before the response started");
+        return;
+    }
+
+    connect(m_socket, &QIODevice::bytesWritten, this, &HttpResponseStream::pump);
+    if (m_socket->write(m_head) == -1) {
+        fail("failed to write the response head");
+        return;
+    }
+    m_head.clear();
+
+    if (m_contentLength == 0) {
+        deliver(true, QByteArray());
+        return;
+    }
+    pump();
+}
+
+void HttpResponseStream::pump()
+{
+    if (m_done || m_inFlight || !m_socket) return;
+    if (m_socket->state() != QAbstractSocket::ConnectedState) return;
+    // Still plenty queued: the next bytesWritten calls back in.
+    if (m_socket->bytesToWrite() >= kLowWater) return;
+
+    m_inFlight = true;
+    QPointer<HttpResponseStream> self(this);
+    TaskExecutor::instance().submit(TaskLane::Interactive, [self, producer = m_producer]() {
+        QByteArray piece;
+        const bool ok = (*producer)(piece);
+        // Marshalled through qApp: the stream can be gone (its socket closed)
+        // by the time the piece is ready.
+        QMetaObject::invokeMethod(qApp, [self, ok, piece = std::move(piece)]() mutable {
+            if (self) self->deliver(ok, std::move(piece));
+        }, Qt::QueuedConnection);
+    }, CancellationToken::boundTo(this));
+}
+
+void HttpResponseStream::deliver(bool ok, QByteArray piece)
+{
+    m_inFlight = false;
+    if (m_done) return;
+    if (!m_socket || m_socket->state() != QAbstractSocket::ConnectedState) {
+        // Not an error: the client cancelled the download.
+        qDebug() << "HttpResponseStream: client went away after" << m_sent << "body bytes";
+        m_done = true;
+        emit finished(false);
+        deleteLater();
+        return;
+    }
+    if (!ok) {
+        fail("the body could not be produced");
+        return;
+    }
+
+    const bool chunked = m_contentLength < 0;
+    if (piece.isEmpty()) {
+        if (!chunked && m_sent != m_contentLength) {
+            fail("body ended short of its Content-Length");
+            return;
+        }
+        // Last chunk and an empty trailer section.
+        if (chunked && m_socket->write("0\r\n\r\n") == -1) {
+            fail("socket write failed");
+            return;
+        }
+        m_done = true;
+        emit finished(true);
+        deleteLater();
+        return;
+    }
+
+    if (!chunked && m_sent + piece.size() > m_contentLength) {
+        fail("body ran past its Content-Length");
+        return;
+    }
+    QByteArray framed;
+    if (chunked) {
+        framed.reserve(piece.size() + 12);
+        framed += QByteArray::number(piece.size(), 16) + "\r\n";
+        framed += piece;
+        framed += "\r\n";
+    }
+    if (m_socket->write(chunked ? framed : piece) == -1) {
+        fail("socket write failed");
+        return;
+    }
+    m_sent += piece.size();
+
+    // A sized body is complete without asking the producer for its end.
+    if (!chunked && m_sent == m_contentLength) {
+        deliver(true, QByteArray());
+        return;
+    }
+    pump();
+}
+
+void HttpResponseStream::fail(const char* reason)
+{
+    if (m_done) return;
+    m_done = true;
+    qWarning() << "HttpResponseStream:" << reason << "after" << m_sent << "body bytes";
+    if (m_socket && m_socket->state() != QAbstractSocket::UnconnectedState)
+        m_socket->abort();
+    emit finished(false);
+    deleteLater();
+}
+
+HttpResponseStream::Producer HttpResponseStream::fileProducer(const QString& path, qint64 offset)
+{
+    return [path, offset](QByteArray& piece) mutable {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly) || !file.seek(offset)) {
+            qWarning() << "HttpResponseStream: cannot read" << path << "at" << offset << "-" << file.errorString();
+            return false;
+        }
+        piece = file.read(kPieceSize);
+        if (piece.isEmpty() && file.error() != QFileDevice::NoError) {
+            qWarning() << "HttpResponseStream: read failed on" << path << "-" << file.errorString();
+            return false;
+        }
+        offset += piece.size();
+        return true;
+    };
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+#include <functional>
+#include <memory>
+
+class QTcpSocket;
+
+/**
+ * A response body written as the client drains it, not all at once.
+ *
+ * ShotServer used to build every body in memory before writing it: a shots
+ * database backup was read whole into a QByteArray, and sendFile looped over
+ * waitForBytesWritten(), spinning a nested event loop on the GUI thread for as
+ * long as the download took. Here the body comes from a Producer, one piece at
+ * a time, and the next piece is only asked for once the socket's write buffer
+ * has drained below kLowWater (bytesWritten drives it). A slow client therefore
+ * holds at most about kLowWater + kPieceSize of the body in memory, however
+ * large it is, and the event loop never waits on it.
+ *
+ * The Producer runs on a TaskExecutor worker — it reads files and queries the
+ * database, which the main thread must not — and the pieces come back queued.
+ *
+ * Framing is Content-Length when the size is known up front (files), chunked
+ * otherwise. Either way the status line has gone out before the body is
+ * complete, so a body that fails halfway can only be reported by aborting the
+ * connection: a chunked body then lacks its last chunk, a sized one falls short,
+ * and the client sees a truncated transfer rather than a complete-looking one.
+ *
+ * The stream is a child of its socket, so a client that goes away takes the
+ * stream with it and any piece still being produced is dropped.
+ */
+class HttpResponseStream : public QObject {
+    Q_OBJECT
+
+public:
+    // Fills `piece` with the next part of the body — kPieceSize bytes or so —
+    // and returns true. An empty piece ends the body. False: the body cannot be
+    // completed (a read failed), and the connection is aborted.
+    //
+    // Called on a worker, one call at a time and in order, so it may keep state
+    // in its captures (a read offset, a keyset cursor) — but nothing bound to a
+    // thread: consecutive calls can land on different workers, so open the
+    // database per call (withTempDb) rather than holding a query open.
+    using Producer = std::function<bool(QByteArray& piece)>;
+
+    static constexpr qsizetype kPieceSize = 64 * 1024;
+    // The next piece is produced once fewer than this many bytes wait in the
+    // socket's write buffer.
+    static constexpr qint64 kLowWater = 256 * 1024;
+
+    // `head` is the status line and header fields through the blank line. With
+    // `contentLength` >= 0 it carries that Content-Length and the body must come
+    // to exactly that many bytes; with -1 it carries Transfer-Encoding: chunked.
+    HttpResponseStream(QTcpSocket* socket, QByteArray head, qint64 contentLength, Producer producer);
+
+    // Writes the head and starts on the body.
+    void start();
+
+    qint64 bodyBytesSent() const { return m_sent; }
+
+    // Reads `path` from `offset` onward, kPieceSize bytes per call. The file is
+    // opened per call, so no QFile outlives one worker task.
+    static Producer fileProducer(const QString& path, qint64 offset = 0);
+
+signals:
+    // The whole body is in the socket's write buffer (true), or the stream gave
+    // up and aborted the socket (false). The stream deletes itself afterwards.
+    void finished(bool ok);
+
+private:
+    void pump();
+    void deliver(bool ok, QByteArray piece);
+    void fail(const char* reason);
+
+    QPointer<QTcpSocket> m_socket;
+    QByteArray m_head;
+    qint64 m_contentLength;
+    std::shared_ptr<Producer> m_producer;
+    qint64 m_sent = 0;
+    bool m_started = false;
+    bool m_inFlight = false;
+    bool m_done = false;
+};
@@ -0,0 +1,638 @@
+#include "httpserverthread.h"
+
+#include <QDebug>
+#include <QRegularExpression>
+#include <QSocketNotifier>
+#include <QSslServer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <utility>
+
+#ifdef Q_OS_WIN
+#include <winsock2.h>
+#else
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+// ---------------------------------------------------------------------------
+// HttpRedirectSslServer – QSslServer subclass that detects plain HTTP
+// connections and replies with a 301 redirect to https://.
+//
+// When a new connection arrives, we peek at the first byte using raw recv():
+//   0x16 = TLS ClientHello -> hand off to QSslServer for normal TLS flow
+//   anything else          -> parse HTTP request, send 301, close
+//
+// Host and path are sanitized against CRLF header injection.
+// ---------------------------------------------------------------------------
+class HttpRedirectSslServer : public QSslServer {
+public:
+    explicit HttpRedirectSslServer(QObject* parent = nullptr)
+        : QSslServer(parent) {}
+
+    ~HttpRedirectSslServer() override {
+        // Close any file descriptors still waiting for data
+        for (auto it = m_pending.begin(); it != m_pending.end(); ++it) {
+            delete it.value().notifier;
+            delete it.value().timer;
+            closeFd(it.key());
+        }
+        m_pending.clear();
+    }
+
+protected:
+    void incomingConnection(qintptr fd) override {
+        // We can't peek yet – data may not have arrived. Use QSocketNotifier
+        // to wait asynchronously for the first byte.
+        auto* notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        auto* timer = new QTimer(this);
+        timer->setSingleShot(true);
+        timer->setInterval(5000);
+
+        PendingConn pc;
+        pc.notifier = notifier;
+        pc.timer = timer;
+        m_pending.insert(fd, pc);
+
+        connect(notifier, &QSocketNotifier::activated, this, [this, fd]() {
+            handleFirstByte(fd);
+        });
+
+        connect(timer, &QTimer::timeout, this, [this, fd]() {
+            qDebug() << "HttpRedirectSslServer: Timeout waiting for first byte, fd:" << fd;
+            cleanupPending(fd);
+            closeFd(fd);
+        });
+
+        timer->start();
+    }
+
+private:
+    struct PendingConn {
+        QSocketNotifier* notifier = nullptr;
+        QTimer* timer = nullptr;
+    };
+    QHash<qintptr, PendingConn> m_pending;
+
+    // Platform-appropriate socket type from qintptr
+#ifdef Q_OS_WIN
+    static SOCKET toNativeFd(qintptr fd) { return static_cast<SOCKET>(fd); }
+#else
+    static int toNativeFd(qintptr fd) { return static_cast<int>(fd); }
+#endif
+
+    void handleFirstByte(qintptr fd) {
+        auto it = m_pending.find(fd);
+        if (it == m_pending.end()) return;
+
+        // Disable notifier immediately to avoid re-entry
+        it.value().notifier->setEnabled(false);
+
+        unsigned char peek = 0;
+        auto n = ::recv(toNativeFd(fd), reinterpret_cast<char*>(&peek), 1, MSG_PEEK);
+
+        if (n <= 0) {
+            if (n < 0) {
+#ifdef Q_OS_WIN
+                qWarning() << "HttpRedirectSslServer: recv(MSG_PEEK) failed, fd:" << fd
+                           << "WSA error:" << WSAGetLastError();
+#else
+                qWarning() << "HttpRedirectSslServer: recv(MSG_PEEK) failed, fd:" << fd
+                           << "errno:" << errno << strerror(errno);
+#endif
+            }
+            cleanupPending(fd);
+            closeFd(fd);
+            return;
+        }
+
+        cleanupPending(fd);
+
+        if (peek == 0x16) {
+            // TLS ClientHello – hand off to QSslServer for normal processing
+            QSslServer::incomingConnection(fd);
+        } else {
+            // Plain HTTP – read request, send redirect, close
+            sendHttpRedirect(fd);
+        }
+    }
+
+    void sendHttpRedirect(qintptr fd) {
+        // Read whatever HTTP data is available (up to 4 KB is plenty for a request line + headers)
+        char buf[4096];
+        auto n = ::recv(toNativeFd(fd), buf, sizeof(buf) - 1, 0);
+        if (n <= 0) {
+            closeFd(fd);
+            return;
+        }
+        buf[n] = '\0';
+
+        // Parse path from "GET /path HTTP/1.x"
+        QString path = "/";
+        QByteArray request(buf, n);
+        qsizetype firstSpace = request.indexOf(' ');
+        if (firstSpace > 0) {
+            qsizetype secondSpace = request.indexOf(' ', firstSpace + 1);
+            if (secondSpace > firstSpace + 1) {
+                path = QString::fromLatin1(request.mid(firstSpace + 1, secondSpace - firstSpace - 1));
+            }
+        }
+
+        // Parse Host header
+        QString host = "localhost";
+        qsizetype hostIdx = request.indexOf("Host:");
+        if (hostIdx < 0) hostIdx = request.indexOf("host:");
+        if (hostIdx >= 0) {
+            qsizetype start = hostIdx + 5;
+            while (start < request.size() && request.at(start) == ' ') ++start;
+            qsizetype end = request.indexOf('\r', start);
+            if (end < 0) end = request.indexOf('\n', start);
+            if (end > start) {
+                host = QString::fromLatin1(request.mid(start, end - start));
+                // Strip port from host if present (we'll add our own)
+                if (host.startsWith('[')) {
+                    // IPv6 literal: [::1]:port – strip after closing bracket
+                    qsizetype closeBracket = host.indexOf(']');
+                    if (closeBracket > 0)
+                        host = host.left(closeBracket + 1);
+                } else {
+                    qsizetype colonIdx = host.lastIndexOf(':');
+                    if (colonIdx > 0) host = host.left(colonIdx);
+                }
+            }
+        }
+
+        // Sanitize host and path to prevent header injection via CRLF
+        static QRegularExpression validHost(QStringLiteral("^[a-zA-Z0-9.\\-]+$|^\\[[0-9a-fA-F:]+\\]$"));
+        if (!validHost.match(host).hasMatch())
+            host = QStringLiteral("localhost");
+        path.remove(QChar('\r'));
+        path.remove(QChar('\n'));
+
+        QString location = QString("https://%1:%2%3").arg(host).arg(serverPort()).arg(path);
+        QByteArray response =
+            "HTTP/1.1 301 Moved Permanently\r\n"
+            "Location: " + location.toLatin1() + "\r\n"
+            "Content-Length: 0\r\n"
+            "Connection: close\r\n"
+            "\r\n";
+
+        auto sent = ::send(toNativeFd(fd), response.constData(), response.size(), 0);
+        if (sent < 0)
+            qWarning() << "HttpRedirectSslServer: send() failed, fd:" << fd;
+        else if (sent < response.size())
+            qWarning() << "HttpRedirectSslServer: partial send" << sent << "/" << response.size() << "fd:" << fd;
+        closeFd(fd);
+    }
+
+    void cleanupPending(qintptr fd) {
+        auto it = m_pending.find(fd);
+        if (it != m_pending.end()) {
+            delete it.value().notifier;
+            delete it.value().timer;
+            m_pending.erase(it);
+        }
+    }
+
+    static void closeFd(qintptr fd) {
+#ifdef Q_OS_WIN
+        ::closesocket(toNativeFd(fd));
+#else
+        ::close(toNativeFd(fd));
+#endif
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Listener – the I/O thread's side. Owns the server and the real sockets and
+// talks to the main thread only by posting to the owning HttpServerThread,
+// which outlives the thread (its destructor joins it).
+// ---------------------------------------------------------------------------
+class HttpServerThread::Listener : public QObject {
+public:
+    explicit Listener(HttpServerThread* owner) : m_owner(owner) {}
+    ~Listener() override { stop(); }
+
+    bool listen(const QHostAddress& address, quint16 port, const QSslConfiguration* tls,
+                QString* error, quint16* boundPort)
+    {
+        stop();
+        if (tls) {
+            auto* sslServer = new HttpRedirectSslServer(this);
+            sslServer->setSslConfiguration(*tls);
+            m_server = sslServer;
+            // Use pendingConnectionAvailable (not newConnection) for QSslServer:
+            // newConnection fires on TCP accept (before SSL handshake), when hasPendingConnections() is still false.
+            // pendingConnectionAvailable fires after handshake completes and socket is added to the pending queue.
+            connect(m_server, &QTcpServer::pendingConnectionAvailable, this, &Listener::acceptPending);
+            connect(sslServer, &QSslServer::sslErrors, this, [](QSslSocket* /*socket*/, const QList<QSslError>& errors) {
+                for (const auto& err : errors)
+                    qWarning() << "ShotServer: SSL error:" << err.errorString();
+            });
+            connect(sslServer, &QSslServer::handshakeInterruptedOnError, this, [](QSslSocket* /*socket*/, const QSslError& error) {
+                qWarning() << "ShotServer: SSL handshake interrupted:" << error.errorString();
+            });
+            connect(sslServer, &QSslServer::peerVerifyError, this, [](QSslSocket* /*socket*/, const QSslError& error) {
+                qWarning() << "ShotServer: SSL peer verify error:" << error.errorString();
+            });
+        } else {
+            m_server = new QTcpServer(this);
+            connect(m_server, &QTcpServer::newConnection, this, &Listener::acceptPending);
+        }
+        connect(m_server, &QTcpServer::acceptError, this, [this](QAbstractSocket::SocketError err) {
+            qWarning() << "ShotServer: accept error:" << err
+                       << "socketDescriptor:" << m_server->socketDescriptor()
+                       << "isListening:" << m_server->isListening();
+        });
+
+        if (!m_server->listen(address, port)) {
+            *error = m_server->errorString();
+            delete m_server;
+            m_server = nullptr;
+            return false;
+        }
+        *boundPort = m_server->serverPort();
+        return true;
+    }
+
+    // Drops the server and every connection, each reported closed.
+    void stop()
+    {
+        const QList<quint64> ids = m_clients.keys();
+        for (quint64 id : ids) {
+            QTcpSocket* socket = m_clients.take(id).socket;
+            socket->disconnect(this);
+            socket->abort();
+            delete socket;
+            post([id](HttpServerThread* owner) { owner->closed(id); });
+        }
+        if (m_server) {
+            m_server->close();
+            delete m_server;
+            m_server = nullptr;
+        }
+    }
+
+    void health()
+    {
+        const qintptr fd = m_server ? m_server->socketDescriptor() : -1;
+        const bool listening = m_server && m_server->isListening();
+        post([fd, listening](HttpServerThread* owner) { emit owner->healthChecked(fd, listening); });
+    }
+
+    void write(quint64 id, const QByteArray& bytes)
+    {
+        // Gone already: the main thread has its closed() on the way.
+        auto it = m_clients.find(id);
+        if (it != m_clients.end())
+            it->socket->write(bytes);
+    }
+
+    void consume(quint64 id, qint64 bytes)
+    {
+        auto it = m_clients.find(id);
+        if (it == m_clients.end()) return;
+        it->inFlight -= bytes;
+        pull(id);
+    }
+
+    // The stand-in was closed or destroyed. Same as QAbstractSocket::close():
+    // what was written still goes out, then the connection closes.
+    void release(quint64 id)
+    {
+        auto it = m_clients.find(id);
+        if (it == m_clients.end()) return;
+        QTcpSocket* socket = it->socket;
+        socket->disconnectFromHost();
+        // With nothing left to write that can disconnect synchronously, and
+        // drop() has run; otherwise disconnected() arrives once it has drained.
+        if (m_clients.contains(id) && socket->state() == QAbstractSocket::UnconnectedState)
+            drop(id);
+    }
+
+private:
+    struct Client {
+        QTcpSocket* socket = nullptr;
+        qint64 inFlight = 0;  // Received bytes posted to the stand-in, not yet read there
+    };
+
+    template <typename F>
+    void post(F&& f)
+    {
+        QMetaObject::invokeMethod(m_owner, [owner = m_owner, f = std::forward<F>(f)]() { f(owner); },
+                                  Qt::QueuedConnection);
+    }
+
+    void acceptPending()
+    {
+        while (m_server && m_server->hasPendingConnections())
+            adopt(m_server->nextPendingConnection());
+    }
+
+    void adopt(QTcpSocket* socket)
+    {
+        const quint64 id = m_nextId++;
+        // Owned here from now on, not by the server: a restart replaces the
+        // server, and stop() decides when the sockets go.
+        socket->setParent(this);
+        // What Qt reads ahead of us. Together with kReadWindow this caps what
+        // one client's upload can hold in memory before TCP pushes back.
+        socket->setReadBufferSize(kReadWindow);
+        m_clients.insert(id, Client{socket});
+
+        connect(socket, &QIODevice::readyRead, this, [this, id]() { pull(id); });
+        connect(socket, &QIODevice::bytesWritten, this, [this, id](qint64 bytes) {
+            post([id, bytes](HttpServerThread* owner) { owner->written(id, bytes); });
+        });
+        connect(socket, &QAbstractSocket::disconnected, this, [this, id]() { drop(id); });
+
+        post([id, peer = socket->peerAddress(), peerPort = socket->peerPort(),
+              local = socket->localAddress(), localPort = socket->localPort()](HttpServerThread* owner) {
+            owner->accepted(id, peer, peerPort, local, localPort);
+        });
+        // A TLS client's first request can arrive with the end of its handshake.
+        pull(id);
+    }
+
+    // Forwards what has arrived, up to the client's read window.
+    void pull(quint64 id)
+    {
+        auto it = m_clients.find(id);
+        if (it == m_clients.end()) return;
+        const qint64 room = kReadWindow - it->inFlight;
+        if (room <= 0) return;
+        QByteArray bytes = it->socket->read(room);
+        if (bytes.isEmpty()) return;
+        it->inFlight += bytes.size();
+        post([id, bytes = std::move(bytes)](HttpServerThread* owner) { owner->received(id, bytes); });
+    }
+
+    void drop(quint64 id)
+    {
+        auto it = m_clients.find(id);
+        if (it == m_clients.end()) return;
+        QTcpSocket* socket = it->socket;
+        m_clients.erase(it);
+        // Whatever arrived before the close still reaches the reader, ahead of
+        // closed() — a request followed by a half-close is a complete request.
+        QByteArray rest = socket->isOpen() ? socket->readAll() : QByteArray();
+        if (!rest.isEmpty())
+            post([id, rest = std::move(rest)](HttpServerThread* owner) { owner->received(id, rest); });
+        socket->disconnect(this);
+        socket->deleteLater();
+        post([id](HttpServerThread* owner) { owner->closed(id); });
+    }
+
+    HttpServerThread* m_owner;
+    QTcpServer* m_server = nullptr;
+    QHash<quint64, Client> m_clients;
+    quint64 m_nextId = 1;
+};
+
+// ---------------------------------------------------------------------------
+// Connection – the main thread's stand-in for one client socket.
+//
+// Overrides the QIODevice/QAbstractSocket virtuals that carry data and keeps
+// the socket state, peer and local address in QAbstractSocket's own fields, so
+// state(), peerAddress(), write(), readAll(), close() and the usual signals
+// behave as they do on a connected QTcpSocket. It never opens a descriptor.
+// ---------------------------------------------------------------------------
+class HttpServerThread::Connection : public QTcpSocket {
+public:
+    Connection(HttpServerThread* owner, quint64 id, const QHostAddress& peer, quint16 peerPort,
+               const QHostAddress& local, quint16 localPort)
+        : QTcpSocket(owner), m_owner(owner), m_id(id)
+    {
+        setPeerAddress(peer);
+        setPeerPort(peerPort);
+        setLocalAddress(local);
+        setLocalPort(localPort);
+        setSocketState(ConnectedState);
+        // Unbuffered: m_incoming is the read buffer, so QIODevice keeps none.
+        QIODevice::open(QIODevice::ReadWrite | QIODevice::Unbuffered);
+    }
+
+    ~Connection() override
+    {
+        m_owner->m_connections.remove(m_id);
+        if (!m_released)
+            m_owner->release(m_id);
+        // Already handed over. Left Connected, QAbstractSocket's destructor
+        // would abort() and emit disconnected() from a half-destroyed object.
+        setSocketState(UnconnectedState);
+    }
+
+    void deliver(const QByteArray& bytes)
+    {
+        if (m_readOffset > 0) {
+            m_incoming.remove(0, m_readOffset);
+            m_readOffset = 0;
+        }
+        m_incoming += bytes;
+        emit readyRead();
+    }
+
+    void acknowledge(qint64 bytes)
+    {
+        m_unwritten = qMax<qint64>(0, m_unwritten - bytes);
+        emit bytesWritten(bytes);
+    }
+
+    void transportClosed()
+    {
+        m_released = true;
+        if (state() == UnconnectedState) return;
+        setSocketState(UnconnectedState);
+        emit stateChanged(UnconnectedState);
+        emit readChannelFinished();
+        emit disconnected();
+    }
+
+    qint64 bytesAvailable() const override
+    {
+        return (m_incoming.size() - m_readOffset) + QTcpSocket::bytesAvailable();
+    }
+
+    // Written here but not yet taken by the kernel on the I/O thread — what
+    // HttpResponseStream's backpressure measures.
+    qint64 bytesToWrite() const override { return m_unwritten; }
+
+    // Graceful: the I/O thread sends what it holds, then closes. abort() and
+    // close() come through here too, and get the same treatment — there is no
+    // override point that tells them apart, and a response cut short is still
+    // cut short when its last queued bytes go out first.
+    void disconnectFromHost() override
+    {
+        if (state() != ConnectedState) return;
+        setSocketState(ClosingState);
+        emit stateChanged(ClosingState);
+        if (!m_released) {
+            m_released = true;
+            m_owner->release(m_id);
+        }
+    }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override
+    {
+        const qint64 n = qMin<qint64>(maxSize, m_incoming.size() - m_readOffset);
+        if (n <= 0)
+            return (state() == UnconnectedState && maxSize > 0) ? -1 : 0;
+        memcpy(data, m_incoming.constData() + m_readOffset, n);
+        m_readOffset += n;
+        if (m_readOffset == m_incoming.size()) {
+            m_incoming.clear();
+            m_readOffset = 0;
+        }
+        // One report per event-loop pass, however many reads readAll() made.
+        if (m_unreported == 0) {
+            QMetaObject::invokeMethod(this, [this]() {
+                if (!m_released)
+                    m_owner->consumed(m_id, std::exchange(m_unreported, 0));
+                else
+                    m_unreported = 0;
+            }, Qt::QueuedConnection);
+        }
+        m_unreported += n;
+        return n;
+    }
+
+    qint64 writeData(const char* data, qint64 size) override
+    {
+        if (state() != ConnectedState) return -1;
+        m_unwritten += size;
+        m_owner->send(m_id, QByteArray(data, size));
+        return size;
+    }
+
+private:
+    HttpServerThread* const m_owner;
+    const quint64 m_id;
+    QByteArray m_incoming;
+    qsizetype m_readOffset = 0;
+    qint64 m_unwritten = 0;
+    qint64 m_unreported = 0;
+    bool m_released = false;  // The I/O thread has been told to close, or has closed
+};
+
+// ---------------------------------------------------------------------------
+
+HttpServerThread::HttpServerThread(QObject* parent)
+    : QObject(parent)
+{
+    m_thread.setObjectName(QStringLiteral("HTTP-IO"));
+    m_listener = new Listener(this);
+    m_listener->moveToThread(&m_thread);
+    m_thread.start();
+}
+
+HttpServerThread::~HttpServerThread()
+{
+    close();
+    // Deleted on its own thread: its sockets' notifiers are registered there.
+    QMetaObject::invokeMethod(m_listener, [listener = m_listener]() { delete listener; },
+                              Qt::BlockingQueuedConnection);
+    m_listener = nullptr;
+    m_thread.quit();
+    m_thread.wait();
+    // Stand-ins still alive (closed, awaiting their deleteLater) go now, while
+    // the members their destructors touch still exist — QObject's destructor
+    // would delete them after those are gone.
+    const QObjectList children = this->children();
+    for (QObject* child : children)
+        delete dynamic_cast<Connection*>(child);
+}
+
+bool HttpServerThread::listen(const QHostAddress& address, quint16 port)
+{
+    return startListening(address, port, nullptr);
+}
+
+bool HttpServerThread::listenTls(const QHostAddress& address, quint16 port, const QSslConfiguration& tls)
+{
+    return startListening(address, port, &tls);
+}
+
+bool HttpServerThread::startListening(const QHostAddress& address, quint16 port, const QSslConfiguration* tls)
+{
+    close();
+    bool ok = false;
+    QString error;
+    quint16 boundPort = 0;
+    // Blocking, main -> I/O only (see the header): a bind takes microseconds,
+    // and start() has always reported a busy port as its return value.
+    QMetaObject::invokeMethod(m_listener, [&]() {
+        ok = m_listener->listen(address, port, tls, &error, &boundPort);
+    }, Qt::BlockingQueuedConnection);
+    m_listening = ok;
+    m_serverPort = ok ? boundPort : 0;
+    m_errorString = error;
+    return ok;
+}
+
+void HttpServerThread::close()
+{
+    // Blocking too, so the descriptors are closed when this returns — the APK
+    // installer handover (#865) needs them gone before it dispatches.
+    QMetaObject::invokeMethod(m_listener, [listener = m_listener]() { listener->stop(); },
+                              Qt::BlockingQueuedConnection);
+    m_listening = false;
+    m_serverPort = 0;
+}
+
+void HttpServerThread::checkHealth()
+{
+    if (!m_listener) return;
+    QMetaObject::invokeMethod(m_listener, [listener = m_listener]() { listener->health(); },
+                              Qt::QueuedConnection);
+}
+
+void HttpServerThread::accepted(quint64 id, const QHostAddress& peer, quint16 peerPort,
+                                const QHostAddress& local, quint16 localPort)
+{
+    auto* connection = new Connection(this, id, peer, peerPort, local, localPort);
+    m_connections.insert(id, connection);
+    emit newConnection(connection);
+}
+
+void HttpServerThread::received(quint64 id, const QByteArray& bytes)
+{
+    if (Connection* connection = m_connections.value(id))
+        connection->deliver(bytes);
+}
+
+void HttpServerThread::written(quint64 id, qint64 bytes)
+{
+    if (Connection* connection = m_connections.value(id))
+        connection->acknowledge(bytes);
+}
+
+void HttpServerThread::closed(quint64 id)
+{
+    if (Connection* connection = m_connections.take(id))
+        connection->transportClosed();
+}
+
+void HttpServerThread::send(quint64 id, const QByteArray& bytes)
+{
+    if (!m_listener) return;
+    QMetaObject::invokeMethod(m_listener, [listener = m_listener, id, bytes]() { listener->write(id, bytes); },
+                              Qt::QueuedConnection);
+}
+
+void HttpServerThread::consumed(quint64 id, qint64 bytes)
+{
+    if (!m_listener) return;
+    QMetaObject::invokeMethod(m_listener, [listener = m_listener, id, bytes]() { listener->consume(id, bytes); },
+                              Qt::QueuedConnection);
+}
+
+void HttpServerThread::release(quint64 id)
+{
+    if (!m_listener) return;
+    QMetaObject::invokeMethod(m_listener, [listener = m_listener, id]() { listener->release(id); },
+                              Qt::QueuedConnection);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QHash>
+#include <QHostAddress>
+#include <QObject>
+#include <QPointer>
+#include <QSslConfiguration>
+#include <QString>
+#include <QThread>
+
+class QTcpSocket;
+
+/**
+ * ShotServer's network stack, on its own "HTTP-IO" thread.
+ *
+ * The listening socket, every accepted connection, the TLS handshake and all
+ * encryption and decryption, and the plain-HTTP-to-HTTPS redirect run there. A
+ * handshake that stalls on a slow phone and a 400 MB upload being decrypted no
+ * longer run on the GUI thread.
+ *
+ * ShotServer still gets a QTcpSocket per client, created on the main thread and
+ * emitted by newConnection(). It is a stand-in for the real socket: writes are
+ * handed to the I/O thread, received bytes arrive as readyRead, and
+ * bytesWritten / bytesToWrite follow the real socket. HttpResponseStream's
+ * backpressure therefore works unchanged, and so does every handler. Request
+ * handling stays on the main thread because that is where MachineState,
+ * Settings and the storage objects live. The only bridge between the two
+ * threads is this class's queued messages. The I/O thread never touches a
+ * main-thread object.
+ *
+ * Received bytes are flow-controlled. At most kReadWindow bytes are in flight
+ * to a stand-in before its reader consumes them. Past that the real socket's
+ * read buffer fills and TCP pushes back on the client, so a fast upload to a
+ * busy GUI thread cannot pile up in memory.
+ *
+ * Same one-way rule as the BLE I/O thread (src/ble/bleiothread.h). The main
+ * thread may block on the I/O thread: listen() and close() wait for the bind
+ * and unbind, so start() still reports a busy port synchronously. The I/O
+ * thread never blocks on the main thread.
+ */
+class HttpServerThread : public QObject {
+    Q_OBJECT
+
+public:
+    // Received bytes a stand-in may hold before its reader drains them.
+    static constexpr qint64 kReadWindow = 1024 * 1024;
+
+    explicit HttpServerThread(QObject* parent = nullptr);
+    ~HttpServerThread() override;
+
+    // Plain HTTP.
+    bool listen(const QHostAddress& address, quint16 port);
+    // HTTPS with `tls`. A plain-HTTP request on the same port gets a 301 to
+    // https://, so a bookmarked http:// address still works.
+    bool listenTls(const QHostAddress& address, quint16 port, const QSslConfiguration& tls);
+    // Stops listening and drops every connection. Stand-ins still open see
+    // disconnected().
+    void close();
+
+    bool isListening() const { return m_listening; }
+    quint16 serverPort() const { return m_serverPort; }
+    QString errorString() const { return m_errorString; }
+
+    // Asks the I/O thread for the listening socket's state. The answer comes
+    // back as healthChecked().
+    void checkHealth();
+
+signals:
+    // A client connected (for HTTPS, after its handshake). `socket` lives on
+    // the main thread and is a child of this object. The receiver owns it from
+    // here: close() and deleteLater() it as with any QTcpServer socket.
+    void newConnection(QTcpSocket* socket);
+    void healthChecked(qintptr socketDescriptor, bool listening);
+
+private:
+    class Listener;
+    class Connection;
+
+    bool startListening(const QHostAddress& address, quint16 port, const QSslConfiguration* tls);
+
+    // I/O thread -> main thread, always queued through this object.
+    void accepted(quint64 id, const QHostAddress& peer, quint16 peerPort,
+                  const QHostAddress& local, quint16 localPort);
+    void received(quint64 id, const QByteArray& bytes);
+    void written(quint64 id, qint64 bytes);
+    void closed(quint64 id);
+
+    // Main thread -> I/O thread.
+    void send(quint64 id, const QByteArray& bytes);
+    void consumed(quint64 id, qint64 bytes);
+    void release(quint64 id);
+
+    QThread m_thread;
+    Listener* m_listener = nullptr;  // Lives on m_thread
+    QHash<quint64, QPointer<Connection>> m_connections;
+    bool m_listening = false;
+    quint16 m_serverPort = 0;
+    QString m_errorString;
+};
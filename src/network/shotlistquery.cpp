@@ -0,0 +1,319 @@
+#include "shotlistquery.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QLocale>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QUrlQuery>
+
+namespace ShotListQuery {
+
+namespace {
+
+// "Strictly after (timestamp, id)", led by a bare `timestamp <= ?` so SQLite
+// starts the idx_shots_timestamp range at the cursor. The plainer
+// `timestamp < ? OR (timestamp = ? AND id < ?)` is the same set of rows, but
+// SQLite walks the index up from the oldest shot to reach it: 50 ms a page at
+// the newest end of 200k shots, against 0.05 ms for this form at either end.
+const char* const kKeysetCondition = " WHERE shots.timestamp <= ? AND (shots.timestamp < ? OR shots.id < ?)";
+const char* const kNewestFirst = " ORDER BY shots.timestamp DESC, shots.id DESC";
+
+QVariant value(const QSqlQuery& query, int column, Kind kind)
+{
+    const QVariant v = query.value(column);
+    switch (kind) {
+    case Kind::Integer: return v.toLongLong();
+    case Kind::Real: return v.toDouble();
+    case Kind::Text: return v.toString();
+    case Kind::Flag: return v.toInt() != 0;
+    case Kind::Present: return !v.toString().isEmpty();
+    case Kind::LocalDateTime: {
+        static const bool use12h = QLocale::system().timeFormat(QLocale::ShortFormat).contains("AP", Qt::CaseInsensitive);
+        return QDateTime::fromSecsSinceEpoch(v.toLongLong())
+            .toString(use12h ? "yyyy-MM-dd h:mm AP" : "yyyy-MM-dd HH:mm");
+    }
+    }
+    return {};
+}
+
+// Binds the keyset condition's values (when `after`) and then the LIMIT.
+void bindPage(QSqlQuery& query, const ShotListCursor& after, int limit)
+{
+    int i = 0;
+    if (after.valid) {
+        query.bindValue(i++, after.timestamp);
+        query.bindValue(i++, after.timestamp);
+        query.bindValue(i++, after.id);
+    }
+    query.bindValue(i, limit);
+}
+
+}  // namespace
+
+const QList<Field>& fields()
+{
+    // Recipe identity is joined in, matching the in-app history list
+    // (history-recipe-identity): live from `recipes` by id, never snapshotted
+    // onto the shot, so renaming a recipe relabels its whole history. LEFT so a
+    // recipe-less shot is still listed.
+    //
+    // ShotProjection-ALIGNED key names. enjoyment0to100, drinkTdsPct and
+    // drinkEyPct were `enjoyment`, `drinkTds` and `drinkEy` while
+    // ShotProjection::fromVariantMap has always read the former, so
+    // generateShotListPage saw 0 for all three: the web card's rating chip
+    // never rendered, and the client-side `rating:`, `tds:` and `ey:` searches
+    // plus the rating sort matched nothing. A key MISMATCH rather than an
+    // absence, so it survives even a "does every field appear in both
+    // functions" audit — one table for both the page and the API is the fix.
+    static const QList<Field> all = {
+        {"id", "shots.id", Kind::Integer},
+        {"uuid", "shots.uuid", Kind::Text},
+        {"timestamp", "shots.timestamp", Kind::Integer},
+        {"profileName", "shots.profile_name", Kind::Text},
+        {"durationSec", "shots.duration_seconds", Kind::Real},
+        {"finalWeightG", "shots.final_weight", Kind::Real},
+        {"doseWeightG", "shots.dose_weight", Kind::Real},
+        {"beanBrand", "shots.bean_brand", Kind::Text},
+        {"beanType", "shots.bean_type", Kind::Text},
+        {"enjoyment0to100", "shots.enjoyment", Kind::Real},
+        {"hasVisualizerUpload", "shots.visualizer_id", Kind::Present},
+        {"grinderSetting", "shots.grinder_setting", Kind::Text},
+        {"rpm", "shots.rpm", Kind::Integer},  // RPM half of the dial-in
+        {"temperatureOverrideC", "shots.temperature_override", Kind::Real},
+        {"targetWeightG", "shots.yield_override", Kind::Real},
+        {"beverageType", "shots.beverage_type", Kind::Text},
+        {"drinkTdsPct", "shots.drink_tds", Kind::Real},
+        {"drinkEyPct", "shots.drink_ey", Kind::Real},
+        {"recipeId", "shots.recipe_id", Kind::Integer},
+        {"recipeName", "r.name", Kind::Text},
+        {"recipeDrinkType", "r.drink_type", Kind::Text},
+        {"recipeArchived", "r.archived", Kind::Flag},
+        {"dateTime", "shots.timestamp", Kind::LocalDateTime},
+    };
+    return all;
+}
+
+Projection project(const QList<int>& wanted)
+{
+    Projection p;
+    p.selectList = {QStringLiteral("shots.timestamp"), QStringLiteral("shots.id")};
+    const QList<Field>& all = fields();
+    auto add = [&p, &all](int field) {
+        const QString column = QString::fromLatin1(all[field].column);
+        qsizetype at = p.selectList.indexOf(column);
+        if (at < 0) {
+            at = p.selectList.size();
+            p.selectList.append(column);
+        }
+        p.fields.append(field);
+        p.columns.append(static_cast<int>(at));
+        if (column.startsWith(QLatin1String("r.")))
+            p.joinsRecipes = true;
+    };
+    if (wanted.isEmpty()) {
+        for (int i = 0; i < all.size(); ++i)
+            add(i);
+    } else {
+        for (int field : wanted)
+            add(field);
+    }
+    return p;
+}
+
+QString Projection::sql(bool after) const
+{
+    QString sql = QStringLiteral("SELECT ") + selectList.join(QStringLiteral(", ")) + QStringLiteral(" FROM shots");
+    if (joinsRecipes)
+        sql += QStringLiteral(" LEFT JOIN recipes r ON r.id = shots.recipe_id");
+    // idx_shots_timestamp gives the timestamp order and the keyset range;
+    // only shots sharing a timestamp are sorted by id, so a page reads about
+    // `limit` index entries however long the history is.
+    if (after)
+        sql += QLatin1String(kKeysetCondition);
+    sql += QLatin1String(kNewestFirst);
+    sql += QStringLiteral(" LIMIT ?");
+    return sql;
+}
+
+QJsonObject Projection::toJson(const QSqlQuery& query) const
+{
+    const QList<Field>& all = ShotListQuery::fields();  // not the member
+    QJsonObject row;
+    for (qsizetype i = 0; i < fields.size(); ++i) {
+        const Field& field = all[fields[i]];
+        row.insert(QLatin1String(field.key), QJsonValue::fromVariant(value(query, columns[i], field.kind)));
+    }
+    return row;
+}
+
+QVariantMap Projection::toVariantMap(const QSqlQuery& query) const
+{
+    const QList<Field>& all = ShotListQuery::fields();  // not the member
+    QVariantMap row;
+    for (qsizetype i = 0; i < fields.size(); ++i) {
+        const Field& field = all[fields[i]];
+        row.insert(QString::fromLatin1(field.key), value(query, columns[i], field.kind));
+    }
+    return row;
+}
+
+bool execute(QSqlQuery& query, const Projection& projection, int limit, const ShotListCursor& after)
+{
+    query.setForwardOnly(true);
+    const bool prepared = query.prepare(projection.sql(after.valid));
+    if (prepared)
+        bindPage(query, after, limit);
+    if (!prepared || !query.exec()) {
+        qWarning() << "ShotServer: Shot list query failed:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool encodePage(QSqlDatabase& db, const Projection& projection, int limit, ShotListCursor& after,
+                bool ndjson, QByteArray& out, int& count)
+{
+    count = 0;
+    QSqlQuery query(db);
+    if (!execute(query, projection, limit, after))
+        return false;
+    while (query.next()) {
+        if (!ndjson && count > 0)
+            out += ',';
+        out += QJsonDocument(projection.toJson(query)).toJson(QJsonDocument::Compact);
+        if (ndjson)
+            out += '\n';
+        after = {query.value(0).toLongLong(), query.value(1).toLongLong(), true};
+        ++count;
+    }
+    return true;
+}
+
+bool nextCursor(QSqlDatabase& db, int limit, const ShotListCursor& after, ShotListCursor& next)
+{
+    next = {};
+    // The page's last row, and whether another follows it.
+    QString sql = QStringLiteral("SELECT shots.timestamp, shots.id FROM shots");
+    if (after.valid)
+        sql += QLatin1String(kKeysetCondition);
+    sql += QLatin1String(kNewestFirst);
+    sql += QStringLiteral(" LIMIT 2 OFFSET ?");
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    const bool prepared = query.prepare(sql);
+    if (prepared)
+        bindPage(query, after, limit - 1);
+    if (!prepared || !query.exec()) {
+        qWarning() << "ShotServer: Shot list cursor query failed:" << query.lastError().text();
+        return false;
+    }
+    if (!query.next())
+        return true;
+    const ShotListCursor last{query.value(0).toLongLong(), query.value(1).toLongLong(), true};
+    if (query.next())
+        next = last;
+    return true;
+}
+
+Request parse(const QUrlQuery& query, QByteArrayView accept)
+{
+    Request request;
+    if (query.hasQueryItem(QStringLiteral("limit"))) {
+        bool ok = false;
+        const qint64 limit = query.queryItemValue(QStringLiteral("limit")).toLongLong(&ok);
+        if (!ok || limit < 1) {
+            request.error = QStringLiteral("limit must be a positive integer");
+            return request;
+        }
+        request.limit = static_cast<int>(qMin<qint64>(limit, kMaxLimit));
+    }
+    if (query.hasQueryItem(QStringLiteral("after"))) {
+        request.after = decodeCursor(query.queryItemValue(QStringLiteral("after")).toLatin1());
+        if (!request.after.valid) {
+            request.error = QStringLiteral("Invalid cursor");
+            return request;
+        }
+    }
+    if (query.hasQueryItem(QStringLiteral("fields"))) {
+        const QList<Field>& all = fields();
+        const QStringList names = query.queryItemValue(QStringLiteral("fields"), QUrl::FullyDecoded)
+                                      .split(QLatin1Char(','), Qt::SkipEmptyParts);
+        for (const QString& raw : names) {
+            const QString name = raw.trimmed();
+            int found = -1;
+            for (int i = 0; i < all.size() && found < 0; ++i) {
+                if (name == QLatin1String(all[i].key))
+                    found = i;
+            }
+            if (found < 0) {
+                request.error = QStringLiteral("Unknown field: ") + name;
+                return request;
+            }
+            if (!request.fields.contains(found))
+                request.fields.append(found);
+        }
+        if (request.fields.isEmpty()) {
+            request.error = QStringLiteral("fields lists no field");
+            return request;
+        }
+    }
+    const QString format = query.queryItemValue(QStringLiteral("format"));
+    if (format == QLatin1String("ndjson")) {
+        request.ndjson = true;
+    } else if (format.isEmpty()) {
+        request.ndjson = accept.toByteArray().contains("application/x-ndjson");
+    } else if (format != QLatin1String("json")) {
+        request.error = QStringLiteral("format must be json or ndjson");
+        return request;
+    }
+    return request;
+}
+
+QByteArray nextLink(const Request& request, const ShotListCursor& next)
+{
+    QByteArray target = "/api/shots?limit=" + QByteArray::number(request.limit);
+    if (!request.fields.isEmpty()) {
+        const QList<Field>& all = fields();
+        target += "&fields=";
+        for (qsizetype i = 0; i < request.fields.size(); ++i) {
+            if (i > 0)
+                target += ',';
+            target += all[request.fields[i]].key;
+        }
+    }
+    if (request.ndjson)
+        target += "&format=ndjson";
+    target += "&after=" + encodeCursor(next);
+    return '<' + target + ">; rel=\"next\"";
+}
+
+QByteArray encodeCursor(const ShotListCursor& cursor)
+{
+    return (QByteArray::number(cursor.timestamp) + ',' + QByteArray::number(cursor.id))
+        .toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
+}
+
+ShotListCursor decodeCursor(QByteArrayView encoded)
+{
+    const auto decoded = QByteArray::fromBase64Encoding(
+        encoded.toByteArray(), QByteArray::Base64UrlEncoding | QByteArray::AbortOnBase64DecodingErrors);
+    if (!decoded)
+        return {};
+    const QByteArray& text = *decoded;
+    const qsizetype comma = text.indexOf(',');
+    if (comma <= 0)
+        return {};
+    bool timestampOk = false;
+    bool idOk = false;
+    const qint64 timestamp = text.left(comma).toLongLong(&timestampOk);
+    const qint64 id = text.mid(comma + 1).toLongLong(&idOk);
+    if (!timestampOk || !idOk || id <= 0)
+        return {};
+    return {timestamp, id, true};
+}
+
+}  // namespace ShotListQuery
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+class QSqlDatabase;
+class QSqlQuery;
+class QUrlQuery;
+
+// Keyset position in the newest-first shot list: the (timestamp, id) of the
+// last row already returned. The list is ordered on exactly that pair, so the
+// next page starts strictly after it however many shots share a timestamp.
+struct ShotListCursor {
+    qint64 timestamp = 0;
+    qint64 id = 0;
+    bool valid = false;
+};
+
+// GET /api/shots paging and projection, split out of ShotServer so it can be
+// tested without a server (the same reason as grindcandidates.h).
+//
+//   ?limit=N        at most N shots (1..kMaxLimit; larger is clamped)
+//   ?after=CURSOR   the shots after CURSOR, which the previous page's
+//                   Link: rel="next" header carries
+//   ?fields=a,b,c   only these keys per shot. Only their columns are selected,
+//                   and the recipes join is skipped unless a recipe field is
+//                   among them.
+//   ?format=ndjson  (or Accept: application/x-ndjson) one object per line
+//                   instead of a JSON array
+//
+// Every page is an index range on idx_shots_timestamp, so its cost depends on
+// N and the fields, not on how long the history is. Without parameters the
+// response is what it has always been: the newest kMaxLimit shots, every
+// field, as an array.
+namespace ShotListQuery {
+
+inline constexpr int kMaxLimit = 1000;
+
+// How a column becomes a value.
+enum class Kind {
+    Integer,
+    Real,
+    Text,
+    Flag,           // an integer, true when non-zero
+    Present,        // true when the text is non-empty
+    LocalDateTime,  // epoch seconds, formatted for the list page
+};
+
+// One key of a shot row. The keys are ShotProjection-aligned:
+// ShotProjection::fromVariantMap reads the /shots page's rows by them.
+struct Field {
+    const char* key;
+    const char* column;  // Qualified: shots and recipes share nine column names
+    Kind kind;
+};
+
+// Every field, in the order a full row lists them.
+const QList<Field>& fields();
+
+// The SELECT for a set of fields. Columns 0 and 1 are always shots.timestamp
+// and shots.id, because the cursor needs them. Fields that read either column
+// reuse it, and the other columns follow without duplicates.
+struct Projection {
+    QList<int> fields;       // Indices into fields()
+    QList<int> columns;      // Result column of each field
+    QStringList selectList;
+    bool joinsRecipes = false;
+
+    // Newest first, with the keyset condition when `after`, LIMIT bound last.
+    QString sql(bool after) const;
+    QJsonObject toJson(const QSqlQuery& query) const;
+    QVariantMap toVariantMap(const QSqlQuery& query) const;
+};
+
+// Empty `fields` means all of them.
+Projection project(const QList<int>& fields = {});
+
+// Prepares and runs `projection`'s query: up to `limit` shots after `after`
+// (when valid). Logs and returns false on failure.
+bool execute(QSqlQuery& query, const Projection& projection, int limit, const ShotListCursor& after);
+
+// Up to `limit` shots after `after`, as compact JSON: array elements joined by
+// commas, or with `ndjson` one object per line. Appends to `out`, counts the
+// rows in `count` and moves `after` to the last of them.
+bool encodePage(QSqlDatabase& db, const Projection& projection, int limit, ShotListCursor& after,
+                bool ndjson, QByteArray& out, int& count);
+
+// Where the page of `limit` shots after `after` ends, when more shots follow
+// it. Otherwise `next` is left invalid: that page is the last. An index range
+// of `limit` + 1 entries, whatever the history holds.
+bool nextCursor(QSqlDatabase& db, int limit, const ShotListCursor& after, ShotListCursor& next);
+
+struct Request {
+    int limit = kMaxLimit;
+    ShotListCursor after;
+    QList<int> fields;   // Empty: all
+    bool ndjson = false;
+    QString error;       // Set when the request is malformed; answer 400 with it
+};
+
+// Parses the query string of GET /api/shots and its Accept header.
+Request parse(const QUrlQuery& query, QByteArrayView accept);
+
+// The link to the page after `next`: the same limit, fields and format.
+QByteArray nextLink(const Request& request, const ShotListCursor& next);
+
+// The cursor is opaque to clients: base64url of "timestamp,id". Decoding
+// anything else yields an invalid cursor.
+QByteArray encodeCursor(const ShotListCursor& cursor);
+ShotListCursor decodeCursor(QByteArrayView encoded);
+
+}  // namespace ShotListQuery
@@ -12,12 +12,15 @@
 #include "../core/settings.h"
 #include "../core/settings_dye.h"
 #include "grindcandidates.h"
+#include "shotlistquery.h"
 #include "../core/settings_network.h"
 #include "../core/settings_theme.h"
 #include "../core/settings_mcp.h"
 #include "../core/profilestorage.h"
 #include "../core/settingsserializer.h"
 #include "../core/dbutils.h"
+#include "../core/latencystats.h"
+#include "../core/taskexecutor.h"
 #include "../ai/aimanager.h"
 #include "../core/batterymanager.h"
 #include "../core/memorymonitor.h"
@@ -51,16 +54,6 @@
 #include <QCoreApplication>
 #include <QRegularExpression>
 #include <QRandomGenerator>
-#include <QSslServer>
-#include <QSocketNotifier>
-
-#ifdef Q_OS_WIN
-#include <winsock2.h>
-#else
-#include <sys/socket.h>
-#include <unistd.h>
-#include <cerrno>
-#endif
 
 #ifdef Q_OS_IOS
 #include <Security/Security.h>
@@ -74,257 +67,68 @@
 #include <openssl/rand.h>
 #endif
 
-// ---------------------------------------------------------------------------
-// HttpRedirectSslServer – QSslServer subclass that detects plain HTTP
-// connections and replies with a 301 redirect to https://.
-//
-// When a new connection arrives, we peek at the first byte using raw recv():
-//   0x16 = TLS ClientHello -> hand off to QSslServer for normal TLS flow
-//   anything else          -> parse HTTP request, send 301, close
-//
-// Host and path are sanitized against CRLF header injection.
-// ---------------------------------------------------------------------------
-class HttpRedirectSslServer : public QSslServer {
-public:
-    explicit HttpRedirectSslServer(int port, QObject* parent = nullptr)
-        : QSslServer(parent), m_port(port) {}
-
-    ~HttpRedirectSslServer() override {
-        // Close any file descriptors still waiting for data
-        for (auto it = m_pending.begin(); it != m_pending.end(); ++it) {
-            delete it.value().notifier;
-            delete it.value().timer;
-            closeFd(it.key());
-        }
-        m_pending.clear();
-    }
-
-protected:
-    void incomingConnection(qintptr fd) override {
-        // We can't peek yet – data may not have arrived. Use QSocketNotifier
-        // to wait asynchronously for the first byte.
-        auto* notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
-        auto* timer = new QTimer(this);
-        timer->setSingleShot(true);
-        timer->setInterval(5000);
-
-        PendingConn pc;
-        pc.notifier = notifier;
-        pc.timer = timer;
-        m_pending.insert(fd, pc);
-
-        connect(notifier, &QSocketNotifier::activated, this, [this, fd]() {
-            handleFirstByte(fd);
-        });
-
-        connect(timer, &QTimer::timeout, this, [this, fd]() {
-            qDebug() << "HttpRedirectSslServer: Timeout waiting for first byte, fd:" << fd;
-            cleanupPending(fd);
-            closeFd(fd);
-        });
-
-        timer->start();
-    }
-
-private:
-    struct PendingConn {
-        QSocketNotifier* notifier = nullptr;
-        QTimer* timer = nullptr;
-    };
-    QHash<qintptr, PendingConn> m_pending;
-    int m_port;
-
-    // Platform-appropriate socket type from qintptr
-#ifdef Q_OS_WIN
-    static SOCKET toNativeFd(qintptr fd) { return static_cast<SOCKET>(fd); }
-#else
-    static int toNativeFd(qintptr fd) { return static_cast<int>(fd); }
-#endif
-
-    void handleFirstByte(qintptr fd) {
-        auto it = m_pending.find(fd);
-        if (it == m_pending.end()) return;
-
-        // Disable notifier immediately to avoid re-entry
-        it.value().notifier->setEnabled(false);
-
-        unsigned char peek = 0;
-        auto n = ::recv(toNativeFd(fd), reinterpret_cast<char*>(&peek), 1, MSG_PEEK);
-
-        if (n <= 0) {
-            if (n < 0) {
-#ifdef Q_OS_WIN
-                qWarning() << "HttpRedirectSslServer: recv(MSG_PEEK) failed, fd:" << fd
-                           << "WSA error:" << WSAGetLastError();
-#else
-                qWarning() << "HttpRedirectSslServer: recv(MSG_PEEK) failed, fd:" << fd
-                           << "errno:" << errno << strerror(errno);
-#endif
-            }
-            cleanupPending(fd);
-            closeFd(fd);
-            return;
-        }
-
-        cleanupPending(fd);
-
-        if (peek == 0x16) {
-            // TLS ClientHello – hand off to QSslServer for normal processing
-            QSslServer::incomingConnection(fd);
-        } else {
-            // Plain HTTP – read request, send redirect, close
-            sendHttpRedirect(fd);
-        }
-    }
-
-    void sendHttpRedirect(qintptr fd) {
-        // Read whatever HTTP data is available (up to 4 KB is plenty for a request line + headers)
-        char buf[4096];
-        auto n = ::recv(toNativeFd(fd), buf, sizeof(buf) - 1, 0);
-        if (n <= 0) {
-            closeFd(fd);
-            return;
-        }
-        buf[n] = '\0';
-
-        // Parse path from "GET /path HTTP/1.x"
-        QString path = "/";
-        QByteArray request(buf, n);
-        qsizetype firstSpace = request.indexOf(' ');
-        if (firstSpace > 0) {
-            qsizetype secondSpace = request.indexOf(' ', firstSpace + 1);
-            if (secondSpace > firstSpace + 1) {
-                path = QString::fromLatin1(request.mid(firstSpace + 1, secondSpace - firstSpace - 1));
-            }
-        }
-
-        // Parse Host header
-        QString host = "localhost";
-        qsizetype hostIdx = request.indexOf("Host:");
-        if (hostIdx < 0) hostIdx = request.indexOf("host:");
-        if (hostIdx >= 0) {
-            qsizetype start = hostIdx + 5;
-            while (start < request.size() && request.at(start) == ' ') ++start;
-            qsizetype end = request.indexOf('\r', start);
-            if (end < 0) end = request.indexOf('\n', start);
-            if (end > start) {
-                host = QString::fromLatin1(request.mid(start, end - start));
-                // Strip port from host if present (we'll add our own)
-                if (host.startsWith('[')) {
-                    // IPv6 literal: [::1]:port – strip after closing bracket
-                    qsizetype closeBracket = host.indexOf(']');
-                    if (closeBracket > 0)
-                        host = host.left(closeBracket + 1);
-                } else {
-                    qsizetype colonIdx = host.lastIndexOf(':');
-                    if (colonIdx > 0) host = host.left(colonIdx);
-                }
-            }
-        }
-
-        // Sanitize host and path to prevent header injection via CRLF
-        static QRegularExpression validHost(QStringLiteral("^[a-zA-Z0-9.\\-]+$|^\\[[0-9a-fA-F:]+\\]$"));
-        if (!validHost.match(host).hasMatch())
-            host = QStringLiteral("localhost");
-        path.remove(QChar('\r'));
-        path.remove(QChar('\n'));
-
-        QString location = QString("https://%1:%2%3").arg(host).arg(m_port).arg(path);
-        QByteArray response =
-            "HTTP/1.1 301 Moved Permanently\r\n"
-            "Location: " + location.toLatin1() + "\r\n"
-            "Content-Length: 0\r\n"
-            "Connection: close\r\n"
-            "\r\n";
-
-        auto sent = ::send(toNativeFd(fd), response.constData(), response.size(), 0);
-        if (sent < 0)
-            qWarning() << "HttpRedirectSslServer: send() failed, fd:" << fd;
-        else if (sent < response.size())
-            qWarning() << "HttpRedirectSslServer: partial send" << sent << "/" << response.size() << "fd:" << fd;
-        closeFd(fd);
-    }
+// Query shot list from DB: the newest ShotListQuery::kMaxLimit shots with
+// every field, for the /shots page. Returns true on success, false on query
+// failure.
+static bool queryShotList(QSqlDatabase& db, QVariantList& result) {
+    static const ShotListQuery::Projection all = ShotListQuery::project();
+    QSqlQuery query(db);
+    if (!ShotListQuery::execute(query, all, ShotListQuery::kMaxLimit, {}))
+        return false;
+    while (query.next())
+        result.append(all.toVariantMap(query));
+    return true;
+}
 
-    void cleanupPending(qintptr fd) {
-        auto it = m_pending.find(fd);
-        if (it != m_pending.end()) {
-            delete it.value().notifier;
-            delete it.value().timer;
-            m_pending.erase(it);
-        }
-    }
+// Modification stamps for the shot pages' ETags (ShotServer::shotPageETag):
+// one cheap read of everything the page is rendered from, taken before
+// deciding whether to render it at all.
 
-    static void closeFd(qintptr fd) {
-#ifdef Q_OS_WIN
-        ::closesocket(toNativeFd(fd));
-#else
-        ::close(toNativeFd(fd));
-#endif
+// The list page: any shot added, deleted or edited (updated_at), any recipe
+// renamed, archived or removed (the list joins recipe names in).
+static bool queryShotListStamp(QSqlDatabase& db, QByteArray& stamp) {
+    QSqlQuery query(db);
+    if (!query.exec(QStringLiteral(
+            "SELECT (SELECT COUNT(*) FROM shots), (SELECT COALESCE(MAX(id), 0) FROM shots), "
+            "(SELECT COALESCE(MAX(updated_at), 0) FROM shots), "
+            "(SELECT COUNT(*) FROM recipes), (SELECT COALESCE(MAX(updated_at), 0) FROM recipes)"))
+        || !query.next()) {
+        qWarning() << "ShotServer: Shot list stamp query failed:" << query.lastError().text();
+        return false;
     }
-};
-
-// ---------------------------------------------------------------------------
+    stamp = "list";
+    for (int i = 0; i < 5; ++i)
+        stamp += '/' + QByteArray::number(query.value(i).toLongLong());
+    return true;
+}
 
-// Query shot list from DB. Returns true on success, false on query failure.
-static bool queryShotList(QSqlDatabase& db, QVariantList& result) {
+// The detail page: the shot's own updated_at, its recipe's, and its
+// equipment package's and that package's items' (the grinder, basket and
+// puck-prep names resolve through equipment_id). A shot that doesn't exist
+// stamps as such, so its "not found" page validates too.
+static bool queryShotStamp(QSqlDatabase& db, qint64 shotId, QByteArray& stamp) {
     QSqlQuery query(db);
-    // Recipe identity is joined in, matching the in-app history list
-    // (history-recipe-identity): live from `recipes` by id, never snapshotted
-    // onto the shot, so renaming a recipe relabels its whole history. LEFT so a
-    // recipe-less shot is still listed. Every column is qualified because the
-    // two tables collide on ten names — deliberately not enumerated here: an
-    // enumerated copy of that list went stale, omitted `profile_json`, and that
-    // omission is what silently emptied the MCP shots_list query.
-    if (!query.prepare(R"(
-        SELECT shots.id, shots.uuid, shots.timestamp, shots.profile_name, shots.duration_seconds,
-               shots.final_weight, shots.dose_weight, shots.bean_brand, shots.bean_type,
-               shots.enjoyment, shots.visualizer_id, shots.grinder_setting,
-               shots.temperature_override, shots.yield_override, shots.beverage_type,
-               shots.drink_tds, shots.drink_ey, shots.rpm,
-               shots.recipe_id, r.name, r.drink_type, r.archived
-        FROM shots LEFT JOIN recipes r ON r.id = shots.recipe_id
-        ORDER BY shots.timestamp DESC LIMIT 1000
-    )") || !query.exec()) {
-        qWarning() << "ShotServer: Shot list query failed:" << query.lastError().text();
+    if (!query.prepare(QStringLiteral(
+            "SELECT COALESCE(shots.updated_at, 0), COALESCE(r.updated_at, 0), "
+            "COALESCE(ep.updated_at, 0), "
+            "(SELECT COALESCE(MAX(ei.updated_at), 0) || ':' || COUNT(*) FROM equipment_items ei "
+            "WHERE ei.package_id = shots.equipment_id) "
+            "FROM shots LEFT JOIN recipes r ON r.id = shots.recipe_id "
+            "LEFT JOIN equipment_packages ep ON ep.id = shots.equipment_id WHERE shots.id = ?"))) {
+        qWarning() << "ShotServer: Shot stamp query failed:" << query.lastError().text();
         return false;
     }
-    while (query.next()) {
-        QVariantMap row;
-        row["id"] = query.value(0).toLongLong();
-        row["uuid"] = query.value(1).toString();
-        row["timestamp"] = query.value(2).toLongLong();
-        row["profileName"] = query.value(3).toString();
-        row["durationSec"] = query.value(4).toDouble();
-        row["finalWeightG"] = query.value(5).toDouble();
-        row["doseWeightG"] = query.value(6).toDouble();
-        row["beanBrand"] = query.value(7).toString();
-        row["beanType"] = query.value(8).toString();
-        // ShotProjection-ALIGNED key names. These three were `enjoyment`,
-        // `drinkTds` and `drinkEy` while ShotProjection::fromVariantMap has
-        // always read `enjoyment0to100`, `drinkTdsPct` and `drinkEyPct`, so
-        // generateShotListPage saw 0 for all three: the web card's rating chip
-        // never rendered, and the client-side `rating:`, `tds:` and `ey:`
-        // searches plus the rating sort matched nothing. Same defect class as
-        // the dateTime omission, but a key MISMATCH rather than an absence, so
-        // it survives even a "does every field appear in both functions" audit.
-        row["enjoyment0to100"] = query.value(9).toDouble();
-        row["hasVisualizerUpload"] = !query.value(10).toString().isEmpty();
-        row["grinderSetting"] = query.value(11).toString();
-        row["rpm"] = query.value(17).toLongLong();  // RPM half of the dial-in
-        row["temperatureOverrideC"] = query.value(12).toDouble();
-        row["targetWeightG"] = query.value(13).toDouble();
-        row["beverageType"] = query.value(14).toString();
-        row["drinkTdsPct"] = query.value(15).toDouble();
-        row["drinkEyPct"] = query.value(16).toDouble();
-        row["recipeId"] = query.value(18).toLongLong();
-        row["recipeName"] = query.value(19).toString();
-        row["recipeDrinkType"] = query.value(20).toString();
-        row["recipeArchived"] = query.value(21).toInt() != 0;
-        QDateTime dt = QDateTime::fromSecsSinceEpoch(query.value(2).toLongLong());
-        static const bool use12h = QLocale::system().timeFormat(QLocale::ShortFormat).contains("AP", Qt::CaseInsensitive);
-        row["dateTime"] = dt.toString(use12h ? "yyyy-MM-dd h:mm AP" : "yyyy-MM-dd HH:mm");
-        result.append(row);
+    query.bindValue(0, shotId);
+    if (!query.exec()) {
+        qWarning() << "ShotServer: Shot stamp query failed:" << query.lastError().text();
+        return false;
     }
+    stamp = "shot/" + QByteArray::number(shotId);
+    if (query.next())
+        stamp += '/' + QByteArray::number(query.value(0).toLongLong()) + '/' + QByteArray::number(query.value(1).toLongLong())
+                 + '/' + QByteArray::number(query.value(2).toLongLong()) + '/' + query.value(3).toString().toLatin1();
+    else
+        stamp += "/none";
     return true;
 }
 
@@ -339,6 +143,12 @@ ShotServer::ShotServer(ShotHistoryStorage* storage, DE1Device* device, QObject*
     m_cleanupTimer = new QTimer(this);
     m_cleanupTimer->setInterval(30000);  // Check every 30 seconds
     connect(m_cleanupTimer, &QTimer::timeout, this, &ShotServer::onCleanupTimerTick);
+
+    if (m_storage) {
+        connect(m_storage, &ShotHistoryStorage::historyDataChanged, this, [this]() {
+            ++m_historyGeneration;
+        });
+    }
 }
 
 ShotServer::~ShotServer()
@@ -392,6 +202,8 @@ void ShotServer::retireSocket(QTcpSocket* socket)
     m_sseLayoutClients.remove(socket);
     m_sseThemeClients.remove(socket);
     m_uploadProgressLog.remove(socket);
+    m_acceptedCoding.remove(socket);
+    m_streamingClients.remove(socket);
 
     // The timer is a child of `socket` and dies with it; stopping it here keeps
     // its lambda from firing in the window before deleteLater() runs. Taking it
@@ -480,74 +292,46 @@ void ShotServer::setPort(int port)
 
 bool ShotServer::start()
 {
-    if (m_server) {
+    if (m_network) {
         stop();
     }
 
+    // The listener, TLS and all socket I/O run on m_network's own thread;
+    // what reaches onNewConnection is a main-thread stand-in for each client
+    // (see httpserverthread.h).
+    m_network = new HttpServerThread(this);
+    connect(m_network, &HttpServerThread::newConnection, this, &ShotServer::onNewConnection);
+    connect(m_network, &HttpServerThread::healthChecked, this, &ShotServer::onHealthChecked);
+
     if (isSecurityEnabled()) {
         // Set up TLS with self-signed certificate
         if (!setupTls()) {
             qWarning() << "ShotServer: TLS setup failed, cannot start secure server";
+            delete m_network;
+            m_network = nullptr;
             return false;
-        } else {
-            auto* sslServer = new HttpRedirectSslServer(m_port, this);
-            QSslConfiguration sslConfig;
-            sslConfig.setLocalCertificate(m_sslCert);
-            sslConfig.setPrivateKey(m_sslKey);
-            sslConfig.setPeerVerifyMode(QSslSocket::VerifyNone);
-            sslServer->setSslConfiguration(sslConfig);
-            m_server = sslServer;
-            // Use pendingConnectionAvailable (not newConnection) for QSslServer:
-            // newConnection fires on TCP accept (before SSL handshake), when hasPendingConnections() is still false.
-            // pendingConnectionAvailable fires after handshake completes and socket is added to the pending queue.
-            connect(m_server, &QTcpServer::pendingConnectionAvailable, this, &ShotServer::onNewConnection);
-            connect(m_server, &QTcpServer::acceptError, this, [this](QAbstractSocket::SocketError err) {
-                qWarning() << "ShotServer: accept error:" << err
-                           << "socketDescriptor:" << m_server->socketDescriptor()
-                           << "isListening:" << m_server->isListening();
-            });
-            connect(sslServer, &QSslServer::sslErrors, this, [](QSslSocket* /*socket*/, const QList<QSslError>& errors) {
-                for (const auto& err : errors)
-                    qWarning() << "ShotServer: SSL error:" << err.errorString();
-            });
-            connect(sslServer, &QSslServer::handshakeInterruptedOnError, this, [](QSslSocket* /*socket*/, const QSslError& error) {
-                qWarning() << "ShotServer: SSL handshake interrupted:" << error.errorString();
-            });
-            connect(sslServer, &QSslServer::peerVerifyError, this, [](QSslSocket* /*socket*/, const QSslError& error) {
-                qWarning() << "ShotServer: SSL peer verify error:" << error.errorString();
-            });
-
-
-            if (!m_server->listen(QHostAddress::Any, m_port)) {
-                qWarning() << "ShotServer: Failed to start TLS on port" << m_port << m_server->errorString();
-                delete m_server;
-                m_server = nullptr;
-                return false;
-            }
-
-            // Load persisted sessions
-            loadSessions();
-
-            qDebug() << "ShotServer: HTTPS mode enabled";
         }
-    }
-
-    if (!m_server) {
-        // Plain HTTP mode (security disabled)
-        m_server = new QTcpServer(this);
-        connect(m_server, &QTcpServer::newConnection, this, &ShotServer::onNewConnection);
-        connect(m_server, &QTcpServer::acceptError, this, [this](QAbstractSocket::SocketError err) {
-            qWarning() << "ShotServer: accept error:" << err
-                       << "socketDescriptor:" << m_server->socketDescriptor()
-                       << "isListening:" << m_server->isListening();
-        });
-
-        if (!m_server->listen(QHostAddress::Any, m_port)) {
-            qWarning() << "ShotServer: Failed to start on port" << m_port << m_server->errorString();
-            delete m_server;
-            m_server = nullptr;
+        QSslConfiguration sslConfig;
+        sslConfig.setLocalCertificate(m_sslCert);
+        sslConfig.setPrivateKey(m_sslKey);
+        sslConfig.setPeerVerifyMode(QSslSocket::VerifyNone);
+        if (!m_network->listenTls(QHostAddress::Any, m_port, sslConfig)) {
+            qWarning() << "ShotServer: Failed to start TLS on port" << m_port << m_network->errorString();
+            delete m_network;
+            m_network = nullptr;
             return false;
         }
+
+        // Load persisted sessions
+        loadSessions();
+
+        qDebug() << "ShotServer: HTTPS mode enabled";
+    } else if (!m_network->listen(QHostAddress::Any, m_port)) {
+        // Plain HTTP mode (security disabled)
+        qWarning() << "ShotServer: Failed to start on port" << m_port << m_network->errorString();
+        delete m_network;
+        m_network = nullptr;
+        return false;
     }
 
     // Start UDP discovery socket
@@ -590,7 +374,7 @@ void ShotServer::stop()
     }
     m_multicastLock.reset();
 
-    if (m_server) {
+    if (m_network) {
         m_cleanupTimer->stop();
         // Stop all keep-alive timers BEFORE closing any sockets. This ensures
         // every timer pointer is still valid (sockets haven't been destroyed yet).
@@ -619,86 +403,83 @@ void ShotServer::stop()
         m_sseThemeClients.clear();
         m_pendingRequests.clear();
         m_clients.clear();
-        m_server->close();
-        delete m_server;
-        m_server = nullptr;
+        // Closes the listening socket and whatever connections are left, and
+        // joins the network thread, before returning.
+        delete m_network;
+        m_network = nullptr;
         emit runningChanged();
         emit urlChanged();
         qDebug() << "ShotServer: Stopped";
     }
 }
 
-void ShotServer::onNewConnection()
+void ShotServer::onNewConnection(QTcpSocket* socket)
 {
-    while (m_server->hasPendingConnections()) {
-        QTcpSocket* socket = m_server->nextPendingConnection();
-
-        // Fail closed above the ceiling. Dropping the newest arrival keeps the
-        // clients already being served, which is the opposite of what running
-        // out of descriptors does — that takes down BLE, the database and
-        // everything else in the process along with the web server.
-        if (m_clients.size() >= MAX_CONNECTIONS) {
-            // Answer, don't just hang up. A bare close reaches the browser as
-            // ERR_EMPTY_RESPONSE, which is byte-identical to the app being dead,
-            // the wrong port, or a bad certificate — and whoever hits this is far
-            // more likely to be the owner on their phone than anything hostile.
-            //
-            // Written straight to the socket rather than through sendResponse():
-            // that arms a keep-alive timer keyed on the socket, and this socket
-            // is deliberately never wired to onDisconnected, so the entry would
-            // outlive it. flush() normally pushes a body this small straight into
-            // the kernel buffer, leaving close() nothing to drain — a peer that
-            // never reads and has a full receive window instead gets a truncated
-            // 503, which is an acceptable answer to give a client that is not
-            // listening.
-            const QByteArray body =
-                "Decenza is already serving its maximum number of connections. "
-                "Close other tabs or devices and try again in a moment.\n";
-            socket->write("HTTP/1.1 503 Service Unavailable\r\n"
-                          "Content-Type: text/plain\r\n"
-                          "Retry-After: 5\r\n"
-                          "Connection: close\r\n"
-                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
-                          "\r\n" + body);
-            socket->flush();
-            socket->close();
-            socket->deleteLater();
-
-            // Log the TRANSITION, not the event. One warning per refusal is one
-            // warning per SYN on a path an attacker controls, and the debug log
-            // is a bounded ring buffer that crash reports carry — flooding it
-            // would evict the fd-pressure evidence this same change adds, which
-            // is the diagnostic losing to the denial of service in the one
-            // buffer they share.
-            ++m_refusedConnections;
-            if (!m_atConnectionLimit) {
-                m_atConnectionLimit = true;
-                qWarning() << "ShotServer: connection limit reached ("
-                           << MAX_CONNECTIONS << ") — refusing new clients, most recent from"
-                           << socket->peerAddress().toString();
-            }
-            continue;
+    // Fail closed above the ceiling. Dropping the newest arrival keeps the
+    // clients already being served, which is the opposite of what running
+    // out of descriptors does — that takes down BLE, the database and
+    // everything else in the process along with the web server.
+    if (m_clients.size() >= MAX_CONNECTIONS) {
+        // Answer, don't just hang up. A bare close reaches the browser as
+        // ERR_EMPTY_RESPONSE, which is byte-identical to the app being dead,
+        // the wrong port, or a bad certificate — and whoever hits this is far
+        // more likely to be the owner on their phone than anything hostile.
+        //
+        // Written straight to the socket rather than through sendResponse():
+        // that arms a keep-alive timer keyed on the socket, and this socket
+        // is deliberately never wired to onDisconnected, so the entry would
+        // outlive it. close() leaves the network thread to send the reply and
+        // then hang up; a body this small fits the kernel buffer — a peer that
+        // never reads and has a full receive window instead gets a truncated
+        // 503, which is an acceptable answer to give a client that is not
+        // listening.
+        const QByteArray body =
+            "Decenza is already serving its maximum number of connections. "
+            "Close other tabs or devices and try again in a moment.\n";
+        socket->write("HTTP/1.1 503 Service Unavailable\r\n"
+                      "Content-Type: text/plain\r\n"
+                      "Retry-After: 5\r\n"
+                      "Connection: close\r\n"
+                      "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                      "\r\n" + body);
+        socket->flush();
+        socket->close();
+        socket->deleteLater();
+
+        // Log the TRANSITION, not the event. One warning per refusal is one
+        // warning per SYN on a path an attacker controls, and the debug log
+        // is a bounded ring buffer that crash reports carry — flooding it
+        // would evict the fd-pressure evidence this same change adds, which
+        // is the diagnostic losing to the denial of service in the one
+        // buffer they share.
+        ++m_refusedConnections;
+        if (!m_atConnectionLimit) {
+            m_atConnectionLimit = true;
+            qWarning() << "ShotServer: connection limit reached ("
+                       << MAX_CONNECTIONS << ") — refusing new clients, most recent from"
+                       << socket->peerAddress().toString();
         }
-        m_clients.insert(socket);
-
-        connect(socket, &QTcpSocket::readyRead, this, &ShotServer::onReadyRead);
-        connect(socket, &QTcpSocket::disconnected, this, &ShotServer::onDisconnected);
-        // Start the idle clock HERE, not at the first readyRead. A peer that
-        // connects and then sends nothing was previously tracked nowhere: no
-        // m_pendingRequests entry (created on first read), no keep-alive timer
-        // (created when a response is sent), not in either SSE set — so
-        // onCleanupTimerTick's stale sweep could not see it and the descriptor
-        // was held until the peer closed, which a vanished peer never does. On a
-        // LAN where this server advertises itself over mDNS that is a steady
-        // trickle (scanners, browser pre-connects, discovery agents), and the fd
-        // count only goes up. Registering at accept puts such a socket under
-        // SILENT_TIMEOUT_MS — 30 s, not the 5-minute CONNECTION_TIMEOUT_MS, which
-        // is reserved for sockets with a request actually in flight (see the
-        // two-deadline check in onCleanupTimerTick). onReadyRead reuses this
-        // same entry.
-        m_pendingRequests[socket].lastActivity.start();
-        emit clientConnected(socket->peerAddress().toString());
+        return;
     }
+    m_clients.insert(socket);
+
+    connect(socket, &QTcpSocket::readyRead, this, &ShotServer::onReadyRead);
+    connect(socket, &QTcpSocket::disconnected, this, &ShotServer::onDisconnected);
+    // Start the idle clock HERE, not at the first readyRead. A peer that
+    // connects and then sends nothing was previously tracked nowhere: no
+    // m_pendingRequests entry (created on first read), no keep-alive timer
+    // (created when a response is sent), not in either SSE set — so
+    // onCleanupTimerTick's stale sweep could not see it and the descriptor
+    // was held until the peer closed, which a vanished peer never does. On a
+    // LAN where this server advertises itself over mDNS that is a steady
+    // trickle (scanners, browser pre-connects, discovery agents), and the fd
+    // count only goes up. Registering at accept puts such a socket under
+    // SILENT_TIMEOUT_MS — 30 s, not the 5-minute CONNECTION_TIMEOUT_MS, which
+    // is reserved for sockets with a request actually in flight (see the
+    // two-deadline check in onCleanupTimerTick). onReadyRead reuses this
+    // same entry.
+    m_pendingRequests[socket].lastActivity.start();
+    emit clientConnected(socket->peerAddress().toString());
 }
 
 void ShotServer::onReadyRead()
@@ -718,6 +499,9 @@ void ShotServer::onReadyRead()
     if (m_sseLayoutClients.contains(socket)) return;
     if (m_sseThemeClients.contains(socket)) return;
     if (m_mcpServer && m_mcpServer->isSseClient(socket)) return;
+    // Likewise a socket mid-stream: its response closes the connection, and
+    // answering a pipelined request now would land inside the body.
+    if (m_streamingClients.contains(socket)) return;
 
     // Stop keep-alive idle timer while processing incoming request data
     if (QTimer* t = m_keepAliveTimers.value(socket))
@@ -746,220 +530,217 @@ void ShotServer::onReadyRead()
     }
 
     try {
-        PendingRequest& pending = m_pendingRequests[socket];
-        pending.lastActivity.start();
-
-        // Read available data
-        QByteArray chunk = socket->readAll();
-
-        // If we haven't found headers yet, accumulate header data
-        if (pending.headerEnd < 0) {
-            pending.headerData.append(chunk);
-
-            // Check header size limit
-            if (pending.headerData.size() > MAX_HEADER_SIZE) {
-                qWarning() << "ShotServer: Headers too large, rejecting";
-                sendResponse(socket, 413, "text/plain", "Headers too large");
-                cleanupPendingRequest(socket);
-                m_pendingRequests.remove(socket);
-                socket->close();
-                return;
-            }
-
-            pending.headerEnd = static_cast<int>(pending.headerData.indexOf("\r\n\r\n"));
-            if (pending.headerEnd < 0) {
-                // Headers not complete yet
-                return;
-            }
-
-            // Parse headers
-            QString headers = QString::fromUtf8(pending.headerData.left(pending.headerEnd));
-            QStringList lines = headers.split("\r\n");
-            QString requestLine = lines.isEmpty() ? "" : lines.first();
+        processIncoming(socket, socket->readAll());
+    } catch (const std::exception& e) {
+        qWarning() << "ShotServer: Exception in onReadyRead:" << e.what();
+        m_uploadProgressLog.remove(socket);
+        cleanupPendingRequest(socket);
+        m_pendingRequests.remove(socket);
+        socket->close();
+    } catch (...) {
+        qWarning() << "ShotServer: Unknown exception in onReadyRead";
+        m_uploadProgressLog.remove(socket);
+        cleanupPendingRequest(socket);
+        m_pendingRequests.remove(socket);
+        socket->close();
+    }
+}
 
-            // Parse Content-Length
-            for (const QString& line : std::as_const(lines)) {
-                if (line.startsWith("Content-Length:", Qt::CaseInsensitive)) {
-                    pending.contentLength = line.mid(15).trimmed().toLongLong();
-                    break;
+void ShotServer::processIncoming(QTcpSocket* socket, const QByteArray& data)
+{
+    PendingRequest& pending = m_pendingRequests[socket];
+    pending.lastActivity.start();
+    HttpRequestParser& parser = pending.parser;
+    parser.append(data);
+
+    for (;;) {
+        switch (parser.parse()) {
+        case HttpRequestParser::Status::NeedMore:
+            // Log progress for large uploads
+            if (parser.contentLength() > 5 * 1024 * 1024) {
+                qint64& last = m_uploadProgressLog[socket];
+                if (parser.bodyReceived() - last > 5 * 1024 * 1024) {
+                    qDebug() << "Upload progress:" << parser.bodyReceived() / (1024*1024) << "MB /" << parser.contentLength() / (1024*1024) << "MB";
+                    last = parser.bodyReceived();
                 }
             }
-
-            if (pending.contentLength < 0) {
-                pending.contentLength = 0;
-            }
-
-            // Check if this is a media upload (POST to /upload/media)
-            pending.isMediaUpload = requestLine.contains("POST") && requestLine.contains("/upload/media");
-            pending.isBackupRestore = requestLine.contains("POST") && requestLine.contains("/api/backup/restore");
-            // APK upload: POST /upload (not /upload/anything-else)
-            pending.isApkUpload = requestLine.contains("POST") &&
-                                  requestLine.contains("/upload") &&
-                                  !requestLine.contains("/upload/");
-
-            // Check upload size limit for media and APK uploads
-            if ((pending.isMediaUpload || pending.isBackupRestore || pending.isApkUpload) && pending.contentLength > MAX_UPLOAD_SIZE) {
-                qWarning() << "ShotServer: Upload too large:" << pending.contentLength << "bytes (max:" << MAX_UPLOAD_SIZE << ")";
-                sendResponse(socket, 413, "text/plain",
-                    QString("File too large. Maximum size is %1 MB").arg(MAX_UPLOAD_SIZE / (1024*1024)).toUtf8());
-                cleanupPendingRequest(socket);
-                m_pendingRequests.remove(socket);
-                socket->close();
+            return;
+        case HttpRequestParser::Status::Error:
+            qWarning() << "ShotServer: Rejecting request:" << parser.errorString();
+            sendResponse(socket, parser.errorStatus(), "text/plain", parser.errorString().toUtf8());
+            cleanupPendingRequest(socket);
+            m_pendingRequests.remove(socket);
+            socket->close();
+            return;
+        case HttpRequestParser::Status::HeadComplete:
+            if (!beginRequestBody(socket, pending))
                 return;
-            }
+            continue;
+        case HttpRequestParser::Status::Complete:
+            // One request per pass: the handler may respond later, retire the
+            // socket, or turn it into an SSE stream. A pipelined request
+            // already buffered behind it is picked up by a queued pass, after
+            // this one has unwound, and only if the socket is still a plain
+            // request/response connection by then.
+            completeRequest(socket, pending);
+            return;
+        }
+    }
+}
 
-            // Check concurrent upload limit
-            if ((pending.isMediaUpload || pending.isBackupRestore || pending.isApkUpload) && m_activeMediaUploads >= MAX_CONCURRENT_UPLOADS) {
-                qWarning() << "ShotServer: Too many concurrent uploads";
-                sendResponse(socket, 503, "text/plain", "Server busy. Please wait and try again.");
-                cleanupPendingRequest(socket);
-                m_pendingRequests.remove(socket);
-                socket->close();
-                return;
-            }
+bool ShotServer::beginRequestBody(QTcpSocket* socket, PendingRequest& pending)
+{
+    HttpRequestParser& parser = pending.parser;
+    const HttpRequest& request = parser.request();
+    const bool isPost = request.method() == "POST";
+    QByteArrayView path = request.target();
+    if (const qsizetype query = path.indexOf('?'); query >= 0)
+        path = path.first(query);
+
+    // Check if this is a media upload (POST to /upload/media)
+    pending.isMediaUpload = isPost && path == "/upload/media";
+    pending.isBackupRestore = isPost && path == "/api/backup/restore";
+    // APK upload: POST /upload (not /upload/anything-else)
+    pending.isApkUpload = isPost && path == "/upload";
+    const bool isUpload = pending.isMediaUpload || pending.isBackupRestore || pending.isApkUpload;
+
+    auto refuse = [this, socket](int statusCode, const QByteArray& message) {
+        sendResponse(socket, statusCode, "text/plain", message);
+        cleanupPendingRequest(socket);
+        m_pendingRequests.remove(socket);
+        socket->close();
+        return false;
+    };
 
-            // For large uploads (> 1MB) and all APK uploads, stream to temp file instead of memory
-            if (pending.contentLength > MAX_SMALL_BODY_SIZE || pending.isApkUpload) {
-                QString tempDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
-                pending.tempFilePath = tempDir + "/upload_stream_" + QString::number(QDateTime::currentMSecsSinceEpoch()) + ".tmp";
-                pending.tempFile = new QFile(pending.tempFilePath);
-                if (!pending.tempFile->open(QIODevice::WriteOnly)) {
-                    qWarning() << "ShotServer: Failed to create temp file for streaming";
-                    sendResponse(socket, 500, "text/plain", "Server error: cannot create temp file");
-                    cleanupPendingRequest(socket);
-                    m_pendingRequests.remove(socket);
-                    socket->close();
-                    return;
-                }
-                if (pending.isMediaUpload || pending.isBackupRestore || pending.isApkUpload) {
-                    m_activeMediaUploads++;
-                }
-                qDebug() << "ShotServer: Streaming large upload to" << pending.tempFilePath;
-            }
+    // Check upload size limit for media and APK uploads. A chunked upload
+    // has no declared length; the parser enforces the same limit as it reads.
+    if (isUpload && parser.contentLength() > MAX_UPLOAD_SIZE) {
+        qWarning() << "ShotServer: Upload too large:" << parser.contentLength() << "bytes (max:" << MAX_UPLOAD_SIZE << ")";
+        return refuse(413, QString("File too large. Maximum size is %1 MB").arg(MAX_UPLOAD_SIZE / (1024*1024)).toUtf8());
+    }
 
-            // Handle any body data that came with headers
-            int bodyStart = pending.headerEnd + 4;
-            if (bodyStart < pending.headerData.size()) {
-                QByteArray bodyPart = pending.headerData.mid(bodyStart);
-                if (pending.tempFile) {
-                    // Write body to temp file and truncate headerData to just headers
-                    pending.tempFile->write(bodyPart);
-                    pending.headerData.truncate(pending.headerEnd);
-                }
-                // For small requests without temp file, keep everything in headerData
-                pending.bodyReceived = bodyPart.size();
-            }
+    // Check concurrent upload limit
+    if (isUpload && m_activeMediaUploads >= MAX_CONCURRENT_UPLOADS) {
+        qWarning() << "ShotServer: Too many concurrent uploads";
+        return refuse(503, "Server busy. Please wait and try again.");
+    }
 
-            chunk.clear();  // Already processed
-        } else {
-            // Headers already received, this is body data
-            if (pending.tempFile) {
-                // Stream to temp file
-                pending.tempFile->write(chunk);
-            } else {
-                // Append to header buffer (for small requests)
-                pending.headerData.append(chunk);
-            }
-            pending.bodyReceived += chunk.size();
-        }
+    // For large uploads (> 1MB), chunked uploads and all APK uploads, stream
+    // to temp file instead of memory. Anything else is read into memory, up
+    // to MAX_SMALL_BODY_SIZE.
+    const bool streamToFile = parser.contentLength() > MAX_SMALL_BODY_SIZE || pending.isApkUpload
+                              || (isUpload && parser.isChunked());
+    if (!streamToFile) {
+        parser.setMaxBodySize(MAX_SMALL_BODY_SIZE);
+        return true;
+    }
 
-        // Log progress for large uploads
-        if (pending.contentLength > 5 * 1024 * 1024) {
-            qint64& last = m_uploadProgressLog[socket];
-            if (pending.bodyReceived - last > 5 * 1024 * 1024) {
-                qDebug() << "Upload progress:" << pending.bodyReceived / (1024*1024) << "MB /" << pending.contentLength / (1024*1024) << "MB";
-                last = pending.bodyReceived;
-            }
-        }
+    QString tempDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
+    pending.tempFilePath = tempDir + "/upload_stream_" + QString::number(QDateTime::currentMSecsSinceEpoch()) + ".tmp";
+    pending.tempFile = new QFile(pending.tempFilePath);
+    if (!pending.tempFile->open(QIODevice::WriteOnly)) {
+        qWarning() << "ShotServer: Failed to create temp file for streaming";
+        return refuse(500, "Server error: cannot create temp file");
+    }
+    if (isUpload) {
+        m_activeMediaUploads++;
+    }
+    parser.setBodySink(pending.tempFile);
+    parser.setMaxBodySize(MAX_UPLOAD_SIZE);
+    qDebug() << "ShotServer: Streaming large upload to" << pending.tempFilePath;
+    return true;
+}
 
-        // Check if we have all the body data
-        if (pending.bodyReceived < pending.contentLength) {
-            return;  // Still waiting for more data
-        }
+void ShotServer::completeRequest(QTcpSocket* socket, PendingRequest& pending)
+{
+    // Clean up upload progress tracking for this socket
+    m_uploadProgressLog.remove(socket);
 
-        // Clean up upload progress tracking for this socket
-        m_uploadProgressLog.remove(socket);
+    HttpRequest request = pending.parser.takeRequest();
+    const bool pipelined = pending.parser.bufferedSize() > 0;
 
-        // Request complete
-        if (pending.tempFile) {
-            // Use the QFile's write position instead of QFileInfo::size() — pos()
-            // is a pure in-memory read, avoiding a main-thread stat/fstat syscall
-            // (CLAUDE.md "Never run disk I/O on the main thread").
-            const qint64 tempFileSize = pending.tempFile->pos();
-            pending.tempFile->close();
-            qDebug() << "ShotServer: Upload complete, temp file:" << pending.tempFilePath
-                     << "size:" << tempFileSize << "bytes";
-        }
-
-        // Handle the request
-        if ((pending.isMediaUpload || pending.isBackupRestore || pending.isApkUpload) && pending.tempFile) {
-            // Large upload with streamed body - pass temp file path
-            QString headers = QString::fromUtf8(pending.headerData);
-            QString tempPath = pending.tempFilePath;
-            bool wasBackupRestore = pending.isBackupRestore;
-            bool wasApkUpload = pending.isApkUpload;
-            delete pending.tempFile;
-            pending.tempFile = nullptr;
-            pending.tempFilePath.clear();
-            m_activeMediaUploads--;
-            m_pendingRequests.remove(socket);
-            if (wasBackupRestore) {
-                handleBackupRestore(socket, tempPath, headers);
-            } else if (wasApkUpload) {
-                handleUploadFromFile(socket, tempPath, headers);
-            } else {
-                handleMediaUpload(socket, tempPath, headers);
-            }
-        } else if (pending.tempFilePath.isEmpty()) {
-            // Small request or non-media — headerData contains the full
-            // request (headers + \r\n\r\n + body), nothing on disk.
-            QByteArray request = pending.headerData;
-            cleanupPendingRequest(socket);
-            m_pendingRequests.remove(socket);
-            handleRequest(socket, request);
-        } else {
-            // Large non-media request that was streamed to a temp file.
-            // Reconstruct on a background thread to keep main-thread disk I/O
-            // off the event loop (CLAUDE.md: "Never run disk I/O on the main
-            // thread"). We take ownership of the temp file removal here so we
-            // clear pending.tempFilePath before cleanupPendingRequest to stop
-            // it from queueing its own remove.
-            QByteArray headerData = pending.headerData;
-            QString tempPath = pending.tempFilePath;
-            pending.tempFilePath.clear();
-            cleanupPendingRequest(socket);
+    if (pending.tempFile) {
+        // Use the QFile's write position instead of QFileInfo::size() — pos()
+        // is a pure in-memory read, avoiding a main-thread stat/fstat syscall
+        // (CLAUDE.md "Never run disk I/O on the main thread").
+        const qint64 tempFileSize = pending.tempFile->pos();
+        pending.tempFile->close();
+        qDebug() << "ShotServer: Upload complete, temp file:" << pending.tempFilePath
+                 << "size:" << tempFileSize << "bytes";
+    }
+
+    // Done with this request's entry. It normally goes (an idle keep-alive
+    // socket has none); when the start of the next request is already
+    // buffered, the entry — and the parser holding those bytes — stays.
+    auto release = [this, socket, pipelined](PendingRequest& p) {
+        if (!pipelined) {
             m_pendingRequests.remove(socket);
-            QPointer<QTcpSocket> safeSocket = socket;
-            QPointer<ShotServer> safeThis = this;
-            QThread* t = QThread::create([safeThis, safeSocket, headerData, tempPath]() {
-                QByteArray request = headerData + "\r\n\r\n";
-                QFile f(tempPath);
-                if (f.open(QIODevice::ReadOnly)) {
-                    request.append(f.readAll());
-                    f.close();
-                }
-                QFile::remove(tempPath);
-                QMetaObject::invokeMethod(safeThis, [safeThis, safeSocket, request]() {
-                    if (safeThis && safeSocket)
-                        safeThis->handleRequest(safeSocket, request);
-                }, Qt::QueuedConnection);
-            });
-            connect(t, &QThread::finished, t, &QThread::deleteLater);
-            t->start();
+            return;
         }
+        p.tempFile = nullptr;
+        p.tempFilePath.clear();
+        p.isMediaUpload = p.isBackupRestore = p.isApkUpload = false;
+    };
 
-    } catch (const std::exception& e) {
-        qWarning() << "ShotServer: Exception in onReadyRead:" << e.what();
-        m_uploadProgressLog.remove(socket);
-        cleanupPendingRequest(socket);
-        m_pendingRequests.remove(socket);
-        socket->close();
-    } catch (...) {
-        qWarning() << "ShotServer: Unknown exception in onReadyRead";
-        m_uploadProgressLog.remove(socket);
+    // Handle the request
+    if ((pending.isMediaUpload || pending.isBackupRestore || pending.isApkUpload) && pending.tempFile) {
+        // Large upload with streamed body - pass temp file path
+        QString tempPath = pending.tempFilePath;
+        bool wasBackupRestore = pending.isBackupRestore;
+        bool wasApkUpload = pending.isApkUpload;
+        delete pending.tempFile;
+        pending.tempFile = nullptr;
+        m_activeMediaUploads--;
+        release(pending);
+        if (wasBackupRestore) {
+            handleBackupRestore(socket, tempPath);
+        } else if (wasApkUpload) {
+            handleUploadFromFile(socket, tempPath, request);
+        } else {
+            handleMediaUpload(socket, tempPath, request);
+        }
+    } else if (pending.tempFilePath.isEmpty()) {
+        // Small request — the body is in memory, nothing on disk.
+        release(pending);
+        handleRequest(socket, request);
+    } else {
+        // Large non-media request that was streamed to a temp file.
+        // Read it back on a background thread to keep main-thread disk I/O
+        // off the event loop (CLAUDE.md: "Never run disk I/O on the main
+        // thread"). We take ownership of the temp file removal here so we
+        // clear pending.tempFilePath before cleanupPendingRequest to stop
+        // it from queueing its own remove.
+        QString tempPath = pending.tempFilePath;
+        pending.tempFilePath.clear();
         cleanupPendingRequest(socket);
-        m_pendingRequests.remove(socket);
-        socket->close();
+        release(pending);
+        QPointer<QTcpSocket> safeSocket = socket;
+        QPointer<ShotServer> safeThis = this;
+        TaskExecutor::instance().submit(TaskLane::Interactive, [safeThis, safeSocket, request, tempPath]() mutable {
+            QFile f(tempPath);
+            if (f.open(QIODevice::ReadOnly)) {
+                request.setBody(f.readAll());
+                f.close();
+            }
+            QFile::remove(tempPath);
+            QMetaObject::invokeMethod(safeThis, [safeThis, safeSocket, request]() {
+                if (safeThis && safeSocket)
+                    safeThis->handleRequest(safeSocket, request);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    if (pipelined) {
+        QPointer<QTcpSocket> safeSocket = socket;
+        QMetaObject::invokeMethod(this, [this, safeSocket]() {
+            if (!safeSocket || !m_pendingRequests.contains(safeSocket)
+                || safeSocket->state() != QAbstractSocket::ConnectedState)
+                return;
+            if (m_sseLayoutClients.contains(safeSocket) || m_sseThemeClients.contains(safeSocket)
+                || (m_mcpServer && m_mcpServer->isSseClient(safeSocket)))
+                return;
+            processIncoming(safeSocket, QByteArray());
+        }, Qt::QueuedConnection);
     }
 }
 
@@ -1017,12 +798,10 @@ void ShotServer::cleanupPendingRequest(QTcpSocket* socket)
     }
     if (!pending.tempFilePath.isEmpty()) {
         QString tmpPath = pending.tempFilePath;
-        QThread* cleanup = QThread::create([tmpPath]() {
+        TaskExecutor::instance().submit(TaskLane::Background, [tmpPath]() {
             if (QFile::remove(tmpPath))
                 qDebug() << "ShotServer: Cleaned up temp file:" << tmpPath;
         });
-        connect(cleanup, &QThread::finished, cleanup, &QThread::deleteLater);
-        cleanup->start();
     }
     // Only decrement if this upload was actually counted. An upload is counted
     // (m_activeMediaUploads++) when it streams to a temp file. APK uploads always
@@ -1034,24 +813,28 @@ void ShotServer::cleanupPendingRequest(QTcpSocket* socket)
     }
 }
 
+void ShotServer::onHealthChecked(qintptr fd, bool listening)
+{
+    if (fd == -1 && listening) {
+        // The bug we're hunting — always log this when it happens, no
+        // de-dup, so consecutive ticks paint a clear timeline.
+        qWarning() << "ShotServer: socketDescriptor() == -1 while isListening() == true — listen socket may have been invalidated by OS";
+    } else if (fd != m_lastHealthFd || listening != m_lastHealthListening) {
+        // Only log when state changes (incl. the first tick after startup).
+        // Steady-state was burning ~120 lines/hr without surfacing any new
+        // signal; a flip in either field is the actual breadcrumb.
+        qDebug() << "ShotServer: health check — isListening:" << listening << "socketDescriptor:" << fd;
+    }
+    m_lastHealthFd = fd;
+    m_lastHealthListening = listening;
+}
+
 void ShotServer::onCleanupTimerTick()
 {
-    if (m_server) {
-        qintptr fd = m_server->socketDescriptor();
-        bool listening = m_server->isListening();
-        if (fd == -1 && listening) {
-            // The bug we're hunting — always log this when it happens, no
-            // de-dup, so consecutive ticks paint a clear timeline.
-            qWarning() << "ShotServer: socketDescriptor() == -1 while isListening() == true — listen socket may have been invalidated by OS";
-        } else if (fd != m_lastHealthFd || listening != m_lastHealthListening) {
-            // Only log when state changes (incl. the first tick after startup).
-            // Steady-state was burning ~120 lines/hr without surfacing any new
-            // signal; a flip in either field is the actual breadcrumb.
-            qDebug() << "ShotServer: health check — isListening:" << listening << "socketDescriptor:" << fd;
-        }
-        m_lastHealthFd = fd;
-        m_lastHealthListening = listening;
-    }
+    // The listening socket lives on the network thread; it samples itself and
+    // answers with healthChecked().
+    if (m_network)
+        m_network->checkHealth();
 
     QList<QTcpSocket*> staleConnections;
     for (auto it = m_pendingRequests.begin(); it != m_pendingRequests.end(); ++it) {
@@ -1063,7 +846,7 @@ void ShotServer::onCleanupTimerTick()
         // server for five minutes, and the wedge is what every real user then
         // meets as a 503. A client with a request in flight keeps the long
         // deadline it needs.
-        const bool sentNothing = it.value().headerData.isEmpty() && it.value().headerEnd < 0;
+        const bool sentNothing = it.value().parser.isIdle();
         const int deadline = sentNothing ? SILENT_TIMEOUT_MS : CONNECTION_TIMEOUT_MS;
         if (it.value().lastActivity.elapsed() > deadline)
             staleConnections.append(it.key());
@@ -1141,23 +924,13 @@ void ShotServer::onDiscoveryDatagram()
     }
 }
 
-void ShotServer::handleRequest(QTcpSocket* socket, const QByteArray& request)
+void ShotServer::handleRequest(QTcpSocket* socket, const HttpRequest& request)
 {
-    QString requestStr = QString::fromUtf8(request);
-    QStringList lines = requestStr.split("\r\n");
-    if (lines.isEmpty()) {
-        socket->close();
-        return;
-    }
-
-    QStringList requestLine = lines.first().split(" ");
-    if (requestLine.size() < 2) {
-        socket->close();
-        return;
-    }
-
-    QString method = requestLine[0];
-    QString path = requestLine[1];
+    // The parser has already validated the request line and split the
+    // headers; routing works on the method and target as strings.
+    const QString method = QString::fromLatin1(request.method());
+    const QString path = QString::fromUtf8(request.target());
+    m_acceptedCoding[socket] = HttpContentCoding::negotiate(request.header("Accept-Encoding"));
 
     // Two tiers, because "too noisy" covers two different things.
     //
@@ -1189,13 +962,7 @@ void ShotServer::handleRequest(QTcpSocket* socket, const QByteArray& request)
 
         // MCP routes can authenticate via API key (Bearer token) instead of TOTP
         if (!exempt && (path == "/mcp" || path.startsWith("/mcp/")) && m_settings) {
-            QString authHeader;
-            for (const auto& line : requestStr.split("\r\n")) {
-                if (line.startsWith("Authorization:", Qt::CaseInsensitive)) {
-                    authHeader = line.mid(line.indexOf(':') + 1).trimmed();
-                    break;
-                }
-            }
+            const QString authHeader = QString::fromUtf8(request.header("Authorization"));
             if (authHeader.startsWith("Bearer ", Qt::CaseInsensitive)) {
                 QString token = authHeader.mid(7).trimmed();
                 if (!token.isEmpty() && token == m_settings->mcp()->mcpApiKey()) {
@@ -1205,25 +972,14 @@ void ShotServer::handleRequest(QTcpSocket* socket, const QByteArray& request)
         }
 
         if (!exempt && !checkSession(request)) {
-            if (hasStoredTotpSecret()) {
-                sendResponse(socket, 401, "text/html; charset=utf-8", QByteArray(WEB_AUTH_LOGIN_PAGE));
-            } else {
-                sendResponse(socket, 401, "text/html; charset=utf-8", QByteArray(WEB_AUTH_SETUP_REQUIRED_PAGE));
-            }
+            sendAsset(socket, 401, "text/html; charset=utf-8",
+                      staticPage(hasStoredTotpSecret() ? StaticPage::Login : StaticPage::SetupRequired));
             return;
         }
 
         // Handle auth API routes
         if (isAuthRoute) {
-            // Extract body for POST requests
-            QByteArray body;
-            qsizetype bodyStart = request.indexOf("\r\n\r\n");
-            if (bodyStart != -1) {
-                body = request.mid(bodyStart + 4);
-            }
-            // Store full request on socket for auth handlers that need cookie access
-            socket->setProperty("fullRequest", request);
-            handleAuthRoute(socket, method, path, body);
+            handleAuthRoute(socket, method, path, request);
             return;
         }
     }
@@ -1696,41 +1452,54 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
             sendResponse(socket, 404, "text/plain", "Not Found");
             return;
         }
-        // Extract headers from the raw request
-        qsizetype headerEnd = request.indexOf("\r\n\r\n");
-        QByteArray headers = (headerEnd > 0) ? request.left(headerEnd) : QByteArray();
-        QByteArray body;
-        if (headerEnd > 0 && headerEnd + 4 < request.size())
-            body = request.mid(headerEnd + 4);
-        m_mcpServer->handleHttpRequest(socket, method, path, headers, body);
+        m_mcpServer->handleHttpRequest(socket, method, path, request.head(), request.body());
         return;
     }
 
     // Route requests
     if (path == "/" || path == "/index.html" || path == "/shots" || path == "/shots/") {
+        // Read-only pages and API reads take a socket-bound token: if the client
+        // hangs up while the task is still queued, the query is never run.
         QPointer<QTcpSocket> socketGuard(socket);
         QString dbPath = m_storage->databasePath();
         auto destroyed = m_destroyed;
-        QThread* thread = QThread::create([this, socketGuard, dbPath, destroyed]() {
+        // Revalidation: stamp first, and skip the list query and the render
+        // entirely when the browser already holds this version of the page.
+        const QByteArray ifNoneMatch = request.header("If-None-Match").toByteArray();
+        const quint64 generation = m_historyGeneration;
+        // The page is rendered on the worker too, so the main thread only
+        // writes the finished string; the header's shot count is the one piece
+        // of main-thread state it needs.
+        const int totalShots = m_storage->totalShots();
+        TaskExecutor::instance().submit(TaskLane::Interactive, [this, socketGuard, dbPath, destroyed,
+                                                                ifNoneMatch, generation, totalShots]() {
             QVariantList shots;
+            QByteArray stamp;
+            bool notModified = false;
             bool success = false;
             withTempDb(dbPath, "shs_web_list", [&](QSqlDatabase& db) {
-                success = queryShotList(db, shots);
+                if (queryShotListStamp(db, stamp) && !ifNoneMatch.isEmpty())
+                    notModified = HttpContentCoding::ifNoneMatch(ifNoneMatch, shotPageETag(generation, stamp));
+                success = notModified || queryShotList(db, shots);
             });
+            QString html;
+            if (success && !notModified && !*destroyed)
+                html = generateShotListPage(shots, totalShots);
 
             if (*destroyed) return;
-            QMetaObject::invokeMethod(this, [this, socketGuard, destroyed, success,
-                                             shots = std::move(shots)]() {
+            QMetaObject::invokeMethod(this, [this, socketGuard, destroyed, success, notModified,
+                                             generation, stamp, html = std::move(html)]() {
                 if (*destroyed || !socketGuard) return;
+                const QByteArray etag = stamp.isEmpty() ? QByteArray() : shotPageETag(generation, stamp);
                 if (!success) {
                     sendResponse(socketGuard, 500, "text/plain", "Database unavailable");
+                } else if (notModified) {
+                    sendNotModified(socketGuard, etag);
                 } else {
-                    sendHtml(socketGuard, generateShotListPage(shots));
+                    sendHtml(socketGuard, html, etag);
                 }
             }, Qt::QueuedConnection);
-        });
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-        thread->start();
+        }, CancellationToken::boundTo(socket));
     }
     else if (path.startsWith("/compare/")) {
         // /compare/1,2,3 - compare shots with IDs 1, 2, 3
@@ -1754,7 +1523,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         QPointer<QTcpSocket> socketGuard(socket);
         QString dbPath = m_storage->databasePath();
         auto destroyed = m_destroyed;
-        QThread* thread = QThread::create([this, socketGuard, dbPath, ids, destroyed]() {
+        TaskExecutor::instance().submit(TaskLane::Interactive, [this, socketGuard, dbPath, ids, destroyed]() {
             QList<ShotRecord> shots;
             bool dbOpened = withTempDb(dbPath, "shs_web_cmp", [&](QSqlDatabase& db) {
                 for (qint64 id : ids) {
@@ -1773,9 +1542,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
                     sendHtml(socketGuard, generateComparisonPage(shots));
                 }
             }, Qt::QueuedConnection);
-        });
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-        thread->start();
+        }, CancellationToken::boundTo(socket));
     }
     else if (path.startsWith("/shot/") && path.endsWith("/profile.json")) {
         // /shot/123/profile.json - download profile JSON for a shot
@@ -1790,7 +1557,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         QPointer<QTcpSocket> socketGuard(socket);
         QString dbPath = m_storage->databasePath();
         auto destroyed = m_destroyed;
-        QThread* thread = QThread::create([this, socketGuard, dbPath, shotId, destroyed]() {
+        TaskExecutor::instance().submit(TaskLane::Interactive, [this, socketGuard, dbPath, shotId, destroyed]() {
             ShotRecord record;
             bool dbOpened = withTempDb(dbPath, "shs_web_prof", [&](QSqlDatabase& db) {
                 record = ShotHistoryStorage::loadShotRecordStatic(db, shotId);
@@ -1812,9 +1579,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
                     sendResponse(socketGuard, 404, "application/json", R"({"error":"No profile data for this shot"})");
                 }
             }, Qt::QueuedConnection);
-        });
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-        thread->start();
+        }, CancellationToken::boundTo(socket));
     }
     else if (path.startsWith("/shot/") && path.endsWith("/shot.json")) {
         // /shot/123/shot.json — download the shot as visualizer-format JSON
@@ -1829,7 +1594,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         QPointer<QTcpSocket> socketGuard(socket);
         QString dbPath = m_storage->databasePath();
         auto destroyed = m_destroyed;
-        QThread* thread = QThread::create([this, socketGuard, dbPath, shotId, destroyed]() {
+        TaskExecutor::instance().submit(TaskLane::Interactive, [this, socketGuard, dbPath, shotId, destroyed]() {
             ShotRecord record;
             bool dbOpened = withTempDb(dbPath, "shs_web_shot", [&](QSqlDatabase& db) {
                 record = ShotHistoryStorage::loadShotRecordStatic(db, shotId);
@@ -1856,9 +1621,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
                     sendResponse(socketGuard, 200, "application/json", payload, headers);
                 }
             }, Qt::QueuedConnection);
-        });
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-        thread->start();
+        }, CancellationToken::boundTo(socket));
     }
     else if (path.startsWith("/shot/")) {
         bool ok;
@@ -1870,9 +1633,20 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         QPointer<QTcpSocket> socketGuard(socket);
         QString dbPath = m_storage->databasePath();
         auto destroyed = m_destroyed;
-        QThread* thread = QThread::create([this, socketGuard, dbPath, shotId, destroyed]() {
+        const QByteArray ifNoneMatch = request.header("If-None-Match").toByteArray();
+        const quint64 generation = m_historyGeneration;
+        TaskExecutor::instance().submit(TaskLane::Interactive, [this, socketGuard, dbPath, shotId, destroyed,
+                                                                ifNoneMatch, generation]() {
             ShotProjection shot;
+            QByteArray stamp;
+            bool notModified = false;
             bool dbOpened = withTempDb(dbPath, "shs_web_det", [&](QSqlDatabase& db) {
+                if (queryShotStamp(db, shotId, stamp) && !ifNoneMatch.isEmpty()) {
+                    notModified = HttpContentCoding::ifNoneMatch(ifNoneMatch, shotPageETag(generation, stamp));
+                    if (notModified)
+                        return;
+                }
+
                 ShotRecord record = ShotHistoryStorage::loadShotRecordStatic(db, shotId);
                 shot = ShotHistoryStorage::convertShotRecord(record);
 
@@ -1907,47 +1681,126 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
                 }
             });
 
+            // Rendered here, like the list page: the detail page embeds every
+            // curve sample, and building that string is no job for the main thread.
+            QString html;
+            if (dbOpened && !notModified && !*destroyed)
+                html = generateShotDetailPage(shotId, shot);
+
             if (*destroyed) return;
-            QMetaObject::invokeMethod(this, [this, socketGuard, destroyed, dbOpened, shotId,
-                                             shot = std::move(shot)]() {
+            QMetaObject::invokeMethod(this, [this, socketGuard, destroyed, dbOpened, notModified,
+                                             generation, stamp, html = std::move(html)]() {
                 if (*destroyed || !socketGuard) return;
                 if (!dbOpened) {
                     sendResponse(socketGuard, 500, "text/plain", "Database unavailable");
                     return;
                 }
-                sendHtml(socketGuard, generateShotDetailPage(shotId, shot));
+                const QByteArray etag = stamp.isEmpty() ? QByteArray() : shotPageETag(generation, stamp);
+                if (notModified) {
+                    sendNotModified(socketGuard, etag);
+                    return;
+                }
+                sendHtml(socketGuard, html, etag);
             }, Qt::QueuedConnection);
-        });
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-        thread->start();
-    }
-    else if (path == "/api/shots") {
+        }, CancellationToken::boundTo(socket));
+    }
+    else if (path == "/api/shots" || path.startsWith("/api/shots?")) {
+        // GET /api/shots[?limit=&after=&fields=&format=] — see shotlistquery.h.
+        // A page that fits in one piece is answered whole (and compressed,
+        // like any JSON); a longer one is streamed chunked, a piece of
+        // kShotListPiece shots at a time, each read on a worker only once the
+        // client has taken the last — so the page is never held in memory
+        // whole. Link: rel="next" carries the cursor when more shots follow.
+        static constexpr int kShotListPiece = 200;
+        const ShotListQuery::Request list = ShotListQuery::parse(
+            path.contains('?') ? QUrlQuery(path.mid(path.indexOf('?') + 1)) : QUrlQuery(),
+            request.header("Accept"));
+        if (!list.error.isEmpty()) {
+            sendResponse(socket, 400, "application/json",
+                         QJsonDocument(QJsonObject{{"error", list.error}}).toJson(QJsonDocument::Compact));
+            return;
+        }
         QPointer<QTcpSocket> socketGuard(socket);
         QString dbPath = m_storage->databasePath();
         auto destroyed = m_destroyed;
-        QThread* thread = QThread::create([this, socketGuard, dbPath, destroyed]() {
-            QVariantList shots;
+        TaskExecutor::instance().submit(TaskLane::Interactive, [this, socketGuard, dbPath, destroyed, list]() {
+            const ShotListQuery::Projection projection = ShotListQuery::project(list.fields);
+            const int firstWant = qMin(kShotListPiece, list.limit);
+            QByteArray firstRows;
+            ShotListCursor last = list.after;
+            ShotListCursor next;
+            int count = 0;
             bool success = false;
             withTempDb(dbPath, "shs_web_api", [&](QSqlDatabase& db) {
-                success = queryShotList(db, shots);
+                success = ShotListQuery::encodePage(db, projection, firstWant, last, list.ndjson, firstRows, count)
+                          && (count < firstWant || ShotListQuery::nextCursor(db, list.limit, list.after, next));
             });
+            const bool complete = count < firstWant || count == list.limit;
 
             if (*destroyed) return;
-            QMetaObject::invokeMethod(this, [this, socketGuard, destroyed, success,
-                                             shots = std::move(shots)]() {
+            QMetaObject::invokeMethod(this, [this, socketGuard, destroyed, success, complete, dbPath, list,
+                                             projection, last, next, count, firstRows = std::move(firstRows)]() {
                 if (*destroyed || !socketGuard) return;
                 if (!success) {
                     sendResponse(socketGuard, 500, "application/json", R"({"error":"Database unavailable"})");
-                } else {
-                    QJsonArray arr;
-                    for (const QVariant& v : shots)
-                        arr.append(QJsonObject::fromVariantMap(v.toMap()));
-                    sendJson(socketGuard, QJsonDocument(arr).toJson(QJsonDocument::Compact));
+                    return;
                 }
+                const QString type = list.ndjson ? QStringLiteral("application/x-ndjson")
+                                                 : QStringLiteral("application/json");
+                QByteArray link;
+                if (next.valid)
+                    link = "Link: " + ShotListQuery::nextLink(list, next) + "\r\n";
+                if (complete) {
+                    sendResponse(socketGuard, 200, type, list.ndjson ? firstRows : QByteArray('[' + firstRows + ']'),
+                                 link);
+                    return;
+                }
+
+                struct ListStream {
+                    QString dbPath;
+                    ShotListQuery::Projection projection;
+                    bool ndjson = false;
+                    QByteArray pending;
+                    ShotListCursor after;
+                    int remaining = 0;
+                    bool closed = false;
+                };
+                auto state = std::make_shared<ListStream>();
+                state->dbPath = dbPath;
+                state->projection = projection;
+                state->ndjson = list.ndjson;
+                state->pending = list.ndjson ? firstRows : QByteArray('[' + firstRows);
+                state->after = last;
+                state->remaining = list.limit - count;
+                sendStream(socketGuard, type, -1, [state](QByteArray& piece) {
+                    if (!state->pending.isEmpty()) {
+                        piece = std::exchange(state->pending, QByteArray());
+                        return true;
+                    }
+                    if (state->closed) {
+                        piece.clear();
+                        return true;
+                    }
+                    const int want = qMin(kShotListPiece, state->remaining);
+                    QByteArray rows;
+                    int got = 0;
+                    bool ok = false;
+                    withTempDb(state->dbPath, "shs_web_api", [&](QSqlDatabase& db) {
+                        ok = ShotListQuery::encodePage(db, state->projection, want, state->after,
+                                                       state->ndjson, rows, got);
+                    });
+                    if (!ok) return false;
+                    piece = (state->ndjson || rows.isEmpty()) ? rows : QByteArray(',' + rows);
+                    state->remaining -= got;
+                    if (got < want || state->remaining <= 0) {
+                        if (!state->ndjson)
+                            piece += ']';
+                        state->closed = true;
+                    }
+                    return true;
+                }, link);
             }, Qt::QueuedConnection);
-        });
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-        thread->start();
+        }, CancellationToken::boundTo(socket));
     }
     else if (path.startsWith("/api/shot/") && path.endsWith("/metadata") && method == "POST") {
         // POST /api/shot/123/metadata - update shot metadata
@@ -1959,12 +1812,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
             sendResponse(socket, 400, "application/json", R"({"error":"Invalid shot ID"})");
             return;
         }
-        qsizetype bodyStart = request.indexOf("\r\n\r\n");
-        if (bodyStart == -1) {
-            sendResponse(socket, 400, "application/json", R"({"error":"Invalid request"})");
-            return;
-        }
-        QByteArray body = request.mid(bodyStart + 4);
+        const QByteArray& body = request.body();
         QJsonDocument doc = QJsonDocument::fromJson(body);
         if (!doc.isObject()) {
             sendResponse(socket, 400, "application/json", R"({"error":"Invalid JSON"})");
@@ -1974,7 +1822,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         QPointer<QTcpSocket> socketGuard(socket);
         QString dbPath = m_storage->databasePath();
         auto destroyed = m_destroyed;
-        QThread* thread = QThread::create([this, socketGuard, dbPath, shotId, metadata, destroyed]() {
+        TaskExecutor::instance().submit(TaskLane::Interactive, [this, socketGuard, dbPath, shotId, metadata, destroyed]() {
             bool success = false;
             bool dbOpened = withTempDb(dbPath, "shs_web_upd", [&](QSqlDatabase& db) {
                 success = ShotHistoryStorage::updateShotMetadataStatic(db, shotId, metadata);
@@ -1998,8 +1846,6 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
                 }
             }, Qt::QueuedConnection);
         });
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-        thread->start();
     }
     else if (path.startsWith("/api/shot/")) {
         bool ok;
@@ -2011,7 +1857,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         QPointer<QTcpSocket> socketGuard(socket);
         QString dbPath = m_storage->databasePath();
         auto destroyed = m_destroyed;
-        QThread* thread = QThread::create([this, socketGuard, dbPath, shotId, destroyed]() {
+        TaskExecutor::instance().submit(TaskLane::Interactive, [this, socketGuard, dbPath, shotId, destroyed]() {
             ShotProjection shot;
             bool dbOpened = withTempDb(dbPath, "shs_web_get", [&](QSqlDatabase& db) {
                 ShotRecord record = ShotHistoryStorage::loadShotRecordStatic(db, shotId);
@@ -2028,17 +1874,10 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
                     sendJson(socketGuard, QJsonDocument(shot.toJsonObject()).toJson());
                 }
             }, Qt::QueuedConnection);
-        });
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-        thread->start();
+        }, CancellationToken::boundTo(socket));
     }
     else if (path == "/api/shots/delete" && method == "POST") {
-        qsizetype bodyStart = request.indexOf("\r\n\r\n");
-        if (bodyStart == -1) {
-            sendResponse(socket, 400, "application/json", R"({"error":"Invalid request"})");
-            return;
-        }
-        QByteArray body = request.mid(bodyStart + 4);
+        const QByteArray& body = request.body();
         QJsonDocument doc = QJsonDocument::fromJson(body);
         QJsonArray ids = doc.object().value("ids").toArray();
         QList<qint64> shotIds;
@@ -2053,7 +1892,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         QPointer<QTcpSocket> socketGuard(socket);
         QString dbPath = m_storage->databasePath();
         auto destroyed = m_destroyed;
-        QThread* thread = QThread::create([this, socketGuard, dbPath, shotIds, destroyed]() {
+        TaskExecutor::instance().submit(TaskLane::Interactive, [this, socketGuard, dbPath, shotIds, destroyed]() {
             int deleted = 0;
             QList<qint64> deletedIds;
             bool dbOpened = withTempDb(dbPath, "shs_web_del", [&](QSqlDatabase& db) {
@@ -2091,15 +1930,30 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
                 }
             }, Qt::QueuedConnection);
         });
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-        thread->start();
+    }
+    else if (path == "/api/shots/reanalysis") {
+        // Whole-history re-analysis job: GET reports its status, POST
+        // {"action":"start"|"cancel"} drives it. Both answer with the status
+        // as it stands after the action.
+        if (method == "POST") {
+            const QString action = QJsonDocument::fromJson(request.body()).object().value("action").toString();
+            if (action == "start") {
+                m_storage->requestHistoryReanalysis();
+            } else if (action == "cancel") {
+                m_storage->cancelHistoryReanalysis();
+            } else {
+                sendResponse(socket, 400, "application/json", R"({"error":"action must be start or cancel"})");
+                return;
+            }
+        }
+        sendJson(socket, QJsonDocument(m_storage->historyReanalysisStatus()).toJson(QJsonDocument::Compact));
     }
     else if (path == "/api/database" || path == "/database.db") {
         // Checkpoint WAL and send DB file from background thread
         QPointer<QTcpSocket> socketGuard(socket);
         QString dbPath = m_storage->databasePath();
         auto destroyed = m_destroyed;
-        QThread* thread = QThread::create([this, socketGuard, dbPath, destroyed]() {
+        TaskExecutor::instance().submit(TaskLane::Maintenance, [this, socketGuard, dbPath, destroyed]() {
             bool checkpointOk = false;
             withTempDb(dbPath, "shs_web_db", [&](QSqlDatabase& db) {
                 QSqlQuery walQuery(db);
@@ -2131,8 +1985,6 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
                 }
             }, Qt::QueuedConnection);
         });
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-        thread->start();
     }
     else if (path == "/api/memory") {
         if (m_memoryMonitor) {
@@ -2142,34 +1994,27 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
             sendResponse(socket, 503, "application/json", R"({"error":"Memory monitor not available"})");
         }
     }
+    else if (path == "/api/executor") {
+        sendJson(socket, QJsonDocument(TaskExecutor::instance().toJson()).toJson(QJsonDocument::Compact));
+    }
     else if (path == "/debug") {
         sendHtml(socket, generateDebugPage());
     }
     else if (path == "/remote") {
-        sendHtml(socket, QString(WEB_REMOTE_PAGE));
+        sendAsset(socket, 200, "text/html; charset=utf-8", staticPage(StaticPage::Remote),
+                  request.header("If-None-Match"));
     }
     else if (path == "/settings") {
         sendHtml(socket, generateSettingsPage());
     }
     else if (path == "/api/settings/visualizer/test" && method == "POST") {
-        qsizetype bodyStart = request.indexOf("\r\n\r\n");
-        if (bodyStart != -1) {
-            handleVisualizerTest(socket, request.mid(bodyStart + 4));
-        } else {
-            sendJson(socket, R"({"success": false, "message": "Invalid request"})");
-        }
+        handleVisualizerTest(socket, request.body());
     }
     else if (path == "/api/settings/ai/test" && method == "POST") {
-        qsizetype bodyStart = request.indexOf("\r\n\r\n");
-        if (bodyStart != -1) {
-            handleAiTest(socket, request.mid(bodyStart + 4));
-        } else {
-            sendJson(socket, R"({"success": false, "message": "Invalid request"})");
-        }
+        handleAiTest(socket, request.body());
     }
     else if (path == "/api/settings/mqtt/connect" && method == "POST") {
-        qsizetype bodyStart = request.indexOf("\r\n\r\n");
-        QByteArray body = (bodyStart != -1) ? request.mid(bodyStart + 4) : QByteArray();
+        const QByteArray& body = request.body();
         handleMqttConnect(socket, body);
     }
     else if (path == "/api/settings/mqtt/disconnect" && method == "POST") {
@@ -2186,14 +2031,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
     }
     else if (path == "/api/settings") {
         if (method == "POST") {
-            // Extract body from request
-            qsizetype bodyStart = request.indexOf("\r\n\r\n");
-            if (bodyStart != -1) {
-                QByteArray body = request.mid(bodyStart + 4);
-                handleSaveSettings(socket, body);
-            } else {
-                sendJson(socket, R"({"error": "Invalid request"})");
-            }
+            handleSaveSettings(socket, request.body());
         } else {
             handleGetSettings(socket);
         }
@@ -2213,12 +2051,10 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
             result["searches"] = arr;
             sendJson(socket, QJsonDocument(result).toJson(QJsonDocument::Compact));
         } else if (method == "POST") {
-            qsizetype bodyStart = request.indexOf("\r\n\r\n");
             QJsonObject result;
             bool hasError = false;
-            if (bodyStart != -1 && m_settings) {
-                QByteArray body = request.mid(bodyStart + 4);
-                QJsonObject obj = QJsonDocument::fromJson(body).object();
+            if (m_settings) {
+                QJsonObject obj = QJsonDocument::fromJson(request.body()).object();
                 QString search = obj["search"].toString().trimmed();
                 if (!search.isEmpty()) {
                     m_settings->network()->addSavedSearch(search);
@@ -2237,12 +2073,10 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
             else
                 sendJson(socket, json);
         } else if (method == "DELETE") {
-            qsizetype bodyStart = request.indexOf("\r\n\r\n");
             QJsonObject result;
             bool hasError = false;
-            if (bodyStart != -1 && m_settings) {
-                QByteArray body = request.mid(bodyStart + 4);
-                QJsonObject obj = QJsonDocument::fromJson(body).object();
+            if (m_settings) {
+                QJsonObject obj = QJsonDocument::fromJson(request.body()).object();
                 QString search = obj["search"].toString().trimmed();
                 if (!search.isEmpty()) {
                     m_settings->network()->removeSavedSearch(search);
@@ -2307,6 +2141,17 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         result["success"] = true;
         sendJson(socket, QJsonDocument(result).toJson(QJsonDocument::Compact));
     }
+    else if (path == "/api/debug/latency") {
+        // Control-loop latency histograms (core/latencystats.h). Served whole —
+        // four legs of fourteen buckets — so a script can diff two dumps from
+        // different builds or devices without paging.
+        sendJson(socket, QJsonDocument(LatencyStats::toJson()).toJson(QJsonDocument::Compact));
+    }
+    else if (path == "/api/debug/latency/reset" && method == "POST") {
+        // Start a fresh measurement window, e.g. before an A/B run of shots.
+        LatencyStats::reset();
+        sendJson(socket, QJsonDocument(QJsonObject{{"success", true}}).toJson(QJsonDocument::Compact));
+    }
     else if (path == "/api/debug/file") {
         // Return persisted log file content (survives crashes), with memory snapshot appended
         QJsonObject result;
@@ -2318,29 +2163,41 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         sendJson(socket, QJsonDocument(result).toJson(QJsonDocument::Compact));
     }
     else if (path == "/api/debug/file/zip") {
-        // Return persisted log as a ZIP file for smaller downloads
-        QString log = WebDebugLogger::instance() ? WebDebugLogger::instance()->getPersistedLog() : QString();
-        if (m_memoryMonitor)
-            log += m_memoryMonitor->toSummaryString();
-
-        QBuffer zipBuffer;
-        zipBuffer.open(QIODevice::WriteOnly);
-        bool zipOk = false;
-        {
-            QZipWriter writer(&zipBuffer);
-            writer.setCompressionPolicy(QZipWriter::AlwaysCompress);
-            writer.addFile("debug.log", log.toUtf8());
-            zipOk = (writer.status() == QZipWriter::NoError);
-            writer.close();
-        }
+        // Return persisted log as a ZIP file for smaller downloads. Reading the
+        // log (up to WebDebugLogger::MAX_LOG_FILE_SIZE) and deflating it is
+        // disk I/O and CPU, so both happen on a worker.
+        QString memorySummary = m_memoryMonitor ? m_memoryMonitor->toSummaryString() : QString();
+        WebDebugLogger* logger = WebDebugLogger::instance();
+        QPointer<QTcpSocket> socketGuard(socket);
+        auto destroyed = m_destroyed;
+        TaskExecutor::instance().submit(TaskLane::Interactive, [this, socketGuard, destroyed, logger, memorySummary]() {
+            QString log = logger ? logger->getPersistedLog() : QString();
+            log += memorySummary;
+
+            QBuffer zipBuffer;
+            zipBuffer.open(QIODevice::WriteOnly);
+            bool zipOk = false;
+            {
+                QZipWriter writer(&zipBuffer);
+                writer.setCompressionPolicy(QZipWriter::AlwaysCompress);
+                writer.addFile("debug.log", log.toUtf8());
+                zipOk = (writer.status() == QZipWriter::NoError);
+                writer.close();
+            }
+            QByteArray zip = zipOk ? zipBuffer.data() : QByteArray();
 
-        if (zipOk) {
-            sendResponse(socket, 200, "application/zip", zipBuffer.data(),
-                         "Content-Disposition: attachment; filename=\"debug.zip\"\r\n");
-        } else {
-            qWarning() << "ShotServer: QZipWriter failed to create debug ZIP";
-            sendResponse(socket, 500, "text/plain", "Failed to create ZIP file");
-        }
+            if (*destroyed) return;
+            QMetaObject::invokeMethod(this, [this, socketGuard, destroyed, zipOk, zip = std::move(zip)]() {
+                if (*destroyed || !socketGuard) return;
+                if (zipOk) {
+                    sendResponse(socketGuard, 200, "application/zip", zip,
+                                 "Content-Disposition: attachment; filename=\"debug.zip\"\r\n");
+                } else {
+                    qWarning() << "ShotServer: QZipWriter failed to create debug ZIP";
+                    sendResponse(socketGuard, 500, "text/plain", "Failed to create ZIP file");
+                }
+            }, Qt::QueuedConnection);
+        }, CancellationToken::boundTo(socket));
     }
     else if (path == "/api/power" || path == "/api/power/status") {
         // Return current power state
@@ -2425,10 +2282,8 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
     }
     else if (path == "/api/command" && method == "POST") {
         // Parse JSON body from request
-        qsizetype bodyStart = request.indexOf("\r\n\r\n");
-        if (bodyStart >= 0) {
-            QByteArray body = request.mid(bodyStart + 4);
-            QJsonDocument doc = QJsonDocument::fromJson(body);
+        if (!request.body().isEmpty()) {
+            QJsonDocument doc = QJsonDocument::fromJson(request.body());
             QString command = doc.object()["command"].toString().toLower();
 
             if (command == "wake") {
@@ -2453,10 +2308,8 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         }
     }
     else if (path == "/api/pocket/pair" && method == "POST") {
-        qsizetype bodyStart = request.indexOf("\r\n\r\n");
-        if (bodyStart >= 0) {
-            QByteArray body = request.mid(bodyStart + 4);
-            handlePocketPair(socket, body);
+        if (!request.body().isEmpty()) {
+            handlePocketPair(socket, request.body());
         } else {
             sendResponse(socket, 400, "application/json", R"({"error":"Missing request body"})");
         }
@@ -2478,16 +2331,10 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
             sendHtml(socket, generateMediaUploadPage());
         } else if (method == "POST") {
             // For small uploads that weren't streamed, save body to temp file
-            qsizetype headerEndPos = request.indexOf("\r\n\r\n");
-            if (headerEndPos < 0) {
-                sendResponse(socket, 400, "text/plain", "Invalid request");
-                return;
-            }
-            QString headers = QString::fromUtf8(request.left(headerEndPos));
-            QByteArray body = request.mid(headerEndPos + 4);
+            const QByteArray body = request.body();
 
-            qDebug() << "ShotServer: Small media upload - request size:" << request.size()
-                     << "headerEnd:" << headerEndPos << "body size:" << body.size();
+            qDebug() << "ShotServer: Small media upload - head size:" << request.head().size()
+                     << "body size:" << body.size();
 
             // Save to temp file on a background thread (CLAUDE.md prohibits
             // main-thread disk I/O). Dispatch handleMediaUpload back to the
@@ -2496,7 +2343,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
             QString tempPath = tempDir + "/upload_small_" + QString::number(QDateTime::currentMSecsSinceEpoch()) + ".tmp";
             QPointer<QTcpSocket> safeSocket = socket;
             QPointer<ShotServer> safeThis = this;
-            QThread* t = QThread::create([safeThis, safeSocket, tempPath, body, headers]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [safeThis, safeSocket, tempPath, body, request]() {
                 QFile tempFile(tempPath);
                 if (!tempFile.open(QIODevice::WriteOnly) || tempFile.write(body) != body.size()) {
                     tempFile.close();
@@ -2508,22 +2355,18 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
                     return;
                 }
                 tempFile.close();
-                QMetaObject::invokeMethod(safeThis, [safeThis, safeSocket, tempPath, headers]() {
+                QMetaObject::invokeMethod(safeThis, [safeThis, safeSocket, tempPath, request]() {
                     if (safeThis && safeSocket) {
-                        safeThis->handleMediaUpload(safeSocket, tempPath, headers);
+                        safeThis->handleMediaUpload(safeSocket, tempPath, request);
                     } else {
                         // Client disconnected or ShotServer torn down before the
                         // handler could run. This callback runs on the main thread,
                         // so dispatch the cleanup to a background thread to keep
                         // main-thread disk I/O off the event loop (CLAUDE.md).
-                        QThread* cleanup = QThread::create([tempPath]() { QFile::remove(tempPath); });
-                        connect(cleanup, &QThread::finished, cleanup, &QThread::deleteLater);
-                        cleanup->start();
+                        TaskExecutor::instance().submit(TaskLane::Background, [tempPath]() { QFile::remove(tempPath); });
                     }
                 }, Qt::QueuedConnection);
             });
-            connect(t, &QThread::finished, t, &QThread::deleteLater);
-            t->start();
         }
     }
     else if (path == "/api/media/personal" && method == "GET") {
@@ -2589,42 +2432,47 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         }
     }
     else if (path == "/api/backup/shots") {
-        // Create a safe backup copy on background thread, then send it
+        // Create a safe backup copy on background thread, then stream it from
+        // disk — a whole history database is far too big to hold in memory.
         QPointer<QTcpSocket> socketGuard(socket);
         QString dbPath = m_storage->databasePath();
         auto destroyed = m_destroyed;
-        QThread* thread = QThread::create([this, socketGuard, dbPath, destroyed]() {
+        TaskExecutor::instance().submit(TaskLane::Maintenance, [this, socketGuard, dbPath, destroyed]() {
             QString tempDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
             QString tempPath = tempDir + "/backup_web_" + QString::number(QDateTime::currentMSecsSinceEpoch()) + ".db";
 
             QString result = ShotHistoryStorage::createBackupStatic(dbPath, tempPath);
-            QByteArray fileData;
+            qint64 size = -1;
             if (!result.isEmpty()) {
-                QFile f(tempPath);
-                if (f.open(QIODevice::ReadOnly)) {
-                    fileData = f.readAll();
-                } else {
-                    qWarning() << "ShotServer: Failed to read backup file:" << f.errorString();
-                }
+                size = QFileInfo(tempPath).size();
             } else {
                 qWarning() << "ShotServer: createBackupStatic failed for" << dbPath << "->" << tempPath;
             }
-            if (QFile::exists(tempPath))
+            if (size <= 0 && QFile::exists(tempPath))
                 QFile::remove(tempPath);
 
-            if (*destroyed) return;
-            QMetaObject::invokeMethod(this, [this, socketGuard, destroyed,
-                                             fileData = std::move(fileData)]() {
-                if (*destroyed || !socketGuard) return;
-                if (!fileData.isEmpty()) {
-                    sendResponse(socketGuard, 200, "application/x-sqlite3", fileData);
-                } else {
+            if (*destroyed) {
+                QFile::remove(tempPath);
+                return;
+            }
+            QMetaObject::invokeMethod(this, [this, socketGuard, destroyed, tempPath, size]() {
+                auto removeTemp = [tempPath]() {
+                    TaskExecutor::instance().submit(TaskLane::Background, [tempPath]() {
+                        QFile::remove(tempPath);
+                    });
+                };
+                if (*destroyed || !socketGuard) {
+                    if (size > 0) removeTemp();
+                    return;
+                }
+                if (size <= 0) {
                     sendResponse(socketGuard, 500, "application/json", R"({"error":"Failed to create backup"})");
+                    return;
                 }
+                sendStream(socketGuard, "application/x-sqlite3", size,
+                           HttpResponseStream::fileProducer(tempPath), QByteArray(), removeTemp);
             }, Qt::QueuedConnection);
         });
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-        thread->start();
     }
     else if (path == "/api/backup/media") {
         handleBackupMediaList(socket);
@@ -2646,13 +2494,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
     }
     else if (path == "/api/backup/restore" && method == "POST") {
         // Small restore uploads (< 1MB) that were not streamed to temp file
-        qsizetype headerEndPos = request.indexOf("\r\n\r\n");
-        if (headerEndPos < 0) {
-            sendResponse(socket, 400, "text/plain", "Invalid request");
-            return;
-        }
-        QString headers = QString::fromUtf8(request.left(headerEndPos));
-        QByteArray body = request.mid(headerEndPos + 4);
+        const QByteArray body = request.body();
 
         QString tempDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
         QString tempPath = tempDir + "/restore_small_" + QString::number(QDateTime::currentMSecsSinceEpoch()) + ".tmp";
@@ -2661,7 +2503,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         // to the main thread once the write completes.
         QPointer<QTcpSocket> safeSocket = socket;
         QPointer<ShotServer> safeThis = this;
-        QThread* t = QThread::create([safeThis, safeSocket, tempPath, body, headers]() {
+        TaskExecutor::instance().submit(TaskLane::Interactive, [safeThis, safeSocket, tempPath, body]() {
             QFile tempFile(tempPath);
             if (!tempFile.open(QIODevice::WriteOnly) || tempFile.write(body) != body.size()) {
                 tempFile.close();
@@ -2673,22 +2515,18 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
                 return;
             }
             tempFile.close();
-            QMetaObject::invokeMethod(safeThis, [safeThis, safeSocket, tempPath, headers]() {
+            QMetaObject::invokeMethod(safeThis, [safeThis, safeSocket, tempPath]() {
                 if (safeThis && safeSocket) {
-                    safeThis->handleBackupRestore(safeSocket, tempPath, headers);
+                    safeThis->handleBackupRestore(safeSocket, tempPath);
                 } else {
                     // Client disconnected or ShotServer torn down before the
                     // handler could run. This callback runs on the main thread,
                     // so dispatch the cleanup to a background thread to keep
                     // main-thread disk I/O off the event loop (CLAUDE.md).
-                    QThread* cleanup = QThread::create([tempPath]() { QFile::remove(tempPath); });
-                    connect(cleanup, &QThread::finished, cleanup, &QThread::deleteLater);
-                    cleanup->start();
+                    TaskExecutor::instance().submit(TaskLane::Background, [tempPath]() { QFile::remove(tempPath); });
                 }
             }, Qt::QueuedConnection);
         });
-        connect(t, &QThread::finished, t, &QThread::deleteLater);
-        t->start();
     }
     // Recipes / Beans / Equipment management pages (add-recipes)
     else if (path == "/recipes") {
@@ -2702,19 +2540,16 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
     }
     // Recipes / bags / equipment REST APIs (add-recipes)
     else if (path == "/api/recipes" || path.startsWith("/api/recipes/") || path.startsWith("/api/recipe/")) {
-        qsizetype headerEndPos = request.indexOf("\r\n\r\n");
-        QByteArray body = (headerEndPos >= 0) ? request.mid(headerEndPos + 4) : QByteArray();
+        const QByteArray& body = request.body();
         handleRecipesApi(socket, method, path, body);
     }
     else if (path == "/api/bags" || path.startsWith("/api/bag/")
              || path.startsWith("/api/beans/")) {
-        qsizetype headerEndPos = request.indexOf("\r\n\r\n");
-        QByteArray body = (headerEndPos >= 0) ? request.mid(headerEndPos + 4) : QByteArray();
+        const QByteArray& body = request.body();
         handleBagsApi(socket, method, path, body);
     }
     else if (path == "/api/equipment" || path.startsWith("/api/equipment/")) {
-        qsizetype headerEndPos = request.indexOf("\r\n\r\n");
-        QByteArray body = (headerEndPos >= 0) ? request.mid(headerEndPos + 4) : QByteArray();
+        const QByteArray& body = request.body();
         handleEquipmentApi(socket, method, path, body);
     }
     // Theme editor
@@ -2736,8 +2571,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
     }
     // Theme API endpoints
     else if (path == "/api/theme" || path.startsWith("/api/theme/")) {
-        qsizetype headerEndPos = request.indexOf("\r\n\r\n");
-        QByteArray body = (headerEndPos >= 0) ? request.mid(headerEndPos + 4) : QByteArray();
+        const QByteArray& body = request.body();
         handleThemeApi(socket, method, path, body);
     }
     // Layout editor
@@ -2759,8 +2593,7 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
     }
     else if (path == "/api/layout" || path.startsWith("/api/layout/") || path.startsWith("/api/layout?")
              || path.startsWith("/api/library") || path.startsWith("/api/community")) {
-        qsizetype headerEndPos = request.indexOf("\r\n\r\n");
-        QByteArray body = (headerEndPos >= 0) ? request.mid(headerEndPos + 4) : QByteArray();
+        const QByteArray& body = request.body();
         handleLayoutApi(socket, method, path, body);
     }
     else if (path == "/ai-conversations") {
@@ -2780,22 +2613,123 @@ btn.textContent='Copied!';setTimeout(function(){btn.textContent='Copy'},2000);
         handleAIConversationDownload(socket, key, format);
     }
     else if (path.startsWith("/icons/") && path.endsWith(".svg")) {
-        // Serve SVG icons from Qt resources for web layout editor
-        QString resourcePath = ":/" + path.mid(1); // ":/icons/espresso.svg"
-        QFile iconFile(resourcePath);
-        if (iconFile.open(QIODevice::ReadOnly)) {
-            QByteArray svgData = iconFile.readAll();
-            sendResponse(socket, 200, "image/svg+xml", svgData);
-        } else {
-            sendResponse(socket, 404, "text/plain", "Icon not found");
+        // Serve SVG icons from Qt resources for web layout editor. Resources
+        // are fixed for the life of the build, so each is read and encoded once.
+        auto it = m_iconAssets.constFind(path);
+        if (it == m_iconAssets.cend()) {
+            QString resourcePath = ":/" + path.mid(1); // ":/icons/espresso.svg"
+            QFile iconFile(resourcePath);
+            if (!iconFile.open(QIODevice::ReadOnly)) {
+                sendResponse(socket, 404, "text/plain", "Icon not found");
+                return;
+            }
+            it = m_iconAssets.insert(path, HttpContentCoding::EncodedAsset::make(iconFile.readAll(), "image/svg+xml"));
         }
+        sendAsset(socket, 200, "image/svg+xml", it.value(), request.header("If-None-Match"));
     }
     else {
         sendResponse(socket, 404, "text/plain", "Not Found");
     }
 }
 
-void ShotServer::sendResponse(QTcpSocket* rawSocket, int statusCode, const QString& contentType,
+void ShotServer::sendResponse(QTcpSocket* socket, int statusCode, const QString& contentType,
+                               const QByteArray& body, const QByteArray& extraHeaders, const QByteArray& etag)
+{
+    using HttpContentCoding::Coding;
+
+    QByteArray headers;
+    const QByteArray type = contentType.toUtf8();
+    // Callers that set their own Content-Encoding have encoded the body already.
+    const bool compressible = HttpContentCoding::shouldCompress(type, body.size())
+                              && !extraHeaders.contains("Content-Encoding:");
+    Coding coding = compressible ? m_acceptedCoding.value(socket, Coding::Identity) : Coding::Identity;
+    QByteArray encoded;
+    if (coding != Coding::Identity) {
+        encoded = HttpContentCoding::encode(body, coding);
+        if (encoded.isEmpty() || encoded.size() >= body.size()) {
+            coding = Coding::Identity;
+            encoded.clear();
+        } else {
+            headers += "Content-Encoding: " + HttpContentCoding::token(coding).toByteArray() + "\r\n";
+        }
+    }
+    if (compressible)
+        headers += "Vary: Accept-Encoding\r\n";
+    if (!etag.isEmpty()) {
+        headers += "ETag: " + HttpContentCoding::etagForCoding(etag, coding) + "\r\n";
+        headers += "Cache-Control: private, no-cache\r\n";
+    }
+    headers += extraHeaders;
+    writeResponse(socket, statusCode, contentType, coding == Coding::Identity ? body : encoded, headers);
+}
+
+void ShotServer::sendAsset(QTcpSocket* socket, int statusCode, const QString& contentType,
+                            const HttpContentCoding::EncodedAsset& asset, QByteArrayView ifNoneMatch)
+{
+    using HttpContentCoding::Coding;
+
+    const Coding coding = asset.codingFor(m_acceptedCoding.value(socket, Coding::Identity));
+    if (statusCode == 200 && !ifNoneMatch.isEmpty() && HttpContentCoding::ifNoneMatch(ifNoneMatch, asset.etag)) {
+        sendNotModified(socket, HttpContentCoding::etagForCoding(asset.etag, coding));
+        return;
+    }
+
+    QByteArray headers;
+    if (coding != Coding::Identity)
+        headers += "Content-Encoding: " + HttpContentCoding::token(coding).toByteArray() + "\r\n";
+    if (!asset.gzip.isEmpty() || !asset.deflate.isEmpty())
+        headers += "Vary: Accept-Encoding\r\n";
+    if (statusCode == 200) {
+        headers += "ETag: " + HttpContentCoding::etagForCoding(asset.etag, coding) + "\r\n";
+        headers += "Cache-Control: private, no-cache\r\n";
+    }
+    writeResponse(socket, statusCode, contentType, asset.body(coding), headers);
+}
+
+void ShotServer::sendNotModified(QTcpSocket* socket, const QByteArray& etag)
+{
+    QByteArray headers;
+    if (!etag.isEmpty())
+        headers += "ETag: " + HttpContentCoding::etagForCoding(etag, m_acceptedCoding.value(socket)) + "\r\n";
+    headers += "Cache-Control: private, no-cache\r\nVary: Accept-Encoding\r\n";
+    writeResponse(socket, 304, QString(), QByteArray(), headers);
+}
+
+const HttpContentCoding::EncodedAsset& ShotServer::staticPage(StaticPage page)
+{
+    // Encoded once per process, on first request — the embedded pages are
+    // constants, so there is nothing to redo until the app is rebuilt.
+    static const QString vitalScript = generateVitalStatsScript();
+    auto make = [](const char* html, bool withVitalStats) {
+        QString finalHtml = QString::fromUtf8(html);
+        if (withVitalStats)
+            finalHtml.replace(QLatin1String("</body>"), vitalScript + QStringLiteral("</body>"));
+        return HttpContentCoding::EncodedAsset::make(finalHtml.toUtf8(), "text/html");
+    };
+    switch (page) {
+    case StaticPage::Login: {
+        static const HttpContentCoding::EncodedAsset login = make(WEB_AUTH_LOGIN_PAGE, false);
+        return login;
+    }
+    case StaticPage::SetupRequired: {
+        static const HttpContentCoding::EncodedAsset setup = make(WEB_AUTH_SETUP_REQUIRED_PAGE, false);
+        return setup;
+    }
+    case StaticPage::Remote:
+        break;
+    }
+    // Served through sendHtml before, so it carries the vital-stats header too.
+    static const HttpContentCoding::EncodedAsset remote = make(WEB_REMOTE_PAGE, true);
+    return remote;
+}
+
+QByteArray ShotServer::shotPageETag(quint64 generation, QByteArrayView stamp) const
+{
+    return HttpContentCoding::strongETag(stamp.toByteArray() + '/' + QByteArray::number(generation)
+                                         + '/' + QByteArray::number(m_etagEpoch));
+}
+
+void ShotServer::writeResponse(QTcpSocket* rawSocket, int statusCode, const QString& contentType,
                                const QByteArray& body, const QByteArray& extraHeaders)
 {
     // Raw socket pointers reach this function via posted QMetaCallEvents and
@@ -2812,19 +2746,26 @@ void ShotServer::sendResponse(QTcpSocket* rawSocket, int statusCode, const QStri
     switch (statusCode) {
         case 200: statusText = "OK"; break;
         case 302: statusText = "Found"; break;
+        case 304: statusText = "Not Modified"; break;
         case 400: statusText = "Bad Request"; break;
         case 401: statusText = "Unauthorized"; break;
         case 404: statusText = "Not Found"; break;
         case 413: statusText = "Payload Too Large"; break;
         case 429: statusText = "Too Many Requests"; break;
+        case 500: statusText = "Internal Server Error"; break;
+        case 501: statusText = "Not Implemented"; break;
         case 503: statusText = "Service Unavailable"; break;
         default: statusText = "Unknown"; break;
     }
 
     QByteArray response;
     response.append(QString("HTTP/1.1 %1 %2\r\n").arg(statusCode).arg(statusText).toUtf8());
-    response.append(QString("Content-Type: %1\r\n").arg(contentType).toUtf8());
-    response.append(QString("Content-Length: %1\r\n").arg(body.size()).toUtf8());
+    // A 304 has no body; its headers describe the representation the client
+    // already holds, so no Content-Type or Content-Length of an empty one.
+    if (statusCode != 304) {
+        response.append(QString("Content-Type: %1\r\n").arg(contentType).toUtf8());
+        response.append(QString("Content-Length: %1\r\n").arg(body.size()).toUtf8());
+    }
     if (!isSecurityEnabled()) {
         response.append("Access-Control-Allow-Origin: *\r\n");
     }
@@ -2919,85 +2860,79 @@ void ShotServer::handleGrindCandidatesApi(QTcpSocket* socket, const QString& pat
                          .toJson(QJsonDocument::Compact));
 }
 
-void ShotServer::sendHtml(QTcpSocket* socket, const QString& html)
+void ShotServer::sendHtml(QTcpSocket* socket, const QString& html, const QByteArray& etag)
 {
     // Inject vital stats (temperature, water level, connection) into the header of every page
     QString finalHtml = html;
     static const QString vitalScript = generateVitalStatsScript();
     finalHtml.replace(QLatin1String("</body>"), vitalScript + QStringLiteral("</body>"));
-    sendResponse(socket, 200, "text/html; charset=utf-8", finalHtml.toUtf8());
+    sendResponse(socket, 200, "text/html; charset=utf-8", finalHtml.toUtf8(), QByteArray(), etag);
 }
 
-void ShotServer::sendFile(QTcpSocket* rawSocket, const QString& path, const QString& contentType)
+void ShotServer::sendFile(QTcpSocket* socket, const QString& path, const QString& contentType)
 {
-    // waitForBytesWritten() below spins a local event loop, so unlike
-    // sendResponse the socket really can be destroyed mid-function via a
-    // deleteLater queued from onDisconnected. Hold a QPointer and re-check it
-    // after every operation that yields to the event loop.
-    QPointer<QTcpSocket> socket(rawSocket);
-    if (!socket || socket->state() != QAbstractSocket::ConnectedState) return;
-
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        sendResponse(socket, 404, "text/plain", "File not found");
-        return;
-    }
-
-    qint64 fileSize = file.size();
-    QString filename = QFileInfo(path).fileName();
-    filename.replace(QRegularExpression("[^a-zA-Z0-9_.-]"), "_");
-
-    // Send headers
-    QByteArray headers = QString(
-        "HTTP/1.1 200 OK\r\n"
-        "Content-Type: %1\r\n"
-        "Content-Length: %2\r\n"
-        "Content-Disposition: attachment; filename=\"%3\"\r\n"
-        "Access-Control-Allow-Origin: *\r\n"
-        "Connection: close\r\n"
-        "\r\n"
-    ).arg(contentType).arg(fileSize).arg(filename).toUtf8();
+    // This used to write 64 KB at a time and waitForBytesWritten() after each,
+    // a nested event loop on the GUI thread for the length of the download.
+    // Now only the size is needed up front, for Content-Length — and even
+    // that is a disk access, so it is taken on a worker.
+    QPointer<QTcpSocket> socketGuard(socket);
+    auto destroyed = m_destroyed;
+    TaskExecutor::instance().submit(TaskLane::Interactive, [this, socketGuard, destroyed, path, contentType]() {
+        QFile file(path);
+        const qint64 size = file.open(QIODevice::ReadOnly) ? file.size() : -1;
+        file.close();
+
+        if (*destroyed) return;
+        QMetaObject::invokeMethod(this, [this, socketGuard, destroyed, path, contentType, size]() {
+            if (*destroyed || !socketGuard) return;
+            if (size < 0) {
+                sendResponse(socketGuard, 404, "text/plain", "File not found");
+                return;
+            }
+            QString filename = QFileInfo(path).fileName();
+            filename.replace(QRegularExpression("[^a-zA-Z0-9_.-]"), "_");
+            sendStream(socketGuard, contentType, size, HttpResponseStream::fileProducer(path),
+                       QString("Content-Disposition: attachment; filename=\"%1\"\r\n").arg(filename).toUtf8());
+        }, Qt::QueuedConnection);
+    }, CancellationToken::boundTo(socket));
+}
 
-    if (!socket) return;
-    if (socket->write(headers) == -1) {
-        qWarning() << "ShotServer::sendFile: Failed to write headers -" << socket->errorString();
-        if (socket) socket->abort();
+void ShotServer::sendStream(QTcpSocket* rawSocket, const QString& contentType, qint64 contentLength,
+                            HttpResponseStream::Producer producer, const QByteArray& extraHeaders,
+                            std::function<void()> onDone)
+{
+    QPointer<QTcpSocket> socket(rawSocket);
+    if (!socket || socket->state() != QAbstractSocket::ConnectedState) {
+        if (onDone) onDone();
         return;
     }
 
-    // Stream file in 64KB chunks to avoid OOM on large databases
-    const qint64 chunkSize = 64 * 1024;
-    bool success = true;
-    while (!file.atEnd()) {
-        QByteArray chunk = file.read(chunkSize);
-        if (chunk.isEmpty() && !file.atEnd()) {
-            qWarning() << "ShotServer::sendFile: File read error -" << file.errorString();
-            success = false;
-            break;
-        }
-        if (!socket) return;
-        if (socket->write(chunk) == -1) {
-            qWarning() << "ShotServer::sendFile: Socket write failed -" << socket->errorString();
-            success = false;
-            break;
-        }
-        if (!socket) return;
-        if (!socket->waitForBytesWritten(5000)) {
-            // Either a write timeout OR the socket was destroyed by a
-            // deleteLater fired from the nested event loop above.
-            if (socket) qWarning() << "ShotServer::sendFile: Write timed out";
-            success = false;
-            break;
-        }
-    }
+    QByteArray head = "HTTP/1.1 200 OK\r\n";
+    head += "Content-Type: " + contentType.toUtf8() + "\r\n";
+    if (contentLength >= 0)
+        head += "Content-Length: " + QByteArray::number(contentLength) + "\r\n";
+    else
+        head += "Transfer-Encoding: chunked\r\n";
+    if (!isSecurityEnabled())
+        head += "Access-Control-Allow-Origin: *\r\n";
+    head += "Connection: close\r\n";
+    head += extraHeaders;
+    head += "\r\n";
 
-    if (!socket) return;
-    if (success) {
-        socket->flush();
-        if (socket) socket->disconnectFromHost();
-    } else {
-        socket->abort();
-    }
+    if (QTimer* t = m_keepAliveTimers.take(socket))
+        t->stop();
+    m_streamingClients.insert(socket);
+
+    auto* stream = new HttpResponseStream(socket, std::move(head), contentLength, std::move(producer));
+    // disconnectFromHost waits for the buffered tail to go out; a stream that
+    // failed has aborted the socket already.
+    connect(stream, &HttpResponseStream::finished, socket, [socket](bool ok) {
+        if (ok && socket) socket->disconnectFromHost();
+    });
+    // No context object: this must run even when the stream outlives us.
+    if (onDone)
+        connect(stream, &QObject::destroyed, [onDone = std::move(onDone)]() { onDone(); });
+    stream->start();
 }
 
 void ShotServer::sendRedirect(QTcpSocket* rawSocket, const QString& location, const QString& setCookie)
@@ -3507,7 +3442,7 @@ bool ShotServer::generateSelfSignedCert(const QString& certPath, const QString&
 }
 #endif // Q_OS_IOS
 
-// Session management, extractCookie, checkSession, createSession, hasStoredTotpSecret,
+// Session management, checkSession, createSession, hasStoredTotpSecret,
 // loadSessions, saveSessions are all in shotserver_auth.cpp
 
 QString ShotServer::getLocalIpAddress() const
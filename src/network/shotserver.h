@@ -22,6 +22,10 @@
 #include <memory>
 
 #include "../history/shotprojection.h"
+#include "httpcontentcoding.h"
+#include "httpresponsestream.h"
+#include "httpserverthread.h"
+#include "httprequestparser.h"
 #include "multicastlock.h"
 #include <QtQml/qqmlregistration.h>
 
@@ -42,10 +46,7 @@ class McpServer;
 class MemoryMonitor;
 
 struct PendingRequest {
-    QByteArray headerData;          // Only headers stored in memory
-    qint64 contentLength = -1;
-    int headerEnd = -1;
-    qint64 bodyReceived = 0;        // Track bytes received
+    HttpRequestParser parser;       // Parses the request as it arrives; keeps pipelined bytes
     QFile* tempFile = nullptr;      // Stream body to temp file for large uploads
     QString tempFilePath;           // Path to temp file
     QElapsedTimer lastActivity;     // For timeout tracking
@@ -72,7 +73,7 @@ public:
     explicit ShotServer(ShotHistoryStorage* storage, DE1Device* device, QObject* parent = nullptr);
     ~ShotServer();
 
-    bool isRunning() const { return m_server && m_server->isListening(); }
+    bool isRunning() const { return m_network && m_network->isListening(); }
     QString url() const;
     int port() const { return m_port; }
     void setPort(int port);
@@ -140,10 +141,11 @@ signals:
     void aboutToDispatchInstall();
 
 private slots:
-    void onNewConnection();
+    void onNewConnection(QTcpSocket* socket);
     void onReadyRead();
     void onDisconnected();
     void onCleanupTimerTick();
+    void onHealthChecked(qintptr socketDescriptor, bool listening);
     void onDiscoveryDatagram();
     void onLayoutChanged();
     void onThemeChanged();
@@ -158,9 +160,44 @@ private:
     // are reported.
     LogCollapse m_requestLog{LogCollapse::kChangesOnly};
 
-    void handleRequest(QTcpSocket* socket, const QByteArray& request);
+    // Feed bytes read from `socket` to its parser and dispatch every request
+    // they complete. Called from onReadyRead, and again (queued) when a
+    // request left pipelined bytes behind.
+    void processIncoming(QTcpSocket* socket, const QByteArray& data);
+    // HeadComplete: pick where the body goes (memory or a temp file) and
+    // enforce the upload limits. False if the request was refused and the
+    // socket closed.
+    bool beginRequestBody(QTcpSocket* socket, PendingRequest& pending);
+    void completeRequest(QTcpSocket* socket, PendingRequest& pending);
+    void handleRequest(QTcpSocket* socket, const HttpRequest& request);
+    // Compresses the body when the connection's last request accepted gzip or
+    // deflate and the type is worth it (HttpContentCoding::shouldCompress).
+    // A non-empty `etag` makes it a validated response: the ETag goes out in
+    // the coding's variant, with Cache-Control: no-cache so the browser asks
+    // again every time — and gets a 304 while the tag still matches.
     void sendResponse(QTcpSocket* socket, int statusCode, const QString& contentType,
-                      const QByteArray& body, const QByteArray& extraHeaders = QByteArray());
+                      const QByteArray& body, const QByteArray& extraHeaders = QByteArray(),
+                      const QByteArray& etag = QByteArray());
+    // Writes status line, headers and `body` exactly as given: the body is
+    // already in whatever Content-Encoding `extraHeaders` names. A 304 goes out
+    // without Content-Type, Content-Length or body.
+    void writeResponse(QTcpSocket* socket, int statusCode, const QString& contentType,
+                       const QByteArray& body, const QByteArray& extraHeaders);
+    // A fixed body encoded ahead of time. 304 instead when `ifNoneMatch`
+    // already names it (200 responses only).
+    void sendAsset(QTcpSocket* socket, int statusCode, const QString& contentType,
+                   const HttpContentCoding::EncodedAsset& asset, QByteArrayView ifNoneMatch = {});
+    void sendNotModified(QTcpSocket* socket, const QByteArray& etag);
+    // The pages served verbatim from webtemplates/, encoded on first use.
+    enum class StaticPage { Login, SetupRequired, Remote };
+    static const HttpContentCoding::EncodedAsset& staticPage(StaticPage page);
+    // Validators for the shot pages: what the page was rendered from (shot
+    // ids, shots.updated_at and the recipes it names), plus the history
+    // generation — bumped on every historyDataChanged, so two edits inside
+    // the same updated_at second still change the tag — and this process's
+    // start, so a restart (perhaps into a new build that renders differently)
+    // never revalidates a page it didn't render.
+    QByteArray shotPageETag(quint64 generation, QByteArrayView stamp) const;
     void sendJson(QTcpSocket* socket, const QByteArray& json);
     // GET /api/grind-candidates?brand=&model=&current=&rpm= — server-computed
     // stepped grind/RPM candidate lists for the web <datalist> helper
@@ -172,21 +209,35 @@ private:
     // plain-numeric fallback, observed-history fallback; RPM ±5 steps around
     // the value (neutral 1000 anchor when unset). No stepping in browser JS.
     void handleGrindCandidatesApi(QTcpSocket* socket, const QString& path);
-    void sendHtml(QTcpSocket* socket, const QString& html);
+    void sendHtml(QTcpSocket* socket, const QString& html, const QByteArray& etag = QByteArray());
+    // Stats the file on a worker, then streams it (sendStream). 404 if it
+    // can't be opened.
     void sendFile(QTcpSocket* socket, const QString& path, const QString& contentType);
+    // A 200 whose body `producer` makes a piece at a time on a worker, written
+    // as the client drains it (HttpResponseStream): Content-Length framing when
+    // `contentLength` >= 0, chunked otherwise. The connection closes after the
+    // body, and the socket is out of the keep-alive rotation until then — no
+    // idle timer, and onReadyRead ignores whatever the client pipelines behind
+    // it — so nothing else is ever written into the middle of the body.
+    // `onDone` runs once the stream is over however it ended: done, failed, or
+    // its client gone. It may run after this ShotServer is destroyed, so it
+    // must check m_destroyed before touching members.
+    void sendStream(QTcpSocket* socket, const QString& contentType, qint64 contentLength,
+                    HttpResponseStream::Producer producer, const QByteArray& extraHeaders = QByteArray(),
+                    std::function<void()> onDone = {});
 
     QString getLocalIpAddress() const;
-    QString generateShotListPage(const QVariantList& shots) const;
+    QString generateShotListPage(const QVariantList& shots, int totalShots) const;
     QString generateShotDetailPage(qint64 shotId, const ShotProjection& shot) const;
     QString generateComparisonPage(const QList<ShotRecord>& shots) const;
     QString generateDebugPage() const;
     QString generateUploadPage() const;
-    void handleUploadFromFile(QTcpSocket* socket, const QString& tempPath, const QString& headers);
+    void handleUploadFromFile(QTcpSocket* socket, const QString& tempPath, const HttpRequest& request);
     bool installApk(const QString& apkPath);
 
     // Personal media upload
     QString generateMediaUploadPage() const;
-    void handleMediaUpload(QTcpSocket* socket, const QString& tempFilePath, const QString& headers);
+    void handleMediaUpload(QTcpSocket* socket, const QString& tempFilePath, const HttpRequest& request);
     static bool resizeImage(const QString& inputPath, const QString& outputPath, int maxWidth, int maxHeight);
     static bool resizeVideo(const QString& inputPath, const QString& outputPath, int maxWidth, int maxHeight);
     static QDateTime extractImageDate(const QString& imagePath);
@@ -212,7 +263,7 @@ private:
     // Full backup download/restore
     void handleBackupFull(QTcpSocket* socket);
     QString generateRestorePage() const;
-    void handleBackupRestore(QTcpSocket* socket, const QString& tempFilePath, const QString& headers);
+    void handleBackupRestore(QTcpSocket* socket, const QString& tempFilePath);
 
     // Layout editor web UI
     QString generateLayoutPage() const;
@@ -263,11 +314,10 @@ private:
     bool isSecurityEnabled() const;
 
     // Authentication (TOTP) - implemented in shotserver_auth.cpp
-    void handleAuthRoute(QTcpSocket* socket, const QString& method, const QString& path, const QByteArray& body);
-    void handleTotpLogin(QTcpSocket* socket, const QByteArray& body);
-    bool checkSession(const QByteArray& request) const;
+    void handleAuthRoute(QTcpSocket* socket, const QString& method, const QString& path, const HttpRequest& request);
+    void handleTotpLogin(QTcpSocket* socket, const HttpRequest& request);
+    bool checkSession(const HttpRequest& request) const;
     bool hasStoredTotpSecret() const;
-    QString extractCookie(const QByteArray& request, const QString& cookieName) const;
     QString createSession(const QString& userAgent);
     void sendRedirect(QTcpSocket* socket, const QString& location, const QString& setCookie = QString());
     void loadSessions();
@@ -287,7 +337,7 @@ private:
     // Shared flag for destructor safety in background thread lambdas
     std::shared_ptr<bool> m_destroyed = std::make_shared<bool>(false);
 
-    QTcpServer* m_server = nullptr;
+    HttpServerThread* m_network = nullptr;  // Listener and sockets, on their own thread
     QUdpSocket* m_discoverySocket = nullptr;
 
     // Listen-socket health-check state. We only log on state change instead
@@ -379,13 +429,22 @@ private:
     QSet<QTcpSocket*> m_sseLayoutClients;  // SSE connections for layout change notifications
     QSet<QTcpSocket*> m_sseThemeClients;   // SSE connections for theme change notifications
     QHash<QTcpSocket*, QTimer*> m_keepAliveTimers;  // Idle timers for keep-alive connections
+    QSet<QTcpSocket*> m_streamingClients;  // Sockets with a sendStream body still going out
+    // Content coding each connection's latest request accepted. A connection
+    // is one browser, so responses still in flight from an earlier request on
+    // it are fine to encode the same way.
+    QHash<QTcpSocket*, HttpContentCoding::Coding> m_acceptedCoding;
+    QHash<QString, HttpContentCoding::EncodedAsset> m_iconAssets;  // /icons/*.svg, encoded on first request
+    quint64 m_historyGeneration = 0;   // see shotPageETag
+    const qint64 m_etagEpoch = QDateTime::currentMSecsSinceEpoch();
     // Every accepted socket, for the whole time it is alive. The other
     // containers above each hold a SUBSET once the connection has taken a shape
     // (mid-request, subscribed to SSE, idle between keep-alive requests), so
     // none of them can answer "how many clients are connected right now" — which
     // is what MAX_CONNECTIONS is enforced against. (m_pendingRequests now also
     // gets an entry at accept, before any of those shapes is known; it is
-    // removed again the moment a request completes.)
+    // removed again the moment a request completes, unless the start of a
+    // pipelined next request is already buffered behind it.)
     QSet<QTcpSocket*> m_clients;
     bool m_atConnectionLimit = false;   // true between hitting MAX_CONNECTIONS and dropping below it
     int m_refusedConnections = 0;       // refusals since the limit was last hit, reported on recovery
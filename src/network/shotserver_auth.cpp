@@ -1,6 +1,5 @@
 #include "shotserver.h"
 #include "core/appsettings.h"
-#include "webtemplates/auth_page.h"
 #include "../core/settings.h"
 
 #include <QCryptographicHash>
@@ -96,18 +95,6 @@ static bool validateTotp(const QByteArray& secret, const QString& code)
 
 // ─── Helper: extract User-Agent from request ────────────────────────────────
 
-static QString extractUserAgent(const QByteArray& request)
-{
-    QString requestStr = QString::fromUtf8(request);
-    QStringList lines = requestStr.split("\r\n");
-    for (const QString& line : lines) {
-        if (line.startsWith("User-Agent:", Qt::CaseInsensitive)) {
-            return line.mid(11).trimmed();
-        }
-    }
-    return QString();
-}
-
 // ─── Session token hashing ──────────────────────────────────────────────────
 
 static QString hashToken(const QString& token)
@@ -206,25 +193,23 @@ void ShotServer::resetTotpSecret()
 
 // ─── Web auth route handler ─────────────────────────────────────────────────
 
-void ShotServer::handleAuthRoute(QTcpSocket* socket, const QString& method, const QString& path, const QByteArray& body)
+void ShotServer::handleAuthRoute(QTcpSocket* socket, const QString& method, const QString& path, const HttpRequest& request)
 {
     if (path == "/auth/login" && method == "GET") {
-        if (hasStoredTotpSecret()) {
-            sendResponse(socket, 200, "text/html; charset=utf-8", QByteArray(WEB_AUTH_LOGIN_PAGE));
-        } else {
-            sendResponse(socket, 200, "text/html; charset=utf-8", QByteArray(WEB_AUTH_SETUP_REQUIRED_PAGE));
-        }
+        sendAsset(socket, 200, "text/html; charset=utf-8",
+                  staticPage(hasStoredTotpSecret() ? StaticPage::Login : StaticPage::SetupRequired),
+                  request.header("If-None-Match"));
     }
     else if (path == "/auth/setup-required" && method == "GET") {
-        sendResponse(socket, 200, "text/html; charset=utf-8", QByteArray(WEB_AUTH_SETUP_REQUIRED_PAGE));
+        sendAsset(socket, 200, "text/html; charset=utf-8", staticPage(StaticPage::SetupRequired),
+                  request.header("If-None-Match"));
     }
     else if (path == "/api/auth/login" && method == "POST") {
-        handleTotpLogin(socket, body);
+        handleTotpLogin(socket, request);
     }
     else if (path == "/api/auth/reset" && method == "POST") {
         // Require valid session to reset
-        QByteArray fullRequest = socket->property("fullRequest").toByteArray();
-        if (!checkSession(fullRequest)) {
+        if (!checkSession(request)) {
             sendResponse(socket, 401, "application/json", R"({"error":"Unauthorized"})");
             return;
         }
@@ -238,7 +223,7 @@ void ShotServer::handleAuthRoute(QTcpSocket* socket, const QString& method, cons
 
 // ─── TOTP login handler ─────────────────────────────────────────────────────
 
-void ShotServer::handleTotpLogin(QTcpSocket* socket, const QByteArray& body)
+void ShotServer::handleTotpLogin(QTcpSocket* socket, const HttpRequest& request)
 {
     // Rate limiting by IP
     QString clientIp = (socket->state() != QAbstractSocket::UnconnectedState)
@@ -255,7 +240,7 @@ void ShotServer::handleTotpLogin(QTcpSocket* socket, const QByteArray& body)
         return;
     }
 
-    QJsonDocument doc = QJsonDocument::fromJson(body);
+    QJsonDocument doc = QJsonDocument::fromJson(request.body());
     if (!doc.isObject()) {
         sendResponse(socket, 400, "application/json", R"({"error":"Invalid JSON"})");
         return;
@@ -280,9 +265,7 @@ void ShotServer::handleTotpLogin(QTcpSocket* socket, const QByteArray& body)
     m_loginAttempts.remove(clientIp);
 
     // Create session
-    QByteArray fullRequest = socket->property("fullRequest").toByteArray();
-    QString userAgent = extractUserAgent(fullRequest);
-    QString token = createSession(userAgent);
+    QString token = createSession(QString::fromUtf8(request.header("User-Agent")));
 
     // SameSite=Lax (not Strict) so the cookie survives the HTTP-to-HTTPS 301
     // redirect issued by HttpRedirectSslServer when a client connects via plain HTTP.
@@ -297,28 +280,9 @@ void ShotServer::handleTotpLogin(QTcpSocket* socket, const QByteArray& body)
 
 // ─── Session management (unchanged from WebAuthn version) ───────────────────
 
-QString ShotServer::extractCookie(const QByteArray& request, const QString& cookieName) const
-{
-    QString requestStr = QString::fromUtf8(request);
-    QStringList lines = requestStr.split("\r\n");
-    for (const QString& line : lines) {
-        if (line.startsWith("Cookie:", Qt::CaseInsensitive)) {
-            QString cookieStr = line.mid(7).trimmed();
-            QStringList cookies = cookieStr.split(";");
-            for (const QString& cookie : cookies) {
-                QString trimmed = cookie.trimmed();
-                if (trimmed.startsWith(cookieName + "=")) {
-                    return trimmed.mid(cookieName.length() + 1);
-                }
-            }
-        }
-    }
-    return QString();
-}
-
-bool ShotServer::checkSession(const QByteArray& request) const
+bool ShotServer::checkSession(const HttpRequest& request) const
 {
-    QString token = extractCookie(request, "decenza_session");
+    QString token = QString::fromUtf8(request.cookie("decenza_session"));
     if (token.isEmpty()) return false;
 
     QString hashed = hashToken(token);
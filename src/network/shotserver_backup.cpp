@@ -5,6 +5,7 @@
 #include "../history/shothistorystorage.h"
 #include "../ai/aiconversation.h"
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 #include "../ble/de1device.h"
 #include "../machine/machinestate.h"
 #include "../screensaver/screensavervideomanager.h"
@@ -457,9 +458,13 @@ void ShotServer::handleBackupFull(QTcpSocket* socket)
     }
     m_backupFullInProgress = true;
 
+    // An archive member is either held in memory (the JSON collected here) or
+    // streamed from `path`, `size` bytes of it, when the archive is sent.
     struct Entry {
         QByteArray name;
         QByteArray data;
+        QString path;
+        qint64 size = 0;
     };
 
     // Phase 1: Collect data that requires QObject access on the main thread
@@ -469,7 +474,7 @@ void ShotServer::handleBackupFull(QTcpSocket* socket)
     if (m_settings) {
         QJsonObject settingsJson = SettingsSerializer::exportToJson(m_settings, false);
         QByteArray settingsData = QJsonDocument(settingsJson).toJson(QJsonDocument::Indented);
-        mainThreadEntries.append({"settings.json", settingsData});
+        mainThreadEntries.append({"settings.json", settingsData, QString(), settingsData.size()});
     }
 
     // 2. AI conversations (requires m_aiManager QObject)
@@ -477,7 +482,7 @@ void ShotServer::handleBackupFull(QTcpSocket* socket)
         QJsonArray conversations = serializeAIConversations();
         if (!conversations.isEmpty()) {
             QByteArray convData = QJsonDocument(conversations).toJson(QJsonDocument::Compact);
-            mainThreadEntries.append({"ai_conversations.json", convData});
+            mainThreadEntries.append({"ai_conversations.json", convData, QString(), convData.size()});
         }
     }
 
@@ -485,7 +490,7 @@ void ShotServer::handleBackupFull(QTcpSocket* socket)
     // /api/backup/extra-settings LAN endpoint via buildExtraSettingsObject().
     {
         QByteArray extraData = QJsonDocument(buildExtraSettingsObject()).toJson(QJsonDocument::Compact);
-        mainThreadEntries.append({"extra_settings.json", extraData});
+        mainThreadEntries.append({"extra_settings.json", extraData, QString(), extraData.size()});
     }
 
     // Capture file paths for background-thread I/O
@@ -502,25 +507,29 @@ void ShotServer::handleBackupFull(QTcpSocket* socket)
     QString mediaDir = m_screensaverManager ? m_screensaverManager->personalMediaDirectory() : QString();
     QString backupDate = QDateTime::currentDateTime().toString("yyyy-MM-dd");
 
-    // Phase 2: Run file I/O and archive building on background thread
+    // Phase 2: list the files on a background thread, with their sizes, and
+    // snapshot the database. Nothing is read yet: the archive is streamed
+    // (phase 3), so a multi-hundred-MB history plus media is never in memory.
     QPointer<QTcpSocket> socketGuard(socket);
     auto destroyed = m_destroyed;
 
-    QThread* thread = QThread::create([this, mainThreadEntries = std::move(mainThreadEntries),
+    TaskExecutor::instance().submit(TaskLane::Maintenance, [this, mainThreadEntries = std::move(mainThreadEntries),
                                        dbPath, profileDirs, mediaDir, backupDate,
                                        socketGuard, destroyed]() {
         QList<Entry> entries = mainThreadEntries;
 
-        // 2. Shots database (checkpoint via temporary connection, then read file)
+        // 2. Shots database — a backup copy, so the bytes streamed are one
+        // consistent snapshot however long the download takes.
+        QString dbSnapshot;
         if (!dbPath.isEmpty()) {
-            withTempDb(dbPath, "shs_backup", [&](QSqlDatabase& db) {
-                QSqlQuery walQuery(db);
-                walQuery.exec("PRAGMA wal_checkpoint(FULL)");
-            });
-
-            QFile dbFile(dbPath);
-            if (dbFile.open(QIODevice::ReadOnly)) {
-                entries.append({"shots.db", dbFile.readAll()});
+            const QString tempPath = QStandardPaths::writableLocation(QStandardPaths::TempLocation)
+                + "/backup_full_" + QString::number(QDateTime::currentMSecsSinceEpoch()) + ".db";
+            if (!ShotHistoryStorage::createBackupStatic(dbPath, tempPath).isEmpty()) {
+                dbSnapshot = tempPath;
+                entries.append({"shots.db", QByteArray(), tempPath, QFileInfo(tempPath).size()});
+            } else {
+                qWarning() << "ShotServer: createBackupStatic failed for" << dbPath << "->" << tempPath;
+                QFile::remove(tempPath);
             }
         }
 
@@ -541,10 +550,9 @@ void ShotServer::handleBackupFull(QTcpSocket* socket)
                     QString key = (subdir.isEmpty() ? "" : subdir + "/") + fi.fileName();
                     if (seenFiles.contains(key)) continue;
                     seenFiles.insert(key);
-                    QFile f(fi.absoluteFilePath());
-                    if (f.open(QIODevice::ReadOnly)) {
+                    if (fi.isReadable()) {
                         QByteArray name = ("profiles/" + key).toUtf8();
-                        entries.append({name, f.readAll()});
+                        entries.append({name, QByteArray(), fi.absoluteFilePath(), fi.size()});
                     }
                 }
             }
@@ -557,60 +565,122 @@ void ShotServer::handleBackupFull(QTcpSocket* socket)
                 QFileInfoList files = dir.entryInfoList(QDir::Files);
                 for (const QFileInfo& fi : files) {
                     if (fi.fileName() == "index.json") continue;
-                    QFile f(fi.absoluteFilePath());
-                    if (f.open(QIODevice::ReadOnly)) {
+                    if (fi.isReadable()) {
                         QByteArray name = ("media/" + fi.fileName()).toUtf8();
-                        entries.append({name, f.readAll()});
+                        entries.append({name, QByteArray(), fi.absoluteFilePath(), fi.size()});
                     }
                 }
             }
         }
 
-        // Build binary archive
-        QByteArray archiveData;
-        QBuffer buffer(&archiveData);
-        buffer.open(QIODevice::WriteOnly);
-
-        buffer.write("DCBK", 4);
-        quint32 version = 1;
-        buffer.write(reinterpret_cast<const char*>(&version), 4);
-        quint32 count = static_cast<quint32>(entries.size());
-        buffer.write(reinterpret_cast<const char*>(&count), 4);
-
-        for (const Entry& e : entries) {
-            quint32 nameLen = static_cast<quint32>(e.name.size());
-            buffer.write(reinterpret_cast<const char*>(&nameLen), 4);
-            buffer.write(e.name);
-            quint64 dataLen = static_cast<quint64>(e.data.size());
-            buffer.write(reinterpret_cast<const char*>(&dataLen), 8);
-            buffer.write(e.data);
+        // Archive layout: "DCBK", version, entry count, then per entry its
+        // name length, name, data length and data — all sizes known now, so
+        // the response can carry a Content-Length.
+        qint64 archiveSize = 4 + 4 + 4;
+        for (const Entry& e : entries)
+            archiveSize += 4 + e.name.size() + 8 + e.size;
+
+        qDebug() << "ShotServer: Streaming backup archive with" << entries.size() << "entries,"
+                 << archiveSize << "bytes";
+
+        // Phase 3: send on the main thread, reading each piece on a worker.
+        // `finish` deletes the snapshot, so it runs on every way out. It only
+        // touches this ShotServer when it still exists, and phase 3 is queued
+        // on the application rather than on this object, so a server destroyed
+        // in between still gets to run it.
+        auto finish = [this, destroyed, dbSnapshot]() {
+            if (!dbSnapshot.isEmpty()) {
+                TaskExecutor::instance().submit(TaskLane::Background, [dbSnapshot]() {
+                    QFile::remove(dbSnapshot);
+                });
+            }
+            if (!*destroyed)
+                m_backupFullInProgress = false;
+        };
+        if (*destroyed) {
+            if (!dbSnapshot.isEmpty()) QFile::remove(dbSnapshot);
+            qDebug() << "ShotServer: Backup response dropped (server destroyed)";
+            return;
         }
-        buffer.close();
-
-        qDebug() << "ShotServer: Created backup archive with" << entries.size() << "entries,"
-                 << archiveData.size() << "bytes";
-
-        // Send response on main thread
-        QMetaObject::invokeMethod(this, [this, socketGuard, destroyed,
-                                         archiveData = std::move(archiveData), backupDate]() {
-            m_backupFullInProgress = false;  // Always reset before destroyed check
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [this, socketGuard, destroyed, finish,
+                                         entries = std::move(entries), archiveSize, backupDate]() mutable {
             if (*destroyed) {
                 qDebug() << "ShotServer: Backup response dropped (server destroyed)";
+                finish();
                 return;
             }
             if (!socketGuard) {
                 qDebug() << "ShotServer: Backup response dropped (socket disconnected)";
+                finish();
                 return;
             }
 
+            struct ArchiveStream {
+                QList<Entry> entries;
+                qsizetype index = 0;
+                qint64 offset = 0;        // into entries[index]'s data
+                bool headerSent = false;  // the archive's
+                bool entryOpen = false;   // entries[index]'s name and length sent
+            };
+            auto state = std::make_shared<ArchiveStream>();
+            state->entries = std::move(entries);
+
+            auto producer = [state](QByteArray& piece) {
+                auto appendRaw = [&piece](const auto& value) {
+                    piece.append(reinterpret_cast<const char*>(&value), sizeof(value));
+                };
+                piece.clear();
+                if (!state->headerSent) {
+                    piece.append("DCBK", 4);
+                    appendRaw(quint32(1));
+                    appendRaw(static_cast<quint32>(state->entries.size()));
+                    state->headerSent = true;
+                }
+                while (piece.size() < HttpResponseStream::kPieceSize && state->index < state->entries.size()) {
+                    Entry& e = state->entries[state->index];
+                    if (!state->entryOpen) {
+                        appendRaw(static_cast<quint32>(e.name.size()));
+                        piece.append(e.name);
+                        appendRaw(static_cast<quint64>(e.size));
+                        state->entryOpen = true;
+                        state->offset = 0;
+                    }
+                    const qint64 want = qMin(e.size - state->offset,
+                                             static_cast<qint64>(HttpResponseStream::kPieceSize - piece.size()));
+                    if (want > 0) {
+                        if (e.path.isEmpty()) {
+                            piece.append(QByteArrayView(e.data).sliced(state->offset, want));
+                        } else {
+                            QFile f(e.path);
+                            QByteArray bytes;
+                            if (f.open(QIODevice::ReadOnly) && f.seek(state->offset))
+                                bytes = f.read(want);
+                            // The length went out with the entry header; a file
+                            // that shrank since can't be sent as anything else.
+                            if (bytes.size() != want) {
+                                qWarning() << "ShotServer: Backup entry" << e.name << "changed while streaming -"
+                                           << f.errorString();
+                                return false;
+                            }
+                            piece.append(bytes);
+                        }
+                        state->offset += want;
+                    }
+                    if (state->offset >= e.size) {
+                        e.data.clear();
+                        ++state->index;
+                        state->entryOpen = false;
+                    }
+                }
+                return true;
+            };
+
             QString filename = QString("decenza_backup_%1.dcbackup").arg(backupDate);
             QByteArray extraHeaders = QString("Content-Disposition: attachment; filename=\"%1\"\r\n").arg(filename).toUtf8();
-            sendResponse(socketGuard, 200, "application/octet-stream", archiveData, extraHeaders);
+            sendStream(socketGuard, "application/octet-stream", archiveSize, std::move(producer),
+                       extraHeaders, std::move(finish));
         }, Qt::QueuedConnection);
     });
-
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
 
 QString ShotServer::generateRestorePage() const
@@ -912,10 +982,8 @@ QString ShotServer::generateRestorePage() const
     return html;
 }
 
-void ShotServer::handleBackupRestore(QTcpSocket* socket, const QString& tempFilePath, const QString& headers)
+void ShotServer::handleBackupRestore(QTcpSocket* socket, const QString& tempFilePath)
 {
-    Q_UNUSED(headers);
-
     QString tempPathToCleanup = tempFilePath;
     auto cleanupTempFile = [&tempPathToCleanup]() {
         if (!tempPathToCleanup.isEmpty() && QFile::exists(tempPathToCleanup)) {
@@ -1161,7 +1229,7 @@ void ShotServer::handleBackupRestore(QTcpSocket* socket, const QString& tempFile
         QPointer<QTcpSocket> socketGuard(socket);
         auto destroyed = m_destroyed;
 
-        QThread* thread = QThread::create([this, dbPath, shotsTempPath, socketGuard, destroyed,
+        TaskExecutor::instance().submit(TaskLane::Maintenance, [this, dbPath, shotsTempPath, socketGuard, destroyed,
                                            settingsRestored, profilesImported, profilesSkipped,
                                            mediaImported, mediaSkipped, aiConversationsImported,
                                            pendingConversations, tempPathToCleanup]() {
@@ -1274,9 +1342,6 @@ void ShotServer::handleBackupRestore(QTcpSocket* socket, const QString& tempFile
                 }
             }, Qt::QueuedConnection);
         });
-
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-        thread->start();
         return;
     }
 
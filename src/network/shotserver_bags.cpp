@@ -13,6 +13,7 @@
 #include "webtemplates/grind_datalist_js.h"
 #include "../core/yieldspec.h"
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 #include "../ai/aimanager.h"
 #include "../network/beanbaseclient.h"
 #include "../history/coffeebagstorage.h"
@@ -365,7 +366,7 @@ void ShotServer::handleBagsApi(QTcpSocket* socket, const QString& method,
             }
             const QString dbPath = bagStorage->databasePath();
             QPointer<BeanBaseClient> safeBeanbase = beanbase;
-            QThread* loadThread = QThread::create(
+            TaskExecutor::instance().submit(TaskLane::Interactive,
                 [safeThis, safeSocket, safeBeanbase, dbPath, bagId, respondJson]() {
                     QString imageKey, roastName, productUrl;
                     bool bagFound = false;
@@ -420,8 +421,6 @@ void ShotServer::handleBagsApi(QTcpSocket* socket, const QString& method,
                             }
                         }, Qt::QueuedConnection);
                 });
-            QObject::connect(loadThread, &QThread::finished, loadThread, &QObject::deleteLater);
-            loadThread->start();
             return;
         }
 
@@ -501,7 +500,7 @@ void ShotServer::handleBagsApi(QTcpSocket* socket, const QString& method,
                     // reply claimed success. The write has already landed, so
                     // the row is the post-update truth.
                     const QString photoDbPath = dbPath;
-                    QThread* photoThread = QThread::create(
+                    TaskExecutor::instance().submit(TaskLane::Interactive,
                         [photoDbPath, bagId, extractedImageUrl, safeBeanbase, respondJson]() {
                             QString canonicalId, coffeeName, link;
                             (void)withTempDb(photoDbPath, "web_bag_photo", [&](QSqlDatabase& db) {
@@ -542,8 +541,6 @@ void ShotServer::handleBagsApi(QTcpSocket* socket, const QString& method,
                                                             {"imageRefreshed", imageRefreshed}});
                                 }, Qt::QueuedConnection);
                         });
-                    QObject::connect(photoThread, &QThread::finished, photoThread, &QObject::deleteLater);
-                    photoThread->start();
                 });
             // Setting a Bean Base link propagates it onto the bag's shots, exactly
             // as the in-app edit dialog's link path does.
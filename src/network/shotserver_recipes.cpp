@@ -13,6 +13,7 @@
 #include "../controllers/maincontroller.h"
 #include "../controllers/profilemanager.h"
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 #include "../core/settings.h"
 #include "../core/settings_dye.h"
 #include "webtemplates/grind_datalist_js.h"
@@ -244,7 +245,7 @@ void ShotServer::handleRecipesApi(QTcpSocket* socket, const QString& method,
             (m_mainController && m_mainController->profileManager())
                 ? m_mainController->profileManager()->installedTitlesSnapshot()
                 : QSet<QString>();
-        QThread* t = QThread::create([dbPath, activeRecipeId, respondJson, bevByTitle, baseTempByTitle, installedTitles]() {
+        TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, activeRecipeId, respondJson, bevByTitle, baseTempByTitle, installedTitles]() {
             QJsonArray recipes;
             const bool opened = withTempDb(dbPath, "web_recipes", [&](QSqlDatabase& db) {
                 for (const InventoryRecipe& e : RecipeStorage::loadInventoryStatic(db, false))
@@ -259,8 +260,6 @@ void ShotServer::handleRecipesApi(QTcpSocket* socket, const QString& method,
                     respondJson(QJsonObject{{"recipes", recipes}, {"count", recipes.size()}});
             }, Qt::QueuedConnection);
         });
-        connect(t, &QThread::finished, t, &QThread::deleteLater);
-        t->start();
         return;
     }
 
@@ -344,7 +343,7 @@ void ShotServer::handleRecipesApi(QTcpSocket* socket, const QString& method,
         const bool hasMilk = bodyJson["hasMilk"].toBool();
         const QString fallbackSteam =
             m_mainController ? m_mainController->currentSteamSpecJson() : QString();
-        QThread* t = QThread::create([dbPath, shotId, name, hasMilkProvided, hasMilk,
+        TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, shotId, name, hasMilkProvided, hasMilk,
                                       fallbackSteam, recipeStorage, respondJson]() {
             ShotRecord record;
             const bool opened = withTempDb(dbPath, "web_recipe_promote", [&](QSqlDatabase& db) {
@@ -389,8 +388,6 @@ void ShotServer::handleRecipesApi(QTcpSocket* socket, const QString& method,
                 recipeStorage->requestCreateRecipe(fields);
             }, Qt::QueuedConnection);
         });
-        connect(t, &QThread::finished, t, &QThread::deleteLater);
-        t->start();
         return;
     }
 
@@ -418,7 +415,7 @@ void ShotServer::handleRecipesApi(QTcpSocket* socket, const QString& method,
                 (m_mainController && m_mainController->profileManager())
                     ? m_mainController->profileManager()->installedTitlesSnapshot()
                     : QSet<QString>();
-            QThread* t = QThread::create([dbPath, recipeId, activeRecipeId, respondJson, bevByTitle, baseTempByTitle, installedTitles]() {
+            TaskExecutor::instance().submit(TaskLane::Interactive, [dbPath, recipeId, activeRecipeId, respondJson, bevByTitle, baseTempByTitle, installedTitles]() {
                 QJsonObject result;
                 bool found = false;
                 const bool opened = withTempDb(dbPath, "web_recipe_get", [&](QSqlDatabase& db) {
@@ -438,8 +435,6 @@ void ShotServer::handleRecipesApi(QTcpSocket* socket, const QString& method,
                         respondJson(result);
                 }, Qt::QueuedConnection);
             });
-            connect(t, &QThread::finished, t, &QThread::deleteLater);
-            t->start();
             return;
         }
 
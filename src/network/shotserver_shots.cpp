@@ -67,7 +67,9 @@ static QString drinkTypeEmoji(const QString& drinkType)
                                        // legacy recipe with no stored type
 }
 
-QString ShotServer::generateShotListPage(const QVariantList& shots) const
+// Runs on a TaskExecutor worker: everything it reads arrives as an argument
+// (the shot count is taken on the main thread, where m_storage lives).
+QString ShotServer::generateShotListPage(const QVariantList& shots, int totalShots) const
 {
     QString rows;
     for (const QVariant& v : std::as_const(shots)) {
@@ -747,7 +749,7 @@ QString ShotServer::generateShotListPage(const QVariantList& shots) const
         <div class="header-content">
             <a href="/" class="logo">&#9749; Decenza</a>
             <div class="header-right">
-                <span class="shot-count">%1 shots</span>)HTML").arg(m_storage->totalShots());
+                <span class="shot-count">%1 shots</span>)HTML").arg(totalShots);
 
     html += generateMenuHtml(true);
 
@@ -814,7 +816,7 @@ QString ShotServer::generateShotListPage(const QVariantList& shots) const
         <button class="delete-btn" onclick="deleteSelected()">Delete</button>
         <button class="clear-btn" onclick="clearSelection()">Clear</button>
     </div>
-)HTML").arg(m_storage->totalShots())
+)HTML").arg(totalShots)
       .arg(rows.isEmpty() ? "<div class='empty-state'><h2>No shots yet</h2><p>Pull some espresso to see your history here</p></div>" : rows);
 
     // Part 11: Script - selection functions
@@ -1253,6 +1255,7 @@ QString ShotServer::generateShotListPage(const QVariantList& shots) const
     return html;
 }
 
+// Runs on a TaskExecutor worker, like generateShotListPage: no member state.
 QString ShotServer::generateShotDetailPage(qint64 shotId, const ShotProjection& shot) const
 {
     if (!shot.isValid()) {
@@ -12,6 +12,7 @@
 #include "../core/settingsserializer.h"
 #include "../ai/aimanager.h"
 #include "version.h"
+#include "../core/taskexecutor.h"
 
 #ifdef Q_OS_ANDROID
 #include <QJniObject>
@@ -312,22 +313,13 @@ QString ShotServer::generateUploadPage() const
 // Called from onReadyRead's streaming path for APK uploads. The body has already
 // been written to tempPath on disk — this renames it to the final cache location
 // without ever holding the full APK in memory on the main thread.
-void ShotServer::handleUploadFromFile(QTcpSocket* socket, const QString& tempPath, const QString& headers)
+void ShotServer::handleUploadFromFile(QTcpSocket* socket, const QString& tempPath, const HttpRequest& request)
 {
-    QString filename = "uploaded.apk";
-    for (const QString& line : headers.split("\r\n")) {
-        if (line.startsWith("X-Filename:", Qt::CaseInsensitive)) {
-            filename = line.mid(11).trimmed();
-            break;
-        }
-    }
-    filename = QFileInfo(filename).fileName();
+    QString filename = QFileInfo(QString::fromUtf8(request.header("X-Filename"))).fileName();
     if (filename.isEmpty()) filename = "uploaded.apk";
 
     if (!filename.endsWith(".apk", Qt::CaseInsensitive)) {
-        QThread* cleanup = QThread::create([tempPath]() { QFile::remove(tempPath); });
-        connect(cleanup, &QThread::finished, cleanup, &QThread::deleteLater);
-        cleanup->start();
+        TaskExecutor::instance().submit(TaskLane::Background, [tempPath]() { QFile::remove(tempPath); });
         sendResponse(socket, 400, "text/plain", "Only APK files are allowed");
         return;
     }
@@ -346,7 +338,7 @@ void ShotServer::handleUploadFromFile(QTcpSocket* socket, const QString& tempPat
     static QMutex s_apkFinalizationMutex;
     QPointer<QTcpSocket> safeSocket = socket;
     QPointer<ShotServer> safeThis = this;
-    QThread* t = QThread::create([safeThis, safeSocket, tempPath, fullPath, savePath]() {
+    TaskExecutor::instance().submit(TaskLane::Interactive, [safeThis, safeSocket, tempPath, fullPath, savePath]() {
         QDir().mkpath(savePath);
         QMutexLocker finalizeLock(&s_apkFinalizationMutex);
         // Remove stale destination, then rename (atomic on same filesystem).
@@ -368,9 +360,7 @@ void ShotServer::handleUploadFromFile(QTcpSocket* socket, const QString& tempPat
         QMetaObject::invokeMethod(safeThis, [safeThis, safeSocket, fullPath]() {
             if (!safeThis || !safeSocket) return;
             if (!safeThis->installApk(fullPath)) {
-                QThread* cleanup = QThread::create([fullPath]() { QFile::remove(fullPath); });
-                connect(cleanup, &QThread::finished, cleanup, &QThread::deleteLater);
-                cleanup->start();
+                TaskExecutor::instance().submit(TaskLane::Background, [fullPath]() { QFile::remove(fullPath); });
                 safeThis->sendResponse(safeSocket, 500, "text/plain", "Upload succeeded but install could not be dispatched");
                 return;
             }
@@ -385,8 +375,6 @@ void ShotServer::handleUploadFromFile(QTcpSocket* socket, const QString& tempPat
             safeThis->sendResponse(safeSocket, 200, "text/plain", "APK dispatched to PackageInstaller — check device screen for installation prompt");
         }, Qt::QueuedConnection);
     });
-    connect(t, &QThread::finished, t, &QThread::deleteLater);
-    t->start();
 }
 
 
@@ -1024,24 +1012,18 @@ winget install OliverBetz.ExifTool</pre>
     return html;
 }
 
-void ShotServer::handleMediaUpload(QTcpSocket* socket, const QString& uploadedTempPath, const QString& headers)
+void ShotServer::handleMediaUpload(QTcpSocket* socket, const QString& uploadedTempPath, const HttpRequest& request)
 {
     if (!m_screensaverManager) {
         sendResponse(socket, 500, "text/plain", "Screensaver manager not available");
-        QThread* t = QThread::create([uploadedTempPath]() { QFile::remove(uploadedTempPath); });
-        connect(t, &QThread::finished, t, &QThread::deleteLater);
-        t->start();
+        TaskExecutor::instance().submit(TaskLane::Background, [uploadedTempPath]() { QFile::remove(uploadedTempPath); });
         return;
     }
 
     // Get filename from X-Filename header (URL-encoded)
     QString filename = "uploaded_media";
-    for (const QString& line : headers.split("\r\n")) {
-        if (line.startsWith("X-Filename:", Qt::CaseInsensitive)) {
-            filename = QUrl::fromPercentEncoding(line.mid(11).trimmed().toUtf8());
-            break;
-        }
-    }
+    if (request.hasHeader("X-Filename"))
+        filename = QUrl::fromPercentEncoding(request.header("X-Filename").toByteArray());
 
     // Validate file type — fast check before dispatching background work
     QString ext = QFileInfo(filename).suffix().toLower();
@@ -1050,24 +1032,25 @@ void ShotServer::handleMediaUpload(QTcpSocket* socket, const QString& uploadedTe
 
     if (!isImage && !isVideo) {
         sendResponse(socket, 400, "text/plain", "Unsupported file type. Use JPG, PNG, GIF, WebP, MP4, or WebM.");
-        QThread* t = QThread::create([uploadedTempPath]() { QFile::remove(uploadedTempPath); });
-        connect(t, &QThread::finished, t, &QThread::deleteLater);
-        t->start();
+        TaskExecutor::instance().submit(TaskLane::Background, [uploadedTempPath]() { QFile::remove(uploadedTempPath); });
         return;
     }
 
     // Check for duplicate before doing expensive resize work
     if (m_screensaverManager->hasPersonalMediaWithName(filename)) {
         sendResponse(socket, 409, "text/plain", "File already exists: " + filename.toUtf8());
-        QThread* t = QThread::create([uploadedTempPath]() { QFile::remove(uploadedTempPath); });
-        connect(t, &QThread::finished, t, &QThread::deleteLater);
-        t->start();
+        TaskExecutor::instance().submit(TaskLane::Background, [uploadedTempPath]() { QFile::remove(uploadedTempPath); });
         return;
     }
 
     QPointer<QTcpSocket> safeSocket = socket;
     QPointer<ShotServer> safeThis = this;
-    QThread* worker = QThread::create([safeThis, safeSocket, uploadedTempPath, filename, ext, isImage, isVideo]() {
+    // A video is transcoded by ffmpeg, blocking its worker for up to five
+    // minutes (resizeVideo), so it goes on the capped Maintenance lane and can
+    // never hold the workers that page and API requests need. An image resize
+    // is short and someone is waiting on it.
+    const TaskLane lane = isVideo ? TaskLane::Maintenance : TaskLane::Interactive;
+    TaskExecutor::instance().submit(lane, [safeThis, safeSocket, uploadedTempPath, filename, ext, isImage, isVideo]() {
         auto sendErr = [&](int code, const QByteArray& msg) {
             QMetaObject::invokeMethod(safeThis, [safeThis, safeSocket, code, msg]() {
                 if (safeThis && safeSocket) safeThis->sendResponse(safeSocket, code, "text/plain", msg);
@@ -1123,23 +1106,17 @@ void ShotServer::handleMediaUpload(QTcpSocket* socket, const QString& uploadedTe
         // Add to screensaver — must be done on the main thread (QObject)
         QMetaObject::invokeMethod(safeThis, [safeThis, safeSocket, outputPath, filename, mediaDate]() {
             if (!safeThis || !safeSocket) {
-                QThread* t = QThread::create([outputPath]() { QFile::remove(outputPath); });
-                connect(t, &QThread::finished, t, &QThread::deleteLater);
-                t->start();
+                TaskExecutor::instance().submit(TaskLane::Background, [outputPath]() { QFile::remove(outputPath); });
                 return;
             }
             if (safeThis->m_screensaverManager->addPersonalMedia(outputPath, filename, mediaDate)) {
                 safeThis->sendResponse(safeSocket, 200, "text/plain", "Media uploaded successfully");
             } else {
-                QThread* t = QThread::create([outputPath]() { QFile::remove(outputPath); });
-                connect(t, &QThread::finished, t, &QThread::deleteLater);
-                t->start();
+                TaskExecutor::instance().submit(TaskLane::Background, [outputPath]() { QFile::remove(outputPath); });
                 safeThis->sendResponse(safeSocket, 500, "text/plain", "Failed to add media to screensaver");
             }
         }, Qt::QueuedConnection);
     });
-    connect(worker, &QThread::finished, worker, &QThread::deleteLater);
-    worker->start();
 }
 
 bool ShotServer::resizeImage(const QString& inputPath, const QString& outputPath, int maxWidth, int maxHeight)
@@ -9,6 +9,7 @@
 
 #include <QtQml/qqmlregistration.h>
 class MainController;
+class VisualizerShotRecovery;
 class ProfileSaveHelper;
 class Settings;
 class TranslationManager;
@@ -42,7 +43,7 @@ public:
     bool isFetching() const { return m_fetching; }
     QString lastError() const { return m_lastError; }
     QVariantList sharedShots() const { return m_sharedShots; }
-    bool isRecovering() const { return m_recovering; }
+    bool isRecovering() const;
 
     // Import profile from a Visualizer shot ID
     Q_INVOKABLE void importFromShotId(const QString& shotId);
@@ -74,21 +75,30 @@ public:
     // Pulls the user's own FULL shot records (telemetry + metadata) from
     // visualizer.coffee back into local history, for shots whose start time
     // falls within [fromEpoch, toEpoch] (Unix seconds, inclusive). Async and
-    // non-blocking. The recovery:
+    // non-blocking; the run itself is a VisualizerShotRecovery (see
+    // visualizershotrecovery.h), which:
     //   1. pages GET /api/shots (authenticated => the user's own shots),
     //      filtering by each entry's `clock`;
-    //   2. for each in-range shot, downloads the full record
+    //   2. downloads several in-window shots at once, each its full record
     //      (GET /api/shots/{id}/download) and its profile
     //      (GET /api/shots/{id}/profile?format=json);
-    //   3. parses via ShotFileParser::parseVisualizerShot and inserts (on a
-    //      background DB thread via importShotRecordAsync), which DEDUPES against
-    //      local history (by visualizer_id, then uuid, then timestamp+profile) so
-    //      a shot the user still has is skipped and re-running is idempotent.
+    //   3. parses them on worker threads via ShotFileParser::parseVisualizerShot
+    //      and inserts them in batches on the DB thread (importShotRecordsAsync),
+    //      which DEDUPES against local history (by visualizer_id, then uuid,
+    //      then timestamp+profile) so a shot the user still has is skipped and
+    //      re-running is idempotent.
     // Emits recoveryProgress after each shot and recoveryComplete when done.
-    // Requires Visualizer credentials; fails clearly via recoveryFailed if
-    // they are not configured. A no-op if a recovery is already running.
+    // Progress is checkpointed in settings: a run interrupted part way (the
+    // app closed) picks up where it stopped the next time the same range is
+    // recovered. Requires Visualizer credentials; fails clearly via
+    // recoveryFailed if they are not configured. A no-op if a recovery is
+    // already running.
     Q_INVOKABLE void recoverShots(qint64 fromEpoch, qint64 toEpoch);
 
+    // Stop a running recovery. What it already wrote stays, and its
+    // checkpoint lets the same range resume later. Ends with recoveryCancelled.
+    Q_INVOKABLE void cancelRecovery();
+
 signals:
     void importingChanged();
     void lastErrorChanged();
@@ -104,12 +114,16 @@ signals:
     // Fired once the in-range shot list is known (total) and then after each
     // shot is processed: imported so far, skipped as already-present, failed.
     void recoveryProgress(int total, int imported, int skipped, int failed);
-    // Terminal success: final counts. imported+skipped+failed == total.
+    // Terminal success: final counts. imported+skipped+failed == total
+    // (for a resumed run, the counts include the earlier part).
     void recoveryComplete(int total, int imported, int skipped, int failed);
     // Terminal failure before per-shot processing (no credentials, list
     // fetch error). Per-shot failures do NOT abort the batch — they are
     // counted in `failed` and surfaced via recoveryComplete.
     void recoveryFailed(const QString& error);
+    // Terminal: the run was stopped by cancelRecovery(). Retrieving the same
+    // range again resumes from its checkpoint.
+    void recoveryCancelled();
 
 private slots:
     void onFetchFinished(QNetworkReply* reply);
@@ -126,39 +140,9 @@ private:
     // falling back to the English source when none is set.
     QString tr_(const char* key, const char* fallback) const;
 
-    // --- Recovery internals ---
-    // A shot to recover: its Visualizer id and start time (from the list).
-    struct RecoveryShot {
-        QString visualizerId;
-        qint64 clockEpoch = 0;
-    };
-    // Page GET /api/shots collecting in-window ids, then start downloads.
-    void recoverFetchListPage(int page);
-    // Advance to the next queued shot (resets the per-shot retry counter) and
-    // kick off its download.
-    void recoverNextShot();
-    // Download the current shot's full record (with bounded transient retry) +
-    // profile, then parse and insert.
-    void recoverDownloadCurrent();
-    // Finish the run: emit recoveryComplete and reset state.
-    void finishRecovery();
-
-    // Recovery state (single run at a time — guarded by m_recovering).
-    bool m_recovering = false;
-    qint64 m_recoverFromEpoch = 0;
-    qint64 m_recoverToEpoch = 0;
-    QVector<RecoveryShot> m_recoverQueue;   // in-window shots still to fetch
-    RecoveryShot m_recoverCurrent;          // shot whose download is in flight
-    int m_recoverAttempts = 0;              // download attempts for m_recoverCurrent (bounded retry)
-    int m_recoverTotal = 0;
-    int m_recoverImported = 0;
-    int m_recoverSkipped = 0;
-    int m_recoverFailed = 0;
-
-    static constexpr const char* VISUALIZER_SHOT_DOWNLOAD_API =
-        "https://visualizer.coffee/api/shots/%1/download";
-    static constexpr const char* VISUALIZER_SHOTS_LIST_API =
-        "https://visualizer.coffee/api/shots";
+    // The recovery run, created on first use (MainController's shot history
+    // isn't there yet when this is constructed).
+    VisualizerShotRecovery* m_recovery = nullptr;
 
     // Fetch profile details for shared shots (chained after fetchSharedShots)
     void fetchProfileDetailsForShots();
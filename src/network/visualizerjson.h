@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QByteArray>
+#include <QRegularExpression>
+#include <QString>
+
+// Sanitize JSON to fix malformed numbers from Visualizer API
+// Fixes: .5 -> 0.5, 9. -> 9.0
+//
+// visualizer.coffee can emit these tokens, which QJsonDocument rejects
+// outright, in profiles and shot downloads alike. Shared by VisualizerImporter
+// and VisualizerShotRecovery; the latter calls it from TaskExecutor workers,
+// which is why the expressions are function-local statics (matching a const
+// QRegularExpression is thread-safe).
+inline QByteArray sanitizeVisualizerJson(const QByteArray& data)
+{
+    static const QRegularExpression leadingPoint(QStringLiteral(R"(([:,\[]\s*)\.(\d))"));
+    static const QRegularExpression trailingPoint(QStringLiteral(R"((\d)\.([,\]\s}]))"));
+
+    QString jsonStr = QString::fromUtf8(data);
+
+    // Fix numbers starting with decimal point (e.g., .5 -> 0.5)
+    jsonStr.replace(leadingPoint, "\\10.\\2");
+
+    // Fix numbers ending with decimal point (e.g., 9. -> 9.0)
+    jsonStr.replace(trailingPoint, "\\1.0\\2");
+
+    return jsonStr.toUtf8();
+}
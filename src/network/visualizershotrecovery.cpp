@@ -0,0 +1,487 @@
+#include "visualizershotrecovery.h"
+#include "visualizerjson.h"
+#include "visualizershotlist.h"
+#include "../history/shotfileparser.h"
+#include "../history/shothistorystorage.h"
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QUrl>
+#include <QDebug>
+
+#include <algorithm>
+
+namespace {
+constexpr auto kVisualizerBaseUrl = "https://visualizer.coffee";
+}  // namespace
+
+QVariantMap VisualizerShotRecovery::Checkpoint::toVariantMap() const
+{
+    return {
+        {QStringLiteral("from"), fromEpoch},
+        {QStringLiteral("to"), toEpoch},
+        {QStringLiteral("settledThroughClock"), settledThroughClock},
+        {QStringLiteral("imported"), imported},
+        {QStringLiteral("skipped"), skipped},
+        {QStringLiteral("failed"), failed},
+    };
+}
+
+VisualizerShotRecovery::Checkpoint VisualizerShotRecovery::Checkpoint::fromVariantMap(const QVariantMap& map)
+{
+    Checkpoint checkpoint;
+    checkpoint.fromEpoch = map.value(QStringLiteral("from")).toLongLong();
+    checkpoint.toEpoch = map.value(QStringLiteral("to")).toLongLong();
+    checkpoint.settledThroughClock = map.value(QStringLiteral("settledThroughClock")).toLongLong();
+    checkpoint.imported = map.value(QStringLiteral("imported")).toInt();
+    checkpoint.skipped = map.value(QStringLiteral("skipped")).toInt();
+    checkpoint.failed = map.value(QStringLiteral("failed")).toInt();
+    return checkpoint;
+}
+
+VisualizerShotRecovery::VisualizerShotRecovery(QNetworkAccessManager* networkManager,
+                                               ShotHistoryStorage* storage, QObject* parent)
+    : QObject(parent)
+    , m_networkManager(networkManager)
+    , m_storage(storage)
+    , m_baseUrl(QString::fromLatin1(kVisualizerBaseUrl))
+{
+    Q_ASSERT(networkManager);
+}
+
+VisualizerShotRecovery::~VisualizerShotRecovery()
+{
+    *m_destroyed = true;
+    m_cancelled = true;
+    m_cancelToken.cancel();
+    // Abort so the transfers don't run on with nobody to read them. abort()
+    // emits finished synchronously and the handlers are still connected here,
+    // so disconnect them first: they would take the abort for a transient
+    // failure and retry, or build and start the next downloads.
+    const QSet<QNetworkReply*> replies = m_replies;
+    for (QNetworkReply* reply : replies) {
+        disconnect(reply, nullptr, this, nullptr);
+        reply->abort();
+        reply->deleteLater();
+    }
+}
+
+void VisualizerShotRecovery::start(qint64 fromEpoch, qint64 toEpoch, const QByteArray& authHeader,
+                                   const Checkpoint& resume)
+{
+    if (m_running) {
+        qWarning() << "VisualizerShotRecovery: recovery already in progress";
+        return;
+    }
+
+    // Normalise the range (tolerate a swapped from/to).
+    m_fromEpoch = qMin(fromEpoch, toEpoch);
+    m_toEpoch = qMax(fromEpoch, toEpoch);
+    m_authHeader = authHeader;
+    m_resume = resume;
+
+    m_shots.clear();
+    m_outcomes.clear();
+    m_nextShot = 0;
+    m_settledPrefix = 0;
+    m_downloading = 0;
+    m_building = 0;
+    m_writing = false;
+    m_built.clear();
+    m_builtIndex.clear();
+    m_checkpointClock = 0;
+    m_prefixImported = 0;
+    m_prefixSkipped = 0;
+    m_prefixFailed = 0;
+    m_total = 0;
+    m_imported = 0;
+    m_skipped = 0;
+    m_failed = 0;
+    m_cancelled = false;
+    m_cancelToken = CancellationToken::create();
+
+    m_running = true;
+    emit runningChanged();
+
+    fetchListPage(1);
+}
+
+void VisualizerShotRecovery::cancel()
+{
+    if (!m_running || m_cancelled) return;
+    m_cancelled = true;
+    m_cancelToken.cancel();
+
+    // abort() finishes a reply synchronously, and its handler may end the
+    // run — iterate a copy.
+    const QSet<QNetworkReply*> replies = m_replies;
+    for (QNetworkReply* reply : replies)
+        reply->abort();
+}
+
+QNetworkReply* VisualizerShotRecovery::get(const QString& pathAndQuery)
+{
+    QNetworkRequest request(QUrl(m_baseUrl + pathAndQuery));
+    request.setRawHeader("Authorization", m_authHeader);
+    request.setRawHeader("Accept", "application/json");
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute,
+                         QNetworkRequest::NoLessSafeRedirectPolicy);
+
+    QNetworkReply* reply = m_networkManager->get(request);
+    m_replies.insert(reply);
+    return reply;
+}
+
+void VisualizerShotRecovery::fetchListPage(int page)
+{
+    // GET /api/shots?page=N&items=100 — authenticated => the user's own shots.
+    // The page body is processed by the shared VisualizerShotList::processPage
+    // (see visualizershotlist.h): it parses the response, filters each entry's
+    // `clock` against the window, and returns a verdict (keep paging / done /
+    // fail). The same helper drives the uploader's back-sync, so the paging /
+    // early-stop / ceiling policy lives in exactly one place.
+    QNetworkReply* reply = get(QStringLiteral("/api/shots?page=%1&items=%2").arg(page).arg(kItemsPerPage));
+    connect(reply, &QNetworkReply::finished, this, [this, reply, page]() {
+        m_replies.remove(reply);
+        reply->deleteLater();
+
+        if (m_cancelled) {
+            finish();
+            return;
+        }
+
+        auto fail = [this](ListError error, int httpStatus, const QString& detail) {
+            m_running = false;
+            emit runningChanged();
+            emit listFailed(error, httpStatus, detail);
+        };
+
+        if (reply->error() != QNetworkReply::NoError) {
+            fail(ListError::Network, reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+                 reply->errorString());
+            return;
+        }
+
+        using namespace VisualizerShotList;
+        const PageResult pr = processPage(reply->readAll(), page, kMaxPages, m_fromEpoch, m_toEpoch);
+        switch (pr.reason) {
+        case FailReason::ParseError:
+            fail(ListError::Parse, 200, pr.parseError);
+            return;
+        case FailReason::MissingPaging:
+            fail(ListError::Envelope, 200, QString());
+            return;
+        case FailReason::PageCeiling:
+            fail(ListError::TooManyShots, 200, QString());
+            return;
+        case FailReason::None:
+            break;
+        }
+
+        for (const Entry& e : pr.inWindow)
+            m_shots.append({e.visualizerId, e.clockEpoch});
+
+        if (pr.verdict == Verdict::Done) {
+            beginShots();
+            return;
+        }
+        fetchListPage(page + 1);
+    });
+}
+
+void VisualizerShotRecovery::beginShots()
+{
+    // Oldest first, so "every shot up to start time T is settled" is one
+    // number however far the run got.
+    std::stable_sort(m_shots.begin(), m_shots.end(), [](const Shot& a, const Shot& b) {
+        return a.clockEpoch < b.clockEpoch;
+    });
+
+    if (m_resume.covers(m_fromEpoch, m_toEpoch)) {
+        const auto firstUnsettled = std::upper_bound(
+            m_shots.begin(), m_shots.end(), m_resume.settledThroughClock,
+            [](qint64 clock, const Shot& shot) { return clock < shot.clockEpoch; });
+        const qsizetype resumed = firstUnsettled - m_shots.begin();
+        m_shots.erase(m_shots.begin(), firstUnsettled);
+
+        m_imported = m_resume.imported;
+        m_skipped = m_resume.skipped;
+        m_failed = m_resume.failed;
+        m_checkpointClock = m_resume.settledThroughClock;
+        qDebug() << "VisualizerShotRecovery: resuming -" << resumed << "shots already settled,"
+                 << m_shots.size() << "to go";
+    } else {
+        m_resume = {};
+    }
+
+    m_outcomes.assign(size_t(m_shots.size()), Outcome::Pending);
+    m_total = m_imported + m_skipped + m_failed + static_cast<int>(m_shots.size());
+    emitProgress();
+    pump();
+}
+
+void VisualizerShotRecovery::pump()
+{
+    if (!m_running) return;
+
+    if (m_cancelled) {
+        // Built but not yet written: dropped, like the shots never reached.
+        m_built.clear();
+        m_builtIndex.clear();
+        if (m_downloading == 0 && m_building == 0 && !m_writing) finish();
+        return;
+    }
+
+    if (!m_writing && !m_built.isEmpty())
+        writeBatch();
+
+    // Every record waiting for the writer holds its curves; stop downloading
+    // ahead of a writer that has fallen that far behind.
+    // (writeBatch() may have run a listener that cancelled.)
+    while (!m_cancelled && m_downloading < m_concurrency && m_nextShot < m_shots.size()
+           && m_building + m_built.size() < kMaxBuffered) {
+        ++m_downloading;
+        download(m_nextShot++, 0);
+    }
+
+    if (m_downloading == 0 && m_building == 0 && !m_writing && m_built.isEmpty()
+        && m_nextShot >= m_shots.size())
+        finish();
+}
+
+void VisualizerShotRecovery::download(qsizetype index, int attempt)
+{
+    // The full shot record (telemetry + metadata). A transient network/server
+    // failure is retried a bounded number of times (mirrors the uploader's
+    // transient-retry policy) so one blip mid-run doesn't permanently drop an
+    // otherwise-recoverable shot; a definitive client error (4xx, e.g. a
+    // deleted shot) is not retried.
+    QNetworkReply* reply = get(QStringLiteral("/api/shots/%1/download").arg(m_shots[index].visualizerId));
+    connect(reply, &QNetworkReply::finished, this, [this, reply, index, attempt]() {
+        m_replies.remove(reply);
+        reply->deleteLater();
+
+        if (m_cancelled) {
+            --m_downloading;
+            pump();
+            return;
+        }
+
+        if (reply->error() != QNetworkReply::NoError) {
+            const int sc = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+            const bool transient = (sc == 0 || sc >= 500);  // transport error or 5xx
+            if (transient && attempt + 1 < kMaxDownloadAttempts) {
+                qWarning() << "VisualizerShotRecovery: shot download transient failure for"
+                           << m_shots[index].visualizerId << reply->errorString()
+                           << "- retrying" << (attempt + 1) << "of" << (kMaxDownloadAttempts - 1);
+                download(index, attempt + 1);
+                return;
+            }
+            qWarning() << "VisualizerShotRecovery: shot download failed for"
+                       << m_shots[index].visualizerId << reply->errorString();
+            --m_downloading;
+            settle(index, Outcome::Failed);
+            emitProgress();
+            pump();
+            return;
+        }
+
+        fetchProfile(index, reply->readAll());
+    });
+}
+
+void VisualizerShotRecovery::fetchProfile(qsizetype index, const QByteArray& shotBody)
+{
+    // The download carries only a profile_url. The profile is best-effort —
+    // a shot with no profile still imports.
+    QNetworkReply* reply = get(QStringLiteral("/api/shots/%1/profile?format=json")
+                                   .arg(m_shots[index].visualizerId));
+    connect(reply, &QNetworkReply::finished, this, [this, reply, index, shotBody]() {
+        m_replies.remove(reply);
+        reply->deleteLater();
+        --m_downloading;
+
+        if (m_cancelled) {
+            pump();
+            return;
+        }
+
+        QByteArray profileBody;
+        if (reply->error() == QNetworkReply::NoError)
+            profileBody = reply->readAll();
+        else
+            qWarning() << "VisualizerShotRecovery: profile fetch failed for"
+                       << m_shots[index].visualizerId << reply->errorString()
+                       << "- importing shot without a profile";
+
+        build(index, shotBody, profileBody);
+        pump();
+    });
+}
+
+void VisualizerShotRecovery::build(qsizetype index, const QByteArray& shotBody, const QByteArray& profileBody)
+{
+    ++m_building;
+
+    struct Built {
+        ShotFileParser::ParseResult result;
+        QString error;
+    };
+    auto built = std::make_shared<Built>();
+    const Shot shot = m_shots[index];
+    const CancellationToken cancel = m_cancelToken;
+    auto destroyed = m_destroyed;
+
+    // The token is checked here rather than handed to the executor: a task
+    // the executor drops would never hand its shot back, and the run would
+    // never end.
+    TaskExecutor::instance().submit(TaskLane::Background,
+        [this, index, shot, shotBody, profileBody, built, cancel, destroyed]() {
+            if (!cancel.isCancelled()) {
+                // Sanitize first: visualizer.coffee can emit the malformed
+                // number tokens (.5, 9.) that QJsonDocument rejects outright,
+                // which would otherwise drop the whole shot.
+                QJsonParseError perr{};
+                const QJsonDocument doc = QJsonDocument::fromJson(sanitizeVisualizerJson(shotBody), &perr);
+                if (perr.error != QJsonParseError::NoError || !doc.isObject()) {
+                    built->error = QStringLiteral("shot parse error: ") + perr.errorString();
+                } else {
+                    built->result = ShotFileParser::parseVisualizerShot(
+                        doc.object(), QString::fromUtf8(profileBody), shot.visualizerId, shot.clockEpoch);
+                    if (!built->result.success)
+                        built->error = QStringLiteral("could not build shot record: ") + built->result.errorMessage;
+                }
+            }
+            if (*destroyed) return;
+
+            QMetaObject::invokeMethod(this, [this, index, shot, built, destroyed]() {
+                if (*destroyed) return;
+                --m_building;
+                if (!m_cancelled) {
+                    if (built->error.isEmpty()) {
+                        m_built.append(std::move(built->result.record));
+                        m_builtIndex.append(index);
+                    } else {
+                        qWarning() << "VisualizerShotRecovery:" << built->error << "for" << shot.visualizerId;
+                        settle(index, Outcome::Failed);
+                        emitProgress();
+                    }
+                }
+                pump();
+            }, Qt::QueuedConnection);
+        });
+}
+
+void VisualizerShotRecovery::writeBatch()
+{
+    const qsizetype count = qMin<qsizetype>(m_built.size(), kMaxInsertBatch);
+    const QList<ShotRecord> records = m_built.mid(0, count);
+    const QVector<qsizetype> indices = m_builtIndex.mid(0, count);
+    m_built.remove(0, count);
+    m_builtIndex.remove(0, count);
+
+    m_writing = true;
+    if (!m_storage) {
+        for (const qsizetype index : indices)
+            settle(index, Outcome::Failed);
+        m_writing = false;
+        emitProgress();
+        return;
+    }
+
+    // overwriteExisting = false => shots already in history are skipped
+    // (deduped by visualizer_id, then uuid, then timestamp + profile), which
+    // is exactly the idempotent recovery we want.
+    auto destroyed = m_destroyed;
+    m_storage->importShotRecordsAsync(records, false,
+        [this, destroyed, indices](const QList<qint64>& resultCodes) {
+            if (*destroyed) return;
+            // m_writing stays set until every index is settled: a checkpoint
+            // listener may cancel(), and the run must not finish (and drop
+            // m_outcomes) under this loop.
+            for (qsizetype i = 0; i < indices.size(); ++i) {
+                const qint64 shotId = i < resultCodes.size() ? resultCodes[i] : -1;
+                if (shotId > 0)       settle(indices[i], Outcome::Imported);
+                else if (shotId == 0) settle(indices[i], Outcome::Skipped);   // duplicate
+                else                  settle(indices[i], Outcome::Failed);    // DB error
+            }
+            m_writing = false;
+            emitProgress();
+            pump();
+        });
+}
+
+void VisualizerShotRecovery::settle(qsizetype index, Outcome outcome)
+{
+    m_outcomes[size_t(index)] = outcome;
+    switch (outcome) {
+    case Outcome::Imported: m_imported++; break;
+    case Outcome::Skipped:  m_skipped++; break;
+    case Outcome::Failed:   m_failed++; break;
+    case Outcome::Pending:  break;
+    }
+
+    const qsizetype before = m_settledPrefix;
+    while (m_settledPrefix < m_shots.size() && m_outcomes[size_t(m_settledPrefix)] != Outcome::Pending) {
+        switch (m_outcomes[size_t(m_settledPrefix)]) {
+        case Outcome::Imported: m_prefixImported++; break;
+        case Outcome::Skipped:  m_prefixSkipped++; break;
+        case Outcome::Failed:   m_prefixFailed++; break;
+        case Outcome::Pending:  break;
+        }
+        ++m_settledPrefix;
+    }
+    if (m_settledPrefix == before) return;
+
+    // The checkpoint is a start time, so it can only cover a shot whose
+    // start-time twins are settled too: back off past any that share the
+    // first unsettled shot's.
+    qsizetype covered = m_settledPrefix;
+    while (covered > 0 && covered < m_shots.size()
+           && m_shots[covered - 1].clockEpoch == m_shots[covered].clockEpoch)
+        --covered;
+    if (covered == 0 || m_shots[covered - 1].clockEpoch == m_checkpointClock) return;
+
+    Checkpoint checkpoint;
+    checkpoint.fromEpoch = m_fromEpoch;
+    checkpoint.toEpoch = m_toEpoch;
+    checkpoint.settledThroughClock = m_shots[covered - 1].clockEpoch;
+    checkpoint.imported = m_resume.imported + m_prefixImported;
+    checkpoint.skipped = m_resume.skipped + m_prefixSkipped;
+    checkpoint.failed = m_resume.failed + m_prefixFailed;
+    for (qsizetype i = covered; i < m_settledPrefix; ++i) {
+        switch (m_outcomes[size_t(i)]) {
+        case Outcome::Imported: checkpoint.imported--; break;
+        case Outcome::Skipped:  checkpoint.skipped--; break;
+        case Outcome::Failed:   checkpoint.failed--; break;
+        case Outcome::Pending:  break;
+        }
+    }
+    m_checkpointClock = checkpoint.settledThroughClock;
+    emit checkpointChanged(checkpoint);
+}
+
+void VisualizerShotRecovery::emitProgress()
+{
+    emit progress(m_total, m_imported, m_skipped, m_failed);
+}
+
+void VisualizerShotRecovery::finish()
+{
+    if (!m_running) return;
+
+    if (m_storage)
+        m_storage->refreshTotalShots();
+
+    m_running = false;
+    m_shots.clear();
+    m_outcomes.clear();
+    emit runningChanged();
+
+    if (m_cancelled)
+        emit cancelled();
+    else
+        emit finished(m_total, m_imported, m_skipped, m_failed);
+}
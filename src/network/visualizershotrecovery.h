@@ -0,0 +1,170 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QVariantMap>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "../core/taskexecutor.h"
+#include "../history/shothistory_types.h"
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class ShotHistoryStorage;
+
+/**
+ * One "Recover shots from Visualizer" run: the date-window history import
+ * behind VisualizerImporter::recoverShots.
+ *
+ * The run lists the user's shots in the window (GET /api/shots, paged through
+ * VisualizerShotList::processPage), then recovers them oldest first as a
+ * pipeline rather than one shot at a time:
+ *   - up to concurrency() shots are downloading at once, each its full record
+ *     (GET /api/shots/{id}/download) and then its profile;
+ *   - a downloaded body is sanitized, parsed and built into a ShotRecord
+ *     (ShotFileParser::parseVisualizerShot) on a TaskExecutor Background worker;
+ *   - built records go to the storage's serial DB worker in batches
+ *     (importShotRecordsAsync), one batch in flight. Whatever was built while
+ *     the last batch was being written is the next batch, so batches grow
+ *     exactly when the writer is the slow stage.
+ * Downloads stop being started while kMaxBuffered records wait for the writer.
+ *
+ * Progress is checkpointed for an interrupted run (the app closed, the tablet
+ * slept): checkpointChanged() reports the newest start time up to which every
+ * shot in the window has been settled, with the counts so far. start() given
+ * that checkpoint for the same window skips those shots and carries the counts
+ * on. A checkpoint never runs ahead of a shot it hasn't settled, and importing
+ * dedupes, so the worst a stale one costs is re-downloading a few shots.
+ */
+class VisualizerShotRecovery : public QObject {
+    Q_OBJECT
+
+public:
+    struct Checkpoint {
+        qint64 fromEpoch = 0;
+        qint64 toEpoch = 0;
+        // Every in-window shot with a start time <= this has been settled.
+        qint64 settledThroughClock = 0;
+        int imported = 0;
+        int skipped = 0;
+        int failed = 0;
+
+        bool isValid() const { return settledThroughClock > 0; }
+        bool covers(qint64 from, qint64 to) const { return isValid() && fromEpoch == from && toEpoch == to; }
+        QVariantMap toVariantMap() const;
+        static Checkpoint fromVariantMap(const QVariantMap& map);
+    };
+
+    // Why listing failed. Per-shot failures never stop the run; they are
+    // counted in `failed`.
+    enum class ListError {
+        Network,      // transport error or HTTP error status
+        Parse,        // the page was not JSON
+        Envelope,     // 200 without paging — usually an auth/error envelope
+        TooManyShots  // the window reaches past the page ceiling
+    };
+    Q_ENUM(ListError)
+
+    static constexpr int kDefaultConcurrency = 4;
+    static constexpr int kMaxInsertBatch = 32;
+    static constexpr int kMaxBuffered = 2 * kMaxInsertBatch;
+    static constexpr int kMaxPages = 50;        // 50 * 100 = 5000 shots hard cap
+    static constexpr int kItemsPerPage = 100;
+    static constexpr int kMaxDownloadAttempts = 3;   // 1 initial + up to 2 retries
+
+    VisualizerShotRecovery(QNetworkAccessManager* networkManager, ShotHistoryStorage* storage,
+                           QObject* parent = nullptr);
+    ~VisualizerShotRecovery() override;
+
+    // https://visualizer.coffee by default; tests point it at a local stand-in.
+    void setBaseUrl(const QString& baseUrl) { m_baseUrl = baseUrl; }
+    void setConcurrency(int concurrency) { m_concurrency = qMax(1, concurrency); }
+    int concurrency() const { return m_concurrency; }
+
+    bool isRunning() const { return m_running; }
+
+    // Recover the shots whose start time is in [fromEpoch, toEpoch] (Unix
+    // seconds, inclusive). `resume` is honoured only when it covers exactly
+    // this window. A no-op while a run is in progress.
+    void start(qint64 fromEpoch, qint64 toEpoch, const QByteArray& authHeader,
+               const Checkpoint& resume = {});
+
+    // Abort downloads in flight and stop once the batch being written lands.
+    // Shots not yet written stay outside the checkpoint. Emits cancelled().
+    void cancel();
+
+signals:
+    void runningChanged();
+    // Once the window's shots are listed, then after every shot settles:
+    // imported, skipped as already present, failed.
+    void progress(int total, int imported, int skipped, int failed);
+    void checkpointChanged(const VisualizerShotRecovery::Checkpoint& checkpoint);
+    // imported + skipped + failed == total.
+    void finished(int total, int imported, int skipped, int failed);
+    void listFailed(VisualizerShotRecovery::ListError error, int httpStatus, const QString& detail);
+    void cancelled();
+
+private:
+    struct Shot {
+        QString visualizerId;
+        qint64 clockEpoch = 0;
+    };
+    enum class Outcome : quint8 { Pending, Imported, Skipped, Failed };
+
+    void fetchListPage(int page);
+    void beginShots();
+    // Starts whatever stage has room; ends the run once nothing is left.
+    void pump();
+    void download(qsizetype index, int attempt);
+    void fetchProfile(qsizetype index, const QByteArray& shotBody);
+    void build(qsizetype index, const QByteArray& shotBody, const QByteArray& profileBody);
+    void writeBatch();
+    void settle(qsizetype index, Outcome outcome);
+    void finish();
+
+    QNetworkReply* get(const QString& path);
+    void emitProgress();
+
+    QNetworkAccessManager* m_networkManager;
+    ShotHistoryStorage* m_storage;
+    QString m_baseUrl;
+    int m_concurrency = kDefaultConcurrency;
+
+    bool m_running = false;
+    bool m_cancelled = false;
+    qint64 m_fromEpoch = 0;
+    qint64 m_toEpoch = 0;
+    QByteArray m_authHeader;
+    Checkpoint m_resume;
+
+    QVector<Shot> m_shots;                 // in-window shots still to recover, oldest first
+    std::vector<Outcome> m_outcomes;       // per m_shots index
+    qsizetype m_nextShot = 0;              // first shot not yet downloading
+    qsizetype m_settledPrefix = 0;         // m_shots[0, m_settledPrefix) are all settled
+    int m_downloading = 0;
+    int m_building = 0;
+    bool m_writing = false;
+    QList<ShotRecord> m_built;             // built, waiting for the writer
+    QVector<qsizetype> m_builtIndex;       // their m_shots indices
+    QSet<QNetworkReply*> m_replies;        // in flight, for cancel()
+    qint64 m_checkpointClock = 0;
+    // Outcomes over m_shots[0, m_settledPrefix), for the checkpoint's counts.
+    int m_prefixImported = 0;
+    int m_prefixSkipped = 0;
+    int m_prefixFailed = 0;
+
+    int m_total = 0;
+    int m_imported = 0;
+    int m_skipped = 0;
+    int m_failed = 0;
+
+    CancellationToken m_cancelToken;
+    std::shared_ptr<std::atomic<bool>> m_destroyed = std::make_shared<std::atomic<bool>>(false);
+};
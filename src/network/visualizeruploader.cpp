@@ -30,6 +30,7 @@
 #include "../core/translationmanager.h"
 #include "../history/coffeebagstorage.h"
 #include "../core/dbutils.h"
+#include "../core/taskexecutor.h"
 #include "../models/shotdatamodel.h"
 #include "../core/settings.h"
 #include "../core/settings_visualizer.h"
@@ -90,7 +91,9 @@ QString VisualizerUploader::tr_(const char* key, const char* fallback) const {
 // Helper: Interpolate goal data to match elapsed timestamps
 // Goal data may have different timestamps or gaps; we need to align to the master elapsed array
 // Gaps > 0.5s between goal points indicate mode switches (flow/pressure) - return 0 during gaps
-static QJsonArray interpolateGoalData(const QVector<QPointF>& goalData, const QVector<QPointF>& masterData) {
+// Either argument is a QVector<QPointF> (history shots) or a SampleColumn (the live shot's buffer)
+template <typename GoalSeries, typename MasterSeries>
+static QJsonArray interpolateGoalData(const GoalSeries& goalData, const MasterSeries& masterData) {
     QJsonArray result;
 
     if (goalData.isEmpty() || masterData.isEmpty()) {
@@ -1219,16 +1222,18 @@ QByteArray VisualizerUploader::buildShotJson(ShotDataModel* shotData,
 {
     QJsonObject root;
 
-    // Get data from ShotDataModel
-    const auto& pressureData = shotData->pressureData();
-    const auto& flowData = shotData->flowData();
-    const auto& temperatureData = shotData->temperatureData();
-    const auto& pressureGoalData = shotData->pressureGoalData();
-    const auto& flowGoalData = shotData->flowGoalData();
-    const auto& temperatureGoalData = shotData->temperatureGoalData();
-    const auto& weightFlowRateData = shotData->weightFlowRateData();   // Scale flow rate (g/s)
-    const auto& darcyResistanceData = shotData->darcyResistanceData(); // P/flow² (Darcy formula, matches de1app)
-    const auto& cumulativeWeightData = shotData->cumulativeWeightData(); // Cumulative weight (g)
+    // Get data from ShotDataModel: column views of one snapshot of its sample buffer
+    using Channel = ShotSampleBuffer::Channel;
+    const ShotSampleBuffer samples = shotData->samples();
+    const SampleColumn pressureData = samples.column(Channel::Pressure);
+    const SampleColumn flowData = samples.column(Channel::Flow);
+    const SampleColumn temperatureData = samples.column(Channel::Temperature);
+    const QVector<QPointF> pressureGoalData = samples.goalPoints(ShotSampleBuffer::GoalCurve::Pressure);
+    const QVector<QPointF> flowGoalData = samples.goalPoints(ShotSampleBuffer::GoalCurve::Flow);
+    const SampleColumn temperatureGoalData = samples.column(Channel::TemperatureGoal);
+    const SampleColumn weightFlowRateData = samples.column(Channel::WeightFlowRate);   // Scale flow rate (g/s)
+    const SampleColumn darcyResistanceData = samples.column(Channel::DarcyResistance); // P/flow² (Darcy formula, matches de1app)
+    const SampleColumn cumulativeWeightData = samples.column(Channel::Weight); // Cumulative weight (g)
 
     // Use de1app version 2 format
     root["version"] = 2;
@@ -1271,7 +1276,7 @@ QByteArray VisualizerUploader::buildShotJson(ShotDataModel* shotData,
         flow["by_weight"] = interpolateGoalData(weightFlowRateData, pressureData);
     }
     // Raw (pre-smoothing) weight flow rate
-    const auto& weightFlowRateRawData = shotData->weightFlowRateRawData();
+    const SampleColumn weightFlowRateRawData = samples.column(Channel::WeightFlowRateRaw);
     if (!weightFlowRateRawData.isEmpty()) {
         flow["by_weight_raw"] = interpolateGoalData(weightFlowRateRawData, pressureData);
     }
@@ -1287,14 +1292,14 @@ QByteArray VisualizerUploader::buildShotJson(ShotDataModel* shotData,
     // Interpolate goal data to match elapsed timestamps
     temperature["goal"] = interpolateGoalData(temperatureGoalData, pressureData);
     // Mix temperature (water input temperature)
-    const auto& temperatureMixData = shotData->temperatureMixData();
+    const SampleColumn temperatureMixData = samples.column(Channel::TemperatureMix);
     if (!temperatureMixData.isEmpty()) {
         temperature["mix"] = interpolateGoalData(temperatureMixData, pressureData);
     }
     // Mix temperature goal (SetMixTemp). Omit the key entirely when absent —
     // interpolateGoalData() would otherwise fill a zero array, and Visualizer
     // would draw a 0 °C goal line. Missing means "legacy shot" to Visualizer.
-    const auto& temperatureMixGoalData = shotData->temperatureMixGoalData();
+    const SampleColumn temperatureMixGoalData = samples.column(Channel::TemperatureMixGoal);
     if (!temperatureMixGoalData.isEmpty()) {
         temperature["mix_goal"] = interpolateGoalData(temperatureMixGoalData, pressureData);
     }
@@ -1308,7 +1313,7 @@ QByteArray VisualizerUploader::buildShotJson(ShotDataModel* shotData,
     }
     // Water dispensed: de1app stores espresso_water_dispensed at 0.1× scale (tenths of ml),
     // so Visualizer expects values ~4.0 for a 40ml shot, not 40.0. Apply the same scaling.
-    const auto& waterDispensedData = shotData->waterDispensedData();
+    const SampleColumn waterDispensedData = samples.column(Channel::WaterDispensed);
     if (!waterDispensedData.isEmpty()) {
         QJsonArray waterDispensedRaw = interpolateGoalData(waterDispensedData, pressureData);
         QJsonArray waterDispensedScaled;
@@ -1440,7 +1445,7 @@ QByteArray VisualizerUploader::buildShotJson(ShotDataModel* shotData,
     // has one source, and it is this parameter.
     double drinkWeight = finalWeight;
     if (drinkWeight <= 0) {
-        const auto& wdData = shotData->waterDispensedData();
+        const SampleColumn wdData = samples.column(Channel::WaterDispensed);
         if (!wdData.isEmpty())
             drinkWeight = wdData.last().y();  // actual ml from flow integration, not scaled
     }
@@ -2078,7 +2083,7 @@ void VisualizerUploader::syncCoffeeBagAfterUpload(qint64 dbShotId, const QString
 
     const QString dbPath = m_localDbPath;
     QPointer<VisualizerUploader> self(this);
-    QThread* thread = QThread::create([self, dbPath, dbShotId, visualizerShotId]() {
+    TaskExecutor::instance().submit(TaskLane::Background, [self, dbPath, dbShotId, visualizerShotId]() {
         QVariantMap bagMap;
         withTempDb(dbPath, "viz_bagsync", [&](QSqlDatabase& db) {
             QSqlQuery query(db);
@@ -2096,8 +2101,6 @@ void VisualizerUploader::syncCoffeeBagAfterUpload(qint64 dbShotId, const QString
                 self->reconcileShotBag(visualizerShotId, bagMap);
         }, Qt::QueuedConnection);
     });
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
 
 void VisualizerUploader::reconcileShotBag(const QString& visualizerShotId, const QVariantMap& bag)
@@ -2432,7 +2435,7 @@ void VisualizerUploader::persistBagSyncIds(qint64 localBagId, const QString& vis
     if (localBagId <= 0 || m_localDbPath.isEmpty())
         return;
     const QString dbPath = m_localDbPath;
-    QThread* thread = QThread::create([dbPath, localBagId, visualizerBagId, visualizerRoasterId]() {
+    TaskExecutor::instance().submit(TaskLane::Background, [dbPath, localBagId, visualizerBagId, visualizerRoasterId]() {
         withTempDb(dbPath, "viz_bagids", [&](QSqlDatabase& db) {
             QVariantMap fields{{QStringLiteral("visualizerBagId"), visualizerBagId}};
             if (!visualizerRoasterId.isEmpty())
@@ -2441,8 +2444,6 @@ void VisualizerUploader::persistBagSyncIds(qint64 localBagId, const QString& vis
                 qWarning() << "Visualizer CM: failed to persist sync ids for bag" << localBagId;
         });
     });
-    QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
 
 void VisualizerUploader::updateBagOnVisualizer(qint64 localBagId)
@@ -2474,7 +2475,7 @@ void VisualizerUploader::updateBagOnVisualizer(qint64 localBagId)
 
     const QString dbPath = m_localDbPath;
     QPointer<VisualizerUploader> self(this);
-    QThread* thread = QThread::create([self, dbPath, localBagId]() {
+    TaskExecutor::instance().submit(TaskLane::Background, [self, dbPath, localBagId]() {
         QVariantMap bagMap;
         withTempDb(dbPath, "viz_bagupd", [&](QSqlDatabase& db) {
             const CoffeeBag bag = CoffeeBagStorage::loadBagStatic(db, localBagId);
@@ -2521,8 +2522,6 @@ void VisualizerUploader::updateBagOnVisualizer(qint64 localBagId)
             });
         }, Qt::QueuedConnection);
     });
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
 
 void VisualizerUploader::patchRemoteBag(const QVariantMap& bag, const QString& roasterId)
@@ -2596,15 +2595,13 @@ void VisualizerUploader::persistBagSyncPending(qint64 localBagId, bool pending)
     if (localBagId <= 0 || m_localDbPath.isEmpty())
         return;
     const QString dbPath = m_localDbPath;
-    QThread* thread = QThread::create([dbPath, localBagId, pending]() {
+    TaskExecutor::instance().submit(TaskLane::Background, [dbPath, localBagId, pending]() {
         withTempDb(dbPath, "viz_bagpend", [&](QSqlDatabase& db) {
             if (!CoffeeBagStorage::updateBagFieldsStatic(
                     db, localBagId, {{QStringLiteral("visualizerSyncPending"), pending}}))
                 qWarning() << "Visualizer CM: failed to persist sync-pending for bag" << localBagId;
         });
     });
-    QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
 
 void VisualizerUploader::retrySyncPendingBags()
@@ -2618,7 +2615,7 @@ void VisualizerUploader::retrySyncPendingBags()
         return;
     const QString dbPath = m_localDbPath;
     QPointer<VisualizerUploader> self(this);
-    QThread* thread = QThread::create([self, dbPath]() {
+    TaskExecutor::instance().submit(TaskLane::Background, [self, dbPath]() {
         QVector<qint64> pendingIds;
         withTempDb(dbPath, "viz_bagretry", [&](QSqlDatabase& db) {
             QSqlQuery query(db);
@@ -2639,6 +2636,4 @@ void VisualizerUploader::retrySyncPendingBags()
                 self->updateBagOnVisualizer(bagId);
         }, Qt::QueuedConnection);
     });
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
 }
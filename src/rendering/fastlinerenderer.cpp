@@ -1,6 +1,7 @@
 #include "fastlinerenderer.h"
 #include <QDebug>
 #include <cmath>
+#include <cstring>
 
 FastLineRenderer::FastLineRenderer(QQuickItem* parent)
     : QQuickItem(parent)
@@ -20,7 +21,7 @@ void FastLineRenderer::setColor(const QColor& color) {
 void FastLineRenderer::setLineWidth(float width) {
     if (qFuzzyCompare(m_lineWidth, width)) return;
     m_lineWidth = width;
-    m_geometryDirty = true;
+    invalidateLod();
     update();
     emit lineWidthChanged();
 }
@@ -28,7 +29,7 @@ void FastLineRenderer::setLineWidth(float width) {
 void FastLineRenderer::setMinX(double v) {
     if (qFuzzyCompare(m_minX, v)) return;
     m_minX = v;
-    m_geometryDirty = true;
+    invalidateLod();
     update();
     emit minXChanged();
 }
@@ -36,7 +37,7 @@ void FastLineRenderer::setMinX(double v) {
 void FastLineRenderer::setMaxX(double v) {
     if (qFuzzyCompare(m_maxX, v)) return;
     m_maxX = v;
-    m_geometryDirty = true;
+    invalidateLod();
     update();
     emit maxXChanged();
 }
@@ -44,7 +45,7 @@ void FastLineRenderer::setMaxX(double v) {
 void FastLineRenderer::setMinY(double v) {
     if (qFuzzyCompare(m_minY, v)) return;
     m_minY = v;
-    m_geometryDirty = true;
+    invalidateLod();
     update();
     emit minYChanged();
 }
@@ -52,22 +53,31 @@ void FastLineRenderer::setMinY(double v) {
 void FastLineRenderer::setMaxY(double v) {
     if (qFuzzyCompare(m_maxY, v)) return;
     m_maxY = v;
-    m_geometryDirty = true;
+    invalidateLod();
     update();
     emit maxYChanged();
 }
 
 void FastLineRenderer::appendPoint(double x, double y) {
-    if (m_pointCount < MAX_POINTS) {
+    appendPoints(&x, &y, 1);
+}
+
+void FastLineRenderer::appendPoints(const double* xs, const double* ys, qsizetype count) {
+    const qsizetype room = MAX_POINTS - m_pointCount;
+    const qsizetype taken = qMin(count, room);
+    for (qsizetype i = 0; i < taken; ++i) {
         if (m_pointCount < m_points.size()) {
-            m_points[m_pointCount] = QPointF(x, y);
+            m_points[m_pointCount] = QPointF(xs[i], ys[i]);
         } else {
-            m_points.append(QPointF(x, y));
+            m_points.append(QPointF(xs[i], ys[i]));
         }
         m_pointCount++;
+    }
+    if (taken > 0) {
         m_geometryDirty = true;
         update();
-    } else if (!m_overflowLogged) {
+    }
+    if (taken < count && !m_overflowLogged) {
         qWarning() << "FastLineRenderer: MAX_POINTS (" << MAX_POINTS
                    << ") reached — further points will be discarded."
                       " Increase MAX_POINTS if shots regularly exceed 10 minutes.";
@@ -78,7 +88,7 @@ void FastLineRenderer::appendPoint(double x, double y) {
 void FastLineRenderer::clear() {
     m_pointCount = 0;
     m_overflowLogged = false;
-    m_geometryDirty = true;
+    invalidateLod();
     update();
 }
 
@@ -91,10 +101,28 @@ void FastLineRenderer::setPoints(const QVector<QPointF>& points) {
     m_points = points;
     if (m_points.size() > MAX_POINTS)
         m_points.resize(MAX_POINTS);
-    m_geometryDirty = true;
+    invalidateLod();
+    update();
+}
+
+void FastLineRenderer::setPoints(const double* xs, const double* ys, qsizetype count) {
+    if (count > MAX_POINTS)
+        qWarning() << "FastLineRenderer::setPoints: received" << count
+                   << "points, truncating to MAX_POINTS (" << MAX_POINTS << ")."
+                      " Increase MAX_POINTS if shots regularly exceed 10 minutes.";
+    m_pointCount = static_cast<int>(qMin(count, qsizetype(MAX_POINTS)));
+    m_points.resize(m_pointCount);
+    for (int i = 0; i < m_pointCount; ++i)
+        m_points[i] = QPointF(xs[i], ys[i]);
+    invalidateLod();
     update();
 }
 
+void FastLineRenderer::invalidateLod() {
+    m_lodDirty = true;
+    m_geometryDirty = true;
+}
+
 void FastLineRenderer::itemChange(ItemChange change, const ItemChangeData& data) {
     if (change == ItemVisibleHasChanged && data.boolValue) {
         // When the item becomes visible again (e.g., StackView pop), force a repaint.
@@ -106,8 +134,74 @@ void FastLineRenderer::itemChange(ItemChange change, const ItemChangeData& data)
     QQuickItem::itemChange(change, data);
 }
 
-// Triangle strip vertex count: 2 vertices per point (left/right of the line center)
-static constexpr int MAX_VERTICES = FastLineRenderer::MAX_POINTS * 2;
+void FastLineRenderer::updateStrip(int from) {
+    // Triangle strip: for each point, emit two vertices offset perpendicular
+    // to the line direction by halfWidth. A point's vertices depend on both
+    // neighbours, so the caller passes one before the first changed point.
+    const QVector<LineDecimator::Point>& px = m_lod.points();
+    const int count = static_cast<int>(px.size());
+    const float halfWidth = m_lineWidth * 0.5f;
+    m_strip.resize(count * 2);
+    QSGGeometry::Point2D* v = m_strip.data();
+
+    for (int i = from; i < count; ++i) {
+        float nx, ny;
+        if (i == 0) {
+            // First point: use direction to next point
+            float dx = px[1].x - px[0].x;
+            float dy = px[1].y - px[0].y;
+            float len = std::sqrt(dx * dx + dy * dy);
+            if (len < 1e-6f) len = 1.0f;
+            nx = -dy / len;
+            ny = dx / len;
+        } else if (i == count - 1) {
+            // Last point: use direction from previous point
+            float dx = px[i].x - px[i - 1].x;
+            float dy = px[i].y - px[i - 1].y;
+            float len = std::sqrt(dx * dx + dy * dy);
+            if (len < 1e-6f) len = 1.0f;
+            nx = -dy / len;
+            ny = dx / len;
+        } else {
+            // Middle points: average the normals of adjacent segments (miter join)
+            float dx1 = px[i].x - px[i - 1].x;
+            float dy1 = px[i].y - px[i - 1].y;
+            float len1 = std::sqrt(dx1 * dx1 + dy1 * dy1);
+            if (len1 < 1e-6f) len1 = 1.0f;
+            float nx1 = -dy1 / len1;
+            float ny1 = dx1 / len1;
+
+            float dx2 = px[i + 1].x - px[i].x;
+            float dy2 = px[i + 1].y - px[i].y;
+            float len2 = std::sqrt(dx2 * dx2 + dy2 * dy2);
+            if (len2 < 1e-6f) len2 = 1.0f;
+            float nx2 = -dy2 / len2;
+            float ny2 = dx2 / len2;
+
+            nx = (nx1 + nx2) * 0.5f;
+            ny = (ny1 + ny2) * 0.5f;
+            float nlen = std::sqrt(nx * nx + ny * ny);
+            if (nlen < 1e-6f) { nx = nx1; ny = ny1; }
+            else {
+                // Scale miter normal so the perpendicular offset equals halfWidth.
+                // dot(avgNormal, segNormal) gives the cosine of the half-angle;
+                // dividing by it corrects the miter length. Clamp to avoid spikes.
+                float dot = nx * nx1 + ny * ny1;
+                float miterLen = (dot > 0.25f) ? (nlen / dot) : 2.0f;
+                if (miterLen > 2.0f) miterLen = 2.0f;
+                nx = nx / nlen * miterLen;
+                ny = ny / nlen * miterLen;
+            }
+        }
+
+        v[i * 2].set(px[i].x + nx * halfWidth, px[i].y + ny * halfWidth);
+        v[i * 2 + 1].set(px[i].x - nx * halfWidth, px[i].y - ny * halfWidth);
+    }
+}
+
+// Vertex count of the dot and blank cases. Never zero: an empty geometry is
+// as unwelcome to the Metal backend as a zero-sized item (see below).
+static constexpr int MIN_VERTICES = 4;
 
 QSGNode* FastLineRenderer::updatePaintNode(QSGNode* node, UpdatePaintNodeData*) {
     // Guard against zero-dimension rendering (e.g., during Loader creation before
@@ -123,7 +217,7 @@ QSGNode* FastLineRenderer::updatePaintNode(QSGNode* node, UpdatePaintNodeData*)
     if (!gnode) {
         gnode = new QSGGeometryNode();
 
-        auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), MAX_VERTICES);
+        auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), MIN_VERTICES);
         geometry->setDrawingMode(QSGGeometry::DrawTriangleStrip);
         geometry->setVertexDataPattern(QSGGeometry::StreamPattern);
 
@@ -148,100 +242,62 @@ QSGNode* FastLineRenderer::updatePaintNode(QSGNode* node, UpdatePaintNodeData*)
 
     if (m_geometryDirty) {
         auto* geometry = gnode->geometry();
-        auto* v = geometry->vertexDataAsPoint2D();
         const float w = static_cast<float>(width());
         const float h = static_cast<float>(height());
         const double rangeX = m_maxX - m_minX;
         const double rangeY = m_maxY - m_minY;
         const float halfWidth = m_lineWidth * 0.5f;
 
-        if (rangeX > 0 && rangeY > 0 && m_pointCount > 1) {
-            const double scaleX = w / rangeX;
-            const double scaleY = h / rangeY;
-
-            // Convert data points to pixel coordinates in a temp buffer
-            struct Pt { float x, y; };
-            QVarLengthArray<Pt, MAX_POINTS> px(m_pointCount);
-            for (int i = 0; i < m_pointCount; ++i) {
-                px[i].x = static_cast<float>((m_points[i].x() - m_minX) * scaleX);
-                px[i].y = h - static_cast<float>((m_points[i].y() - m_minY) * scaleY);
-            }
-
-            // Generate triangle strip: for each point, emit two vertices offset
-            // perpendicular to the line direction by halfWidth
-            int vi = 0;
-            for (int i = 0; i < m_pointCount; ++i) {
-                float nx, ny;
-                if (i == 0) {
-                    // First point: use direction to next point
-                    float dx = px[1].x - px[0].x;
-                    float dy = px[1].y - px[0].y;
-                    float len = std::sqrt(dx * dx + dy * dy);
-                    if (len < 1e-6f) len = 1.0f;
-                    nx = -dy / len;
-                    ny = dx / len;
-                } else if (i == m_pointCount - 1) {
-                    // Last point: use direction from previous point
-                    float dx = px[i].x - px[i - 1].x;
-                    float dy = px[i].y - px[i - 1].y;
-                    float len = std::sqrt(dx * dx + dy * dy);
-                    if (len < 1e-6f) len = 1.0f;
-                    nx = -dy / len;
-                    ny = dx / len;
-                } else {
-                    // Middle points: average the normals of adjacent segments (miter join)
-                    float dx1 = px[i].x - px[i - 1].x;
-                    float dy1 = px[i].y - px[i - 1].y;
-                    float len1 = std::sqrt(dx1 * dx1 + dy1 * dy1);
-                    if (len1 < 1e-6f) len1 = 1.0f;
-                    float nx1 = -dy1 / len1;
-                    float ny1 = dx1 / len1;
-
-                    float dx2 = px[i + 1].x - px[i].x;
-                    float dy2 = px[i + 1].y - px[i].y;
-                    float len2 = std::sqrt(dx2 * dx2 + dy2 * dy2);
-                    if (len2 < 1e-6f) len2 = 1.0f;
-                    float nx2 = -dy2 / len2;
-                    float ny2 = dx2 / len2;
-
-                    nx = (nx1 + nx2) * 0.5f;
-                    ny = (ny1 + ny2) * 0.5f;
-                    float nlen = std::sqrt(nx * nx + ny * ny);
-                    if (nlen < 1e-6f) { nx = nx1; ny = ny1; }
-                    else {
-                        // Scale miter normal so the perpendicular offset equals halfWidth.
-                        // dot(avgNormal, segNormal) gives the cosine of the half-angle;
-                        // dividing by it corrects the miter length. Clamp to avoid spikes.
-                        float dot = nx * nx1 + ny * ny1;
-                        float miterLen = (dot > 0.25f) ? (nlen / dot) : 2.0f;
-                        if (miterLen > 2.0f) miterLen = 2.0f;
-                        nx = nx / nlen * miterLen;
-                        ny = ny / nlen * miterLen;
-                    }
-                }
+        if (w != m_lodWidth || h != m_lodHeight) {
+            m_lodDirty = true;
+            m_lodWidth = w;
+            m_lodHeight = h;
+        }
 
-                v[vi].set(px[i].x + nx * halfWidth, px[i].y + ny * halfWidth);
-                v[vi + 1].set(px[i].x - nx * halfWidth, px[i].y - ny * halfWidth);
-                vi += 2;
+        if (rangeX > 0 && rangeY > 0 && m_pointCount > 1) {
+            // Decimate to the item's pixel columns. After an append only the
+            // line's tail is redone — the decimator keeps every column before
+            // the last — and the strip is rebuilt from the point before the
+            // first one that moved. A view change (zoom, resize, axis range)
+            // starts both over.
+            if (m_lodDirty) {
+                m_lod.setView(m_minX, m_maxX, m_minY, m_maxY, w, h);
+                m_lod.reset();
+                m_lodDirty = false;
             }
+            const int changed = m_lod.update(m_points.constData(), m_pointCount);
+            const int stripFrom = qMin(qMax(0, changed - 1), static_cast<int>(m_strip.size() / 2));
+            updateStrip(stripFrom);
 
-            // Fill remaining vertices with degenerate (last point)
-            QSGGeometry::Point2D last = v[vi - 1];
-            for (int i = vi; i < MAX_VERTICES; ++i) {
-                v[i] = last;
-            }
-        } else if (rangeX > 0 && rangeY > 0 && m_pointCount == 1) {
-            // Single point: draw a small dot
-            float px = static_cast<float>((m_points[0].x() - m_minX) * (w / rangeX));
-            float py = h - static_cast<float>((m_points[0].y() - m_minY) * (h / rangeY));
-            v[0].set(px - halfWidth, py - halfWidth);
-            v[1].set(px + halfWidth, py - halfWidth);
-            for (int i = 2; i < MAX_VERTICES; ++i) {
-                v[i].set(px, py);
-            }
+            // The geometry is sized to the decimated line, not to MAX_POINTS,
+            // so what the renderer uploads scales with the item's width. The
+            // scene graph re-uploads a dirty geometry whole; the partial work
+            // is the CPU side above.
+            const int vertexCount = static_cast<int>(m_strip.size());
+            if (geometry->vertexCount() != vertexCount)
+                geometry->allocate(vertexCount);
+            std::memcpy(geometry->vertexDataAsPoint2D(), m_strip.constData(),
+                        static_cast<size_t>(vertexCount) * sizeof(QSGGeometry::Point2D));
         } else {
-            for (int i = 0; i < MAX_VERTICES; ++i) {
-                v[i].set(0.0f, 0.0f);
+            m_lodDirty = true;  // nothing decimated under this view
+            m_lod.reset();
+            m_strip.clear();
+            if (geometry->vertexCount() != MIN_VERTICES)
+                geometry->allocate(MIN_VERTICES);
+            auto* v = geometry->vertexDataAsPoint2D();
+            if (rangeX > 0 && rangeY > 0 && m_pointCount == 1) {
+                // Single point: draw a small dot
+                float px = static_cast<float>((m_points[0].x() - m_minX) * (w / rangeX));
+                float py = h - static_cast<float>((m_points[0].y() - m_minY) * (h / rangeY));
+                v[0].set(px - halfWidth, py - halfWidth);
+                v[1].set(px + halfWidth, py - halfWidth);
+                for (int i = 2; i < MIN_VERTICES; ++i) {
+                    v[i].set(px, py);
+                }
+            } else {
+                for (int i = 0; i < MIN_VERTICES; ++i) {
+                    v[i].set(0.0f, 0.0f);
+                }
             }
         }
 
@@ -8,6 +8,8 @@
 #include <QSGFlatColorMaterial>
 #include <QtQml/qqmlregistration.h>
 
+#include "linedecimator.h"
+
 class FastLineRenderer : public QQuickItem {
     Q_OBJECT
     // Compile-time registration. A runtime qmlRegisterType<>() in main.cpp is invisible to
@@ -46,9 +48,13 @@ public:
 
     // Called by ShotDataModel - fast, just appends to internal vector
     Q_INVOKABLE void appendPoint(double x, double y);
+    // A flush's worth in one call, straight from column storage (ShotSampleBuffer):
+    // xs and ys are parallel arrays of `count` values.
+    void appendPoints(const double* xs, const double* ys, qsizetype count);
     Q_INVOKABLE void clear();
     // Bulk load for viewing completed shots on page re-entry
     void setPoints(const QVector<QPointF>& points);
+    void setPoints(const double* xs, const double* ys, qsizetype count);
 
 signals:
     void colorChanged();
@@ -63,6 +69,12 @@ protected:
     void itemChange(ItemChange change, const ItemChangeData& data) override;
 
 private:
+    // View or data replaced: decimate from scratch at the next paint. Appends
+    // don't set this — they only extend the decimated line's tail.
+    void invalidateLod();
+    // Rebuild the triangle strip for decimated points [from, end).
+    void updateStrip(int from);
+
     QVector<QPointF> m_points;  // Data-space coordinates
     int m_pointCount = 0;
     QColor m_color = Qt::white;
@@ -72,4 +84,11 @@ private:
     bool m_materialDirty = true;
     bool m_overflowLogged = false;
 
+    // What is actually drawn: the points decimated to the item's pixel
+    // columns (see linedecimator.h), and the strip built from them.
+    LineDecimator m_lod;
+    QVector<QSGGeometry::Point2D> m_strip;
+    bool m_lodDirty = true;
+    float m_lodWidth = 0, m_lodHeight = 0;
+
 };
@@ -0,0 +1,89 @@
+#include "linedecimator.h"
+
+#include <cmath>
+
+void LineDecimator::setView(double minX, double maxX, double minY, double maxY,
+                            float width, float height)
+{
+    m_minX = minX;
+    m_minY = minY;
+    m_scaleX = maxX > minX ? width / (maxX - minX) : 0.0;
+    m_scaleY = maxY > minY ? height / (maxY - minY) : 0.0;
+    m_width = width;
+    m_height = height;
+}
+
+void LineDecimator::reset()
+{
+    m_out.clear();
+    m_valid = false;
+    m_tailOut = 0;
+    m_tailSource = 0;
+}
+
+int LineDecimator::columnOf(double x) const
+{
+    // Everything off the left edge is column -1, off the right edge the
+    // column just past the last; clamping before the cast also keeps a huge x
+    // out of int range.
+    const double px = std::floor((x - m_minX) * m_scaleX);
+    if (!(px >= 0.0)) return -1;  // also NaN
+    if (px >= m_width) return static_cast<int>(std::ceil(m_width));
+    return static_cast<int>(px);
+}
+
+LineDecimator::Point LineDecimator::toPixel(const QPointF& p) const
+{
+    return {static_cast<float>((p.x() - m_minX) * m_scaleX),
+            m_height - static_cast<float>((p.y() - m_minY) * m_scaleY)};
+}
+
+void LineDecimator::emitRun(const QPointF* points, int begin, int end)
+{
+    if (end - begin <= 4) {
+        for (int i = begin; i < end; ++i)
+            m_out.append(toPixel(points[i]));
+        return;
+    }
+
+    int lowest = begin, highest = begin;
+    for (int i = begin + 1; i < end; ++i) {
+        if (points[i].y() < points[lowest].y()) lowest = i;
+        if (points[i].y() > points[highest].y()) highest = i;
+    }
+    const int first = qMin(lowest, highest);
+    const int second = qMax(lowest, highest);
+
+    m_out.append(toPixel(points[begin]));
+    if (first != begin) m_out.append(toPixel(points[first]));
+    if (second != first && second != end - 1) m_out.append(toPixel(points[second]));
+    m_out.append(toPixel(points[end - 1]));
+}
+
+int LineDecimator::update(const QPointF* points, int count)
+{
+    int from = 0;
+    if (m_valid && count >= m_tailSource) {
+        // The open run may have grown: drop what it emitted and redo it.
+        m_out.resize(m_tailOut);
+        from = m_tailSource;
+    } else {
+        m_out.clear();
+        m_tailOut = 0;
+        m_tailSource = 0;
+        m_valid = true;
+    }
+    const int firstChanged = static_cast<int>(m_out.size());
+
+    int i = from;
+    while (i < count) {
+        const int column = columnOf(points[i].x());
+        int end = i + 1;
+        while (end < count && columnOf(points[end].x()) == column) ++end;
+        m_tailOut = static_cast<int>(m_out.size());
+        m_tailSource = i;
+        emitRun(points, i, end);
+        i = end;
+    }
+    return firstChanged;
+}
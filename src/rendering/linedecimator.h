@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QPointF>
+#include <QVector>
+
+// Level-of-detail for FastLineRenderer: reduces a time series to what its
+// item's pixels can show, per pixel column.
+//
+// Consecutive points that land in the same pixel column form a run. A run of
+// up to four points is kept as-is; a longer one is reduced to its first point,
+// its minimum, its maximum (in sample order) and its last point — M4
+// decimation. A polyline through those four covers the same pixels as one
+// through the whole run: the vertical extent is the min/max, and the line
+// enters and leaves the column where it did. So a 10-minute tea shot, or a
+// zoomed-out history chart, costs vertices in proportion to the item's width
+// rather than its sample count, and nothing visible is lost. Points left of
+// the view, and right of it, collapse into one column each, so a zoomed view
+// costs what it shows.
+//
+// It is incremental. Samples only ever append during a shot, and only the
+// last run can still grow, so update() keeps every output point before that
+// run and redoes just the run plus whatever arrived since. Anything that
+// changes the data-to-pixel mapping (setView) or replaces the points needs a
+// reset().
+//
+// Qt Core only, so the tests can drive and benchmark it without a scene graph.
+class LineDecimator {
+public:
+    struct Point { float x, y; };  // item pixels, y down
+
+    // The data-to-pixel mapping. Output already produced under the old one is
+    // stale: follow a change with reset().
+    void setView(double minX, double maxX, double minY, double maxY, float width, float height);
+
+    // Forget the output; the next update() starts from the first point.
+    void reset();
+
+    // Bring the output up to date with points[0, count), which may only have
+    // grown since the last call. Returns the index of the first output point
+    // that changed (or was added) — everything before it is as it was.
+    int update(const QPointF* points, int count);
+
+    const QVector<Point>& points() const { return m_out; }
+
+private:
+    int columnOf(double x) const;
+    Point toPixel(const QPointF& p) const;
+    void emitRun(const QPointF* points, int begin, int end);
+
+    double m_minX = 0, m_minY = 0;
+    double m_scaleX = 1, m_scaleY = 1;
+    float m_width = 0, m_height = 0;
+
+    QVector<Point> m_out;
+    bool m_valid = false;
+    int m_tailOut = 0;     // m_out index where the last (still open) run starts
+    int m_tailSource = 0;  // source index of that run's first point
+};
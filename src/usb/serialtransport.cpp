@@ -2,6 +2,7 @@
 #include "ble/de1logging.h"
 #include "ble/protocol/de1characteristics.h"
 #include "usb/serialstall.h"
+#include "core/latencystats.h"
 
 #ifdef Q_OS_ANDROID
 #include "usb/androidusbhelper.h"
@@ -448,7 +449,7 @@ void SerialTransport::processLine(const QString& line)
     // the shot record already prove, and BleTransport::onCharacteristicChanged
     // logs no equivalent. The two anomaly cases above ARE logged — those are the
     // ones a reader is looking for.
-    emit dataReceived(uuid, data);
+    emit dataReceived(uuid, data, LatencyStats::nowMs());
 }
 
 char SerialTransport::uuidToLetter(const QBluetoothUuid& uuid)
@@ -0,0 +1,19 @@
+#pragma once
+
+// Opt-in gate for the wall-clock cases: a history-sized import, a 500 MB
+// download, a 200k-row table. They measure rather than check, cost seconds,
+// and a time bound is only meaningful on a quiet machine, so the default
+// `ctest` run skips them. Run them with the variable set:
+//
+//   DECENZA_BENCHMARKS=1 ./tests/tst_shotimportbatch importThroughput
+//
+// First statement of the test function. QBENCHMARK cases that are cheap for
+// one pass (the default outside -iterations) do not need it.
+
+#include <QtTest>
+
+#define DECENZA_BENCHMARK_OPT_IN()                                                   \
+    do {                                                                             \
+        if (!qEnvironmentVariableIsSet("DECENZA_BENCHMARKS"))                        \
+            QSKIP("Benchmark: set DECENZA_BENCHMARKS=1 to run it");                  \
+    } while (false)
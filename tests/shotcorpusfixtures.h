@@ -0,0 +1,69 @@
+#pragma once
+
+// Shared tests/data/shots corpus loader and bit-identity check, for the tests
+// that prove a batch kernel answers exactly what the loop it replaced did.
+//
+// Extracted from tst_seriesview.cpp and tst_conductance.cpp, which each carried
+// a copy and had already drifted: one kept shots with a single pressure sample,
+// the other needed three. The sample floor is now a parameter and the pour
+// window is taken for every shot; a test that has no use for it ignores it.
+//
+// The corpus is read with ShotFileParser::parseVisualizerShot, so it is the
+// visualizer-format half of it; the de1app-JSON shots are shot_eval's alone.
+// Call loadCorpus outside failOnWarning: a few of those downloads carry an
+// off-by-one espresso_state_change the parser warns about.
+
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+#include <cmath>
+#include <cstring>
+
+#include "history/shotfileparser.h"
+#include "history/shothistorystorage.h"
+
+namespace ShotCorpusFixtures {
+
+// Same bits, or both NaN. Not ==: -0.0 and 0.0 must differ here.
+inline bool identical(double a, double b)
+{
+    if (std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b);
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+struct CorpusShot {
+    QString file;
+    ShotRecord record;
+    double pourStart = 0;   // first phase marker, or 0 with none
+    double pourEnd = 0;     // last pressure sample
+};
+
+// Every visualizer shot in tests/data/shots that parses and has at least
+// `minSamples` pressure samples, in file-name order.
+inline QList<CorpusShot> loadCorpus(qsizetype minSamples = 1)
+{
+    QList<CorpusShot> shots;
+    const QDir dir(QStringLiteral(DECENZA_SOURCE_DIR) + QStringLiteral("/tests/data/shots"));
+    for (const QString& name : dir.entryList({QStringLiteral("*.json")}, QDir::Files, QDir::Name)) {
+        if (name == QStringLiteral("manifest.json")) continue;
+        QFile f(dir.filePath(name));
+        if (!f.open(QIODevice::ReadOnly)) continue;
+        const QJsonObject json = QJsonDocument::fromJson(f.readAll()).object();
+        const ShotFileParser::ParseResult res = ShotFileParser::parseVisualizerShot(
+            json, QString(), name, 1751000000);
+        if (!res.success || res.record.pressure.size() < qMax<qsizetype>(minSamples, 1)) continue;
+        CorpusShot shot;
+        shot.file = name;
+        shot.record = res.record;
+        shot.pourStart = res.record.phases.isEmpty() ? 0.0 : res.record.phases.first().time;
+        shot.pourEnd = res.record.pressure.last().x();
+        shots.append(shot);
+    }
+    return shots;
+}
+
+} // namespace ShotCorpusFixtures
@@ -31,6 +31,11 @@
 
 namespace ShotRowFixtures {
 
+// schema_version at the end of ShotHistoryStorage's migration chain. Every
+// "chain runs on to the latest" assert compares against this, so a new
+// migration is one edit here rather than a hunt through each test file.
+constexpr int kLatestSchemaVersion = 41;
+
 // One shot's input fields. Keep this near-identical to ShotSaveData so
 // the parameter list is grep-able from the production save path.
 // Every member carries an explicit default initializer, including the QStrings.
@@ -126,6 +131,13 @@ inline qint64 insertShot(QSqlDatabase& db, const ShotRow& r)
         }
     }
 
+    // profile_json lives in the content-addressed shot_profiles table
+    // (migration 39); the row names it by hash, as saveShotStatic does.
+    const std::optional<QString> profileHash =
+        ShotHistoryStorage::storeProfileJsonStatic(db, r.profileJson);
+    if (!profileHash)
+        return -1;
+
     QSqlQuery q(db);
     q.prepare(QStringLiteral(R"(
         INSERT INTO shots (
@@ -134,7 +146,7 @@ inline qint64 insertShot(QSqlDatabase& db, const ShotRow& r)
             bean_brand, bean_type, roast_level,
             grinder_setting, rpm, equipment_id,
             enjoyment, espresso_notes, profile_kb_id,
-            profile_json, yield_override, temperature_override, stopped_by,
+            profile_hash, yield_override, temperature_override, stopped_by,
             frozen_date, defrost_date, storage_hint, opened_date
         ) VALUES (
             :uuid, :timestamp, :profile_name, :beverage_type,
@@ -142,7 +154,7 @@ inline qint64 insertShot(QSqlDatabase& db, const ShotRow& r)
             :bean_brand, :bean_type, :roast_level,
             :grinder_setting, :rpm, :equipment_id,
             :enjoyment, :espresso_notes, :profile_kb_id,
-            :profile_json, :yield_override, :temperature_override, :stopped_by,
+            :profile_hash, :yield_override, :temperature_override, :stopped_by,
             :frozen_date, :defrost_date, :storage_hint, :opened_date
         )
     )"));
@@ -165,7 +177,7 @@ inline qint64 insertShot(QSqlDatabase& db, const ShotRow& r)
     q.bindValue(":enjoyment", r.enjoyment);
     q.bindValue(":espresso_notes", r.espressoNotes);
     q.bindValue(":profile_kb_id", r.profileKbId.isEmpty() ? QVariant() : r.profileKbId);
-    q.bindValue(":profile_json", r.profileJson);
+    q.bindValue(":profile_hash", profileHash->isEmpty() ? QVariant() : *profileHash);
     q.bindValue(":yield_override", r.targetWeight);
     q.bindValue(":temperature_override", r.temperatureOverride);
     q.bindValue(":stopped_by", r.stoppedBy);
@@ -1,5 +1,8 @@
 #include <QtTest>
 #include <QSignalSpy>
+#include <QThread>
+
+#include <atomic>
 
 #include "ble/blegattqueue.h"
 #include "ble/protocol/de1characteristics.h"
@@ -922,6 +925,76 @@ private slots:
         // Drain everything so the queue does not report again at destruction.
         q.forget(de1());
     }
+
+    // --- threads ----------------------------------------------------------
+    //
+    // Production runs the queue on the BLE I/O thread beside the DE1, with the
+    // scale transports left on the main thread. These two slots put the queue
+    // on a worker thread and drive it from this one, the way a scale does.
+
+    // A scale's QLowEnergyService belongs to the main thread, so its issue
+    // callback must run there — and the public API must work from there
+    // without the caller knowing where the queue lives.
+    void anOperationIsIssuedOnItsContextsThread() {
+        QThread io;
+        auto* q = new BleGattQueue;
+        q->moveToThread(&io);
+        io.start();
+
+        QObject requester;
+        std::atomic<QThread*> issuedOn{nullptr};
+        BleGattQueue::Operation o;
+        o.requester = scale();
+        o.label = QStringLiteral("scale-write");
+        o.context = &requester;
+        o.issue = [&issuedOn]() { issuedOn = QThread::currentThread(); };
+        q->submit(o);
+
+        QTRY_VERIFY(issuedOn.load() != nullptr);
+        QCOMPARE(issuedOn.load(), QThread::currentThread());
+        QCOMPARE(q->inFlightRequester(), scale());
+
+        q->noteSucceeded(scale());
+        QTRY_VERIFY(!q->isBusy());
+
+        q->deleteLater();
+        io.quit();
+        QVERIFY(io.wait(5000));
+    }
+
+    // The issue is in transit to the requester's thread while the slot is
+    // already held. If the requester forgets its work in that window, the
+    // issue must not reach the platform when it lands — that would be an
+    // operation on the wire with nothing in the queue accounting for it.
+    void aHoppedIssueIsDroppedWhenTheSlotMovedOn() {
+        QThread io;
+        auto* q = new BleGattQueue;
+        q->moveToThread(&io);
+        io.start();
+
+        QObject requester;
+        Recorder rec;
+        BleGattQueue::Operation o = op(scale(), QStringLiteral("scale-write"), &rec);
+        o.context = &requester;
+        q->submit(o);
+
+        // Wait for the dispatch WITHOUT running this thread's event loop, so
+        // the posted issue is still sitting in it. isBusy() blocks on the
+        // queue's thread; it processes nothing here.
+        QElapsedTimer waited;
+        waited.start();
+        while (!q->isBusy() && waited.elapsed() < 5000)
+            QThread::msleep(1);
+        QVERIFY(q->isBusy());
+
+        QCOMPARE(q->forget(scale()), qsizetype(1));
+        pump();
+        QVERIFY(rec.issued.isEmpty());
+
+        q->deleteLater();
+        io.quit();
+        QVERIFY(io.wait(5000));
+    }
 };
 
 QTEST_MAIN(tst_BleGattQueue)
@@ -44,6 +44,8 @@ using ShotRowFixtures::hasColumn;
 
 using ShotRowFixtures::hasTable;
 
+using ShotRowFixtures::kLatestSchemaVersion;
+
 // Minimal shot row insert for link / history-lane tests.
 static qint64 insertShot(QSqlDatabase& db, const QString& brand, const QString& type,
                          qint64 timestamp, const QString& beanBaseId = QString(),
@@ -890,7 +892,7 @@ private slots:
             QCOMPARE(q.value(0).toInt(), 0);  // existing rows default to 0
             QVERIFY(q.exec("SELECT version FROM schema_version"));
             QVERIFY(q.next());
-            QCOMPARE(q.value(0).toInt(), 38);  // chain runs on to the latest (canonical-link unlink)
+            QCOMPARE(q.value(0).toInt(), kLatestSchemaVersion);  // chain runs on to the latest
         });
     }
 
@@ -1288,7 +1290,7 @@ private slots:
             QSqlQuery q(db);
             QVERIFY(q.exec("SELECT version FROM schema_version"));
             QVERIFY(q.next());
-            QCOMPARE(q.value(0).toInt(), 38);  // chain runs on to the latest (canonical-link unlink)
+            QCOMPARE(q.value(0).toInt(), kLatestSchemaVersion);  // chain runs on to the latest
         });
     }
 
@@ -1321,7 +1323,7 @@ private slots:
             QSqlQuery q(db);
             QVERIFY(q.exec("SELECT version FROM schema_version"));
             QVERIFY(q.next());
-            QCOMPARE(q.value(0).toInt(), 38);  // chain runs on to the latest (canonical-link unlink)
+            QCOMPARE(q.value(0).toInt(), kLatestSchemaVersion);  // chain runs on to the latest
             // The repaired table is writable — insertRecipeStatic binds
             // rpm_pinned unconditionally, so it would fail wholesale if the
             // ALTER hadn't landed.
@@ -0,0 +1,206 @@
+#include <QtTest>
+
+#include "ai/conductance.h"
+#include "history/shothistorystorage.h"
+#include "shotcorpusfixtures.h"
+
+using ShotCorpusFixtures::CorpusShot;
+using ShotCorpusFixtures::identical;
+using ShotCorpusFixtures::loadCorpus;
+
+// Conductance batch kernels — the columnar conductance, resistance, Darcy
+// resistance and dC/dt behind computeDerivedCurves and ShotDataModel.
+//
+// They replaced per-sample loops over QVector<QPointF>, and they must answer
+// bit-for-bit what those loops answered: the derived curves are what the
+// detectors and the charts read, and shot_eval's manifest was tuned on them.
+// The references below are the scalar path — the per-sample formulas and the
+// derivative as it was written before it had a batch form — checked on the
+// guard thresholds and on the curves of the tests/data/shots corpus. The
+// benchmarks run both over that corpus, as a history load does per shot.
+class tst_Conductance : public QObject {
+    Q_OBJECT
+
+private:
+    // --- The scalar path ---
+
+    static QVector<QPointF> scalarDerivative(const QVector<QPointF>& conductance) {
+        QVector<QPointF> out;
+        const qsizetype n = conductance.size();
+        if (n < 3) return out;
+
+        QVector<double> raw(n, 0.0);
+        for (qsizetype i = 1; i < n - 1; ++i) {
+            const double dt = conductance[i + 1].x() - conductance[i - 1].x();
+            if (dt > 0.001) {
+                const double dc = conductance[i + 1].y() - conductance[i - 1].y();
+                raw[i] = (dc / dt) * 10.0;
+            }
+        }
+        {
+            double dt = conductance[1].x() - conductance[0].x();
+            if (dt > 0.001)
+                raw[0] = ((conductance[1].y() - conductance[0].y()) / dt) * 10.0;
+            dt = conductance[n - 1].x() - conductance[n - 2].x();
+            if (dt > 0.001)
+                raw[n - 1] = ((conductance[n - 1].y() - conductance[n - 2].y()) / dt) * 10.0;
+        }
+
+        static constexpr double GAUSSIAN[] = {
+            0.048297, 0.08393, 0.124548, 0.157829, 0.170793,
+            0.157829, 0.124548, 0.08393, 0.048297
+        };
+        static constexpr qsizetype KERNEL_HALF = 4;
+
+        out.reserve(n);
+        for (qsizetype i = 0; i < n; ++i) {
+            double smoothed = 0.0;
+            double weightSum = 0.0;
+            for (qsizetype k = -KERNEL_HALF; k <= KERNEL_HALF; ++k) {
+                const qsizetype idx = i + k;
+                if (idx >= 0 && idx < n) {
+                    const double w = GAUSSIAN[k + KERNEL_HALF];
+                    smoothed += raw[idx] * w;
+                    weightSum += w;
+                }
+            }
+            if (weightSum > 0.0) smoothed /= weightSum;
+            if (smoothed < -5.0) smoothed = -5.0;
+            else if (smoothed > 19.0) smoothed = 19.0;
+            out.append(QPointF(conductance[i].x(), smoothed));
+        }
+        return out;
+    }
+
+    // What computeDerivedCurves did per sample before the batch kernels.
+    static void scalarDerivedCurves(ShotRecord& record) {
+        const qsizetype n = qMin(record.pressure.size(), record.flow.size());
+        if (n < 3) return;
+        record.conductance.clear();
+        record.resistance.clear();
+        record.darcyResistance.clear();
+        for (qsizetype i = 0; i < n; ++i) {
+            const double t = record.pressure[i].x();
+            const double p = record.pressure[i].y();
+            const double f = record.flow[i].y();
+            record.conductance.append(QPointF(t, Conductance::sample(p, f)));
+            record.resistance.append(QPointF(t, Conductance::resistance(p, f)));
+            record.darcyResistance.append(QPointF(t, Conductance::darcyResistanceSample(p, f)));
+        }
+        record.conductanceDerivative = scalarDerivative(record.conductance);
+    }
+
+    static void checkSame(const QVector<QPointF>& actual, const QVector<QPointF>& expected,
+                          const QString& what) {
+        QVERIFY2(actual.size() == expected.size(), qPrintable(what + QStringLiteral(": size")));
+        for (qsizetype i = 0; i < actual.size(); ++i) {
+            QVERIFY2(identical(actual[i].x(), expected[i].x()) && identical(actual[i].y(), expected[i].y()),
+                     qPrintable(QStringLiteral("%1[%2]: %3 != %4").arg(what).arg(i)
+                                    .arg(actual[i].y(), 0, 'g', 17).arg(expected[i].y(), 0, 'g', 17)));
+        }
+    }
+
+    QList<CorpusShot> m_corpus;
+
+private slots:
+    // Outside failOnWarning: see shotcorpusfixtures.h. Three samples is the
+    // least the derivative has a value for.
+    void initTestCase() {
+        m_corpus = loadCorpus(3);
+        QVERIFY(!m_corpus.isEmpty());
+    }
+
+    void init() { QTest::failOnWarning(); }
+
+    // Every guard sits at 0.05 and every clamp at 15 or 19: walk both sides
+    // of each, plus zero, negative and exactly-on values.
+    void batchFormulasMatchScalarsAtTheGuards() {
+        const QVector<double> values = {
+            -1.0, 0.0, 0.01, 0.0499999, 0.05, 0.0500001, 0.1, 0.3, 1.0,
+            1.9, 2.0, 4.359, 4.36, 6.0, 9.0, 12.0, 19.0, 40.0
+        };
+        QVector<double> pressure, flow;
+        for (double p : values) {
+            for (double f : values) {
+                pressure.append(p);
+                flow.append(f);
+            }
+        }
+        const qsizetype n = pressure.size();
+        QVector<double> c(n), r(n), d(n);
+        Conductance::sampleBatch(pressure.constData(), flow.constData(), c.data(), n);
+        Conductance::resistanceBatch(pressure.constData(), flow.constData(), r.data(), n);
+        Conductance::darcyResistanceBatch(pressure.constData(), flow.constData(), d.data(), n);
+        for (qsizetype i = 0; i < n; ++i) {
+            const double p = pressure[i];
+            const double f = flow[i];
+            QVERIFY2(identical(c[i], Conductance::sample(p, f)), qPrintable(QStringLiteral("sample %1 %2").arg(p).arg(f)));
+            QVERIFY2(identical(r[i], Conductance::resistance(p, f)), qPrintable(QStringLiteral("resistance %1 %2").arg(p).arg(f)));
+            QVERIFY2(identical(d[i], Conductance::darcyResistanceSample(p, f)), qPrintable(QStringLiteral("darcy %1 %2").arg(p).arg(f)));
+        }
+    }
+
+    // Short inputs exercise the head/interior/tail split of the smoothing
+    // (nothing fits the full kernel below 9 samples); repeated and
+    // sub-millisecond timestamps exercise the dt guard.
+    void derivativeMatchesScalarOnShortAndIrregularSeries() {
+        for (int count = 0; count <= 12; ++count) {
+            QVector<QPointF> series;
+            for (int i = 0; i < count; ++i)
+                series.append(QPointF(i * 0.2, std::sin(i * 0.9) * 6.0 + 3.0));
+            checkSame(Conductance::derivative(series), scalarDerivative(series),
+                      QStringLiteral("n=%1").arg(count));
+        }
+
+        QVector<QPointF> irregular;
+        double t = 0.0;
+        for (int i = 0; i < 40; ++i) {
+            t += (i % 7 == 3) ? 0.0 : (i % 5 == 1 ? 0.0004 : 0.25);
+            irregular.append(QPointF(t, (i % 3) * 7.5 - 2.0));
+        }
+        checkSame(Conductance::derivative(irregular), scalarDerivative(irregular),
+                  QStringLiteral("irregular"));
+
+        // Steep enough to hit both clamps.
+        QVector<QPointF> steep;
+        for (int i = 0; i < 30; ++i)
+            steep.append(QPointF(i * 0.1, (i / 5) % 2 ? 19.0 : 0.0));
+        checkSame(Conductance::derivative(steep), scalarDerivative(steep), QStringLiteral("steep"));
+    }
+
+    void derivedCurvesMatchScalarOnCorpus() {
+        for (const CorpusShot& shot : m_corpus) {
+            ShotRecord batch = shot.record;
+            ShotRecord scalar = shot.record;
+            ShotHistoryStorage::computeDerivedCurves(batch);
+            scalarDerivedCurves(scalar);
+            const QString& file = shot.file;
+            checkSame(batch.conductance, scalar.conductance, file + QStringLiteral(" conductance"));
+            checkSame(batch.resistance, scalar.resistance, file + QStringLiteral(" resistance"));
+            checkSame(batch.darcyResistance, scalar.darcyResistance, file + QStringLiteral(" darcy"));
+            checkSame(batch.conductanceDerivative, scalar.conductanceDerivative,
+                      file + QStringLiteral(" derivative"));
+        }
+    }
+
+    void benchmarkCorpusScalar() {
+        QBENCHMARK {
+            for (const CorpusShot& shot : m_corpus) {
+                ShotRecord record = shot.record;
+                scalarDerivedCurves(record);
+            }
+        }
+    }
+
+    void benchmarkCorpusBatch() {
+        QBENCHMARK {
+            for (const CorpusShot& shot : m_corpus) {
+                ShotRecord record = shot.record;
+                ShotHistoryStorage::computeDerivedCurves(record);
+            }
+        }
+    }
+};
+
+QTEST_MAIN(tst_Conductance)
+#include "tst_conductance.moc"
@@ -12,6 +12,7 @@
 #include <QSettings>
 
 #include "history/shothistorystorage.h"
+#include "history/shotanalysiscache.h"
 #include "history/coffeebagstorage.h"
 #include "history/equipmentstorage.h"
 #include "core/appsettings.h"
@@ -31,6 +32,7 @@
 using ShotRowFixtures::withRawDb;
 using ShotRowFixtures::ShotRow;
 using ShotRowFixtures::insertShot;
+using ShotRowFixtures::kLatestSchemaVersion;
 
 using ShotRowFixtures::hasColumn;
 using ShotRowFixtures::hasTable;
@@ -256,7 +258,9 @@ private slots:
             QVERIFY(hasTable(db, "shot_phases"));
             QVERIFY(hasTable(db, "schema_version"));
             QVERIFY(hasTable(db, "recipes"));  // migration 25 (add-recipes)
-            QCOMPARE(getSchemaVersion(db), 38);
+            QVERIFY(hasTable(db, "shot_analysis"));  // migration 40
+            QVERIFY(hasTable(db, "shot_reanalysis_checkpoint"));  // migration 41
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
         });
     }
 
@@ -345,7 +349,7 @@ private slots:
         initAndClose(path, storage);
 
         withRawDb(path, "v1_verify", [](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             QVERIFY(hasColumn(db, "shots", "temperature_override"));
             QVERIFY(hasColumn(db, "shots", "yield_override"));
             QVERIFY(hasColumn(db, "shots", "beverage_type"));
@@ -474,7 +478,7 @@ private slots:
         withRawDb(path, "v9_verify", [](QSqlDatabase& db) {
             QVERIFY(hasColumn(db, "shots", "profile_kb_id"));
             QVERIFY(hasIndex(db, "idx_shots_profile_kb_id"));
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
         });
     }
 
@@ -488,7 +492,7 @@ private slots:
         { ShotHistoryStorage s; initAndClose(path, s); }
 
         withRawDb(path, "idempotent", [](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
         });
     }
 
@@ -520,7 +524,7 @@ private slots:
         { ShotHistoryStorage s; initAndClose(path, s); }  // runs migration 30
 
         withRawDb(path, "v29_verify30", [&](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             QSqlQuery q(db);
             QVERIFY(q.exec(QString("SELECT grind_pinned, rpm_pinned FROM recipes "
                                    "WHERE id = %1").arg(recipeId)));
@@ -555,7 +559,7 @@ private slots:
         { ShotHistoryStorage s; initAndClose(path, s); }  // runs migration 31
 
         withRawDb(path, "v30_verify31", [&](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             QSqlQuery q(db);
             QVERIFY(q.exec(QString("SELECT temp_offset_c, temp_override_c FROM recipes "
                                    "WHERE id = %1").arg(recipeId)));
@@ -596,7 +600,7 @@ private slots:
         { ShotHistoryStorage s; initAndClose(path, s); }  // runs migration 32
 
         withRawDb(path, "v31_verify32", [&](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             QVERIFY(hasColumn(db, "shots", "storage_hint"));
             QVERIFY(hasColumn(db, "shots", "opened_date"));
             QVERIFY(hasColumn(db, "coffee_bags", "storage_hint"));
@@ -635,7 +639,7 @@ private slots:
         { ShotHistoryStorage s; initAndClose(path, s); }  // runs migration 33
 
         withRawDb(path, "v32_verify33", [&](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             QVERIFY(hasColumn(db, "shots", "taste_balance"));
             QVERIFY(hasColumn(db, "shots", "taste_body"));
             QVERIFY(!hasColumn(db, "coffee_bags", "taste_balance"));
@@ -692,7 +696,7 @@ private slots:
         { ShotHistoryStorage s; initAndClose(path, s); }  // runs migration 36
 
         withRawDb(path, "v36_verify", [&](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             QSqlQuery q(db);
             // The stranded shot now hangs off the surviving package.
             QVERIFY(q.exec(QStringLiteral("SELECT equipment_id FROM shots WHERE id = %1")
@@ -759,7 +763,7 @@ private slots:
         // one that the second fold deleted.
         QCOMPARE(healedTo, full);
         withRawDb(path, "v36_active_verify", [&](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             QSqlQuery q(db);
             QVERIFY(q.exec(QStringLiteral("SELECT COUNT(*) FROM equipment_packages WHERE id IN (%1,%2)")
                                .arg(bare1).arg(mid)));
@@ -802,7 +806,7 @@ private slots:
         { ShotHistoryStorage s; initAndClose(path, s); }  // runs migration 34
 
         withRawDb(path, "v34_verify", [&](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             QSqlQuery q(db);
             QVERIFY(q.exec("SELECT yield_value, yield_mode, yield_g FROM recipes WHERE name = 'With'"));
             QVERIFY(q.next());
@@ -899,7 +903,7 @@ private slots:
         QCoreApplication::processEvents();
 
         withRawDb(path, "empty_verify", [](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
         });
     }
 
@@ -921,7 +925,7 @@ private slots:
         QCoreApplication::processEvents();
 
         withRawDb(path, "null_verify", [](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             QSqlQuery q(db);
             // grinder_brand was dropped in migration 23; grinder_setting (the
             // surviving per-shot dial-in) exercises the same NULL-tolerance path.
@@ -1101,7 +1105,7 @@ private slots:
                 }
             }
         });
-        QCOMPARE(versionFound, 38);  // latest after full chain
+        QCOMPARE(versionFound, kLatestSchemaVersion);  // latest after full chain
         QVERIFY2(!hasEnjoymentSource,
                  "enjoyment_source column must be absent after migration 16");
     }
@@ -1339,7 +1343,7 @@ private slots:
             }
         });
 
-        QCOMPARE(versionFound, 38);  // latest after full chain
+        QCOMPARE(versionFound, kLatestSchemaVersion);  // latest after full chain
         QVERIFY2(columnGone, "enjoyment_source column must be dropped");
         // Inferred rows reset to 0 (unrated), NOT to the stale 50 seeded
         // above — an app-invented rating becomes unrated, and the back-sync
@@ -1677,7 +1681,7 @@ private slots:
         { ShotHistoryStorage s; initAndClose(path, s); }
 
         withRawDb(path, "v21_verify", [](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             QVERIFY(hasColumn(db, "coffee_bags", "yield_override_g"));
             QVERIFY(!hasColumn(db, "coffee_bags", "yield_target_g"));
             QSqlQuery q(db);
@@ -1711,7 +1715,7 @@ private slots:
         { ShotHistoryStorage s; initAndClose(path, s); }
 
         withRawDb(path, "v28_verify", [](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             QVERIFY(hasColumn(db, "recipes", "drink_type"));
             QVERIFY(hasColumn(db, "coffee_bags", "kind"));
             QSqlQuery q(db);
@@ -1791,7 +1795,7 @@ private slots:
         { ShotHistoryStorage s; initAndClose(path, s); }
 
         withRawDb(path, "v20_after_retry", [&](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             // The retry ran the WHOLE deferred chain, not just migration 20:
             // migration 21's rename landed too (post-condition column present).
             QVERIFY(hasColumn(db, "coffee_bags", "yield_override_g"));
@@ -1837,7 +1841,7 @@ private slots:
         { ShotHistoryStorage s; initAndClose(path, s); }
 
         withRawDb(path, "v21_after_retry", [](QSqlDatabase& db) {
-            QCOMPARE(getSchemaVersion(db), 38);
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
             QVERIFY(hasColumn(db, "coffee_bags", "yield_override_g"));
             QVERIFY(!hasColumn(db, "coffee_bags", "yield_target_g"));
             QSqlQuery q(db);
@@ -1904,7 +1908,7 @@ private slots:
         };
 
         { ShotHistoryStorage s; initAndClose(path, s); }
-        withRawDb(path, "v22_ver", [](QSqlDatabase& db) { QCOMPARE(getSchemaVersion(db), 38); });
+        withRawDb(path, "v22_ver", [](QSqlDatabase& db) { QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion); });
         QCOMPARE(packageCount(), 1);             // default package created from current settings
         { ShotHistoryStorage s; initAndClose(path, s); }
         QCOMPARE(packageCount(), 1);             // gate prevented a duplicate on re-init
@@ -1971,6 +1975,182 @@ private slots:
         });
     }
 
+    // ==========================================
+    // Migration 39: debug_log / profile_json side tables
+    // ==========================================
+
+    // Rewinds a migrated database to the v38 shape (blobs inline on `shots`,
+    // no side tables), seeds three shots — two sharing one profile — and
+    // re-runs the chain. The profiles must dedupe by content, the log must
+    // move, both columns must go, and reads must come back unchanged through
+    // the joins. Then the cleanup paths: the trigger drops a profile with its
+    // last shot, and the cascade drops a log with its shot.
+    void v39_movesColdBlobsToSideTables() {
+        const QString path = freshDbPath();
+        { ShotHistoryStorage s; initAndClose(path, s); }
+
+        const QString profileA = QStringLiteral(R"({"title":"A","target_weight":36})");
+        const QString profileB = QStringLiteral(R"({"title":"B"})");
+        qint64 ids[3] = {-1, -1, -1};
+        withRawDb(path, "v39_rewind", [&](QSqlDatabase& db) {
+            QSqlQuery q(db);
+            QVERIFY(q.exec("DROP TRIGGER shots_profile_gc"));
+            QVERIFY(q.exec("DROP INDEX idx_shots_profile_hash"));
+            QVERIFY(q.exec("ALTER TABLE shots DROP COLUMN profile_hash"));
+            QVERIFY(q.exec("DROP TABLE shot_debug_logs"));
+            QVERIFY(q.exec("DROP TABLE shot_profiles"));
+            QVERIFY(q.exec("ALTER TABLE shots ADD COLUMN profile_json TEXT"));
+            QVERIFY(q.exec("ALTER TABLE shots ADD COLUMN debug_log TEXT"));
+            q.exec("DELETE FROM schema_version");
+            q.exec("INSERT INTO schema_version (version) VALUES (38)");
+
+            const QString profiles[3] = {profileA, profileA, profileB};
+            const QString logs[3] = {QStringLiteral("line 1\nline 2"), QString(), QString()};
+            for (int i = 0; i < 3; ++i) {
+                q.prepare("INSERT INTO shots (uuid, timestamp, profile_name, duration_seconds, "
+                          "profile_json, debug_log) VALUES (?, ?, 'P', 30, ?, ?)");
+                q.addBindValue(QStringLiteral("v39-%1").arg(i));
+                q.addBindValue(1000 + i);
+                q.addBindValue(profiles[i]);
+                q.addBindValue(logs[i]);
+                QVERIFY2(q.exec(), qPrintable(q.lastError().text()));
+                ids[i] = q.lastInsertId().toLongLong();
+            }
+        });
+
+        { ShotHistoryStorage s; initAndClose(path, s); }
+
+        withRawDb(path, "v39_verify", [&](QSqlDatabase& db) {
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
+            QVERIFY(!hasColumn(db, "shots", "profile_json"));
+            QVERIFY(!hasColumn(db, "shots", "debug_log"));
+            QVERIFY(hasColumn(db, "shots", "profile_hash"));
+
+            QSqlQuery q(db);
+            QVERIFY(q.exec("SELECT COUNT(*) FROM shot_profiles") && q.next());
+            QCOMPARE(q.value(0).toInt(), 2);   // A stored once for two shots
+            QVERIFY(q.exec("SELECT COUNT(*) FROM shot_debug_logs") && q.next());
+            QCOMPARE(q.value(0).toInt(), 1);   // empty logs write no row
+
+            const ShotRecord first = ShotHistoryStorage::loadShotRecordStatic(db, ids[0]);
+            QCOMPARE(first.profileJson, profileA);
+            QCOMPARE(first.debugLog, QStringLiteral("line 1\nline 2"));
+            const ShotRecord third = ShotHistoryStorage::loadShotRecordStatic(db, ids[2]);
+            QCOMPARE(third.profileJson, profileB);
+            QVERIFY(third.debugLog.isEmpty());
+
+            q.prepare("DELETE FROM shots WHERE id = ?");
+            q.addBindValue(ids[2]);
+            QVERIFY(q.exec());
+            q.prepare("DELETE FROM shots WHERE id = ?");
+            q.addBindValue(ids[0]);
+            QVERIFY(q.exec());
+            QVERIFY(q.exec("SELECT COUNT(*) FROM shot_profiles") && q.next());
+            QCOMPARE(q.value(0).toInt(), 1);   // B gone; A still named by the second shot
+            QVERIFY(q.exec("SELECT COUNT(*) FROM shot_debug_logs") && q.next());
+            QCOMPARE(q.value(0).toInt(), 0);
+        });
+    }
+
+    // ==========================================
+    // Migration 40: derived-curve stamp and stored analysis
+    // ==========================================
+
+    // Rewinds to the v39 shape (no shot_analysis, no derived_version) with one
+    // imported shot already in it, re-runs the chain, and checks the upgrade
+    // leaves the shot unstamped — nothing in it was verified under the current
+    // algorithm — until the first full load stamps the curves and stores the
+    // analysis under the current fingerprint.
+    void v40_addsDerivedStampAndAnalysisTable() {
+        const QString path = freshDbPath();
+        qint64 shotId = -1;
+        {
+            ShotHistoryStorage s;
+            QVERIFY(s.initialize(path));
+            ShotRecord rec;
+            rec.summary.uuid = QStringLiteral("v40-1");
+            rec.summary.timestamp = 1000;
+            rec.summary.profileName = QStringLiteral("P");
+            rec.summary.duration = 30.0;
+            for (int i = 0; i < 40; ++i) {
+                const double t = i * 0.25;
+                rec.pressure.append(QPointF(t, qMin(9.0, t)));
+                rec.flow.append(QPointF(t, 2.0));
+            }
+            shotId = s.importShotRecord(rec);
+            QVERIFY(shotId > 0);
+            s.close();
+        }
+        withRawDb(path, "v40_rewind", [&](QSqlDatabase& db) {
+            QSqlQuery q(db);
+            QVERIFY(q.exec("DROP TABLE shot_analysis"));
+            QVERIFY(q.exec("ALTER TABLE shot_samples DROP COLUMN derived_version"));
+            q.exec("DELETE FROM schema_version");
+            q.exec("INSERT INTO schema_version (version) VALUES (39)");
+        });
+
+        { ShotHistoryStorage s; initAndClose(path, s); }
+
+        withRawDb(path, "v40_verify", [&](QSqlDatabase& db) {
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
+            QVERIFY(hasTable(db, "shot_analysis"));
+            QVERIFY(hasColumn(db, "shot_samples", "derived_version"));
+
+            QSqlQuery q(db);
+            QVERIFY(q.exec("SELECT derived_version FROM shot_samples") && q.next());
+            QCOMPARE(q.value(0).toInt(), 0);
+            QVERIFY(q.exec("SELECT COUNT(*) FROM shot_analysis") && q.next());
+            QCOMPARE(q.value(0).toInt(), 0);
+            q.finish();
+
+            const ShotRecord r = ShotHistoryStorage::loadShotRecordStatic(db, shotId);
+            QVERIFY(r.cachedAnalysis.has_value());
+
+            QVERIFY(q.exec("SELECT derived_version FROM shot_samples") && q.next());
+            QCOMPARE(q.value(0).toInt(), Conductance::kAlgorithmVersion);
+            QVERIFY(q.exec("SELECT shot_id, fingerprint FROM shot_analysis") && q.next());
+            QCOMPARE(q.value(0).toLongLong(), shotId);
+            QCOMPARE(q.value(1).toLongLong(), ShotAnalysisCache::kFingerprint);
+            q.finish();
+
+            // The cascade drops the row with its shot.
+            q.prepare("DELETE FROM shots WHERE id = ?");
+            q.addBindValue(shotId);
+            QVERIFY(q.exec());
+            QVERIFY(q.exec("SELECT COUNT(*) FROM shot_analysis") && q.next());
+            QCOMPARE(q.value(0).toInt(), 0);
+        });
+    }
+
+    // ==========================================================================
+    // Migration 41: history re-analysis checkpoint
+    // ==========================================================================
+
+    void v41_addsReanalysisCheckpoint() {
+        const QString path = freshDbPath();
+        { ShotHistoryStorage s; initAndClose(path, s); }
+        withRawDb(path, "v41_rewind", [](QSqlDatabase& db) {
+            QSqlQuery q(db);
+            QVERIFY(q.exec("DROP TABLE shot_reanalysis_checkpoint"));
+            q.exec("DELETE FROM schema_version");
+            q.exec("INSERT INTO schema_version (version) VALUES (40)");
+        });
+
+        { ShotHistoryStorage s; initAndClose(path, s); }
+
+        withRawDb(path, "v41_verify", [](QSqlDatabase& db) {
+            QCOMPARE(getSchemaVersion(db), kLatestSchemaVersion);
+            QVERIFY(hasTable(db, "shot_reanalysis_checkpoint"));
+
+            // Single-row table: the CHECK refuses a second cursor.
+            QSqlQuery q(db);
+            QVERIFY(q.exec("INSERT INTO shot_reanalysis_checkpoint (id, fingerprint, before_id, done) "
+                           "VALUES (1, 1, 100, 5)"));
+            QVERIFY(!q.exec("INSERT INTO shot_reanalysis_checkpoint (id, fingerprint, before_id, done) "
+                            "VALUES (2, 1, 50, 10)"));
+        });
+    }
+
     // loadShotRecordStatic resolves grinder brand/model/burrs through the
     // equipment_id JOIN (the per-shot columns are gone — migration 23) and
     // derives equipmentState from the package's in_inventory + superseded_by
@@ -0,0 +1,327 @@
+#include <QtTest>
+
+#include <QRegularExpression>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+#include "core/dbutils.h"
+
+// DbConnectionPool + PreparedQuery — the long-lived connection withTempDb
+// borrows on a thread that pools its database (every SerialDbWorker).
+//
+// Most cases run on the test's own thread, which opts in with
+// poolOnCurrentThread() exactly as a worker's task does, so each one can look
+// at the pool's state between calls without marshaling. The worker case is the
+// one that checks the real wiring, including the release on thread exit.
+class tst_DbPool : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+    void cleanup();
+
+    void pooledThreadReusesOneConnection();
+    void unpooledPathStillGetsATemporaryConnection();
+    void statementCacheServesTheSamePreparedQuery();
+    void statementCacheIsBoundedAndEvictsLeastRecentlyUsed();
+    void nestedCallGetsItsOwnConnection();
+    void openTransactionIsRolledBackAtCheckin();
+    void idleConnectionHoldsNoReadSnapshot();
+    void workerReleasesItsConnectionsOnDestruction();
+
+    void perTaskLatency_data();
+    void perTaskLatency();
+
+private:
+    QTemporaryDir m_dir;
+    int m_seq = 0;
+    QString m_path;
+
+    // Fresh WAL file per test, seeded through a temporary connection so the
+    // pool starts every test empty.
+    void seed(int rows = 3) {
+        m_path = m_dir.filePath(QStringLiteral("p%1.db").arg(++m_seq));
+        QVERIFY(withTempDb(m_path, QStringLiteral("seed"), [&](QSqlDatabase& db) {
+            QSqlQuery q(db);
+            q.exec(QStringLiteral("PRAGMA journal_mode = WAL"));  // as shots.db
+            q.exec(QStringLiteral("CREATE TABLE t(id INTEGER PRIMARY KEY, v TEXT)"));
+            for (int i = 1; i <= rows; ++i)
+                q.exec(QStringLiteral("INSERT INTO t(id, v) VALUES(%1, 'v%1')").arg(i));
+        }));
+    }
+    static int count(QSqlDatabase& db) {
+        QSqlQuery q(db);
+        return q.exec(QStringLiteral("SELECT COUNT(*) FROM t")) && q.next() ? q.value(0).toInt() : -1;
+    }
+    static bool anyPooledConnection() {
+        for (const QString& name : QSqlDatabase::connectionNames()) {
+            if (name.startsWith(QLatin1String("dbpool_")))
+                return true;
+        }
+        return false;
+    }
+};
+
+void tst_DbPool::cleanup()
+{
+    DbConnectionPool::releaseCurrentThread();
+    QVERIFY(!anyPooledConnection());
+}
+
+void tst_DbPool::pooledThreadReusesOneConnection()
+{
+    seed();
+    DbConnectionPool::poolOnCurrentThread(m_path);
+
+    // A TEMP table lives exactly as long as its connection: visible to the
+    // second call only if both ran on the same one.
+    QString first;
+    QVERIFY(withTempDb(m_path, QStringLiteral("a"), [&](QSqlDatabase& db) {
+        first = db.connectionName();
+        QVERIFY(QSqlQuery(db).exec(QStringLiteral("CREATE TEMP TABLE scratch(x)")));
+    }));
+    QVERIFY(withTempDb(m_path, QStringLiteral("b"), [&](QSqlDatabase& db) {
+        QCOMPARE(db.connectionName(), first);
+        QVERIFY(QSqlQuery(db).exec(QStringLiteral("SELECT x FROM temp.scratch")));
+        QCOMPARE(count(db), 3);
+    }));
+    QVERIFY(first.startsWith(QLatin1String("dbpool_")));
+    QCOMPARE(DbConnectionPool::openConnectionCount(), 1);
+
+    DbConnectionPool::releaseCurrentThread();
+    QCOMPARE(DbConnectionPool::openConnectionCount(), 0);
+
+    // Still opted in: the next call reopens, and the TEMP table is gone with
+    // the old connection.
+    QVERIFY(withTempDb(m_path, QStringLiteral("c"), [&](QSqlDatabase& db) {
+        QVERIFY(!QSqlQuery(db).exec(QStringLiteral("SELECT x FROM temp.scratch")));
+    }));
+    QCOMPARE(DbConnectionPool::openConnectionCount(), 1);
+}
+
+void tst_DbPool::unpooledPathStillGetsATemporaryConnection()
+{
+    seed();
+    const QString pooled = m_path;
+    DbConnectionPool::poolOnCurrentThread(pooled);
+    seed();  // a second file this thread never opted in for — an import source, say
+
+    QVERIFY(withTempDb(m_path, QStringLiteral("import"), [&](QSqlDatabase& db) {
+        QVERIFY(db.connectionName().startsWith(QLatin1String("import_")));
+        QCOMPARE(count(db), 3);
+    }));
+    QCOMPARE(DbConnectionPool::openConnectionCount(), 0);
+    QVERIFY(!QSqlDatabase::connectionNames().contains(QStringLiteral("import_%1")
+        .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()), 0, 16)));
+}
+
+void tst_DbPool::statementCacheServesTheSamePreparedQuery()
+{
+    seed();
+    DbConnectionPool::poolOnCurrentThread(m_path);
+    const QString sql = QStringLiteral("SELECT v FROM t WHERE id = ?");
+
+    QSqlQuery* first = nullptr;
+    for (int id = 1; id <= 3; ++id) {
+        QVERIFY(withTempDb(m_path, QStringLiteral("read"), [&](QSqlDatabase& db) {
+            PreparedQuery q(db, sql);
+            QVERIFY(q.ok());
+            QVERIFY(q.isCached());
+            if (!first)
+                first = &*q;
+            QCOMPARE(&*q, first);   // the same prepared statement, rebound
+            q->bindValue(0, id);
+            QVERIFY(q->exec());
+            QVERIFY(q->next());
+            QCOMPARE(q->value(0).toString(), QStringLiteral("v%1").arg(id));
+        }));
+    }
+
+    // The same SQL twice in one frame: the second can't share the borrowed
+    // statement, so it runs uncached instead of clobbering the first's cursor.
+    QVERIFY(withTempDb(m_path, QStringLiteral("twice"), [&](QSqlDatabase& db) {
+        PreparedQuery outer(db, sql);
+        PreparedQuery inner(db, sql);
+        QVERIFY(outer.isCached());
+        QVERIFY(!inner.isCached());
+        QVERIFY(inner.ok());
+    }));
+
+    // Off the pool it is an ordinary one-shot query, with the prepare error
+    // reported the usual way.
+    QVERIFY(withTempDb(m_dir.filePath(QStringLiteral("elsewhere.db")), QStringLiteral("x"),
+                       [&](QSqlDatabase& db) {
+        PreparedQuery q(db, QStringLiteral("SELECT nope FROM missing"));
+        QVERIFY(!q.isCached());
+        QVERIFY(!q.ok());
+        QVERIFY(q->lastError().isValid());
+    }));
+}
+
+void tst_DbPool::statementCacheIsBoundedAndEvictsLeastRecentlyUsed()
+{
+    seed();
+    DbConnectionPool::poolOnCurrentThread(m_path);
+    const auto sqlFor = [](int i) { return QStringLiteral("SELECT %1 FROM t").arg(i); };
+
+    QSqlQuery* hot = nullptr;
+    QVERIFY(withTempDb(m_path, QStringLiteral("fill"), [&](QSqlDatabase& db) {
+        { PreparedQuery q(db, sqlFor(0)); hot = &*q; }
+        for (int i = 1; i <= DbConnectionPool::kStatementCacheSize + 8; ++i) {
+            PreparedQuery q(db, sqlFor(i));
+            QVERIFY(q.isCached());
+            // Keep statement 0 the most recently used, so it survives every trim.
+            PreparedQuery keep(db, sqlFor(0));
+            QCOMPARE(&*keep, hot);
+        }
+        DbConnectionPool::Connection* conn = DbConnectionPool::checkedOut(db);
+        QVERIFY(conn);
+        QCOMPARE(static_cast<int>(conn->statements.size()), DbConnectionPool::kStatementCacheSize);
+        // Statement 1 was the least recently used, so it went first.
+        for (const auto& st : conn->statements)
+            QVERIFY(st->sql != sqlFor(1));
+    }));
+}
+
+void tst_DbPool::nestedCallGetsItsOwnConnection()
+{
+    seed();
+    DbConnectionPool::poolOnCurrentThread(m_path);
+
+    QVERIFY(withTempDb(m_path, QStringLiteral("outer"), [&](QSqlDatabase& outer) {
+        DbWriteTxn txn = DbWriteTxn::begin(outer, "outer");
+        QVERIFY(txn.ok());
+        QVERIFY(QSqlQuery(outer).exec(QStringLiteral("INSERT INTO t(v) VALUES('outer')")));
+
+        // The inner frame must not join the outer transaction: it gets a
+        // temporary connection, which sees only committed data.
+        QVERIFY(withTempDb(m_path, QStringLiteral("inner"), [&](QSqlDatabase& inner) {
+            QVERIFY(inner.connectionName() != outer.connectionName());
+            QVERIFY(!DbConnectionPool::checkedOut(inner));
+            QCOMPARE(count(inner), 3);
+        }));
+        QVERIFY(txn.commit());
+    }));
+    QCOMPARE(DbConnectionPool::openConnectionCount(), 1);
+}
+
+void tst_DbPool::openTransactionIsRolledBackAtCheckin()
+{
+    seed();
+    DbConnectionPool::poolOnCurrentThread(m_path);
+
+    QTest::ignoreMessage(QtWarningMsg,
+        QRegularExpression(QStringLiteral("withTempDb: \"leaky\" returned with a transaction still open")));
+    QVERIFY(withTempDb(m_path, QStringLiteral("leaky"), [&](QSqlDatabase& db) {
+        QVERIFY(QSqlQuery(db).exec(QStringLiteral("BEGIN IMMEDIATE")));
+        QVERIFY(QSqlQuery(db).exec(QStringLiteral("INSERT INTO t(v) VALUES('never committed')")));
+    }));
+
+    // Rolled back, and the write lock with it: the next task — on the same
+    // pooled connection — can take a fresh one.
+    QVERIFY(withTempDb(m_path, QStringLiteral("next"), [&](QSqlDatabase& db) {
+        QCOMPARE(count(db), 3);
+        DbWriteTxn txn = DbWriteTxn::begin(db, "next", 1);
+        QVERIFY(txn.ok());
+        QVERIFY(txn.commit());
+    }));
+}
+
+// A cached statement abandoned mid-result would keep its read snapshot, and a
+// checkpoint cannot truncate the WAL past a snapshot a reader still holds.
+void tst_DbPool::idleConnectionHoldsNoReadSnapshot()
+{
+    seed();
+    DbConnectionPool::poolOnCurrentThread(m_path);
+
+    QVERIFY(withTempDb(m_path, QStringLiteral("read"), [&](QSqlDatabase& db) {
+        PreparedQuery q(db, QStringLiteral("SELECT v FROM t ORDER BY id"));
+        QVERIFY(q->exec());
+        QVERIFY(q->next());   // one row of three — the statement is still active
+    }));
+    QCOMPARE(DbConnectionPool::openConnectionCount(), 1);
+
+    // From a connection outside the pool, as the checkpointing writer would be.
+    const QString probeName = QStringLiteral("probe");
+    {
+        QSqlDatabase probe = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), probeName);
+        probe.setDatabaseName(m_path);
+        QVERIFY(probe.open());
+        QVERIFY(QSqlQuery(probe).exec(QStringLiteral("INSERT INTO t(v) VALUES('more')")));
+        QSqlQuery cp(probe);
+        QVERIFY(cp.exec(QStringLiteral("PRAGMA wal_checkpoint(TRUNCATE)")));
+        QVERIFY(cp.next());
+        const int busy = cp.value(0).toInt();
+        cp.finish();
+        probe.close();
+        QCOMPARE(busy, 0);   // no reader held it back
+    }
+    QSqlDatabase::removeDatabase(probeName);
+}
+
+void tst_DbPool::workerReleasesItsConnectionsOnDestruction()
+{
+    seed();
+    QObject receiver;
+    auto destroyed = std::make_shared<std::atomic<bool>>(false);
+    QStringList names;
+    {
+        SerialDbWorker worker(QStringLiteral("tst_dbpool"));
+        for (int i = 0; i < 3; ++i) {
+            worker.run(m_path, QStringLiteral("task"),
+                       [&names](QSqlDatabase& db) { names << db.connectionName(); },
+                       [](bool dbOpened) { QVERIFY(dbOpened); },
+                       &receiver, destroyed);
+        }
+        QTRY_VERIFY(worker.isIdle());
+        QCOMPARE(names.size(), 3);
+        QVERIFY(names.first().startsWith(QLatin1String("dbpool_")));
+        QCOMPARE(names.count(names.first()), 3);   // one connection for all three
+        QVERIFY(anyPooledConnection());
+
+        // An owner about to delete the file releases first, and the call
+        // returns only once the worker has closed it.
+        worker.releasePooledConnections();
+        QVERIFY(!anyPooledConnection());
+
+        worker.run(m_path, QStringLiteral("task"),
+                   [](QSqlDatabase&) {}, [](bool) {}, &receiver, destroyed);
+        QTRY_VERIFY(worker.isIdle());
+        QVERIFY(anyPooledConnection());   // reopened on demand
+    }
+    // Joined, and released on the worker thread as it finished.
+    QVERIFY(!anyPooledConnection());
+    QVERIFY(QFile::remove(m_path));
+}
+
+void tst_DbPool::perTaskLatency_data()
+{
+    QTest::addColumn<bool>("pooled");
+    QTest::newRow("temporary connection") << false;
+    QTest::newRow("pooled connection") << true;
+}
+
+// A storage-worker-sized task: one keyed lookup, as loadShotRecordStatic and
+// most of the per-shot reads are.
+void tst_DbPool::perTaskLatency()
+{
+    QFETCH(bool, pooled);
+    seed(200);
+    if (pooled)
+        DbConnectionPool::poolOnCurrentThread(m_path);
+
+    int id = 0;
+    QBENCHMARK {
+        withTempDb(m_path, QStringLiteral("bench"), [&](QSqlDatabase& db) {
+            PreparedQuery q(db, QStringLiteral("SELECT v FROM t WHERE id = ?"));
+            q->bindValue(0, id++ % 200 + 1);
+            if (!q->exec() || !q->next())
+                QFAIL("lookup failed");
+        });
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_DbPool)
+#include "tst_dbpool.moc"
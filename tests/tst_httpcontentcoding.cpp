@@ -0,0 +1,246 @@
+// HttpContentCoding — ShotServer's Accept-Encoding negotiation, gzip/deflate
+// encoders and ETag validators.
+//
+// The encoders are built on qCompress rather than zlib directly, so the tests
+// check the framing a browser will decode: deflate must be a plain zlib
+// stream, gzip a member with the right header, CRC-32 and length. The
+// transfer case encodes the pages served from webtemplates/ and checks that
+// each coding at least halves them and a revalidation is headers only; its
+// QBENCHMARK is the encode time each costs the thread answering the request.
+// Shot list/detail pages need a live database;
+// scripts/measure_web_transfer.py measures those against a running device.
+
+#include <QtTest>
+#include <QtEndian>
+
+#include "network/httpcontentcoding.h"
+#include "network/webtemplates.h"
+#include "network/webtemplates/auth_page.h"
+#include "network/webtemplates/grind_datalist_js.h"
+#include "network/webtemplates/management_css.h"
+#include "network/webtemplates/management_html.h"
+#include "network/webtemplates/management_js.h"
+#include "network/webtemplates/theme_page.h"
+
+using HttpContentCoding::Coding;
+
+namespace {
+
+quint32 adler32(QByteArrayView data)
+{
+    quint32 a = 1, b = 0;
+    for (const char c : data) {
+        a = (a + static_cast<quint8>(c)) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+// Inflates a deflate-coded body through qUncompress, which wants its own
+// 4-byte length prefix in front of the zlib stream.
+QByteArray inflateZlib(const QByteArray& zlib, qsizetype expectedSize)
+{
+    char prefix[4];
+    qToBigEndian<quint32>(static_cast<quint32>(expectedSize), prefix);
+    return qUncompress(QByteArray(prefix, 4) + zlib);
+}
+
+QByteArray managementPage()
+{
+    // Assembled the way the recipes/beans/equipment pages assemble theirs.
+    QString html = QStringLiteral("<!DOCTYPE html><html><head><style>");
+    html += WEB_CSS_VARIABLES;
+    html += WEB_CSS_HEADER;
+    html += WEB_CSS_MENU;
+    html += WEB_CSS_MANAGEMENT;
+    html += QStringLiteral("</style></head><body>");
+    html += generateManagementHeader(QStringLiteral("Recipes"));
+    html += QStringLiteral("<script>");
+    html += WEB_JS_MENU;
+    html += WEB_JS_POWER_CONTROL;
+    html += WEB_JS_MANAGEMENT;
+    html += WEB_JS_GRIND_DATALIST;
+    html += QStringLiteral("</script>");
+    html += generateVitalStatsScript();
+    html += QStringLiteral("</body></html>");
+    return html.toUtf8();
+}
+
+}  // namespace
+
+class TstHttpContentCoding : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+
+    void negotiate_data()
+    {
+        QTest::addColumn<QByteArray>("acceptEncoding");
+        QTest::addColumn<Coding>("expected");
+        QTest::newRow("absent") << QByteArray() << Coding::Identity;
+        QTest::newRow("chrome") << QByteArray("gzip, deflate, br, zstd") << Coding::Gzip;
+        QTest::newRow("deflate only") << QByteArray("deflate") << Coding::Deflate;
+        QTest::newRow("case") << QByteArray("GZip") << Coding::Gzip;
+        QTest::newRow("x-gzip") << QByteArray("x-gzip") << Coding::Gzip;
+        QTest::newRow("br only") << QByteArray("br") << Coding::Identity;
+        QTest::newRow("identity") << QByteArray("identity") << Coding::Identity;
+        QTest::newRow("gzip refused") << QByteArray("gzip;q=0, deflate") << Coding::Deflate;
+        QTest::newRow("deflate preferred") << QByteArray("gzip;q=0.5, deflate;q=0.8") << Coding::Deflate;
+        QTest::newRow("spaces") << QByteArray("deflate ; q=0.2 ,gzip ;q=0.9") << Coding::Gzip;
+        QTest::newRow("star") << QByteArray("*") << Coding::Gzip;
+        QTest::newRow("star refused") << QByteArray("br, *;q=0") << Coding::Identity;
+        QTest::newRow("star except gzip") << QByteArray("gzip;q=0, *") << Coding::Deflate;
+        QTest::newRow("all refused") << QByteArray("gzip;q=0.000, deflate;q=0") << Coding::Identity;
+    }
+
+    void negotiate()
+    {
+        QFETCH(QByteArray, acceptEncoding);
+        QFETCH(Coding, expected);
+        QCOMPARE(HttpContentCoding::negotiate(acceptEncoding), expected);
+    }
+
+    void compressibleTypes()
+    {
+        QVERIFY(HttpContentCoding::isCompressible("text/html; charset=utf-8"));
+        QVERIFY(HttpContentCoding::isCompressible("text/plain"));
+        QVERIFY(HttpContentCoding::isCompressible("application/json"));
+        QVERIFY(HttpContentCoding::isCompressible("application/x-ndjson"));
+        QVERIFY(HttpContentCoding::isCompressible("image/svg+xml"));
+        QVERIFY(HttpContentCoding::isCompressible("application/manifest+json"));
+        QVERIFY(!HttpContentCoding::isCompressible("image/png"));
+        QVERIFY(!HttpContentCoding::isCompressible("application/zip"));
+        QVERIFY(!HttpContentCoding::isCompressible("application/x-sqlite3"));
+        QVERIFY(!HttpContentCoding::isCompressible("application/octet-stream"));
+
+        QVERIFY(!HttpContentCoding::shouldCompress("text/html", HttpContentCoding::kMinCompressSize - 1));
+        QVERIFY(HttpContentCoding::shouldCompress("text/html", HttpContentCoding::kMinCompressSize));
+        QVERIFY(!HttpContentCoding::shouldCompress("text/html", HttpContentCoding::kMaxCompressSize + 1));
+    }
+
+    // "deflate" in HTTP is the zlib format (RFC 9110 8.4.1.2).
+    void deflateIsZlibStream()
+    {
+        const QByteArray body = managementPage();
+        const QByteArray deflate = HttpContentCoding::encode(body, Coding::Deflate);
+        QVERIFY(deflate.size() < body.size());
+        QCOMPARE(static_cast<quint8>(deflate[0]) & 0x0F, 8);          // CM = deflate
+        QCOMPARE(((static_cast<quint8>(deflate[0]) << 8) | static_cast<quint8>(deflate[1])) % 31, 0);
+        QCOMPARE(qFromBigEndian<quint32>(deflate.constData() + deflate.size() - 4), adler32(body));
+        QCOMPARE(inflateZlib(deflate, body.size()), body);
+    }
+
+    void gzipMember()
+    {
+        const QByteArray body = managementPage();
+        const QByteArray gzip = HttpContentCoding::encode(body, Coding::Gzip);
+        QVERIFY(gzip.size() < body.size());
+        QCOMPARE(static_cast<quint8>(gzip[0]), quint8(0x1f));
+        QCOMPARE(static_cast<quint8>(gzip[1]), quint8(0x8b));
+        QCOMPARE(static_cast<quint8>(gzip[2]), quint8(8));    // CM = deflate
+        QCOMPARE(static_cast<quint8>(gzip[3]), quint8(0));    // no FTEXT/FNAME/...
+        QCOMPARE(qFromLittleEndian<quint32>(gzip.constData() + gzip.size() - 4),
+                 static_cast<quint32>(body.size()));
+
+        // The raw deflate data is the same as the deflate coding's, so it
+        // inflates to the body when given the zlib framing back.
+        const QByteArray raw = gzip.sliced(10, gzip.size() - 18);
+        char adler[4];
+        qToBigEndian<quint32>(adler32(body), adler);
+        QCOMPARE(inflateZlib(QByteArray("\x78\x9c", 2) + raw + QByteArray(adler, 4), body.size()), body);
+    }
+
+    // Check value from the CRC-32 catalogue (CRC-32/ISO-HDLC).
+    void gzipCrc()
+    {
+        const QByteArray body("123456789");
+        const QByteArray gzip = HttpContentCoding::encode(body, Coding::Gzip);
+        QCOMPARE(qFromLittleEndian<quint32>(gzip.constData() + gzip.size() - 8), quint32(0xCBF43926));
+    }
+
+    void identityIsUnchanged()
+    {
+        QCOMPARE(HttpContentCoding::encode("plain", Coding::Identity), QByteArray("plain"));
+        QVERIFY(HttpContentCoding::token(Coding::Identity).isEmpty());
+        QCOMPARE(HttpContentCoding::token(Coding::Gzip).toByteArray(), QByteArray("gzip"));
+    }
+
+    void etags()
+    {
+        const QByteArray a = HttpContentCoding::strongETag("shot/12/1700000000/0");
+        const QByteArray b = HttpContentCoding::strongETag("shot/12/1700000001/0");
+        QVERIFY(a.startsWith('"') && a.endsWith('"'));
+        QCOMPARE(a.size(), 18);
+        QCOMPARE(a, HttpContentCoding::strongETag("shot/12/1700000000/0"));
+        QVERIFY(a != b);
+
+        const QByteArray gz = HttpContentCoding::etagForCoding(a, Coding::Gzip);
+        QCOMPARE(gz, a.chopped(1) + "-gzip\"");
+        QCOMPARE(HttpContentCoding::etagForCoding(a, Coding::Identity), a);
+
+        QVERIFY(HttpContentCoding::ifNoneMatch(a, a));
+        QVERIFY(HttpContentCoding::ifNoneMatch(gz, a));       // any coding's variant
+        QVERIFY(HttpContentCoding::ifNoneMatch("W/" + gz, a)); // weak comparison
+        QVERIFY(HttpContentCoding::ifNoneMatch(b + ", " + gz, a));
+        QVERIFY(HttpContentCoding::ifNoneMatch(" * ", a));
+        QVERIFY(!HttpContentCoding::ifNoneMatch(b, a));
+        QVERIFY(!HttpContentCoding::ifNoneMatch("", a));
+        QVERIFY(!HttpContentCoding::ifNoneMatch(a.chopped(2) + "\"", a));
+    }
+
+    void encodedAsset()
+    {
+        const QByteArray page = managementPage();
+        const auto asset = HttpContentCoding::EncodedAsset::make(page, "text/html");
+        QCOMPARE(asset.identity, page);
+        QCOMPARE(asset.etag, HttpContentCoding::strongETag(page));
+        QCOMPARE(asset.codingFor(Coding::Gzip), Coding::Gzip);
+        QCOMPARE(asset.codingFor(Coding::Deflate), Coding::Deflate);
+        QCOMPARE(asset.codingFor(Coding::Identity), Coding::Identity);
+        QCOMPARE(asset.body(Coding::Identity), page);
+        QCOMPARE(inflateZlib(asset.body(Coding::Deflate), page.size()), page);
+
+        // Too small to be worth it, or not text: identity only.
+        const auto tiny = HttpContentCoding::EncodedAsset::make("<svg/>", "image/svg+xml");
+        QVERIFY(tiny.gzip.isEmpty() && tiny.deflate.isEmpty());
+        QCOMPARE(tiny.codingFor(Coding::Gzip), Coding::Identity);
+        const auto png = HttpContentCoding::EncodedAsset::make(QByteArray(4096, 'x'), "image/png");
+        QCOMPARE(png.codingFor(Coding::Gzip), Coding::Identity);
+    }
+
+    void pageTransfer_data()
+    {
+        QTest::addColumn<QByteArray>("page");
+        QTest::newRow("management page") << managementPage();
+        QTest::newRow("theme page") << generateThemePageHtml().toUtf8();
+        QTest::newRow("remote page") << QByteArray(WEB_REMOTE_PAGE);
+        QTest::newRow("login page") << QByteArray(WEB_AUTH_LOGIN_PAGE);
+    }
+
+    // Bytes on the wire per page: gzip and deflate each at most half of
+    // identity, and a revalidated 304 a few hundred bytes of headers. The
+    // benchmark is the gzip encode, which is what a dynamic page costs the
+    // thread answering the request.
+    void pageTransfer()
+    {
+        QFETCH(QByteArray, page);
+        QByteArray gzip;
+        QBENCHMARK {
+            gzip = HttpContentCoding::encode(page, Coding::Gzip);
+        }
+        const QByteArray deflate = HttpContentCoding::encode(page, Coding::Deflate);
+        const QByteArray etag = HttpContentCoding::etagForCoding(HttpContentCoding::strongETag(page), Coding::Gzip);
+        const QByteArray notModified = "HTTP/1.1 304 Not Modified\r\nETag: " + etag
+            + "\r\nCache-Control: private, no-cache\r\nVary: Accept-Encoding\r\n"
+              "Connection: keep-alive\r\nKeep-Alive: timeout=30\r\n\r\n";
+        QVERIFY2(gzip.size() < page.size() / 2, qPrintable(QString::number(gzip.size())));
+        QVERIFY2(deflate.size() < page.size() / 2, qPrintable(QString::number(deflate.size())));
+        QVERIFY2(notModified.size() < 512, qPrintable(QString::number(notModified.size())));
+    }
+};
+
+QTEST_GUILESS_MAIN(TstHttpContentCoding)
+
+#include "tst_httpcontentcoding.moc"
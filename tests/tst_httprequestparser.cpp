@@ -0,0 +1,410 @@
+// HttpRequestParser — ShotServer's incremental HTTP/1.1 request parser.
+//
+// Requests are fed in arbitrary slices (down to one byte at a time) and must
+// come out the same: request line, header lookup, cookies, Content-Length and
+// chunked bodies, body sinks, and pipelined requests parsed back to back from
+// one read. Malformed or oversized requests fail with the status ShotServer
+// answers with. The benchmark parses the requests the web UI sends most
+// (a browser page load and the telemetry poll) with the parser and with the
+// QString split/re-split handleRequest used before it, kept below as the
+// reference.
+
+#include <QtTest>
+#include <QBuffer>
+
+#include "network/httprequestparser.h"
+
+using Status = HttpRequestParser::Status;
+
+namespace {
+
+const QByteArray kBrowserGet =
+    "GET /shot/1234 HTTP/1.1\r\n"
+    "Host: 192.168.1.50:8888\r\n"
+    "Connection: keep-alive\r\n"
+    "Upgrade-Insecure-Requests: 1\r\n"
+    "User-Agent: Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 "
+    "(KHTML, like Gecko) Chrome/126.0.0.0 Safari/537.36\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+    "Referer: http://192.168.1.50:8888/\r\n"
+    "Accept-Encoding: gzip, deflate\r\n"
+    "Accept-Language: en-US,en;q=0.9\r\n"
+    "Cookie: theme=dark; decenza_session=3f9a1c0e5b7d4e2a8c6f0b1d3e5a7c9f; lang=en\r\n"
+    "\r\n";
+
+const QByteArray kPoll =
+    "GET /api/telemetry HTTP/1.1\r\n"
+    "Host: 192.168.1.50:8888\r\n"
+    "Accept: */*\r\n"
+    "Cookie: decenza_session=3f9a1c0e5b7d4e2a8c6f0b1d3e5a7c9f\r\n"
+    "\r\n";
+
+// What handleRequest did before the parser: decode the whole request to a
+// QString, split it into lines, split the request line, then walk the lines
+// again for each header a route needed (Authorization, then Cookie).
+struct LegacyRequest {
+    QString method;
+    QString path;
+    QString authorization;
+    QString session;
+};
+
+LegacyRequest legacyParse(const QByteArray& request)
+{
+    LegacyRequest result;
+    const QString requestStr = QString::fromUtf8(request);
+    const QStringList lines = requestStr.split("\r\n");
+    if (lines.isEmpty())
+        return result;
+    const QStringList parts = lines[0].split(' ');
+    if (parts.size() < 2)
+        return result;
+    result.method = parts[0];
+    result.path = parts[1];
+
+    for (const QString& line : requestStr.split("\r\n")) {
+        if (line.startsWith("Authorization:", Qt::CaseInsensitive)) {
+            result.authorization = line.mid(14).trimmed();
+            break;
+        }
+    }
+    for (const QString& line : requestStr.split("\r\n")) {
+        if (line.startsWith("Cookie:", Qt::CaseInsensitive)) {
+            for (const QString& cookie : line.mid(7).trimmed().split(';')) {
+                const QString c = cookie.trimmed();
+                if (c.startsWith("decenza_session=")) {
+                    result.session = c.mid(16);
+                    break;
+                }
+            }
+            break;
+        }
+    }
+    return result;
+}
+
+// Feeds `data` to `parser` in `slice`-byte reads, running the loop ShotServer
+// runs, and returns every request completed.
+QList<HttpRequest> feed(HttpRequestParser& parser, const QByteArray& data, qsizetype slice,
+                        Status* last = nullptr)
+{
+    QList<HttpRequest> requests;
+    Status status = Status::NeedMore;
+    for (qsizetype offset = 0; offset < data.size() && status != Status::Error; offset += slice) {
+        parser.append(data.mid(offset, slice));
+        for (;;) {
+            status = parser.parse();
+            if (status == Status::HeadComplete)
+                continue;
+            if (status == Status::Complete) {
+                requests.append(parser.takeRequest());
+                continue;
+            }
+            break;
+        }
+    }
+    if (last)
+        *last = status;
+    return requests;
+}
+
+}  // namespace
+
+class TstHttpRequestParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+
+    void parsesRequestLineAndHeaders()
+    {
+        HttpRequestParser parser;
+        parser.append(kBrowserGet);
+        QCOMPARE(parser.parse(), Status::HeadComplete);
+        QCOMPARE(parser.contentLength(), qint64(0));
+        QCOMPARE(parser.parse(), Status::Complete);
+
+        const HttpRequest request = parser.takeRequest();
+        QCOMPARE(request.method().toByteArray(), QByteArray("GET"));
+        QCOMPARE(request.target().toByteArray(), QByteArray("/shot/1234"));
+        QCOMPARE(request.version().toByteArray(), QByteArray("HTTP/1.1"));
+        QCOMPARE(request.headerCount(), 9);
+        QCOMPARE(request.header("host").toByteArray(), QByteArray("192.168.1.50:8888"));
+        QCOMPARE(request.header("ACCEPT-ENCODING").toByteArray(), QByteArray("gzip, deflate"));
+        QVERIFY(request.hasHeader("Referer"));
+        QVERIFY(!request.hasHeader("Authorization"));
+        QVERIFY(request.header("Authorization").isEmpty());
+        QCOMPARE(request.cookie("decenza_session").toByteArray(), QByteArray("3f9a1c0e5b7d4e2a8c6f0b1d3e5a7c9f"));
+        QCOMPARE(request.cookie("lang").toByteArray(), QByteArray("en"));
+        QVERIFY(request.cookie("decenza").isEmpty());
+        QVERIFY(request.body().isEmpty());
+        QVERIFY(request.keepAlive());
+        QVERIFY(parser.isIdle());
+    }
+
+    void trimsValuesAndReadsSeveralCookieFields()
+    {
+        HttpRequestParser parser;
+        const QList<HttpRequest> requests = feed(parser,
+            "GET / HTTP/1.1\r\nX-Filename:\t  my shot.json  \r\n"
+            "Cookie: a=1\r\nCookie: decenza_session=abc\r\n\r\n", 4096);
+        QCOMPARE(requests.size(), 1);
+        QCOMPARE(requests[0].header("X-Filename").toByteArray(), QByteArray("my shot.json"));
+        QCOMPARE(requests[0].cookie("a").toByteArray(), QByteArray("1"));
+        QCOMPARE(requests[0].cookie("decenza_session").toByteArray(), QByteArray("abc"));
+    }
+
+    void keepAlive_data()
+    {
+        QTest::addColumn<QByteArray>("request");
+        QTest::addColumn<bool>("keepAlive");
+        QTest::newRow("1.1 default") << QByteArray("GET / HTTP/1.1\r\n\r\n") << true;
+        QTest::newRow("1.1 close") << QByteArray("GET / HTTP/1.1\r\nConnection: Upgrade, close\r\n\r\n") << false;
+        QTest::newRow("1.0 default") << QByteArray("GET / HTTP/1.0\r\n\r\n") << false;
+        QTest::newRow("1.0 keep-alive") << QByteArray("GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n") << true;
+    }
+
+    void keepAlive()
+    {
+        QFETCH(QByteArray, request);
+        QFETCH(bool, keepAlive);
+        HttpRequestParser parser;
+        const QList<HttpRequest> requests = feed(parser, request, request.size());
+        QCOMPARE(requests.size(), 1);
+        QCOMPARE(requests[0].keepAlive(), keepAlive);
+    }
+
+    void contentLengthBody_data()
+    {
+        QTest::addColumn<qsizetype>("slice");
+        QTest::newRow("one read") << qsizetype(4096);
+        QTest::newRow("7 bytes") << qsizetype(7);
+        QTest::newRow("byte by byte") << qsizetype(1);
+    }
+
+    // However the bytes are sliced — including the "\r\n\r\n" split across
+    // reads — the request parses the same.
+    void contentLengthBody()
+    {
+        QFETCH(qsizetype, slice);
+        const QByteArray body = "{\"grinderSetting\":\"12\"}";
+        const QByteArray wire = "POST /api/shot/7/metadata HTTP/1.1\r\n"
+                                "Content-Type: application/json\r\n"
+                                "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body;
+        HttpRequestParser parser;
+        Status last;
+        const QList<HttpRequest> requests = feed(parser, wire, slice, &last);
+        QCOMPARE(last, Status::NeedMore);
+        QCOMPARE(requests.size(), 1);
+        QCOMPARE(requests[0].method().toByteArray(), QByteArray("POST"));
+        QCOMPARE(requests[0].target().toByteArray(), QByteArray("/api/shot/7/metadata"));
+        QCOMPARE(requests[0].body(), body);
+        QCOMPARE(requests[0].bodySize(), qint64(body.size()));
+        QVERIFY(parser.isIdle());
+    }
+
+    void chunkedBody_data() { contentLengthBody_data(); }
+
+    void chunkedBody()
+    {
+        QFETCH(qsizetype, slice);
+        const QByteArray wire = "POST /upload HTTP/1.1\r\n"
+                                "Transfer-Encoding: chunked\r\n\r\n"
+                                "5\r\nhello\r\n"
+                                "1;ext=\"x\"\r\n \r\n"
+                                "c\r\nworld, again\r\n"
+                                "0\r\nX-Checksum: 1\r\n\r\n";
+        HttpRequestParser parser;
+        Status last;
+        const QList<HttpRequest> requests = feed(parser, wire, slice, &last);
+        QCOMPARE(last, Status::NeedMore);
+        QCOMPARE(requests.size(), 1);
+        QCOMPARE(requests[0].body(), QByteArray("hello world, again"));
+        QVERIFY(parser.isIdle());
+    }
+
+    void chunkedReportsUnknownLength()
+    {
+        HttpRequestParser parser;
+        parser.append("POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n");
+        QCOMPARE(parser.parse(), Status::HeadComplete);
+        QVERIFY(parser.isChunked());
+        QCOMPARE(parser.contentLength(), qint64(-1));
+        QCOMPARE(parser.parse(), Status::NeedMore);
+        QVERIFY(!parser.isIdle());
+    }
+
+    // Bytes past the end of one request are the next request.
+    void pipelinedRequests_data() { contentLengthBody_data(); }
+
+    void pipelinedRequests()
+    {
+        QFETCH(qsizetype, slice);
+        const QByteArray wire = kPoll
+            + "POST /api/settings HTTP/1.1\r\nContent-Length: 4\r\n\r\n{ }\n"
+            + "POST /api/upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n2\r\nok\r\n0\r\n\r\n"
+            + kBrowserGet;
+        HttpRequestParser parser;
+        const QList<HttpRequest> requests = feed(parser, wire, slice);
+        QCOMPARE(requests.size(), 4);
+        QCOMPARE(requests[0].target().toByteArray(), QByteArray("/api/telemetry"));
+        QCOMPARE(requests[1].target().toByteArray(), QByteArray("/api/settings"));
+        QCOMPARE(requests[1].body(), QByteArray("{ }\n"));
+        QCOMPARE(requests[2].body(), QByteArray("ok"));
+        QCOMPARE(requests[3].target().toByteArray(), QByteArray("/shot/1234"));
+        QCOMPARE(requests[3].cookie("decenza_session").toByteArray(), QByteArray("3f9a1c0e5b7d4e2a8c6f0b1d3e5a7c9f"));
+        QVERIFY(parser.isIdle());
+    }
+
+    // takeRequest() leaves the next request's bytes buffered rather than
+    // parsing it — ShotServer finishes one response before reading the next.
+    void takeRequestKeepsLeftover()
+    {
+        HttpRequestParser parser;
+        parser.append(kPoll + kPoll.first(10));
+        QCOMPARE(parser.parse(), Status::HeadComplete);
+        QCOMPARE(parser.parse(), Status::Complete);
+        parser.takeRequest();
+        QCOMPARE(parser.bufferedSize(), 10);
+        QVERIFY(!parser.isIdle());
+        QCOMPARE(parser.parse(), Status::NeedMore);
+        parser.append(kPoll.sliced(10));
+        QCOMPARE(parser.parse(), Status::HeadComplete);
+        QCOMPARE(parser.request().target().toByteArray(), QByteArray("/api/telemetry"));
+    }
+
+    void bodySink()
+    {
+        const QByteArray body(300 * 1024, 'x');
+        const QByteArray wire = "POST /upload HTTP/1.1\r\nContent-Length: "
+                                + QByteArray::number(body.size()) + "\r\n\r\n" + body;
+        QBuffer sink;
+        QVERIFY(sink.open(QIODevice::WriteOnly));
+
+        HttpRequestParser parser;
+        parser.append(wire.first(100));
+        QCOMPARE(parser.parse(), Status::HeadComplete);
+        QCOMPARE(parser.contentLength(), qint64(body.size()));
+        parser.setBodySink(&sink);
+        parser.setMaxBodySize(body.size());
+        QCOMPARE(parser.parse(), Status::NeedMore);
+        parser.append(wire.sliced(100));
+        QCOMPARE(parser.parse(), Status::Complete);
+        QCOMPARE(parser.bodyReceived(), qint64(body.size()));
+
+        const HttpRequest request = parser.takeRequest();
+        QVERIFY(request.body().isEmpty());
+        QCOMPARE(request.bodySize(), qint64(body.size()));
+        QCOMPARE(sink.data(), body);
+    }
+
+    // The sink and the body limit apply to one request only.
+    void limitsResetPerRequest()
+    {
+        const QByteArray big(2 * 1024 * 1024, 'x');
+        const QByteArray wire = "POST /a HTTP/1.1\r\nContent-Length: " + QByteArray::number(big.size())
+                                + "\r\n\r\n" + big + "POST /b HTTP/1.1\r\nContent-Length: "
+                                + QByteArray::number(big.size()) + "\r\n\r\n";
+        HttpRequestParser parser;
+        parser.append(wire);
+        QCOMPARE(parser.parse(), Status::HeadComplete);
+        parser.setMaxBodySize(big.size());
+        QCOMPARE(parser.parse(), Status::Complete);
+        parser.takeRequest();
+        QCOMPARE(parser.parse(), Status::HeadComplete);
+        QCOMPARE(parser.parse(), Status::Error);
+        QCOMPARE(parser.errorStatus(), 413);
+    }
+
+    void errors_data()
+    {
+        QTest::addColumn<QByteArray>("request");
+        QTest::addColumn<int>("status");
+        QTest::newRow("no target") << QByteArray("GET\r\n\r\n") << 400;
+        QTest::newRow("extra space") << QByteArray("GET  / HTTP/1.1\r\n\r\n") << 400;
+        QTest::newRow("not http") << QByteArray("GET / SPDY/3\r\n\r\n") << 400;
+        QTest::newRow("no colon") << QByteArray("GET / HTTP/1.1\r\nHost\r\n\r\n") << 400;
+        QTest::newRow("space before colon") << QByteArray("GET / HTTP/1.1\r\nHost : x\r\n\r\n") << 400;
+        QTest::newRow("folded") << QByteArray("GET / HTTP/1.1\r\nX-A: 1\r\n 2\r\n\r\n") << 400;
+        QTest::newRow("bad length") << QByteArray("POST / HTTP/1.1\r\nContent-Length: -5\r\n\r\n") << 400;
+        QTest::newRow("two lengths") << QByteArray("POST / HTTP/1.1\r\nContent-Length: 1\r\n"
+                                                   "Content-Length: 2\r\n\r\n") << 400;
+        QTest::newRow("te and cl") << QByteArray("POST / HTTP/1.1\r\nContent-Length: 3\r\n"
+                                                 "Transfer-Encoding: chunked\r\n\r\n") << 400;
+        QTest::newRow("gzip te") << QByteArray("POST / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\n\r\n") << 501;
+        QTest::newRow("bad chunk") << QByteArray("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n") << 400;
+        QTest::newRow("body too large") << QByteArray("POST / HTTP/1.1\r\nContent-Length: 2000000\r\n\r\n") << 413;
+        QTest::newRow("chunk too large") << QByteArray("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                                                       "200000\r\n") << 413;
+    }
+
+    void errors()
+    {
+        QFETCH(QByteArray, request);
+        QFETCH(int, status);
+        HttpRequestParser parser;
+        Status last;
+        feed(parser, request, request.size(), &last);
+        QCOMPARE(last, Status::Error);
+        QCOMPARE(parser.errorStatus(), status);
+        QVERIFY(!parser.errorString().isEmpty());
+        // Failed is terminal.
+        parser.append(kPoll);
+        QCOMPARE(parser.parse(), Status::Error);
+    }
+
+    void headTooLarge()
+    {
+        HttpRequestParser parser(1024);
+        parser.append("GET / HTTP/1.1\r\nX-Pad: " + QByteArray(1000, 'a'));
+        QCOMPARE(parser.parse(), Status::NeedMore);
+        parser.append(QByteArray(100, 'a'));
+        QCOMPARE(parser.parse(), Status::Error);
+        QCOMPARE(parser.errorStatus(), 413);
+    }
+
+    void parseRequests_data()
+    {
+        QTest::addColumn<bool>("legacy");
+        QTest::addColumn<QByteArray>("request");
+        QTest::newRow("legacy browser GET") << true << kBrowserGet;
+        QTest::newRow("parser browser GET") << false << kBrowserGet;
+        QTest::newRow("legacy poll") << true << kPoll;
+        QTest::newRow("parser poll") << false << kPoll;
+    }
+
+    // 10,000 requests, each arriving in one read, through what a route sees:
+    // method, path, Authorization and the session cookie.
+    void parseRequests()
+    {
+        QFETCH(bool, legacy);
+        QFETCH(QByteArray, request);
+        constexpr int kRequests = 10000;
+
+        int sessions = 0;
+        QBENCHMARK {
+            sessions = 0;
+            HttpRequestParser parser;
+            for (int i = 0; i < kRequests; ++i) {
+                if (legacy) {
+                    const LegacyRequest r = legacyParse(request);
+                    sessions += (r.method == QLatin1String("GET") && r.authorization.isEmpty()
+                                 && !r.session.isEmpty()) ? 1 : 0;
+                    continue;
+                }
+                parser.append(request);
+                if (parser.parse() != Status::HeadComplete || parser.parse() != Status::Complete)
+                    break;
+                const HttpRequest r = parser.takeRequest();
+                sessions += (r.method() == "GET" && r.header("Authorization").isEmpty()
+                             && !r.cookie("decenza_session").isEmpty()) ? 1 : 0;
+            }
+        }
+        QCOMPARE(sessions, kRequests);
+    }
+};
+
+QTEST_GUILESS_MAIN(TstHttpRequestParser)
+
+#include "tst_httprequestparser.moc"
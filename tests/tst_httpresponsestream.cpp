@@ -0,0 +1,317 @@
+// HttpResponseStream — ShotServer's backpressured response bodies.
+//
+// Each case streams over a real loopback connection: the server end is the
+// socket the stream writes to, the client end reads in the same event loop,
+// exactly as a browser on the tablet's own Wi-Fi would drain it. The framing
+// cases compare the raw bytes received; the failure cases check that a body
+// which cannot be completed is cut off rather than ended cleanly.
+//
+// largeDatabaseDownload is the case the class exists for: a 500 MB file (a
+// sparse one, so the test costs no real disk) streamed while a 5 ms timer
+// stands in for the UI. Before, sendFile looped on waitForBytesWritten and the
+// timer would not have fired until the download was over. It bounds the most
+// body ever queued in the socket and the longest gap between ticks, and is
+// opt-in (benchmarkoptin.h). queueStaysBounded checks the queue bound in the
+// default run, on a 16 MB body and with no clock involved.
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QRegularExpression>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include "benchmarkoptin.h"
+#include "core/taskexecutor.h"
+#include "network/httpresponsestream.h"
+
+namespace {
+
+// A connected pair on 127.0.0.1. `received` accumulates everything the client
+// reads unless `discard` is set, in which case only the count is kept.
+struct Loopback {
+    QTcpServer server;
+    QTcpSocket client;
+    QTcpSocket* serverSide = nullptr;
+    QByteArray received;
+    qint64 receivedCount = 0;
+    bool discard = false;
+
+    bool open()
+    {
+        if (!server.listen(QHostAddress::LocalHost))
+            return false;
+        client.connectToHost(QHostAddress::LocalHost, server.serverPort());
+        if (!server.waitForNewConnection(5000) || !client.waitForConnected(5000))
+            return false;
+        serverSide = server.nextPendingConnection();
+        QObject::connect(&client, &QTcpSocket::readyRead, &client, [this]() {
+            const QByteArray bytes = client.readAll();
+            receivedCount += bytes.size();
+            if (!discard)
+                received += bytes;
+        });
+        return serverSide != nullptr;
+    }
+};
+
+// Hands out `pieces` in order, then the empty piece that ends the body.
+HttpResponseStream::Producer piecesProducer(QList<QByteArray> pieces)
+{
+    auto remaining = std::make_shared<QList<QByteArray>>(std::move(pieces));
+    return [remaining](QByteArray& piece) {
+        piece = remaining->isEmpty() ? QByteArray() : remaining->takeFirst();
+        return true;
+    };
+}
+
+const QByteArray kChunkedHead = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+
+// A file of `size` zero bytes that takes no real disk.
+bool makeSparseFile(const QString& path, qint64 size)
+{
+    QFile f(path);
+    return f.open(QIODevice::WriteOnly) && f.resize(size);
+}
+
+QByteArray sizedHead(qint64 size)
+{
+    return "HTTP/1.1 200 OK\r\nContent-Length: " + QByteArray::number(size) + "\r\n\r\n";
+}
+
+}  // namespace
+
+class TstHttpResponseStream : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+    void cleanupTestCase() { TaskExecutor::instance().shutdown(5000); }
+
+    void chunkedFraming()
+    {
+        Loopback net;
+        QVERIFY(net.open());
+        const QList<QByteArray> pieces{"hello", QByteArray(300, 'x'), "!"};
+        auto* stream = new HttpResponseStream(net.serverSide, kChunkedHead, -1, piecesProducer(pieces));
+        QSignalSpy finished(stream, &HttpResponseStream::finished);
+        stream->start();
+
+        QVERIFY(finished.wait(5000));
+        QCOMPARE(finished.first().first().toBool(), true);
+        const QByteArray expected = kChunkedHead
+            + "5\r\nhello\r\n" + "12c\r\n" + QByteArray(300, 'x') + "\r\n" + "1\r\n!\r\n" + "0\r\n\r\n";
+        QTRY_COMPARE(net.received, expected);
+    }
+
+    void emptyChunkedBody()
+    {
+        Loopback net;
+        QVERIFY(net.open());
+        auto* stream = new HttpResponseStream(net.serverSide, kChunkedHead, -1, piecesProducer({}));
+        QSignalSpy finished(stream, &HttpResponseStream::finished);
+        stream->start();
+
+        QVERIFY(finished.wait(5000));
+        QCOMPARE(finished.first().first().toBool(), true);
+        QTRY_COMPARE(net.received, kChunkedHead + "0\r\n\r\n");
+    }
+
+    void sizedFile()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath("body.bin");
+        QByteArray content;
+        for (int i = 0; i < 300 * 1024; ++i)
+            content += static_cast<char>(i * 31 % 251);
+        {
+            QFile f(path);
+            QVERIFY(f.open(QIODevice::WriteOnly));
+            QCOMPARE(f.write(content), content.size());
+        }
+
+        Loopback net;
+        QVERIFY(net.open());
+        auto* stream = new HttpResponseStream(net.serverSide, sizedHead(content.size()), content.size(),
+                                              HttpResponseStream::fileProducer(path));
+        QSignalSpy finished(stream, &HttpResponseStream::finished);
+        stream->start();
+
+        QVERIFY(finished.wait(5000));
+        QCOMPARE(finished.first().first().toBool(), true);
+        QTRY_COMPARE(net.received.size(), sizedHead(content.size()).size() + content.size());
+        QCOMPARE(net.received, sizedHead(content.size()) + content);
+    }
+
+    void zeroLengthBodyNeedsNoProducer()
+    {
+        Loopback net;
+        QVERIFY(net.open());
+        auto* stream = new HttpResponseStream(net.serverSide, sizedHead(0), 0, [](QByteArray&) -> bool {
+            qFatal("producer called for an empty body");
+        });
+        QSignalSpy finished(stream, &HttpResponseStream::finished);
+        stream->start();
+        QCOMPARE(finished.size(), 1);
+        QCOMPARE(finished.first().first().toBool(), true);
+    }
+
+    // The status line is out before the body fails, so the only honest way to
+    // report it is to cut the connection: no terminating chunk.
+    void producerFailureAborts()
+    {
+        Loopback net;
+        QVERIFY(net.open());
+        auto calls = std::make_shared<int>(0);
+        auto* stream = new HttpResponseStream(net.serverSide, kChunkedHead, -1, [calls](QByteArray& piece) {
+            if ((*calls)++ == 0) {
+                piece = "abc";
+                return true;
+            }
+            return false;
+        });
+        QSignalSpy finished(stream, &HttpResponseStream::finished);
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("HttpResponseStream: the body could not be produced"));
+        stream->start();
+
+        QVERIFY(finished.wait(5000));
+        QCOMPARE(finished.first().first().toBool(), false);
+        QTRY_COMPARE(net.client.state(), QAbstractSocket::UnconnectedState);
+        QVERIFY(!net.received.endsWith("0\r\n\r\n"));
+    }
+
+    void shortSizedBodyAborts()
+    {
+        Loopback net;
+        QVERIFY(net.open());
+        auto* stream = new HttpResponseStream(net.serverSide, sizedHead(10), 10, piecesProducer({"12345"}));
+        QSignalSpy finished(stream, &HttpResponseStream::finished);
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("body ended short of its Content-Length"));
+        stream->start();
+
+        QVERIFY(finished.wait(5000));
+        QCOMPARE(finished.first().first().toBool(), false);
+        QTRY_COMPARE(net.client.state(), QAbstractSocket::UnconnectedState);
+    }
+
+    void longSizedBodyAborts()
+    {
+        Loopback net;
+        QVERIFY(net.open());
+        auto* stream = new HttpResponseStream(net.serverSide, sizedHead(4), 4, piecesProducer({"12345"}));
+        QSignalSpy finished(stream, &HttpResponseStream::finished);
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("body ran past its Content-Length"));
+        stream->start();
+
+        QVERIFY(finished.wait(5000));
+        QCOMPARE(finished.first().first().toBool(), false);
+    }
+
+    // The stream is a child of its socket: a client that goes away mid-body
+    // takes the stream with it, and a piece still being produced is dropped.
+    void clientGoneMidStream()
+    {
+        Loopback net;
+        QVERIFY(net.open());
+        auto* stream = new HttpResponseStream(net.serverSide, kChunkedHead, -1, [](QByteArray& piece) {
+            piece = QByteArray(HttpResponseStream::kPieceSize, 'z');
+            return true;
+        });
+        QPointer<HttpResponseStream> guard(stream);
+        stream->start();
+        QTRY_VERIFY(net.receivedCount > 4 * HttpResponseStream::kPieceSize);
+
+        delete net.serverSide;
+        QVERIFY(guard.isNull());
+        QVERIFY(TaskExecutor::instance().waitForIdle(5000));
+        QCoreApplication::processEvents();
+    }
+
+    void queueStaysBounded()
+    {
+        constexpr qint64 kSize = 16LL * 1024 * 1024;
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath("shots.db");
+        QVERIFY(makeSparseFile(path, kSize));
+
+        Loopback net;
+        QVERIFY(net.open());
+        net.discard = true;
+        qint64 peakQueued = 0;
+        connect(net.serverSide, &QTcpSocket::bytesWritten, this, [&]() {
+            peakQueued = qMax(peakQueued, net.serverSide->bytesToWrite());
+        });
+
+        const QByteArray head = sizedHead(kSize);
+        auto* stream = new HttpResponseStream(net.serverSide, head, kSize, HttpResponseStream::fileProducer(path));
+        QSignalSpy finished(stream, &HttpResponseStream::finished);
+        stream->start();
+
+        QVERIFY(finished.wait(30000));
+        QCOMPARE(finished.first().first().toBool(), true);
+        QTRY_COMPARE_WITH_TIMEOUT(net.receivedCount, head.size() + kSize, 30000);
+        QVERIFY2(peakQueued <= HttpResponseStream::kLowWater + HttpResponseStream::kPieceSize,
+                 qPrintable(QString::number(peakQueued)));
+    }
+
+    void largeDatabaseDownload()
+    {
+        DECENZA_BENCHMARK_OPT_IN();
+        constexpr qint64 kSize = 500LL * 1024 * 1024;
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath("shots.db");
+        QVERIFY(makeSparseFile(path, kSize));
+
+        Loopback net;
+        QVERIFY(net.open());
+        net.discard = true;
+
+        qint64 peakQueued = 0;
+        connect(net.serverSide, &QTcpSocket::bytesWritten, this, [&]() {
+            peakQueued = qMax(peakQueued, net.serverSide->bytesToWrite());
+        });
+
+        // Stand-in for the UI: how late does a 5 ms timer get to run?
+        QElapsedTimer sinceTick;
+        qint64 longestGapMs = 0;
+        int ticks = 0;
+        QTimer ui;
+        ui.setInterval(5);
+        connect(&ui, &QTimer::timeout, this, [&]() {
+            longestGapMs = qMax(longestGapMs, sinceTick.restart());
+            ++ticks;
+        });
+
+        const QByteArray head = sizedHead(kSize);
+        auto* stream = new HttpResponseStream(net.serverSide, head, kSize, HttpResponseStream::fileProducer(path));
+        QSignalSpy finished(stream, &HttpResponseStream::finished);
+        sinceTick.start();
+        ui.start();
+        stream->start();
+
+        QVERIFY(finished.wait(300000));
+        QCOMPARE(finished.first().first().toBool(), true);
+        QTRY_COMPARE_WITH_TIMEOUT(net.receivedCount, head.size() + kSize, 60000);
+        ui.stop();
+
+        // Never more buffered than the low-water mark plus the piece that
+        // crossed it (peakQueued is sampled after each write drains, so this
+        // is a bound, not the exact high point).
+        QVERIFY2(peakQueued <= HttpResponseStream::kLowWater + HttpResponseStream::kPieceSize,
+                 qPrintable(QString::number(peakQueued)));
+        // Generous for a loaded CI machine; a blocking send would be seconds.
+        QVERIFY2(longestGapMs < 250, qPrintable(QString::number(longestGapMs)));
+        QVERIFY(ticks > 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(TstHttpResponseStream)
+
+#include "tst_httpresponsestream.moc"
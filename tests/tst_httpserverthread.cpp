@@ -0,0 +1,197 @@
+// HttpServerThread — ShotServer's listener and sockets on their own thread.
+//
+// A real client on the test's (main) thread talks to a server whose socket
+// lives on the HTTP-IO thread. What the test holds is the stand-in socket
+// newConnection() hands out, which is what ShotServer's handlers use. Each
+// case checks that the stand-in behaves like a connected QTcpSocket: bytes
+// both ways, bytesWritten and bytesToWrite following the real socket, close()
+// draining before it hangs up, and a peer's close arriving as disconnected().
+//
+// uploadIsFlowControlled covers the bound that keeps an upload from piling up
+// in memory when the main thread is not reading.
+
+#include <QtTest>
+#include <QSignalSpy>
+#include <QSslConfiguration>
+#include <QSslSocket>
+#include <QTcpSocket>
+#include <QThread>
+
+#include "network/httpserverthread.h"
+
+namespace {
+
+// A client on the test thread, and the stand-in the server handed out for it.
+struct Client {
+    QTcpSocket socket;
+    QByteArray received;
+
+    QTcpSocket* connectTo(HttpServerThread& server)
+    {
+        QSignalSpy accepted(&server, &HttpServerThread::newConnection);
+        QObject::connect(&socket, &QTcpSocket::readyRead, &socket, [this]() { received += socket.readAll(); });
+        socket.connectToHost(QHostAddress::LocalHost, server.serverPort());
+        if (!accepted.wait(5000))
+            return nullptr;
+        return accepted.first().first().value<QTcpSocket*>();
+    }
+};
+
+QByteArray pattern(qsizetype size)
+{
+    QByteArray bytes(size, Qt::Uninitialized);
+    for (qsizetype i = 0; i < size; ++i)
+        bytes[i] = static_cast<char>(i * 7 % 253);
+    return bytes;
+}
+
+}  // namespace
+
+class TstHttpServerThread : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+
+    void roundTrip()
+    {
+        HttpServerThread server;
+        QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+        QVERIFY(server.isListening());
+        Client client;
+        QTcpSocket* socket = client.connectTo(server);
+        QVERIFY(socket);
+
+        // Handlers see a main-thread socket with the peer filled in.
+        QCOMPARE(socket->thread(), QThread::currentThread());
+        QCOMPARE(socket->state(), QAbstractSocket::ConnectedState);
+        QCOMPARE(socket->peerAddress(), QHostAddress(QHostAddress::LocalHost));
+        QCOMPARE(socket->peerPort(), client.socket.localPort());
+
+        QByteArray request;
+        connect(socket, &QTcpSocket::readyRead, this, [&]() { request += socket->readAll(); });
+        client.socket.write("GET / HTTP/1.1\r\n\r\n");
+        QTRY_COMPARE(request, QByteArray("GET / HTTP/1.1\r\n\r\n"));
+
+        QSignalSpy written(socket, &QIODevice::bytesWritten);
+        QCOMPARE(socket->write("hello"), qint64(5));
+        QCOMPARE(socket->bytesToWrite(), qint64(5));
+        QTRY_COMPARE(client.received, QByteArray("hello"));
+        QTRY_COMPARE(socket->bytesToWrite(), qint64(0));
+        qint64 total = 0;
+        for (const auto& args : written)
+            total += args.first().toLongLong();
+        QCOMPARE(total, qint64(5));
+    }
+
+    // close() is graceful, as on a real socket: what was written goes out
+    // first, and disconnected() follows once the connection is down.
+    void closeDrainsThenDisconnects()
+    {
+        HttpServerThread server;
+        QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+        Client client;
+        QTcpSocket* socket = client.connectTo(server);
+        QVERIFY(socket);
+        QSignalSpy disconnected(socket, &QAbstractSocket::disconnected);
+
+        const QByteArray body = pattern(2 * 1024 * 1024);
+        socket->write(body);
+        socket->close();
+        QCOMPARE(socket->state(), QAbstractSocket::ClosingState);
+
+        QTRY_COMPARE_WITH_TIMEOUT(client.socket.state(), QAbstractSocket::UnconnectedState, 10000);
+        QCOMPARE(client.received, body);
+        QTRY_COMPARE(disconnected.size(), 1);
+        QCOMPARE(socket->state(), QAbstractSocket::UnconnectedState);
+        socket->deleteLater();
+    }
+
+    // A request followed by a half-close is still a whole request: the bytes
+    // arrive before disconnected(), and stay readable after it.
+    void peerCloseDeliversRestThenDisconnects()
+    {
+        HttpServerThread server;
+        QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+        Client client;
+        QTcpSocket* socket = client.connectTo(server);
+        QVERIFY(socket);
+        QSignalSpy disconnected(socket, &QAbstractSocket::disconnected);
+
+        client.socket.write("tail");
+        client.socket.disconnectFromHost();
+        QTRY_COMPARE(disconnected.size(), 1);
+        QCOMPARE(socket->state(), QAbstractSocket::UnconnectedState);
+        QCOMPARE(socket->readAll(), QByteArray("tail"));
+        // A write after the peer left fails, as it does on a QTcpSocket.
+        QCOMPARE(socket->write("late"), qint64(-1));
+        socket->deleteLater();
+    }
+
+    void uploadIsFlowControlled()
+    {
+        HttpServerThread server;
+        QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+        Client client;
+        QTcpSocket* socket = client.connectTo(server);
+        QVERIFY(socket);
+
+        const QByteArray upload = pattern(8 * 1024 * 1024);
+        client.socket.write(upload);
+        // The main thread is "busy": nothing reads the stand-in for a while.
+        QTest::qWait(500);
+        const qint64 held = socket->bytesAvailable();
+        QVERIFY2(held <= HttpServerThread::kReadWindow, qPrintable(QString::number(held)));
+        QVERIFY(held > 0);
+
+        QByteArray received = socket->readAll();
+        connect(socket, &QTcpSocket::readyRead, this, [&]() { received += socket->readAll(); });
+        QTRY_COMPARE_WITH_TIMEOUT(received.size(), upload.size(), 20000);
+        QCOMPARE(received, upload);
+    }
+
+    void closingTheServerDropsConnections()
+    {
+        HttpServerThread server;
+        QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+        Client client;
+        QTcpSocket* socket = client.connectTo(server);
+        QVERIFY(socket);
+        QSignalSpy disconnected(socket, &QAbstractSocket::disconnected);
+
+        server.close();
+        QVERIFY(!server.isListening());
+        QTRY_COMPARE(disconnected.size(), 1);
+        QTRY_COMPARE(client.socket.state(), QAbstractSocket::UnconnectedState);
+    }
+
+    // With TLS on, a plain-HTTP request is answered on the I/O thread with a
+    // redirect and never becomes a connection.
+    void plainHttpUnderTlsIsRedirected()
+    {
+        if (!QSslSocket::supportsSsl())
+            QSKIP("No TLS backend");
+        HttpServerThread server;
+        QVERIFY(server.listenTls(QHostAddress::LocalHost, 0, QSslConfiguration::defaultConfiguration()));
+        QSignalSpy accepted(&server, &HttpServerThread::newConnection);
+
+        QTcpSocket client;
+        QByteArray received;
+        connect(&client, &QTcpSocket::readyRead, this, [&]() { received += client.readAll(); });
+        client.connectToHost(QHostAddress::LocalHost, server.serverPort());
+        QVERIFY(client.waitForConnected(5000));
+        client.write("GET /shots HTTP/1.1\r\nHost: decenza.local:" + QByteArray::number(server.serverPort())
+                     + "\r\n\r\n");
+
+        QTRY_COMPARE(client.state(), QAbstractSocket::UnconnectedState);
+        QVERIFY(received.startsWith("HTTP/1.1 301 "));
+        QVERIFY(received.contains("Location: https://decenza.local:" + QByteArray::number(server.serverPort())
+                                  + "/shots\r\n"));
+        QCOMPARE(accepted.size(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(TstHttpServerThread)
+
+#include "tst_httpserverthread.moc"
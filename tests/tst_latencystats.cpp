@@ -0,0 +1,131 @@
+#include <QtTest>
+
+#include <QThread>
+
+#include <atomic>
+#include <vector>
+
+#include "core/latencystats.h"
+
+// LatencyStats — the control-loop latency histograms behind /api/debug/latency
+// and debug_get_latency.
+//
+// Most cases build a local Histogram so the counts are exact; the process-wide
+// set is touched only by the cases about it, each starting with reset().
+class tst_LatencyStats : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+
+    // Bounds are inclusive: a sample on a boundary belongs to the bucket it
+    // names, not the next one up. Off by one here shifts every percentile.
+    void samplesLandInTheirInclusiveBucket() {
+        LatencyStats::Histogram h;
+        h.record(0);
+        h.record(1);
+        h.record(2);
+        h.record(3);
+        h.record(10000);
+        h.record(10001);
+
+        QCOMPARE(h.bucketCount(0), quint64(2));   // 0, 1 → ≤1
+        QCOMPARE(h.bucketCount(1), quint64(1));   // 2 → ≤2
+        QCOMPARE(h.bucketCount(2), quint64(1));   // 3 → ≤5
+        QCOMPARE(h.bucketCount(LatencyStats::Histogram::kBoundsMs.size() - 1), quint64(1));
+        QCOMPARE(h.bucketCount(LatencyStats::Histogram::kBucketCount - 1), quint64(1));
+        QCOMPARE(h.count(), quint64(6));
+        QCOMPARE(h.maxMs(), qint64(10001));
+    }
+
+    // A negative span is another clock's stamp. It must still be counted —
+    // dropping it would make the bug invisible.
+    void aNegativeSpanCountsAsZero() {
+        LatencyStats::Histogram h;
+        h.record(-40);
+        QCOMPARE(h.count(), quint64(1));
+        QCOMPARE(h.bucketCount(0), quint64(1));
+        QCOMPARE(h.maxMs(), qint64(0));
+    }
+
+    void percentilesAreBucketUpperBoundsCappedAtTheMax() {
+        LatencyStats::Histogram h;
+        QCOMPARE(h.percentileMs(0.5), qint64(-1));
+
+        // 90 fast samples and 10 slow ones: p50 sits in the fast bucket, p95 and
+        // p99 in the slow one.
+        for (int i = 0; i < 90; ++i) h.record(4);
+        for (int i = 0; i < 10; ++i) h.record(150);
+        QCOMPARE(h.percentileMs(0.50), qint64(5));
+        QCOMPARE(h.percentileMs(0.95), qint64(150));  // ≤200 bucket, capped at max
+        QCOMPARE(h.percentileMs(0.99), qint64(150));
+
+        // Above the last bound, the max is the only honest answer.
+        LatencyStats::Histogram stalled;
+        stalled.record(25000);
+        QCOMPARE(stalled.percentileMs(0.5), qint64(25000));
+    }
+
+    void jsonCarriesOneCountPerBucket() {
+        LatencyStats::reset();
+        LatencyStats::record(LatencyStats::Leg::DispatchToAck, 30);
+        LatencyStats::record(LatencyStats::Leg::DispatchToAck, 70);
+
+        const QJsonObject json = LatencyStats::toJson();
+        QCOMPARE(json["clock"].toString(), QStringLiteral("steady"));
+        const QJsonArray bounds = json["bucketsMs"].toArray();
+        QCOMPARE(bounds.size(), qsizetype(LatencyStats::Histogram::kBoundsMs.size()));
+
+        const QJsonObject legs = json["legs"].toObject();
+        QCOMPARE(legs.size(), qsizetype(LatencyStats::Leg::Count));
+        const QJsonObject ack = legs["dispatchToAck"].toObject();
+        QCOMPARE(ack["count"].toInteger(), qint64(2));
+        QCOMPARE(ack["meanMs"].toDouble(), 50.0);
+        QCOMPARE(ack["maxMs"].toInteger(), qint64(70));
+        QCOMPARE(ack["counts"].toArray().size(), bounds.size() + 1);
+        QVERIFY(!ack["description"].toString().isEmpty());
+
+        const QJsonObject idle = legs["scaleToWeightProcessor"].toObject();
+        QCOMPARE(idle["count"].toInteger(), qint64(0));
+        QCOMPARE(idle["p50Ms"].toInteger(), qint64(-1));
+    }
+
+    // 0 is "no stamp taken" (simulated samples, tests) and must not be timed —
+    // nowMs() - 0 would be the machine's uptime.
+    void recordSinceIgnoresAnUntakenStamp() {
+        LatencyStats::reset();
+        LatencyStats::recordSince(LatencyStats::Leg::SampleToChartFlush, 0);
+        QCOMPARE(LatencyStats::histogram(LatencyStats::Leg::SampleToChartFlush).count(), quint64(0));
+
+        LatencyStats::recordSince(LatencyStats::Leg::SampleToChartFlush, LatencyStats::nowMs());
+        QCOMPARE(LatencyStats::histogram(LatencyStats::Leg::SampleToChartFlush).count(), quint64(1));
+    }
+
+    // The worker, the BLE I/O thread and the GUI thread record concurrently.
+    void concurrentRecordsAreAllCounted() {
+        LatencyStats::Histogram h;
+        constexpr int kThreads = 4;
+        constexpr int kPerThread = 20000;
+        std::vector<QThread*> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.push_back(QThread::create([&h, t]() {
+                for (int i = 0; i < kPerThread; ++i) h.record((i + t) % 300);
+            }));
+        }
+        for (QThread* thread : threads) thread->start();
+        for (QThread* thread : threads) {
+            QVERIFY(thread->wait(10000));
+            delete thread;
+        }
+
+        QCOMPARE(h.count(), quint64(kThreads * kPerThread));
+        quint64 bucketed = 0;
+        for (std::size_t i = 0; i < LatencyStats::Histogram::kBucketCount; ++i)
+            bucketed += h.bucketCount(i);
+        QCOMPARE(bucketed, h.count());
+        QCOMPARE(h.maxMs(), qint64(299));
+    }
+};
+
+QTEST_MAIN(tst_LatencyStats)
+#include "tst_latencystats.moc"
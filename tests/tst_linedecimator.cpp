@@ -0,0 +1,152 @@
+#include <QtTest>
+
+#include <cmath>
+
+#include "rendering/linedecimator.h"
+
+// LineDecimator — the per-pixel-column level of detail behind FastLineRenderer.
+//
+// What it must never do is change what the line looks like: every column keeps
+// its first and last point and its vertical extent, and a line built up one
+// flush at a time must come out exactly as if it had been decimated in one go.
+// The benchmarks are the paint-time CPU cost on a full 6000-point series
+// (FastLineRenderer::MAX_POINTS): after a zoom or resize, and per live flush.
+class tst_LineDecimator : public QObject {
+    Q_OBJECT
+
+private:
+    // A 10 Hz series with a fast wobble on a slow ramp, so most pixel columns
+    // hold a run whose extremes are neither its first nor its last point.
+    static QVector<QPointF> series(int count) {
+        QVector<QPointF> points(count);
+        for (int i = 0; i < count; ++i)
+            points[i] = QPointF(i * 0.1, 4.0 + i * 0.001 + std::sin(i * 1.7) * 0.5);
+        return points;
+    }
+
+    static bool same(const QVector<LineDecimator::Point>& a, const QVector<LineDecimator::Point>& b) {
+        if (a.size() != b.size()) return false;
+        for (qsizetype i = 0; i < a.size(); ++i) {
+            if (a[i].x != b[i].x || a[i].y != b[i].y) return false;
+        }
+        return true;
+    }
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+
+    // Fewer points than pixels: nothing to decimate, every point is drawn.
+    void sparsePointsPassThrough() {
+        const QVector<QPointF> points = series(50);
+        LineDecimator lod;
+        lod.setView(0.0, 5.0, 0.0, 10.0, 500.0f, 100.0f);
+        lod.update(points.constData(), points.size());
+
+        QCOMPARE(lod.points().size(), points.size());
+        QCOMPARE(lod.points().at(10).x, 100.0f);
+        QCOMPARE(lod.points().at(10).y, 100.0f - static_cast<float>(points[10].y() * 10.0));
+    }
+
+    // A run is reduced to first, min, max, last — min and max in the order
+    // they were sampled, so the line still goes where it went.
+    void aDenseColumnKeepsItsEndsAndExtremes() {
+        QVector<QPointF> points;
+        for (int i = 0; i < 20; ++i) points.append(QPointF(i * 0.01, 5.0));
+        points[3].setY(9.0);   // max first
+        points[12].setY(1.0);  // then min
+
+        LineDecimator lod;
+        lod.setView(0.0, 10.0, 0.0, 10.0, 10.0f, 10.0f);  // all 20 in column 0
+        lod.update(points.constData(), points.size());
+
+        const QVector<LineDecimator::Point>& out = lod.points();
+        QCOMPARE(out.size(), qsizetype(4));
+        QCOMPARE(out[0].y, 5.0f);
+        QCOMPARE(out[1].y, 1.0f);  // y down: 9.0 is pixel 1
+        QCOMPARE(out[2].y, 9.0f);
+        QCOMPARE(out[3].x, static_cast<float>(19 * 0.01));
+    }
+
+    void outputIsBoundedByWidthNotSampleCount() {
+        const QVector<QPointF> points = series(6000);
+        LineDecimator lod;
+        lod.setView(0.0, 600.0, 0.0, 10.0, 400.0f, 200.0f);
+        lod.update(points.constData(), points.size());
+        QVERIFY(lod.points().size() <= 4 * (400 + 1));
+
+        // Zoomed to a tenth: the off-screen nine tenths collapse into the two
+        // edge columns instead of a column per pixel they would have spanned.
+        LineDecimator zoomed;
+        zoomed.setView(300.0, 360.0, 0.0, 10.0, 400.0f, 200.0f);
+        zoomed.update(points.constData(), points.size());
+        QVERIFY(zoomed.points().size() <= 600 + 2 * 4);  // x 300.0 … 359.9, then the edges
+        QCOMPARE(zoomed.points().first().x, static_cast<float>(-300.0 * 400.0 / 60.0));
+    }
+
+    // The live path: points arrive a flush at a time and only the tail is
+    // redone. The result must be the one a single pass produces, and the
+    // reported first change must leave everything before it untouched.
+    void appendingMatchesASinglePass() {
+        const QVector<QPointF> points = series(3000);
+        LineDecimator whole;
+        whole.setView(0.0, 300.0, 0.0, 10.0, 333.0f, 120.0f);
+        whole.update(points.constData(), points.size());
+
+        LineDecimator live;
+        live.setView(0.0, 300.0, 0.0, 10.0, 333.0f, 120.0f);
+        QVector<LineDecimator::Point> previous;
+        for (int count = 0; count < points.size(); count = qMin(count + 7, int(points.size()))) {
+            const int next = qMin(count + 7, int(points.size()));
+            const int changed = live.update(points.constData(), next);
+            QVERIFY(changed <= previous.size());
+            for (int i = 0; i < changed; ++i) {
+                QCOMPARE(live.points()[i].x, previous[i].x);
+                QCOMPARE(live.points()[i].y, previous[i].y);
+            }
+            previous = live.points();
+        }
+        QVERIFY(same(live.points(), whole.points()));
+    }
+
+    void resetStartsOverUnderANewView() {
+        const QVector<QPointF> points = series(1000);
+        LineDecimator lod;
+        lod.setView(0.0, 100.0, 0.0, 10.0, 50.0f, 50.0f);
+        lod.update(points.constData(), points.size());
+
+        lod.setView(0.0, 100.0, 0.0, 10.0, 1000.0f, 50.0f);
+        lod.reset();
+        QCOMPARE(lod.update(points.constData(), points.size()), 0);
+
+        LineDecimator fresh;
+        fresh.setView(0.0, 100.0, 0.0, 10.0, 1000.0f, 50.0f);
+        fresh.update(points.constData(), points.size());
+        QVERIFY(same(lod.points(), fresh.points()));
+    }
+
+    // A zoom, a resize or a history page loading a finished shot.
+    void benchmarkFullRebuild() {
+        const QVector<QPointF> points = series(6000);
+        LineDecimator lod;
+        lod.setView(0.0, 600.0, 0.0, 10.0, 800.0f, 300.0f);
+        QBENCHMARK {
+            lod.reset();
+            lod.update(points.constData(), points.size());
+        }
+    }
+
+    // One live flush at the end of a 10-minute shot: only the open column and
+    // the new points are looked at, however long the series.
+    void benchmarkLiveFlush() {
+        const QVector<QPointF> points = series(6000);
+        LineDecimator lod;
+        lod.setView(0.0, 600.0, 0.0, 10.0, 800.0f, 300.0f);
+        lod.update(points.constData(), points.size() - 5);
+        QBENCHMARK {
+            lod.update(points.constData(), points.size());
+        }
+    }
+};
+
+QTEST_MAIN(tst_LineDecimator)
+#include "tst_linedecimator.moc"
@@ -20,16 +20,18 @@ class tst_McpToolsShotsDebugLog : public QObject {
 
     static qint64 insertShotWithDebugLog(QSqlDatabase& db, const QString& debugLog) {
         QSqlQuery q(db);
-        q.prepare("INSERT INTO shots (uuid, timestamp, profile_name, duration_seconds, debug_log) "
-                  "VALUES (:uuid, :ts, 'Test', 30, :log)");
+        q.prepare("INSERT INTO shots (uuid, timestamp, profile_name, duration_seconds) "
+                  "VALUES (:uuid, :ts, 'Test', 30)");
         q.bindValue(":uuid", QUuid::createUuid().toString(QUuid::WithoutBraces));
         q.bindValue(":ts", QDateTime::currentSecsSinceEpoch());
-        q.bindValue(":log", debugLog);
         if (!q.exec()) {
             qWarning() << "insertShotWithDebugLog failed:" << q.lastError().text();
             return -1;
         }
-        return q.lastInsertId().toLongLong();
+        const qint64 shotId = q.lastInsertId().toLongLong();
+        if (!ShotHistoryStorage::storeDebugLogStatic(db, shotId, debugLog))
+            return -1;
+        return shotId;
     }
 
 private slots:
@@ -224,19 +226,26 @@ private slots:
             QVERIFY(r.exec());
             const qint64 recipeId = r.lastInsertId().toLongLong();
 
+            // Carries a profile, so the shot_profiles join (whose profile_json
+            // shares its name with the recipes column) is exercised too.
+            const std::optional<QString> hash =
+                ShotHistoryStorage::storeProfileJsonStatic(db, QStringLiteral("{}"));
+            QVERIFY(hash.has_value());
+
             QSqlQuery q(db);
             q.prepare("INSERT INTO shots (uuid, timestamp, profile_name, duration_seconds, "
-                      "profile_json, recipe_id) VALUES (:uuid, :ts, 'Test', 30, '{}', :rid)");
+                      "profile_hash, recipe_id) VALUES (:uuid, :ts, 'Test', 30, :hash, :rid)");
             q.bindValue(":uuid", QUuid::createUuid().toString(QUuid::WithoutBraces));
             q.bindValue(":ts", QDateTime::currentSecsSinceEpoch());
+            q.bindValue(":hash", *hash);
             q.bindValue(":rid", recipeId);
             QVERIFY(q.exec());
 
             // A second shot with no recipe, to prove the fields are sparse rather
             // than empty-but-present.
             QSqlQuery q2(db);
-            q2.prepare("INSERT INTO shots (uuid, timestamp, profile_name, duration_seconds, "
-                       "profile_json) VALUES (:uuid, :ts, 'Test', 30, '{}')");
+            q2.prepare("INSERT INTO shots (uuid, timestamp, profile_name, duration_seconds) "
+                       "VALUES (:uuid, :ts, 'Test', 30)");
             q2.bindValue(":uuid", QUuid::createUuid().toString(QUuid::WithoutBraces));
             q2.bindValue(":ts", QDateTime::currentSecsSinceEpoch() - 60);
             QVERIFY(q2.exec());
@@ -247,7 +256,7 @@ private slots:
             // alone, so deleting the name check leaves the test green.
             QSqlQuery q3(db);
             q3.prepare("INSERT INTO shots (uuid, timestamp, profile_name, duration_seconds, "
-                       "profile_json, recipe_id) VALUES (:uuid, :ts, 'Test', 30, '{}', 999999)");
+                       "recipe_id) VALUES (:uuid, :ts, 'Test', 30, 999999)");
             q3.bindValue(":uuid", QUuid::createUuid().toString(QUuid::WithoutBraces));
             q3.bindValue(":ts", QDateTime::currentSecsSinceEpoch() - 120);
             QVERIFY(q3.exec());
@@ -6,20 +6,28 @@
 #include <QSqlQuery>
 #include <QTemporaryDir>
 
+#include <cmath>
+
 #include "core/dbutils.h"
 #include "history/shothistorystorage.h"
 #include "history/shothistory_types.h"
 #include "history/shotprojection.h"
+#include "history/shotsampleblob.h"
 #include "models/shotdatamodel.h"
 #include "network/visualizeruploader.h"
 
-// Guards the mix temperature goal's trip through the sample blob.
+// Guards the shot series' trip through the sample blob.
+//
+// Shot series are not table columns — they live in shot_samples.data_blob,
+// whose series are read back optionally. That is what makes adding a series
+// migration-free, and what makes the "absent key" case real: every shot
+// recorded before the mix temperature goal existed has a blob without it, and
+// must load with an EMPTY vector rather than a defaulted or zeroed one.
 //
-// Shot series are not table columns — they live in a qCompress'd JSON object in
-// shot_samples.data_blob, whose series keys are read back optionally. That is
-// what makes adding a series migration-free, and what makes the "absent key"
-// case real: every shot recorded before this series existed has a blob without
-// it, and must load with an EMPTY vector rather than a defaulted or zeroed one.
+// The blob has two formats (history/shotsampleblob.h): the legacy qCompress'd
+// JSON every older shot still carries, and the binary columnar one new shots
+// are written in. Legacy blobs here are built by hand in the old encoder's
+// shape, because nothing in production writes them any more.
 class tst_SampleBlobSeries : public QObject {
     Q_OBJECT
 
@@ -47,6 +55,67 @@ private:
         model.computeConductanceDerivative();
     }
 
+    // A shot-length recording with the value shapes production sees: a
+    // millisecond clock, DE1 sensor fields on binary fractions, goals typed
+    // in decimals, and derived curves that are neither.
+    static void populateLong(ShotDataModel& model, int samples) {
+        for (int i = 0; i < samples; i++) {
+            const double t = (i * 200 + (i * 37) % 11) / 1000.0;
+            const double pressure = qRound(std::min(9.0, i * 0.15) * 16.0) / 16.0;
+            const double flow = qRound((1.0 + std::sin(i * 0.05)) * 16.0) / 16.0;
+            model.addSample(t, pressure, flow, 92.0 + (i % 7) / 256.0, 90.5, 9.0, 0.0,
+                            /*tempGoal*/ 92.0, /*tempMixGoal*/ 94.0);
+        }
+        model.computeConductanceDerivative();
+    }
+
+    static QJsonObject jsonSeries(const QVector<QPointF>& points) {
+        QJsonArray t, v;
+        for (const auto& pt : points) {
+            t.append(pt.x());
+            v.append(pt.y());
+        }
+        QJsonObject obj;
+        obj["t"] = t;
+        obj["v"] = v;
+        return obj;
+    }
+
+    // The legacy blob body, key for key as the pre-binary encoder wrote it.
+    static QJsonObject legacyRoot(const ShotDataModel& model) {
+        QJsonObject root;
+        root["pressure"] = jsonSeries(model.pressureData());
+        root["flow"] = jsonSeries(model.flowData());
+        root["temperature"] = jsonSeries(model.temperatureData());
+        root["pressureGoal"] = jsonSeries(model.pressureGoalData());
+        root["flowGoal"] = jsonSeries(model.flowGoalData());
+        root["temperatureGoal"] = jsonSeries(model.temperatureGoalData());
+        root["temperatureMixGoal"] = jsonSeries(model.temperatureMixGoalData());
+        root["temperatureMix"] = jsonSeries(model.temperatureMixData());
+        root["resistance"] = jsonSeries(model.resistanceData());
+        root["conductance"] = jsonSeries(model.conductanceData());
+        root["darcyResistance"] = jsonSeries(model.darcyResistanceData());
+        root["conductanceDerivative"] = jsonSeries(model.conductanceDerivativeData());
+        root["waterDispensed"] = jsonSeries(model.waterDispensedData());
+        root["weight"] = jsonSeries(model.cumulativeWeightData());
+        root["weightFlow"] = jsonSeries(model.weightData());
+        root["weightFlowRate"] = jsonSeries(model.weightFlowRateData());
+        return root;
+    }
+
+    static QByteArray legacyBlob(const QJsonObject& root) {
+        return qCompress(QJsonDocument(root).toJson(QJsonDocument::Compact), 9);
+    }
+
+    // QPointF's operator== is a fuzzy compare; the codec's promise is exact.
+    static bool bitIdentical(const QVector<QPointF>& a, const QVector<QPointF>& b) {
+        if (a.size() != b.size()) return false;
+        for (qsizetype i = 0; i < a.size(); ++i) {
+            if (a[i].x() != b[i].x() || a[i].y() != b[i].y()) return false;
+        }
+        return true;
+    }
+
 private slots:
     void init() { QTest::failOnWarning(); }
 
@@ -68,17 +137,14 @@ private slots:
 
     // A shot saved before this series existed: same blob shape, minus the key.
     void blobWithoutMixGoalKeyLoadsEmpty() {
-        ShotHistoryStorage storage;
         ShotDataModel model;
         populate(model);
 
-        QByteArray blob = storage.compressSampleData(&model);
-        QJsonObject root = QJsonDocument::fromJson(qUncompress(blob)).object();
+        QJsonObject root = legacyRoot(model);
         root.remove("temperatureMixGoal");
-        QByteArray legacyBlob = qCompress(QJsonDocument(root).toJson(QJsonDocument::Compact), 9);
 
         ShotRecord record;
-        ShotHistoryStorage::decompressSampleData(legacyBlob, &record);
+        ShotHistoryStorage::decompressSampleData(legacyBlob(root), &record);
 
         // Empty means "not recorded" — never a zero-filled series, which would
         // upload a 0 °C goal line and draw one on the graph.
@@ -94,12 +160,10 @@ private slots:
     // that decompressSampleData recomputes from pressure/flow instead of
     // trusting the stored formula, and reports a corrected blob when it differs.
     void staleResistanceFormulaGetsCorrectedOnLoad() {
-        ShotHistoryStorage storage;
         ShotDataModel model;
         populate(model);  // constant pressure 9.0, flow 2.0 -> correct P/F resistance = 4.5
 
-        QByteArray blob = storage.compressSampleData(&model);
-        QJsonObject root = QJsonDocument::fromJson(qUncompress(blob)).object();
+        QJsonObject root = legacyRoot(model);
 
         // Overwrite the stored resistance with what the P/F² bug would have
         // produced (9.0 / 2.0² = 2.25), same shape ({t: [...], v: [...]}) as
@@ -111,16 +175,174 @@ private slots:
         for (qsizetype i = 0; i < n; i++) staleValues.append(9.0 / (2.0 * 2.0));
         staleResistance["v"] = staleValues;
         root["resistance"] = staleResistance;
-        QByteArray staleBlob = qCompress(QJsonDocument(root).toJson(QJsonDocument::Compact), 9);
 
         ShotRecord record;
         QByteArray corrected;
-        ShotHistoryStorage::decompressSampleData(staleBlob, &record, &corrected);
+        bool curvesChanged = false;
+        ShotHistoryStorage::decompressSampleData(legacyBlob(root), &record, &corrected,
+                                                 &curvesChanged);
 
         QVERIFY(!record.resistance.isEmpty());
         QVERIFY2(qAbs(record.resistance.first().y() - 4.5) < 0.01,
                  "resistance must be recomputed as P/F (4.5), not trusted as the stale P/F² value (2.25)");
         QVERIFY2(!corrected.isEmpty(), "a stale stored curve must produce a corrected blob to persist");
+        QVERIFY(curvesChanged);
+    }
+
+    // The lazy half of the format migration: a legacy blob whose curves are
+    // already right still comes back re-encoded, but flagged as a format-only
+    // change — loadShotRecordStatic leaves updated_at alone for those, so
+    // opening old shots doesn't invalidate their exports one by one.
+    void legacyBlobIsUpgradedWithoutCurveChange() {
+        ShotDataModel model;
+        populateLong(model, 60);
+
+        ShotRecord legacy;
+        QByteArray corrected;
+        bool curvesChanged = true;
+        ShotHistoryStorage::decompressSampleData(legacyBlob(legacyRoot(model)), &legacy,
+                                                 &corrected, &curvesChanged);
+
+        QVERIFY2(!corrected.isEmpty(), "a legacy blob must be re-encoded on read");
+        QVERIFY(ShotSampleBlob::isBinary(corrected));
+        QVERIFY2(!curvesChanged, "a format-only upgrade is not a curve correction");
+
+        // And the upgraded blob is final: reading it back asks for nothing.
+        ShotRecord upgraded;
+        QByteArray again;
+        ShotHistoryStorage::decompressSampleData(corrected, &upgraded, &again);
+        QVERIFY(again.isEmpty());
+        QVERIFY(bitIdentical(upgraded.pressure, legacy.pressure));
+        QVERIFY(bitIdentical(upgraded.weightFlowRate, legacy.weightFlowRate));
+        QVERIFY(bitIdentical(upgraded.temperatureMixGoal, legacy.temperatureMixGoal));
+    }
+
+    // Lossless is the property everything downstream leans on: detector
+    // verdicts and the curve self-heal comparison must not move across the
+    // format change. Covers each encoding the codec picks — decimal fixed
+    // point (ms clock, typed goals), binary fixed point (sensor fractions) and
+    // float64 (derived curves) — in one recording.
+    void binaryBlobRoundTripsBitExact() {
+        ShotHistoryStorage storage;
+        ShotDataModel model;
+        populateLong(model, 300);
+
+        const QByteArray blob = storage.compressSampleData(&model, QStringLiteral("[{\"name\":\"Pour\"}]"));
+        QVERIFY(ShotSampleBlob::isBinary(blob));
+
+        ShotRecord record;
+        QCOMPARE(ShotSampleBlob::decode(blob, &record), ShotSampleBlob::Format::Binary);
+        QVERIFY(bitIdentical(record.pressure, model.pressureData()));
+        QVERIFY(bitIdentical(record.flow, model.flowData()));
+        QVERIFY(bitIdentical(record.temperature, model.temperatureData()));
+        QVERIFY(bitIdentical(record.temperatureMix, model.temperatureMixData()));
+        QVERIFY(bitIdentical(record.pressureGoal, model.pressureGoalData()));
+        QVERIFY(bitIdentical(record.temperatureMixGoal, model.temperatureMixGoalData()));
+        QVERIFY(bitIdentical(record.conductance, model.conductanceData()));
+        QVERIFY(bitIdentical(record.conductanceDerivative, model.conductanceDerivativeData()));
+        QCOMPARE(record.phaseSummariesJson, QStringLiteral("[{\"name\":\"Pour\"}]"));
+    }
+
+    // A truncated blob must fail whole — never a record with some series
+    // populated and the rest silently empty.
+    void truncatedBinaryBlobIsRejected() {
+        ShotHistoryStorage storage;
+        ShotDataModel model;
+        populateLong(model, 60);
+        const QByteArray blob = storage.compressSampleData(&model);
+
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("sample blob"));
+        ShotRecord record;
+        QCOMPARE(ShotSampleBlob::decode(blob.left(blob.size() - 16), &record),
+                 ShotSampleBlob::Format::Invalid);
+        QVERIFY(record.pressure.isEmpty());
+        QVERIFY(record.weight.isEmpty());
+    }
+
+    // A series mask decodes exactly the series it names: everything else on
+    // the record is left as it was (empty here), in both formats.
+    void maskedDecodeTouchesOnlyRequestedSeries() {
+        using ShotSampleBlob::Series;
+        using ShotSampleBlob::seriesBit;
+        ShotHistoryStorage storage;
+        ShotDataModel model;
+        populateLong(model, 60);
+        const ShotSampleBlob::SeriesMask mask =
+            seriesBit(Series::Pressure) | seriesBit(Series::Weight);
+
+        for (const QByteArray& blob : {storage.compressSampleData(&model),
+                                       legacyBlob(legacyRoot(model))}) {
+            ShotRecord record;
+            QVERIFY(ShotSampleBlob::decode(blob, &record, mask) != ShotSampleBlob::Format::Invalid);
+            QVERIFY(bitIdentical(record.pressure, model.pressureData()));
+            QVERIFY(bitIdentical(record.weight, model.cumulativeWeightData()));
+            QVERIFY(record.flow.isEmpty());
+            QVERIFY(record.temperature.isEmpty());
+            QVERIFY(record.conductance.isEmpty());
+            QVERIFY(record.weightFlowRate.isEmpty());
+        }
+    }
+
+    // A partial load still recomputes the derived curves it was asked for
+    // (from pressure/flow it decodes behind the caller's back and then drops),
+    // but never hands back a blob to persist: re-encoding a half-decoded
+    // record would write away every series the mask left out.
+    void partialDecodeDerivesWithoutCorrecting() {
+        ShotDataModel model;
+        populate(model);
+        QJsonObject root = legacyRoot(model);
+        QJsonObject staleResistance = root["resistance"].toObject();
+        QJsonArray staleValues;
+        const qsizetype n = staleResistance["t"].toArray().size();
+        for (qsizetype i = 0; i < n; i++) staleValues.append(9.0 / (2.0 * 2.0));
+        staleResistance["v"] = staleValues;
+        root["resistance"] = staleResistance;
+
+        ShotRecord record;
+        QByteArray corrected;
+        bool curvesChanged = true;
+        ShotHistoryStorage::decompressSampleData(
+            legacyBlob(root), &record, &corrected, &curvesChanged,
+            ShotSampleBlob::seriesBit(ShotSampleBlob::Series::Resistance));
+
+        QVERIFY(!record.resistance.isEmpty());
+        QVERIFY(qAbs(record.resistance.first().y() - 4.5) < 0.01);
+        QVERIFY2(record.pressure.isEmpty() && record.flow.isEmpty(),
+                 "series decoded only to derive from must not leak to the caller");
+        QVERIFY(record.conductance.isEmpty());
+        QVERIFY2(corrected.isEmpty(), "a partial load must never produce a blob to persist");
+        QVERIFY(!curvesChanged);
+    }
+
+    // What the format change buys: decode cost of a 600-sample shot (two
+    // minutes at 5 Hz) in each format, whole and for a three-series caller. `-tickcounter` or `-iterations 500`
+    // for numbers worth comparing; under ctest each row runs once.
+    void decodeBenchmark_data() {
+        using ShotSampleBlob::Series;
+        using ShotSampleBlob::seriesBit;
+        const ShotSampleBlob::SeriesMask comparison =
+            seriesBit(Series::Pressure) | seriesBit(Series::Flow) | seriesBit(Series::Weight);
+        QTest::addColumn<bool>("legacy");
+        QTest::addColumn<ShotSampleBlob::SeriesMask>("mask");
+        QTest::newRow("legacy json") << true << ShotSampleBlob::kAllSeries;
+        QTest::newRow("legacy json, 3 series") << true << comparison;
+        QTest::newRow("binary") << false << ShotSampleBlob::kAllSeries;
+        QTest::newRow("binary, 3 series") << false << comparison;
+    }
+
+    void decodeBenchmark() {
+        QFETCH(bool, legacy);
+        QFETCH(ShotSampleBlob::SeriesMask, mask);
+        ShotHistoryStorage storage;
+        ShotDataModel model;
+        populateLong(model, 600);
+        const QByteArray blob = legacy ? legacyBlob(legacyRoot(model))
+                                       : storage.compressSampleData(&model);
+
+        QBENCHMARK {
+            ShotRecord record;
+            ShotSampleBlob::decode(blob, &record, mask);
+        }
     }
 
     // The counterpart to the above: a shot whose stored curves already match
@@ -139,6 +361,33 @@ private slots:
         QVERIFY2(corrected.isEmpty(), "an already-correct blob must not be flagged for rewrite");
     }
 
+    // saveShot() hands the worker a snapshot and lets the model move on to the
+    // next shot. The worker's encode must see the shot as it was at the
+    // handoff — not the cleared model, and not the next shot's first samples.
+    void workerEncodeReadsTheSnapshotNotTheModel() {
+        ShotHistoryStorage storage;
+        ShotDataModel model;
+        populateLong(model, 300);
+        const QByteArray atHandoff = storage.compressSampleData(&model);
+        const QVector<QPointF> pressureAtHandoff = model.pressureData();
+
+        ShotSaveData data;
+        data.beverageType = QStringLiteral("espresso");
+        data.duration = 60.0;
+        const ShotSampleBuffer snapshot = model.samples();
+
+        model.clear();
+        populate(model);  // the next shot, recording while the worker encodes
+
+        ShotHistoryStorage::encodeShotSamples(data, snapshot);
+        QCOMPARE(data.sampleCount, 300);
+        QCOMPARE(data.compressedSamples, atHandoff);
+
+        ShotRecord record;
+        ShotHistoryStorage::decompressSampleData(data.compressedSamples, &record);
+        QVERIFY(bitIdentical(record.pressure, pressureAtHandoff));
+    }
+
     // The DB-backed counterpart: loadShotRecordStatic must persist the
     // corrected blob back to shot_samples on the same connection (mirroring
     // the existing badge-persist behavior), exactly once — loading the same
@@ -206,6 +455,20 @@ private slots:
         const qint64 updatedAtBefore = readUpdatedAt();
         QVERIFY(updatedAtBefore > 0);
 
+        // A partial load sees the recomputed curve too, but is read-only: the
+        // stale blob and updated_at stay put until a full load heals them.
+        withTempDb(path, "shs_test_resistance_partial", [&](QSqlDatabase& db) {
+            ShotRecord partial = ShotHistoryStorage::loadShotRecordStatic(
+                db, shotId, nullptr, ShotSampleBlob::seriesBit(ShotSampleBlob::Series::Resistance));
+            QCOMPARE(partial.summary.id, shotId);
+            QVERIFY(partial.pressure.isEmpty());
+            QVERIFY(!partial.resistance.isEmpty());
+            QVERIFY(qAbs(partial.resistance.first().y() - 4.5) < 0.01);
+            QVERIFY(!partial.cachedAnalysis.has_value());
+        });
+        QCOMPARE(readBlob(), blobBefore);
+        QCOMPARE(readUpdatedAt(), updatedAtBefore);
+
         withTempDb(path, "shs_test_resistance_load", [&](QSqlDatabase& db) {
             ShotRecord loaded = ShotHistoryStorage::loadShotRecordStatic(db, shotId);
             QVERIFY(!loaded.resistance.isEmpty());
@@ -262,17 +525,15 @@ private slots:
     // Same seam for a shot recorded before the series existed: absence has to
     // survive the whole chain too, or old shots upload a 0 °C goal line.
     void legacyShotStaysAbsentThroughProjectionToJson() {
-        ShotHistoryStorage storage;
         ShotDataModel model;
         populate(model);
 
-        QJsonObject root = QJsonDocument::fromJson(qUncompress(storage.compressSampleData(&model))).object();
+        QJsonObject root = legacyRoot(model);
         root.remove("temperatureMixGoal");
 
         ShotRecord record;
         giveIdentity(record);
-        ShotHistoryStorage::decompressSampleData(
-            qCompress(QJsonDocument(root).toJson(QJsonDocument::Compact), 9), &record);
+        ShotHistoryStorage::decompressSampleData(legacyBlob(root), &record);
         ShotProjection p = ShotHistoryStorage::convertShotRecord(record);
 
         QVERIFY(p.temperatureMixGoal.isEmpty());
@@ -0,0 +1,138 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QThread>
+
+#include <atomic>
+
+#include "ble/blegattqueue.h"
+#include "ble/bletransport.h"
+#include "ble/sawstopchannel.h"
+#include "ble/protocol/de1characteristics.h"
+
+// The stop-at-weight fast path: worker thread → BLE I/O thread → DE1 write.
+//
+// Headless, like tst_blecommandqueue: with no QLowEnergyService a dispatched
+// write fails at writeCharacteristic()'s guard and the queue holds the slot
+// across its retry delay, which is what lets these slots see the Idle write in
+// flight without a radio. Each builds its own BleGattQueue.
+class tst_SawStopChannel : public QObject {
+    Q_OBJECT
+
+private:
+    static QBluetoothUuid requestedState() { return DE1::Characteristic::REQUESTED_STATE; }
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+
+    // Unarmed is the answer for USB, the simulator, a firmware flash and Apple
+    // platforms. The caller relies on `false` to take the main-thread route —
+    // a `true` here with nothing behind it would be a stop that never happens.
+    void anUnarmedChannelRefusesTheStop() {
+        SawStopChannel channel;
+        QSignalSpy issued(&channel, &SawStopChannel::stopIssued);
+
+        QVERIFY(!channel.isArmed());
+        QVERIFY(!channel.post(1000));
+        QTest::qWait(20);
+        QCOMPARE(issued.count(), 0);
+    }
+
+    // The stop does what stopOperationUrgent() does to the transport: stale
+    // work is dropped and Idle goes to the front.
+    void theStopClearsTheQueueAndWritesIdle() {
+        BleGattQueue queue;
+        BleTransport transport(nullptr, &queue);
+        SawStopChannel channel;
+        QSignalSpy issued(&channel, &SawStopChannel::stopIssued);
+
+        transport.write(DE1::Characteristic::FRAME_WRITE, QByteArray(8, 'f'));
+        channel.arm(&transport);
+        QVERIFY(channel.post(1000));
+
+        QTRY_COMPARE(issued.count(), 1);
+        QCOMPARE(issued.at(0).at(0).toLongLong(), qint64(1000));
+        QCOMPARE(issued.at(0).at(2).value<qsizetype>(), qsizetype(1));
+        QTRY_COMPARE(queue.inFlightKey(), requestedState());
+        QCOMPARE(queue.pendingCount(&transport), qsizetype(0));
+
+        transport.disconnect();
+    }
+
+    // A burst of triggers is one stop, timed from the first of them.
+    void postsBeforePickupCoalesceIntoTheFirst() {
+        BleGattQueue queue;
+        BleTransport transport(nullptr, &queue);
+        SawStopChannel channel;
+        QSignalSpy issued(&channel, &SawStopChannel::stopIssued);
+
+        channel.arm(&transport);
+        QVERIFY(channel.post(1000));
+        QVERIFY(channel.post(1005));
+
+        QTRY_COMPARE(issued.count(), 1);
+        QTest::qWait(20);
+        QCOMPARE(issued.count(), 1);
+        QCOMPARE(issued.at(0).at(0).toLongLong(), qint64(1000));
+
+        transport.disconnect();
+    }
+
+    // Disarmed between post() and pickup — a disconnect, a flash starting. The
+    // stop was accepted, so it must come back to DE1Device rather than vanish.
+    void aStopPickedUpAfterDisarmingFallsBack() {
+        BleGattQueue queue;
+        BleTransport transport(nullptr, &queue);
+        SawStopChannel channel;
+        QSignalSpy issued(&channel, &SawStopChannel::stopIssued);
+        QSignalSpy fallback(&channel, &SawStopChannel::fallback);
+
+        channel.arm(&transport);
+        QVERIFY(channel.post(1000));
+        channel.arm(nullptr);
+
+        QTRY_COMPARE(fallback.count(), 1);
+        QCOMPARE(fallback.at(0).at(0).toLongLong(), qint64(1000));
+        QCOMPARE(issued.count(), 0);
+        QVERIFY(!queue.isBusy());
+    }
+
+    // The point of the channel: posted from one thread, issued on the
+    // transport's, with this thread's event loop never involved.
+    void theStopIsIssuedOnTheChannelsThread() {
+        QThread io;
+        auto* queue = new BleGattQueue;
+        auto* transport = new BleTransport(nullptr, queue);
+        auto* channel = new SawStopChannel;
+        queue->moveToThread(&io);
+        transport->moveToThread(&io);
+        channel->moveToThread(&io);
+        io.start();
+
+        std::atomic<QThread*> issuedOn{nullptr};
+        connect(channel, &SawStopChannel::stopIssued, channel,
+                [&issuedOn]() { issuedOn = QThread::currentThread(); },
+                Qt::DirectConnection);
+
+        channel->arm(transport);
+        QVERIFY(channel->post(1000));
+
+        // Polled without pumping this thread: the stop must not need it.
+        QElapsedTimer waited;
+        waited.start();
+        while (!issuedOn.load() && waited.elapsed() < 5000)
+            QThread::msleep(1);
+        QCOMPARE(issuedOn.load(), &io);
+        QTRY_COMPARE(queue->inFlightKey(), requestedState());
+
+        channel->arm(nullptr);
+        transport->disconnect();
+        channel->deleteLater();
+        transport->deleteLater();
+        queue->deleteLater();
+        io.quit();
+        QVERIFY(io.wait(5000));
+    }
+};
+
+QTEST_MAIN(tst_SawStopChannel)
+#include "tst_sawstopchannel.moc"
@@ -0,0 +1,161 @@
+#include <QtTest>
+
+#include <cmath>
+
+#include "ai/seriesview.h"
+#include "ai/shotanalysis.h"
+#include "shotcorpusfixtures.h"
+
+using ShotCorpusFixtures::CorpusShot;
+using ShotCorpusFixtures::identical;
+using ShotCorpusFixtures::loadCorpus;
+
+// SeriesView — the time-indexed lookups shared by the ShotAnalysis detectors
+// and the ShotSummarizer curve helpers.
+//
+// It replaced linear walks that the detectors ran once per sample, so it has
+// one job besides being fast: answer bit-for-bit what those walks answered.
+// The reference implementations below are the replaced helpers, verbatim,
+// checked against both random access and cursors — on edge cases and on
+// the curves of the tests/data/shots corpus. The benchmarks run the
+// detectors that use it over that corpus, as loadShotRecordStatic does.
+//
+// The corpus comes from shotcorpusfixtures.h, loaded in initTestCase.
+class tst_SeriesView : public QObject {
+    Q_OBJECT
+
+private:
+    // --- The replaced helpers ---
+
+    static double linearStep(const QVector<QPointF>& data, double time) {
+        if (data.isEmpty()) return 0.0;
+        for (const auto& pt : data) {
+            if (pt.x() >= time) return pt.y();
+        }
+        return data.last().y();
+    }
+
+    static double linearOrNaN(const QVector<QPointF>& data, double t) {
+        if (data.isEmpty()) return std::nan("");
+        if (t < data.first().x() || t > data.last().x()) return std::nan("");
+        for (qsizetype i = 1; i < data.size(); ++i) {
+            if (data[i].x() >= t) {
+                const double x0 = data[i - 1].x();
+                const double x1 = data[i].x();
+                const double y0 = data[i - 1].y();
+                const double y1 = data[i].y();
+                if (x1 <= x0) return y1;
+                const double alpha = (t - x0) / (x1 - x0);
+                return y0 + alpha * (y1 - y0);
+            }
+        }
+        return data.last().y();
+    }
+
+    static double linearAverage(const QVector<QPointF>& data, double startTime, double endTime) {
+        if (data.isEmpty()) return 0;
+        double sum = 0;
+        int count = 0;
+        for (const auto& point : data) {
+            if (point.x() >= startTime && point.x() <= endTime) {
+                sum += point.y();
+                count++;
+            }
+        }
+        return count > 0 ? sum / count : 0;
+    }
+
+    QList<CorpusShot> m_corpus;
+
+private slots:
+    void initTestCase() {
+        m_corpus = loadCorpus();
+        QVERIFY(m_corpus.size() >= 10);
+    }
+
+    void init() { QTest::failOnWarning(); }
+
+    void emptyAndSingleSample() {
+        const QVector<QPointF> empty;
+        QCOMPARE(SeriesView(empty).stepAt(1.0), 0.0);
+        QVERIFY(std::isnan(SeriesView(empty).interpolateOrNaN(1.0)));
+        QCOMPARE(SeriesView(empty).interpolateAt(1.0), 0.0);
+        QCOMPARE(SeriesView(empty).max(0.0, 10.0), 0.0);
+
+        const QVector<QPointF> one{QPointF(2.0, 7.0)};
+        QCOMPARE(SeriesView(one).stepAt(0.0), 7.0);
+        QCOMPARE(SeriesView(one).stepAt(9.0), 7.0);
+        QCOMPARE(SeriesView(one).interpolateOrNaN(2.0), 7.0);
+        QVERIFY(std::isnan(SeriesView(one).interpolateOrNaN(2.5)));
+        QCOMPARE(SeriesView(one).min(2.0, 2.0), 7.0);
+    }
+
+    // Imported shots can open with a run of t = 0 preheat samples
+    // (puck_failure_short_gusher has 29): the first of a run answers a step
+    // lookup, the last of it brackets an interpolation.
+    void equalTimestamps() {
+        const QVector<QPointF> data{QPointF(0.0, 4.0), QPointF(0.0, 5.0), QPointF(0.0, 6.0),
+                                    QPointF(1.0, 8.0), QPointF(1.0, 9.0), QPointF(2.0, 10.0)};
+        const QVector<double> times{-1.0, 0.0, 0.5, 1.0, 1.5, 2.0, 3.0};
+        checkAgainstLinear(data, times, QStringLiteral("equal timestamps"));
+        QCOMPARE(SeriesView(data).stepAt(0.0), 4.0);
+        QCOMPARE(SeriesView(data).interpolateOrNaN(0.0), 5.0);
+        QCOMPARE(SeriesView(data).interpolateAt(0.5), 7.0);
+        QCOMPARE(SeriesView(data).average(0.0, 1.0), 32.0 / 5.0);
+    }
+
+    void corpusLookupsMatchTheLinearHelpers() {
+        for (const CorpusShot& shot : m_corpus) {
+            const ShotRecord& r = shot.record;
+            const QVector<double> times = queryTimes(r.pressure);
+            checkAgainstLinear(r.pressure, times, shot.file + QStringLiteral(" pressure"));
+            checkAgainstLinear(r.flow, times, shot.file + QStringLiteral(" flow"));
+            checkAgainstLinear(r.pressureGoal, times, shot.file + QStringLiteral(" pressureGoal"));
+            checkAgainstLinear(r.flowGoal, times, shot.file + QStringLiteral(" flowGoal"));
+            checkAgainstLinear(r.weight, times, shot.file + QStringLiteral(" weight"));
+        }
+    }
+
+    // The detectors that made analysis O(n²): channeling windows (six
+    // interpolations per sample) and flow-vs-goal (four step lookups).
+    void benchmarkCorpusDetectors() {
+        QBENCHMARK {
+            for (const CorpusShot& shot : m_corpus) {
+                const ShotRecord& r = shot.record;
+                const auto windows = ShotAnalysis::buildChannelingWindows(
+                    r.pressure, r.flow, r.pressureGoal, r.flowGoal, r.phases,
+                    shot.pourStart, shot.pourEnd);
+                const auto grind = ShotAnalysis::analyzeFlowVsGoal(
+                    r.flow, r.flowGoal, r.phases, shot.pourStart, shot.pourEnd,
+                    QString(), QStringList(), r.pressure);
+                Q_UNUSED(windows);
+                Q_UNUSED(grind);
+            }
+        }
+    }
+
+    // What ShotSummarizer computes per phase: average/max/min and a point
+    // lookup, each a pair of binary searches now rather than a full scan.
+    void benchmarkCorpusPhaseMetrics() {
+        QBENCHMARK {
+            double sink = 0;
+            for (const CorpusShot& shot : m_corpus) {
+                const ShotRecord& r = shot.record;
+                const SeriesView pressure(r.pressure);
+                const SeriesView flow(r.flow);
+                for (qsizetype i = 0; i < r.phases.size(); ++i) {
+                    const double start = r.phases[i].time;
+                    const double end = i + 1 < r.phases.size() ? r.phases[i + 1].time : shot.pourEnd;
+                    sink += pressure.average(start, end);
+                    sink += flow.max(start, end);
+                    sink += flow.min(start, end);
+                    sink += pressure.interpolateAt((start + end) / 2);
+                }
+            }
+            QVERIFY(!std::isnan(sink));
+        }
+    }
+};
+
+QTEST_MAIN(tst_SeriesView)
+#include "tst_seriesview.moc"
@@ -0,0 +1,139 @@
+#include <QtTest>
+
+#include <cmath>
+
+#include "models/shotcomparisonmodel.h"
+
+// ShotComparisonModel — the curve accessors and crosshair lookup behind the
+// comparison graph.
+//
+// Every window change re-reads 3 shots × 11 curves through the getters, and
+// every crosshair move asks getValuesAtTime for each shot. The getters hand
+// QML the stored sequence itself (no per-point boxing), and the lookup is a
+// binary search that must answer exactly as the linear scan it replaced:
+// nearest within 1 s, earlier sample on a tie, -1.0 for "missing".
+// The window is seeded through the friend; no database is opened.
+class tst_ShotComparisonModel : public QObject {
+    Q_OBJECT
+
+private:
+    using Shot = ShotComparisonModel::ComparisonShot;
+
+    // A 5 Hz shot of the given length with every curve populated.
+    static Shot shot(qint64 id, double seconds) {
+        Shot s;
+        s.id = id;
+        s.duration = seconds;
+        const int count = static_cast<int>(seconds * 5.0);
+        for (int i = 0; i < count; ++i) {
+            const double t = i * 0.2;
+            s.pressure.append(QPointF(t, 9.0 + std::sin(t)));
+            s.flow.append(QPointF(t, 2.0 + std::cos(t)));
+            s.temperature.append(QPointF(t, 93.0));
+            s.weight.append(QPointF(t, t * 0.8));
+            s.weightFlowRate.append(QPointF(t, 1.6));
+            s.resistance.append(QPointF(t, 4.0));
+            s.conductance.append(QPointF(t, 0.25));
+            s.conductanceDerivative.append(QPointF(t, std::sin(t * 3.0)));
+            s.darcyResistance.append(QPointF(t, 3.0));
+            s.temperatureMix.append(QPointF(t, 92.5));
+            s.temperatureMixGoal.append(QPointF(t, 93.0));
+        }
+        return s;
+    }
+
+    static void seed(ShotComparisonModel& model, const QList<Shot>& shots) {
+        model.m_displayShots = shots;
+    }
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+
+    void gettersReturnTheStoredCurve() {
+        ShotComparisonModel model;
+        const Shot s = shot(1, 30.0);
+        seed(model, {s});
+
+        QCOMPARE(model.getPressureData(0), s.pressure);
+        QCOMPARE(model.getConductanceDerivativeData(0), s.conductanceDerivative);
+        QCOMPARE(model.getTemperatureMixGoalData(0), s.temperatureMixGoal);
+        QVERIFY(model.getFlowData(1).isEmpty());
+        QVERIFY(model.getFlowData(-1).isEmpty());
+    }
+
+    void nearestSampleWithinOneSecond() {
+        ShotComparisonModel model;
+        Shot s;
+        s.pressure = {QPointF(0.0, 1.0), QPointF(2.0, 2.0), QPointF(4.0, 3.0)};
+        seed(model, {s});
+
+        QCOMPARE(model.getValuesAtTime(0, 2.3).value("pressure").toDouble(), 2.0);
+        QCOMPARE(model.getValuesAtTime(0, 3.4).value("pressure").toDouble(), 3.0);
+        QCOMPARE(model.getValuesAtTime(0, 9.0).value("pressure").toDouble(), -1.0);
+        QCOMPARE(model.getValuesAtTime(0, 9.0).value("hasPressure").toBool(), false);
+        QCOMPARE(model.getValuesAtTime(0, -0.5).value("pressure").toDouble(), 1.0);
+        QCOMPARE(model.getValuesAtTime(0, 1.0).value("hasFlow").toBool(), false);
+    }
+
+    // Halfway between two samples, and among samples sharing a timestamp,
+    // the earliest wins.
+    void tiesGoToTheEarlierSample() {
+        ShotComparisonModel model;
+        Shot s;
+        s.pressure = {QPointF(0.0, 1.0), QPointF(1.0, 2.0), QPointF(1.0, 5.0), QPointF(2.0, 3.0)};
+        seed(model, {s});
+
+        QCOMPARE(model.getValuesAtTime(0, 0.5).value("pressure").toDouble(), 1.0);
+        QCOMPARE(model.getValuesAtTime(0, 1.0).value("pressure").toDouble(), 2.0);
+        QCOMPARE(model.getValuesAtTime(0, 1.2).value("pressure").toDouble(), 2.0);
+        QCOMPARE(model.getValuesAtTime(0, 1.5).value("pressure").toDouble(), 2.0);
+    }
+
+    // dC/dt can be -1.0 for real, so its presence is reported on its own.
+    void negativeConductanceDerivativeIsPresent() {
+        ShotComparisonModel model;
+        Shot s;
+        s.conductanceDerivative = {QPointF(0.0, 0.5), QPointF(1.0, -1.0)};
+        seed(model, {s});
+
+        const QVariantMap at = model.getValuesAtTime(0, 1.1);
+        QCOMPARE(at.value("hasConductanceDerivative").toBool(), true);
+        QCOMPARE(at.value("conductanceDerivative").toDouble(), -1.0);
+
+        const QVariantMap past = model.getValuesAtTime(0, 5.0);
+        QCOMPARE(past.value("hasConductanceDerivative").toBool(), false);
+        QCOMPARE(past.value("conductanceDerivative").toDouble(), 0.0);
+    }
+
+    // What the graph does when the window shifts: read every curve of the
+    // three shots on show, then sweep the crosshair across them.
+    void benchmarkWindowSwitch() {
+        ShotComparisonModel model;
+        seed(model, {shot(1, 120.0), shot(2, 300.0), shot(3, 600.0)});
+
+        QBENCHMARK {
+            qsizetype points = 0;
+            for (int i = 0; i < model.displayShotCount(); ++i) {
+                points += model.getPressureData(i).size();
+                points += model.getFlowData(i).size();
+                points += model.getTemperatureData(i).size();
+                points += model.getWeightData(i).size();
+                points += model.getWeightFlowRateData(i).size();
+                points += model.getResistanceData(i).size();
+                points += model.getConductanceData(i).size();
+                points += model.getConductanceDerivativeData(i).size();
+                points += model.getDarcyResistanceData(i).size();
+                points += model.getTemperatureMixData(i).size();
+                points += model.getTemperatureMixGoalData(i).size();
+            }
+            QVERIFY(points > 0);
+            for (double t = 0.0; t < 600.0; t += 5.0) {
+                for (int i = 0; i < model.displayShotCount(); ++i)
+                    model.getValuesAtTime(i, t);
+            }
+        }
+    }
+};
+
+QTEST_MAIN(tst_ShotComparisonModel)
+#include "tst_shotcomparisonmodel.moc"
@@ -0,0 +1,422 @@
+// ShotFileParser::parse — the de1app .shot (Tcl) import path.
+//
+// parse() reads the file's bytes in place through a one-pass key index rather
+// than decoding it to a QString and running a multiline regex per key. These
+// hold it to the regex implementation it replaced, kept below as the
+// reference: every field of the record must come out identical on the
+// tests/data/de1app_shots fixtures, which include CRLF endings, a missing
+// clock, values on the line after their key, repeated and indented keys, and
+// non-numeric list tokens. The benchmark parses a 1,000-file history with
+// both.
+
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+#include <QDateTime>
+#include <QTimeZone>
+#include <QJsonDocument>
+#include <QRegularExpression>
+
+#include "history/shotfileparser.h"
+#include "core/grinderaliases.h"
+
+namespace {
+
+// --- The QString + QRegularExpression parser, verbatim in behaviour --------
+
+QVector<double> legacyParseTclList(const QString& listStr)
+{
+    QVector<double> result;
+    QString str = listStr.trimmed();
+    if (str.startsWith('{') && str.endsWith('}'))
+        str = str.mid(1, str.length() - 2);
+    const QStringList parts = str.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+    result.reserve(parts.size());
+    for (const QString& part : parts) {
+        bool ok;
+        const double val = part.toDouble(&ok);
+        if (ok) result.append(val);
+    }
+    return result;
+}
+
+QVariantMap legacyParseTclDict(const QString& dictStr)
+{
+    QVariantMap result;
+    QString str = dictStr.trimmed();
+    if (str.startsWith('{') && str.endsWith('}'))
+        str = str.mid(1, str.length() - 2);
+
+    int pos = 0;
+    while (pos < str.length()) {
+        while (pos < str.length() && str[pos].isSpace()) pos++;
+        if (pos >= str.length()) break;
+        QString key;
+        while (pos < str.length() && !str[pos].isSpace() && str[pos] != '{')
+            key += str[pos++];
+        while (pos < str.length() && str[pos].isSpace()) pos++;
+        if (pos >= str.length()) break;
+        QString value;
+        if (str[pos] == '{') {
+            int braceCount = 1;
+            pos++;
+            const int valueStart = pos;
+            while (pos < str.length() && braceCount > 0) {
+                if (str[pos] == '{') braceCount++;
+                else if (str[pos] == '}') braceCount--;
+                pos++;
+            }
+            value = str.mid(valueStart, pos - valueStart - 1);
+        } else {
+            while (pos < str.length() && !str[pos].isSpace())
+                value += str[pos++];
+        }
+        if (!key.isEmpty()) result[key] = value;
+    }
+    return result;
+}
+
+QString legacyExtractValue(const QString& content, const QString& key)
+{
+    const QRegularExpression re(QString("^%1\\s+(.+)$").arg(QRegularExpression::escape(key)),
+                                QRegularExpression::MultilineOption);
+    const QRegularExpressionMatch match = re.match(content);
+    if (!match.hasMatch()) return QString();
+
+    const QString value = match.captured(1).trimmed();
+    if (value.startsWith('{')) {
+        int braceCount = 1;
+        int pos = 1;
+        while (pos < value.length() && braceCount > 0) {
+            if (value[pos] == '{') braceCount++;
+            else if (value[pos] == '}') braceCount--;
+            pos++;
+        }
+        return value.left(pos);
+    }
+    return value.split(QRegularExpression("\\s+")).first();
+}
+
+QString legacyExtractBracedBlock(const QString& content, const QString& key)
+{
+    const qsizetype keyPos = content.indexOf(QRegularExpression(
+        QString("^%1\\s+\\{").arg(QRegularExpression::escape(key)), QRegularExpression::MultilineOption));
+    if (keyPos < 0) return QString();
+    const qsizetype braceStart = content.indexOf('{', keyPos);
+    if (braceStart < 0) return QString();
+    int braceCount = 1;
+    qsizetype pos = braceStart + 1;
+    while (pos < content.length() && braceCount > 0) {
+        if (content[pos] == '{') braceCount++;
+        else if (content[pos] == '}') braceCount--;
+        pos++;
+    }
+    return content.mid(braceStart, pos - braceStart);
+}
+
+QVector<QPointF> legacyToPointVector(const QVector<double>& times, const QVector<double>& values)
+{
+    QVector<QPointF> result;
+    const qsizetype count = qMin(times.size(), values.size());
+    for (qsizetype i = 0; i < count; ++i) {
+        if (values[i] >= 0) result.append(QPointF(times[i], values[i]));
+    }
+    return result;
+}
+
+// Everything ShotFileParser::parse fills except the uuid, which is a hash of
+// the timestamp and filename and compared through the timestamp instead.
+ShotFileParser::ParseResult legacyParse(const QByteArray& fileContents, const QString& filename)
+{
+    ShotFileParser::ParseResult result;
+    const QString content = QString::fromUtf8(fileContents);
+
+    const QString clockStr = legacyExtractValue(content, "clock");
+    qint64 timestamp = clockStr.toLongLong();
+    if (timestamp == 0) {
+        const QDateTime dt = QDateTime::fromString(filename.section('.', 0, 0), "yyyyMMddTHHmmss");
+        if (dt.isValid())
+            timestamp = QDateTime(dt.date(), dt.time(), QTimeZone::utc()).toSecsSinceEpoch();
+    }
+    if (timestamp == 0) {
+        result.errorMessage = clockStr.isEmpty() ? "Missing clock timestamp" : "Invalid clock timestamp";
+        return result;
+    }
+    result.record.summary.timestamp = timestamp;
+
+    const auto list = [&](const char* key) { return legacyParseTclList(legacyExtractValue(content, key)); };
+    const QVector<double> elapsed = list("espresso_elapsed");
+    if (elapsed.isEmpty()) {
+        result.errorMessage = "Missing espresso_elapsed data";
+        return result;
+    }
+
+    ShotRecord& r = result.record;
+    r.pressure = legacyToPointVector(elapsed, list("espresso_pressure"));
+    r.flow = legacyToPointVector(elapsed, list("espresso_flow"));
+    r.temperature = legacyToPointVector(elapsed, list("espresso_temperature_basket"));
+    r.weight = legacyToPointVector(elapsed, list("espresso_weight"));
+    r.pressureGoal = legacyToPointVector(elapsed, list("espresso_pressure_goal"));
+    r.flowGoal = legacyToPointVector(elapsed, list("espresso_flow_goal"));
+    r.temperatureGoal = legacyToPointVector(elapsed, list("espresso_temperature_goal"));
+    const QVector<double> tempMix = list("espresso_temperature_mix");
+    if (!tempMix.isEmpty()) r.temperatureMix = legacyToPointVector(elapsed, tempMix);
+    const QVector<double> resistance = list("espresso_resistance");
+    if (!resistance.isEmpty()) r.resistance = legacyToPointVector(elapsed, resistance);
+    QVector<double> waterDispensed = list("espresso_water_dispensed");
+    if (!waterDispensed.isEmpty()) {
+        for (auto& v : waterDispensed) v *= 10.0;
+        r.waterDispensed = legacyToPointVector(elapsed, waterDispensed);
+    }
+    const QVector<double> flowWeight = list("espresso_flow_weight");
+    if (!flowWeight.isEmpty()) r.weightFlowRate = legacyToPointVector(elapsed, flowWeight);
+    r.summary.duration = elapsed.last();
+
+    const QString settingsBlock = legacyExtractBracedBlock(content, "settings");
+    if (!settingsBlock.isEmpty()) {
+        const QVariantMap settings = legacyParseTclDict(settingsBlock);
+        r.summary.profileName = settings.value("profile_title", "Unknown").toString();
+        r.summary.beanBrand = settings.value("bean_brand").toString();
+        r.summary.beanType = settings.value("bean_type").toString();
+        r.roastDate = settings.value("roast_date").toString();
+        r.roastLevel = settings.value("roast_level").toString();
+        const QString rawGrinder = settings.value("grinder_model").toString();
+        const auto grinderLookup = GrinderAliases::lookup(rawGrinder);
+        if (grinderLookup.found) {
+            r.grinderBrand = grinderLookup.brand;
+            r.grinderModel = grinderLookup.model;
+            r.grinderBurrs = grinderLookup.stockBurrs;
+        } else {
+            r.grinderModel = rawGrinder;
+        }
+        r.grinderSetting = settings.value("grinder_setting").toString();
+        r.drinkTds = settings.value("drink_tds").toDouble();
+        r.drinkEy = settings.value("drink_ey").toDouble();
+        r.summary.enjoyment = settings.value("espresso_enjoyment").toInt();
+        r.espressoNotes = settings.value("espresso_notes").toString();
+        r.barista = settings.value("my_name", settings.value("drinker_name")).toString();
+        r.summary.doseWeight = settings.value("grinder_dose_weight").toDouble();
+        r.summary.finalWeight = settings.value("drink_weight").toDouble();
+        r.summary.beverageType = settings.value("beverage_type", "espresso").toString();
+        r.beanNotes = settings.value("bean_notes").toString();
+        r.profileNotes = settings.value("profile_notes").toString();
+    }
+    if (r.summary.finalWeight <= 0 && !r.weight.isEmpty()) {
+        double maxWeight = 0;
+        for (const auto& pt : r.weight) maxWeight = qMax(maxWeight, pt.y());
+        r.summary.finalWeight = maxWeight;
+    }
+
+    const QString profileBlock = legacyExtractBracedBlock(content, "profile");
+    if (!QJsonDocument::fromJson(profileBlock.toUtf8()).isNull())
+        r.profileJson = profileBlock;
+
+    const qint64 espressoStart = legacyExtractValue(content, "timers(espresso_start)").toLongLong();
+    const qint64 preinfStart = legacyExtractValue(content, "timers(espresso_preinfusion_start)").toLongLong();
+    const qint64 pourStart = legacyExtractValue(content, "timers(espresso_pour_start)").toLongLong();
+    if (espressoStart > 0) {
+        if (preinfStart > 0 && preinfStart >= espressoStart) {
+            HistoryPhaseMarker marker;
+            marker.time = (preinfStart - espressoStart) / 1000.0;
+            marker.label = "Preinfusion";
+            marker.isFlowMode = true;
+            r.phases.append(marker);
+        }
+        if (pourStart > 0 && pourStart > espressoStart) {
+            HistoryPhaseMarker marker;
+            marker.time = (pourStart - espressoStart) / 1000.0;
+            marker.label = "Pour";
+            marker.isFlowMode = false;
+            r.phases.append(marker);
+        }
+    }
+
+    result.success = true;
+    return result;
+}
+
+QString fixtureDir()
+{
+    return QStringLiteral(TST_SHOT_PARSE_SOURCE_DIR) + QStringLiteral("/data/de1app_shots");
+}
+
+QByteArray readFixture(const QString& name)
+{
+    QFile f(fixtureDir() + QLatin1Char('/') + name);
+    return f.open(QIODevice::ReadOnly) ? f.readAll() : QByteArray();
+}
+
+} // namespace
+
+class TstShotFileParser : public QObject
+{
+    Q_OBJECT
+
+    // Field by field, so a mismatch names the field rather than just failing.
+    static void compareRecords(const ShotFileParser::ParseResult& actual,
+                               const ShotFileParser::ParseResult& expected)
+    {
+        QCOMPARE(actual.success, expected.success);
+        QCOMPARE(actual.errorMessage, expected.errorMessage);
+        const ShotRecord& a = actual.record;
+        const ShotRecord& e = expected.record;
+        QCOMPARE(a.summary.timestamp, e.summary.timestamp);
+        QCOMPARE(a.summary.duration, e.summary.duration);
+        QCOMPARE(a.pressure, e.pressure);
+        QCOMPARE(a.flow, e.flow);
+        QCOMPARE(a.temperature, e.temperature);
+        QCOMPARE(a.weight, e.weight);
+        QCOMPARE(a.pressureGoal, e.pressureGoal);
+        QCOMPARE(a.flowGoal, e.flowGoal);
+        QCOMPARE(a.temperatureGoal, e.temperatureGoal);
+        QCOMPARE(a.temperatureMix, e.temperatureMix);
+        QCOMPARE(a.resistance, e.resistance);
+        QCOMPARE(a.waterDispensed, e.waterDispensed);
+        QCOMPARE(a.weightFlowRate, e.weightFlowRate);
+        QCOMPARE(a.summary.profileName, e.summary.profileName);
+        QCOMPARE(a.summary.beanBrand, e.summary.beanBrand);
+        QCOMPARE(a.summary.beanType, e.summary.beanType);
+        QCOMPARE(a.roastDate, e.roastDate);
+        QCOMPARE(a.roastLevel, e.roastLevel);
+        QCOMPARE(a.grinderBrand, e.grinderBrand);
+        QCOMPARE(a.grinderModel, e.grinderModel);
+        QCOMPARE(a.grinderBurrs, e.grinderBurrs);
+        QCOMPARE(a.grinderSetting, e.grinderSetting);
+        QCOMPARE(a.drinkTds, e.drinkTds);
+        QCOMPARE(a.drinkEy, e.drinkEy);
+        QCOMPARE(a.summary.enjoyment, e.summary.enjoyment);
+        QCOMPARE(a.espressoNotes, e.espressoNotes);
+        QCOMPARE(a.barista, e.barista);
+        QCOMPARE(a.summary.doseWeight, e.summary.doseWeight);
+        QCOMPARE(a.summary.finalWeight, e.summary.finalWeight);
+        QCOMPARE(a.summary.beverageType, e.summary.beverageType);
+        QCOMPARE(a.beanNotes, e.beanNotes);
+        QCOMPARE(a.profileNotes, e.profileNotes);
+        QCOMPARE(a.profileJson, e.profileJson);
+        QCOMPARE(a.phases.size(), e.phases.size());
+        for (qsizetype i = 0; i < a.phases.size(); ++i) {
+            QCOMPARE(a.phases[i].time, e.phases[i].time);
+            QCOMPARE(a.phases[i].label, e.phases[i].label);
+            QCOMPARE(a.phases[i].isFlowMode, e.phases[i].isFlowMode);
+        }
+    }
+
+private slots:
+    // parse() logs (qDebug) the filename fallback, which failOnWarning allows.
+    void init() { QTest::failOnWarning(); }
+
+    void matchesRegexParser_data()
+    {
+        QTest::addColumn<QString>("fileName");
+        QTest::addColumn<bool>("crlf");
+
+        const QStringList names = QDir(fixtureDir()).entryList({QStringLiteral("*.shot")}, QDir::Files);
+        QVERIFY2(names.size() >= 3, "de1app_shots fixtures missing");
+        for (const QString& name : names) {
+            QTest::newRow(qPrintable(name)) << name << false;
+            QTest::newRow(qPrintable(name + QStringLiteral(" (CRLF)"))) << name << true;
+        }
+    }
+
+    void matchesRegexParser()
+    {
+        QFETCH(QString, fileName);
+        QFETCH(bool, crlf);
+
+        QByteArray contents = readFixture(fileName);
+        QVERIFY(!contents.isEmpty());
+        if (crlf) {
+            contents.replace("\r\n", "\n");
+            contents.replace("\n", "\r\n");
+        }
+
+        const ShotFileParser::ParseResult actual = ShotFileParser::parse(contents, fileName);
+        QVERIFY2(actual.success, qPrintable(actual.errorMessage));
+        compareRecords(actual, legacyParse(contents, fileName));
+    }
+
+    // Spot checks against the fixture text itself, so the comparison above
+    // can't pass by both parsers agreeing on nothing.
+    void fixtureValues()
+    {
+        const ShotFileParser::ParseResult full =
+            ShotFileParser::parse(readFixture("20240315T081502.shot"), "20240315T081502.shot");
+        QVERIFY(full.success);
+        QCOMPARE(full.record.summary.timestamp, qint64(1710490502));
+        QCOMPARE(full.record.pressure.size(), 180);
+        QCOMPARE(full.record.summary.beanBrand, QStringLiteral("Square Mile"));
+        QCOMPARE(full.record.beanNotes, QStringLiteral("Stone fruit, {cocoa} finish"));
+        QVERIFY(full.record.espressoNotes.endsWith(QStringLiteral("café crème")));
+        QCOMPARE(full.record.barista, QStringLiteral("Alex Doe"));
+        QCOMPARE(full.record.summary.finalWeight, 36.4);
+        QVERIFY(full.record.profileJson.contains(QStringLiteral("Adaptive v2")));
+        QCOMPARE(full.record.phases.size(), 2);
+
+        // No clock line: the timestamp comes from the filename, as UTC.
+        const ShotFileParser::ParseResult noClock =
+            ShotFileParser::parse(readFixture("20231102T193045.shot"), "20231102T193045.shot");
+        QVERIFY(noClock.success);
+        QCOMPARE(noClock.record.summary.timestamp,
+                 QDateTime(QDate(2023, 11, 2), QTime(19, 30, 45), QTimeZone::utc()).toSecsSinceEpoch());
+        QVERIFY(noClock.record.pressureGoal.isEmpty());   // all -1
+        QCOMPARE(noClock.record.barista, QStringLiteral("Sam"));
+
+        const ShotFileParser::ParseResult odd =
+            ShotFileParser::parse(readFixture("20220607T120000.shot"), "20220607T120000.shot");
+        QVERIFY(odd.success);
+        QCOMPARE(odd.record.summary.timestamp, qint64(1654603200));
+        QCOMPARE(odd.record.pressure.size(), 60);          // elapsed read from the next line
+        QCOMPARE(odd.record.temperature.first().y(), 88.5); // first top-level occurrence
+        QCOMPARE(odd.record.summary.beanBrand, QStringLiteral("Ethiopia {Guji} natural"));
+        QVERIFY(odd.record.profileJson.isEmpty());          // first profile block isn't JSON
+        QVERIFY(odd.record.resistance.isEmpty());
+    }
+
+    void errors()
+    {
+        QCOMPARE(ShotFileParser::parse("espresso_elapsed {0 1 2}\n", "shot.shot").errorMessage,
+                 QStringLiteral("Missing clock timestamp"));
+        QCOMPARE(ShotFileParser::parse("clock soon\nespresso_elapsed {0 1 2}\n", "shot.shot").errorMessage,
+                 QStringLiteral("Invalid clock timestamp"));
+        QCOMPARE(ShotFileParser::parse("clock 1700000000\nespresso_elapsed {}\n", "shot.shot").errorMessage,
+                 QStringLiteral("Missing espresso_elapsed data"));
+    }
+
+    void parseHistory_data()
+    {
+        QTest::addColumn<bool>("legacy");
+        QTest::newRow("regex") << true;
+        QTest::newRow("tokenizer") << false;
+    }
+
+    // A 1,000-file de1app history, the three fixtures in rotation — the parse
+    // half of ShotImporter's bulk import.
+    void parseHistory()
+    {
+        QFETCH(bool, legacy);
+        constexpr int kFiles = 1000;
+
+        const QStringList names = QDir(fixtureDir()).entryList({QStringLiteral("*.shot")}, QDir::Files);
+        QVERIFY(!names.isEmpty());
+        QList<QByteArray> fixtures;
+        for (const QString& name : names)
+            fixtures.append(readFixture(name));
+
+        int parsed = 0;
+        QBENCHMARK {
+            parsed = 0;
+            for (int i = 0; i < kFiles; ++i) {
+                const qsizetype which = i % fixtures.size();
+                const ShotFileParser::ParseResult r = legacy
+                    ? legacyParse(fixtures[which], names[which])
+                    : ShotFileParser::parse(fixtures[which], names[which]);
+                parsed += r.success ? 1 : 0;
+            }
+        }
+        QCOMPARE(parsed, kFiles);
+    }
+};
+
+QTEST_GUILESS_MAIN(TstShotFileParser)
+
+#include "tst_shotfileparser.moc"
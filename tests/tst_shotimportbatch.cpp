@@ -0,0 +1,236 @@
+// ShotHistoryStorage::importShotRecordsAsync — the batch write behind the
+// .shot bulk importer (ShotImporter).
+//
+// A batch is deduped with one set query per key and written in one
+// transaction, so these pin down that it still behaves like the same records
+// imported one at a time: duplicates of existing shots and of earlier records
+// in the batch are skipped, and a record that fails rolls back alone without
+// taking the rest of the batch with it. The benchmark compares the two paths
+// on the same synthetic history (opt-in, see benchmarkoptin.h).
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QCoreApplication>
+#include <QThread>
+#include <QPointF>
+#include <QSqlQuery>
+#include <QSqlDatabase>
+#include <QRegularExpression>
+
+#include "history/shothistorystorage.h"
+#include "history/shothistory_types.h"
+#include "core/dbutils.h"
+#include "benchmarkoptin.h"
+
+class TstShotImportBatch : public QObject
+{
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+
+    // initialize() spawns a distinct-cache thread; close() + drain before the
+    // storage destructs or it can crash (see tst_coffeebags::initAndClose).
+    static void drain()
+    {
+        for (int i = 0; i < 20; i++) {
+            QCoreApplication::processEvents();
+            QThread::msleep(25);
+        }
+    }
+
+    // A 30 s shot at the DE1's 5 Hz, with the curves and phases a de1app
+    // .shot file yields.
+    static ShotRecord makeShot(const QString& uuid, qint64 ts, const QString& profileName)
+    {
+        ShotRecord r;
+        r.summary.uuid = uuid;
+        r.summary.timestamp = ts;
+        r.summary.profileName = profileName;
+        r.summary.beverageType = "espresso";
+        r.summary.duration = 30.0;
+        for (int i = 0; i < 150; ++i) {
+            const double t = i * 0.2;
+            r.pressure.append(QPointF(t, qMin(9.0, t)));
+            r.flow.append(QPointF(t, 2.0));
+            r.temperature.append(QPointF(t, 93.0));
+            r.weight.append(QPointF(t, t * 1.2));
+        }
+        HistoryPhaseMarker preinfusion;
+        preinfusion.time = 0.0;
+        preinfusion.label = QStringLiteral("Preinfusion");
+        HistoryPhaseMarker pour;
+        pour.time = 8.0;
+        pour.frameNumber = 1;
+        pour.label = QStringLiteral("Pour");
+        r.phases = {preinfusion, pour};
+        return r;
+    }
+
+    static QList<qint64> importBatch(ShotHistoryStorage& storage, const QList<ShotRecord>& records,
+                                     bool overwriteExisting = false)
+    {
+        QList<qint64> codes;
+        bool done = false;
+        storage.importShotRecordsAsync(records, overwriteExisting, [&](const QList<qint64>& resultCodes) {
+            codes = resultCodes;
+            done = true;
+        });
+        if (!QTest::qWaitFor([&] { return done; }, 30000))
+            qWarning() << "importShotRecordsAsync did not answer";
+        return codes;
+    }
+
+    static int countRows(const QString& path, const QString& table)
+    {
+        int count = -1;
+        withTempDb(path, "tst_sib_count", [&](QSqlDatabase& db) {
+            QSqlQuery q(db);
+            if (q.exec(QStringLiteral("SELECT COUNT(*) FROM ") + table) && q.next())
+                count = q.value(0).toInt();
+        });
+        return count;
+    }
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+
+    void batch_skipsExistingAndRepeatedShots()
+    {
+        QVERIFY(m_dir.isValid());
+        const QString path = m_dir.filePath("batch_dedupe.db");
+        ShotHistoryStorage storage;
+        QVERIFY(storage.initialize(path));
+
+        const qint64 t = 1760000000;
+        QVERIFY(storage.importShotRecord(makeShot("existing", t, "Profile A"), false) > 0);
+
+        const QList<qint64> codes = importBatch(storage, {
+            makeShot("existing", t, "Profile A"),              // same uuid as a stored shot
+            makeShot("near-existing", t + 3, "Profile A"),     // 3 s from it, same profile
+            makeShot("new-1", t + 600, "Profile A"),
+            makeShot("new-1", t + 1200, "Profile B"),          // repeats new-1's uuid
+            makeShot("near-new-1", t + 602, "Profile A"),      // 2 s from new-1, same profile
+            makeShot("new-2", t + 602, "Profile B"),           // same time, other profile
+        });
+        QCOMPARE(codes.size(), 6);
+        QCOMPARE(codes[0], qint64(0));
+        QCOMPARE(codes[1], qint64(0));
+        QVERIFY(codes[2] > 0);
+        QCOMPARE(codes[3], qint64(0));
+        QCOMPARE(codes[4], qint64(0));
+        QVERIFY(codes[5] > 0);
+
+        QCOMPARE(countRows(path, "shots"), 3);
+        QCOMPARE(countRows(path, "shot_samples"), 3);
+        QCOMPARE(countRows(path, "shot_phases"), 6);
+
+        // Overwriting replaces the stored shot in place of skipping it.
+        const QList<qint64> replaced = importBatch(storage, {makeShot("existing", t, "Profile A")}, true);
+        QCOMPARE(replaced.size(), 1);
+        QVERIFY(replaced[0] > 0);
+        QCOMPARE(countRows(path, "shots"), 3);
+
+        QTRY_VERIFY(storage.isDbWorkIdle());
+        storage.close();
+        drain();
+    }
+
+    // A record whose INSERT fails is reported as failed and rolls back to its
+    // savepoint — the shot it was replacing included — while the records
+    // around it still commit.
+    void batch_failedRecordRollsBackAlone()
+    {
+        QVERIFY(m_dir.isValid());
+        const QString path = m_dir.filePath("batch_failure.db");
+        ShotHistoryStorage storage;
+        QVERIFY(storage.initialize(path));
+
+        const qint64 t = 1761000000;
+        const qint64 originalId = storage.importShotRecord(makeShot("poisoned", t, "Profile A"), false);
+        QVERIFY(originalId > 0);
+
+        withTempDb(path, "tst_sib_trigger", [](QSqlDatabase& db) {
+            QSqlQuery(db).exec(QStringLiteral(
+                "CREATE TRIGGER fail_poisoned BEFORE INSERT ON shots WHEN NEW.uuid = 'poisoned' "
+                "BEGIN SELECT RAISE(ABORT, 'injected import failure'); END"));
+        });
+
+        QTest::ignoreMessage(QtWarningMsg,
+            QRegularExpression(QStringLiteral("Failed to import shot.*injected import failure")));
+        const QList<qint64> codes = importBatch(storage, {
+            makeShot("before", t + 600, "Profile A"),
+            makeShot("poisoned", t, "Profile A"),
+            makeShot("after", t + 1200, "Profile A"),
+        }, true);
+        QCOMPARE(codes.size(), 3);
+        QVERIFY(codes[0] > 0);
+        QCOMPARE(codes[1], qint64(-1));
+        QVERIFY(codes[2] > 0);
+
+        QCOMPARE(countRows(path, "shots"), 3);
+        int originals = -1;
+        withTempDb(path, "tst_sib_check", [&](QSqlDatabase& db) {
+            QSqlQuery q(db);
+            q.prepare(QStringLiteral("SELECT COUNT(*) FROM shots WHERE id = ?"));
+            q.bindValue(0, originalId);
+            if (q.exec() && q.next())
+                originals = q.value(0).toInt();
+        });
+        QVERIFY2(originals == 1, "the failed record destroyed the shot it was replacing");
+
+        QTRY_VERIFY(storage.isDbWorkIdle());
+        storage.close();
+        drain();
+    }
+
+    void importThroughput_data()
+    {
+        QTest::addColumn<bool>("batched");
+        QTest::newRow("per shot") << false;
+        QTest::newRow("batched") << true;
+    }
+
+    // A de1app history import: the per-shot row is the path ShotImporter
+    // used to take (one synchronous importShotRecord per file, each its own
+    // transaction), the batched row the one it takes now (chunks of 64, one
+    // transaction each, on the serial DB worker).
+    void importThroughput()
+    {
+        DECENZA_BENCHMARK_OPT_IN();
+        QFETCH(bool, batched);
+        constexpr int kShots = 1000;
+        constexpr int kChunk = 64;
+
+        QList<ShotRecord> history;
+        history.reserve(kShots);
+        for (int i = 0; i < kShots; ++i)
+            history.append(makeShot(QStringLiteral("bench-%1").arg(i), 1762000000 + i * 600, "Profile A"));
+
+        QVERIFY(m_dir.isValid());
+        const QString path = m_dir.filePath(batched ? "bench_batched.db" : "bench_single.db");
+        ShotHistoryStorage storage;
+        QVERIFY(storage.initialize(path));
+
+        int imported = 0;
+        QBENCHMARK_ONCE {
+            if (batched) {
+                for (qsizetype start = 0; start < history.size(); start += kChunk) {
+                    for (const qint64 code : importBatch(storage, history.mid(start, kChunk)))
+                        imported += code > 0 ? 1 : 0;
+                }
+            } else {
+                for (const ShotRecord& record : std::as_const(history))
+                    imported += storage.importShotRecord(record, false) > 0 ? 1 : 0;
+            }
+        }
+        QCOMPARE(imported, kShots);
+
+        QTRY_VERIFY(storage.isDbWorkIdle());
+        storage.close();
+        drain();
+    }
+};
+
+QTEST_GUILESS_MAIN(TstShotImportBatch)
+
+#include "tst_shotimportbatch.moc"
@@ -0,0 +1,403 @@
+// ShotListQuery — GET /api/shots paging, field projection and NDJSON rows.
+//
+// Runs against an in-memory SQLite database with the columns and index of the
+// real shots and recipes tables. The paging cases walk the history a page at a
+// time, the way a client follows Link: rel="next", and check that every shot
+// appears exactly once and in order, even where many shots share a timestamp
+// (a cursor on the timestamp alone would skip or repeat them). The projection
+// cases check that only the requested columns are selected, and that the
+// recipes join is only made when a recipe field is asked for.
+//
+// pageCostIndependentOfHistory is the case the keyset cursor exists for. A
+// 20-shot page at the newest end of a 200k-shot history must cost what it costs
+// on a short one. An OFFSET page, or a keyset condition SQLite cannot start
+// an index range from, reads the history up to the page instead. It builds a
+// 200k-shot table, so it is opt-in (DECENZA_BENCHMARKS=1, see benchmarkoptin.h).
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QUrlQuery>
+
+#include <algorithm>
+#include <limits>
+
+#include "network/shotlistquery.h"
+#include "benchmarkoptin.h"
+
+namespace {
+
+int fieldIndex(const char* key)
+{
+    const QList<ShotListQuery::Field>& all = ShotListQuery::fields();
+    for (int i = 0; i < all.size(); ++i) {
+        if (qstrcmp(all[i].key, key) == 0)
+            return i;
+    }
+    return -1;
+}
+
+ShotListQuery::Request parse(const QString& query, QByteArrayView accept = {})
+{
+    return ShotListQuery::parse(QUrlQuery(query), accept);
+}
+
+// An in-memory database shaped like shots.db, for the columns the list reads.
+struct History {
+    QString name;
+    QSqlDatabase db;
+
+    explicit History(const QString& connection) : name(connection)
+    {
+        db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), name);
+        db.setDatabaseName(QStringLiteral(":memory:"));
+        db.open();
+        QSqlQuery q(db);
+        q.exec("CREATE TABLE recipes (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT, drink_type TEXT, "
+               "archived INTEGER DEFAULT 0)");
+        q.exec("CREATE TABLE shots (id INTEGER PRIMARY KEY AUTOINCREMENT, uuid TEXT, timestamp INTEGER, "
+               "profile_name TEXT, duration_seconds REAL, final_weight REAL, dose_weight REAL, bean_brand TEXT, "
+               "bean_type TEXT, enjoyment INTEGER, visualizer_id TEXT, grinder_setting TEXT, rpm INTEGER, "
+               "temperature_override REAL, yield_override REAL, beverage_type TEXT, drink_tds REAL, "
+               "drink_ey REAL, recipe_id INTEGER)");
+        q.exec("CREATE INDEX idx_shots_timestamp ON shots(timestamp DESC)");
+    }
+
+    ~History()
+    {
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(name);
+    }
+
+    // `count` shots; shot i (from 0) is taken at timestamp baseTime + i / perTimestamp.
+    void addShots(int count, int perTimestamp = 1, qint64 baseTime = 1700000000)
+    {
+        db.transaction();
+        QSqlQuery q(db);
+        q.prepare("INSERT INTO shots (uuid, timestamp, profile_name, final_weight, enjoyment) "
+                  "VALUES (?, ?, ?, ?, ?)");
+        for (int i = 0; i < count; ++i) {
+            q.bindValue(0, QStringLiteral("uuid-%1").arg(i));
+            q.bindValue(1, baseTime + i / perTimestamp);
+            q.bindValue(2, QStringLiteral("Profile %1").arg(i % 7));
+            q.bindValue(3, 36.0 + i % 5);
+            q.bindValue(4, i % 101);
+            q.exec();
+        }
+        db.commit();
+    }
+
+    // Every id, in the order the list must return them.
+    QList<qint64> newestFirst()
+    {
+        QList<qint64> ids;
+        QSqlQuery q(db);
+        q.exec("SELECT id FROM shots ORDER BY timestamp DESC, id DESC");
+        while (q.next())
+            ids.append(q.value(0).toLongLong());
+        return ids;
+    }
+
+    // Follows the pages the way a client follows Link: rel="next". Returns the
+    // ids seen, in order; `pages` counts the responses.
+    QList<qint64> walk(int limit, int& pages)
+    {
+        const ShotListQuery::Projection projection = ShotListQuery::project({fieldIndex("id")});
+        QList<qint64> ids;
+        ShotListCursor after;
+        pages = 0;
+        for (;;) {
+            QByteArray body;
+            int count = 0;
+            ShotListCursor last = after;
+            ShotListCursor next;
+            if (!ShotListQuery::encodePage(db, projection, limit, last, false, body, count)
+                || !ShotListQuery::nextCursor(db, limit, after, next))
+                return {};
+            ++pages;
+            const QJsonArray rows = QJsonDocument::fromJson('[' + body + ']').array();
+            if (rows.size() != count)
+                return {};
+            for (const QJsonValue& row : rows)
+                ids.append(row.toObject().value("id").toInteger());
+            if (!next.valid)
+                return ids;
+            // The Link cursor is where this page ended.
+            if (next.id != last.id || next.timestamp != last.timestamp || pages > 10000)
+                return {};
+            after = ShotListQuery::decodeCursor(ShotListQuery::encodeCursor(next));
+        }
+    }
+};
+
+}  // namespace
+
+class TstShotListQuery : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+
+    void cursorRoundTrip()
+    {
+        const ShotListCursor cursor{1751234567, 4242, true};
+        const QByteArray encoded = ShotListQuery::encodeCursor(cursor);
+        // URL-safe as it stands: no padding, no '+' or '/'.
+        QVERIFY(!encoded.contains('=') && !encoded.contains('+') && !encoded.contains('/'));
+        const ShotListCursor decoded = ShotListQuery::decodeCursor(encoded);
+        QVERIFY(decoded.valid);
+        QCOMPARE(decoded.timestamp, cursor.timestamp);
+        QCOMPARE(decoded.id, cursor.id);
+    }
+
+    void invalidCursors_data()
+    {
+        QTest::addColumn<QByteArray>("encoded");
+        QTest::newRow("empty") << QByteArray();
+        QTest::newRow("not base64") << QByteArray("**");
+        QTest::newRow("no comma") << QByteArray("12345").toBase64(QByteArray::Base64UrlEncoding);
+        QTest::newRow("no timestamp") << QByteArray(",5").toBase64(QByteArray::Base64UrlEncoding);
+        QTest::newRow("text id") << QByteArray("1700000000,x").toBase64(QByteArray::Base64UrlEncoding);
+        QTest::newRow("zero id") << QByteArray("1700000000,0").toBase64(QByteArray::Base64UrlEncoding);
+    }
+
+    void invalidCursors()
+    {
+        QFETCH(QByteArray, encoded);
+        QVERIFY(!ShotListQuery::decodeCursor(encoded).valid);
+    }
+
+    // No parameters: what /api/shots has always answered.
+    void parseDefaults()
+    {
+        const ShotListQuery::Request request = parse(QString());
+        QVERIFY(request.error.isEmpty());
+        QCOMPARE(request.limit, ShotListQuery::kMaxLimit);
+        QVERIFY(!request.after.valid);
+        QVERIFY(request.fields.isEmpty());
+        QVERIFY(!request.ndjson);
+    }
+
+    void parseParameters()
+    {
+        const ShotListCursor cursor{1700000000, 17, true};
+        const ShotListQuery::Request request =
+            parse("limit=25&fields=id,%20profileName,,id&format=ndjson&after="
+                  + QString::fromLatin1(ShotListQuery::encodeCursor(cursor)));
+        QVERIFY2(request.error.isEmpty(), qPrintable(request.error));
+        QCOMPARE(request.limit, 25);
+        QCOMPARE(request.after.id, qint64(17));
+        // Trimmed, empty entries skipped, duplicates dropped, order kept.
+        QCOMPARE(request.fields, (QList<int>{fieldIndex("id"), fieldIndex("profileName")}));
+        QVERIFY(request.ndjson);
+
+        QCOMPARE(parse("limit=5000").limit, ShotListQuery::kMaxLimit);
+        QVERIFY(parse(QString(), "application/x-ndjson").ndjson);
+        QVERIFY(!parse("format=json", "application/x-ndjson").ndjson);
+    }
+
+    void parseErrors_data()
+    {
+        QTest::addColumn<QString>("query");
+        QTest::addColumn<QString>("error");
+        QTest::newRow("zero limit") << "limit=0" << "limit must be a positive integer";
+        QTest::newRow("text limit") << "limit=ten" << "limit must be a positive integer";
+        QTest::newRow("bad cursor") << "after=%21%21" << "Invalid cursor";
+        QTest::newRow("unknown field") << "fields=id,espresso" << "Unknown field: espresso";
+        QTest::newRow("column name") << "fields=profile_name" << "Unknown field: profile_name";
+        QTest::newRow("no field") << "fields=," << "fields lists no field";
+        QTest::newRow("bad format") << "format=csv" << "format must be json or ndjson";
+    }
+
+    void parseErrors()
+    {
+        QFETCH(QString, query);
+        QFETCH(QString, error);
+        QCOMPARE(parse(query).error, error);
+    }
+
+    void projectionSelectsOnlyWhatIsAsked()
+    {
+        const ShotListQuery::Projection narrow =
+            ShotListQuery::project({fieldIndex("profileName"), fieldIndex("id"), fieldIndex("dateTime")});
+        // The cursor's two columns, then profile_name; id and dateTime reuse them.
+        QCOMPARE(narrow.selectList,
+                 (QStringList{"shots.timestamp", "shots.id", "shots.profile_name"}));
+        QCOMPARE(narrow.columns, (QList<int>{2, 1, 0}));
+        QVERIFY(!narrow.joinsRecipes);
+        QVERIFY(!narrow.sql(true).contains("recipes"));
+
+        const ShotListQuery::Projection withRecipe = ShotListQuery::project({fieldIndex("recipeName")});
+        QVERIFY(withRecipe.joinsRecipes);
+        QVERIFY(withRecipe.sql(false).contains("LEFT JOIN recipes r"));
+
+        const ShotListQuery::Projection all = ShotListQuery::project();
+        QCOMPARE(all.fields.size(), ShotListQuery::fields().size());
+        QVERIFY(all.joinsRecipes);
+    }
+
+    // Full rows carry every key with its type, recipe identity joined in.
+    void fullRow()
+    {
+        History history("full_row");
+        QSqlQuery q(history.db);
+        QVERIFY(q.exec("INSERT INTO recipes (name, drink_type, archived) VALUES ('House latte', 'latte', 1)"));
+        QVERIFY(q.exec("INSERT INTO shots (uuid, timestamp, profile_name, enjoyment, visualizer_id, "
+                       "drink_tds, recipe_id) VALUES ('u1', 1700000000, 'Blooming', 85, 'viz-9', 9.5, 1)"));
+        QVERIFY(q.exec("INSERT INTO shots (uuid, timestamp, profile_name) VALUES ('u2', 1700000100, 'Turbo')"));
+
+        QByteArray body;
+        int count = 0;
+        ShotListCursor after;
+        QVERIFY(ShotListQuery::encodePage(history.db, ShotListQuery::project(), 10, after, false, body, count));
+        QCOMPARE(count, 2);
+        const QJsonArray rows = QJsonDocument::fromJson('[' + body + ']').array();
+        QCOMPARE(rows.size(), 2);
+        for (const QJsonValue& row : rows)
+            QCOMPARE(row.toObject().size(), ShotListQuery::fields().size());
+
+        const QJsonObject plain = rows[0].toObject();
+        QCOMPARE(plain.value("profileName").toString(), QString("Turbo"));
+        QCOMPARE(plain.value("hasVisualizerUpload").toBool(true), false);
+        QCOMPARE(plain.value("recipeName").toString("unset"), QString());
+
+        const QJsonObject withRecipe = rows[1].toObject();
+        QCOMPARE(withRecipe.value("id").toInteger(), qint64(1));
+        QCOMPARE(withRecipe.value("enjoyment0to100").toDouble(), 85.0);
+        QCOMPARE(withRecipe.value("drinkTdsPct").toDouble(), 9.5);
+        QCOMPARE(withRecipe.value("hasVisualizerUpload").toBool(), true);
+        QCOMPARE(withRecipe.value("recipeName").toString(), QString("House latte"));
+        QCOMPARE(withRecipe.value("recipeArchived").toBool(), true);
+        QCOMPARE(after.id, qint64(1));
+    }
+
+    void ndjsonRows()
+    {
+        History history("ndjson_rows");
+        history.addShots(5);
+        const ShotListQuery::Projection projection =
+            ShotListQuery::project({fieldIndex("id"), fieldIndex("finalWeightG")});
+
+        QByteArray body;
+        int count = 0;
+        ShotListCursor after;
+        QVERIFY(ShotListQuery::encodePage(history.db, projection, 3, after, true, body, count));
+        QCOMPARE(count, 3);
+        QVERIFY(body.endsWith('\n'));
+        const QList<QByteArray> lines = body.trimmed().split('\n');
+        QCOMPARE(lines.size(), 3);
+        qint64 previous = std::numeric_limits<qint64>::max();
+        for (const QByteArray& line : lines) {
+            QJsonParseError error;
+            const QJsonObject row = QJsonDocument::fromJson(line, &error).object();
+            QCOMPARE(error.error, QJsonParseError::NoError);
+            QCOMPARE(row.keys(), (QStringList{"finalWeightG", "id"}));
+            QVERIFY(row.value("id").toInteger() < previous);
+            previous = row.value("id").toInteger();
+        }
+    }
+
+    void pagesAcrossSharedTimestamps_data()
+    {
+        QTest::addColumn<int>("shots");
+        QTest::addColumn<int>("perTimestamp");
+        QTest::addColumn<int>("limit");
+        QTest::addColumn<int>("pages");
+        QTest::newRow("page inside a timestamp") << 25 << 5 << 7 << 4;
+        QTest::newRow("last page exactly full") << 25 << 5 << 5 << 5;
+        QTest::newRow("one timestamp for all") << 12 << 12 << 5 << 3;
+        QTest::newRow("one page") << 4 << 1 << 10 << 1;
+        QTest::newRow("single shots") << 3 << 1 << 1 << 3;
+        QTest::newRow("empty history") << 0 << 1 << 10 << 1;
+    }
+
+    void pagesAcrossSharedTimestamps()
+    {
+        QFETCH(int, shots);
+        QFETCH(int, perTimestamp);
+        QFETCH(int, limit);
+        QFETCH(int, pages);
+
+        History history("shared_timestamps");
+        history.addShots(shots, perTimestamp);
+        int walked = 0;
+        QCOMPARE(history.walk(limit, walked), history.newestFirst());
+        // No trailing empty page: the last full page already had no Link.
+        QCOMPARE(walked, pages);
+    }
+
+    void nextLinkKeepsTheRequest()
+    {
+        const ShotListCursor next{1700000000, 9, true};
+        const ShotListQuery::Request request = parse("limit=20&fields=id,enjoyment0to100&format=ndjson");
+        const QByteArray link = ShotListQuery::nextLink(request, next);
+        QCOMPARE(link, "</api/shots?limit=20&fields=id,enjoyment0to100&format=ndjson&after="
+                           + ShotListQuery::encodeCursor(next) + ">; rel=\"next\"");
+
+        // Following the link asks for the same page shape from the cursor on.
+        const QByteArray target = link.mid(link.indexOf('?') + 1, link.indexOf('>') - link.indexOf('?') - 1);
+        const ShotListQuery::Request followed = parse(QString::fromLatin1(target));
+        QVERIFY(followed.error.isEmpty());
+        QCOMPARE(followed.limit, request.limit);
+        QCOMPARE(followed.fields, request.fields);
+        QCOMPARE(followed.ndjson, request.ndjson);
+        QCOMPARE(followed.after.id, next.id);
+
+        QCOMPARE(ShotListQuery::nextLink(parse(QString()), next),
+                 "</api/shots?limit=1000&after=" + ShotListQuery::encodeCursor(next) + ">; rel=\"next\"");
+    }
+
+    void pageCostIndependentOfHistory()
+    {
+        DECENZA_BENCHMARK_OPT_IN();
+
+        const ShotListQuery::Projection projection = ShotListQuery::project(
+            {fieldIndex("id"), fieldIndex("timestamp"), fieldIndex("profileName"), fieldIndex("finalWeightG"),
+             fieldIndex("enjoyment0to100")});
+
+        // Median time for the page after the newest shot, and the page's end.
+        auto pageMs = [&projection](QSqlDatabase& db) {
+            QSqlQuery newest(db);
+            newest.exec("SELECT timestamp, id FROM shots ORDER BY timestamp DESC, id DESC LIMIT 1");
+            newest.next();
+            const ShotListCursor top{newest.value(0).toLongLong(), newest.value(1).toLongLong(), true};
+            QList<double> times;
+            for (int run = 0; run < 21; ++run) {
+                QElapsedTimer timer;
+                timer.start();
+                QByteArray body;
+                int count = 0;
+                ShotListCursor after = top;
+                ShotListCursor next;
+                const bool ok = ShotListQuery::encodePage(db, projection, 20, after, false, body, count)
+                                && ShotListQuery::nextCursor(db, 20, top, next);
+                times.append(timer.nsecsElapsed() / 1e6);
+                if (!ok || count != 20 || !next.valid)
+                    return -1.0;
+            }
+            std::sort(times.begin(), times.end());
+            return times[times.size() / 2];
+        };
+
+        History small("cost_small");
+        small.addShots(1000, 3);
+        History large("cost_large");
+        large.addShots(200000, 3);
+        const double smallMs = pageMs(small.db);
+        const double largeMs = pageMs(large.db);
+        QVERIFY(smallMs >= 0 && largeMs >= 0);
+        // A page that reads the history costs tens of milliseconds at 200k
+        // shots. Generous for a loaded CI machine.
+        QVERIFY2(largeMs < 10.0, qPrintable(QString::number(largeMs)));
+    }
+};
+
+QTEST_GUILESS_MAIN(TstShotListQuery)
+
+#include "tst_shotlistquery.moc"
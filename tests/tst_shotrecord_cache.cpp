@@ -12,16 +12,26 @@
 //      analyzeShot call.
 //   3. The cached path and the fallback path MUST produce byte-equal output
 //      for the same input data.
+//   4. The persisted form (history/shotanalysiscache.h) round-trips an
+//      AnalysisResult exactly, and loadShotRecordStatic trusts a stored row
+//      only while its fingerprint and inputs key both still match.
 
 #include <QtTest>
 
+#include <QSignalSpy>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
 #include <QVariantMap>
 #include <QVariantList>
 #include <QVector>
 #include <QPointF>
 #include <QList>
 
+#include "ai/conductance.h"
 #include "ai/shotanalysis.h"
+#include "core/dbutils.h"
+#include "history/shotanalysiscache.h"
 #include "history/shothistory_types.h"
 #include "history/shothistorystorage.h"
 
@@ -94,6 +104,31 @@ ShotRecord buildHealthyRecord()
 class tst_ShotRecordCache : public QObject {
     Q_OBJECT
 
+    QTemporaryDir m_dir;
+
+    // The shot_analysis row's result column, or empty when there is none.
+    static QByteArray storedResult(const QString& path, qint64 shotId)
+    {
+        QByteArray blob;
+        withTempDb(path, "tst_src_read", [&](QSqlDatabase& db) {
+            QSqlQuery q(db);
+            q.prepare(QStringLiteral("SELECT result FROM shot_analysis WHERE shot_id = ?"));
+            q.bindValue(0, shotId);
+            if (q.exec() && q.next()) blob = q.value(0).toByteArray();
+        });
+        return blob;
+    }
+
+    static void execSql(const QString& path, const QString& sql, const QVariantList& binds = {})
+    {
+        withTempDb(path, "tst_src_exec", [&](QSqlDatabase& db) {
+            QSqlQuery q(db);
+            q.prepare(sql);
+            for (qsizetype i = 0; i < binds.size(); ++i) q.bindValue(int(i), binds[i]);
+            QVERIFY2(q.exec(), qPrintable(sql));
+        });
+    }
+
 private slots:
     void init() { QTest::failOnWarning(); }
     // Sentinel test: when cachedAnalysis is populated, convertShotRecord
@@ -251,6 +286,234 @@ private slots:
         QCOMPARE(gates.value("minPressurizedSec").toDouble(),
                  ShotAnalysis::CHOKED_DURATION_MIN_SEC);
     }
+
+    // The persisted encoding must give back exactly what analyzeShot returned:
+    // a stored row stands in for a fresh pass, so any field it loses is a
+    // silent difference between a shot's first and second open.
+    void storedAnalysis_roundTripsExactly()
+    {
+        const ShotRecord record = buildHealthyRecord();
+        ShotAnalysisCache::Entry entry;
+        entry.result = ShotAnalysis::analyzeShot(
+            record.pressure, record.flow, record.weight, record.conductanceDerivative,
+            record.phases, record.summary.beverageType, record.summary.duration,
+            record.pressureGoal, record.flowGoal,
+            /*analysisFlags=*/{}, /*firstFrameSec=*/-1.0,
+            record.targetWeight, record.summary.finalWeight,
+            /*expectedFrameCount=*/-1, /*expertBand=*/std::nullopt,
+            /*profileKbResolved=*/false);
+        entry.kbDerivedFrom = QStringLiteral("Blooming Espresso");
+        QVERIFY(!entry.result.lines.isEmpty());
+
+        const QByteArray blob = ShotAnalysisCache::encode(entry);
+        const auto decoded = ShotAnalysisCache::decode(blob);
+        QVERIFY(decoded.has_value());
+        QCOMPARE(decoded->result.lines, entry.result.lines);
+        QCOMPARE(decoded->kbDerivedFrom, entry.kbDerivedFrom);
+        // Re-encoding what was decoded reproduces the bytes, which covers every
+        // DetectorResults field without naming each one here.
+        QCOMPARE(ShotAnalysisCache::encode(*decoded), blob);
+
+        QVERIFY(!ShotAnalysisCache::decode(blob.left(blob.size() - 1)).has_value());
+        QVERIFY(!ShotAnalysisCache::decode(blob + QByteArray(1, '\0')).has_value());
+        QVERIFY(!ShotAnalysisCache::decode(QByteArray()).has_value());
+    }
+
+    // First full load stores the analysis; the next trusts it (a sentinel
+    // planted in the row comes back); a metadata change or a stale fingerprint
+    // makes the load recompute and replace it.
+    void storedAnalysis_trustedOnlyWhileCurrent()
+    {
+        QVERIFY(m_dir.isValid());
+        const QString path = m_dir.filePath("stored_analysis.db");
+        ShotHistoryStorage storage;
+        QVERIFY(storage.initialize(path));
+
+        ShotRecord record = buildHealthyRecord();
+        record.summary.id = 0;
+        const qint64 shotId = storage.importShotRecord(record, false);
+        QVERIFY(shotId > 0);
+        QVERIFY(storedResult(path, shotId).isEmpty());
+
+        withTempDb(path, "tst_src_first", [&](QSqlDatabase& db) {
+            const ShotRecord loaded = ShotHistoryStorage::loadShotRecordStatic(db, shotId);
+            QVERIFY(loaded.cachedAnalysis.has_value());
+        });
+        const QByteArray firstRow = storedResult(path, shotId);
+        QVERIFY(!firstRow.isEmpty());
+        auto firstEntry = ShotAnalysisCache::decode(firstRow);
+        QVERIFY(firstEntry.has_value());
+
+        ShotAnalysisCache::Entry planted = *firstEntry;
+        QVariantMap sentinel;
+        sentinel["text"] = QStringLiteral("__STORED_SENTINEL__");
+        sentinel["type"] = QStringLiteral("good");
+        planted.result.lines = {sentinel};
+        execSql(path, QStringLiteral("UPDATE shot_analysis SET result = ? WHERE shot_id = ?"),
+             {ShotAnalysisCache::encode(planted), shotId});
+
+        auto firstLineText = [&]() {
+            QString text;
+            withTempDb(path, "tst_src_reload", [&](QSqlDatabase& db) {
+                const ShotRecord loaded = ShotHistoryStorage::loadShotRecordStatic(db, shotId);
+                if (loaded.cachedAnalysis && !loaded.cachedAnalysis->lines.isEmpty())
+                    text = loaded.cachedAnalysis->lines.first().toMap().value("text").toString();
+            });
+            return text;
+        };
+        QCOMPARE(firstLineText(), QStringLiteral("__STORED_SENTINEL__"));
+
+        // An inputs change: the key no longer matches, so the row is recomputed.
+        execSql(path, QStringLiteral("UPDATE shots SET duration_seconds = 31 WHERE id = ?"), {shotId});
+        QVERIFY(firstLineText() != QStringLiteral("__STORED_SENTINEL__"));
+        QVERIFY(storedResult(path, shotId) != ShotAnalysisCache::encode(planted));
+
+        // An algorithm change: same inputs, stale fingerprint.
+        execSql(path, QStringLiteral("UPDATE shot_analysis SET result = ?, fingerprint = 0 WHERE shot_id = ?"),
+             {ShotAnalysisCache::encode(planted), shotId});
+        QVERIFY(firstLineText() != QStringLiteral("__STORED_SENTINEL__"));
+        QVERIFY(storedResult(path, shotId) != ShotAnalysisCache::encode(planted));
+    }
+
+    // The history re-analysis job brings every stale shot current and then
+    // finds nothing.
+    void historyReanalysis_stampsEveryShotOnce()
+    {
+        QVERIFY(m_dir.isValid());
+        const QString path = m_dir.filePath("reanalysis.db");
+        ShotHistoryStorage storage;
+        QVERIFY(storage.initialize(path));
+
+        // More than one batch, so the cursor hand-off runs.
+        constexpr int kShots = 40;
+        for (int i = 0; i < kShots; ++i) {
+            ShotRecord record = buildHealthyRecord();
+            record.summary.id = 0;
+            record.summary.uuid = QStringLiteral("sweep-%1").arg(i);
+            record.summary.timestamp += i;
+            QVERIFY(storage.importShotRecord(record, false) > 0);
+        }
+
+        QSignalSpy progress(&storage, &ShotHistoryStorage::historyReanalysisProgress);
+        QSignalSpy finished(&storage, &ShotHistoryStorage::historyReanalysisFinished);
+        storage.requestHistoryReanalysis();
+        QVERIFY(finished.wait(10000));
+        QCOMPARE(finished.first().at(0).toBool(), true);
+        QCOMPARE(finished.first().at(1).toInt(), kShots);
+        QVERIFY(progress.size() >= 2);
+        QCOMPARE(progress.last().at(0).toInt(), kShots);
+        QCOMPARE(progress.last().at(1).toInt(), kShots);
+        QCOMPARE(storage.historyReanalysisStatus().value("lastResult").toString(),
+                 QStringLiteral("completed"));
+
+        withTempDb(path, "tst_src_sweep_verify", [&](QSqlDatabase& db) {
+            QSqlQuery q(db);
+            q.prepare(QStringLiteral("SELECT COUNT(*) FROM shot_samples WHERE derived_version = ?"));
+            q.bindValue(0, Conductance::kAlgorithmVersion);
+            QVERIFY(q.exec() && q.next());
+            QCOMPARE(q.value(0).toInt(), kShots);
+            q.prepare(QStringLiteral("SELECT COUNT(*) FROM shot_analysis WHERE fingerprint = ?"));
+            q.bindValue(0, ShotAnalysisCache::kFingerprint);
+            QVERIFY(q.exec() && q.next());
+            QCOMPARE(q.value(0).toInt(), kShots);
+        });
+
+        finished.clear();
+        storage.requestHistoryReanalysis();
+        QVERIFY(finished.wait(10000));
+        QCOMPARE(finished.first().at(0).toBool(), true);
+        QCOMPARE(finished.first().at(1).toInt(), 0);
+        QTRY_VERIFY(storage.isDbWorkIdle());
+    }
+
+    // A checkpoint left by an interrupted run is resumed below its cursor,
+    // and removed once the job completes. One written under another
+    // fingerprint is ignored.
+    void historyReanalysis_resumesFromCheckpoint()
+    {
+        QVERIFY(m_dir.isValid());
+        const QString path = m_dir.filePath("reanalysis_resume.db");
+        ShotHistoryStorage storage;
+        QVERIFY(storage.initialize(path));
+
+        QList<qint64> ids;
+        for (int i = 0; i < 6; ++i) {
+            ShotRecord record = buildHealthyRecord();
+            record.summary.id = 0;
+            record.summary.uuid = QStringLiteral("resume-%1").arg(i);
+            record.summary.timestamp += i;
+            const qint64 id = storage.importShotRecord(record, false);
+            QVERIFY(id > 0);
+            ids.append(id);
+        }
+
+        // As if a run had committed the newest three before the app quit.
+        execSql(path, QStringLiteral("INSERT INTO shot_reanalysis_checkpoint (id, fingerprint, before_id, done) "
+                                     "VALUES (1, ?, ?, 3)"),
+                {ShotAnalysisCache::kFingerprint, ids[3]});
+
+        QSignalSpy progress(&storage, &ShotHistoryStorage::historyReanalysisProgress);
+        QSignalSpy finished(&storage, &ShotHistoryStorage::historyReanalysisFinished);
+        storage.requestHistoryReanalysis();
+        QVERIFY(finished.wait(10000));
+        QCOMPARE(finished.first().at(1).toInt(), 3);
+        QCOMPARE(progress.first().at(0).toInt(), 3);
+        QCOMPARE(progress.first().at(1).toInt(), 6);
+        QCOMPARE(progress.last().at(0).toInt(), 6);
+
+        QVERIFY(storedResult(path, ids[0]).size() > 0);
+        QVERIFY(storedResult(path, ids[2]).size() > 0);
+        QVERIFY(storedResult(path, ids[3]).isEmpty());
+        QVERIFY(storedResult(path, ids[5]).isEmpty());
+        QTRY_VERIFY(storage.isDbWorkIdle());
+
+        int checkpoints = -1;
+        withTempDb(path, "tst_src_resume_verify", [&](QSqlDatabase& db) {
+            QSqlQuery q(db);
+            if (q.exec(QStringLiteral("SELECT COUNT(*) FROM shot_reanalysis_checkpoint")) && q.next())
+                checkpoints = q.value(0).toInt();
+        });
+        QCOMPARE(checkpoints, 0);
+
+        // A checkpoint from an older algorithm describes work that has to be
+        // redone; the run starts from the top and covers the three left over.
+        execSql(path, QStringLiteral("INSERT INTO shot_reanalysis_checkpoint (id, fingerprint, before_id, done) "
+                                     "VALUES (1, 0, ?, 3)"),
+                {ids[3]});
+        finished.clear();
+        storage.requestHistoryReanalysis();
+        QVERIFY(finished.wait(10000));
+        QCOMPARE(finished.first().at(1).toInt(), 3);
+        QVERIFY(storedResult(path, ids[5]).size() > 0);
+        QTRY_VERIFY(storage.isDbWorkIdle());
+    }
+
+    // Cancelling before the first batch is selected writes nothing and
+    // reports an incomplete run.
+    void historyReanalysis_cancelStopsBeforeWriting()
+    {
+        QVERIFY(m_dir.isValid());
+        const QString path = m_dir.filePath("reanalysis_cancel.db");
+        ShotHistoryStorage storage;
+        QVERIFY(storage.initialize(path));
+
+        ShotRecord record = buildHealthyRecord();
+        record.summary.id = 0;
+        const qint64 shotId = storage.importShotRecord(record, false);
+        QVERIFY(shotId > 0);
+
+        QSignalSpy finished(&storage, &ShotHistoryStorage::historyReanalysisFinished);
+        storage.requestHistoryReanalysis();
+        storage.cancelHistoryReanalysis();
+        QCOMPARE(storage.historyReanalysisStatus().value("state").toString(), QStringLiteral("cancelling"));
+        QVERIFY(finished.wait(10000));
+        QCOMPARE(finished.first().at(0).toBool(), false);
+        QCOMPARE(finished.first().at(1).toInt(), 0);
+        QCOMPARE(storage.historyReanalysisStatus().value("lastResult").toString(),
+                 QStringLiteral("cancelled"));
+        QVERIFY(storedResult(path, shotId).isEmpty());
+        QTRY_VERIFY(storage.isDbWorkIdle());
+    }
 };
 
 QTEST_GUILESS_MAIN(tst_ShotRecordCache)
@@ -0,0 +1,236 @@
+#include <QtTest>
+
+#include <algorithm>
+#include <iterator>
+
+#include "history/shothistorystorage.h"
+#include "history/shotsampleblob.h"
+#include "models/shotdatamodel.h"
+#include "models/shotsamplebuffer.h"
+
+// ShotSampleBuffer — the struct-of-arrays store behind ShotDataModel, the chart
+// renderers, the blob encoder and the Visualizer uploader.
+//
+// The buffer cases drive it directly; the last two go through ShotDataModel,
+// for what only shows up there (the weight graph's leading zero, and the blob
+// the column views encode to).
+class tst_ShotSampleBuffer : public QObject {
+    Q_OBJECT
+
+    using Channel = ShotSampleBuffer::Channel;
+
+private:
+    static void appendRows(ShotSampleBuffer& buffer, int count, double startTime = 0.0) {
+        for (int i = 0; i < count; ++i) {
+            const double t = startTime + i * 0.2;
+            buffer.appendMachineSample(t, /*pressure*/ 9.0 - i * 0.01, /*flow*/ 2.0, 93.0, 88.0,
+                                       4.5, 0.44, 2.25, i * 0.4, 93.0, 94.0);
+        }
+    }
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+
+    // The point of the layout: one time array for every machine-clock series.
+    void machineSeriesShareOneTimeColumn() {
+        ShotSampleBuffer buffer(64);
+        appendRows(buffer, 10);
+
+        const SampleColumn pressure = buffer.column(Channel::Pressure);
+        QCOMPARE(pressure.size(), qsizetype(10));
+        for (Channel c : {Channel::Flow, Channel::Temperature, Channel::TemperatureMix,
+                          Channel::Resistance, Channel::Conductance, Channel::DarcyResistance,
+                          Channel::WaterDispensed, Channel::TemperatureGoal,
+                          Channel::TemperatureMixGoal}) {
+            QCOMPARE(buffer.column(c).times(), pressure.times());
+            QCOMPARE(buffer.column(c).size(), pressure.size());
+        }
+        QCOMPARE(pressure[3], QPointF(3 * 0.2, 9.0 - 3 * 0.01));
+        QCOMPARE(buffer.column(Channel::WaterDispensed).last().y(), 9 * 0.4);
+    }
+
+    // Post-shot curves are absent — not a run of zeros — until they are set.
+    void postShotChannelsAreEmptyUntilSet() {
+        ShotSampleBuffer buffer(64);
+        appendRows(buffer, 5);
+        buffer.appendWeightFlowRate(0.1, 1.5);
+        buffer.appendWeightFlowRate(0.3, 1.7);
+
+        QVERIFY(buffer.column(Channel::ConductanceDerivative).isEmpty());
+        QVERIFY(buffer.column(Channel::WeightFlowRateRaw).isEmpty());
+
+        const double derivative[] = {0.1, 0.2, 0.3, 0.4, 0.5};
+        buffer.setConductanceDerivative(derivative, 5);
+        QCOMPARE(buffer.column(Channel::ConductanceDerivative).size(), qsizetype(5));
+        QCOMPARE(buffer.column(Channel::ConductanceDerivative).times(),
+                 buffer.column(Channel::Pressure).times());
+
+        // A later weight-flow sample extends the rate but not its raw copy.
+        buffer.setWeightFlowRateRaw(buffer.column(Channel::WeightFlowRate).values(), 2);
+        buffer.appendWeightFlowRate(0.5, 1.9);
+        QCOMPARE(buffer.column(Channel::WeightFlowRate).size(), qsizetype(3));
+        QCOMPARE(buffer.column(Channel::WeightFlowRateRaw).size(), qsizetype(2));
+    }
+
+    void growingPastCapacityKeepsEveryRow() {
+        ShotSampleBuffer buffer(4);
+        appendRows(buffer, 500);
+
+        const SampleColumn pressure = buffer.column(Channel::Pressure);
+        QCOMPARE(pressure.size(), qsizetype(500));
+        for (qsizetype i = 0; i < pressure.size(); ++i) {
+            QCOMPARE(pressure.times()[i], i * 0.2);
+            QCOMPARE(pressure.values()[i], 9.0 - i * 0.01);
+        }
+    }
+
+    // The view's iterator is random access, so the standard algorithms that
+    // dispatch on the tag (a binary search on time, std::prev) work on it.
+    void columnIteratorIsRandomAccess() {
+        ShotSampleBuffer buffer(64);
+        appendRows(buffer, 10);
+        const SampleColumn pressure = buffer.column(Channel::Pressure);
+
+        const auto found = std::lower_bound(pressure.begin(), pressure.end(), 0.9,
+                                             [](const QPointF& p, double t) { return p.x() < t; });
+        QCOMPARE(found - pressure.begin(), qsizetype(5));
+        QCOMPARE(*std::prev(pressure.end()), pressure.last());
+        QCOMPARE(std::distance(pressure.begin(), pressure.end()), qsizetype(10));
+
+        SampleColumn::const_iterator it = pressure.begin() + 4;
+        QCOMPARE(it[2], pressure[6]);
+        it -= 3;
+        QCOMPARE(*it, pressure[1]);
+        QCOMPARE(*(2 + it--), pressure[3]);
+        QCOMPARE(*it, pressure[0]);
+        QVERIFY(it < pressure.end() && pressure.end() > it && pressure.begin() <= it && it >= pressure.begin());
+    }
+
+    // The handoff to the save and upload paths: a copy shares the arena, and
+    // the live side writing on doesn't reach it.
+    void aSnapshotSharesUntilTheLiveSideWrites() {
+        ShotSampleBuffer live(64);
+        appendRows(live, 20);
+
+        const ShotSampleBuffer snapshot = live;
+        QCOMPARE(snapshot.column(Channel::Pressure).times(), live.column(Channel::Pressure).times());
+
+        appendRows(live, 5, 4.0);
+        QCOMPARE(snapshot.sampleCount(), qsizetype(20));
+        QCOMPARE(live.sampleCount(), qsizetype(25));
+        QCOMPARE(snapshot.column(Channel::Pressure).last(), QPointF(19 * 0.2, 9.0 - 19 * 0.01));
+    }
+
+    void clearLeavesAHeldSnapshotIntact() {
+        ShotSampleBuffer live(64);
+        appendRows(live, 20);
+        live.appendWeight(1.0, 12.5);
+        const ShotSampleBuffer snapshot = live;
+
+        live.clear();
+        appendRows(live, 3, 10.0);
+
+        QCOMPARE(live.sampleCount(), qsizetype(3));
+        QVERIFY(live.column(Channel::Weight).isEmpty());
+        QCOMPARE(snapshot.sampleCount(), qsizetype(20));
+        QCOMPARE(snapshot.column(Channel::Pressure).first(), QPointF(0.0, 9.0));
+        QCOMPARE(snapshot.column(Channel::Weight).last(), QPointF(1.0, 12.5));
+    }
+
+    // Machine rows are cut by index; the goals and the weight-flow clock,
+    // which have their own counts, by the last kept row's time.
+    void trimCutsTheOtherClocksByTime() {
+        ShotSampleBuffer buffer(64);
+        appendRows(buffer, 10);  // t = 0.0 … 1.8
+        buffer.appendGoal(ShotSampleBuffer::GoalCurve::Pressure, 0, 0.4, 9.0);
+        buffer.appendGoal(ShotSampleBuffer::GoalCurve::Pressure, 0, 1.6, 9.0);
+        buffer.openGoalSegment(ShotSampleBuffer::GoalCurve::Flow, 1);
+        buffer.appendGoal(ShotSampleBuffer::GoalCurve::Flow, 1, 1.2, 2.0);
+        buffer.appendWeightFlowRate(0.5, 1.0);
+        buffer.appendWeightFlowRate(1.5, 1.0);
+        buffer.appendWeight(0.5, 1.0);
+        buffer.appendWeight(1.7, 30.0);
+
+        buffer.trimMachineRows(5);  // keeps t ≤ 0.8
+
+        QCOMPARE(buffer.sampleCount(), qsizetype(5));
+        QCOMPARE(buffer.column(Channel::TemperatureGoal).size(), qsizetype(5));
+        QCOMPARE(buffer.goalSegments(ShotSampleBuffer::GoalCurve::Pressure).at(0).size(), qsizetype(1));
+        QCOMPARE(buffer.goalSegments(ShotSampleBuffer::GoalCurve::Flow).size(), qsizetype(2));
+        QVERIFY(buffer.goalSegments(ShotSampleBuffer::GoalCurve::Flow).at(1).isEmpty());
+        QCOMPARE(buffer.column(Channel::WeightFlowRate).size(), qsizetype(1));
+        QCOMPARE(buffer.column(Channel::Weight).size(), qsizetype(2));  // never trimmed
+    }
+
+    // The graph's leading zero is synthesized, not stored — and nothing that
+    // reads the accepted samples (final weight, weight at stop) may see it.
+    void weightGraphLeadsWithAZeroTheColumnDoesNotStore() {
+        ShotDataModel model;
+        model.addWeightSample(2.0, 0.5);
+        model.addWeightSample(2.2, 1.0);
+
+        const QVector<QPointF> graph = model.weightData();
+        QCOMPARE(graph.size(), qsizetype(3));
+        QCOMPARE(graph.at(0), QPointF(2.0, 0.0));
+        QCOMPARE(model.cumulativeWeightData().size(), qsizetype(2));
+        QCOMPARE(model.finalWeight(), 1.0);
+
+        model.markStopAt(2.0);
+        QCOMPARE(model.weightAtStop(), 0.5);
+    }
+
+    // Encoding from column views must produce the very bytes encoding the
+    // same series as point vectors does — the views change how the encoder
+    // reads, never what it writes.
+    void columnViewsEncodeToTheSameBlobAsPoints() {
+        ShotDataModel model;
+        for (int i = 0; i < 200; ++i) {
+            const double t = i * 0.2;
+            model.addSample(t, 9.0 - i * 0.0117, 2.0 + i * 0.003, 93.0, 88.0,
+                            i < 100 ? 9.0 : 0.0, i < 100 ? 0.0 : 2.0, 93.0, 94.0,
+                            -1, i >= 100);
+            model.addWeightSample(t, 0.2 + i * 0.18, 1.8);
+        }
+        model.smoothWeightFlowRate();
+        model.computeConductanceDerivative();
+
+        using ShotSampleBlob::Series;
+        const QVector<QPointF> pressure = model.pressureData();
+        const QVector<QPointF> flow = model.flowData();
+        const QVector<QPointF> temperature = model.temperatureData();
+        const QVector<QPointF> temperatureMix = model.temperatureMixData();
+        const QVector<QPointF> pressureGoal = model.pressureGoalData();
+        const QVector<QPointF> flowGoal = model.flowGoalData();
+        const QVector<QPointF> temperatureGoal = model.temperatureGoalData();
+        const QVector<QPointF> temperatureMixGoal = model.temperatureMixGoalData();
+        const QVector<QPointF> resistance = model.resistanceData();
+        const QVector<QPointF> conductance = model.conductanceData();
+        const QVector<QPointF> darcyResistance = model.darcyResistanceData();
+        const QVector<QPointF> conductanceDerivative = model.conductanceDerivativeData();
+        const QVector<QPointF> waterDispensed = model.waterDispensedData();
+        const QVector<QPointF> weight = model.cumulativeWeightData();
+        const QVector<QPointF> weightFlowRate = model.weightFlowRateData();
+        const QByteArray fromPoints = ShotSampleBlob::encode({
+            {Series::Pressure, &pressure},
+            {Series::Flow, &flow},
+            {Series::Temperature, &temperature},
+            {Series::TemperatureMix, &temperatureMix},
+            {Series::PressureGoal, &pressureGoal},
+            {Series::FlowGoal, &flowGoal},
+            {Series::TemperatureGoal, &temperatureGoal},
+            {Series::TemperatureMixGoal, &temperatureMixGoal},
+            {Series::Resistance, &resistance},
+            {Series::Conductance, &conductance},
+            {Series::DarcyResistance, &darcyResistance},
+            {Series::ConductanceDerivative, &conductanceDerivative},
+            {Series::WaterDispensed, &waterDispensed},
+            {Series::Weight, &weight},
+            {Series::WeightFlowRate, &weightFlowRate},
+        });
+
+        QCOMPARE(ShotHistoryStorage::compressSampleData(model.samples()), fromPoints);
+    }
+};
+
+QTEST_MAIN(tst_ShotSampleBuffer)
+#include "tst_shotsamplebuffer.moc"
@@ -2707,14 +2707,18 @@ private slots:
             db.setDatabaseName(path);
             QVERIFY(db.open());
 
+            const std::optional<QString> profileHash =
+                ShotHistoryStorage::storeProfileJsonStatic(db, profileJson);
+            QVERIFY(profileHash.has_value());
+
             QSqlQuery ins(db);
             // profile_kb_id deliberately left NULL: a shape-resolved shot never
             // persists one (it is the dial-in grouping key), so this is the
             // state every such row is really in.
             ins.prepare(QStringLiteral(
-                "INSERT INTO shots (uuid, timestamp, profile_name, duration_seconds, profile_json)"
-                " VALUES ('derivedfrom', 1000, 'Zzz Unrelated Name', 30, :pj)"));
-            ins.bindValue(QStringLiteral(":pj"), profileJson);
+                "INSERT INTO shots (uuid, timestamp, profile_name, duration_seconds, profile_hash)"
+                " VALUES ('derivedfrom', 1000, 'Zzz Unrelated Name', 30, :ph)"));
+            ins.bindValue(QStringLiteral(":ph"), *profileHash);
             QVERIFY2(ins.exec(), qPrintable(ins.lastError().text()));
             shotId = ins.lastInsertId().toLongLong();
             QVERIFY(shotId > 0);
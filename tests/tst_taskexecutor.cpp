@@ -0,0 +1,334 @@
+#include <QtTest>
+
+#include <QSemaphore>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+#include <memory>
+#include <mutex>
+
+#include "core/taskexecutor.h"
+
+// TaskExecutor — the shared pool behind the web server's, MCP's and the
+// storages' one-shot background tasks.
+//
+// Every case builds its own executor rather than touching instance(), so worker
+// counts are exact and each one starts and ends with no threads. Ordering is
+// pinned with a gate: a task that holds a worker until the test releases it,
+// which lets the test queue work behind it and then watch the order it runs in.
+class tst_TaskExecutor : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init() { QTest::failOnWarning(); }
+
+    void runsEverySubmittedTask();
+    void interactiveLaneRunsFirst();
+    void lowerLanesLeaveAWorkerForInteractive();
+    void cancelledTaskIsSkipped();
+    void tokenBoundToObjectCancelsOnDestruction();
+    void nestedSubmitRunsOnItsOwnWorkerFirst();
+    void idleWorkerStealsFromBusyWorker();
+    void acceptsMoveOnlyCallable();
+    void shutdownDrainsQueueThenRejects();
+    void pooledConnectionsAreReusedAndReleased();
+    void statsReportWaitsAndCaps();
+
+    void burst_data();
+    void burst();
+
+private:
+    // Holds a worker until open() — or until the test gives up, so a failure
+    // elsewhere cannot wedge the executor's destructor.
+    struct Gate {
+        QSemaphore entered;
+        QSemaphore released;
+        void hold() {
+            entered.release();
+            released.tryAcquire(1, 5000);
+        }
+        bool waitEntered(int n = 1) { return entered.tryAcquire(n, 5000); }
+        void open(int n = 1) { released.release(n); }
+    };
+
+    // Appends from any thread.
+    struct Log {
+        std::mutex mutex;
+        QStringList entries;
+        void add(const QString& s) {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries << s;
+        }
+        QStringList snapshot() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return entries;
+        }
+    };
+};
+
+void tst_TaskExecutor::runsEverySubmittedTask()
+{
+    TaskExecutor ex(3);
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 50; ++i)
+        ex.submit(TaskLane::Interactive, [&ran]() { ran.fetch_add(1); });
+    QVERIFY(ex.waitForIdle(5000));
+    QCOMPARE(ran.load(), 50);
+    QCOMPARE(ex.stats(TaskLane::Interactive).completed, quint64(50));
+    QCOMPARE(ex.stats(TaskLane::Interactive).queued, 0);
+    QVERIFY(ex.stats(TaskLane::Interactive).peakQueued > 0);
+}
+
+void tst_TaskExecutor::interactiveLaneRunsFirst()
+{
+    // One worker, so the order tasks come off the queues is the order they run.
+    TaskExecutor ex(1);
+    Gate gate;
+    Log log;
+    ex.submit(TaskLane::Interactive, [&]() { gate.hold(); });
+    QVERIFY(gate.waitEntered());
+
+    ex.submit(TaskLane::Maintenance, [&]() { log.add("maintenance"); });
+    ex.submit(TaskLane::Background, [&]() { log.add("background"); });
+    ex.submit(TaskLane::Interactive, [&]() { log.add("interactive"); });
+    gate.open();
+
+    QVERIFY(ex.waitForIdle(5000));
+    QCOMPARE(log.snapshot(), QStringList({"interactive", "background", "maintenance"}));
+}
+
+void tst_TaskExecutor::lowerLanesLeaveAWorkerForInteractive()
+{
+    // Two workers: Background may use one of them, Maintenance one.
+    TaskExecutor ex(2);
+    Gate background;
+    ex.submit(TaskLane::Background, [&]() { background.hold(); });
+    ex.submit(TaskLane::Background, [&]() { background.hold(); });
+    QVERIFY(background.waitEntered());
+
+    // The second Background task stays queued although a worker is free...
+    QTRY_COMPARE(ex.stats(TaskLane::Background).running, 1);
+    QCOMPARE(ex.stats(TaskLane::Background).queued, 1);
+
+    // ...which is the one an Interactive task gets.
+    QSemaphore interactiveRan;
+    ex.submit(TaskLane::Interactive, [&]() { interactiveRan.release(); });
+    QVERIFY(interactiveRan.tryAcquire(1, 5000));
+
+    background.open(2);
+    QVERIFY(ex.waitForIdle(5000));
+    QCOMPARE(ex.stats(TaskLane::Background).completed, quint64(2));
+}
+
+void tst_TaskExecutor::cancelledTaskIsSkipped()
+{
+    TaskExecutor ex(1);
+    Gate gate;
+    ex.submit(TaskLane::Interactive, [&]() { gate.hold(); });
+    QVERIFY(gate.waitEntered());
+
+    std::atomic<bool> ran{false};
+    CancellationToken token = CancellationToken::create();
+    ex.submit(TaskLane::Interactive, [&ran]() { ran = true; }, token);
+    token.cancel();
+    gate.open();
+
+    QVERIFY(ex.waitForIdle(5000));
+    QVERIFY(!ran);
+    QCOMPARE(ex.stats(TaskLane::Interactive).cancelled, quint64(1));
+    QCOMPARE(ex.stats(TaskLane::Interactive).completed, quint64(1));
+
+    // A storage's `m_destroyed` flag converts straight into a token.
+    auto destroyed = std::make_shared<std::atomic<bool>>(true);
+    ex.submit(TaskLane::Background, [&ran]() { ran = true; }, destroyed);
+    QVERIFY(ex.waitForIdle(5000));
+    QVERIFY(!ran);
+}
+
+void tst_TaskExecutor::tokenBoundToObjectCancelsOnDestruction()
+{
+    auto* socket = new QObject;
+    const CancellationToken token = CancellationToken::boundTo(socket);
+    QVERIFY(!token.isCancelled());
+    delete socket;
+    QVERIFY(token.isCancelled());
+
+    QVERIFY(CancellationToken::boundTo(nullptr).isCancelled());
+    QVERIFY(!CancellationToken().isCancelled());
+}
+
+void tst_TaskExecutor::nestedSubmitRunsOnItsOwnWorkerFirst()
+{
+    TaskExecutor ex(1);
+    Gate gate;
+    Log log;
+    ex.submit(TaskLane::Interactive, [&]() {
+        gate.hold();
+        log.add("parent");
+        ex.submit(TaskLane::Interactive, [&]() { log.add("child"); });
+    });
+    QVERIFY(gate.waitEntered());
+    ex.submit(TaskLane::Interactive, [&]() { log.add("queued earlier"); });
+    gate.open();
+
+    // The child went on the worker's own deque, which it serves before the
+    // shared queue — even though the other task was submitted first.
+    QVERIFY(ex.waitForIdle(5000));
+    QCOMPARE(log.snapshot(), QStringList({"parent", "child", "queued earlier"}));
+    QCOMPARE(ex.stolenCount(), quint64(0));
+}
+
+void tst_TaskExecutor::idleWorkerStealsFromBusyWorker()
+{
+    TaskExecutor ex(2);
+    QSemaphore childRan;
+    std::atomic<bool> sameThread{true};
+    ex.submit(TaskLane::Interactive, [&]() {
+        QThread* parentThread = QThread::currentThread();
+        ex.submit(TaskLane::Interactive, [&, parentThread]() {
+            sameThread = QThread::currentThread() == parentThread;
+            childRan.release(2);  // one for the parent, one for the test
+        });
+        // Stay busy until the child has run: only the other worker can take it.
+        childRan.tryAcquire(1, 5000);
+    });
+
+    QVERIFY(childRan.tryAcquire(1, 5000));
+    QVERIFY(ex.waitForIdle(5000));
+    QVERIFY(!sameThread);
+    QCOMPARE(ex.stolenCount(), quint64(1));
+}
+
+void tst_TaskExecutor::acceptsMoveOnlyCallable()
+{
+    TaskExecutor ex(1);
+    std::atomic<int> seen{0};
+    auto value = std::make_unique<int>(42);
+    ex.submit(TaskLane::Background, [&seen, value = std::move(value)]() { seen = *value; });
+    QVERIFY(ex.waitForIdle(5000));
+    QCOMPARE(seen.load(), 42);
+}
+
+void tst_TaskExecutor::shutdownDrainsQueueThenRejects()
+{
+    TaskExecutor ex(1);
+    Gate gate;
+    std::atomic<int> ran{0};
+    ex.submit(TaskLane::Interactive, [&]() { gate.hold(); });
+    QVERIFY(gate.waitEntered());
+    for (int i = 0; i < 5; ++i)
+        ex.submit(TaskLane::Maintenance, [&ran]() { ran.fetch_add(1); });
+
+    gate.open();
+    QVERIFY(ex.shutdown(5000));
+    QCOMPARE(ran.load(), 5);
+
+    QTest::ignoreMessage(QtWarningMsg, "TaskExecutor: submit after shutdown - task dropped");
+    ex.submit(TaskLane::Interactive, [&ran]() { ran.fetch_add(1); });
+    QCOMPARE(ran.load(), 5);
+}
+
+void tst_TaskExecutor::pooledConnectionsAreReusedAndReleased()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath(QStringLiteral("pool.db"));
+    QVERIFY(withTempDb(path, QStringLiteral("seed"), [](QSqlDatabase& db) {
+        QSqlQuery(db).exec(QStringLiteral("CREATE TABLE t(id INTEGER PRIMARY KEY)"));
+    }));
+    const auto pooledNames = []() {
+        QStringList names;
+        for (const QString& name : QSqlDatabase::connectionNames()) {
+            if (name.startsWith(QLatin1String("dbpool_")))
+                names << name;
+        }
+        return names;
+    };
+
+    // One worker, so both tasks must land on the same pooled connection.
+    TaskExecutor ex(1);
+    ex.setPooledDatabase(path);
+    QStringList used;
+    std::mutex usedMutex;
+    for (int i = 0; i < 2; ++i) {
+        ex.submit(TaskLane::Interactive, [&]() {
+            withTempDb(path, QStringLiteral("task"), [&](QSqlDatabase& db) {
+                std::lock_guard<std::mutex> lock(usedMutex);
+                used << db.connectionName();
+            });
+        });
+    }
+    QVERIFY(ex.waitForIdle(5000));
+    QCOMPARE(used.size(), 2);
+    QCOMPARE(used.at(0), used.at(1));
+    QVERIFY(used.at(0).startsWith(QLatin1String("dbpool_")));
+    QCOMPARE(pooledNames().size(), 1);  // still open between tasks
+
+    QVERIFY(ex.releasePooledConnections(5000));
+    QVERIFY(pooledNames().isEmpty());
+}
+
+void tst_TaskExecutor::statsReportWaitsAndCaps()
+{
+    TaskExecutor ex(4);
+    QJsonObject idle = ex.toJson();
+    QCOMPARE(idle.value("workers").toInt(), 4);
+    QCOMPARE(idle.value("started").toBool(), false);
+
+    ex.submit(TaskLane::Background, []() {});
+    QVERIFY(ex.waitForIdle(5000));
+    const QJsonObject json = ex.toJson();
+    QCOMPARE(json.value("started").toBool(), true);
+    const QJsonObject lanes = json.value("lanes").toObject();
+    QCOMPARE(lanes.value("interactive").toObject().value("maxConcurrent").toInt(), 4);
+    QCOMPARE(lanes.value("background").toObject().value("maxConcurrent").toInt(), 3);
+    QCOMPARE(lanes.value("maintenance").toObject().value("maxConcurrent").toInt(), 2);
+    QCOMPARE(lanes.value("background").toObject().value("completed").toInt(), 1);
+    QVERIFY(lanes.value("background").toObject().value("maxWaitMs").toDouble() >= 0.0);
+}
+
+void tst_TaskExecutor::burst_data()
+{
+    QTest::addColumn<bool>("executor");
+    QTest::newRow("thread per task") << false;
+    QTest::newRow("executor") << true;
+}
+
+// What a dashboard poll or a burst of MCP tool calls looks like: many short
+// tasks at once. The old code paid a thread start and teardown for each.
+void tst_TaskExecutor::burst()
+{
+    QFETCH(bool, executor);
+    constexpr int kTasks = 64;
+    TaskExecutor ex(TaskExecutor::defaultWorkerCount());
+    std::atomic<int> ran{0};
+    const auto work = [&ran]() {
+        volatile int x = 0;
+        for (int i = 0; i < 1000; ++i)
+            x = x + i;
+        ran.fetch_add(1);
+    };
+
+    QBENCHMARK {
+        ran = 0;
+        if (executor) {
+            for (int i = 0; i < kTasks; ++i)
+                ex.submit(TaskLane::Interactive, work);
+            if (!ex.waitForIdle(10000))
+                QFAIL("executor did not drain");
+        } else {
+            std::vector<std::unique_ptr<QThread>> threads;
+            threads.reserve(kTasks);
+            for (int i = 0; i < kTasks; ++i) {
+                threads.emplace_back(QThread::create(work));
+                threads.back()->start();
+            }
+            for (auto& t : threads)
+                t->wait();
+        }
+    }
+    QCOMPARE(ran.load(), kTasks);
+}
+
+QTEST_GUILESS_MAIN(tst_TaskExecutor)
+#include "tst_taskexecutor.moc"
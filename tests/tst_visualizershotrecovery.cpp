@@ -0,0 +1,494 @@
+// VisualizerShotRecovery — the "Recover shots from Visualizer" pipeline behind
+// VisualizerImporter::recoverShots, run against a local stand-in for the
+// visualizer.coffee API.
+//
+// FakeVisualizerServer serves the three endpoints the recovery uses (the
+// paged shot list, a shot's download, its profile) for a synthetic history,
+// with a configurable per-response latency, injectable failures, and a count
+// of the downloads it is serving at once. Every shot's download body is the
+// real cremina_clean.json capture; its start time comes from the list entry.
+//
+// These pin down that the pipelined run imports exactly the listed window,
+// never has more than concurrency() downloads in flight, retries transient
+// failures, and resumes from a checkpoint without re-downloading settled
+// shots. The benchmark compares one download at a time (the old sequential
+// walk) with the default concurrency over a high-latency link (opt-in, see
+// benchmarkoptin.h).
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QCoreApplication>
+#include <QThread>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QRegularExpression>
+#include <QSqlQuery>
+#include <QSqlDatabase>
+
+#include <algorithm>
+#include <utility>
+
+#include "network/visualizershotrecovery.h"
+#include "history/shothistorystorage.h"
+#include "core/dbutils.h"
+#include "benchmarkoptin.h"
+
+#ifndef TST_VIS_RECOVERY_SOURCE_DIR
+#define TST_VIS_RECOVERY_SOURCE_DIR "."
+#endif
+
+// Serves GET /api/shots?page=N (newest first, kPageSize per page whatever
+// `items` asks for, like the server-side cap), /api/shots/{id}/download and
+// /api/shots/{id}/profile. Replies are Connection: close, so every request
+// is its own connection and "in flight" is simply accepted-but-not-answered.
+class FakeVisualizerServer : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int kPageSize = 25;
+
+    struct Shot {
+        QString id;
+        qint64 clock = 0;
+    };
+
+    FakeVisualizerServer(QList<Shot> shots, QByteArray downloadBody)
+        : m_shots(std::move(shots))
+        , m_downloadBody(std::move(downloadBody))
+    {
+        std::sort(m_shots.begin(), m_shots.end(),
+                  [](const Shot& a, const Shot& b) { return a.clock > b.clock; });
+        connect(&m_server, &QTcpServer::newConnection, this, [this]() {
+            while (m_server.hasPendingConnections()) {
+                QTcpSocket* sock = m_server.nextPendingConnection();
+                connect(sock, &QTcpSocket::readyRead, this, [this, sock]() { onReadyRead(sock); });
+                connect(sock, &QTcpSocket::disconnected, sock, &QObject::deleteLater);
+            }
+        });
+        const bool ok = m_server.listen(QHostAddress::LocalHost, 0);
+        Q_ASSERT(ok);
+    }
+
+    QString baseUrl() const { return QStringLiteral("http://127.0.0.1:%1").arg(m_server.serverPort()); }
+
+    void setLatencyMs(int ms) { m_latencyMs = ms; }
+    // The next `times` downloads of `id` answer `statusLine`, then it serves normally.
+    void failDownload(const QString& id, const QByteArray& statusLine, int times)
+    {
+        m_failures.insert(id, {statusLine, times});
+    }
+
+    int downloadRequests() const { return m_downloadRequests; }
+    int downloadRequests(const QString& id) const { return m_downloadsById.value(id); }
+    QSet<QString> downloadedIds() const { return QSet<QString>(m_downloadsById.keyBegin(), m_downloadsById.keyEnd()); }
+    int peakDownloadsInFlight() const { return m_peakInFlight; }
+    void resetCounters()
+    {
+        m_downloadRequests = 0;
+        m_downloadsById.clear();
+        m_peakInFlight = 0;
+    }
+
+private:
+    struct Failure {
+        QByteArray statusLine;
+        int remaining = 0;
+    };
+
+    void onReadyRead(QTcpSocket* sock)
+    {
+        QByteArray& pending = m_pending[sock];
+        pending += sock->readAll();
+        if (!pending.contains("\r\n\r\n"))
+            return;   // headers still arriving
+        const QByteArray request = std::exchange(pending, {});
+        m_pending.remove(sock);
+
+        // "GET /api/shots/abc/download HTTP/1.1"
+        const QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+        const QUrl url(baseUrl() + QString::fromUtf8(requestLine.value(1)));
+        const QStringList parts = url.path().split('/', Qt::SkipEmptyParts);
+
+        QByteArray statusLine = "200 OK";
+        QByteArray body;
+        bool isDownload = false;
+        if (parts == QStringList{"api", "shots"}) {
+            body = listPage(QUrlQuery(url).queryItemValue("page").toInt());
+        } else if (parts.size() == 4 && parts[0] == "api" && parts[1] == "shots" && parts[3] == "download") {
+            isDownload = true;
+            const QString id = parts[2];
+            ++m_downloadRequests;
+            ++m_downloadsById[id];
+            m_peakInFlight = qMax(m_peakInFlight, ++m_inFlight);
+            auto failure = m_failures.find(id);
+            if (failure != m_failures.end() && failure->remaining > 0) {
+                --failure->remaining;
+                statusLine = failure->statusLine;
+            } else {
+                body = m_downloadBody;
+            }
+        } else if (parts.size() == 4 && parts[0] == "api" && parts[1] == "shots" && parts[3] == "profile") {
+            QJsonObject profile;
+            profile["title"] = QStringLiteral("Cremina lever machine");
+            profile["steps"] = QJsonArray();
+            body = QJsonDocument(profile).toJson(QJsonDocument::Compact);
+        } else {
+            statusLine = "404 Not Found";
+        }
+
+        const QByteArray response =
+            "HTTP/1.1 " + statusLine + "\r\n"
+            "Content-Type: application/json\r\n"
+            "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+            "Connection: close\r\n"
+            "\r\n" + body;
+        // A client abort closes the socket first; the timer then never fires,
+        // and that download stops counting as in flight with it.
+        connect(sock, &QTcpSocket::disconnected, this, [this, isDownload]() {
+            if (isDownload) --m_inFlight;
+        }, Qt::SingleShotConnection);
+        QTimer::singleShot(m_latencyMs, sock, [sock, response]() {
+            sock->write(response);
+            sock->disconnectFromHost();
+        });
+    }
+
+    QByteArray listPage(int page) const
+    {
+        const int pages = qMax(1, int((m_shots.size() + kPageSize - 1) / kPageSize));
+        QJsonArray data;
+        for (qsizetype i = qsizetype(page - 1) * kPageSize; i < qMin<qsizetype>(m_shots.size(), qsizetype(page) * kPageSize); ++i) {
+            QJsonObject entry;
+            entry["id"] = m_shots[i].id;
+            entry["clock"] = m_shots[i].clock;
+            entry["updated_at"] = m_shots[i].clock;
+            data.append(entry);
+        }
+        QJsonObject paging;
+        paging["count"] = int(m_shots.size());
+        paging["page"] = page;
+        paging["items"] = kPageSize;
+        paging["pages"] = pages;
+        QJsonObject root;
+        root["data"] = data;
+        root["paging"] = paging;
+        return QJsonDocument(root).toJson(QJsonDocument::Compact);
+    }
+
+    QTcpServer m_server;
+    QList<Shot> m_shots;   // newest first, as the API lists them
+    QByteArray m_downloadBody;
+    int m_latencyMs = 0;
+    QHash<QString, Failure> m_failures;
+    QHash<QTcpSocket*, QByteArray> m_pending;
+    int m_downloadRequests = 0;
+    QHash<QString, int> m_downloadsById;
+    int m_inFlight = 0;
+    int m_peakInFlight = 0;
+};
+
+class TstVisualizerShotRecovery : public QObject
+{
+    Q_OBJECT
+
+    using Recovery = VisualizerShotRecovery;
+
+    QTemporaryDir m_dir;
+    QByteArray m_downloadBody;
+
+    static constexpr qint64 kBase = 1760000000;
+    static constexpr qint64 kSpacing = 600;
+
+    // initialize() spawns a distinct-cache thread; close() + drain before the
+    // storage destructs or it can crash (see tst_coffeebags::initAndClose).
+    static void drain()
+    {
+        for (int i = 0; i < 20; i++) {
+            QCoreApplication::processEvents();
+            QThread::msleep(25);
+        }
+    }
+
+    static void closeStorage(ShotHistoryStorage& storage)
+    {
+        QTRY_VERIFY(storage.isDbWorkIdle());
+        storage.close();
+        drain();
+    }
+
+    // `count` shots kSpacing apart starting at kBase, ids vis-0 .. vis-N.
+    static QList<FakeVisualizerServer::Shot> history(int count)
+    {
+        QList<FakeVisualizerServer::Shot> shots;
+        for (int i = 0; i < count; ++i)
+            shots.append({QStringLiteral("vis-%1").arg(i), kBase + i * kSpacing});
+        return shots;
+    }
+
+    static int countShots(const QString& path)
+    {
+        int count = -1;
+        withTempDb(path, "tst_vsr_count", [&](QSqlDatabase& db) {
+            QSqlQuery q(db);
+            if (q.exec(QStringLiteral("SELECT COUNT(*) FROM shots")) && q.next())
+                count = q.value(0).toInt();
+        });
+        return count;
+    }
+
+    struct Outcome {
+        bool finished = false;
+        bool cancelled = false;
+        int total = 0;
+        int imported = 0;
+        int skipped = 0;
+        int failed = 0;
+        QList<Recovery::Checkpoint> checkpoints;
+    };
+
+    // Runs `recovery` over [from, to] to completion (or cancellation).
+    static Outcome run(Recovery& recovery, qint64 from, qint64 to,
+                       const Recovery::Checkpoint& resume = {})
+    {
+        Outcome outcome;
+        QObject scope;
+        connect(&recovery, &Recovery::finished, &scope, [&](int total, int imported, int skipped, int failed) {
+            outcome.finished = true;
+            outcome.total = total;
+            outcome.imported = imported;
+            outcome.skipped = skipped;
+            outcome.failed = failed;
+        });
+        connect(&recovery, &Recovery::cancelled, &scope, [&]() { outcome.cancelled = true; });
+        connect(&recovery, &Recovery::checkpointChanged, &scope,
+                [&](const Recovery::Checkpoint& checkpoint) { outcome.checkpoints.append(checkpoint); });
+        connect(&recovery, &Recovery::listFailed, &scope, [](Recovery::ListError error, int status, const QString& detail) {
+            qWarning() << "listing failed:" << error << status << detail;
+        });
+
+        recovery.start(from, to, "Basic dGVzdDp0ZXN0", resume);
+        if (!QTest::qWaitFor([&] { return outcome.finished || outcome.cancelled; }, 60000))
+            qWarning() << "recovery did not end";
+        return outcome;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QFile fixture(QStringLiteral(TST_VIS_RECOVERY_SOURCE_DIR "/data/shots/cremina_clean.json"));
+        QVERIFY2(fixture.open(QIODevice::ReadOnly), "cremina_clean.json fixture missing/unreadable");
+        m_downloadBody = fixture.readAll();
+        QVERIFY(m_dir.isValid());
+    }
+
+    void init() { QTest::failOnWarning(); }
+
+    // 40 shots listed over two pages, 30 of them in the window. Every one of
+    // the 30 is downloaded once, no more than concurrency() at a time, and a
+    // second run over the same window skips them all as already present.
+    void importsEveryShotInWindow()
+    {
+        FakeVisualizerServer server(history(40), m_downloadBody);
+        server.setLatencyMs(20);
+
+        const QString path = m_dir.filePath("window.db");
+        ShotHistoryStorage storage;
+        QVERIFY(storage.initialize(path));
+        QNetworkAccessManager network;
+
+        Recovery recovery(&network, &storage);
+        recovery.setBaseUrl(server.baseUrl());
+        QCOMPARE(recovery.concurrency(), Recovery::kDefaultConcurrency);
+
+        const qint64 from = kBase + 5 * kSpacing;
+        const qint64 to = kBase + 34 * kSpacing;
+        const Outcome first = run(recovery, from, to);
+        QVERIFY(first.finished);
+        QCOMPARE(first.total, 30);
+        QCOMPARE(first.imported, 30);
+        QCOMPARE(first.skipped, 0);
+        QCOMPARE(first.failed, 0);
+        QCOMPARE(countShots(path), 30);
+
+        QCOMPARE(server.downloadRequests(), 30);
+        QSet<QString> expected;
+        for (int i = 5; i <= 34; ++i)
+            expected.insert(QStringLiteral("vis-%1").arg(i));
+        QCOMPARE(server.downloadedIds(), expected);
+        QVERIFY2(server.peakDownloadsInFlight() <= Recovery::kDefaultConcurrency,
+                 qPrintable(QString::number(server.peakDownloadsInFlight())));
+        QVERIFY2(server.peakDownloadsInFlight() > 1, "downloads never overlapped");
+
+        // The final checkpoint covers the whole window.
+        QVERIFY(!first.checkpoints.isEmpty());
+        QCOMPARE(first.checkpoints.last().settledThroughClock, to);
+        QCOMPARE(first.checkpoints.last().imported, 30);
+
+        const Outcome second = run(recovery, from, to);
+        QVERIFY(second.finished);
+        QCOMPARE(second.total, 30);
+        QCOMPARE(second.imported, 0);
+        QCOMPARE(second.skipped, 30);
+        QCOMPARE(countShots(path), 30);
+
+        closeStorage(storage);
+    }
+
+    // A 503 is retried; a 404 (a deleted shot) fails that shot alone, and the
+    // checkpoint still moves past it.
+    void retriesTransientAndCountsFailures()
+    {
+        FakeVisualizerServer server(history(10), m_downloadBody);
+        server.failDownload("vis-3", "503 Service Unavailable", 1);
+        server.failDownload("vis-6", "404 Not Found", Recovery::kMaxDownloadAttempts);
+
+        const QString path = m_dir.filePath("failures.db");
+        ShotHistoryStorage storage;
+        QVERIFY(storage.initialize(path));
+        QNetworkAccessManager network;
+
+        Recovery recovery(&network, &storage);
+        recovery.setBaseUrl(server.baseUrl());
+
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("shot download transient failure for.*vis-3"));
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("shot download failed for.*vis-6"));
+        const Outcome outcome = run(recovery, kBase, kBase + 9 * kSpacing);
+        QVERIFY(outcome.finished);
+        QCOMPARE(outcome.total, 10);
+        QCOMPARE(outcome.imported, 9);
+        QCOMPARE(outcome.failed, 1);
+        QCOMPARE(server.downloadRequests("vis-3"), 2);
+        QCOMPARE(server.downloadRequests("vis-6"), 1);   // 4xx is not retried
+        QCOMPARE(countShots(path), 9);
+
+        const Recovery::Checkpoint last = outcome.checkpoints.last();
+        QCOMPARE(last.settledThroughClock, kBase + 9 * kSpacing);
+        QCOMPARE(last.imported, 9);
+        QCOMPARE(last.failed, 1);
+
+        closeStorage(storage);
+    }
+
+    // A run cancelled part way, then resumed from its last checkpoint by a
+    // fresh instance (the app restarted): only shots after the checkpoint are
+    // downloaded again, and the counts carry on to the full window.
+    void resumesFromCheckpoint()
+    {
+        constexpr int kShots = 20;
+        FakeVisualizerServer server(history(kShots), m_downloadBody);
+        server.setLatencyMs(5);
+
+        const QString path = m_dir.filePath("resume.db");
+        ShotHistoryStorage storage;
+        QVERIFY(storage.initialize(path));
+        QNetworkAccessManager network;
+        const qint64 from = kBase;
+        const qint64 to = kBase + (kShots - 1) * kSpacing;
+
+        Recovery::Checkpoint checkpoint;
+        {
+            Recovery interrupted(&network, &storage);
+            interrupted.setBaseUrl(server.baseUrl());
+            interrupted.setConcurrency(1);
+            // Cancelled from inside the checkpoint notification, which is
+            // where a real caller persisting it would be.
+            connect(&interrupted, &Recovery::checkpointChanged, &interrupted,
+                    [&](const Recovery::Checkpoint& c) {
+                        if (c.imported >= 6) interrupted.cancel();
+                    });
+            const Outcome outcome = run(interrupted, from, to);
+            QVERIFY(outcome.cancelled);
+            QVERIFY(!outcome.finished);
+            QVERIFY(!outcome.checkpoints.isEmpty());
+            checkpoint = outcome.checkpoints.last();
+        }
+        QCOMPARE(checkpoint.fromEpoch, from);
+        QCOMPARE(checkpoint.toEpoch, to);
+        // A batch that lands with the one that cancelled still settles, so
+        // the checkpoint can be a shot or two past the sixth.
+        const int settled = checkpoint.imported;
+        QVERIFY(settled >= 6 && settled < kShots);
+        QCOMPARE(checkpoint.settledThroughClock, kBase + (settled - 1) * kSpacing);
+
+        // It survives the trip through QSettings' variant map.
+        const Recovery::Checkpoint restored = Recovery::Checkpoint::fromVariantMap(checkpoint.toVariantMap());
+        QVERIFY(restored.covers(from, to));
+        QCOMPARE(restored.settledThroughClock, checkpoint.settledThroughClock);
+        QCOMPARE(restored.imported, checkpoint.imported);
+
+        server.resetCounters();
+        Recovery resumed(&network, &storage);
+        resumed.setBaseUrl(server.baseUrl());
+        const Outcome outcome = run(resumed, from, to, restored);
+        QVERIFY(outcome.finished);
+        QCOMPARE(outcome.total, kShots);
+        QCOMPARE(outcome.failed, 0);
+        QCOMPARE(outcome.imported + outcome.skipped, kShots);
+        QCOMPARE(server.downloadRequests(), kShots - settled);
+        for (int i = 0; i < settled; ++i)
+            QVERIFY(!server.downloadedIds().contains(QStringLiteral("vis-%1").arg(i)));
+        QCOMPARE(countShots(path), kShots);
+
+        // A checkpoint for another window is ignored.
+        server.resetCounters();
+        Recovery other(&network, &storage);
+        other.setBaseUrl(server.baseUrl());
+        const Outcome wider = run(other, from, to + kSpacing, restored);
+        QVERIFY(wider.finished);
+        QCOMPARE(wider.total, kShots);
+        QCOMPARE(wider.skipped, kShots);
+        QCOMPARE(server.downloadRequests(), kShots);
+
+        closeStorage(storage);
+    }
+
+    void recoveryThroughput_data()
+    {
+        QTest::addColumn<int>("concurrency");
+        QTest::newRow("sequential") << 1;
+        QTest::newRow("pipelined") << int(Recovery::kDefaultConcurrency);
+    }
+
+    // 100 shots behind 25 ms of latency per response. The sequential row is
+    // the walk recovery used to take (one shot downloaded, parsed and written
+    // before the next is requested); the pipelined row is the default.
+    void recoveryThroughput()
+    {
+        DECENZA_BENCHMARK_OPT_IN();
+        QFETCH(int, concurrency);
+        constexpr int kShots = 100;
+
+        FakeVisualizerServer server(history(kShots), m_downloadBody);
+        server.setLatencyMs(25);
+
+        const QString path = m_dir.filePath(QStringLiteral("bench_%1.db").arg(concurrency));
+        ShotHistoryStorage storage;
+        QVERIFY(storage.initialize(path));
+        QNetworkAccessManager network;
+        Recovery recovery(&network, &storage);
+        recovery.setBaseUrl(server.baseUrl());
+        recovery.setConcurrency(concurrency);
+
+        Outcome outcome;
+        QBENCHMARK_ONCE {
+            outcome = run(recovery, kBase, kBase + (kShots - 1) * kSpacing);
+        }
+        QVERIFY(outcome.finished);
+        QCOMPARE(outcome.imported, kShots);
+
+        closeStorage(storage);
+    }
+};
+
+QTEST_GUILESS_MAIN(TstVisualizerShotRecovery)
+
+#include "tst_visualizershotrecovery.moc"
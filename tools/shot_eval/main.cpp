@@ -18,7 +18,14 @@
 // Output: a table per shot showing baseline (unrestricted) vs mode-aware
 // detector verdicts alongside counts, peaks, and the mask coverage the
 // mode-aware windowing produces. Optional --json emits one JSON object
-// per shot to stdout for diffing.
+// per shot to stdout for diffing; --jsonl streams them one per line.
+//
+// Corpus runs: --jobs N parses and evaluates N shots at a time (the
+// detectors are pure functions, and the profile KB is loaded once and only
+// read after that), and results are written in input order, so the output
+// doesn't depend on N.
+// Shots/s and per-stage times (parse / derive / analyze / summarize) are
+// reported on stderr.
 
 #include "ai/conductance.h"
 #include "ai/shotanalysis.h"
@@ -29,6 +36,7 @@
 #include <QCommandLineParser>
 #include <QCoreApplication>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QRegularExpression>
@@ -37,14 +45,21 @@
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QList>
+#include <QMutex>
 #include <QPointF>
 #include <QString>
 #include <QStringList>
 #include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
 #include <QVector>
+#include <QWaitCondition>
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
+#include <optional>
+#include <vector>
 
 namespace {
 
@@ -503,8 +518,30 @@ bool loadDecenzaFormat(const QJsonObject& root, LoadedShot& out, QString* errOut
     return true;
 }
 
-bool loadShotFile(const QString& path, LoadedShot& out, QString* errOut)
+// Wall time per pipeline stage, summed over shots (and so over workers
+// under --jobs): parse is file read + JSON + format load, derive is the
+// conductance curves and pour bounds, analyze is evaluate(), summarize is
+// turning the verdicts into output rows.
+struct StageTimes {
+    qint64 parseNs = 0;
+    qint64 deriveNs = 0;
+    qint64 analyzeNs = 0;
+    qint64 summarizeNs = 0;
+
+    void add(const StageTimes& o)
+    {
+        parseNs += o.parseNs;
+        deriveNs += o.deriveNs;
+        analyzeNs += o.analyzeNs;
+        summarizeNs += o.summarizeNs;
+    }
+};
+
+bool loadShotFile(const QString& path, LoadedShot& out, QString* errOut,
+                  StageTimes* times = nullptr)
 {
+    QElapsedTimer timer;
+    timer.start();
     QFile f(path);
     if (!f.open(QIODevice::ReadOnly)) {
         if (errOut) *errOut = QStringLiteral("cannot open: %1").arg(f.errorString());
@@ -523,11 +560,14 @@ bool loadShotFile(const QString& path, LoadedShot& out, QString* errOut)
         ? loadDecenzaFormat(root, out, errOut)
         : loadVisualizerFormat(root, path, out, errOut);
     if (!ok) return false;
+    if (times) times->parseNs += timer.restart();
+
     out.conductance = Conductance::fromPressureFlow(out.pressure, out.flow);
     out.conductanceDerivative = Conductance::derivative(out.conductance);
 
     out.pourStart = pourStartFromCurves(out.pressure, out.flow);
     out.pourEnd = out.pressure.last().x();
+    if (times) times->deriveNs += timer.nsecsElapsed();
     return true;
 }
 
@@ -1112,6 +1152,102 @@ QJsonObject toJsonRow(const EvaluatedShot& ev)
     return o;
 }
 
+// How a corpus run renders each shot. Rows are built by the worker that
+// evaluated the shot, so under --jobs the JSON encoding runs in parallel too.
+enum class RowFormat { Table, JsonArray, JsonLines };
+
+// One input file's outcome, as the output loop receives it.
+struct CorpusResult {
+    bool loaded = false;
+    QString error;
+    EvaluatedShot ev;   // RowFormat::Table only
+    QJsonObject row;    // RowFormat::JsonArray
+    QByteArray line;    // RowFormat::JsonLines, without the newline
+    StageTimes times;
+};
+
+CorpusResult processShot(const QString& path, RowFormat format)
+{
+    CorpusResult r;
+    LoadedShot shot;
+    if (!loadShotFile(path, shot, &r.error, &r.times)) return r;
+    r.loaded = true;
+
+    QElapsedTimer timer;
+    timer.start();
+    EvaluatedShot ev = evaluate(shot);
+    r.times.analyzeNs = timer.restart();
+
+    // The table is laid out over all shots at once; it's rendered (and
+    // timed) by the caller. The JSON forms drop the curves here rather than
+    // holding thousands of shots' worth until the end.
+    switch (format) {
+    case RowFormat::Table:
+        r.ev = std::move(ev);
+        break;
+    case RowFormat::JsonArray:
+        r.row = toJsonRow(ev);
+        break;
+    case RowFormat::JsonLines:
+        r.line = QJsonDocument(toJsonRow(ev)).toJson(QJsonDocument::Compact);
+        break;
+    }
+    r.times.summarizeNs = timer.nsecsElapsed();
+    return r;
+}
+
+// Evaluates `files` on up to `jobs` threads and hands each result to
+// `consume` in input order, as soon as it and every file before it are done:
+// the output is byte-for-byte that of a sequential run, and still streams.
+void runCorpus(const QStringList& files, int jobs, RowFormat format,
+               const std::function<void(const QString&, CorpusResult&)>& consume)
+{
+    if (files.isEmpty()) return;
+
+    // The first shot always runs here, as the start of the sequential path.
+    // The profile KB it loads (ShotSummarizer's lazy statics) is safe to load
+    // from a worker too: its load flag is atomic, so a first shot that fails
+    // to parse just leaves the load to whichever worker gets there first.
+    {
+        CorpusResult first = processShot(files.first(), format);
+        consume(files.first(), first);
+    }
+    if (jobs <= 1) {
+        for (qsizetype i = 1; i < files.size(); ++i) {
+            CorpusResult r = processShot(files[i], format);
+            consume(files[i], r);
+        }
+        return;
+    }
+
+    QMutex mutex;
+    QWaitCondition finished;
+    std::vector<std::optional<CorpusResult>> done(files.size());
+
+    // Queued in input order, so workers finish roughly in the order the
+    // loop below wants them.
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobs);
+    for (qsizetype i = 1; i < files.size(); ++i) {
+        pool.start([&files, &mutex, &finished, &done, format, i]() {
+            CorpusResult r = processShot(files[i], format);
+            QMutexLocker locker(&mutex);
+            done[i] = std::move(r);
+            finished.wakeAll();
+        });
+    }
+    for (qsizetype i = 1; i < files.size(); ++i) {
+        CorpusResult r;
+        {
+            QMutexLocker locker(&mutex);
+            while (!done[i]) finished.wait(&mutex);
+            r = std::move(*done[i]);
+            done[i].reset();
+        }
+        consume(files[i], r);
+    }
+}
+
 } // namespace
 
 int main(int argc, char** argv)
@@ -1134,6 +1270,15 @@ int main(int argc, char** argv)
     QCommandLineOption jsonOpt({"j", "json"},
         "Emit one JSON object per shot to stdout (machine-readable).");
     parser.addOption(jsonOpt);
+    QCommandLineOption jsonlOpt("jsonl",
+        "Emit JSON Lines: one compact JSON object per shot, written as soon\n"
+        "as it and every shot before it are evaluated.");
+    parser.addOption(jsonlOpt);
+    QCommandLineOption jobsOpt("jobs",
+        "Parse and evaluate N shots concurrently (0 = one per CPU core).\n"
+        "Output order and content are the same as a sequential run.",
+        "N", "1");
+    parser.addOption(jobsOpt);
     QCommandLineOption validateOpt("validate",
         "Validate shots against a manifest.json with expected verdicts.\n"
         "Exits non-zero on mismatch. Positional args ignored; manifest is\n"
@@ -1160,6 +1305,17 @@ int main(int argc, char** argv)
         QTextStream(stderr) << "--validate and --settling are mutually exclusive\n";
         return 1;
     }
+    if (parser.isSet(jsonOpt) && parser.isSet(jsonlOpt)) {
+        QTextStream(stderr) << "--json and --jsonl are mutually exclusive\n";
+        return 1;
+    }
+    bool jobsOk = false;
+    int jobs = parser.value(jobsOpt).toInt(&jobsOk);
+    if (!jobsOk || jobs < 0) {
+        QTextStream(stderr) << "--jobs expects a non-negative integer\n";
+        return 1;
+    }
+    if (jobs == 0) jobs = std::max(1, QThread::idealThreadCount());
 
     QTextStream out(stdout);
 
@@ -1181,6 +1337,11 @@ int main(int argc, char** argv)
         const QString baseDir = mfInfo.absolutePath();
 
         int passed = 0, failed = 0;
+        // Time spent in evaluate() alone — detectors, windows and the
+        // production analyzeShot — so a detector change can be judged on
+        // throughput as well as verdicts. File I/O and parsing are excluded.
+        qint64 analyzeNs = 0;
+        int analyzed = 0;
         for (const auto& v : shotArr) {
             const QJsonObject entry = v.toObject();
             const QString relFile = entry.value("file").toString();
@@ -1194,7 +1355,11 @@ int main(int argc, char** argv)
                 ++failed;
                 continue;
             }
+            QElapsedTimer analyzeTimer;
+            analyzeTimer.start();
             const EvaluatedShot ev = evaluate(shot);
+            analyzeNs += analyzeTimer.nsecsElapsed();
+            ++analyzed;
 
             // Compare expected vs actual. Missing expect-fields are not
             // checked — authors opt into each invariant explicitly.
@@ -1261,6 +1426,12 @@ int main(int argc, char** argv)
         }
         out << QStringLiteral("\n%1 / %2 shots passed.\n")
                    .arg(passed).arg(passed + failed);
+        if (analyzed > 0 && analyzeNs > 0) {
+            out << QStringLiteral("Analysis: %1 shots in %2 ms (%3 shots/s).\n")
+                       .arg(analyzed)
+                       .arg(analyzeNs / 1e6, 0, 'f', 2)
+                       .arg(analyzed * 1e9 / analyzeNs, 0, 'f', 0);
+        }
         return failed == 0 ? 0 : 1;
     }
 
@@ -1292,22 +1463,42 @@ int main(int argc, char** argv)
         return 0;
     }
 
+    const RowFormat format = parser.isSet(jsonlOpt) ? RowFormat::JsonLines
+                           : parser.isSet(jsonOpt)  ? RowFormat::JsonArray
+                                                    : RowFormat::Table;
     QList<EvaluatedShot> results;
-    for (const auto& f : files) {
-        LoadedShot shot;
-        QString err;
-        if (!loadShotFile(f, shot, &err)) {
-            QTextStream(stderr) << "skip " << f << ": " << err << '\n';
-            continue;
+    QJsonArray rows;
+    StageTimes times;
+    int evaluated = 0;
+
+    QElapsedTimer wall;
+    wall.start();
+    runCorpus(files, jobs, format, [&](const QString& f, CorpusResult& r) {
+        times.add(r.times);
+        if (!r.loaded) {
+            QTextStream(stderr) << "skip " << f << ": " << r.error << '\n';
+            return;
         }
-        results.append(evaluate(shot));
-    }
+        ++evaluated;
+        switch (format) {
+        case RowFormat::Table:
+            results.append(std::move(r.ev));
+            break;
+        case RowFormat::JsonArray:
+            rows.append(r.row);
+            break;
+        case RowFormat::JsonLines:
+            out << r.line << '\n';
+            out.flush();
+            break;
+        }
+    });
 
-    if (parser.isSet(jsonOpt)) {
-        QJsonArray arr;
-        for (const auto& ev : results) arr.append(toJsonRow(ev));
-        out << QJsonDocument(arr).toJson(QJsonDocument::Indented);
-    } else {
+    QElapsedTimer summarizeTimer;
+    summarizeTimer.start();
+    if (format == RowFormat::JsonArray) {
+        out << QJsonDocument(rows).toJson(QJsonDocument::Indented);
+    } else if (format == RowFormat::Table) {
         printTable(results, out);
         // Summary line: how many verdicts changed.
         int downgraded = 0, upgraded = 0, same = 0;
@@ -1322,5 +1513,23 @@ int main(int argc, char** argv)
             << QStringLiteral("Summary: %1 shots — %2 relaxed, %3 tightened, %4 unchanged.\n")
                    .arg(results.size()).arg(downgraded).arg(upgraded).arg(same);
     }
+    out.flush();
+    times.summarizeNs += summarizeTimer.nsecsElapsed();
+    const qint64 wallNs = wall.nsecsElapsed();
+
+    // Throughput goes to stderr so stdout stays exactly the report (and
+    // --json / --jsonl stay parseable). Stage times are summed over
+    // workers, so with --jobs they add up to more than the wall time.
+    QTextStream err(stderr);
+    err << QStringLiteral("Throughput: %1 shots in %2 ms on %3 thread(s) (%4 shots/s).\n")
+               .arg(evaluated)
+               .arg(wallNs / 1e6, 0, 'f', 1)
+               .arg(jobs)
+               .arg(wallNs > 0 ? evaluated * 1e9 / wallNs : 0.0, 0, 'f', 0);
+    err << QStringLiteral("Stages (ms): parse %1, derive %2, analyze %3, summarize %4.\n")
+               .arg(times.parseNs / 1e6, 0, 'f', 1)
+               .arg(times.deriveNs / 1e6, 0, 'f', 1)
+               .arg(times.analyzeNs / 1e6, 0, 'f', 1)
+               .arg(times.summarizeNs / 1e6, 0, 'f', 1);
     return 0;
 }